@@ -0,0 +1,169 @@
+'use strict';
+
+/**
+ * Minimal rigctld stand-in for benchmarks: answers the netrigctl protocol
+ * (the subset HamLib model 2 uses for open, frequency, mode, VFO, PTT and
+ * levels) from in-memory state, after a configurable delay per reply. It
+ * stands in for a slow serial or network rig, so the lock and worker paths
+ * can be measured with realistic I/O times.
+ */
+
+const net = require('net');
+
+// `\dump_state`, protocol 1: a dummy-like HF/VHF rig with every func/level.
+const DUMP_STATE = [
+  '1',
+  '1',
+  '0',
+  '150000.000000 1500000000.000000 0x1ff -1 -1 0x10000003 0x3',
+  '0 0 0 0 0 0 0',
+  '150000.000000 1500000000.000000 0x1ff 5000 100000 0x10000003 0x3',
+  '0 0 0 0 0 0 0',
+  '0x1ff 1',
+  '0 0',
+  '0x1ff 2400',
+  '0 0',
+  '9990',
+  '9990',
+  '10000',
+  '0',
+  '10 ',
+  '10 20 ',
+  '0xffffffff',
+  '0xffffffff',
+  '0x40000000',
+  '0x40000000',
+  '0x0',
+  '0x0',
+  'vfo_ops=0x0',
+  'ptt_type=0x1',
+  'targetable_vfo=0x0',
+  'done',
+].join('\n') + '\n';
+
+class FakeRigctld {
+  /**
+   * @param {Object} [options]
+   * @param {number} [options.latencyMs=0] - Delay before each reply
+   * @param {number} [options.jitterMs=0] - Extra uniform random delay per reply
+   */
+  constructor(options = {}) {
+    this.latencyMs = options.latencyMs || 0;
+    this.jitterMs = options.jitterMs || 0;
+    this.commands = 0;
+    this._server = net.createServer((socket) => this._serve(socket));
+    this._sockets = new Set();
+  }
+
+  /** @returns {Promise<string>} 'localhost:<port>' for new HamLib(2, address) */
+  listen(port = 0) {
+    return new Promise((resolve, reject) => {
+      this._server.once('error', reject);
+      this._server.listen(port, '127.0.0.1', () => {
+        resolve(`localhost:${this._server.address().port}`);
+      });
+    });
+  }
+
+  close() {
+    for (const socket of this._sockets) {
+      socket.destroy();
+    }
+    return new Promise((resolve) => this._server.close(() => resolve()));
+  }
+
+  _serve(socket) {
+    // Per connection, like one rigctld client session.
+    const state = { frequency: 14074000, mode: 'USB', width: 2400, vfo: 'VFOA', ptt: 0, levels: {} };
+    let buffered = '';
+    let replying = Promise.resolve();
+    this._sockets.add(socket);
+    socket.setNoDelay(true);
+    socket.on('close', () => this._sockets.delete(socket));
+    socket.on('error', () => {});
+    socket.on('data', (chunk) => {
+      buffered += chunk.toString('latin1');
+      let newline;
+      while ((newline = buffered.indexOf('\n')) !== -1) {
+        const line = buffered.slice(0, newline).trim();
+        buffered = buffered.slice(newline + 1);
+        if (!line) {
+          continue;
+        }
+        const reply = this._execute(state, line);
+        if (reply === null) {
+          socket.end();
+          return;
+        }
+        // Replies stay in command order even with jitter.
+        replying = replying.then(() => this._delay()).then(() => {
+          if (!socket.destroyed) {
+            socket.write(reply);
+          }
+        });
+      }
+    });
+  }
+
+  _delay() {
+    const ms = this.latencyMs + (this.jitterMs > 0 ? Math.random() * this.jitterMs : 0);
+    return ms > 0 ? new Promise((resolve) => setTimeout(resolve, ms)) : Promise.resolve();
+  }
+
+  _execute(state, line) {
+    this.commands++;
+    const [command, ...args] = line.split(/\s+/);
+    switch (command) {
+      case '\\chk_vfo':
+        return '0\n';
+      case '\\dump_state':
+        return DUMP_STATE;
+      case 'f':
+      case '\\get_freq':
+        return `${state.frequency}\n`;
+      case 'F':
+      case '\\set_freq':
+        state.frequency = Math.round(Number(args[0]));
+        return 'RPRT 0\n';
+      case 'm':
+      case '\\get_mode':
+        return `${state.mode}\n${state.width}\n`;
+      case 'M':
+      case '\\set_mode':
+        state.mode = args[0];
+        state.width = Number(args[1]) > 0 ? Number(args[1]) : 2400;
+        return 'RPRT 0\n';
+      case 'v':
+      case '\\get_vfo':
+        return `${state.vfo}\n`;
+      case 'V':
+      case '\\set_vfo':
+        state.vfo = args[0];
+        return 'RPRT 0\n';
+      case 't':
+      case '\\get_ptt':
+        return `${state.ptt}\n`;
+      case 'T':
+      case '\\set_ptt':
+        state.ptt = Number(args[0]) || 0;
+        return 'RPRT 0\n';
+      case 'l':
+      case '\\get_level':
+        if (args[0] === 'STRENGTH') {
+          return `${-54 + Math.round(Math.random() * 10)}\n`;
+        }
+        return `${state.levels[args[0]] !== undefined ? state.levels[args[0]] : 0}\n`;
+      case 'L':
+      case '\\set_level':
+        state.levels[args[0]] = Number(args[1]);
+        return 'RPRT 0\n';
+      case 'q':
+      case 'Q':
+        return null;
+      default:
+        return 'RPRT -11\n';
+    }
+  }
+}
+
+module.exports = { FakeRigctld };
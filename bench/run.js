@@ -0,0 +1,548 @@
+#!/usr/bin/env node
+'use strict';
+
+/**
+ * Native benchmark suite.
+ *
+ * Runs fixed scenarios against the Dummy rig (model 1) and against a local
+ * fake rigctld (model 2) that answers after a configurable delay, standing in
+ * for a slow serial rig. Results are printed as a table on stderr and as JSON
+ * on stdout (--json) or to a file (--out); --baseline compares against an
+ * earlier JSON file and exits with 1 on a regression.
+ *
+ *   npm run bench
+ *   npm run bench -- --scenario=single-op,multi-rig --latency-ms=5 --out=bench.json
+ *   npm run bench -- --baseline=bench.json --tolerance=0.25
+ */
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { HamLib } = require('../index.js');
+const { FakeRigctld } = require('./fake_rigctld');
+
+const SCENARIOS = ['single-op', 'pipelined', 'batch', 'multi-rig', 'spectrum-flood'];
+const BACKENDS = ['dummy', 'fake'];
+
+const DEFAULTS = {
+  scenario: SCENARIOS.join(','),
+  backend: BACKENDS.join(','),
+  iterations: 2000,
+  fakeIterations: 200,
+  warmup: 50,
+  concurrency: 8,
+  rigs: 4,
+  latencyMs: 2,
+  jitterMs: 0,
+  spectrumLines: 20000,
+  json: false,
+  out: null,
+  baseline: null,
+  tolerance: 0.2,
+};
+
+function parseArgs(argv) {
+  const options = { ...DEFAULTS };
+  for (const arg of argv) {
+    if (!arg.startsWith('--')) {
+      throw new Error(`Unexpected argument: ${arg}`);
+    }
+    const [rawKey, ...rest] = arg.slice(2).split('=');
+    const value = rest.join('=');
+    const key = rawKey.replace(/-([a-z])/g, (_, c) => c.toUpperCase());
+    switch (key) {
+      case 'scenario':
+      case 'backend':
+      case 'out':
+      case 'baseline':
+        options[key] = value;
+        break;
+      case 'iterations':
+      case 'fakeIterations':
+      case 'warmup':
+      case 'concurrency':
+      case 'rigs':
+      case 'latencyMs':
+      case 'jitterMs':
+      case 'spectrumLines':
+      case 'tolerance':
+        options[key] = Number(value);
+        if (!Number.isFinite(options[key]) || options[key] < 0) {
+          throw new Error(`--${rawKey} must be a non-negative number`);
+        }
+        break;
+      case 'json':
+        options.json = value !== 'false';
+        break;
+      case 'help':
+        printHelp();
+        process.exit(0);
+        break;
+      default:
+        throw new Error(`Unknown argument: --${rawKey}`);
+    }
+  }
+  options.scenarios = options.scenario.split(',').filter(Boolean);
+  options.backends = options.backend.split(',').filter(Boolean);
+  for (const name of options.scenarios) {
+    if (!SCENARIOS.includes(name)) {
+      throw new Error(`Unknown scenario: ${name} (expected ${SCENARIOS.join(', ')})`);
+    }
+  }
+  for (const name of options.backends) {
+    if (!BACKENDS.includes(name)) {
+      throw new Error(`Unknown backend: ${name} (expected ${BACKENDS.join(', ')})`);
+    }
+  }
+  return options;
+}
+
+function printHelp() {
+  console.log(`Usage:
+  node bench/run.js [options]
+
+Options:
+  --scenario=<list>        ${SCENARIOS.join(',')} (default: all)
+  --backend=<list>         dummy,fake (default: both); spectrum-flood always uses dummy
+  --iterations=<n>         Calls per case against the Dummy rig, default ${DEFAULTS.iterations}
+  --fake-iterations=<n>    Calls per case against the fake rigctld, default ${DEFAULTS.fakeIterations}
+  --warmup=<n>             Untimed calls before each case, default ${DEFAULTS.warmup}
+  --concurrency=<n>        Calls in flight for the pipelined scenario, default ${DEFAULTS.concurrency}
+  --rigs=<n>               Instances for the multi-rig scenario, default ${DEFAULTS.rigs}
+  --latency-ms=<ms>        Fake rigctld reply delay, default ${DEFAULTS.latencyMs}
+  --jitter-ms=<ms>         Extra random fake rigctld delay, default ${DEFAULTS.jitterMs}
+  --spectrum-lines=<n>     Lines injected per spectrum-flood case, default ${DEFAULTS.spectrumLines}
+  --json                   Print the JSON report on stdout
+  --out=<file>             Write the JSON report to a file
+  --baseline=<file>        Compare against an earlier JSON report; exit 1 on a regression
+  --tolerance=<fraction>   Allowed ops/s drop and p99 growth against the baseline, default ${DEFAULTS.tolerance}
+`);
+}
+
+function log(message) {
+  process.stderr.write(`${message}\n`);
+}
+
+function percentile(sorted, fraction) {
+  if (sorted.length === 0) {
+    return 0;
+  }
+  const index = Math.min(sorted.length - 1, Math.ceil(sorted.length * fraction) - 1);
+  return sorted[Math.max(0, index)];
+}
+
+function round(value) {
+  return Math.round(value * 1000) / 1000;
+}
+
+// Per-call latencies in ms and the wall time of the whole case.
+function summarize(latencies, elapsedMs, calls) {
+  const sorted = Float64Array.from(latencies).sort();
+  const sum = latencies.reduce((total, value) => total + value, 0);
+  return {
+    calls,
+    elapsedMs: round(elapsedMs),
+    opsPerSec: round(calls / (elapsedMs / 1000)),
+    latencyMs: {
+      mean: round(sorted.length ? sum / sorted.length : 0),
+      p50: round(percentile(sorted, 0.5)),
+      p90: round(percentile(sorted, 0.9)),
+      p99: round(percentile(sorted, 0.99)),
+      max: round(sorted.length ? sorted[sorted.length - 1] : 0),
+    },
+  };
+}
+
+// Native lock wait and execute percentiles of the operations a case ran.
+function nativeSummary(stats, operations) {
+  const native = {};
+  for (const name of operations) {
+    const entry = stats.operations[name];
+    if (!entry) {
+      continue;
+    }
+    native[name] = {
+      calls: entry.calls,
+      errors: entry.errors,
+      lockWaitP99Ms: entry.lockWait.p99Ms,
+      executeP50Ms: entry.execute.p50Ms,
+      executeP99Ms: entry.execute.p99Ms,
+    };
+  }
+  return native;
+}
+
+function nowMs() {
+  return Number(process.hrtime.bigint()) / 1e6;
+}
+
+async function timeCalls(count, call) {
+  const latencies = new Array(count);
+  const started = nowMs();
+  for (let i = 0; i < count; i++) {
+    const callStarted = nowMs();
+    await call(i);
+    latencies[i] = nowMs() - callStarted;
+  }
+  return { latencies, elapsedMs: nowMs() - started };
+}
+
+async function timeConcurrent(count, concurrency, call) {
+  const latencies = [];
+  let next = 0;
+  const started = nowMs();
+  async function lane() {
+    while (next < count) {
+      const index = next++;
+      const callStarted = nowMs();
+      await call(index);
+      latencies.push(nowMs() - callStarted);
+    }
+  }
+  await Promise.all(Array.from({ length: Math.max(1, concurrency) }, lane));
+  return { latencies, elapsedMs: nowMs() - started };
+}
+
+async function warmup(rig, count) {
+  for (let i = 0; i < count; i++) {
+    await rig.getFrequency();
+  }
+}
+
+const SINGLE_OPS = {
+  getFrequency: (rig) => rig.getFrequency(),
+  setFrequency: (rig, i) => rig.setFrequency(14074000 + (i % 100) * 10),
+  getLevel: (rig) => rig.getLevel('STRENGTH'),
+};
+
+async function runSingleOp(context, backend) {
+  const results = [];
+  for (const [op, call] of Object.entries(SINGLE_OPS)) {
+    const rig = await context.openRig(backend);
+    try {
+      await warmup(rig, context.options.warmup);
+      rig.resetStats();
+      const { latencies, elapsedMs } = await timeCalls(context.iterations(backend), (i) => call(rig, i));
+      results.push({
+        id: `single-op/${backend}/${op}`,
+        scenario: 'single-op',
+        backend,
+        case: op,
+        ...summarize(latencies, elapsedMs, latencies.length),
+        native: nativeSummary(rig.getStats(), [op]),
+      });
+    } finally {
+      await context.closeRig(rig);
+    }
+  }
+  return results;
+}
+
+async function runPipelined(context, backend) {
+  const results = [];
+  for (const commandThread of [false, true]) {
+    const rig = await context.openRig(backend);
+    try {
+      if (commandThread) {
+        rig.enableCommandThread();
+      }
+      await warmup(rig, context.options.warmup);
+      rig.resetStats();
+      const { latencies, elapsedMs } = await timeConcurrent(
+        context.iterations(backend), context.options.concurrency, () => rig.getFrequency());
+      const mode = commandThread ? 'command-thread' : 'threadpool';
+      results.push({
+        id: `pipelined/${backend}/${mode}`,
+        scenario: 'pipelined',
+        backend,
+        case: mode,
+        concurrency: context.options.concurrency,
+        ...summarize(latencies, elapsedMs, latencies.length),
+        native: nativeSummary(rig.getStats(), ['getFrequency']),
+      });
+    } finally {
+      await context.closeRig(rig);
+    }
+  }
+  return results;
+}
+
+const BATCH = [
+  { op: 'getFrequency' },
+  { op: 'getMode' },
+  { op: 'getVfo' },
+  { op: 'getPtt' },
+  { op: 'getLevel', level: 'STRENGTH' },
+  { op: 'setFrequency', frequency: 14074000 },
+  { op: 'getFrequency' },
+  { op: 'getLevel', level: 'STRENGTH' },
+];
+
+async function runBatch(context, backend) {
+  const rig = await context.openRig(backend);
+  try {
+    await warmup(rig, context.options.warmup);
+    rig.resetStats();
+    // Each batch counts as BATCH.length operations.
+    const batches = Math.max(1, Math.round(context.iterations(backend) / BATCH.length));
+    let failed = 0;
+    const { latencies, elapsedMs } = await timeCalls(batches, async () => {
+      const entries = await rig.batch(BATCH);
+      failed += entries.filter((entry) => !entry.ok).length;
+    });
+    const result = summarize(latencies, elapsedMs, batches * BATCH.length);
+    return [{
+      id: `batch/${backend}/${BATCH.length}-ops`,
+      scenario: 'batch',
+      backend,
+      case: `${BATCH.length}-ops`,
+      ...result,
+      // Latencies are per batch; opsPerSec counts the operations inside.
+      batches,
+      batchesPerSec: round(batches / (elapsedMs / 1000)),
+      failedItems: failed,
+      native: nativeSummary(rig.getStats(), ['batch']),
+    }];
+  } finally {
+    await context.closeRig(rig);
+  }
+}
+
+async function runMultiRig(context, backend) {
+  const results = [];
+  const previousScope = HamLib.getLockScope();
+  try {
+    for (const scope of ['global', 'instance']) {
+      HamLib.setLockScope(scope);
+      const rigs = [];
+      try {
+        for (let i = 0; i < context.options.rigs; i++) {
+          rigs.push(await context.openRig(backend));
+        }
+        for (const rig of rigs) {
+          await warmup(rig, Math.min(context.options.warmup, 10));
+        }
+        HamLib.resetStats();
+        const perRig = Math.max(1, Math.round(context.iterations(backend) / rigs.length));
+        const runs = await Promise.all(rigs.map((rig) => timeCalls(perRig, () => rig.getFrequency())));
+        const latencies = [].concat(...runs.map((run) => run.latencies));
+        const elapsedMs = Math.max(...runs.map((run) => run.elapsedMs));
+        results.push({
+          id: `multi-rig/${backend}/${scope}`,
+          scenario: 'multi-rig',
+          backend,
+          case: scope,
+          rigs: rigs.length,
+          ...summarize(latencies, elapsedMs, latencies.length),
+          native: nativeSummary(HamLib.getStats(), ['getFrequency']),
+        });
+      } finally {
+        for (const rig of rigs) {
+          await context.closeRig(rig);
+        }
+      }
+    }
+  } finally {
+    HamLib.setLockScope(previousScope);
+  }
+  return results;
+}
+
+async function waitFor(predicate, timeoutMs) {
+  const started = Date.now();
+  while (!predicate()) {
+    if (Date.now() - started > timeoutMs) {
+      return false;
+    }
+    await new Promise((resolve) => setTimeout(resolve, 5));
+  }
+  return true;
+}
+
+async function runSpectrumFlood(context) {
+  const results = [];
+  const cases = [
+    { name: 'line', stream: { batchLines: 1 } },
+    { name: 'batch-16', stream: { batchLines: 16, bufferLines: 1024 } },
+    { name: 'keep-latest', stream: { overflow: 'keep-latest' } },
+    { name: 'processing', stream: { batchLines: 16, bufferLines: 1024, processing: { averageAlpha: 0.5, bins: 128 } } },
+  ];
+  for (const testCase of cases) {
+    const rig = await context.openRig('dummy');
+    try {
+      let callbacks = 0;
+      let lastDeliveryMs = 0;
+      await rig.startSpectrumStream(() => {
+        callbacks++;
+        lastDeliveryMs = nowMs();
+      }, testCase.stream);
+      const count = context.options.spectrumLines;
+      const started = nowMs();
+      const injected = await rig._injectSpectrumLines(count);
+      const settled = await waitFor(() => rig.getSpectrumStreamStats().pending === 0, 10000);
+      const stats = rig.getSpectrumStreamStats();
+      await rig.stopSpectrumStream();
+      const elapsedMs = Math.max(lastDeliveryMs, started + injected.elapsedMs) - started;
+      results.push({
+        id: `spectrum-flood/dummy/${testCase.name}`,
+        scenario: 'spectrum-flood',
+        backend: 'dummy',
+        case: testCase.name,
+        calls: count,
+        elapsedMs: round(elapsedMs),
+        // Lines the JS side received per second of the whole flood.
+        opsPerSec: round(stats.delivered / (elapsedMs / 1000)),
+        injectMs: round(injected.elapsedMs),
+        callbacks,
+        settled,
+        spectrum: {
+          received: stats.received,
+          delivered: stats.delivered,
+          dropped: stats.dropped,
+          coalesced: stats.coalesced,
+          poolMisses: stats.poolMisses,
+        },
+      });
+    } finally {
+      await context.closeRig(rig);
+    }
+  }
+  return results;
+}
+
+const RUNNERS = {
+  'single-op': runSingleOp,
+  pipelined: runPipelined,
+  batch: runBatch,
+  'multi-rig': runMultiRig,
+};
+
+function compareToBaseline(report, baseline, tolerance) {
+  const previous = new Map(baseline.results.map((result) => [result.id, result]));
+  const regressions = [];
+  for (const result of report.results) {
+    const before = previous.get(result.id);
+    if (!before) {
+      continue;
+    }
+    if (before.opsPerSec > 0 && result.opsPerSec < before.opsPerSec * (1 - tolerance)) {
+      regressions.push(`${result.id}: ${result.opsPerSec} ops/s, baseline ${before.opsPerSec}`);
+    }
+    if (result.latencyMs && before.latencyMs && before.latencyMs.p99 > 0 &&
+        result.latencyMs.p99 > before.latencyMs.p99 * (1 + tolerance)) {
+      regressions.push(`${result.id}: p99 ${result.latencyMs.p99} ms, baseline ${before.latencyMs.p99} ms`);
+    }
+  }
+  return regressions;
+}
+
+function printTable(results) {
+  log('');
+  log('case'.padEnd(40) + 'ops/s'.padStart(12) + 'p50 ms'.padStart(10) + 'p99 ms'.padStart(10) + 'max ms'.padStart(10));
+  for (const result of results) {
+    const latency = result.latencyMs || {};
+    const cell = (value) => (value === undefined ? '-' : String(value));
+    log(result.id.padEnd(40) + cell(result.opsPerSec).padStart(12) + cell(latency.p50).padStart(10) +
+      cell(latency.p99).padStart(10) + cell(latency.max).padStart(10));
+  }
+  log('');
+}
+
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const fake = new FakeRigctld({ latencyMs: options.latencyMs, jitterMs: options.jitterMs });
+  let fakeAddress = null;
+  if (options.backends.includes('fake')) {
+    fakeAddress = await fake.listen();
+  }
+
+  const open = new Set();
+  const context = {
+    options,
+    iterations: (backend) => (backend === 'fake' ? options.fakeIterations : options.iterations),
+    async openRig(backend) {
+      const rig = backend === 'fake' ? new HamLib(2, fakeAddress) : new HamLib(1);
+      await rig.open();
+      open.add(rig);
+      return rig;
+    },
+    async closeRig(rig) {
+      open.delete(rig);
+      await rig.close().catch(() => {});
+      await rig.destroy().catch(() => {});
+    },
+  };
+
+  const report = {
+    version: 1,
+    timestamp: new Date().toISOString(),
+    node: process.version,
+    hamlib: HamLib.getHamlibVersion(),
+    platform: `${os.platform()}-${os.arch()}`,
+    cpus: os.cpus().length,
+    options: {
+      iterations: options.iterations,
+      fakeIterations: options.fakeIterations,
+      concurrency: options.concurrency,
+      rigs: options.rigs,
+      latencyMs: options.latencyMs,
+      jitterMs: options.jitterMs,
+      spectrumLines: options.spectrumLines,
+    },
+    results: [],
+    skipped: [],
+  };
+
+  try {
+    for (const scenario of options.scenarios) {
+      const backends = scenario === 'spectrum-flood' ? ['dummy'] : options.backends;
+      for (const backend of backends) {
+        log(`running ${scenario} on ${backend}...`);
+        try {
+          const results = scenario === 'spectrum-flood'
+            ? await runSpectrumFlood(context)
+            : await RUNNERS[scenario](context, backend);
+          report.results.push(...results);
+        } catch (error) {
+          // A backend the local Hamlib build cannot open skips its cases only.
+          report.skipped.push({ scenario, backend, reason: error.message });
+          log(`  skipped: ${error.message}`);
+        }
+      }
+    }
+  } finally {
+    for (const rig of open) {
+      await context.closeRig(rig);
+    }
+    await fake.close();
+  }
+
+  printTable(report.results);
+  const json = JSON.stringify(report, null, 2);
+  if (options.out) {
+    fs.writeFileSync(path.resolve(options.out), `${json}\n`);
+    log(`wrote ${options.out}`);
+  }
+  if (options.json) {
+    process.stdout.write(`${json}\n`);
+  }
+
+  if (options.baseline) {
+    const baseline = JSON.parse(fs.readFileSync(path.resolve(options.baseline), 'utf8'));
+    const regressions = compareToBaseline(report, baseline, options.tolerance);
+    if (regressions.length > 0) {
+      log(`${regressions.length} regression(s) against ${options.baseline}:`);
+      for (const line of regressions) {
+        log(`  ${line}`);
+      }
+      process.exitCode = 1;
+    } else {
+      log(`no regressions against ${options.baseline} (tolerance ${options.tolerance})`);
+    }
+  }
+}
+
+main().catch((error) => {
+  log(error && error.stack ? error.stack : String(error));
+  process.exit(1);
+});
@@ -5,7 +5,28 @@
       "sources": [
         "src/hamlib.cpp",
         "src/node_rotator.cpp",
+        "src/node_hamlib_group.cpp",
+        "src/rig_executor.cpp",
+        "src/rig_metrics.cpp",
+        "src/rig_metrics_js.cpp",
+        "src/rig_priority.cpp",
+        "src/rig_state_cache.cpp",
+        "src/rig_capabilities.cpp",
+        "src/rig_catalog.cpp",
+        "src/rig_model_index.cpp",
+        "src/rig_tokens.cpp",
+        "src/rig_background_job.cpp",
+        "src/rig_tracker.cpp",
+        "src/raw_stream.cpp",
+        "src/rig_sweep.cpp",
+        "src/rig_trace.cpp",
+        "src/rigctld_session.cpp",
+        "src/spectrum_ring.cpp",
+        "src/spectrum_dsp.cpp",
+        "src/spectrum_recorder.cpp",
+        "src/node_spectrum_recording.cpp",
         "src/decoder.cpp",
+        "src/addon_data.cpp",
         "src/addon.cpp"
       ],
       "include_dirs": [
@@ -48,6 +48,44 @@ interface SupportedRigInfo {
   rigType: string;
 }
 
+/**
+ * Result of HamLib.getSupportedRigsColumnar(). Row i describes one model;
+ * string columns hold indices into `strings`.
+ */
+interface SupportedRigColumns {
+  count: number;
+  rigModel: Uint32Array;
+  modelName: Uint32Array;
+  mfgName: Uint32Array;
+  version: Uint32Array;
+  status: Uint32Array;
+  rigType: Uint32Array;
+  /** Every distinct string, once */
+  strings: string[];
+}
+
+/**
+ * A loaded model index, see HamLib.loadModelIndex()
+ */
+interface ModelIndexInfo {
+  path: string;
+  models: number;
+  bytes: number;
+  /** Hamlib version the index was built with (always the running one) */
+  hamlibVersion: string;
+}
+
+/**
+ * Result of HamLib.buildModelIndex()
+ */
+interface ModelIndexBuildResult {
+  path: string;
+  models: number;
+  /** Models listed without port caps or config schema (rig_init failed) */
+  incomplete: number;
+  bytes: number;
+}
+
 interface SupportedRotatorInfo {
   rotModel: number;
   modelName: string;
@@ -194,6 +232,32 @@ interface FilterInfo {
   width: number;
 }
 
+/**
+ * Every capability query answered in one object, captured once per open()
+ */
+interface CapabilitySnapshot {
+  /** Capture time, milliseconds since the epoch */
+  capturedAt: number;
+  levels: string[];
+  functions: string[];
+  parms: string[];
+  modes: string[];
+  vfoOps: VfoOperationType[];
+  scanTypes: ScanType[];
+  preampValues: number[];
+  attenuatorValues: number[];
+  agcLevels: number[];
+  maxRit: number;
+  maxXit: number;
+  maxIfShift: number;
+  ctcssTones: number[];
+  dcsCodes: number[];
+  frequencyRanges: { rx: FrequencyRange[]; tx: FrequencyRange[] };
+  tuningSteps: TuningStepInfo[];
+  filters: FilterInfo[];
+  spectrum: SpectrumCapabilities;
+}
+
 interface LevelGranularityInfo {
   min: number;
   max: number;
@@ -221,6 +285,566 @@ interface RfPowerStepInfo {
  */
 type RigDebugLevel = 0 | 1 | 2 | 3 | 4 | 5;
 
+/**
+ * One entry of HamLib.batch()
+ */
+type BatchOperation =
+  | { op: 'getFrequency'; vfo?: VFO }
+  | { op: 'getMode' }
+  | { op: 'getVfo' }
+  | { op: 'getPtt'; vfo?: VFO }
+  | { op: 'getStrength'; vfo?: VFO }
+  | { op: 'getLevel'; level: LevelType; vfo?: VFO }
+  | { op: 'getFunction'; function: FunctionType }
+  | { op: 'setFrequency'; frequency: number; vfo?: VFO }
+  | { op: 'setMode'; mode: RadioMode; bandwidth?: PassbandSelector; vfo?: VFO }
+  | { op: 'setPtt'; ptt: boolean }
+  | { op: 'setVfo'; vfo: VFO }
+  | { op: 'setLevel'; level: LevelType; value: number; vfo?: VFO }
+  | { op: 'setFunction'; function: FunctionType; enable: boolean };
+
+interface BatchOptions {
+  /** Keep executing after a failed item (default true) */
+  continueOnError?: boolean;
+}
+
+/**
+ * Result of one batch operation. `value` matches what the equivalent single
+ * method resolves (number, boolean, VFO token or { mode, bandwidth }).
+ */
+type BatchResult =
+  | { op: string; ok: true; value: number | boolean | string | { mode: string; bandwidth: number } }
+  | { op: string; ok: false; code: 'HAMLIB_ERROR'; hamlibCode: number; message: string };
+
+/**
+ * Hamlib transceive mode: 'rig' lets the rig push its own changes
+ */
+type TransceiveMode = 'off' | 'rig' | 'poll';
+
+/** Payload of the 'frequency_change' event */
+interface FrequencyChangeEvent {
+  vfo: string;
+  frequency: number;
+  timestamp: number;
+}
+
+/** Payload of the 'mode_change' event */
+interface ModeChangeEvent {
+  vfo: string;
+  mode: string;
+  bandwidth: number;
+  timestamp: number;
+}
+
+/** Payload of the 'ptt_change' event */
+interface PttChangeEvent {
+  vfo: string;
+  ptt: boolean;
+  timestamp: number;
+}
+
+/**
+ * One item of HamLib.startPolling(): any get* batch operation plus its period.
+ */
+type PollItem = Extract<BatchOperation, { op: 'getFrequency' | 'getMode' | 'getVfo' | 'getPtt' | 'getStrength' | 'getLevel' | 'getFunction' }> & {
+  /** Poll period in milliseconds, 10 - 3600000 (default 1000) */
+  intervalMs?: number;
+  /** Key reported in change events (default derived from op, level/function and vfo, e.g. 'getLevel:SWR') */
+  key?: string;
+};
+
+/**
+ * A polled value that changed. The first successful reading of every item is
+ * reported too, without `previous`.
+ */
+type PollChange = {
+  key: string;
+  op: string;
+  /** Position of the item in the startPolling() array */
+  index: number;
+  /** Wall-clock time of the poll round (ms since epoch) */
+  timestamp: number;
+} & (
+  | { ok: true; value: number | boolean | string | { mode: string; bandwidth: number }; previous?: number | boolean | string | { mode: string; bandwidth: number } }
+  | { ok: false; code: 'HAMLIB_ERROR'; hamlibCode: number; message: string; previous?: number | boolean | string | { mode: string; bandwidth: number } }
+);
+
+/**
+ * One row of a HamLib.startTracking() schedule. Each field other than time is
+ * given in every point or in none; absent fields are not commanded.
+ */
+interface TrackingPoint {
+  /** Epoch milliseconds */
+  time: number;
+  /** Degrees, interpolated as given: pass unwrapped values to cross north */
+  azimuth?: number;
+  elevation?: number;
+  /** Hz, sent with setFrequency */
+  rxFrequency?: number;
+  /** Hz, sent with setSplitFreq; split must already be enabled */
+  txFrequency?: number;
+}
+
+/**
+ * Options for HamLib.startTracking()
+ */
+interface TrackingOptions {
+  /** Required when the points carry azimuth/elevation */
+  rotator?: Rotator;
+  /** Step period in milliseconds, 10 - 60000 (default 250) */
+  stepMs?: number;
+  vfo?: VFO;
+  /** Minimum frequency change worth sending, in Hz (default 10) */
+  frequencyDeadbandHz?: number;
+  /** Minimum position change worth sending, in degrees (default 1) */
+  azimuthDeadband?: number;
+  elevationDeadband?: number;
+}
+
+/**
+ * A tracking step that sent or failed to send something
+ */
+interface TrackingProgressEvent {
+  type: 'step';
+  /** Wall-clock time of the step (ms since epoch) */
+  timestamp: number;
+  /** Schedule segment the step fell in */
+  index: number;
+  /** How long after its deadline the step started */
+  lateMs: number;
+  azimuth?: number;
+  elevation?: number;
+  rxFrequency?: number;
+  txFrequency?: number;
+  sent: { rxFrequency: boolean; txFrequency: boolean; position: boolean };
+  errors: Array<{ target: 'rxFrequency' | 'txFrequency' | 'position'; code: 'HAMLIB_ERROR'; hamlibCode: number; message: string }>;
+}
+
+/**
+ * The schedule ran past its last point, or the rig or rotator was closed
+ */
+interface TrackingEndEvent {
+  type: 'end';
+  timestamp: number;
+  reason: 'complete' | 'closed';
+}
+
+interface TrackingStatus {
+  running: boolean;
+  points: number;
+  startTime: number;
+  endTime: number;
+  steps: number;
+  /** Steps that started more than half a step late */
+  lateSteps: number;
+  /** Steps whose commands were skipped because the lock stayed busy */
+  skippedSteps: number;
+  maxLateMs: number;
+  commands: { rxFrequency: number; txFrequency: number; position: number };
+  errors: number;
+}
+
+/**
+ * Options for HamLib.startSweep()
+ */
+interface SweepOptions {
+  /** First bin, in Hz */
+  startFreq: number;
+  /** Last bin is the last step at or below this frequency */
+  stopFreq: number;
+  /** Bin spacing; a sweep has 2 to 2048 bins */
+  stepHz: number;
+  /** Wait between tuning a bin and reading its STRENGTH, 0 to 1000 (default 0) */
+  dwellMs?: number;
+  /** Most bins measured per rig lock hold; a hold also ends after about 100 ms (default 16) */
+  chunkPoints?: number;
+  /** Sweeps to run (default 0: until stopSweep()) */
+  sweeps?: number;
+  vfo?: VFO;
+  /** scopeId of the emitted lines (default 0) */
+  scopeId?: number;
+  /** STRENGTH mapped to bin value 0 (default -54, S0) */
+  strengthMinDb?: number;
+  /** STRENGTH mapped to bin value 255 (default 60, S9+60) */
+  strengthMaxDb?: number;
+  /** Tune back to the starting frequency when the sweep ends (default true) */
+  restoreFrequency?: boolean;
+}
+
+interface SweepEndEvent {
+  type: 'end';
+  reason: 'complete' | 'error' | 'closed';
+  sweeps: number;
+  timestamp: number;
+  code?: 'HAMLIB_ERROR';
+  hamlibCode?: number;
+  message?: string;
+}
+
+interface SweepStatus {
+  running: boolean;
+  /** Bins per sweep */
+  points: number;
+  sweeps: number;
+  readings: number;
+  /** Bins whose tune or read failed */
+  errors: number;
+  /** Finished sweeps dropped because the spectrum stream was not running */
+  unsentLines: number;
+  lastSweepMs: number;
+}
+
+/**
+ * Options for HamLib.startRawStream()
+ */
+interface RawStreamOptions {
+  /** Frames end with this byte */
+  terminator: Buffer;
+  /** Sent once before the first read */
+  command?: Buffer;
+  /** Size of each pooled frame buffer (default 1024) */
+  frameBytes?: number;
+  /** Pooled buffers, and the most frames waiting for JS before reading pauses (default 32) */
+  poolFrames?: number;
+  /** End after this many frames (default 0: until the rig stops sending) */
+  maxFrames?: number;
+}
+
+interface RawFrameEvent {
+  type: 'frame';
+  sequence: number;
+  timestamp: number;
+  /** Lent from the pool; it returns there once the Buffer is collected */
+  data: Buffer;
+}
+
+interface RawStreamEndEvent {
+  type: 'end';
+  /** 'idle': a read timed out or returned nothing */
+  reason: 'complete' | 'idle' | 'error' | 'closed';
+  frames: number;
+  bytes: number;
+  timestamp: number;
+  /** Set for reason 'error' */
+  code?: 'HAMLIB_ERROR';
+  hamlibCode?: number;
+  message?: string;
+}
+
+interface RawStreamStatus {
+  running: boolean;
+  frames: number;
+  bytes: number;
+  /** Frames read but not yet delivered */
+  pending: number;
+  /** Reads that waited for JS to drain the backlog */
+  stalls: number;
+  frameBytes: number;
+  poolFrames: number;
+  /** Frames queued or still referenced from JS */
+  inUse: number;
+  /** Frames read into a heap buffer because every pooled one was in use */
+  poolMisses: number;
+}
+
+/**
+ * Options for HamLib.enableCommandThread()
+ */
+interface CommandThreadOptions {
+  /** Maximum number of queued commands per priority class, rounded up to a power of two (default 256) */
+  queueCapacity?: number;
+}
+
+/**
+ * Command thread queue statistics
+ */
+interface CommandThreadStats {
+  /** Whether the command thread is currently enabled */
+  enabled: boolean;
+  queueCapacity: number;
+  /** Commands waiting to run right now */
+  queueDepth: number;
+  /** Highest queue depth observed */
+  maxQueueDepth: number;
+  submitted: number;
+  completed: number;
+  /** Commands refused because the queue was full */
+  rejected: number;
+  /** Number of batched completions delivered to JS */
+  batches: number;
+  /** Mean time between enqueue and start of execution */
+  avgWaitMs: number;
+  maxWaitMs: number;
+}
+
+/**
+ * Options for HamLib.enableStateCache()
+ */
+interface StateCacheOptions {
+  /** Default maximum age of a cached answer in milliseconds (default 250) */
+  maxAgeMs?: number;
+}
+
+/**
+ * Per-call override for cached getters
+ */
+interface CachedReadOptions {
+  /** Maximum acceptable age in milliseconds; 0 always reads from the rig */
+  maxAgeMs?: number;
+}
+
+/**
+ * State cache counters
+ */
+interface StateCacheStats {
+  enabled: boolean;
+  maxAgeMs: number;
+  /** Getter calls answered from the cache */
+  hits: number;
+  /** Getter calls that went to the rig while the cache was enabled */
+  misses: number;
+  /** Misses where the cached value was older than allowed */
+  stale: number;
+  updates: number;
+  invalidations: number;
+  /** hits / (hits + misses) */
+  hitRate: number;
+}
+
+/**
+ * Latency histogram of one operation phase. Buckets are HDR-style: exact to
+ * the microsecond below 16us, then within 12.5%; percentiles report the
+ * bucket's upper bound.
+ */
+interface LatencyHistogramStats {
+  count: number;
+  sumMs: number;
+  meanMs: number;
+  maxMs: number;
+  p50Ms: number;
+  p90Ms: number;
+  p99Ms: number;
+  p999Ms: number;
+  /** Non-empty buckets only; counts are per bucket, not cumulative */
+  buckets: Array<{ leMs: number; count: number }>;
+}
+
+/**
+ * Metrics for one native operation (keyed by its operation name)
+ */
+interface OperationStats {
+  /** Completed calls, including failed ones */
+  calls: number;
+  errors: number;
+  /** Calls that gave up waiting for the rig lock (HAMLIB_GLOBAL_LOCK_TIMEOUT) */
+  lockTimeouts: number;
+  /** Calls refused because the command thread queue was full */
+  rejected: number;
+  /** Hamlib result code (as a string key, e.g. "-5") to count; "0" is a native error without a Hamlib code */
+  errorsByCode: Record<string, number>;
+  /** Time spent waiting for the rig lock */
+  lockWait: LatencyHistogramStats;
+  /** Time spent executing with the lock held */
+  execute: LatencyHistogramStats;
+}
+
+/**
+ * In-flight native commands
+ */
+interface OperationQueueStats {
+  /** Queued and not yet started */
+  pending: number;
+  /** Started and waiting for the rig lock */
+  waitingForLock: number;
+  /** Running with the rig lock held */
+  executing: number;
+  /** Highest pending count observed */
+  maxPending: number;
+}
+
+/**
+ * Scheduling class of a native command; see HamLib.setCommandPriorities()
+ */
+type CommandPriority = 'realtime' | 'interactive' | 'background';
+
+/**
+ * Calls of one priority class
+ */
+interface PriorityLaneStats {
+  calls: number;
+  /** Background commands refused with HAMLIB_COMMAND_SHED */
+  shed: number;
+  /** Queued to finished: queue wait, lock wait and execution */
+  latency: LatencyHistogramStats;
+}
+
+/**
+ * Options for HamLib.setCommandPriorities()
+ */
+interface CommandPriorityOptions {
+  /**
+   * Shed background commands with HAMLIB_COMMAND_SHED while this many
+   * commands are queued or running on the rig; 0 (default) never sheds
+   */
+  backgroundBudget?: number;
+  /** Class per operation (method or getStats() name); null restores the default */
+  operations?: Record<string, CommandPriority | null>;
+}
+
+interface CommandPriorityConfig {
+  backgroundBudget: number;
+  /** Commands queued or running on this rig */
+  inflight: number;
+  /** Overrides set with setCommandPriorities() */
+  operations: Record<string, CommandPriority>;
+}
+
+/**
+ * Options of rig.withCallOptions(). A stopped call rejects with code
+ * HAMLIB_ABORTED (name AbortError) or HAMLIB_DEADLINE_EXCEEDED (name
+ * TimeoutError) and does not touch the rig.
+ */
+interface CallOptions {
+  /** Cancels calls that have not reached the rig yet */
+  signal?: AbortSignal;
+  /** Per call, from the method call until the call reaches the rig */
+  deadlineMs?: number;
+}
+
+/**
+ * Result of rig.getStats() / HamLib.getStats()
+ */
+interface HamLibStats {
+  /** Epoch milliseconds of creation or the last resetStats() */
+  since: number;
+  operations: Record<string, OperationStats>;
+  queue: OperationQueueStats;
+  lanes: Record<CommandPriority, PriorityLaneStats>;
+}
+
+interface RigStats extends HamLibStats {
+  commandThread: CommandThreadStats;
+  coalescing: RequestCoalescingStats;
+}
+
+/**
+ * Result of rotator.getStats()
+ */
+interface RotatorStats extends HamLibStats {
+  position: {
+    /** Current setPositionDeadband() values in degrees; 0 is disabled */
+    deadbandAzimuth: number;
+    deadbandElevation: number;
+    /** setPosition calls that replaced a target not yet sent to the rotator */
+    coalesced: number;
+    /** setPosition calls resolved without a command because they fell inside the deadband */
+    suppressed: number;
+  };
+}
+
+/**
+ * Options for HamLib.enableTrace()
+ */
+interface TraceOptions {
+  /** Events kept, 64 - 1048576, rounded up to a power of two (default 4096) */
+  capacity?: number;
+}
+
+/**
+ * One Chrome trace event. Calls are nestable async spans ('b' / 'e', keyed
+ * by id) named after the operation, with queue, lockWait, execute and resolve
+ * children; 'X' slices show the shim call on the thread that ran it.
+ */
+interface ChromeTraceEvent {
+  name: string;
+  cat: string;
+  ph: 'b' | 'e' | 'X' | 'M';
+  /** Monotonic microseconds */
+  ts: number;
+  dur?: number;
+  pid: number;
+  tid: number;
+  id?: string;
+  args?: Record<string, unknown>;
+}
+
+/**
+ * Result of HamLib.dumpTrace(); JSON.stringify() it into a .json trace file
+ */
+interface ChromeTrace {
+  traceEvents: ChromeTraceEvent[];
+  displayTimeUnit: 'ms';
+  otherData: {
+    enabled: boolean;
+    capacity: number;
+    /** Events recorded since enable / the last clear, including overwritten ones */
+    recorded: number;
+    overwritten: number;
+    calls: number;
+  };
+}
+
+/**
+ * Options for HamLib.openSharedSession()
+ */
+interface SharedSessionOptions {
+  /** Connect timeout and the longest wait for a reply, 100 - 600000 ms (default 5000) */
+  timeoutMs?: number;
+}
+
+interface SharedSessionInfo {
+  /** Normalized host:port the session is keyed by */
+  address: string;
+  /** rigctld runs with --vfo, so commands name their VFO */
+  vfoMode: boolean;
+  /** Instances attached, including this one */
+  clients: number;
+}
+
+interface SharedSessionStats extends SharedSessionInfo {
+  connected: boolean;
+  /** Pipelined writes (one per batch, or per item without continueOnError) */
+  groups: number;
+  commands: number;
+  /** Groups failed by a closed or timed-out connection */
+  errors: number;
+  /** Commands written and not yet answered */
+  inflight: number;
+  maxInflight: number;
+  /** Submit to last reply of each group */
+  latency: LatencyHistogramStats;
+}
+
+/**
+ * Options for HamLib.enableRequestCoalescing()
+ */
+interface RequestCoalescingOptions {
+  /** Share the promise of an identical read that is still queued or running (default true) */
+  reads?: boolean;
+  /** Merge setFrequency calls for the same VFO into one not yet sent to the rig (default true) */
+  writes?: boolean;
+}
+
+interface RequestCoalescingStats {
+  reads: boolean;
+  writes: boolean;
+  /** Read calls that joined an in-flight read */
+  coalescedReads: number;
+  /** setFrequency calls merged into a pending write */
+  coalescedWrites: number;
+}
+
+interface GlobalHamLibStats extends HamLibStats {
+  /** Operations currently holding a rig lock */
+  lockHolders: Array<{ operation: string; scope: RigLockScope; heldMs: number }>;
+}
+
+/**
+ * Native radio I/O lock scope
+ * Selects which mutex serializes Hamlib calls across HamLib instances
+ */
+type RigLockScope = 'global' | 'port' | 'instance';
+
 type MemoryType = 'NONE' | 'MEM' | 'EDGE' | 'CALL' | 'MEMOPAD' | 'SAT' | 'BAND' | 'PRIO' | 'VOICE' | 'MORSE' | 'SPLIT';
 type RepeaterShift = 'None' | 'Minus' | 'Plus' | 'NONE' | 'MINUS' | 'PLUS' | '-' | '+' | string;
 
@@ -338,8 +962,39 @@ interface MemoryListResult {
   errors: MemoryChannelError[];
 }
 
+interface MemoryStreamOptions extends MemoryListOptions {
+  /** Slots read per rig-lock acquisition (default 32) */
+  chunkSize?: number;
+  /** Checked before each chunk, and cancels a chunk still waiting for the rig */
+  signal?: AbortSignal;
+  /** Budget for the whole scan; a chunk started after it rejects with HAMLIB_DEADLINE_EXCEEDED */
+  deadlineMs?: number;
+}
+
+interface MemoryStreamChunk {
+  layout: MemoryLayout;
+  channels: MemoryChannel[];
+  errors: MemoryChannelError[];
+  /** Slots read so far, including this chunk */
+  scanned: number;
+  /** Slots in the layout */
+  total: number;
+}
+
+interface MemoryDiffOptions {
+  /** Compare each channel with the rig and write only those that differ */
+  diff?: boolean;
+  /** Known current image (e.g. list().channels) used instead of reading; implies diff */
+  baseline?: MemoryChannel[];
+}
+
 interface MemoryWriteResult {
+  /** Channels written, including cleared ones */
   written: number;
+  /** Channels left alone because they already matched (diff mode) */
+  skipped: number;
+  /** Written channels whose target was empty */
+  cleared: number;
   errors: MemoryChannelError[];
 }
 
@@ -350,8 +1005,10 @@ interface MemoryFacade {
   get(channelNumber: number, options?: { readOnly?: boolean }): Promise<MemoryChannel>;
   set(channel: MemoryChannelInput): Promise<number>;
   list(options?: MemoryListOptions): Promise<MemoryListResult>;
-  setMany(channels: MemoryChannelInput[], options?: { continueOnError?: boolean }): Promise<MemoryWriteResult>;
-  replaceAll(channels: MemoryChannelInput[]): Promise<MemoryWriteResult>;
+  /** Chunked list(); the rig lock is released between chunks */
+  stream(options?: MemoryStreamOptions): AsyncGenerator<MemoryStreamChunk, void, undefined>;
+  setMany(channels: MemoryChannelInput[], options?: { continueOnError?: boolean } & MemoryDiffOptions): Promise<MemoryWriteResult>;
+  replaceAll(channels: MemoryChannelInput[], options?: MemoryDiffOptions): Promise<MemoryWriteResult>;
   current(vfo?: VFO): Promise<number>;
   select(channelNumber: number, vfo?: VFO): Promise<number>;
   setBank(bank: number, vfo?: VFO): Promise<number>;
@@ -388,6 +1045,161 @@ interface SpectrumLine {
   timestamp: number;
 }
 
+/**
+ * Options for HamLib.startSpectrumStream()
+ */
+interface SpectrumStreamOptions {
+  /**
+   * What to discard when JS falls behind: 'drop-oldest' (default) drops the
+   * oldest undelivered line; 'keep-latest' keeps only the newest undelivered
+   * line per scopeId.
+   */
+  overflow?: 'drop-oldest' | 'keep-latest';
+  /** Maximum undelivered lines, 1 - 4096 (default 64, or 2 * batchLines) */
+  bufferLines?: number;
+  /**
+   * Lines packed into one SpectrumFrame per callback, 1 - 1024 (default 1:
+   * one SpectrumLine per callback).
+   */
+  batchLines?: number;
+  /** Deliver a partial frame once its oldest line is this old, 1 - 10000 ms (default 50) */
+  maxLatencyMs?: number;
+  /** Native DSP applied on Hamlib's reader thread before lines are queued */
+  processing?: SpectrumProcessingOptions;
+}
+
+/**
+ * Native spectrum processing, in order: normalize, average, peak hold,
+ * decimate. Average and peak state is kept per scope and restarts when the
+ * scope's mode, span or edges change.
+ */
+interface SpectrumProcessingOptions {
+  /** Exponential average weight of the newest line, 0.001 - 1 (default 1 = off) */
+  averageAlpha?: number;
+  /** Hold the maximum level of each bin */
+  peakHold?: boolean;
+  /** Levels the held peak falls per line, 0 - 255 (default 0) */
+  peakDecay?: number;
+  /** Decimate each line to this many bins (lines already this short are left alone) */
+  bins?: number;
+  /** How bins are merged when decimating (default 'max') */
+  decimation?: 'max' | 'mean';
+  /** Rescale dataLevelMin..dataLevelMax to 0..255 (and report 0/255 as the new levels) */
+  normalize?: boolean;
+}
+
+/**
+ * Column indices of SpectrumFrame.meta; row i starts at i * frame.stride.
+ */
+interface SpectrumFrameFields {
+  readonly scopeId: 0;
+  readonly mode: 1;
+  readonly centerFreq: 2;
+  readonly spanHz: 3;
+  readonly lowEdgeFreq: 4;
+  readonly highEdgeFreq: 5;
+  readonly timestamp: 6;
+  /** Byte offset of the line's payload in SpectrumFrame.data */
+  readonly dataOffset: 7;
+  readonly dataLength: 8;
+  readonly dataLevelMin: 9;
+  readonly dataLevelMax: 10;
+  readonly signalStrengthMin: 11;
+  readonly signalStrengthMax: 12;
+}
+
+/**
+ * Several spectrum lines delivered together (startSpectrumStream({ batchLines }))
+ */
+interface SpectrumFrame {
+  /** Number of lines in this frame */
+  lines: number;
+  /** meta values per line */
+  stride: number;
+  /** Every line's payload, back to back */
+  data: Uint8Array;
+  /** Per-line metadata, `lines * stride` values laid out as SpectrumFrameFields */
+  meta: Float64Array;
+}
+
+interface SpectrumStreamStats {
+  running: boolean;
+  overflow: 'drop-oldest' | 'keep-latest';
+  bufferLines: number;
+  batchLines: number;
+  maxLatencyMs: number;
+  /** Whether a native processing stage is attached */
+  processing: boolean;
+  /** Lines received from Hamlib */
+  received: number;
+  /** Lines handed to JS */
+  delivered: number;
+  /** Lines discarded because the backlog was full */
+  dropped: number;
+  /** Lines replaced by a newer line of the same scope ('keep-latest') */
+  coalesced: number;
+  /** Lines waiting for the JS thread */
+  pending: number;
+  /** Delivered lines whose data Buffer is still referenced from JS */
+  inUse: number;
+  /** Lines that needed a heap slot because every pooled slot was in use */
+  poolMisses: number;
+}
+
+/**
+ * Options for HamLib.startSpectrumRecording()
+ */
+interface SpectrumRecordingOptions {
+  /** Bytes mapped and reserved on disk at a time, 64 KiB - 1 GiB (default 16 MiB) */
+  segmentBytes?: number;
+  /** Minimum spacing of time index entries, 1 - 3600000 ms (default 1000) */
+  indexIntervalMs?: number;
+}
+
+interface SpectrumRecordingStats {
+  recording: boolean;
+  path: string | null;
+  lines: number;
+  dataBytes: number;
+  indexEntries: number;
+  startTime: number;
+  endTime: number;
+  /** Lines skipped while the writer thread was 256 lines behind */
+  droppedLines: number;
+  /** Writing stopped after an I/O error (e.g. disk full); see `error` */
+  failed: boolean;
+  error: string | null;
+}
+
+interface SpectrumRecordingInfo {
+  version: number;
+  lines: number;
+  dataBytes: number;
+  indexEntries: number;
+  startTime: number;
+  endTime: number;
+  recordHeaderBytes: number;
+}
+
+interface SpectrumRecordingReadOptions {
+  /** Upper bound of the returned buffer (default 16 MiB; at least one record is returned) */
+  maxBytes?: number;
+  /** `endOffset` of a previous read, to continue without seeking */
+  offset?: number;
+}
+
+interface SpectrumRecordingChunk {
+  /** Raw records; split with SpectrumRecording.decode() */
+  data: Buffer;
+  lines: number;
+  startTime: number;
+  endTime: number;
+  startOffset: number;
+  endOffset: number;
+  /** False when maxBytes cut the range short */
+  complete: boolean;
+}
+
 interface SpectrumCapabilities {
   asyncDataSupported?: boolean;
   scopes: SpectrumScopeInfo[];
@@ -406,6 +1218,8 @@ interface SpectrumSupportSummary extends SpectrumCapabilities {
   supportsFixedEdges: boolean;
   supportsEdgeSlotSelection: boolean;
   supportedEdgeSlots: number[];
+  /** STRENGTH is readable, so HamLib.startSweep() can build a line without a hardware scope */
+  sweepSupported: boolean;
 }
 
 type SpectrumDisplayMode = 'center' | 'fixed' | 'scroll-center' | 'scroll-fixed';
@@ -479,6 +1293,17 @@ type FunctionType = 'FAGC' | 'NB' | 'COMP' | 'VOX' | 'TONE' | 'TSQL' | 'SBKIN' |
                     'SEND_MORSE' | 'SEND_VOICE_MEM' | 'OVF_STATUS' |
                     'TBURST' | string;
 
+/**
+ * Pre-parsed level from HamLib.getLevelHandle(); accepted wherever a level
+ * name is, without parsing the string again
+ */
+type LevelHandle = number & { readonly __brand: 'LevelHandle' };
+
+/**
+ * Pre-parsed function from HamLib.getFunctionHandle()
+ */
+type FunctionHandle = number & { readonly __brand: 'FunctionHandle' };
+
 /**
  * Scan type
  */
@@ -647,7 +1472,8 @@ declare class HamLib extends EventEmitter {
   readonly memory: MemoryFacade;
 
   /**
-   * Get list of all supported radio models
+   * Get list of all supported radio models, sorted by model number. The
+   * backends are enumerated once per process; later calls reuse that list.
    * @returns Array of supported radio models with details
    * @static
    * @example
@@ -659,6 +1485,29 @@ declare class HamLib extends EventEmitter {
    */
   static getSupportedRigs(): SupportedRigInfo[];
 
+  /**
+   * Like getSupportedRigs(), but the first enumeration of the backends runs
+   * off the JS thread.
+   */
+  static getSupportedRigsAsync(): Promise<SupportedRigInfo[]>;
+
+  /**
+   * Supported radio models as typed-array columns and one string table,
+   * without creating an object per model.
+   * @example
+   * const cols = HamLib.getSupportedRigsColumnar();
+   * for (let i = 0; i < cols.count; i++) {
+   *   if (cols.strings[cols.mfgName[i]] === 'Icom') console.log(cols.rigModel[i]);
+   * }
+   */
+  static getSupportedRigsColumnar(): SupportedRigColumns;
+
+  /**
+   * Look up one model without building the whole list.
+   * @returns null if Hamlib does not know the model
+   */
+  static getSupportedRig(model: number): SupportedRigInfo | null;
+
   /**
    * Get Hamlib library version information
    * @returns Hamlib version string including version number, build date, and architecture
@@ -722,6 +1571,46 @@ declare class HamLib extends EventEmitter {
    */
   static isGlobalLockEnabled(): boolean;
 
+  /**
+   * Choose which mutex serializes native radio I/O.
+   *
+   * - `global` (default): one process-wide lock, the historical behavior.
+   * - `port`: one lock per device (serial path or rigctld host:port), so rigs
+   *   on different ports run in parallel. Rigs without an explicit port share
+   *   a lock per model, since they open the same backend default device.
+   * - `instance`: one lock per HamLib instance.
+   *
+   * Instances opened on the same explicit port share a lock in every scope,
+   * and models marked with setBackendSerialized() always use the global lock.
+   * Set NODE_HAMLIB_LOCK_SCOPE before loading the package to pick the initial
+   * scope. Throws while a rig command, poll round, tracking schedule, raw
+   * stream or sweep is running, so every lock held on a rig picks the same
+   * scope; change it before starting work on the rigs.
+   */
+  static setLockScope(scope: RigLockScope): void;
+
+  /**
+   * Returns the current native radio I/O lock scope.
+   */
+  static getLockScope(): RigLockScope;
+
+  /**
+   * Process-wide call counts, errors and lock-wait / execute latency
+   * histograms for every native operation, plus current lock holders.
+   */
+  static getStats(): GlobalHamLibStats;
+
+  /**
+   * Clears the counters returned by HamLib.getStats().
+   */
+  static resetStats(): void;
+
+  /**
+   * Force a backend model onto the global lock regardless of the lock scope.
+   * NODE_HAMLIB_SERIALIZED_MODELS accepts a comma-separated list of models.
+   */
+  static setBackendSerialized(model: number, serialized: boolean): void;
+
   /**
    * Get backend-specific configuration schema for a rig model without creating
    * a live HamLib instance or acquiring the live rig I/O lock.
@@ -734,6 +1623,32 @@ declare class HamLib extends EventEmitter {
    */
   static getPortCapsForModel(model: number): HamlibPortCaps;
 
+  /**
+   * Enumerate every backend and write a model index (names, port caps,
+   * config schemas) for the running Hamlib. Defaults to
+   * getDefaultModelIndexPath(); `npm run build` does this.
+   */
+  static buildModelIndex(path?: string): ModelIndexBuildResult;
+
+  /**
+   * Memory-map a model index so getSupportedRigs(), getSupportedRig(),
+   * getConfigSchemaForModel() and getPortCapsForModel() need no backend
+   * initialisation. The default index is loaded on require; set
+   * NODE_HAMLIB_MODEL_INDEX to another path, or '0' to skip it.
+   * @throws If the file is malformed or was built for another Hamlib version
+   */
+  static loadModelIndex(path: string): ModelIndexInfo;
+
+  /**
+   * The model index in use, or null
+   */
+  static getModelIndexInfo(): ModelIndexInfo | null;
+
+  /**
+   * hamlib-models.idx next to the addon binary
+   */
+  static getDefaultModelIndexPath(): string;
+
   /**
    * Open connection to device
    * Must be called before other operations
@@ -782,9 +1697,10 @@ declare class HamLib extends EventEmitter {
 
   /**
    * Get current VFO
+   * @param options Optional state cache age bound (see enableStateCache)
    * @returns Current VFO identifier
    */
-  getVfo(): Promise<VFO>;
+  getVfo(options?: CachedReadOptions): Promise<VFO>;
 
   /**
    * Get current frequency
@@ -794,15 +1710,18 @@ declare class HamLib extends EventEmitter {
    * await rig.getFrequency(); // Get frequency from current VFO
    * await rig.getFrequency('VFOA'); // Get frequency from VFOA
    * await rig.getFrequency('VFOB'); // Get frequency from VFOB
+   * await rig.getFrequency(undefined, { maxAgeMs: 500 }); // Cached value if at most 500 ms old
    */
-  getFrequency(vfo?: VFO): Promise<number>;
+  getFrequency(vfo?: VFO, options?: CachedReadOptions): Promise<number>;
+  getFrequency(options: CachedReadOptions): Promise<number>;
 
   /**
    * Get current radio mode
+   * @param options Optional state cache age bound (see enableStateCache)
    * @returns Object containing mode and bandwidth information
    * @note Operates on the current VFO (RIG_VFO_CURR)
    */
-  getMode(): Promise<ModeInfo>;
+  getMode(options?: CachedReadOptions): Promise<ModeInfo>;
 
   /**
    * Get current signal strength
@@ -832,6 +1751,237 @@ declare class HamLib extends EventEmitter {
    */
   getConnectionInfo(): ConnectionInfo;
 
+  /**
+   * Run several get/set operations in one native round trip, under a single
+   * rig lock acquisition, and resolve one result entry per operation in order.
+   *
+   * With `continueOnError` (default true), failing items are reported inline
+   * as `{ ok: false, ... }`. With false, the batch stops at the first failure
+   * and the promise rejects.
+   *
+   * @example
+   * const [freq, swr] = await rig.batch([
+   *   { op: 'getFrequency' },
+   *   { op: 'getLevel', level: 'SWR' },
+   * ]);
+   */
+  batch(operations: BatchOperation[], options?: BatchOptions): Promise<BatchResult[]>;
+
+  /**
+   * Route this rig's native calls through one dedicated native thread fed by a
+   * bounded queue, instead of one libuv threadpool slot per call. Results are
+   * settled in batches. When the queue is full, calls reject with code
+   * HAMLIB_COMMAND_QUEUE_FULL. NODE_HAMLIB_COMMAND_THREAD=1 enables this for
+   * every new instance. Calling it while already enabled is a no-op.
+   */
+  enableCommandThread(options?: CommandThreadOptions): void;
+
+  /**
+   * Stop the dedicated command thread. Already-queued commands still settle;
+   * later calls use the libuv threadpool again.
+   */
+  disableCommandThread(): void;
+
+  /**
+   * Queue depth and wait-time statistics for the command thread
+   */
+  getCommandThreadStats(): CommandThreadStats;
+
+  /**
+   * Per-operation metrics for this rig, plus command thread statistics
+   */
+  getStats(): RigStats;
+
+  /**
+   * Clears the counters returned by getStats().
+   */
+  resetStats(): void;
+
+  /**
+   * Record native call trace events (construction, Execute() entry, lock
+   * acquired, shim return, settlement) into a lock-free ring.
+   * NODE_HAMLIB_TRACE=1 enables it for every new instance.
+   */
+  enableTrace(options?: TraceOptions): void;
+
+  /**
+   * Stop recording; the ring is kept for dumpTrace()
+   */
+  disableTrace(): void;
+
+  /**
+   * The trace ring as Chrome trace-event JSON (chrome://tracing, Perfetto)
+   */
+  dumpTrace(options?: { clear?: boolean }): ChromeTrace;
+
+  /**
+   * Attach this network rig to a pipelined rigctld connection shared by all
+   * instances on the same host:port. batch() and the plain-argument
+   * get/set frequency, mode, VFO, PTT, level and getStrength calls use it;
+   * they bypass the rig lock, call options and stats. Rejects with code
+   * HAMLIB_SESSION_ERROR when rigctld cannot be reached.
+   */
+  openSharedSession(options?: SharedSessionOptions): Promise<SharedSessionInfo>;
+
+  /**
+   * Detach from the shared session; calls go back to Hamlib's connection
+   */
+  closeSharedSession(): void;
+
+  /**
+   * Shared session statistics, or null when none is attached
+   */
+  getSharedSessionStats(): SharedSessionStats | null;
+
+  /**
+   * Coalesce requests: identical reads (same operation, VFO and level or
+   * function) that are still queued or running share one promise, and a
+   * setFrequency for the same VFO replaces the value of one that has not
+   * reached the rig yet, so a knob-spinning burst sends only the latest
+   * value (all merged callers resolve together). Any other command is a
+   * barrier, so ordering against other writes is kept.
+   */
+  enableRequestCoalescing(options?: RequestCoalescingOptions): void;
+
+  /**
+   * Stops coalescing; callers already sharing a command still settle together
+   */
+  disableRequestCoalescing(): void;
+
+  /**
+   * Configure command priority classes. Waiters for the rig lock are served
+   * realtime first, then interactive, then background, and the command
+   * thread keeps one queue per class; order is kept within a class. A command
+   * already talking to the rig is never interrupted. Defaults: setPtt,
+   * sendMorse and stopMorse are realtime, getLevel and getStrength are
+   * background (as is startPolling()), everything else is interactive.
+   * @example
+   * rig.setCommandPriorities({ backgroundBudget: 4, operations: { getSwr: 'background' } });
+   */
+  setCommandPriorities(options: CommandPriorityOptions): void;
+
+  getCommandPriorities(): CommandPriorityConfig;
+
+  /**
+   * The same API with every async method (rig.memory included) scoped to an
+   * AbortSignal and/or deadline. Work stopped before it reaches the rig is
+   * dropped; memory list reads and waitMorse also stop between steps, other
+   * commands already at the rig finish normally. Scoped calls do not take
+   * part in request coalescing.
+   * @example
+   * const controller = new AbortController();
+   * rig.withCallOptions({ signal: controller.signal, deadlineMs: 500 }).getLevel('STRENGTH');
+   * controller.abort();
+   */
+  withCallOptions(options: CallOptions): this;
+
+  /**
+   * Enable the frequency/mode/VFO state cache. Successful get/set calls, batch
+   * and poll reads and transceive events fill it; getFrequency, getMode and
+   * getVfo then resolve from it without a CAT round trip while the value is
+   * no older than maxAgeMs. Calls that may change state behind it (VFO
+   * operations, memory select, scan, raw commands, reset) clear it.
+   */
+  enableStateCache(options?: StateCacheOptions): void;
+
+  /**
+   * Disables the state cache and drops its entries
+   */
+  disableStateCache(): void;
+
+  /**
+   * Hit/miss counters for tuning maxAgeMs
+   */
+  getStateCacheStats(): StateCacheStats;
+
+  /**
+   * Set the Hamlib transceive mode. With 'rig' (the default applied by open()),
+   * rigs that broadcast their own changes emit frequency_change, mode_change
+   * and ptt_change events, so they need not be polled. Some backends also need
+   * their async conf enabled. Stored for the next open(); applied immediately
+   * when the rig is open, rejecting if the backend refuses it.
+   */
+  setTransceive(mode: TransceiveMode): Promise<number>;
+
+  /**
+   * Transceive mode applied on open()
+   */
+  getTransceive(): TransceiveMode;
+
+  /**
+   * Listen for changes pushed by the rig in transceive mode.
+   */
+  on(event: 'frequency_change', listener: (event: FrequencyChangeEvent) => void): this;
+  once(event: 'frequency_change', listener: (event: FrequencyChangeEvent) => void): this;
+  off(event: 'frequency_change', listener: (event: FrequencyChangeEvent) => void): this;
+  on(event: 'mode_change', listener: (event: ModeChangeEvent) => void): this;
+  once(event: 'mode_change', listener: (event: ModeChangeEvent) => void): this;
+  off(event: 'mode_change', listener: (event: ModeChangeEvent) => void): this;
+  on(event: 'ptt_change', listener: (event: PttChangeEvent) => void): this;
+  once(event: 'ptt_change', listener: (event: PttChangeEvent) => void): this;
+  off(event: 'ptt_change', listener: (event: PttChangeEvent) => void): this;
+
+  /**
+   * Poll get* items natively on a per-rig poll thread and report only the
+   * values that changed. Each item has its own period; all items due in the
+   * same round share one rig lock acquisition, and a round whose lock stays
+   * busy for a whole period is skipped. Rounds are skipped while the rig is
+   * closed. Without a callback, each change is emitted as a 'pollChange' event.
+   * @returns Poll id for stopPolling()
+   * @example
+   * rig.startPolling([
+   *   { op: 'getFrequency', intervalMs: 200 },
+   *   { op: 'getPtt', intervalMs: 100 },
+   *   { op: 'getLevel', level: 'SWR', intervalMs: 250 },
+   * ]);
+   * rig.on('pollChange', (change) => console.log(change.key, change.value));
+   */
+  startPolling(items: PollItem[], callback?: (changes: PollChange[]) => void): number;
+
+  /**
+   * Stop one poll set, or all of them when no id is given.
+   * @returns true if anything was stopped
+   */
+  stopPolling(pollId?: number): boolean;
+
+  /**
+   * Listen for changes reported by startPolling() without a callback.
+   */
+  on(event: 'pollChange', listener: (change: PollChange) => void): this;
+  once(event: 'pollChange', listener: (change: PollChange) => void): this;
+  off(event: 'pollChange', listener: (change: PollChange) => void): this;
+
+  /**
+   * Follow a time-indexed schedule, such as a satellite pass computed from a
+   * TLE, on a native thread. Every stepMs the schedule is linearly
+   * interpolated at the current time (holding the first point before it
+   * starts) and the frequency and rotator position are sent once they leave
+   * their deadband. Step deadlines are absolute, so slow commands do not make
+   * the loop drift. Only steps that sent or failed something are reported.
+   * Starting a new schedule replaces the running one.
+   * @example
+   * rig.startTracking(pass.map(p => ({ time: p.time, azimuth: p.az, elevation: p.el, rxFrequency: p.rx })),
+   *   { rotator, stepMs: 200 });
+   * rig.on('trackingEnd', () => console.log('LOS'));
+   */
+  startTracking(points: TrackingPoint[], options?: TrackingOptions, callback?: (event: TrackingProgressEvent | TrackingEndEvent) => void): void;
+
+  /**
+   * Stop the running schedule; no 'trackingEnd' event follows.
+   * @returns true if a schedule was running
+   */
+  stopTracking(): boolean;
+
+  /** Counters of the current or last schedule; null before the first one */
+  getTrackingStatus(): TrackingStatus | null;
+
+  on(event: 'trackingProgress', listener: (event: TrackingProgressEvent) => void): this;
+  once(event: 'trackingProgress', listener: (event: TrackingProgressEvent) => void): this;
+  off(event: 'trackingProgress', listener: (event: TrackingProgressEvent) => void): this;
+  on(event: 'trackingEnd', listener: (event: TrackingEndEvent) => void): this;
+  once(event: 'trackingEnd', listener: (event: TrackingEndEvent) => void): this;
+  off(event: 'trackingEnd', listener: (event: TrackingEndEvent) => void): this;
+
   // Memory Channel Management
 
   /**
@@ -912,7 +2062,7 @@ declare class HamLib extends EventEmitter {
    * @param levelType Level type ('AF', 'RF', 'SQL', 'RFPOWER', etc.)
    * @param value Level value (0.0-1.0 typically)
    */
-  setLevel(levelType: LevelType, value: number, vfo?: VFO): Promise<number>;
+  setLevel(levelType: LevelType | LevelHandle, value: number, vfo?: VFO): Promise<number>;
 
   /**
    * Get radio level
@@ -920,7 +2070,7 @@ declare class HamLib extends EventEmitter {
    * @param vfo Optional Hamlib VFO token. If not specified, uses current VFO.
    * @returns Level value
    */
-  getLevel(levelType: LevelType, vfo?: VFO): Promise<number>;
+  getLevel(levelType: LevelType | LevelHandle, vfo?: VFO): Promise<number>;
 
   /**
    * Get list of supported level types
@@ -935,14 +2085,14 @@ declare class HamLib extends EventEmitter {
    * @param functionType Function type ('NB', 'COMP', 'VOX', 'TONE', etc.)
    * @param enable true to enable, false to disable
    */
-  setFunction(functionType: FunctionType, enable: boolean): Promise<number>;
+  setFunction(functionType: FunctionType | FunctionHandle, enable: boolean): Promise<number>;
 
   /**
    * Get radio function status
    * @param functionType Function type ('NB', 'COMP', 'VOX', 'TONE', etc.)
    * @returns Function enabled status
    */
-  getFunction(functionType: FunctionType): Promise<boolean>;
+  getFunction(functionType: FunctionType | FunctionHandle): Promise<boolean>;
 
   /**
    * Get list of supported function types
@@ -1600,21 +2750,100 @@ declare class HamLib extends EventEmitter {
    */
   sendRaw(data: Buffer, replyMaxLen: number, terminator?: Buffer): Promise<Buffer>;
 
+  /**
+   * Send raw command bytes and write the reply straight into `reply`, whose
+   * length is the maximum reply length. Neither Buffer is copied; leave them
+   * untouched until the promise settles.
+   * @returns Number of reply bytes written
+   */
+  sendRawInto(data: Buffer, reply: Buffer, terminator?: Buffer): Promise<number>;
+
+  /**
+   * Read terminator-delimited raw frames into a reusable buffer pool on a
+   * native thread, taking the rig lock for each read so other commands run
+   * between frames. Without a callback, 'rawFrame' and 'rawStreamEnd' events
+   * are emitted.
+   */
+  startRawStream(options: RawStreamOptions, callback?: (event: RawFrameEvent | RawStreamEndEvent) => void): void;
+
+  /**
+   * Stop the raw stream; undelivered frames are dropped and no end event follows.
+   * @returns true if a stream was running
+   */
+  stopRawStream(): boolean;
+
+  /** Counters of the current or last raw stream, null before the first one */
+  getRawStreamStatus(): RawStreamStatus | null;
+
+  /**
+   * Sweep a frequency range by tuning each bin and reading STRENGTH on a
+   * native thread. Each finished sweep goes into the running spectrum stream
+   * as one fixed-mode line, so startSpectrumStream() must be running. Without
+   * a callback, a 'sweepEnd' event is emitted.
+   */
+  startSweep(options: SweepOptions, callback?: (event: SweepEndEvent) => void): void;
+
+  /**
+   * Stop the sweep; the rig is tuned back and no end event follows.
+   * @returns true if a sweep was running
+   */
+  stopSweep(): boolean;
+
+  /** Counters of the current or last sweep, null before the first one */
+  getSweepStatus(): SweepStatus | null;
+
+  on(event: 'sweepEnd', listener: (event: SweepEndEvent) => void): this;
+  once(event: 'sweepEnd', listener: (event: SweepEndEvent) => void): this;
+  off(event: 'sweepEnd', listener: (event: SweepEndEvent) => void): this;
+
+  on(event: 'rawFrame', listener: (frame: RawFrameEvent) => void): this;
+  once(event: 'rawFrame', listener: (frame: RawFrameEvent) => void): this;
+  off(event: 'rawFrame', listener: (frame: RawFrameEvent) => void): this;
+  on(event: 'rawStreamEnd', listener: (event: RawStreamEndEvent) => void): this;
+  once(event: 'rawStreamEnd', listener: (event: RawStreamEndEvent) => void): this;
+  off(event: 'rawStreamEnd', listener: (event: RawStreamEndEvent) => void): this;
+
   /**
    * Get official Hamlib spectrum metadata exposed by the backend.
    */
   getSpectrumCapabilities(): Promise<SpectrumCapabilities>;
 
   /**
-   * Start receiving official Hamlib spectrum line events.
+   * Start receiving official Hamlib spectrum line events. Lines are queued
+   * natively without blocking Hamlib's reader thread; `line.data` is backed by
+   * native memory rather than copied.
    */
-  startSpectrumStream(callback?: (line: SpectrumLine) => void): Promise<boolean>;
+  startSpectrumStream(callback?: (line: SpectrumLine) => void, options?: SpectrumStreamOptions): Promise<boolean>;
+  startSpectrumStream(options: SpectrumStreamOptions): Promise<boolean>;
+  /**
+   * Batched mode (`batchLines > 1`): the callback receives SpectrumFrame
+   * objects; without a callback, 'spectrumFrame' is emitted.
+   */
+  startSpectrumStream(callback: (frame: SpectrumFrame) => void, options: SpectrumStreamOptions & { batchLines: number }): Promise<boolean>;
+
+  /**
+   * Delivery and drop counters of the current (or last) spectrum stream.
+   */
+  getSpectrumStreamStats(): SpectrumStreamStats;
 
   /**
    * Stop receiving official Hamlib spectrum line events.
    */
   stopSpectrumStream(): Promise<boolean>;
 
+  /**
+   * Append every spectrum line to a memory-mapped recording file (continuing
+   * an existing recording at `path`); the time index lives in `${path}.idx`.
+   */
+  startSpectrumRecording(path: string, options?: SpectrumRecordingOptions): Promise<boolean>;
+
+  /**
+   * Stop recording and trim the file; resolves with the final stats.
+   */
+  stopSpectrumRecording(): Promise<SpectrumRecordingStats>;
+
+  getSpectrumRecordingStats(): SpectrumRecordingStats;
+
   /**
    * Listen for official spectrum line events.
    */
@@ -1622,6 +2851,13 @@ declare class HamLib extends EventEmitter {
   once(event: 'spectrumLine', listener: (line: SpectrumLine) => void): this;
   off(event: 'spectrumLine', listener: (line: SpectrumLine) => void): this;
 
+  /**
+   * Listen for batched spectrum frames (startSpectrumStream({ batchLines }) without a callback).
+   */
+  on(event: 'spectrumFrame', listener: (frame: SpectrumFrame) => void): this;
+  once(event: 'spectrumFrame', listener: (frame: SpectrumFrame) => void): this;
+  off(event: 'spectrumFrame', listener: (frame: SpectrumFrame) => void): this;
+
   /**
    * Listen for asynchronous spectrum errors.
    */
@@ -1759,6 +2995,59 @@ declare class HamLib extends EventEmitter {
    */
   getFilterList(): Promise<FilterInfo[]>;
 
+  /**
+   * Get all capability queries at once. open() captures the snapshot in the
+   * same locked pass; after that this and the individual capability getters
+   * resolve from memory without queueing a rig command. close() discards it.
+   */
+  getCapabilitySnapshot(): Promise<CapabilitySnapshot>;
+
+  /**
+   * Synchronous state reads served from the state cache (see enableStateCache).
+   * Never queue a rig command; null on a miss or when the entry is older than
+   * `maxAgeMs` (default: the cache's configured age).
+   * @example
+   * rig.enableStateCache({ maxAgeMs: 1000 });
+   * await rig.setFrequency(14074000);
+   * rig.getFrequencySync(); // 14074000, no rig I/O
+   */
+  getFrequencySync(vfo?: VFO, options?: CachedReadOptions): number | null;
+  getFrequencySync(options: CachedReadOptions): number | null;
+  getModeSync(options?: CachedReadOptions): ModeInfo | null;
+  getVfoSync(options?: CachedReadOptions): VFO | null;
+
+  /**
+   * Synchronous capability getters served from the snapshot taken by open().
+   * They throw when called before open() has captured it.
+   */
+  getSupportedLevelsSync(): string[];
+  getSupportedFunctionsSync(): string[];
+  getSupportedModesSync(): string[];
+  getSupportedParmsSync(): string[];
+  getSupportedVfoOpsSync(): VfoOperationType[];
+  getSupportedScanTypesSync(): ScanType[];
+  getPreampValuesSync(): number[];
+  getAttenuatorValuesSync(): number[];
+  getAgcLevelsSync(): number[];
+  getMaxRitSync(): number;
+  getMaxXitSync(): number;
+  getMaxIfShiftSync(): number;
+  getAvailableCtcssTonesSync(): number[];
+  getAvailableDcsCodesSync(): number[];
+  getFrequencyRangesSync(): { rx: FrequencyRange[]; tx: FrequencyRange[] };
+  getTuningStepsSync(): TuningStepInfo[];
+  getFilterListSync(): FilterInfo[];
+  getSpectrumCapabilitiesSync(): SpectrumCapabilities;
+  getCapabilitySnapshotSync(): CapabilitySnapshot;
+
+  /**
+   * Synchronous power conversions using Hamlib's range-based formula. Return
+   * null when the backend supplies its own conversion (which may talk to the
+   * rig; use power2mW()/mW2power()) or no TX range covers the frequency.
+   */
+  power2mWSync(power: number, frequency: number, mode: RadioMode): number | null;
+  mW2powerSync(milliwatts: number, frequency: number, mode: RadioMode): number | null;
+
   /**
    * Get granularity metadata for a level setting from Hamlib rig state.
    */
@@ -1769,6 +3058,21 @@ declare class HamLib extends EventEmitter {
    */
   getRfPowerStepTable(frequency: number, mode: RadioMode): Promise<RfPowerStepInfo[] | null>;
 
+  // ===== Static: Token handles =====
+
+  /**
+   * Parse a level name once; pass the handle to setLevel()/getLevel() in
+   * hot loops to skip name parsing. Throws TypeError for unknown names.
+   * @static
+   */
+  static getLevelHandle(levelType: LevelType): LevelHandle;
+
+  /**
+   * Parse a function name once for setFunction()/getFunction().
+   * @static
+   */
+  static getFunctionHandle(functionType: FunctionType): FunctionHandle;
+
   // ===== Static: Copyright / License =====
 
   /**
@@ -1818,6 +3122,62 @@ declare class HamLib extends EventEmitter {
   getVfoInfo(vfo?: VFO): Promise<VfoInfo>;
 }
 
+/**
+ * Reader for files written by HamLib.startSpectrumRecording()
+ */
+declare class SpectrumRecording {
+  constructor(path: string);
+  static open(path: string): SpectrumRecording;
+  /** View raw records as spectrum lines; line data aliases `buffer` */
+  static decode(buffer: Buffer): SpectrumLine[];
+  info(): SpectrumRecordingInfo;
+  read(fromMs: number, toMs: number, options?: SpectrumRecordingReadOptions): Promise<SpectrumRecordingChunk>;
+  replay(fromMs: number, toMs: number, options?: { chunkBytes?: number }): AsyncGenerator<SpectrumLine, void, unknown>;
+  close(): void;
+}
+
+/** One rig's part of a HamLibGroup call */
+interface HamLibGroupRigResult {
+  /** Position of the rig in the group */
+  index: number;
+  /** The batch ran and every item succeeded */
+  ok: boolean;
+  /** Per-item results, as HamLib.batch() resolves them */
+  results?: BatchResult[];
+  /** Set instead of results when the rig's batch was rejected */
+  error?: Error;
+  /** When the rig's command thread picked up the batch, ms after the call */
+  startedMs?: number;
+  /** When the rig finished applying the batch, ms after the call */
+  appliedMs?: number;
+}
+
+/** Result of a HamLibGroup call */
+interface HamLibGroupResult {
+  /** Every rig applied every item */
+  ok: boolean;
+  /** appliedMs of the last successful rig minus that of the first */
+  skewMs: number;
+  elapsedMs: number;
+  rigs: HamLibGroupRigResult[];
+}
+
+/**
+ * Several HamLib instances driven as one. Rigs only run in parallel when
+ * their locks are independent (setLockScope('port') or 'instance').
+ */
+declare class HamLibGroup {
+  /** @param rigs - Between 1 and 32 distinct HamLib instances */
+  constructor(rigs: HamLib[]);
+  readonly rigs: HamLib[];
+  readonly size: number;
+  /** Run the same batch on every rig at once */
+  batch(operations: BatchOperation[], options?: BatchOptions): Promise<HamLibGroupResult>;
+  setFrequency(frequency: number, vfo?: VFO): Promise<HamLibGroupResult>;
+  setMode(mode: RadioMode, bandwidth?: PassbandSelector, vfo?: VFO): Promise<HamLibGroupResult>;
+  setPtt(state: boolean): Promise<HamLibGroupResult>;
+}
+
 declare class Rotator extends EventEmitter {
   constructor(model: number, port?: string);
 
@@ -1834,6 +3194,7 @@ declare class Rotator extends EventEmitter {
   getConnectionInfo(): RotatorConnectionInfo;
 
   setPosition(azimuth: number, elevation: number): Promise<number>;
+  setPositionDeadband(azimuth: number, elevation?: number): void;
   getPosition(): Promise<RotatorPosition>;
   move(direction: RotatorDirection, speed: number): Promise<number>;
   stop(): Promise<number>;
@@ -1860,6 +3221,9 @@ declare class Rotator extends EventEmitter {
   setParm(parm: string, value: number): Promise<number>;
   getParm(parm: string): Promise<number>;
   getSupportedParms(): string[];
+
+  getStats(): RotatorStats;
+  resetStats(): void;
 }
 
 /**
@@ -1892,24 +3256,29 @@ interface VfoInfo {
  */
 declare const nodeHamlib: {
   HamLib: typeof HamLib;
+  HamLibGroup: typeof HamLibGroup;
   Rotator: typeof Rotator;
+  SpectrumRecording: typeof SpectrumRecording;
   PASSBAND: PassbandConstants;
+  SPECTRUM_FRAME_FIELDS: SpectrumFrameFields;
 };
 
 declare const PASSBAND: PassbandConstants;
+declare const SPECTRUM_FRAME_FIELDS: SpectrumFrameFields;
 
 // Export types for use elsewhere
-export { ConnectionInfo, ModeInfo, SupportedRigInfo, SupportedRotatorInfo, AntennaInfo, RotatorConnectionInfo,
+export { ConnectionInfo, ModeInfo, SupportedRigInfo, SupportedRigColumns, ModelIndexInfo, ModelIndexBuildResult, SupportedRotatorInfo, AntennaInfo, RotatorConnectionInfo,
          RotatorPosition, RotatorStatus, RotatorDirection, RotatorResetType, RotatorCaps, VFO, RadioMode, MemoryChannelData,
          MemoryChannelInfo, MemoryType, RepeaterShift, MemoryChannelFlags, MemoryCapabilities, MemoryRange,
          MemoryLayout, MemoryChannel, MemoryChannelInput, MemoryListOptions, MemoryChannelError,
-         MemoryListResult, MemoryWriteResult, MemoryFacade, SplitModeInfo, SplitStatusInfo, LevelType, FunctionType,
+         MemoryListResult, MemoryStreamOptions, MemoryStreamChunk, MemoryDiffOptions, MemoryWriteResult, MemoryFacade, SplitModeInfo, SplitStatusInfo, LevelType, FunctionType, LevelHandle, FunctionHandle,
          ScanType, VfoOperationType, SerialConfigParam, SerialBaudRate, SerialParity,
          SerialHandshake, SerialControlState, PttType, DcdType, SerialConfigOptions,
          HamlibConfigFieldType, HamlibConfigFieldDescriptor, HamlibPortType, HamlibPortCaps,
          SpectrumScopeInfo, SpectrumModeInfo, SpectrumAverageModeInfo, SpectrumLine,
-         SpectrumCapabilities, SpectrumSupportSummary, SpectrumConfig, SpectrumDisplayState,
-         ClockInfo, VfoInfo, PassbandSelector, PassbandConstants, HamLib, Rotator, PASSBAND };
+         SpectrumCapabilities, SpectrumStreamOptions, SpectrumStreamStats, SpectrumFrame, SpectrumFrameFields, SpectrumProcessingOptions, SpectrumRecordingOptions, SpectrumRecordingStats, SpectrumRecordingInfo,
+         SpectrumRecordingReadOptions, SpectrumRecordingChunk, SpectrumSupportSummary, SpectrumConfig, SpectrumDisplayState,
+         ClockInfo, VfoInfo, PassbandSelector, PassbandConstants, RigLockScope, BatchOperation, BatchOptions, BatchResult, CommandThreadOptions, CommandThreadStats, LatencyHistogramStats, OperationStats, CommandPriority, PriorityLaneStats, CommandPriorityOptions, CommandPriorityConfig, CallOptions, OperationQueueStats, TraceOptions, ChromeTraceEvent, ChromeTrace, SharedSessionOptions, SharedSessionInfo, SharedSessionStats, HamLibStats, RigStats, RotatorStats, GlobalHamLibStats, StateCacheOptions, CachedReadOptions, StateCacheStats, CapabilitySnapshot, RequestCoalescingOptions, RequestCoalescingStats, PollItem, PollChange, TrackingPoint, TrackingOptions, TrackingProgressEvent, TrackingEndEvent, TrackingStatus, RawStreamOptions, RawFrameEvent, RawStreamEndEvent, RawStreamStatus, SweepOptions, SweepEndEvent, SweepStatus, TransceiveMode, FrequencyChangeEvent, ModeChangeEvent, PttChangeEvent, HamLibGroupRigResult, HamLibGroupResult, HamLib, HamLibGroup, Rotator, SpectrumRecording, PASSBAND, SPECTRUM_FRAME_FIELDS };
 
 // Support both CommonJS and ES module exports
 // @ts-ignore
@@ -1,14 +1,110 @@
+const fs = require('fs');
 const path = require('path');
 const { EventEmitter } = require('events');
 const nodeGypBuild = require('node-gyp-build');
+const { SPECTRUM_FRAME_FIELDS } = require('./spectrum.js');
 // Ensure loader resolves from package root (contains prebuilds/ and build/)
-const nativeModule = nodeGypBuild(path.join(__dirname, '..'));
+const packageRoot = path.join(__dirname, '..');
+const nativeModule = nodeGypBuild(packageRoot);
+
+// Written beside the addon binary by scripts/build-model-index.js.
+const MODEL_INDEX_FILE = 'hamlib-models.idx';
+
+function defaultModelIndexPath() {
+  return path.join(path.dirname(nodeGypBuild.path(packageRoot)), MODEL_INDEX_FILE);
+}
+
+// Maps the prebuilt model index, if any, so model lookups need no backend
+// initialisation. NODE_HAMLIB_MODEL_INDEX names another file, or '0' to skip
+// it. A default index from another Hamlib build is ignored.
+function loadDefaultModelIndex() {
+  const configured = process.env.NODE_HAMLIB_MODEL_INDEX;
+  if (configured === '0') {
+    return;
+  }
+  let indexPath = configured;
+  if (!indexPath) {
+    try {
+      indexPath = defaultModelIndexPath();
+    } catch (err) {
+      return;
+    }
+    if (!fs.existsSync(indexPath)) {
+      return;
+    }
+  }
+  try {
+    nativeModule.HamLib.loadModelIndex(indexPath);
+  } catch (err) {
+    if (configured) {
+      process.emitWarning(`NODE_HAMLIB_MODEL_INDEX not loaded: ${err.message}`);
+    }
+  }
+}
+
+loadDefaultModelIndex();
 
 const PASSBAND = Object.freeze({
   NORMAL: 0,
   NOCHANGE: -1,
 });
 
+// Validates `{ signal, deadlineMs }` for withCallOptions() and memory.stream().
+function readCallOptions(options) {
+  if (!options || typeof options !== 'object') {
+    throw new TypeError('Call options must be an object');
+  }
+  const { signal, deadlineMs } = options;
+  if (signal !== undefined
+      && (!signal || typeof signal.aborted !== 'boolean' || typeof signal.addEventListener !== 'function')) {
+    throw new TypeError('signal must be an AbortSignal');
+  }
+  if (deadlineMs !== undefined
+      && (typeof deadlineMs !== 'number' || !Number.isFinite(deadlineMs) || deadlineMs < 0)) {
+    throw new RangeError('deadlineMs must be a non-negative finite number');
+  }
+  return { signal, deadlineMs };
+}
+
+// Runs `fn` with a native call scope open, so every worker it queues carries
+// the signal and deadline. An already-aborted signal still queues the work,
+// which is then dropped natively without touching the rig.
+function runWithCallOptions(nativeInstance, options, fn) {
+  const { signal, deadlineMs } = options;
+  const scopeId = nativeInstance.beginCallScope(deadlineMs);
+  if (signal && signal.aborted) {
+    nativeInstance.cancelCallScope(scopeId);
+  }
+  let result;
+  try {
+    result = fn();
+  } finally {
+    nativeInstance.endCallScope(scopeId);
+  }
+  if (signal && !signal.aborted && result && typeof result.then === 'function') {
+    const onAbort = () => nativeInstance.cancelCallScope(scopeId);
+    const cleanup = () => signal.removeEventListener('abort', onAbort);
+    signal.addEventListener('abort', onAbort, { once: true });
+    result.then(cleanup, cleanup);
+  }
+  return result;
+}
+
+function callOptionsView(target, nativeInstance, options) {
+  return new Proxy(target, {
+    get(object, key) {
+      const value = Reflect.get(object, key, object);
+      if (value instanceof MemoryFacade) {
+        return callOptionsView(value, nativeInstance, options);
+      }
+      if (typeof value !== 'function' || key === 'constructor') {
+        return value;
+      }
+      return (...args) => runWithCallOptions(nativeInstance, options, () => value.apply(object, args));
+    },
+  });
+}
+
 class MemoryFacade {
   constructor(nativeInstance) {
     this._nativeInstance = nativeInstance;
@@ -45,6 +141,62 @@ class MemoryFacade {
     return this._nativeInstance.getMemoryList(options);
   }
 
+  /**
+   * Read the memory bank in chunks, yielding each as soon as it is read. The
+   * rig lock is released between chunks, so other commands interleave with a
+   * long scan. Stop early with `break` or `options.signal`.
+   * @param {Object} [options] - Same as list(), plus:
+   * @param {number} [options.chunkSize=32] - Slots read per lock acquisition
+   * @param {AbortSignal} [options.signal] - Aborts the scan, including a chunk still waiting for the rig
+   * @param {number} [options.deadlineMs] - Budget for the whole scan
+   * @yields {{ channels: Object[], errors: Object[], layout: Object, scanned: number, total: number }}
+   * @example
+   * for await (const chunk of rig.memory.stream({ chunkSize: 50 })) {
+   *   console.log(`${chunk.scanned}/${chunk.total}`, chunk.channels.length);
+   * }
+   */
+  async *stream(options = {}) {
+    const { signal, deadlineMs, chunkSize, ...listOptions } = options;
+    const scoped = signal !== undefined || deadlineMs !== undefined;
+    if (scoped) {
+      readCallOptions({ signal, deadlineMs });
+    }
+    const endsAt = deadlineMs !== undefined ? Date.now() + deadlineMs : undefined;
+    let cursor = null;
+    let scanned = 0;
+    do {
+      if (signal && signal.aborted) {
+        const error = new Error('Memory scan aborted');
+        error.name = 'AbortError';
+        throw error;
+      }
+      const readChunk = () => this._nativeInstance.getMemoryListChunk({
+        ...listOptions,
+        ...(chunkSize !== undefined ? { chunkSize } : {}),
+        cursor,
+      });
+      const chunk = await (scoped
+        ? runWithCallOptions(this._nativeInstance, {
+          signal,
+          deadlineMs: endsAt !== undefined ? Math.max(0, endsAt - Date.now()) : undefined,
+        }, readChunk)
+        : readChunk());
+      scanned += chunk.scanned;
+      cursor = chunk.nextCursor;
+      yield {
+        channels: chunk.channels,
+        errors: chunk.errors,
+        layout: chunk.layout,
+        scanned,
+        total: chunk.layout.count,
+      };
+    } while (cursor !== null);
+  }
+
+  /**
+   * Write several channels. Options: `continueOnError`, and `diff`/`baseline`
+   * as for replaceAll() to skip channels that already match.
+   */
   async setMany(channels, options = {}) {
     if (!Array.isArray(channels)) {
       throw new TypeError('memory.setMany() requires an array');
@@ -52,10 +204,19 @@ class MemoryFacade {
     return this._nativeInstance.setMemoryChannels(channels, options);
   }
 
-  async replaceAll(channels) {
+  /**
+   * Write a complete memory image. With `{ diff: true }` each slot is compared
+   * with the rig (or with `options.baseline`, e.g. a previous list().channels)
+   * and only changed slots are written.
+   * @returns {Promise<{ written: number, skipped: number, cleared: number, errors: Object[] }>}
+   */
+  async replaceAll(channels, options) {
     if (!Array.isArray(channels)) {
       throw new TypeError('memory.replaceAll() requires an array');
     }
+    if (options !== undefined) {
+      return this._nativeInstance.replaceMemoryChannels(channels, options);
+    }
     return this._nativeInstance.replaceMemoryChannels(channels);
   }
 
@@ -99,10 +260,15 @@ class HamLib extends EventEmitter {
     super();
     this._nativeInstance = new nativeModule.HamLib(model, port);
     this.memory = new MemoryFacade(this._nativeInstance);
+    // Set by openSharedSession(); the hot get/set calls then go through it
+    this._sharedSession = false;
+    // Rig-pushed transceive changes arrive as frequency_change / mode_change / ptt_change
+    this._nativeInstance.setTransceiveListener((event, payload) => this.emit(event, payload));
   }
 
   /**
-   * Get list of all supported radio models
+   * Get list of all supported radio models, sorted by model number.
+   * The backends are enumerated once per process; later calls reuse that list.
    * @returns {Array} Array of supported radio models with details
    * @static
    */
@@ -110,6 +276,35 @@ class HamLib extends EventEmitter {
     return nativeModule.HamLib.getSupportedRigs();
   }
 
+  /**
+   * Like getSupportedRigs(), but the first enumeration runs off the JS thread.
+   * @returns {Promise<Array>} Array of supported radio models with details
+   * @static
+   */
+  static getSupportedRigsAsync() {
+    return nativeModule.HamLib.getSupportedRigsAsync();
+  }
+
+  /**
+   * Supported radio models as typed-array columns. String columns hold
+   * indices into `strings`, e.g. strings[columns.modelName[i]].
+   * @returns {Object} count, rigModel, modelName, mfgName, version, status, rigType, strings
+   * @static
+   */
+  static getSupportedRigsColumnar() {
+    return nativeModule.HamLib.getSupportedRigsColumnar();
+  }
+
+  /**
+   * Look up one supported radio model without building the whole list
+   * @param {number} model - Hamlib rig model number
+   * @returns {Object|null} Model details, or null if Hamlib does not know it
+   * @static
+   */
+  static getSupportedRig(model) {
+    return nativeModule.HamLib.getSupportedRig(model);
+  }
+
   /**
    * Get Hamlib library version information
    * @returns {string} Hamlib version string (e.g., "Hamlib 4.5.5 2024-01-15 12:00:00 64-bit")
@@ -174,6 +369,62 @@ class HamLib extends EventEmitter {
     return nativeModule.HamLib.isGlobalLockEnabled();
   }
 
+  /**
+   * Choose which mutex serializes native radio I/O.
+   * 'global' (default) uses one process-wide lock, 'port' one lock per device
+   * (serial path or rigctld host:port), 'instance' one lock per HamLib
+   * instance. Instances opened on the same explicit port always share a lock.
+   * Set NODE_HAMLIB_LOCK_SCOPE to pick the initial scope. Throws while a rig
+   * command, poll round, tracking schedule, raw stream or sweep is running.
+   * @param {'global'|'port'|'instance'} scope
+   * @static
+   */
+  static setLockScope(scope) {
+    return nativeModule.HamLib.setLockScope(scope);
+  }
+
+  /**
+   * Get the current native radio I/O lock scope.
+   * @returns {'global'|'port'|'instance'}
+   * @static
+   */
+  static getLockScope() {
+    return nativeModule.HamLib.getLockScope();
+  }
+
+  /**
+   * Get process-wide per-operation metrics for every native rig command.
+   * Keys of `operations` are worker operation names (e.g. 'SetFrequency');
+   * each entry has calls, errors, lockTimeouts, rejected, errorsByCode
+   * (Hamlib result code -> count) and lockWait / execute latency histograms.
+   * `lockHolders` lists the operations holding a rig lock right now.
+   * @returns {Object} since, operations, queue and lockHolders
+   * @static
+   */
+  static getStats() {
+    return nativeModule.HamLib.getStats();
+  }
+
+  /**
+   * Clear the process-wide counters and histograms returned by getStats().
+   * @static
+   */
+  static resetStats() {
+    return nativeModule.HamLib.resetStats();
+  }
+
+  /**
+   * Force a backend model to always use the global lock, for backends that are
+   * not safe to drive from several threads at once. Also configurable with
+   * NODE_HAMLIB_SERIALIZED_MODELS (comma-separated model numbers).
+   * @param {number} model - Radio model number
+   * @param {boolean} serialized
+   * @static
+   */
+  static setBackendSerialized(model, serialized) {
+    return nativeModule.HamLib.setBackendSerialized(model, serialized);
+  }
+
   /**
    * Get backend-specific configuration schema for a rig model without creating
    * a live HamLib instance or acquiring the live rig I/O lock.
@@ -196,6 +447,49 @@ class HamLib extends EventEmitter {
     return nativeModule.HamLib.getPortCapsForModel(model);
   }
 
+  /**
+   * Enumerate every backend once and write a model index (names, port caps
+   * and config schemas) for the running Hamlib version. Run at build time by
+   * scripts/build-model-index.js.
+   * @param {string} [indexPath] - Output file (default: getDefaultModelIndexPath())
+   * @returns {Object} { path, models, incomplete, bytes }
+   * @static
+   */
+  static buildModelIndex(indexPath) {
+    return nativeModule.HamLib.buildModelIndex(indexPath === undefined ? defaultModelIndexPath() : indexPath);
+  }
+
+  /**
+   * Memory-map a model index; getSupportedRigs(), getSupportedRig(),
+   * getConfigSchemaForModel() and getPortCapsForModel() then answer from it
+   * without initialising any backend. The default index is loaded on require.
+   * @param {string} indexPath - File written by buildModelIndex()
+   * @returns {Object} { path, models, bytes, hamlibVersion }
+   * @throws {Error} If the file is malformed or was built for another Hamlib version
+   * @static
+   */
+  static loadModelIndex(indexPath) {
+    return nativeModule.HamLib.loadModelIndex(indexPath);
+  }
+
+  /**
+   * The model index in use, or null
+   * @returns {Object|null} { path, models, bytes, hamlibVersion }
+   * @static
+   */
+  static getModelIndexInfo() {
+    return nativeModule.HamLib.getModelIndexInfo();
+  }
+
+  /**
+   * Where the index is looked for on require: next to the addon binary
+   * @returns {string}
+   * @static
+   */
+  static getDefaultModelIndexPath() {
+    return defaultModelIndexPath();
+  }
+
   /**
    * Open connection to the radio device
    * Must be called before other operations
@@ -211,6 +505,9 @@ class HamLib extends EventEmitter {
    * @throws {Error} Throws error when device doesn't support or operation fails
    */
   async setVfo(vfo) {
+    if (this._sharedSession && typeof vfo === 'string') {
+      return this._sessionOp({ op: 'setVfo', vfo });
+    }
     return this._nativeInstance.setVfo(vfo);
   }
 
@@ -220,6 +517,9 @@ class HamLib extends EventEmitter {
    * @param {string} [vfo] - Optional VFO ('VFOA' or 'VFOB')
    */
   async setFrequency(frequency, vfo) {
+    if (this._sharedSession && typeof frequency === 'number' && (vfo === undefined || typeof vfo === 'string')) {
+      return this._sessionOp({ op: 'setFrequency', frequency, vfo });
+    }
     if (vfo !== undefined) {
       return this._nativeInstance.setFrequency(frequency, vfo);
     } else {
@@ -234,6 +534,11 @@ class HamLib extends EventEmitter {
    * @param {string} [vfo] - Optional VFO ('VFOA' or 'VFOB')
    */
   async setMode(mode, bandwidth, vfo) {
+    if (this._sharedSession && typeof mode === 'string'
+        && (bandwidth === undefined || typeof bandwidth === 'number' || bandwidth === 'normal' || bandwidth === 'nochange')
+        && (vfo === undefined || typeof vfo === 'string')) {
+      return this._sessionOp({ op: 'setMode', mode, bandwidth, vfo });
+    }
     if (vfo !== undefined) {
       if (bandwidth !== undefined) {
         return this._nativeInstance.setMode(mode, bandwidth, vfo);
@@ -252,24 +557,42 @@ class HamLib extends EventEmitter {
    * @param {boolean} state - true to enable PTT, false to disable
    */
   async setPtt(state) {
+    if (this._sharedSession && typeof state === 'boolean') {
+      return this._sessionOp({ op: 'setPtt', ptt: state });
+    }
     return this._nativeInstance.setPtt(state);
   }
 
   /**
    * Get current VFO
+   * @param {Object} [options]
+   * @param {number} [options.maxAgeMs] - Accept a state-cache value up to this old (see enableStateCache)
    * @returns {string} Current Hamlib VFO token
    */
-  async getVfo() {
+  async getVfo(options) {
+    if (this._sharedSession && options === undefined) {
+      return this._sessionOp({ op: 'getVfo' });
+    }
+    if (options !== undefined) {
+      return this._nativeInstance.getVfo(options);
+    }
     return this._nativeInstance.getVfo();
   }
 
   /**
    * Get current frequency
    * @param {string} [vfo] - Optional VFO ('VFOA' or 'VFOB')
+   * @param {Object} [options]
+   * @param {number} [options.maxAgeMs] - Accept a state-cache value up to this old (see enableStateCache)
    * @returns {number} Current frequency in hertz
    */
-  async getFrequency(vfo) {
-    if (vfo !== undefined) {
+  async getFrequency(vfo, options) {
+    if (this._sharedSession && options === undefined && (vfo === undefined || typeof vfo === 'string')) {
+      return this._sessionOp({ op: 'getFrequency', vfo });
+    }
+    if (options !== undefined) {
+      return this._nativeInstance.getFrequency(vfo, options);
+    } else if (vfo !== undefined) {
       return this._nativeInstance.getFrequency(vfo);
     } else {
       return this._nativeInstance.getFrequency();
@@ -278,9 +601,17 @@ class HamLib extends EventEmitter {
 
   /**
    * Get current radio mode
+   * @param {Object} [options]
+   * @param {number} [options.maxAgeMs] - Accept a state-cache value up to this old (see enableStateCache)
    * @returns {Object} Object containing mode and bandwidth information
    */
-  async getMode() {
+  async getMode(options) {
+    if (this._sharedSession && options === undefined) {
+      return this._sessionOp({ op: 'getMode' });
+    }
+    if (options !== undefined) {
+      return this._nativeInstance.getMode(options);
+    }
     return this._nativeInstance.getMode();
   }
 
@@ -290,6 +621,9 @@ class HamLib extends EventEmitter {
    * @returns {number} Signal strength value
    */
   async getStrength(vfo) {
+    if (this._sharedSession && (vfo === undefined || typeof vfo === 'string')) {
+      return this._sessionOp({ op: 'getStrength', vfo });
+    }
     if (vfo !== undefined) {
       return this._nativeInstance.getStrength(vfo);
     } else {
@@ -321,6 +655,336 @@ class HamLib extends EventEmitter {
     return this._nativeInstance.getConnectionInfo();
   }
 
+  /**
+   * Run several get/set operations in one native round trip under a single
+   * rig lock acquisition.
+   * Supported ops: getFrequency, getMode, getVfo, getPtt, getStrength,
+   * getLevel {level}, getFunction {function}, setFrequency {frequency},
+   * setMode {mode, bandwidth?}, setPtt {ptt}, setVfo {vfo},
+   * setLevel {level, value}, setFunction {function, enable}. Most ops also
+   * accept an optional vfo token.
+   * @param {Array<Object>} operations - e.g. [{ op: 'getFrequency' }, { op: 'getLevel', level: 'SWR' }]
+   * @param {Object} [options]
+   * @param {boolean} [options.continueOnError=true] - Keep going after a failed item; when false the
+   *   batch stops and rejects on the first failure
+   * @returns {Promise<Array<Object>>} One { op, ok, value } or { op, ok: false, code, hamlibCode, message }
+   *   entry per operation, in order
+   */
+  async batch(operations, options) {
+    return this._nativeInstance.batch(operations, options);
+  }
+
+  /**
+   * One batch item through the shared session, settled like the direct call.
+   * @private
+   */
+  async _sessionOp(item) {
+    const [result] = await this._nativeInstance.batch([item]);
+    if (!result.ok) {
+      const error = new Error(result.message);
+      error.code = result.code;
+      error.hamlibCode = result.hamlibCode;
+      error.operation = item.op;
+      throw error;
+    }
+    return result.value;
+  }
+
+  /**
+   * Attach this network rig to a rigctld connection shared by every instance
+   * using the same host:port. batch() items are written back to back and
+   * matched to replies in order, so a batch costs about one round trip, and
+   * concurrent calls from several instances pipeline on the one socket.
+   * getFrequency/setFrequency, getMode/setMode, getVfo/setVfo, getPtt/setPtt,
+   * getLevel/setLevel and getStrength with plain arguments go through it too;
+   * everything else keeps using Hamlib's own connection opened by open().
+   * Session calls bypass the rig lock, call options and stats; a missing
+   * reply within timeoutMs fails the session with code HAMLIB_SESSION_ERROR.
+   * @param {Object} [options]
+   * @param {number} [options.timeoutMs=5000] - Connect and reply timeout (100 - 600000)
+   * @returns {Promise<Object>} { address, vfoMode, clients }
+   */
+  async openSharedSession(options) {
+    const info = await this._nativeInstance.openSharedSession(options);
+    this._sharedSession = true;
+    return info;
+  }
+
+  /**
+   * Detach from the shared session. Submitted calls still settle; the
+   * connection closes with its last instance.
+   */
+  closeSharedSession() {
+    this._sharedSession = false;
+    return this._nativeInstance.closeSharedSession();
+  }
+
+  /**
+   * Get shared session statistics, or null when none is attached
+   * @returns {Object|null} address, connected, vfoMode, clients, groups, commands,
+   *   errors, inflight, maxInflight and latency
+   */
+  getSharedSessionStats() {
+    return this._nativeInstance.getSharedSessionStats();
+  }
+
+  /**
+   * Route this rig's native calls through one dedicated native thread instead
+   * of the libuv threadpool. Calls are queued in a bounded queue and settled in
+   * batches; a full queue rejects with code HAMLIB_COMMAND_QUEUE_FULL.
+   * Set NODE_HAMLIB_COMMAND_THREAD=1 to enable it for every new instance.
+   * @param {Object} [options]
+   * @param {number} [options.queueCapacity=256] - Maximum queued commands (rounded up to a power of two)
+   */
+  enableCommandThread(options) {
+    return this._nativeInstance.enableCommandThread(options);
+  }
+
+  /**
+   * Stop the dedicated command thread. Commands already queued still settle;
+   * later calls go back to the libuv threadpool.
+   */
+  disableCommandThread() {
+    return this._nativeInstance.disableCommandThread();
+  }
+
+  /**
+   * Get command thread queue statistics
+   * @returns {Object} enabled, queueCapacity, queueDepth, maxQueueDepth, submitted,
+   *   completed, rejected, batches, avgWaitMs and maxWaitMs
+   */
+  getCommandThreadStats() {
+    return this._nativeInstance.getCommandThreadStats();
+  }
+
+  /**
+   * Get per-operation metrics for this rig, in the same shape as
+   * HamLib.getStats() plus the command thread and request coalescing statistics.
+   * @returns {Object} since, operations, queue, commandThread and coalescing
+   */
+  getStats() {
+    return this._nativeInstance.getStats();
+  }
+
+  /**
+   * Clear this rig's counters and histograms.
+   */
+  resetStats() {
+    return this._nativeInstance.resetStats();
+  }
+
+  /**
+   * Record a trace event for every native call at construction, Execute()
+   * entry, rig lock acquired, shim return and promise settlement, into a
+   * fixed-size lock-free ring (oldest events are overwritten).
+   * Set NODE_HAMLIB_TRACE=1 (or a capacity) to enable it for every new instance.
+   * @param {Object} [options]
+   * @param {number} [options.capacity=4096] - Events kept (64 - 1048576, rounded up to a power of two)
+   */
+  enableTrace(options) {
+    return this._nativeInstance.enableTrace(options);
+  }
+
+  /**
+   * Stop recording trace events. The ring is kept for dumpTrace().
+   */
+  disableTrace() {
+    return this._nativeInstance.disableTrace();
+  }
+
+  /**
+   * Export the trace ring as Chrome trace-event JSON, loadable in
+   * chrome://tracing or Perfetto: one async span per call with queue,
+   * lockWait, execute and resolve children, plus the shim call on the
+   * thread that ran it.
+   * @param {Object} [options]
+   * @param {boolean} [options.clear=false] - Drop the exported events from the ring
+   * @returns {Object} { traceEvents, displayTimeUnit, otherData: { enabled, capacity, recorded, overwritten, calls } }
+   */
+  dumpTrace(options) {
+    return this._nativeInstance.dumpTrace(options);
+  }
+
+  /**
+   * Enable the frequency/mode/VFO state cache. It is filled by successful
+   * get/set calls, batch and poll reads and transceive events, and answers
+   * getFrequency/getMode/getVfo without a CAT round trip while the cached
+   * value is no older than maxAgeMs (overridable per call; 0 forces a read).
+   * @param {Object} [options]
+   * @param {number} [options.maxAgeMs=250] - Default maximum age of a cached answer
+   */
+  enableStateCache(options) {
+    return this._nativeInstance.enableStateCache(options);
+  }
+
+  /**
+   * Disable the state cache and drop its entries.
+   */
+  disableStateCache() {
+    return this._nativeInstance.disableStateCache();
+  }
+
+  /**
+   * Get state cache counters
+   * @returns {Object} enabled, maxAgeMs, hits, misses, stale, updates, invalidations and hitRate
+   */
+  getStateCacheStats() {
+    return this._nativeInstance.getStateCacheStats();
+  }
+
+  /**
+   * Share identical in-flight reads and collapse setFrequency bursts.
+   * With reads, a getFrequency/getMode/getVfo/getPtt/getStrength/getLevel/
+   * getFunction call identical (same VFO and level/function) to one still
+   * queued or running shares its promise. With writes, a setFrequency for
+   * the same VFO replaces the value of one that has not reached the rig yet
+   * (last writer wins); every merged caller resolves when that write completes.
+   * Any other command acts as a barrier for both.
+   * @param {Object} [options]
+   * @param {boolean} [options.reads=true]
+   * @param {boolean} [options.writes=true]
+   */
+  enableRequestCoalescing(options) {
+    return this._nativeInstance.enableRequestCoalescing(options);
+  }
+
+  /**
+   * Stop coalescing requests. Callers already sharing a command still settle together.
+   */
+  disableRequestCoalescing() {
+    return this._nativeInstance.disableRequestCoalescing();
+  }
+
+  /**
+   * Configure command priority classes. Realtime commands (setPtt, sendMorse,
+   * stopMorse by default) get the rig lock and the command thread before
+   * interactive ones, which go before background ones (getLevel, getStrength).
+   * @param {Object} options
+   * @param {number} [options.backgroundBudget] - Shed background commands while this many
+   *   commands are in flight on the rig; 0 (default) never sheds
+   * @param {Object} [options.operations] - Per-operation class, e.g. { getSwr: 'background' };
+   *   null restores the default
+   */
+  setCommandPriorities(options) {
+    return this._nativeInstance.setCommandPriorities(options);
+  }
+
+  /**
+   * @returns {Object} backgroundBudget, inflight and the per-operation overrides
+   */
+  getCommandPriorities() {
+    return this._nativeInstance.getCommandPriorities();
+  }
+
+  /**
+   * A view of this rig whose async methods (including rig.memory) carry an
+   * AbortSignal and/or a deadline. A call aborted, or whose deadline passed,
+   * before it reaches the rig is rejected with HAMLIB_ABORTED (AbortError) or
+   * HAMLIB_DEADLINE_EXCEEDED (TimeoutError) without touching the rig. Memory
+   * list reads and waitMorse also stop between steps; any other command that
+   * is already running finishes normally. A scoped call never joins or leads
+   * a coalesced request.
+   * @param {Object} options
+   * @param {AbortSignal} [options.signal] - Cancels calls not yet at the rig
+   * @param {number} [options.deadlineMs] - Per call, measured from the method call
+   * @returns {HamLib} The same API, scoped
+   * @example
+   * const controller = new AbortController();
+   * const meter = rig.withCallOptions({ signal: controller.signal, deadlineMs: 500 });
+   * meter.getLevel('STRENGTH').catch(() => {});
+   * controller.abort(); // the read is dropped if it has not started yet
+   */
+  withCallOptions(options) {
+    return callOptionsView(this, this._nativeInstance, readCallOptions(options));
+  }
+
+  /**
+   * Set the Hamlib transceive mode. With 'rig', rigs that broadcast their own
+   * changes (e.g. Icom CI-V transceive) emit frequency_change, mode_change and
+   * ptt_change events without being polled. The mode is stored for the next
+   * open() and applied immediately when the rig is already open.
+   * @param {string} mode - 'off' | 'rig' | 'poll' (default 'rig')
+   * @returns {Promise<number>} Success status
+   */
+  async setTransceive(mode) {
+    return this._nativeInstance.setTransceive(mode);
+  }
+
+  /**
+   * Get the transceive mode applied on open()
+   * @returns {string} 'off' | 'rig' | 'poll'
+   */
+  getTransceive() {
+    return this._nativeInstance.getTransceive();
+  }
+
+  /**
+   * Poll get* items on a native poll thread and report only changed values.
+   * Items take the same shape as batch() get ops plus intervalMs (default 1000)
+   * and an optional key. Items due in the same round share one rig lock.
+   * @param {Array<Object>} items - e.g. [{ op: 'getFrequency', intervalMs: 200 }, { op: 'getPtt', intervalMs: 100 }]
+   * @param {Function} [callback] - Receives an array of changes per round; defaults to emitting
+   *   one 'pollChange' event per change
+   * @returns {number} Poll id for stopPolling()
+   */
+  startPolling(items, callback) {
+    const listener = typeof callback === 'function'
+      ? callback
+      : (changes) => {
+          for (const change of changes) {
+            this.emit('pollChange', change);
+          }
+        };
+    return this._nativeInstance.startPolling(items, listener);
+  }
+
+  /**
+   * Stop a poll set started by startPolling(), or every poll set when no id is given
+   * @param {number} [pollId]
+   * @returns {boolean} true if anything was stopped
+   */
+  stopPolling(pollId) {
+    return this._nativeInstance.stopPolling(pollId);
+  }
+
+  /**
+   * Follow a time-indexed schedule (e.g. a satellite pass) on a native thread:
+   * every stepMs the schedule is interpolated at the current time and the rig
+   * frequency and rotator position are sent once they leave their deadband.
+   * Starting a new schedule replaces the running one.
+   * @param {Array<Object>} points - { time (epoch ms), azimuth?, elevation?, rxFrequency?, txFrequency? },
+   *   strictly increasing in time; each field is given in every point or in none
+   * @param {Object} [options] - rotator, stepMs (default 250), vfo, frequencyDeadbandHz (default 10),
+   *   azimuthDeadband and elevationDeadband (degrees, default 1)
+   * @param {Function} [callback] - Receives every progress and end event; defaults to emitting
+   *   'trackingProgress' and 'trackingEnd' events
+   */
+  startTracking(points, options = {}, callback) {
+    const { rotator, ...rest } = options || {};
+    const nativeOptions = rotator ? { ...rest, rotator: rotator._nativeInstance || rotator } : rest;
+    const listener = typeof callback === 'function'
+      ? callback
+      : (event) => this.emit(event.type === 'end' ? 'trackingEnd' : 'trackingProgress', event);
+    return this._nativeInstance.startTracking(points, nativeOptions, listener);
+  }
+
+  /**
+   * Stop the schedule started by startTracking(). No 'trackingEnd' event follows.
+   * @returns {boolean} true if a schedule was running
+   */
+  stopTracking() {
+    return this._nativeInstance.stopTracking();
+  }
+
+  /**
+   * Counters of the current or last tracking schedule
+   * @returns {Object|null} running, points, startTime, endTime, steps, lateSteps, skippedSteps,
+   *   maxLateMs, commands and errors; null before the first startTracking()
+   */
+  getTrackingStatus() {
+    return this._nativeInstance.getTrackingStatus();
+  }
+
   // Memory Channel Management
   
   /**
@@ -417,10 +1081,14 @@ class HamLib extends EventEmitter {
 
   /**
    * Set radio level (gain, volume, etc.)
-   * @param {string} levelType - Level type ('AF', 'RF', 'SQL', 'RFPOWER', etc.)
+   * @param {string|number} levelType - Level type ('AF', 'RF', 'SQL', 'RFPOWER', etc.) or a handle from HamLib.getLevelHandle()
    * @param {number} value - Level value (0.0-1.0 typically)
    */
   async setLevel(levelType, value, vfo) {
+    if (this._sharedSession && typeof levelType === 'string' && typeof value === 'number'
+        && (vfo === undefined || typeof vfo === 'string')) {
+      return this._sessionOp({ op: 'setLevel', level: levelType, value, vfo });
+    }
     if (vfo !== undefined) {
       return this._nativeInstance.setLevel(levelType, value, vfo);
     }
@@ -429,10 +1097,13 @@ class HamLib extends EventEmitter {
 
   /**
    * Get radio level
-   * @param {string} levelType - Level type ('AF', 'RF', 'SQL', 'STRENGTH', etc.)
+   * @param {string|number} levelType - Level type ('AF', 'RF', 'SQL', 'STRENGTH', etc.) or a handle from HamLib.getLevelHandle()
    * @returns {number} Level value
    */
   async getLevel(levelType, vfo) {
+    if (this._sharedSession && typeof levelType === 'string' && (vfo === undefined || typeof vfo === 'string')) {
+      return this._sessionOp({ op: 'getLevel', level: levelType, vfo });
+    }
     if (vfo !== undefined) {
       return this._nativeInstance.getLevel(levelType, vfo);
     }
@@ -451,7 +1122,7 @@ class HamLib extends EventEmitter {
 
   /**
    * Set radio function on/off
-   * @param {string} functionType - Function type ('NB', 'COMP', 'VOX', 'TONE', etc.)
+   * @param {string|number} functionType - Function type ('NB', 'COMP', 'VOX', 'TONE', etc.) or a handle from HamLib.getFunctionHandle()
    * @param {boolean} enable - true to enable, false to disable
    */
   async setFunction(functionType, enable) {
@@ -460,7 +1131,7 @@ class HamLib extends EventEmitter {
 
   /**
    * Get radio function status
-   * @param {string} functionType - Function type ('NB', 'COMP', 'VOX', 'TONE', etc.)
+   * @param {string|number} functionType - Function type ('NB', 'COMP', 'VOX', 'TONE', etc.) or a handle from HamLib.getFunctionHandle()
    * @returns {boolean} Function enabled status
    */
   async getFunction(functionType) {
@@ -772,6 +1443,9 @@ class HamLib extends EventEmitter {
    * }
    */
   async getPtt(vfo) {
+    if (this._sharedSession && (vfo === undefined || typeof vfo === 'string')) {
+      return this._sessionOp({ op: 'getPtt', vfo });
+    }
     if (vfo !== undefined) {
       return this._nativeInstance.getPtt(vfo);
     } else {
@@ -1289,6 +1963,96 @@ class HamLib extends EventEmitter {
     return this._nativeInstance.sendRaw(data, replyMaxLen);
   }
 
+  /**
+   * Send raw command bytes and let the reply be written straight into `reply`.
+   * Neither Buffer is copied, so do not modify them until the promise settles.
+   * @param {Buffer} data - Raw command data to send
+   * @param {Buffer} reply - Receives the reply; its length is the maximum reply length
+   * @param {Buffer} [terminator] - Optional terminator bytes
+   * @returns {Promise<number>} Number of reply bytes written
+   */
+  async sendRawInto(data, reply, terminator) {
+    if (terminator !== undefined) {
+      return this._nativeInstance.sendRawInto(data, reply, terminator);
+    }
+    return this._nativeInstance.sendRawInto(data, reply);
+  }
+
+  /**
+   * Read terminator-delimited raw frames on a native thread (scope dumps,
+   * bulk reads). Each frame is read into a pooled buffer and handed over
+   * without a copy; the buffer returns to the pool once the frame is collected.
+   * The rig lock is taken for each read, so other commands run between frames.
+   * The stream ends by itself after maxFrames frames, when the rig stops
+   * sending or on a read error.
+   * Starting a new stream replaces the running one.
+   * @param {Object} options - terminator (Buffer), command (Buffer, sent before the first read),
+   *   frameBytes (default 1024), poolFrames (default 32), maxFrames (default 0: until idle)
+   * @param {Function} [callback] - Receives every frame and the end event; defaults to emitting
+   *   'rawFrame' and 'rawStreamEnd' events
+   */
+  startRawStream(options, callback) {
+    const listener = typeof callback === 'function'
+      ? callback
+      : (event) => this.emit(event.type === 'end' ? 'rawStreamEnd' : 'rawFrame', event);
+    return this._nativeInstance.startRawStream(options, listener);
+  }
+
+  /**
+   * Stop the stream started by startRawStream(). Frames not yet delivered
+   * are dropped and no 'rawStreamEnd' event follows.
+   * @returns {boolean} true if a stream was running
+   */
+  stopRawStream() {
+    return this._nativeInstance.stopRawStream();
+  }
+
+  /**
+   * Counters of the current or last raw stream
+   * @returns {Object|null} running, frames, bytes, pending, stalls, frameBytes, poolFrames,
+   *   inUse and poolMisses; null before the first startRawStream()
+   */
+  getRawStreamStatus() {
+    return this._nativeInstance.getRawStreamStatus();
+  }
+
+  /**
+   * Build spectrum lines for rigs without a hardware scope: a native thread
+   * tunes each bin and reads its STRENGTH, and every finished sweep enters
+   * the running spectrum stream as one fixed-mode line, processed, recorded
+   * and delivered like a line from a scope. The rig lock is held for at most
+   * chunkPoints bins or about 100 ms at a time, and the rig is tuned back
+   * when the sweep ends. Starting a new sweep replaces the running one.
+   * @param {Object} options - startFreq, stopFreq, stepHz (2-2048 bins), dwellMs (0-1000, default 0),
+   *   chunkPoints (default 16), sweeps (default 0: until stopped), vfo, scopeId,
+   *   strengthMinDb/strengthMaxDb (default -54/60) and restoreFrequency (default true)
+   * @param {Function} [callback] - Receives the end event; defaults to emitting 'sweepEnd'
+   */
+  startSweep(options, callback) {
+    const listener = typeof callback === 'function'
+      ? callback
+      : (event) => this.emit('sweepEnd', event);
+    return this._nativeInstance.startSweep(options, listener);
+  }
+
+  /**
+   * Stop the sweep started by startSweep(). The rig is tuned back and no
+   * 'sweepEnd' event follows.
+   * @returns {boolean} true if a sweep was running
+   */
+  stopSweep() {
+    return this._nativeInstance.stopSweep();
+  }
+
+  /**
+   * Counters of the current or last sweep
+   * @returns {Object|null} running, points, sweeps, readings, errors, unsentLines and
+   *   lastSweepMs; null before the first startSweep()
+   */
+  getSweepStatus() {
+    return this._nativeInstance.getSweepStatus();
+  }
+
   /**
    * Get official Hamlib spectrum capability metadata from the backend.
    * @returns {Promise<Object>} Spectrum capability object.
@@ -1299,14 +2063,66 @@ class HamLib extends EventEmitter {
 
   /**
    * Start the official Hamlib spectrum callback stream.
-   * @param {(line: Object) => void} [callback]
+   * Lines are queued natively and never block Hamlib's reader thread; when JS
+   * falls behind, the overflow policy decides what is dropped. `line.data` is
+   * backed by native memory (no copy) and stays valid for as long as it is referenced.
+   *
+   * With `batchLines > 1` the callback receives frames instead of lines:
+   * `{ lines, stride, data: Uint8Array, meta: Float64Array }`, where row `i` of
+   * `meta` (columns in SPECTRUM_FRAME_FIELDS) locates its payload in `data`.
+   * @param {(lineOrFrame: Object) => void} [callback] - Defaults to emitting 'spectrumLine' ('spectrumFrame' when batched)
+   * @param {Object} [options]
+   * @param {string} [options.overflow='drop-oldest'] - 'drop-oldest' or 'keep-latest' (newest line per scopeId)
+   * @param {number} [options.bufferLines] - Maximum undelivered lines (default 64, or 2 * batchLines)
+   * @param {number} [options.batchLines=1] - Lines packed into one frame, 1 - 1024
+   * @param {number} [options.maxLatencyMs=50] - Deliver a partial frame once its oldest line is this old
+   * @param {Object} [options.processing] - Native DSP applied before lines are queued:
+   *   averageAlpha (EMA weight of the newest line, 1 = off), peakHold, peakDecay (levels per line),
+   *   bins (decimate to this many bins), decimation ('max' | 'mean'), normalize (data levels to 0..255)
    * @returns {Promise<boolean>}
    */
-  async startSpectrumStream(callback) {
+  async startSpectrumStream(callback, options) {
+    if (callback && typeof callback === 'object') {
+      options = callback;
+      callback = undefined;
+    }
+    const batched = Boolean(options && options.batchLines > 1);
     const listener = typeof callback === 'function'
       ? callback
-      : (line) => this.emit('spectrumLine', line);
-    return this._nativeInstance.startSpectrumStream(listener);
+      : (payload) => this.emit(batched ? 'spectrumFrame' : 'spectrumLine', payload);
+    if (options === undefined) {
+      return this._nativeInstance.startSpectrumStream(listener);
+    }
+    return this._nativeInstance.startSpectrumStream(listener, options);
+  }
+
+  /**
+   * Spectrum line delivery counters for the current (or last) stream
+   * @returns {Object} running, overflow, bufferLines, batchLines, maxLatencyMs, processing, received,
+   *   delivered, dropped, coalesced, pending, inUse and poolMisses
+   */
+  getSpectrumStreamStats() {
+    return this._nativeInstance.getSpectrumStreamStats();
+  }
+
+  /**
+   * Push synthetic lines through the running spectrum stream's native path
+   * (processing, ring, batching, delivery), as if the rig had sent them.
+   * Internal hook for bench/ and the tests; the rig is not involved and the
+   * lines are never recorded. Paced injections are capped at 10 s.
+   * @param {number} count - Lines to inject
+   * @param {Object} [options]
+   * @param {number} [options.dataLength=475] - Bins per line (max 2048)
+   * @param {number} [options.intervalUs=0] - Pacing between lines; 0 injects as fast as possible
+   * @returns {Promise<{ lines: number, elapsedMs: number }>} lines is short of count
+   *   when the stream stopped meanwhile
+   * @private
+   */
+  async _injectSpectrumLines(count, options) {
+    if (options !== undefined) {
+      return this._nativeInstance._injectSpectrumLines(count, options);
+    }
+    return this._nativeInstance._injectSpectrumLines(count);
   }
 
   /**
@@ -1317,6 +2133,39 @@ class HamLib extends EventEmitter {
     return this._nativeInstance.stopSpectrumStream();
   }
 
+  /**
+   * Append every spectrum line (after native processing, regardless of JS
+   * back-pressure) to a memory-mapped recording file. An existing recording
+   * at `path` is continued. Read it back with SpectrumRecording.
+   * @param {string} path - Recording file; the time index is kept in `${path}.idx`
+   * @param {Object} [options]
+   * @param {number} [options.segmentBytes=16777216] - Bytes mapped and reserved on disk at a time
+   * @param {number} [options.indexIntervalMs=1000] - Spacing of time index entries
+   * @returns {Promise<boolean>}
+   */
+  async startSpectrumRecording(path, options) {
+    if (options === undefined) {
+      return this._nativeInstance.startSpectrumRecording(path);
+    }
+    return this._nativeInstance.startSpectrumRecording(path, options);
+  }
+
+  /**
+   * Stop recording and trim the file to its recorded length.
+   * @returns {Promise<Object>} Final recording stats
+   */
+  async stopSpectrumRecording() {
+    return this._nativeInstance.stopSpectrumRecording();
+  }
+
+  /**
+   * @returns {Object} recording, path, lines, dataBytes, indexEntries, startTime, endTime, droppedLines,
+   *   failed, error
+   */
+  getSpectrumRecordingStats() {
+    return this._nativeInstance.getSpectrumRecordingStats();
+  }
+
   /**
    * Set a backend configuration parameter
    * @param {string} name - Configuration token name
@@ -1488,6 +2337,237 @@ class HamLib extends EventEmitter {
     return this._nativeInstance.getFilterList();
   }
 
+  /**
+   * Get every capability query in one object. open() captures it in the same
+   * locked pass, after which this and the capability getters above resolve
+   * from memory without queueing a rig command; close() discards it.
+   * @returns {Promise<Object>} Levels, functions, modes, ranges, steps, filters, spectrum caps, ...
+   */
+  async getCapabilitySnapshot() {
+    return this._nativeInstance.getCapabilitySnapshot();
+  }
+
+  // Synchronous variants. These never queue a rig command: state getters
+  // answer from the state cache and return null on a miss; capability getters
+  // answer from the snapshot taken by open() and throw before it.
+
+  /**
+   * Cached frequency without a rig round trip
+   * @param {string} [vfo] - Optional VFO ('VFOA' or 'VFOB')
+   * @param {Object} [options]
+   * @param {number} [options.maxAgeMs] - Oldest acceptable cache entry (defaults to the cache setting)
+   * @returns {number|null} Frequency in hertz, or null when not cached or too old
+   */
+  getFrequencySync(vfo, options) {
+    if (options !== undefined) {
+      return this._nativeInstance.getFrequencySync(vfo, options);
+    } else if (vfo !== undefined) {
+      return this._nativeInstance.getFrequencySync(vfo);
+    }
+    return this._nativeInstance.getFrequencySync();
+  }
+
+  /**
+   * Cached mode and bandwidth without a rig round trip
+   * @param {Object} [options]
+   * @param {number} [options.maxAgeMs] - Oldest acceptable cache entry
+   * @returns {Object|null} Same shape as getMode(), or null when not cached
+   */
+  getModeSync(options) {
+    if (options !== undefined) {
+      return this._nativeInstance.getModeSync(options);
+    }
+    return this._nativeInstance.getModeSync();
+  }
+
+  /**
+   * Cached current VFO without a rig round trip
+   * @param {Object} [options]
+   * @param {number} [options.maxAgeMs] - Oldest acceptable cache entry
+   * @returns {string|null} Hamlib VFO token, or null when not cached
+   */
+  getVfoSync(options) {
+    if (options !== undefined) {
+      return this._nativeInstance.getVfoSync(options);
+    }
+    return this._nativeInstance.getVfoSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getSupportedLevels}; throws before open()
+   * @returns {string[]}
+   */
+  getSupportedLevelsSync() {
+    return this._nativeInstance.getSupportedLevelsSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getSupportedFunctions}; throws before open()
+   * @returns {string[]}
+   */
+  getSupportedFunctionsSync() {
+    return this._nativeInstance.getSupportedFunctionsSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getSupportedModes}; throws before open()
+   * @returns {string[]}
+   */
+  getSupportedModesSync() {
+    return this._nativeInstance.getSupportedModesSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getSupportedParms}; throws before open()
+   * @returns {string[]}
+   */
+  getSupportedParmsSync() {
+    return this._nativeInstance.getSupportedParmsSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getSupportedVfoOps}; throws before open()
+   * @returns {string[]}
+   */
+  getSupportedVfoOpsSync() {
+    return this._nativeInstance.getSupportedVfoOpsSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getSupportedScanTypes}; throws before open()
+   * @returns {string[]}
+   */
+  getSupportedScanTypesSync() {
+    return this._nativeInstance.getSupportedScanTypesSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getPreampValues}; throws before open()
+   * @returns {number[]}
+   */
+  getPreampValuesSync() {
+    return this._nativeInstance.getPreampValuesSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getAttenuatorValues}; throws before open()
+   * @returns {number[]}
+   */
+  getAttenuatorValuesSync() {
+    return this._nativeInstance.getAttenuatorValuesSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getAgcLevels}; throws before open()
+   * @returns {number[]}
+   */
+  getAgcLevelsSync() {
+    return this._nativeInstance.getAgcLevelsSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getMaxRit}; throws before open()
+   * @returns {number}
+   */
+  getMaxRitSync() {
+    return this._nativeInstance.getMaxRitSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getMaxXit}; throws before open()
+   * @returns {number}
+   */
+  getMaxXitSync() {
+    return this._nativeInstance.getMaxXitSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getMaxIfShift}; throws before open()
+   * @returns {number}
+   */
+  getMaxIfShiftSync() {
+    return this._nativeInstance.getMaxIfShiftSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getAvailableCtcssTones}; throws before open()
+   * @returns {number[]}
+   */
+  getAvailableCtcssTonesSync() {
+    return this._nativeInstance.getAvailableCtcssTonesSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getAvailableDcsCodes}; throws before open()
+   * @returns {number[]}
+   */
+  getAvailableDcsCodesSync() {
+    return this._nativeInstance.getAvailableDcsCodesSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getFrequencyRanges}; throws before open()
+   * @returns {Object}
+   */
+  getFrequencyRangesSync() {
+    return this._nativeInstance.getFrequencyRangesSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getTuningSteps}; throws before open()
+   * @returns {TuningStepInfo[]}
+   */
+  getTuningStepsSync() {
+    return this._nativeInstance.getTuningStepsSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getFilterList}; throws before open()
+   * @returns {FilterInfo[]}
+   */
+  getFilterListSync() {
+    return this._nativeInstance.getFilterListSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getSpectrumCapabilities}; throws before open()
+   * @returns {Object}
+   */
+  getSpectrumCapabilitiesSync() {
+    return this._nativeInstance.getSpectrumCapabilitiesSync();
+  }
+
+  /**
+   * Synchronous {@link HamLib#getCapabilitySnapshot}; throws before open()
+   * @returns {Object}
+   */
+  getCapabilitySnapshotSync() {
+    return this._nativeInstance.getCapabilitySnapshotSync();
+  }
+
+  /**
+   * Synchronous power2mW() using Hamlib's range-based conversion
+   * @param {number} power - Power level (0.0-1.0)
+   * @param {number} frequency - Frequency in Hz
+   * @param {string} mode - Radio mode ('USB', 'LSB', 'FM', etc.)
+   * @returns {number|null} Milliwatts, or null when the backend converts itself
+   *   (use the async power2mW()) or no TX range covers the frequency
+   */
+  power2mWSync(power, frequency, mode) {
+    return this._nativeInstance.power2mWSync(power, frequency, mode);
+  }
+
+  /**
+   * Synchronous mW2power() using Hamlib's range-based conversion
+   * @param {number} milliwatts - Power in milliwatts
+   * @param {number} frequency - Frequency in Hz
+   * @param {string} mode - Radio mode ('USB', 'LSB', 'FM', etc.)
+   * @returns {number|null} Power level (0.0-1.0), or null as for power2mWSync()
+   */
+  mW2powerSync(milliwatts, frequency, mode) {
+    return this._nativeInstance.mW2powerSync(milliwatts, frequency, mode);
+  }
+
   /**
    * Get granularity metadata for a level setting from Hamlib rig state.
    * @param {string} levelType - Level type ('RFPOWER', 'AF', 'SQL', etc.)
@@ -1508,6 +2588,29 @@ class HamLib extends EventEmitter {
     return this._nativeInstance.getRfPowerStepTable(frequency, mode);
   }
 
+  /**
+   * Parse a level name once into a numeric handle that setLevel()/getLevel()
+   * accept in its place, so hot loops skip name parsing.
+   * @param {string} levelType - Level type ('STRENGTH', 'SWR', 'RFPOWER', etc.)
+   * @returns {number} Level handle
+   * @throws {TypeError} Unknown level type
+   * @static
+   */
+  static getLevelHandle(levelType) {
+    return nativeModule.HamLib.getLevelHandle(levelType);
+  }
+
+  /**
+   * Parse a function name once into a handle for setFunction()/getFunction().
+   * @param {string} functionType - Function type ('NB', 'COMP', 'VOX', etc.)
+   * @returns {number} Function handle
+   * @throws {TypeError} Unknown function type
+   * @static
+   */
+  static getFunctionHandle(functionType) {
+    return nativeModule.HamLib.getFunctionHandle(functionType);
+  }
+
   /**
    * Get Hamlib copyright information
    * @returns {string} Copyright string
@@ -1556,6 +2659,208 @@ class HamLib extends EventEmitter {
   }
 }
 
+const SPECTRUM_RECORD_HEADER_BYTES = 80;
+
+/**
+ * Read access to a file written by HamLib.startSpectrumRecording(). Reads
+ * return raw records straight from the file; decode() views them as
+ * spectrum lines without copying the payloads. A recording that is still
+ * being written can be read; each call sees the lines appended so far.
+ */
+class SpectrumRecording {
+  /**
+   * @param {string} path - Recording file
+   */
+  constructor(path) {
+    this._native = new nativeModule.SpectrumRecording(path);
+  }
+
+  /**
+   * @param {string} path - Recording file
+   * @returns {SpectrumRecording}
+   */
+  static open(path) {
+    return new SpectrumRecording(path);
+  }
+
+  /**
+   * Split raw records into line objects; `data` of each line is a view into `buffer`.
+   * @param {Buffer} buffer - `data` of a read() result
+   * @returns {Object[]} Lines shaped like 'spectrumLine' events
+   */
+  static decode(buffer) {
+    const lines = [];
+    let offset = 0;
+    while (offset + SPECTRUM_RECORD_HEADER_BYTES <= buffer.length) {
+      const recordBytes = buffer.readUInt32LE(offset);
+      const dataLength = buffer.readUInt32LE(offset + 4);
+      if (recordBytes < SPECTRUM_RECORD_HEADER_BYTES || offset + recordBytes > buffer.length) {
+        break;
+      }
+      const dataStart = offset + SPECTRUM_RECORD_HEADER_BYTES;
+      lines.push({
+        scopeId: buffer.readInt32LE(offset + 8),
+        mode: buffer.readInt32LE(offset + 12),
+        dataLevelMin: buffer.readInt32LE(offset + 16),
+        dataLevelMax: buffer.readInt32LE(offset + 20),
+        timestamp: buffer.readDoubleLE(offset + 24),
+        centerFreq: buffer.readDoubleLE(offset + 32),
+        spanHz: buffer.readDoubleLE(offset + 40),
+        lowEdgeFreq: buffer.readDoubleLE(offset + 48),
+        highEdgeFreq: buffer.readDoubleLE(offset + 56),
+        signalStrengthMin: buffer.readDoubleLE(offset + 64),
+        signalStrengthMax: buffer.readDoubleLE(offset + 72),
+        dataLength,
+        data: buffer.subarray(dataStart, dataStart + dataLength),
+      });
+      offset += recordBytes;
+    }
+    return lines;
+  }
+
+  /**
+   * @returns {Object} version, lines, dataBytes, indexEntries, startTime, endTime, recordHeaderBytes
+   */
+  info() {
+    return this._native.info();
+  }
+
+  /**
+   * Fetch the raw records with fromMs <= timestamp <= toMs.
+   * @param {number} fromMs
+   * @param {number} toMs
+   * @param {Object} [options]
+   * @param {number} [options.maxBytes=16777216] - Upper bound of the returned buffer (at least one record is returned)
+   * @param {number} [options.offset] - `endOffset` of a previous read to continue without seeking
+   * @returns {Promise<Object>} data, lines, startTime, endTime, startOffset, endOffset, complete
+   */
+  async read(fromMs, toMs, options) {
+    if (options === undefined) {
+      return this._native.read(fromMs, toMs);
+    }
+    return this._native.read(fromMs, toMs, options);
+  }
+
+  /**
+   * Iterate decoded lines of a time range, reading `chunkBytes` at a time.
+   * @param {number} fromMs
+   * @param {number} toMs
+   * @param {Object} [options]
+   * @param {number} [options.chunkBytes=1048576]
+   */
+  async *replay(fromMs, toMs, options = {}) {
+    const maxBytes = options.chunkBytes || 1024 * 1024;
+    let offset;
+    for (;;) {
+      const chunk = await this.read(fromMs, toMs, offset === undefined ? { maxBytes } : { maxBytes, offset });
+      for (const line of SpectrumRecording.decode(chunk.data)) {
+        yield line;
+      }
+      if (chunk.complete || chunk.lines === 0) {
+        return;
+      }
+      offset = chunk.endOffset;
+    }
+  }
+
+  /**
+   * Release the file mapping.
+   */
+  close() {
+    this._native.close();
+  }
+}
+
+/**
+ * Several HamLib instances driven as one (SO2R, diversity receive, a
+ * transverter pair). Every call runs the same batch() on all rigs at once,
+ * each on its own command thread, and resolves once with every rig's outcome
+ * and the skew between the first and the last rig applying it. Rigs only
+ * overlap when their locks are independent (setLockScope('port') or
+ * 'instance'); under the default global lock they run one after another.
+ */
+class HamLibGroup {
+  /**
+   * @param {HamLib[]} rigs - Between 1 and 32 distinct, opened HamLib instances
+   */
+  constructor(rigs) {
+    if (!Array.isArray(rigs)) {
+      throw new TypeError('Expected (rigs: HamLib[])');
+    }
+    this._rigs = rigs.slice();
+    this._native = new nativeModule.HamLibGroup(
+      rigs.map((rig) => (rig instanceof HamLib ? rig._nativeInstance : rig))
+    );
+  }
+
+  /**
+   * The grouped rigs, in result order
+   * @returns {HamLib[]}
+   */
+  get rigs() {
+    return this._rigs.slice();
+  }
+
+  /**
+   * @returns {number}
+   */
+  get size() {
+    return this._native.size();
+  }
+
+  /**
+   * Run one batch on every rig at once.
+   * @param {Array<Object>} operations - Same entries as HamLib.batch()
+   * @param {Object} [options]
+   * @param {boolean} [options.continueOnError=true]
+   * @returns {Promise<Object>} ok, skewMs, elapsedMs and rigs (one entry per rig, in group order)
+   */
+  async batch(operations, options) {
+    if (options === undefined) {
+      return this._native.batch(operations);
+    }
+    return this._native.batch(operations, options);
+  }
+
+  /**
+   * Tune every rig to the same frequency.
+   * @param {number} frequency - Frequency in hertz
+   * @param {string} [vfo] - Optional VFO ('VFOA' or 'VFOB')
+   */
+  async setFrequency(frequency, vfo) {
+    const op = { op: 'setFrequency', frequency };
+    if (vfo !== undefined) {
+      op.vfo = vfo;
+    }
+    return this.batch([op]);
+  }
+
+  /**
+   * Set the same mode on every rig.
+   * @param {string} mode - Radio mode ('USB', 'LSB', 'FM', 'PKTFM', etc.)
+   * @param {string|number} [bandwidth] - Optional bandwidth selector or width in Hz
+   * @param {string} [vfo] - Optional VFO ('VFOA' or 'VFOB')
+   */
+  async setMode(mode, bandwidth, vfo) {
+    const op = { op: 'setMode', mode };
+    if (bandwidth !== undefined) {
+      op.bandwidth = bandwidth;
+    }
+    if (vfo !== undefined) {
+      op.vfo = vfo;
+    }
+    return this.batch([op]);
+  }
+
+  /**
+   * Key or unkey every rig.
+   * @param {boolean} state - true to enable PTT, false to disable
+   */
+  async setPtt(state) {
+    return this.batch([{ op: 'setPtt', ptt: state }]);
+  }
+}
+
 class Rotator extends EventEmitter {
   constructor(model, port) {
     super();
@@ -1606,6 +2911,19 @@ class Rotator extends EventEmitter {
     return this._nativeInstance.setPosition(azimuth, elevation);
   }
 
+  /**
+   * Ignore setPosition targets within the given distance of the current one.
+   * Such calls resolve with 0 without reaching the rotator. 0 disables it.
+   * @param {number} azimuth - Azimuth deadband in degrees
+   * @param {number} [elevation] - Elevation deadband in degrees (defaults to azimuth)
+   */
+  setPositionDeadband(azimuth, elevation) {
+    if (elevation === undefined) {
+      return this._nativeInstance.setPositionDeadband(azimuth);
+    }
+    return this._nativeInstance.setPositionDeadband(azimuth, elevation);
+  }
+
   async getPosition() {
     return this._nativeInstance.getPosition();
   }
@@ -1689,11 +3007,30 @@ class Rotator extends EventEmitter {
   getSupportedParms() {
     return this._nativeInstance.getSupportedParms();
   }
+
+  /**
+   * Get per-operation metrics for this rotator, in the same shape as
+   * HamLib.getStats() plus setPosition coalescing and deadband statistics.
+   * @returns {Object} since, operations, queue and position
+   */
+  getStats() {
+    return this._nativeInstance.getStats();
+  }
+
+  /**
+   * Clear this rotator's counters and histograms.
+   */
+  resetStats() {
+    return this._nativeInstance.resetStats();
+  }
 }
 
 // Export for CommonJS
-module.exports = { HamLib, Rotator, PASSBAND };
+module.exports = { HamLib, HamLibGroup, Rotator, SpectrumRecording, PASSBAND, SPECTRUM_FRAME_FIELDS };
 module.exports.HamLib = HamLib;
+module.exports.HamLibGroup = HamLibGroup;
 module.exports.Rotator = Rotator;
+module.exports.SpectrumRecording = SpectrumRecording;
 module.exports.PASSBAND = PASSBAND;
-module.exports.default = { HamLib, Rotator, PASSBAND };
+module.exports.SPECTRUM_FRAME_FIELDS = SPECTRUM_FRAME_FIELDS;
+module.exports.default = { HamLib, HamLibGroup, Rotator, SpectrumRecording, PASSBAND, SPECTRUM_FRAME_FIELDS };
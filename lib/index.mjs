@@ -7,8 +7,8 @@ const __dirname = path.dirname(__filename);
 const require = createRequire(import.meta.url);
 
 // Import the CommonJS module
-const { HamLib, Rotator, PASSBAND } = require('./index.js');
+const { HamLib, HamLibGroup, Rotator, SpectrumRecording, PASSBAND, SPECTRUM_FRAME_FIELDS } = require('./index.js');
 
 // Export for ES modules
-export { HamLib, Rotator, PASSBAND };
-export default { HamLib, Rotator, PASSBAND }; 
+export { HamLib, HamLibGroup, Rotator, SpectrumRecording, PASSBAND, SPECTRUM_FRAME_FIELDS };
+export default { HamLib, HamLibGroup, Rotator, SpectrumRecording, PASSBAND, SPECTRUM_FRAME_FIELDS }; 
@@ -4,17 +4,40 @@ import type {
   SpectrumCapabilities,
   SpectrumConfig,
   SpectrumDisplayState,
+  SpectrumFrame,
+  SpectrumFrameFields,
   SpectrumLine,
+  SpectrumProcessingOptions,
+  SpectrumStreamOptions,
   SpectrumSupportSummary,
+  SweepEndEvent,
+  SweepOptions,
 } from '../index';
 
 interface ManagedSpectrumConfig extends SpectrumConfig {
   /**
-   * Interval for lightweight CAT pump reads while managed spectrum is active.
-   * Set to 0 or false to disable the helper-side pump.
+   * Interval for lightweight CAT pump reads while managed spectrum is active,
+   * run by the native poll scheduler (see HamLib.startPolling()).
+   * Set to 0 or false to disable the pump.
    * Default: 200ms
    */
   pumpIntervalMs?: number | false;
+  /**
+   * Native line queue options forwarded to HamLib.startSpectrumStream().
+   * With `batchLines > 1` the controller emits 'spectrumFrame' instead of
+   * 'spectrumLine'.
+   */
+  stream?: SpectrumStreamOptions;
+  /**
+   * Native averaging / peak hold / decimation / normalization applied before
+   * lines reach JS (same as `stream.processing`).
+   */
+  processing?: SpectrumProcessingOptions;
+  /**
+   * Used when the rig has no hardware scope: lines are built by
+   * HamLib.startSweep() and delivered through the same events.
+   */
+  sweep?: SweepOptions;
 }
 
 declare class SpectrumController extends EventEmitter {
@@ -36,26 +59,38 @@ declare class SpectrumController extends EventEmitter {
   once(event: 'spectrumLine', listener: (line: SpectrumLine) => void): this;
   off(event: 'spectrumLine', listener: (line: SpectrumLine) => void): this;
 
-  on(event: 'spectrumStateChanged', listener: (state: { active: boolean }) => void): this;
-  once(event: 'spectrumStateChanged', listener: (state: { active: boolean }) => void): this;
-  off(event: 'spectrumStateChanged', listener: (state: { active: boolean }) => void): this;
+  on(event: 'spectrumFrame', listener: (frame: SpectrumFrame) => void): this;
+  once(event: 'spectrumFrame', listener: (frame: SpectrumFrame) => void): this;
+  off(event: 'spectrumFrame', listener: (frame: SpectrumFrame) => void): this;
+
+  on(event: 'spectrumStateChanged', listener: (state: { active: boolean; swept?: boolean }) => void): this;
+  once(event: 'spectrumStateChanged', listener: (state: { active: boolean; swept?: boolean }) => void): this;
+  off(event: 'spectrumStateChanged', listener: (state: { active: boolean; swept?: boolean }) => void): this;
+
+  on(event: 'sweepEnd', listener: (event: SweepEndEvent) => void): this;
+  once(event: 'sweepEnd', listener: (event: SweepEndEvent) => void): this;
+  off(event: 'sweepEnd', listener: (event: SweepEndEvent) => void): this;
 
   on(event: 'spectrumError', listener: (error: Error) => void): this;
   once(event: 'spectrumError', listener: (error: Error) => void): this;
   off(event: 'spectrumError', listener: (error: Error) => void): this;
 }
 
+declare const SPECTRUM_FRAME_FIELDS: SpectrumFrameFields;
+
 declare const spectrumModule: {
   SpectrumController: typeof SpectrumController;
+  SPECTRUM_FRAME_FIELDS: SpectrumFrameFields;
 };
 
-export { SpectrumController };
+export { SpectrumController, SPECTRUM_FRAME_FIELDS };
 export type {
   HamLib,
   ManagedSpectrumConfig,
   SpectrumCapabilities,
   SpectrumConfig,
   SpectrumDisplayState,
+  SpectrumFrame,
   SpectrumLine,
   SpectrumSupportSummary,
 };
@@ -2,6 +2,33 @@ const { EventEmitter } = require('events');
 
 const DEFAULT_SPECTRUM_EDGE_SLOTS = [1, 2, 3, 4];
 
+// Column order of a batched spectrum frame's `meta` Float64Array
+// (`frame.stride` values per line); matches the native frame layout.
+const SPECTRUM_FRAME_FIELDS = Object.freeze({
+  scopeId: 0,
+  mode: 1,
+  centerFreq: 2,
+  spanHz: 3,
+  lowEdgeFreq: 4,
+  highEdgeFreq: 5,
+  timestamp: 6,
+  dataOffset: 7,
+  dataLength: 8,
+  dataLevelMin: 9,
+  dataLevelMax: 10,
+  signalStrengthMin: 11,
+  signalStrengthMax: 12,
+});
+
+function spectrumFrameLineInfo(frame, index) {
+  const base = index * frame.stride;
+  const info = {};
+  for (const [name, column] of Object.entries(SPECTRUM_FRAME_FIELDS)) {
+    info[name] = frame.meta[base + column];
+  }
+  return info;
+}
+
 function normalizeSpectrumModeName(name) {
   const normalized = String(name || '').trim().toLowerCase();
   if (normalized === 'center') return 'center';
@@ -40,7 +67,9 @@ class SpectrumController extends EventEmitter {
 
     this._rig = rig;
     this._managedSpectrumRunning = false;
+    this._managedSweep = false;
     this._lastSpectrumLine = null;
+    this._pumpPollId = null;
     this._pumpTimer = null;
     this._pumpInFlight = false;
   }
@@ -67,14 +96,26 @@ class SpectrumController extends EventEmitter {
       return;
     }
 
-    // Some backends only flush async spectrum data while normal CAT traffic continues.
+    // Backends that only flush async spectrum data while CAT traffic continues
+    // are kept busy by a native frequency poll; nothing crosses into JS unless
+    // the frequency actually changes.
+    if (typeof this._rig.startPolling === 'function' && typeof this._rig.stopPolling === 'function') {
+      this._pumpPollId = this._rig.startPolling(
+        [{ op: 'getFrequency', intervalMs: Math.min(3600000, Math.max(10, intervalMs)), key: 'spectrumPump' }],
+        () => {}
+      );
+      return;
+    }
+
+    // Rigs without the native poll scheduler (wrappers, proxies) get a JS timer.
     this._pumpTimer = setInterval(() => {
       if (!this._managedSpectrumRunning || this._pumpInFlight) {
         return;
       }
 
       this._pumpInFlight = true;
-      this._rig.getFrequency()
+      Promise.resolve()
+        .then(() => this._rig.getFrequency())
         .catch(() => {})
         .finally(() => {
           this._pumpInFlight = false;
@@ -83,6 +124,10 @@ class SpectrumController extends EventEmitter {
   }
 
   _stopPump() {
+    if (this._pumpPollId !== null) {
+      this._rig.stopPolling(this._pumpPollId);
+      this._pumpPollId = null;
+    }
     if (this._pumpTimer) {
       clearInterval(this._pumpTimer);
       this._pumpTimer = null;
@@ -141,6 +186,7 @@ class SpectrumController extends EventEmitter {
       supportsFixedEdges: configurableLevels.includes('SPECTRUM_EDGE_LOW') && configurableLevels.includes('SPECTRUM_EDGE_HIGH'),
       supportsEdgeSlotSelection,
       supportedEdgeSlots: supportsEdgeSlotSelection ? [...DEFAULT_SPECTRUM_EDGE_SLOTS] : [],
+      sweepSupported: supportedLevels.includes('STRENGTH'),
       scopes: capabilities.scopes ?? [],
       modes: capabilities.modes ?? [],
       spans: capabilities.spans ?? [],
@@ -283,22 +329,63 @@ class SpectrumController extends EventEmitter {
     return this.getSpectrumDisplayState();
   }
 
-  async startManagedSpectrum(config = {}) {
-    const summary = await this.getSpectrumSupportSummary();
-    if (!summary.supported) {
-      throw new Error('Official Hamlib spectrum streaming is not supported by this rig/backend');
+  _handleSpectrumPayload(payload) {
+    if (payload && payload.meta instanceof Float64Array) {
+      // Batched mode: remember the newest line's geometry without unpacking.
+      if (payload.lines > 0) {
+        this._recordSpectrumLine(spectrumFrameLineInfo(payload, payload.lines - 1));
+      }
+      this.emit('spectrumFrame', payload);
+      return;
+    }
+    const recorded = this._recordSpectrumLine(payload);
+    this.emit('spectrumLine', recorded);
+  }
+
+  _spectrumStreamOptions(config) {
+    return config.processing
+      ? { ...config.stream, processing: config.processing }
+      : config.stream;
+  }
+
+  async _startSweptSpectrum(config) {
+    if (typeof this._rig.startSweep !== 'function') {
+      throw new TypeError('Expected a HamLib instance with method startSweep()');
+    }
+
+    await this._rig.startSpectrumStream((payload) => this._handleSpectrumPayload(payload),
+      this._spectrumStreamOptions(config));
+    try {
+      this._rig.startSweep(config.sweep, (event) => this.emit('sweepEnd', event));
+    } catch (error) {
+      this.emit('spectrumError', error);
+      await this._rig.stopSpectrumStream();
+      throw error;
     }
 
+    this._managedSpectrumRunning = true;
+    this._managedSweep = true;
+    this.emit('spectrumStateChanged', { active: true, swept: true });
+    return true;
+  }
+
+  async startManagedSpectrum(config = {}) {
     if (this._managedSpectrumRunning) {
       return true;
     }
 
-    const pumpIntervalMs = this._normalizePumpIntervalMs(config.pumpIntervalMs);
+    const summary = await this.getSpectrumSupportSummary();
+    if (!summary.supported) {
+      if (config.sweep) {
+        // No hardware scope: synthesize lines by sweeping the receiver.
+        return this._startSweptSpectrum(config);
+      }
+      throw new Error('Official Hamlib spectrum streaming is not supported by this rig/backend');
+    }
 
-    await this._rig.startSpectrumStream((line) => {
-      const recorded = this._recordSpectrumLine(line);
-      this.emit('spectrumLine', recorded);
-    });
+    const pumpIntervalMs = this._normalizePumpIntervalMs(config.pumpIntervalMs);
+    await this._rig.startSpectrumStream((payload) => this._handleSpectrumPayload(payload),
+      this._spectrumStreamOptions(config));
 
     try {
       try {
@@ -337,6 +424,18 @@ class SpectrumController extends EventEmitter {
       return true;
     }
 
+    if (this._managedSweep) {
+      try {
+        this._rig.stopSweep();
+      } finally {
+        await this._rig.stopSpectrumStream();
+      }
+      this._managedSweep = false;
+      this._managedSpectrumRunning = false;
+      this.emit('spectrumStateChanged', { active: false, swept: true });
+      return true;
+    }
+
     try {
       const supportedFunctions = await this._rig.getSupportedFunctions();
       if (supportedFunctions.includes('TRANSCEIVE')) {
@@ -359,6 +458,7 @@ class SpectrumController extends EventEmitter {
   }
 }
 
-module.exports = { SpectrumController };
+module.exports = { SpectrumController, SPECTRUM_FRAME_FIELDS };
 module.exports.SpectrumController = SpectrumController;
-module.exports.default = { SpectrumController };
+module.exports.SPECTRUM_FRAME_FIELDS = SPECTRUM_FRAME_FIELDS;
+module.exports.default = { SpectrumController, SPECTRUM_FRAME_FIELDS };
@@ -1,7 +1,7 @@
 import { createRequire } from 'module';
 
 const require = createRequire(import.meta.url);
-const { SpectrumController } = require('./spectrum.js');
+const { SpectrumController, SPECTRUM_FRAME_FIELDS } = require('./spectrum.js');
 
-export { SpectrumController };
-export default { SpectrumController };
+export { SpectrumController, SPECTRUM_FRAME_FIELDS };
+export default { SpectrumController, SPECTRUM_FRAME_FIELDS };
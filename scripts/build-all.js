@@ -325,8 +325,8 @@ function runPrebuildify() {
   logger.startSpinner('Generating prebuilt binary...');
 
   try {
-    // Unix: direct prebuildify
-    exec('npx prebuildify --napi --strip');
+    // Same runner as Windows, so the prebuild also gets its model index
+    exec(`node ${path.join(__dirname, 'run-prebuildify.js')}`);
 
     logger.succeedSpinner('Prebuilt binary generated');
 
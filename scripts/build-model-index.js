@@ -0,0 +1,43 @@
+#!/usr/bin/env node
+
+/**
+ * build-model-index.js - Write the prebuilt rig model index
+ *
+ * Enumerates every Hamlib backend once and stores each model's name,
+ * manufacturer, port caps and config schema in hamlib-models.idx next to
+ * the addon binary. At load time the addon memory-maps it, so
+ * getSupportedRigs(), getConfigSchemaForModel() and friends need no
+ * backend initialisation. The index is tied to the Hamlib version it was
+ * built with and ignored by any other.
+ *
+ * Usage:
+ *   node scripts/build-model-index.js [output-path]
+ */
+
+const path = require('path');
+
+// Build from Hamlib itself, not from an index that may already be there.
+process.env.NODE_HAMLIB_MODEL_INDEX = '0';
+
+const { HamLib } = require('../index.js');
+
+function log(msg) {
+  console.log(`[build-model-index] ${msg}`);
+}
+
+function main() {
+  const output = process.argv[2]
+    ? path.resolve(process.argv[2])
+    : HamLib.getDefaultModelIndexPath();
+  const started = Date.now();
+  const result = HamLib.buildModelIndex(output);
+  log(`${result.models} models (${result.incomplete} without caps), ${result.bytes} bytes in ${Date.now() - started}ms`);
+  log(`Wrote ${result.path}`);
+}
+
+try {
+  main();
+} catch (err) {
+  console.error(`[build-model-index] ${err.message}`);
+  process.exit(1);
+}
@@ -1,5 +1,7 @@
 #!/usr/bin/env node
-// Windows-safe prebuildify runner that wraps child_process.spawn for node-gyp
+// Windows-safe prebuildify runner that wraps child_process.spawn for node-gyp.
+// Used on every platform (npm run prebuild, build-all.js) because it also
+// writes the model index next to the native prebuild.
 const os = require('os');
 const path = require('path');
 const cp = require('child_process');
@@ -35,5 +37,14 @@ prebuildify(opts, (err) => {
     process.exit(1);
   }
   console.log('prebuildify completed successfully');
+  // The index has to come from the binary it ships with, so only a native
+  // (not cross-compiled) prebuild gets one.
+  if (opts.platform === os.platform() && opts.arch === os.arch()) {
+    const output = path.join(opts.cwd, 'prebuilds', `${opts.platform}-${opts.arch}`, 'hamlib-models.idx');
+    const result = cp.spawnSync(process.execPath, [path.join(__dirname, 'build-model-index.js'), output], { stdio: 'inherit' });
+    if (result.status !== 0) {
+      console.warn('Model index not written; lookups will initialise backends instead');
+    }
+  }
 });
 
@@ -1,19 +1,37 @@
 #include <napi.h>
+#include "addon_data.h"
 #include "hamlib.h"
+#include "node_hamlib_group.h"
 #include "node_rotator.h"
+#include "node_spectrum_recording.h"
 #include "decoder.h"
 #include "shim/hamlib_shim.h"
 
+#include <mutex>
+
+// Runs once per environment: the main thread and each worker_thread that
+// requires the addon.
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
   // Set Hamlib debug level to NONE by default to prevent unwanted output
-  // Users can change this using HamLib.setDebugLevel() if needed
-  shim_rig_set_debug(0); // 0 = RIG_DEBUG_NONE
+  // Users can change this using HamLib.setDebugLevel() if needed. Only the
+  // first load does so, so a worker starting up keeps the level already set.
+  static std::once_flag debugLevelOnce;
+  std::call_once(debugLevelOnce, []() { shim_rig_set_debug(0); }); // 0 = RIG_DEBUG_NONE
+
+  HamLibAddonData* data = HamLibAddonData::Install(env);
+
+  Napi::Function hamlib = NodeHamLib::GetClass(env);
+  data->hamlib_constructor = Napi::Persistent(hamlib);
+  exports.Set(Napi::String::New(env, "HamLib"), hamlib);
+  exports.Set(Napi::String::New(env, "HamLibGroup"), NodeHamLibGroup::GetClass(env));
 
-  Napi::String name = Napi::String::New(env, "HamLib");
-  exports.Set(name, NodeHamLib::GetClass(env));
+  Napi::Function rotator = NodeRotator::GetClass(env);
+  data->rotator_constructor = Napi::Persistent(rotator);
+  exports.Set(Napi::String::New(env, "Rotator"), rotator);
 
-  Napi::String rotatorName = Napi::String::New(env, "Rotator");
-  exports.Set(rotatorName, NodeRotator::GetClass(env));
+  Napi::Function recording = NodeSpectrumRecording::GetClass(env);
+  data->spectrum_recording_constructor = Napi::Persistent(recording);
+  exports.Set(Napi::String::New(env, "SpectrumRecording"), recording);
 
 
   // Napi::String decoder_name = Napi::String::New(env, "Decoder");
@@ -0,0 +1,34 @@
+#include "addon_data.h"
+
+#include "hamlib.h"
+#include "node_rotator.h"
+
+#include <vector>
+
+HamLibAddonData::~HamLibAddonData() {
+  for (NodeHamLib* rig : rigs_) {
+    rig->addon_data_ = nullptr;
+  }
+  for (NodeRotator* rotator : rotators_) {
+    rotator->addon_data_ = nullptr;
+  }
+}
+
+HamLibAddonData* HamLibAddonData::Install(Napi::Env env) {
+  auto* data = new HamLibAddonData();
+  env.SetInstanceData(data);
+  env.AddCleanupHook(Cleanup, data);
+  return data;
+}
+
+void HamLibAddonData::Cleanup(HamLibAddonData* data) {
+  // Rigs first: a rig's tracking loop may still drive one of the rotators.
+  const std::vector<NodeHamLib*> rigs(data->rigs_.begin(), data->rigs_.end());
+  for (NodeHamLib* rig : rigs) {
+    rig->ShutdownNative();
+  }
+  const std::vector<NodeRotator*> rotators(data->rotators_.begin(), data->rotators_.end());
+  for (NodeRotator* rotator : rotators) {
+    rotator->ShutdownNative();
+  }
+}
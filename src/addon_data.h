@@ -0,0 +1,47 @@
+#pragma once
+
+#include <napi.h>
+#include <unordered_set>
+
+class NodeHamLib;
+class NodeRotator;
+
+// Per-environment state of the addon, stored with SetInstanceData. The main
+// thread and every worker_thread that loads the addon get their own, so JS
+// handles never cross event loops. State that has to be process-wide (the
+// Hamlib locks, the metadata mutex, metrics, the rig catalog) stays static
+// in its own module and is thread-safe.
+class HamLibAddonData {
+public:
+    HamLibAddonData() = default;
+    // Detaches instances that outlive the data (not expected, but the
+    // finalizer order at environment teardown is not ours to pick).
+    ~HamLibAddonData();
+
+    HamLibAddonData(const HamLibAddonData&) = delete;
+    HamLibAddonData& operator=(const HamLibAddonData&) = delete;
+
+    // Creates the data for `env` and registers its cleanup hook. Init only.
+    static HamLibAddonData* Install(Napi::Env env);
+    static HamLibAddonData* From(Napi::Env env) { return env.GetInstanceData<HamLibAddonData>(); }
+
+    Napi::FunctionReference hamlib_constructor;
+    Napi::FunctionReference rotator_constructor;
+    Napi::FunctionReference spectrum_recording_constructor;
+
+    // Live native instances of this environment; JS thread only.
+    void AddRig(NodeHamLib* rig) { rigs_.insert(rig); }
+    void RemoveRig(NodeHamLib* rig) { rigs_.erase(rig); }
+    void AddRotator(NodeRotator* rotator) { rotators_.insert(rotator); }
+    void RemoveRotator(NodeRotator* rotator) { rotators_.erase(rotator); }
+
+private:
+    // Environment cleanup hook: runs before the wrapped objects are finalized
+    // and stops their native threads (poller, tracker, command threads,
+    // spectrum and transceive streams) and closes their devices, so a worker
+    // thread can exit while a rig is still open.
+    static void Cleanup(HamLibAddonData* data);
+
+    std::unordered_set<NodeHamLib*> rigs_;
+    std::unordered_set<NodeRotator*> rotators_;
+};
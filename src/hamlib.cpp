@@ -1,18 +1,32 @@
 #include "hamlib.h"
 #include "shim/hamlib_shim.h"
+#include "addon_data.h"
+#include "rig_tokens.h"
+#include "rig_catalog.h"
+#include "rig_model_index.h"
+#include "rig_metrics_js.h"
+#include "rig_tracker.h"
+#include "raw_stream.h"
+#include "rig_sweep.h"
+#include "node_rotator.h"
 #include <string>
 #include <vector>
 #include <memory>
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <cctype>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <exception>
 #include <functional>
 #include <limits>
+#include <map>
 #include <set>
+#include <sstream>
+#include <thread>
 
 // 安全宏 - 检查RIG指针有效性，防止空指针解引用和已销毁对象访问
 #define CHECK_RIG_VALID() \
@@ -32,11 +46,6 @@
   } while(0)
 
 // Structure to hold rig information for the callback
-struct RigListData {
-  std::vector<Napi::Object> rigList;
-  Napi::Env env;
-};
-
 struct RigConfigFieldDescriptor {
   int token;
   std::string name;
@@ -70,6 +79,43 @@ static bool readGlobalRigLockDefault() {
   return value != "0" && value != "false" && value != "off" && value != "no";
 }
 
+static bool readCommandThreadDefault() {
+  const char* rawValue = std::getenv("NODE_HAMLIB_COMMAND_THREAD");
+  if (!rawValue || !*rawValue) {
+    return false;
+  }
+
+  std::string value(rawValue);
+  std::transform(value.begin(), value.end(), value.begin(), [](unsigned char ch) {
+    return static_cast<char>(std::tolower(ch));
+  });
+
+  return value == "1" || value == "true" || value == "on" || value == "yes";
+}
+
+// NODE_HAMLIB_TRACE=1 (or a ring capacity) enables tracing on new instances.
+static size_t readTraceDefault() {
+  const char* rawValue = std::getenv("NODE_HAMLIB_TRACE");
+  if (!rawValue || !*rawValue) {
+    return 0;
+  }
+
+  std::string value(rawValue);
+  std::transform(value.begin(), value.end(), value.begin(), [](unsigned char ch) {
+    return static_cast<char>(std::tolower(ch));
+  });
+  if (value == "true" || value == "on" || value == "yes") {
+    return RigTraceRing::kDefaultCapacity;
+  }
+
+  char* end = nullptr;
+  const long parsed = std::strtol(rawValue, &end, 10);
+  if (end == rawValue || *end != '\0' || parsed <= 0) {
+    return 0;
+  }
+  return parsed == 1 ? RigTraceRing::kDefaultCapacity : static_cast<size_t>(parsed);
+}
+
 static int readGlobalRigLockTimeoutMs() {
   const char* rawValue = std::getenv("NODE_HAMLIB_GLOBAL_LOCK_TIMEOUT_MS");
   if (!rawValue || !*rawValue) {
@@ -84,19 +130,147 @@ static int readGlobalRigLockTimeoutMs() {
   return static_cast<int>(parsed);
 }
 
-Napi::FunctionReference NodeHamLib::constructor;
-Napi::ThreadSafeFunction tsfn;
+static bool parseRigLockScope(const std::string& rawValue, RigLockScope* scope) {
+  std::string value(rawValue);
+  std::transform(value.begin(), value.end(), value.begin(), [](unsigned char ch) {
+    return static_cast<char>(std::tolower(ch));
+  });
+
+  if (value == "global") {
+    *scope = RigLockScope::Global;
+  } else if (value == "port" || value == "per-port") {
+    *scope = RigLockScope::Port;
+  } else if (value == "instance" || value == "per-instance") {
+    *scope = RigLockScope::Instance;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static const char* rigLockScopeName(RigLockScope scope) {
+  switch (scope) {
+    case RigLockScope::Port: return "port";
+    case RigLockScope::Instance: return "instance";
+    case RigLockScope::Global:
+    default: return "global";
+  }
+}
+
+static int readRigLockScopeDefault() {
+  const char* rawValue = std::getenv("NODE_HAMLIB_LOCK_SCOPE");
+  RigLockScope scope = RigLockScope::Global;
+  if (rawValue && *rawValue && !parseRigLockScope(rawValue, &scope)) {
+    scope = RigLockScope::Global;
+  }
+  return static_cast<int>(scope);
+}
+
+// Models whose backends keep process-wide state and therefore always use the
+// global lock, whatever the configured scope. Seeded from
+// NODE_HAMLIB_SERIALIZED_MODELS ("1035,3073") and HamLib.setBackendSerialized().
+static std::mutex& serializedBackendMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+static std::set<unsigned int>& serializedBackendModels() {
+  static std::set<unsigned int> models = [] {
+    std::set<unsigned int> seeded;
+    const char* rawValue = std::getenv("NODE_HAMLIB_SERIALIZED_MODELS");
+    if (!rawValue || !*rawValue) {
+      return seeded;
+    }
+    std::stringstream stream(rawValue);
+    std::string token;
+    while (std::getline(stream, token, ',')) {
+      char* end = nullptr;
+      const unsigned long parsed = std::strtoul(token.c_str(), &end, 10);
+      if (end != token.c_str() && parsed > 0) {
+        seeded.insert(static_cast<unsigned int>(parsed));
+      }
+    }
+    return seeded;
+  }();
+  return models;
+}
+
+// Instances resolving to the same device key share one mutex. Entries are weak
+// so a device's mutex goes away with the last instance using it.
+static std::shared_ptr<std::timed_mutex> acquireDeviceRigMutex(const std::string& key) {
+  static std::mutex registryMutex;
+  static std::map<std::string, std::weak_ptr<std::timed_mutex>> registry;
+
+  std::lock_guard<std::mutex> guard(registryMutex);
+  for (auto it = registry.begin(); it != registry.end();) {
+    if (it->second.expired()) {
+      it = registry.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  std::shared_ptr<std::timed_mutex> mutex = registry[key].lock();
+  if (!mutex) {
+    mutex = std::make_shared<std::timed_mutex>();
+    registry[key] = mutex;
+  }
+  return mutex;
+}
+
+static std::string normalizeRigDeviceKey(const char* path, bool isNetwork) {
+  std::string key(path ? path : "");
+  if (isNetwork) {
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char ch) {
+      return static_cast<char>(std::tolower(ch));
+    });
+    if (key.compare(0, 10, "localhost:") == 0) {
+      key = "127.0.0.1:" + key.substr(10);
+    }
+    return "net:" + key;
+  }
+#ifdef _WIN32
+  if (key.compare(0, 4, "\\\\.\\") == 0) {
+    key = key.substr(4);
+  }
+  std::transform(key.begin(), key.end(), key.begin(), [](unsigned char ch) {
+    return static_cast<char>(std::toupper(ch));
+  });
+#else
+  // Resolve /dev/serial/by-id style symlinks so aliases of one device collide.
+  char* resolved = realpath(key.c_str(), nullptr);
+  if (resolved) {
+    key = resolved;
+    free(resolved);
+  }
+#endif
+  return "dev:" + key;
+}
+
 std::timed_mutex NodeHamLib::global_rig_mutex_;
 std::atomic<bool> NodeHamLib::global_rig_lock_enabled_{readGlobalRigLockDefault()};
+std::atomic<int> NodeHamLib::rig_lock_scope_{readRigLockScopeDefault()};
 std::mutex NodeHamLib::metadata_mutex_;
 
 constexpr const char* kGlobalLockTimeoutCode = "HAMLIB_GLOBAL_LOCK_TIMEOUT";
+constexpr const char* kCommandQueueFullCode = "HAMLIB_COMMAND_QUEUE_FULL";
+constexpr const char* kCommandShedCode = "HAMLIB_COMMAND_SHED";
+constexpr const char* kCallAbortedCode = "HAMLIB_ABORTED";
+constexpr const char* kCallDeadlineCode = "HAMLIB_DEADLINE_EXCEEDED";
+constexpr const char* kSessionErrorCode = "HAMLIB_SESSION_ERROR";
+// How often a scoped worker waiting for the rig lock re-checks its scope.
+constexpr std::chrono::milliseconds kCallScopeLockSlice(20);
+constexpr size_t kDefaultCommandQueueCapacity = 256;
 
 constexpr int kInvalidVfoParameter = std::numeric_limits<int>::min();
 
 static int parseVfoString(Napi::Env env, const std::string& vfoToken);
 static Napi::Array rigConfigSchemaToArray(Napi::Env env, const RigConfigSchemaData& schemaData);
 static Napi::Object portCapsToObject(Napi::Env env, const shim_rig_port_caps_t& caps);
+static void stopRigPollScheduler(std::shared_ptr<RigPollScheduler>& scheduler);
+static void stopRigTracker(std::shared_ptr<RigTracker>& tracker);
+static void stopRigRawStream(std::shared_ptr<RigRawStream>& stream);
+static void stopRigSweep(std::shared_ptr<RigSweep>& sweep);
 
 static std::string publicVfoToken(int vfo) {
   const char* rawToken = shim_rig_strvfo(vfo);
@@ -142,100 +316,36 @@ static T clampValue(T value, T minValue, T maxValue) {
   return value;
 }
 
+static bool parseFunctionTypeString(const std::string& funcTypeStr, uint64_t* outFuncType) {
+  return lookupRigToken(RigTokenKind::Function, funcTypeStr, outFuncType);
+}
+
 static bool parseLevelTypeString(const std::string& levelTypeStr, uint64_t* outLevelType) {
-  if (!outLevelType) {
-    return false;
+  return lookupRigToken(RigTokenKind::Level, levelTypeStr, outLevelType);
+}
+
+// Common parms come from the local table; anything else goes to Hamlib.
+static uint64_t parseParmName(const std::string& parmStr) {
+  uint64_t parm = 0;
+  if (lookupRigToken(RigTokenKind::Parm, parmStr, &parm)) {
+    return parm;
   }
+  return shim_rig_parse_parm(parmStr.c_str());
+}
 
-  uint64_t levelType = 0;
-  if (levelTypeStr == "AF") {
-    levelType = SHIM_RIG_LEVEL_AF;
-  } else if (levelTypeStr == "PREAMP") {
-    levelType = SHIM_RIG_LEVEL_PREAMP;
-  } else if (levelTypeStr == "ATT") {
-    levelType = SHIM_RIG_LEVEL_ATT;
-  } else if (levelTypeStr == "RF") {
-    levelType = SHIM_RIG_LEVEL_RF;
-  } else if (levelTypeStr == "SQL") {
-    levelType = SHIM_RIG_LEVEL_SQL;
-  } else if (levelTypeStr == "RFPOWER") {
-    levelType = SHIM_RIG_LEVEL_RFPOWER;
-  } else if (levelTypeStr == "MICGAIN") {
-    levelType = SHIM_RIG_LEVEL_MICGAIN;
-  } else if (levelTypeStr == "SWR") {
-    levelType = SHIM_RIG_LEVEL_SWR;
-  } else if (levelTypeStr == "ALC") {
-    levelType = SHIM_RIG_LEVEL_ALC;
-  } else if (levelTypeStr == "STRENGTH") {
-    levelType = SHIM_RIG_LEVEL_STRENGTH;
-  } else if (levelTypeStr == "RAWSTR") {
-    levelType = SHIM_RIG_LEVEL_RAWSTR;
-  } else if (levelTypeStr == "RFPOWER_METER") {
-    levelType = SHIM_RIG_LEVEL_RFPOWER_METER;
-  } else if (levelTypeStr == "RFPOWER_METER_WATTS") {
-    levelType = SHIM_RIG_LEVEL_RFPOWER_METER_WATTS;
-  } else if (levelTypeStr == "COMP_METER") {
-    levelType = SHIM_RIG_LEVEL_COMP_METER;
-  } else if (levelTypeStr == "VD_METER") {
-    levelType = SHIM_RIG_LEVEL_VD_METER;
-  } else if (levelTypeStr == "ID_METER") {
-    levelType = SHIM_RIG_LEVEL_ID_METER;
-  } else if (levelTypeStr == "TEMP_METER") {
-    levelType = SHIM_RIG_LEVEL_TEMP_METER;
-  } else if (levelTypeStr == "IF") {
-    levelType = SHIM_RIG_LEVEL_IF;
-  } else if (levelTypeStr == "APF") {
-    levelType = SHIM_RIG_LEVEL_APF;
-  } else if (levelTypeStr == "NR") {
-    levelType = SHIM_RIG_LEVEL_NR;
-  } else if (levelTypeStr == "PBT_IN") {
-    levelType = SHIM_RIG_LEVEL_PBT_IN;
-  } else if (levelTypeStr == "PBT_OUT") {
-    levelType = SHIM_RIG_LEVEL_PBT_OUT;
-  } else if (levelTypeStr == "CWPITCH") {
-    levelType = SHIM_RIG_LEVEL_CWPITCH;
-  } else if (levelTypeStr == "KEYSPD") {
-    levelType = SHIM_RIG_LEVEL_KEYSPD;
-  } else if (levelTypeStr == "NOTCHF") {
-    levelType = SHIM_RIG_LEVEL_NOTCHF;
-  } else if (levelTypeStr == "COMP") {
-    levelType = SHIM_RIG_LEVEL_COMP;
-  } else if (levelTypeStr == "AGC") {
-    levelType = SHIM_RIG_LEVEL_AGC;
-  } else if (levelTypeStr == "BKINDL") {
-    levelType = SHIM_RIG_LEVEL_BKINDL;
-  } else if (levelTypeStr == "BALANCE") {
-    levelType = SHIM_RIG_LEVEL_BALANCE;
-  } else if (levelTypeStr == "VOXGAIN") {
-    levelType = SHIM_RIG_LEVEL_VOXGAIN;
-  } else if (levelTypeStr == "VOXDELAY") {
-    levelType = SHIM_RIG_LEVEL_VOXDELAY;
-  } else if (levelTypeStr == "ANTIVOX") {
-    levelType = SHIM_RIG_LEVEL_ANTIVOX;
-  } else if (levelTypeStr == "MONITOR_GAIN") {
-    levelType = SHIM_RIG_LEVEL_MONITOR_GAIN;
-  } else if (levelTypeStr == "SPECTRUM_MODE") {
-    levelType = SHIM_RIG_LEVEL_SPECTRUM_MODE;
-  } else if (levelTypeStr == "SPECTRUM_SPAN") {
-    levelType = SHIM_RIG_LEVEL_SPECTRUM_SPAN;
-  } else if (levelTypeStr == "SPECTRUM_EDGE_LOW") {
-    levelType = SHIM_RIG_LEVEL_SPECTRUM_EDGE_LOW;
-  } else if (levelTypeStr == "SPECTRUM_EDGE_HIGH") {
-    levelType = SHIM_RIG_LEVEL_SPECTRUM_EDGE_HIGH;
-  } else if (levelTypeStr == "SPECTRUM_SPEED") {
-    levelType = SHIM_RIG_LEVEL_SPECTRUM_SPEED;
-  } else if (levelTypeStr == "SPECTRUM_REF") {
-    levelType = SHIM_RIG_LEVEL_SPECTRUM_REF;
-  } else if (levelTypeStr == "SPECTRUM_AVG") {
-    levelType = SHIM_RIG_LEVEL_SPECTRUM_AVG;
-  } else if (levelTypeStr == "SPECTRUM_ATT") {
-    levelType = SHIM_RIG_LEVEL_SPECTRUM_ATT;
-  } else {
-    return false;
+// Accepts a token name or a handle from HamLib.getLevelHandle() and friends.
+static bool parseTokenValue(RigTokenKind kind, const Napi::Value& value, uint64_t* out) {
+  if (value.IsString()) {
+    return lookupRigToken(kind, value.As<Napi::String>().Utf8Value(), out);
   }
+  if (value.IsNumber()) {
+    return resolveRigTokenHandle(kind, value.As<Napi::Number>().DoubleValue(), out);
+  }
+  return false;
+}
 
-  *outLevelType = levelType;
-  return true;
+static bool isTokenValue(const Napi::Value& value) {
+  return value.IsString() || value.IsNumber();
 }
 
 struct NamedBit {
@@ -584,19 +694,36 @@ static int antennaMaskToOrdinal(int antennaMask) {
 HamLibPromiseController::HamLibPromiseController(Napi::Env env, HamLibAsyncWorker* owner)
     : deferred_(Napi::Promise::Deferred::New(env)), owner_(owner) {}
 
+Napi::Promise HamLibPromiseController::AddFollower(Napi::Env env) {
+    followers_.push_back(Napi::Promise::Deferred::New(env));
+    return followers_.back().Promise();
+}
+
 void HamLibPromiseController::Resolve(Napi::Value value) {
     if (owner_) {
+        owner_->RecordTrace(RigTracePhase::Settled);
+        owner_->ReleaseCoalescing();
         owner_->ReleaseObjectReference();
     }
     deferred_.Resolve(value);
+    for (const Napi::Promise::Deferred& follower : followers_) {
+        follower.Resolve(value);
+    }
+    followers_.clear();
 }
 
 void HamLibPromiseController::Reject(Napi::Value value) {
     if (owner_) {
         value = owner_->DecorateErrorValue(value);
+        owner_->RecordTrace(RigTracePhase::Settled, true);
+        owner_->ReleaseCoalescing();
         owner_->ReleaseObjectReference();
     }
     deferred_.Reject(value);
+    for (const Napi::Promise::Deferred& follower : followers_) {
+        follower.Reject(value);
+    }
+    followers_.clear();
 }
 
 // Base AsyncWorker implementation with Promise support
@@ -607,18 +734,59 @@ HamLibAsyncWorker::HamLibAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance)
       error_code_(""),
       error_message_(""),
       lock_timeout_ms_(0),
+      lock_holder_held_ms_(0),
       object_ref_held_(false),
+      rig_metrics_(hamlib_instance ? hamlib_instance->metrics_ : nullptr),
+      metrics_queued_(false),
+      coalesce_write_(false),
+      priority_(RigCommandPriority::Interactive),
+      queued_at_us_(0),
+      counted_inflight_(false),
+      call_control_(hamlib_instance ? hamlib_instance->CurrentCallControl() : nullptr),
+      trace_(hamlib_instance && hamlib_instance->trace_enabled_ ? hamlib_instance->trace_ : nullptr),
+      trace_call_id_(trace_ ? trace_->NextCallId() : 0),
+      trace_operation_(nullptr),
       deferred_(env, this) {
     if (hamlib_instance_) {
         hamlib_instance_->Ref();
         object_ref_held_ = true;
     }
+    // OperationName() is not virtual yet; later phases name the call.
+    RecordTrace(RigTracePhase::Created);
 }
 
 HamLibAsyncWorker::~HamLibAsyncWorker() {
+    // Queued but never executed (e.g. environment teardown).
+    if (metrics_queued_) {
+        RigMetricsRegistry::Global().NoteDequeued();
+        if (rig_metrics_) {
+            rig_metrics_->NoteDequeued();
+        }
+    }
+    if (counted_inflight_ && hamlib_instance_ && hamlib_instance_->inflight_commands_ > 0) {
+        --hamlib_instance_->inflight_commands_;
+    }
+    ReleaseCoalescing();
     ReleaseObjectReference();
 }
 
+void HamLibAsyncWorker::SetCoalesceKey(std::string key, bool write) {
+    coalesce_key_ = std::move(key);
+    coalesce_write_ = write;
+}
+
+void HamLibAsyncWorker::ReleaseCoalescing() {
+    if (coalesce_key_.empty() || !hamlib_instance_) {
+        return;
+    }
+    auto& registry = coalesce_write_ ? hamlib_instance_->pending_writes_ : hamlib_instance_->inflight_reads_;
+    auto entry = registry.find(coalesce_key_);
+    if (entry != registry.end() && entry->second == this) {
+        registry.erase(entry);
+    }
+    coalesce_key_.clear();
+}
+
 void HamLibAsyncWorker::ReleaseObjectReference() {
     if (object_ref_held_ && hamlib_instance_) {
         hamlib_instance_->Unref();
@@ -649,6 +817,20 @@ Napi::Value HamLibAsyncWorker::DecorateErrorValue(Napi::Value value) const {
     error.Set("operation", Napi::String::New(env, GetOperationName()));
     if (isLockTimeout && lock_timeout_ms_ > 0) {
         error.Set("timeoutMs", Napi::Number::New(env, lock_timeout_ms_));
+        if (!lock_scope_.empty()) {
+            error.Set("lockScope", Napi::String::New(env, lock_scope_));
+        }
+        if (!lock_holder_.empty()) {
+            Napi::Object holder = Napi::Object::New(env);
+            holder.Set("operation", Napi::String::New(env, lock_holder_));
+            holder.Set("heldMs", Napi::Number::New(env, lock_holder_held_ms_));
+            error.Set("lockHolder", holder);
+        }
+    }
+    if (error_code_ == kCallAbortedCode) {
+        error.Set("name", Napi::String::New(env, "AbortError"));
+    } else if (error_code_ == kCallDeadlineCode) {
+        error.Set("name", Napi::String::New(env, "TimeoutError"));
     }
     if (hasCode) {
         return error;
@@ -664,31 +846,189 @@ Napi::Value HamLibAsyncWorker::DecorateErrorValue(Napi::Value value) const {
     return error;
 }
 
+void HamLibAsyncWorker::Queue() {
+    priority_ = hamlib_instance_
+        ? hamlib_instance_->CommandPriorityFor(OperationName(), DefaultPriority())
+        : DefaultPriority();
+    queued_at_us_ = rigMetricsNowMicros();
+    if (!metrics_queued_) {
+        metrics_queued_ = true;
+        RigMetricsRegistry::Global().NoteQueued();
+        if (rig_metrics_) {
+            rig_metrics_->NoteQueued();
+        }
+    }
+    if (hamlib_instance_ && priority_ == RigCommandPriority::Background
+        && hamlib_instance_->background_budget_ > 0
+        && hamlib_instance_->inflight_commands_ >= hamlib_instance_->background_budget_) {
+        // Over budget: refuse the poll without joining the queue, and
+        // without acting as a coalescing barrier.
+        RigMetricsRegistry::Global().RecordLaneShed(priority_);
+        if (rig_metrics_) {
+            rig_metrics_->RecordLaneShed(priority_);
+        }
+        result_code_ = SHIM_RIG_ENAVAIL;
+        error_code_ = kCommandShedCode;
+        error_message_ = std::string(kCommandShedCode)
+            + ": background command shed with " + std::to_string(hamlib_instance_->inflight_commands_)
+            + " commands in flight operation=" + GetOperationName();
+        Napi::AsyncWorker::Queue();
+        return;
+    }
+    // Only a worker that was accepted counts as in flight and acts as a
+    // coalescing barrier or leader. Completion runs on this (JS) thread, so
+    // noting it right after Submit() cannot race the destructor.
+    auto noteAccepted = [this]() {
+        if (hamlib_instance_) {
+            hamlib_instance_->NoteCommandQueued(this, coalesce_key_, coalesce_write_);
+            ++hamlib_instance_->inflight_commands_;
+            counted_inflight_ = true;
+        }
+    };
+    if (hamlib_instance_ && hamlib_instance_->command_executor_) {
+        if (hamlib_instance_->command_executor_->Submit(this, priority_)) {
+            noteAccepted();
+            return;
+        }
+        // Fall through to the threadpool only to deliver the rejection
+        // asynchronously; Execute() sees the preset error, counts the call
+        // as rejected and returns at once.
+        result_code_ = SHIM_RIG_ENAVAIL;
+        error_code_ = kCommandQueueFullCode;
+        error_message_ = std::string(kCommandQueueFullCode)
+            + ": command thread queue is full operation=" + GetOperationName();
+    } else {
+        noteAccepted();
+    }
+    Napi::AsyncWorker::Queue();
+}
+
+void HamLibAsyncWorker::RunOnCommandThread() {
+    Execute();
+}
+
+void HamLibAsyncWorker::CompleteOnJsThread(Napi::Env env) {
+    (void)env;
+    OnOK();
+    Destroy();
+}
+
 void HamLibAsyncWorker::Execute() {
+    RigMetricsRegistry& globalMetrics = RigMetricsRegistry::Global();
+    RigMetricsRegistry* rigMetrics = rig_metrics_.get();
+    if (metrics_queued_) {
+        metrics_queued_ = false;
+        globalMetrics.NoteDequeued();
+        if (rigMetrics) {
+            rigMetrics->NoteDequeued();
+        }
+    }
+    const char* operation = OperationName();
+    RigOperationMetrics* globalOperation = globalMetrics.ForOperation(operation);
+    RigOperationMetrics* rigOperation = rigMetrics ? rigMetrics->ForOperation(operation) : nullptr;
+    trace_operation_ = globalOperation;
+    RecordTrace(RigTracePhase::Started);
+
+    if (!error_code_.empty() || CallStopped()) {
+        globalOperation->RecordRejected();
+        if (rigOperation) {
+            rigOperation->RecordRejected();
+        }
+        return;
+    }
     const int timeoutMs = readGlobalRigLockTimeoutMs();
     lock_timeout_ms_ = timeoutMs;
-    auto rigLock = NodeHamLib::TryAcquireGlobalRigLockIfEnabled(std::chrono::milliseconds(timeoutMs));
+    RigLockScope lockScope = RigLockScope::Global;
+    globalMetrics.NoteLockWaitBegin();
+    if (rigMetrics) {
+        rigMetrics->NoteLockWaitBegin();
+    }
+    const int64_t waitStartedUs = rigMetricsNowMicros();
+    auto acquire = [&](std::chrono::milliseconds timeout) {
+        return hamlib_instance_
+            ? hamlib_instance_->TryAcquireRigLockIfEnabled(timeout, &lockScope, priority_)
+            : NodeHamLib::TryAcquireGlobalRigLockIfEnabled(timeout, priority_);
+    };
+    GlobalRigLock rigLock;
+    if (!call_control_) {
+        rigLock = acquire(std::chrono::milliseconds(timeoutMs));
+    } else {
+        // Wait in slices so an abort or an expired deadline drops the call
+        // while it is still waiting for the rig.
+        using CallClock = RigCallControl::Clock;
+        const CallClock::time_point lockDeadline = CallClock::now() + std::chrono::milliseconds(timeoutMs);
+        for (;;) {
+            const CallClock::time_point now = CallClock::now();
+            const CallClock::time_point until = call_control_->HasDeadline()
+                ? std::min(lockDeadline, call_control_->Deadline())
+                : lockDeadline;
+            const auto remaining = std::max(std::chrono::milliseconds(0),
+                std::chrono::duration_cast<std::chrono::milliseconds>(until - now));
+            rigLock = acquire(std::min(remaining, kCallScopeLockSlice));
+            if (rigLock.owns_lock() || !NodeHamLib::IsGlobalRigLockEnabled()
+                || now >= until || call_control_->Cancelled()) {
+                break;
+            }
+        }
+    }
+    const int64_t lockedUs = rigMetricsNowMicros();
+    RecordTrace(RigTracePhase::Locked);
+    const uint64_t lockWaitUs = static_cast<uint64_t>(std::max<int64_t>(0, lockedUs - waitStartedUs));
+    globalMetrics.NoteLockWaitEnd();
+    globalOperation->RecordLockWait(lockWaitUs);
+    if (rigMetrics) {
+        rigMetrics->NoteLockWaitEnd();
+        rigOperation->RecordLockWait(lockWaitUs);
+    }
+    lock_scope_ = rigLockScopeName(lockScope);
+    if (CallStopped()) {
+        globalOperation->RecordRejected();
+        if (rigOperation) {
+            rigOperation->RecordRejected();
+        }
+        return;
+    }
     if (!rigLock.owns_lock() && NodeHamLib::IsGlobalRigLockEnabled()) {
         result_code_ = SHIM_RIG_ETIMEOUT;
         error_code_ = kGlobalLockTimeoutCode;
         error_message_ = std::string(kGlobalLockTimeoutCode)
-            + ": timed out waiting for Hamlib global lock"
+            + ": timed out waiting for Hamlib " + lock_scope_ + " lock"
             + " operation=" + GetOperationName()
             + " timeoutMs=" + std::to_string(timeoutMs);
+        RigLockHolderSnapshot holder;
+        if (RigLockHolderTable::Global().Find(rigLock.mutex(), &holder)) {
+            lock_holder_ = holder.operation;
+            lock_holder_held_ms_ = holder.held_ms;
+            error_message_ += " heldBy=" + holder.operation
+                + " heldMs=" + std::to_string(static_cast<long long>(holder.held_ms));
+        }
+        globalOperation->RecordLockTimeout();
+        if (rigOperation) {
+            rigOperation->RecordLockTimeout();
+        }
+        RecordLaneCall();
         return;
     }
+
+    const void* heldMutex = rigLock.owns_lock() ? rigLock.mutex() : nullptr;
+    RigLockHolderTable::Global().NoteAcquired(heldMutex, globalOperation, rigLockScopeName(lockScope));
+    globalMetrics.NoteExecuteBegin();
+    if (rigMetrics) {
+        rigMetrics->NoteExecuteBegin();
+    }
     try {
         if (!hamlib_instance_ || !hamlib_instance_->my_rig) {
             result_code_ = SHIM_RIG_EINVAL;
             error_message_ = "RIG is not initialized or has been destroyed";
-            return;
-        }
-        if (RequiresOpenRig() && !hamlib_instance_->rig_is_open.load(std::memory_order_acquire)) {
+        } else if (RequiresOpenRig() && !hamlib_instance_->rig_is_open.load(std::memory_order_acquire)) {
             result_code_ = SHIM_RIG_EINVAL;
             error_message_ = "Rig is not open!";
-            return;
+        } else {
+            ExecuteWithRigLock();
+            if (InvalidatesStateCache()) {
+                hamlib_instance_->state_cache_.Invalidate();
+            }
         }
-        ExecuteWithRigLock();
     } catch (const std::exception& error) {
         result_code_ = SHIM_RIG_EINVAL;
         error_message_ = error.what();
@@ -696,6 +1036,60 @@ void HamLibAsyncWorker::Execute() {
         result_code_ = SHIM_RIG_EINVAL;
         error_message_ = "Unexpected native exception in Hamlib worker";
     }
+    const uint64_t executeUs = static_cast<uint64_t>(std::max<int64_t>(0, rigMetricsNowMicros() - lockedUs));
+    RecordTrace(RigTracePhase::Returned);
+    RigLockHolderTable::Global().NoteReleased(heldMutex);
+
+    // Positive result codes carry values (e.g. range counts), not errors.
+    const bool failed = result_code_ < 0 || !error_message_.empty();
+    globalMetrics.NoteExecuteEnd();
+    globalOperation->RecordCall(executeUs, failed, result_code_);
+    if (rigMetrics) {
+        rigMetrics->NoteExecuteEnd();
+        rigOperation->RecordCall(executeUs, failed, result_code_);
+    }
+    RecordLaneCall();
+}
+
+bool HamLibAsyncWorker::CallStopped() {
+    if (!call_control_) {
+        return false;
+    }
+    switch (call_control_->Check(RigCallControl::Clock::now())) {
+        case RigCallControl::Stop::Aborted:
+            result_code_ = SHIM_RIG_ENAVAIL;
+            error_code_ = kCallAbortedCode;
+            error_message_ = std::string(kCallAbortedCode)
+                + ": call aborted operation=" + GetOperationName();
+            return true;
+        case RigCallControl::Stop::DeadlineExceeded:
+            result_code_ = SHIM_RIG_ETIMEOUT;
+            error_code_ = kCallDeadlineCode;
+            error_message_ = std::string(kCallDeadlineCode)
+                + ": call deadline passed operation=" + GetOperationName();
+            return true;
+        case RigCallControl::Stop::None:
+        default:
+            return false;
+    }
+}
+
+void HamLibAsyncWorker::RecordTrace(RigTracePhase phase, bool failed) {
+    if (!trace_) {
+        return;
+    }
+    if (!trace_operation_ && phase != RigTracePhase::Created) {
+        trace_operation_ = RigMetricsRegistry::Global().ForOperation(OperationName());
+    }
+    trace_->Record(trace_call_id_, phase, trace_operation_, priority_, result_code_, failed);
+}
+
+void HamLibAsyncWorker::RecordLaneCall() {
+    const uint64_t latencyUs = static_cast<uint64_t>(std::max<int64_t>(0, rigMetricsNowMicros() - queued_at_us_));
+    RigMetricsRegistry::Global().RecordLaneCall(priority_, latencyUs);
+    if (rig_metrics_) {
+        rig_metrics_->RecordLaneCall(priority_, latencyUs);
+    }
 }
 
 class LockedCallbackWorker : public HamLibAsyncWorker {
@@ -708,14 +1102,19 @@ public:
         NodeHamLib* hamlib_instance,
         std::string operation,
         ExecuteFn execute,
-        ResolveFn resolve)
+        ResolveFn resolve,
+        bool requires_open_rig = false,
+        RigCommandPriority priority = RigCommandPriority::Interactive)
         : HamLibAsyncWorker(env, hamlib_instance),
           operation_(std::move(operation)),
           execute_(std::move(execute)),
-          resolve_(std::move(resolve)) {}
+          resolve_(std::move(resolve)),
+          requires_open_rig_(requires_open_rig),
+          default_priority_(priority) {}
 
     const char* OperationName() const override { return operation_.c_str(); }
-    bool RequiresOpenRig() const override { return false; }
+    RigCommandPriority DefaultPriority() const override { return default_priority_; }
+    bool RequiresOpenRig() const override { return requires_open_rig_; }
 
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
@@ -745,6 +1144,8 @@ private:
     std::string operation_;
     ExecuteFn execute_;
     ResolveFn resolve_;
+    bool requires_open_rig_;
+    RigCommandPriority default_priority_;
 };
 
 static Napi::Promise QueueLockedCallbackWorker(
@@ -752,8 +1153,12 @@ static Napi::Promise QueueLockedCallbackWorker(
     NodeHamLib* hamlib_instance,
     std::string operation,
     LockedCallbackWorker::ExecuteFn execute,
-    LockedCallbackWorker::ResolveFn resolve) {
-  auto* worker = new LockedCallbackWorker(env, hamlib_instance, std::move(operation), std::move(execute), std::move(resolve));
+    LockedCallbackWorker::ResolveFn resolve,
+    bool requires_open_rig = false,
+    RigCommandPriority priority = RigCommandPriority::Interactive) {
+  auto* worker = new LockedCallbackWorker(
+    env, hamlib_instance, std::move(operation), std::move(execute), std::move(resolve), requires_open_rig,
+    priority);
   worker->Queue();
   return worker->GetPromise();
 }
@@ -835,6 +1240,7 @@ public:
         : HamLibAsyncWorker(env, hamlib_instance) {}
 
     const char* OperationName() const override { return "Open"; }
+    bool InvalidatesStateCache() const override { return true; }
     bool RequiresOpenRig() const override { return false; }
     
     void ExecuteWithRigLock() override {
@@ -845,15 +1251,11 @@ public:
             error_message_ = shim_rigerror(result_code_);
         } else {
             shim_rig_set_freq_callback(hamlib_instance_->my_rig, NodeHamLib::freq_change_cb, hamlib_instance_);
-            auto ppt_cb = +[](void* handle, int vfo, int ptt, void* arg) -> int {
-                (void)handle;
-                (void)vfo;
-                (void)ptt;
-                (void)arg;
-                return 0;
-            };
-            shim_rig_set_ptt_callback(hamlib_instance_->my_rig, ppt_cb, NULL);
-            shim_rig_set_trn(hamlib_instance_->my_rig, SHIM_RIG_TRN_POLL);
+            shim_rig_set_mode_callback(hamlib_instance_->my_rig, NodeHamLib::mode_change_cb, hamlib_instance_);
+            shim_rig_set_ptt_callback(hamlib_instance_->my_rig, NodeHamLib::ptt_change_cb, hamlib_instance_);
+            // Best effort: backends without transceive support just keep polling.
+            shim_rig_set_trn(hamlib_instance_->my_rig, hamlib_instance_->transceive_mode_.load(std::memory_order_acquire));
+            hamlib_instance_->SetCapabilitySnapshot(RigCapabilitySnapshot::Capture(hamlib_instance_->my_rig));
             hamlib_instance_->rig_is_open.store(true, std::memory_order_release);
         }
     }
@@ -880,12 +1282,29 @@ public:
 
     const char* OperationName() const override { return "SetFrequency"; }
     
+    // JS thread. Retargets the write while it has not reached the rig.
+    bool TryReplaceFrequency(double freq) {
+        std::lock_guard<std::mutex> guard(freq_mutex_);
+        if (started_) {
+            return false;
+        }
+        freq_ = freq;
+        return true;
+    }
+
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
+        {
+            std::lock_guard<std::mutex> guard(freq_mutex_);
+            started_ = true;
+        }
         
         result_code_ = shim_rig_set_freq(hamlib_instance_->my_rig, vfo_, freq_);
         if (result_code_ != SHIM_RIG_OK) {
             error_message_ = shim_rigerror(result_code_);
+            hamlib_instance_->state_cache_.Invalidate();
+        } else {
+            hamlib_instance_->state_cache_.StoreFrequency(vfo_, freq_);
         }
     }
     
@@ -904,6 +1323,8 @@ public:
     }
     
 private:
+    std::mutex freq_mutex_;
+    bool started_ = false;
     double freq_;
     int vfo_;
 };
@@ -921,6 +1342,8 @@ public:
         result_code_ = shim_rig_get_freq(hamlib_instance_->my_rig, vfo_, &freq_);
         if (result_code_ != SHIM_RIG_OK) {
             error_message_ = shim_rigerror(result_code_);
+        } else {
+            hamlib_instance_->state_cache_.StoreFrequency(vfo_, freq_);
         }
     }
     
@@ -960,6 +1383,9 @@ public:
         result_code_ = shim_rig_set_mode(hamlib_instance_->my_rig, vfo_, mode_, width_);
         if (result_code_ != SHIM_RIG_OK) {
             error_message_ = shim_rigerror(result_code_);
+            hamlib_instance_->state_cache_.Invalidate();
+        } else {
+            hamlib_instance_->state_cache_.StoreMode(vfo_, mode_, width_);
         }
     }
     
@@ -997,6 +1423,8 @@ public:
         result_code_ = shim_rig_get_mode(hamlib_instance_->my_rig, SHIM_RIG_VFO_CURR, &mode_, &width_);
         if (result_code_ != SHIM_RIG_OK) {
             error_message_ = shim_rigerror(result_code_);
+        } else {
+            hamlib_instance_->state_cache_.StoreMode(SHIM_RIG_VFO_CURR, mode_, width_);
         }
     }
     
@@ -1030,6 +1458,7 @@ public:
         : HamLibAsyncWorker(env, hamlib_instance), ptt_(ptt) {}
 
     const char* OperationName() const override { return "SetPtt"; }
+    RigCommandPriority DefaultPriority() const override { return RigCommandPriority::Realtime; }
     
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
@@ -1064,6 +1493,7 @@ public:
         : HamLibAsyncWorker(env, hamlib_instance), vfo_(vfo), strength_(0) {}
 
     const char* OperationName() const override { return "GetStrength"; }
+    RigCommandPriority DefaultPriority() const override { return RigCommandPriority::Background; }
     
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
@@ -1139,6 +1569,7 @@ public:
         : HamLibAsyncWorker(env, hamlib_instance), level_type_(level_type), vfo_(vfo), value_(0.0) {}
 
     const char* OperationName() const override { return "GetLevel"; }
+    RigCommandPriority DefaultPriority() const override { return RigCommandPriority::Background; }
 
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
@@ -1336,6 +1767,7 @@ public:
         : HamLibAsyncWorker(env, hamlib_instance), channel_num_(channel_num), vfo_(vfo) {}
 
     const char* OperationName() const override { return "SelectMemoryChannel"; }
+    bool InvalidatesStateCache() const override { return true; }
     
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
@@ -1470,6 +1902,72 @@ private:
     shim_memory_range_t range_;
 };
 
+// Reads one memory slot into `channels` (empty slots only with include_empty).
+// A failed read is appended to `errors` and its code returned.
+static int readMemorySlot(hamlib_shim_handle_t rig, int ch, const shim_memory_range_t& range,
+                          bool read_only, bool include_empty,
+                          std::vector<shim_channel_t>* channels,
+                          std::vector<MemoryChannelErrorInfo>* errors) {
+    shim_channel_t chan;
+    memset(&chan, 0, sizeof(chan));
+    chan.channel_num = ch;
+    chan.vfo = SHIM_RIG_VFO_MEM;
+    int get_ret = shim_rig_get_channel(rig, SHIM_RIG_VFO_MEM, &chan, read_only ? 1 : 0);
+    if (get_ret == SHIM_RIG_ENAVAIL) {
+        chan.channel_num = ch;
+        chan.channel_type = range.type;
+        if (include_empty) {
+            channels->push_back(chan);
+        }
+        return SHIM_RIG_OK;
+    }
+    if (get_ret != SHIM_RIG_OK) {
+        errors->push_back({ch, get_ret, shim_rigerror(get_ret)});
+        return get_ret;
+    }
+    if (include_empty || !shimChannelIsEmpty(chan)) {
+        channels->push_back(chan);
+    }
+    return SHIM_RIG_OK;
+}
+
+// Reads the memory layout; false (with the result set) on failure.
+static bool readMemoryRanges(hamlib_shim_handle_t rig, std::vector<shim_memory_range_t>* ranges,
+                             int* result_code, std::string* error_message) {
+    int range_count = shim_rig_get_memory_range_count(rig);
+    if (range_count < 0) {
+        *result_code = range_count;
+        *error_message = shim_rigerror(range_count);
+        return false;
+    }
+    ranges->resize(range_count);
+    for (int i = 0; i < range_count; ++i) {
+        int ret = shim_rig_get_memory_range(rig, i, &(*ranges)[i]);
+        if (ret != SHIM_RIG_OK) {
+            *result_code = ret;
+            *error_message = shim_rigerror(ret);
+            return false;
+        }
+    }
+    return true;
+}
+
+static Napi::Array memoryChannelsToArray(Napi::Env env, const std::vector<shim_channel_t>& channels) {
+    Napi::Array arr = Napi::Array::New(env, channels.size());
+    for (size_t i = 0; i < channels.size(); ++i) {
+        arr[static_cast<uint32_t>(i)] = shimChannelToJsObject(env, channels[i], shimChannelIsEmpty(channels[i]));
+    }
+    return arr;
+}
+
+static Napi::Array memoryErrorsToArray(Napi::Env env, const std::vector<MemoryChannelErrorInfo>& errors) {
+    Napi::Array arr = Napi::Array::New(env, errors.size());
+    for (size_t i = 0; i < errors.size(); ++i) {
+        arr[static_cast<uint32_t>(i)] = memoryErrorToJsObject(env, errors[i]);
+    }
+    return arr;
+}
+
 class MemoryListAsyncWorker : public HamLibAsyncWorker {
 public:
     MemoryListAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance, bool read_only, bool include_empty, bool continue_on_error)
@@ -1479,45 +1977,19 @@ public:
 
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
-        int range_count = shim_rig_get_memory_range_count(hamlib_instance_->my_rig);
-        if (range_count < 0) {
-            result_code_ = range_count;
-            error_message_ = shim_rigerror(result_code_);
+        if (!readMemoryRanges(hamlib_instance_->my_rig, &ranges_, &result_code_, &error_message_)) {
             return;
         }
-        ranges_.resize(range_count);
-        for (int i = 0; i < range_count; ++i) {
-            int ret = shim_rig_get_memory_range(hamlib_instance_->my_rig, i, &ranges_[i]);
-            if (ret != SHIM_RIG_OK) {
-                result_code_ = ret;
-                error_message_ = shim_rigerror(result_code_);
-                return;
-            }
-            for (int ch = ranges_[i].start; ch <= ranges_[i].end; ++ch) {
-                shim_channel_t chan;
-                memset(&chan, 0, sizeof(chan));
-                chan.channel_num = ch;
-                chan.vfo = SHIM_RIG_VFO_MEM;
-                int get_ret = shim_rig_get_channel(hamlib_instance_->my_rig, SHIM_RIG_VFO_MEM, &chan, read_only_ ? 1 : 0);
-                if (get_ret == SHIM_RIG_ENAVAIL) {
-                    chan.channel_num = ch;
-                    chan.channel_type = ranges_[i].type;
-                    if (include_empty_) {
-                        channels_.push_back(chan);
-                    }
-                    continue;
-                }
-                if (get_ret != SHIM_RIG_OK) {
-                    errors_.push_back({ch, get_ret, shim_rigerror(get_ret)});
-                    if (!continue_on_error_) {
-                        result_code_ = get_ret;
-                        error_message_ = shim_rigerror(result_code_);
-                        return;
-                    }
-                    continue;
+        for (const shim_memory_range_t& range : ranges_) {
+            for (int ch = range.start; ch <= range.end; ++ch) {
+                if (CallStopped()) {
+                    return;
                 }
-                if (include_empty_ || !shimChannelIsEmpty(chan)) {
-                    channels_.push_back(chan);
+                int ret = readMemorySlot(hamlib_instance_->my_rig, ch, range, read_only_, include_empty_, &channels_, &errors_);
+                if (ret != SHIM_RIG_OK && !continue_on_error_) {
+                    result_code_ = ret;
+                    error_message_ = shim_rigerror(result_code_);
+                    return;
                 }
             }
         }
@@ -1532,16 +2004,78 @@ public:
         }
         Napi::Object obj = Napi::Object::New(env);
         obj.Set("layout", buildMemoryLayoutObject(env, ranges_));
-        Napi::Array channels = Napi::Array::New(env, channels_.size());
-        for (size_t i = 0; i < channels_.size(); ++i) {
-            channels[static_cast<uint32_t>(i)] = shimChannelToJsObject(env, channels_[i], shimChannelIsEmpty(channels_[i]));
+        obj.Set("channels", memoryChannelsToArray(env, channels_));
+        obj.Set("errors", memoryErrorsToArray(env, errors_));
+        deferred_.Resolve(obj);
+    }
+
+    void OnError(const Napi::Error& e) override {
+        deferred_.Reject(Napi::Error::New(Env(), error_message_).Value());
+    }
+
+private:
+    bool read_only_;
+    bool include_empty_;
+    bool continue_on_error_;
+    std::vector<shim_memory_range_t> ranges_;
+    std::vector<shim_channel_t> channels_;
+    std::vector<MemoryChannelErrorInfo> errors_;
+};
+
+// One slice of a memory scan: up to `chunk_size` slots starting at the first
+// channel >= `cursor`, under a single lock acquisition. Callers queue the next
+// slice from `nextCursor`, so other commands interleave between slices.
+class MemoryListChunkAsyncWorker : public HamLibAsyncWorker {
+public:
+    MemoryListChunkAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance, int cursor, int chunk_size,
+                               bool read_only, bool include_empty, bool continue_on_error)
+        : HamLibAsyncWorker(env, hamlib_instance), cursor_(cursor), chunk_size_(chunk_size),
+          read_only_(read_only), include_empty_(include_empty), continue_on_error_(continue_on_error) {}
+
+    const char* OperationName() const override { return "MemoryListChunk"; }
+
+    void ExecuteWithRigLock() override {
+        CHECK_RIG_VALID();
+        if (!readMemoryRanges(hamlib_instance_->my_rig, &ranges_, &result_code_, &error_message_)) {
+            return;
+        }
+        int slots = 0;
+        for (const shim_memory_range_t& range : ranges_) {
+            for (int ch = std::max(range.start, cursor_); ch <= range.end; ++ch) {
+                if (slots == chunk_size_) {
+                    has_next_ = true;
+                    next_cursor_ = ch;
+                    result_code_ = SHIM_RIG_OK;
+                    return;
+                }
+                if (CallStopped()) {
+                    return;
+                }
+                ++slots;
+                int ret = readMemorySlot(hamlib_instance_->my_rig, ch, range, read_only_, include_empty_, &channels_, &errors_);
+                if (ret != SHIM_RIG_OK && !continue_on_error_) {
+                    result_code_ = ret;
+                    error_message_ = shim_rigerror(result_code_);
+                    return;
+                }
+            }
         }
-        obj.Set("channels", channels);
-        Napi::Array errors = Napi::Array::New(env, errors_.size());
-        for (size_t i = 0; i < errors_.size(); ++i) {
-            errors[static_cast<uint32_t>(i)] = memoryErrorToJsObject(env, errors_[i]);
+        scanned_ = slots;
+        result_code_ = SHIM_RIG_OK;
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        if (result_code_ != SHIM_RIG_OK && !error_message_.empty()) {
+            deferred_.Reject(Napi::Error::New(env, error_message_).Value());
+            return;
         }
-        obj.Set("errors", errors);
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("layout", buildMemoryLayoutObject(env, ranges_));
+        obj.Set("channels", memoryChannelsToArray(env, channels_));
+        obj.Set("errors", memoryErrorsToArray(env, errors_));
+        obj.Set("scanned", Napi::Number::New(env, has_next_ ? chunk_size_ : scanned_));
+        obj.Set("nextCursor", has_next_ ? Napi::Number::New(env, next_cursor_) : env.Null());
         deferred_.Resolve(obj);
     }
 
@@ -1550,25 +2084,117 @@ public:
     }
 
 private:
+    int cursor_;
+    int chunk_size_;
     bool read_only_;
     bool include_empty_;
     bool continue_on_error_;
+    bool has_next_ = false;
+    int next_cursor_ = 0;
+    int scanned_ = 0;
     std::vector<shim_memory_range_t> ranges_;
     std::vector<shim_channel_t> channels_;
     std::vector<MemoryChannelErrorInfo> errors_;
 };
 
+// True when writing `target` over `current` would change nothing the caller
+// asked for. A PASSBAND_NORMAL target width and levels the target omits are
+// not compared, since the read-back values for those are rig-chosen.
+static bool shimChannelMatches(const shim_channel_t& target, const shim_channel_t& current) {
+    const bool target_empty = shimChannelIsEmpty(target);
+    if (target_empty || shimChannelIsEmpty(current)) {
+        return target_empty && shimChannelIsEmpty(current);
+    }
+    if (target.bank_num != current.bank_num || target.ant != current.ant
+        || target.freq != current.freq || target.tx_freq != current.tx_freq
+        || target.mode != current.mode || target.tx_mode != current.tx_mode
+        || target.tx_width != current.tx_width || target.split != current.split
+        || target.tx_vfo != current.tx_vfo || target.rptr_shift != current.rptr_shift
+        || target.rptr_offs != current.rptr_offs || target.tuning_step != current.tuning_step
+        || target.rit != current.rit || target.xit != current.xit
+        || target.funcs != current.funcs
+        || target.ctcss_tone != current.ctcss_tone || target.ctcss_sql != current.ctcss_sql
+        || target.dcs_code != current.dcs_code || target.dcs_sql != current.dcs_sql
+        || target.scan_group != current.scan_group || target.flags != current.flags
+        || strncmp(target.channel_desc, current.channel_desc, sizeof(target.channel_desc)) != 0
+        || strncmp(target.tag, current.tag, sizeof(target.tag)) != 0) {
+        return false;
+    }
+    if (target.width != SHIM_RIG_PASSBAND_NORMAL && target.width != current.width) {
+        return false;
+    }
+    for (int i = 0; i < target.level_count; ++i) {
+        bool found = false;
+        for (int j = 0; j < current.level_count && !found; ++j) {
+            found = current.level_tokens[j] == target.level_tokens[i]
+                && std::fabs(current.level_values[j] - target.level_values[i]) < 1e-6;
+        }
+        if (!found) {
+            return false;
+        }
+    }
+    return true;
+}
+
+enum class MemoryWriteOutcome { Skipped, Written, Cleared };
+
+// Diff-mode write: compares `target` with the baseline image (or a fresh
+// read-only read of the slot) and writes only when they differ.
+static int writeMemoryChannelIfChanged(hamlib_shim_handle_t rig, const shim_channel_t& target,
+                                       const std::map<int, shim_channel_t>& baseline,
+                                       MemoryWriteOutcome* outcome) {
+    shim_channel_t current;
+    auto known = baseline.find(target.channel_num);
+    if (known != baseline.end()) {
+        current = known->second;
+    } else {
+        memset(&current, 0, sizeof(current));
+        current.channel_num = target.channel_num;
+        current.vfo = SHIM_RIG_VFO_MEM;
+        int get_ret = shim_rig_get_channel(rig, SHIM_RIG_VFO_MEM, &current, 1);
+        if (get_ret == SHIM_RIG_ENAVAIL) {
+            memset(&current, 0, sizeof(current));
+        } else if (get_ret != SHIM_RIG_OK) {
+            return get_ret;
+        }
+    }
+    if (shimChannelMatches(target, current)) {
+        *outcome = MemoryWriteOutcome::Skipped;
+        return SHIM_RIG_OK;
+    }
+    int ret = shim_rig_set_channel(rig, SHIM_RIG_VFO_MEM, &target);
+    if (ret == SHIM_RIG_OK) {
+        *outcome = shimChannelIsEmpty(target) ? MemoryWriteOutcome::Cleared : MemoryWriteOutcome::Written;
+    }
+    return ret;
+}
+
+static Napi::Object memoryWriteResultObject(Napi::Env env, int written, int skipped, int cleared,
+                                            const std::vector<MemoryChannelErrorInfo>& errors) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("written", Napi::Number::New(env, written));
+    obj.Set("skipped", Napi::Number::New(env, skipped));
+    obj.Set("cleared", Napi::Number::New(env, cleared));
+    obj.Set("errors", memoryErrorsToArray(env, errors));
+    return obj;
+}
+
 class SetMemoryChannelsAsyncWorker : public HamLibAsyncWorker {
 public:
-    SetMemoryChannelsAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance, std::vector<shim_channel_t> channels, bool continue_on_error)
-        : HamLibAsyncWorker(env, hamlib_instance), channels_(std::move(channels)), continue_on_error_(continue_on_error) {}
+    SetMemoryChannelsAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance, std::vector<shim_channel_t> channels, bool continue_on_error,
+                                 bool diff, std::map<int, shim_channel_t> baseline)
+        : HamLibAsyncWorker(env, hamlib_instance), channels_(std::move(channels)), continue_on_error_(continue_on_error),
+          diff_(diff), baseline_(std::move(baseline)) {}
 
     const char* OperationName() const override { return "SetMemoryChannels"; }
 
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
         for (const auto& chan : channels_) {
-            int ret = shim_rig_set_channel(hamlib_instance_->my_rig, SHIM_RIG_VFO_MEM, &chan);
+            MemoryWriteOutcome outcome = shimChannelIsEmpty(chan) ? MemoryWriteOutcome::Cleared : MemoryWriteOutcome::Written;
+            int ret = diff_
+                ? writeMemoryChannelIfChanged(hamlib_instance_->my_rig, chan, baseline_, &outcome)
+                : shim_rig_set_channel(hamlib_instance_->my_rig, SHIM_RIG_VFO_MEM, &chan);
             if (ret != SHIM_RIG_OK) {
                 errors_.push_back({chan.channel_num, ret, shim_rigerror(ret)});
                 if (!continue_on_error_) {
@@ -1576,8 +2202,11 @@ public:
                     error_message_ = shim_rigerror(ret);
                     return;
                 }
+            } else if (outcome == MemoryWriteOutcome::Skipped) {
+                skipped_++;
             } else {
                 written_++;
+                if (outcome == MemoryWriteOutcome::Cleared) cleared_++;
             }
         }
         result_code_ = SHIM_RIG_OK;
@@ -1589,14 +2218,7 @@ public:
             deferred_.Reject(Napi::Error::New(env, error_message_).Value());
             return;
         }
-        Napi::Object obj = Napi::Object::New(env);
-        obj.Set("written", Napi::Number::New(env, written_));
-        Napi::Array errors = Napi::Array::New(env, errors_.size());
-        for (size_t i = 0; i < errors_.size(); ++i) {
-            errors[static_cast<uint32_t>(i)] = memoryErrorToJsObject(env, errors_[i]);
-        }
-        obj.Set("errors", errors);
-        deferred_.Resolve(obj);
+        deferred_.Resolve(memoryWriteResultObject(env, written_, skipped_, cleared_, errors_));
     }
 
     void OnError(const Napi::Error& e) override {
@@ -1606,14 +2228,20 @@ public:
 private:
     std::vector<shim_channel_t> channels_;
     bool continue_on_error_;
+    bool diff_;
+    std::map<int, shim_channel_t> baseline_;
     int written_ = 0;
+    int skipped_ = 0;
+    int cleared_ = 0;
     std::vector<MemoryChannelErrorInfo> errors_;
 };
 
 class ReplaceMemoryChannelsAsyncWorker : public HamLibAsyncWorker {
 public:
-    ReplaceMemoryChannelsAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance, std::vector<shim_channel_t> channels)
-        : HamLibAsyncWorker(env, hamlib_instance), channels_(std::move(channels)) {}
+    ReplaceMemoryChannelsAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance, std::vector<shim_channel_t> channels,
+                                     bool diff, std::map<int, shim_channel_t> baseline)
+        : HamLibAsyncWorker(env, hamlib_instance), channels_(std::move(channels)),
+          diff_(diff), baseline_(std::move(baseline)) {}
 
     const char* OperationName() const override { return "ReplaceMemoryChannels"; }
 
@@ -1655,12 +2283,32 @@ public:
             error_message_ = "replaceAll requires a channel entry for every memory slot in the rig layout";
             return;
         }
+        if (diff_) {
+            // Slot by slot so unchanged ones are skipped; stops at the first failure
+            // like set_chan_all does.
+            for (const auto& chan : channels_) {
+                MemoryWriteOutcome outcome = MemoryWriteOutcome::Skipped;
+                result_code_ = writeMemoryChannelIfChanged(hamlib_instance_->my_rig, chan, baseline_, &outcome);
+                if (result_code_ != SHIM_RIG_OK) {
+                    error_message_ = shim_rigerror(result_code_);
+                    return;
+                }
+                if (outcome == MemoryWriteOutcome::Skipped) {
+                    skipped_++;
+                } else {
+                    written_++;
+                    if (outcome == MemoryWriteOutcome::Cleared) cleared_++;
+                }
+            }
+            return;
+        }
         result_code_ = shim_rig_set_chan_all(hamlib_instance_->my_rig, SHIM_RIG_VFO_MEM, channels_.data(), static_cast<int>(channels_.size()));
         if (result_code_ != SHIM_RIG_OK) {
             error_message_ = shim_rigerror(result_code_);
             return;
         }
         written_ = static_cast<int>(channels_.size());
+        cleared_ = static_cast<int>(std::count_if(channels_.begin(), channels_.end(), shimChannelIsEmpty));
     }
 
     void OnOK() override {
@@ -1669,10 +2317,7 @@ public:
             deferred_.Reject(Napi::Error::New(env, error_message_).Value());
             return;
         }
-        Napi::Object obj = Napi::Object::New(env);
-        obj.Set("written", Napi::Number::New(env, written_));
-        obj.Set("errors", Napi::Array::New(env));
-        deferred_.Resolve(obj);
+        deferred_.Resolve(memoryWriteResultObject(env, written_, skipped_, cleared_, {}));
     }
 
     void OnError(const Napi::Error& e) override {
@@ -1681,7 +2326,11 @@ public:
 
 private:
     std::vector<shim_channel_t> channels_;
+    bool diff_;
+    std::map<int, shim_channel_t> baseline_;
     int written_ = 0;
+    int skipped_ = 0;
+    int cleared_ = 0;
 };
 
 class SetRitAsyncWorker : public HamLibAsyncWorker {
@@ -2018,6 +2667,9 @@ public:
         result_code_ = shim_rig_set_vfo(hamlib_instance_->my_rig, vfo_);
         if (result_code_ != SHIM_RIG_OK) {
             error_message_ = shim_rigerror(result_code_);
+            hamlib_instance_->state_cache_.Invalidate();
+        } else {
+            hamlib_instance_->state_cache_.StoreVfo(vfo_);
         }
     }
     
@@ -2050,7 +2702,9 @@ public:
         CHECK_RIG_VALID();
         
         result_code_ = shim_rig_get_vfo(hamlib_instance_->my_rig, &vfo_);
-        if (result_code_ != SHIM_RIG_OK) {
+        if (result_code_ == SHIM_RIG_OK) {
+            hamlib_instance_->state_cache_.StoreVfo(vfo_);
+        } else {
             // 提供更清晰的错误信息
             switch (result_code_) {
                 case SHIM_RIG_ENAVAIL:
@@ -2099,6 +2753,7 @@ public:
         : HamLibAsyncWorker(env, hamlib_instance) {}
 
     const char* OperationName() const override { return "Close"; }
+    bool InvalidatesStateCache() const override { return true; }
     bool RequiresOpenRig() const override { return false; }
     
     void ExecuteWithRigLock() override {
@@ -2116,6 +2771,7 @@ public:
             error_message_ = shim_rigerror(result_code_);
         } else {
             hamlib_instance_->rig_is_open.store(false, std::memory_order_release);
+            hamlib_instance_->SetCapabilitySnapshot(nullptr);
         }
     }
     
@@ -2140,6 +2796,7 @@ public:
         : HamLibAsyncWorker(env, hamlib_instance) {}
 
     const char* OperationName() const override { return "Destroy"; }
+    bool InvalidatesStateCache() const override { return true; }
     bool RequiresOpenRig() const override { return false; }
     
     void ExecuteWithRigLock() override {
@@ -2152,6 +2809,7 @@ public:
             error_message_ = shim_rigerror(result_code_);
         } else {
             hamlib_instance_->rig_is_open.store(false, std::memory_order_release);
+            hamlib_instance_->SetCapabilitySnapshot(nullptr);
             hamlib_instance_->my_rig = nullptr;  // 重要：清空指针防止重复释放
         }
     }
@@ -2178,6 +2836,7 @@ public:
         : HamLibAsyncWorker(env, hamlib_instance), intype_(intype), channel_(channel) {}
 
     const char* OperationName() const override { return "StartScan"; }
+    bool InvalidatesStateCache() const override { return true; }
     
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
@@ -2214,6 +2873,7 @@ public:
         : HamLibAsyncWorker(env, hamlib_instance) {}
 
     const char* OperationName() const override { return "StopScan"; }
+    bool InvalidatesStateCache() const override { return true; }
     
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
@@ -2246,6 +2906,7 @@ public:
         : HamLibAsyncWorker(env, hamlib_instance), vfo_op_(vfo_op) {}
 
     const char* OperationName() const override { return "VfoOperation"; }
+    bool InvalidatesStateCache() const override { return true; }
     
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
@@ -3051,6 +3712,7 @@ public:
         : HamLibAsyncWorker(env, hamlib_instance), status_(status) {}
 
     const char* OperationName() const override { return "SetPowerstat"; }
+    bool InvalidatesStateCache() const override { return true; }
     
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
@@ -3414,9 +4076,11 @@ int parseVfoParameter(const Napi::CallbackInfo& info, int index, int defaultVfo
 
 NodeHamLib::NodeHamLib(const Napi::CallbackInfo & info): ObjectWrap(info) {
   Napi::Env env = info.Env();
+  addon_data_ = HamLibAddonData::From(env);
+  if (addon_data_) {
+    addon_data_->AddRig(this);
+  }
   my_rig = nullptr;
-  freq_emit_cb = nullptr;
-  m_currentInfo = nullptr;
   rig_is_open.store(false);
   port_path[0] = '\0';
   if (info.Length() < 1) {
@@ -3468,6 +4132,17 @@ NodeHamLib::NodeHamLib(const Napi::CallbackInfo & info): ObjectWrap(info) {
     // Network connection will be established on open()
   }
 
+  // Instances that name the same device share its mutex in every scope; a
+  // rig without an explicit port opens the backend default device, which in
+  // port scope is keyed per model.
+  const std::string deviceKey = has_port
+    ? normalizeRigDeviceKey(port_path, is_network_rig)
+    : "default:model=" + std::to_string(myrig_model);
+  port_rig_mutex_ = acquireDeviceRigMutex(deviceKey);
+  instance_rig_mutex_ = has_port ? port_rig_mutex_ : std::make_shared<std::timed_mutex>();
+
+  // rig_init() touches Hamlib's process-wide backend registry, so construction
+  // always serializes on the global lock regardless of the lock scope.
   auto rigLock = NodeHamLib::TryAcquireGlobalRigLockIfEnabled(std::chrono::milliseconds(0));
   if (!rigLock.owns_lock() && NodeHamLib::IsGlobalRigLockEnabled()) {
     Napi::Error::New(
@@ -3500,20 +4175,52 @@ NodeHamLib::NodeHamLib(const Napi::CallbackInfo & info): ObjectWrap(info) {
     }
   }
 
-  // this->freq_emit_cb = [info](double freq) {
-  //     Napi::Env env = info.Env();
-  //     Napi::Function emit = info.This().As<Napi::Object>().Get("emit").As<Napi::Function>();
-  //       emit.Call(
-  //       info.This(),
-  //       {Napi::String::New(env, "frequency_change"), Napi::Number::New(env, freq)});
-  //   } 
+  if (readCommandThreadDefault()) {
+    command_executor_ = RigCommandExecutor::Create(env, kDefaultCommandQueueCapacity);
+  }
+  if (const size_t traceCapacity = readTraceDefault()) {
+    trace_ = std::make_shared<RigTraceRing>(traceCapacity);
+    trace_enabled_ = true;
+  }
 
   rig_is_open.store(false, std::memory_order_release);
 }
 
 // 析构函数 - 确保资源正确清理
 NodeHamLib::~NodeHamLib() {
-  auto rigLock = NodeHamLib::TryAcquireGlobalRigLockIfEnabled(std::chrono::milliseconds(0));
+  if (addon_data_) {
+    addon_data_->RemoveRig(this);
+  }
+  ShutdownNative();
+}
+
+constexpr std::chrono::milliseconds kShutdownLockSlice(100);
+
+void NodeHamLib::ShutdownNative() {
+  session_client_.reset();
+  stopRigTracker(tracker_);
+  stopRigRawStream(raw_stream_);
+  stopRigSweep(sweep_);
+  stopRigPollScheduler(poll_scheduler_);
+  StopTransceiveEventsInternal();
+  if (command_executor_) {
+    // Joins the command thread; workers still queued on it are abandoned
+    // rather than run against a rig that is about to be cleaned up.
+    command_executor_->Shutdown();
+    command_executor_.reset();
+  }
+  // Another rig's command may hold a shared lock; wait for it in slices, up
+  // to the usual lock timeout, instead of leaving this rig open.
+  RigLockScopeUse scopeUse;
+  GlobalRigLock rigLock;
+  const auto lockDeadline = std::chrono::steady_clock::now()
+    + std::chrono::milliseconds(readGlobalRigLockTimeoutMs());
+  while (NodeHamLib::IsGlobalRigLockEnabled()) {
+    rigLock = TryAcquireRigLockIfEnabled(kShutdownLockSlice, nullptr, RigCommandPriority::Realtime);
+    if (rigLock.owns_lock() || std::chrono::steady_clock::now() >= lockDeadline) {
+      break;
+    }
+  }
   if (!rigLock.owns_lock() && NodeHamLib::IsGlobalRigLockEnabled()) {
     return;
   }
@@ -3521,6 +4228,9 @@ NodeHamLib::~NodeHamLib() {
 
   // 如果rig指针存在，执行清理
   if (my_rig) {
+    shim_rig_set_freq_callback(my_rig, nullptr, nullptr);
+    shim_rig_set_mode_callback(my_rig, nullptr, nullptr);
+    shim_rig_set_ptt_callback(my_rig, nullptr, nullptr);
     // 如果rig是打开状态，先关闭
     if (rig_is_open.load(std::memory_order_acquire)) {
       shim_rig_close(my_rig);
@@ -3542,68 +4252,314 @@ int NodeHamLib::spectrum_line_cb(void* handle, const shim_spectrum_line_t* line,
   return 0;
 }
 
-void NodeHamLib::EmitSpectrumLine(const shim_spectrum_line_t& line) {
-  if (!spectrum_tsfn_) {
-    return;
-  }
+struct SpectrumSlotHint {
+  std::shared_ptr<SpectrumLineRing> ring;
+  SpectrumLineSlot* slot;
+};
 
-  auto* line_copy = new shim_spectrum_line_t(line);
-  napi_status status = spectrum_tsfn_.BlockingCall(
-    line_copy,
-    [](Napi::Env env, Napi::Function callback, shim_spectrum_line_t* data) {
-      Napi::Object lineObject = Napi::Object::New(env);
-      lineObject.Set("scopeId", Napi::Number::New(env, data->id));
-      lineObject.Set("dataLevelMin", Napi::Number::New(env, data->data_level_min));
-      lineObject.Set("dataLevelMax", Napi::Number::New(env, data->data_level_max));
-      lineObject.Set("signalStrengthMin", Napi::Number::New(env, data->signal_strength_min));
-      lineObject.Set("signalStrengthMax", Napi::Number::New(env, data->signal_strength_max));
-      lineObject.Set("mode", Napi::Number::New(env, data->spectrum_mode));
-      lineObject.Set("centerFreq", Napi::Number::New(env, data->center_freq));
-      lineObject.Set("spanHz", Napi::Number::New(env, data->span_freq));
-      lineObject.Set("lowEdgeFreq", Napi::Number::New(env, data->low_edge_freq));
-      lineObject.Set("highEdgeFreq", Napi::Number::New(env, data->high_edge_freq));
-      lineObject.Set("dataLength", Napi::Number::New(env, data->data_length));
-      lineObject.Set("timestamp", Napi::Number::New(env, static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count())));
-      lineObject.Set("data", Napi::Buffer<unsigned char>::Copy(env, data->data, static_cast<size_t>(data->data_length)));
-      callback.Call({ lineObject });
-      delete data;
-    });
+static std::atomic<bool> spectrumExternalBuffersAllowed{true};
+
+// Lends the slot's payload to JS without copying; the slot returns to the ring
+// when the Buffer is collected. Falls back to a copy where the runtime forbids
+// external buffers (e.g. V8 sandbox builds).
+static Napi::Value spectrumLineData(Napi::Env env, const std::shared_ptr<SpectrumLineRing>& ring, SpectrumLineSlot* slot) {
+  const size_t length = static_cast<size_t>(slot->line.data_length);
+#ifndef NODE_API_NO_EXTERNAL_BUFFERS_ALLOWED
+  if (length > 0 && spectrumExternalBuffersAllowed.load(std::memory_order_relaxed)) {
+    auto* hint = new SpectrumSlotHint{ring, slot};
+    Napi::Buffer<unsigned char> buffer = Napi::Buffer<unsigned char>::New(
+      env, slot->line.data, length,
+      [](Napi::Env, unsigned char*, SpectrumSlotHint* data) {
+        data->ring->Release(data->slot);
+        delete data;
+      },
+      hint);
+    if (!env.IsExceptionPending()) {
+      return buffer;
+    }
+    env.GetAndClearPendingException();
+    delete hint;
+    spectrumExternalBuffersAllowed.store(false, std::memory_order_relaxed);
+  }
+#endif
+  Napi::Buffer<unsigned char> copy = Napi::Buffer<unsigned char>::Copy(env, slot->line.data, length);
+  ring->Release(slot);
+  return copy;
+}
+
+static void deliverSpectrumLines(Napi::Env env, Napi::Function callback, const std::shared_ptr<SpectrumLineRing>& ring) {
+  std::vector<SpectrumLineSlot*> slots = ring->TakePending();
+  for (SpectrumLineSlot* slot : slots) {
+    Napi::HandleScope scope(env);
+    const shim_spectrum_line_t& line = slot->line;
+    Napi::Object lineObject = Napi::Object::New(env);
+    lineObject.Set("scopeId", Napi::Number::New(env, line.id));
+    lineObject.Set("dataLevelMin", Napi::Number::New(env, line.data_level_min));
+    lineObject.Set("dataLevelMax", Napi::Number::New(env, line.data_level_max));
+    lineObject.Set("signalStrengthMin", Napi::Number::New(env, line.signal_strength_min));
+    lineObject.Set("signalStrengthMax", Napi::Number::New(env, line.signal_strength_max));
+    lineObject.Set("mode", Napi::Number::New(env, line.spectrum_mode));
+    lineObject.Set("centerFreq", Napi::Number::New(env, line.center_freq));
+    lineObject.Set("spanHz", Napi::Number::New(env, line.span_freq));
+    lineObject.Set("lowEdgeFreq", Napi::Number::New(env, line.low_edge_freq));
+    lineObject.Set("highEdgeFreq", Napi::Number::New(env, line.high_edge_freq));
+    lineObject.Set("dataLength", Napi::Number::New(env, line.data_length));
+    lineObject.Set("timestamp", Napi::Number::New(env, slot->timestamp));
+    // Must be last: the slot may be recycled as soon as it is handed over.
+    lineObject.Set("data", spectrumLineData(env, ring, slot));
+    callback.Call({ lineObject });
+  }
+}
+
+// Per-line metadata layout of a batched spectrum frame (Float64Array `meta`,
+// kSpectrumFrameStride values per line). Must match SPECTRUM_FRAME_FIELDS in
+// lib/spectrum.js.
+enum SpectrumFrameField : size_t {
+  kFrameScopeId = 0,
+  kFrameMode,
+  kFrameCenterFreq,
+  kFrameSpanHz,
+  kFrameLowEdgeFreq,
+  kFrameHighEdgeFreq,
+  kFrameTimestamp,
+  kFrameDataOffset,
+  kFrameDataLength,
+  kFrameDataLevelMin,
+  kFrameDataLevelMax,
+  kFrameSignalStrengthMin,
+  kFrameSignalStrengthMax,
+  kSpectrumFrameStride,
+};
 
-  if (status != napi_ok) {
-    delete line_copy;
+// Packs up to batchLines lines per callback: one contiguous Uint8Array with
+// every payload plus one Float64Array of metadata, so JS pays a single call
+// and two allocations per batch instead of one object per line.
+static void deliverSpectrumFrames(Napi::Env env, Napi::Function callback, const std::shared_ptr<SpectrumLineRing>& ring) {
+  std::vector<SpectrumLineSlot*> slots = ring->TakePending();
+  const size_t batch = ring->BatchLines();
+  for (size_t start = 0; start < slots.size(); start += batch) {
+    Napi::HandleScope scope(env);
+    const size_t count = std::min(batch, slots.size() - start);
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+      total += static_cast<size_t>(slots[start + i]->line.data_length);
+    }
+
+    Napi::ArrayBuffer payload = Napi::ArrayBuffer::New(env, total);
+    Napi::Float64Array meta = Napi::Float64Array::New(env, count * kSpectrumFrameStride);
+    uint8_t* out = static_cast<uint8_t*>(payload.Data());
+    double* fields = meta.Data();
+    size_t offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+      SpectrumLineSlot* slot = slots[start + i];
+      const shim_spectrum_line_t& line = slot->line;
+      const size_t length = static_cast<size_t>(line.data_length);
+      double* row = fields + i * kSpectrumFrameStride;
+      row[kFrameScopeId] = line.id;
+      row[kFrameMode] = line.spectrum_mode;
+      row[kFrameCenterFreq] = line.center_freq;
+      row[kFrameSpanHz] = line.span_freq;
+      row[kFrameLowEdgeFreq] = line.low_edge_freq;
+      row[kFrameHighEdgeFreq] = line.high_edge_freq;
+      row[kFrameTimestamp] = slot->timestamp;
+      row[kFrameDataOffset] = static_cast<double>(offset);
+      row[kFrameDataLength] = static_cast<double>(length);
+      row[kFrameDataLevelMin] = line.data_level_min;
+      row[kFrameDataLevelMax] = line.data_level_max;
+      row[kFrameSignalStrengthMin] = line.signal_strength_min;
+      row[kFrameSignalStrengthMax] = line.signal_strength_max;
+      if (length > 0) {
+        std::memcpy(out + offset, line.data, length);
+      }
+      offset += length;
+      ring->Release(slot);
+    }
+
+    Napi::Object frame = Napi::Object::New(env);
+    frame.Set("lines", Napi::Number::New(env, static_cast<double>(count)));
+    frame.Set("stride", Napi::Number::New(env, static_cast<double>(kSpectrumFrameStride)));
+    frame.Set("data", Napi::Uint8Array::New(env, total, payload, 0));
+    frame.Set("meta", meta);
+    callback.Call({ frame });
+  }
+}
+
+static void deliverSpectrum(Napi::Env env, Napi::Function callback, const std::shared_ptr<SpectrumLineRing>& ring) {
+  if (ring->BatchLines() > 1) {
+    deliverSpectrumFrames(env, callback, ring);
+  } else {
+    deliverSpectrumLines(env, callback, ring);
+  }
+}
+
+// Runs on Hamlib's async reader thread: copy into a ring slot and never wait
+// for the JS thread. Lines that arrive while a flush is queued ride along
+// with it.
+bool NodeHamLib::EmitSpectrumLine(const shim_spectrum_line_t& line, bool record) {
+  std::lock_guard<std::mutex> lock(spectrum_mutex_);
+  if (!spectrum_tsfn_ || !spectrum_ring_) {
+    return false;
+  }
+
+  const double timestamp = static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count());
+  const shim_spectrum_line_t& queued = spectrum_processor_ ? spectrum_processor_->Process(line) : line;
+  if (spectrum_recorder_ && record) {
+    spectrum_recorder_->Append(queued, timestamp);
+  }
+  if (!spectrum_ring_->Push(queued, timestamp)) {
+    return true;
+  }
+  ScheduleSpectrumFlushLocked();
+  return true;
+}
+
+// Runs on the ring's latency timer thread once a partial batch has waited
+// maxLatencyMs.
+void NodeHamLib::FlushPartialSpectrumBatch() {
+  std::lock_guard<std::mutex> lock(spectrum_mutex_);
+  if (!spectrum_ring_) {
+    return;
+  }
+  if (!spectrum_tsfn_) {
+    spectrum_ring_->CancelFlush();
     return;
   }
+  ScheduleSpectrumFlushLocked();
+}
+
+void NodeHamLib::ScheduleSpectrumFlushLocked() {
+  std::shared_ptr<SpectrumLineRing> ring = spectrum_ring_;
+  napi_status status = spectrum_tsfn_.NonBlockingCall([ring](Napi::Env env, Napi::Function callback) {
+    deliverSpectrum(env, callback, ring);
+  });
+  if (status != napi_ok) {
+    ring->CancelFlush();
+  }
 }
 
 void NodeHamLib::StopSpectrumStreamInternal() {
-  std::lock_guard<std::mutex> lock(spectrum_mutex_);
-  if (spectrum_stream_running_ && my_rig) {
-    shim_rig_set_spectrum_callback(my_rig, nullptr, nullptr);
+  std::shared_ptr<SpectrumLineRing> ring;
+  {
+    std::lock_guard<std::mutex> lock(spectrum_mutex_);
+    if (spectrum_stream_running_ && my_rig) {
+      shim_rig_set_spectrum_callback(my_rig, nullptr, nullptr);
+    }
+    spectrum_stream_running_ = false;
+    if (spectrum_tsfn_) {
+      spectrum_tsfn_.Release();
+      spectrum_tsfn_ = Napi::ThreadSafeFunction();
+    }
+    ring = spectrum_ring_;
   }
-  spectrum_stream_running_ = false;
-  if (spectrum_tsfn_) {
-    spectrum_tsfn_.Release();
-    spectrum_tsfn_ = Napi::ThreadSafeFunction();
+  // Outside spectrum_mutex_: the timer thread takes it to schedule a flush.
+  if (ring) {
+    ring->StopLatencyTimer();
   }
 }
 
+static double transceiveTimestampMs() {
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
 int NodeHamLib::freq_change_cb(void *handle, int vfo, double freq, void* arg) {
-      (void)handle;
-      (void)vfo;
-      (void)freq;
-      auto instance = static_cast<NodeHamLib*>(arg);
-      if (!instance) {
-        return 0;
+  (void)handle;
+  auto instance = static_cast<NodeHamLib*>(arg);
+  if (!instance) {
+    return 0;
+  }
+  RigTransceiveEvent event;
+  event.kind = RigTransceiveEvent::Kind::Frequency;
+  event.vfo = vfo;
+  event.frequency = freq;
+  event.timestamp = transceiveTimestampMs();
+  instance->EmitTransceiveEvent(event);
+  return 0;
+}
+
+int NodeHamLib::mode_change_cb(void *handle, int vfo, int mode, int width, void* arg) {
+  (void)handle;
+  auto instance = static_cast<NodeHamLib*>(arg);
+  if (!instance) {
+    return 0;
+  }
+  RigTransceiveEvent event;
+  event.kind = RigTransceiveEvent::Kind::Mode;
+  event.vfo = vfo;
+  event.mode = mode;
+  event.width = width;
+  event.timestamp = transceiveTimestampMs();
+  instance->EmitTransceiveEvent(event);
+  return 0;
+}
+
+int NodeHamLib::ptt_change_cb(void *handle, int vfo, int ptt, void* arg) {
+  (void)handle;
+  auto instance = static_cast<NodeHamLib*>(arg);
+  if (!instance) {
+    return 0;
+  }
+  RigTransceiveEvent event;
+  event.kind = RigTransceiveEvent::Kind::Ptt;
+  event.vfo = vfo;
+  event.ptt = ptt;
+  event.timestamp = transceiveTimestampMs();
+  instance->EmitTransceiveEvent(event);
+  return 0;
+}
+
+// Runs on Hamlib's async/transceive thread (or inside a command that read an
+// unsolicited frame), so it must never wait on the JS thread.
+void NodeHamLib::EmitTransceiveEvent(const RigTransceiveEvent& event) {
+  if (event.kind == RigTransceiveEvent::Kind::Frequency) {
+    state_cache_.StoreFrequency(event.vfo, event.frequency);
+  } else if (event.kind == RigTransceiveEvent::Kind::Mode) {
+    state_cache_.StoreMode(event.vfo, event.mode, event.width);
+  }
+
+  std::lock_guard<std::mutex> lock(transceive_mutex_);
+  if (!transceive_tsfn_) {
+    return;
+  }
+
+  auto* event_copy = new RigTransceiveEvent(event);
+  napi_status status = transceive_tsfn_.NonBlockingCall(
+    event_copy,
+    [](Napi::Env env, Napi::Function callback, RigTransceiveEvent* data) {
+      Napi::Object payload = Napi::Object::New(env);
+      payload.Set("vfo", Napi::String::New(env, publicVfoToken(data->vfo)));
+      const char* name = "frequency_change";
+      switch (data->kind) {
+        case RigTransceiveEvent::Kind::Frequency:
+          payload.Set("frequency", Napi::Number::New(env, data->frequency));
+          break;
+        case RigTransceiveEvent::Kind::Mode:
+          name = "mode_change";
+          payload.Set("mode", Napi::String::New(env, shim_rig_strrmode(data->mode)));
+          payload.Set("bandwidth", Napi::Number::New(env, data->width));
+          break;
+        case RigTransceiveEvent::Kind::Ptt:
+          name = "ptt_change";
+          payload.Set("ptt", Napi::Boolean::New(env, data->ptt == SHIM_RIG_PTT_ON));
+          break;
       }
-      //Napi::Function emit = instance->m_currentInfo[0].Get("emit").As<Napi::Function>();
-			// Napi::Function emit = instance->m_currentInfo[0]->This().As<Napi::Object>().Get("emit").As<Napi::Function>();
-      //emit.Call(instance->m_currentInfo->This(), { Napi::String::New(env, "frequency_change"), Napi::Number::New(env, freq) });
-        //this->freq_emit_cb(freq);
-        //Napi::Function emit = this.As<Napi::Object>().Get("emit").As<Napi::Function>();
-        //auto fn = global.Get("process").As<Napi::Object>().Get("emit").As<Napi::Function>();
-        //fn.Call({Napi::Number::New(env, freq)});
-        return 0;
+      payload.Set("timestamp", Napi::Number::New(env, data->timestamp));
+      delete data;
+      callback.Call({ Napi::String::New(env, name), payload });
+    });
+
+  if (status != napi_ok) {
+    delete event_copy;
+  }
+}
+
+void NodeHamLib::StopTransceiveEventsInternal() {
+  std::lock_guard<std::mutex> lock(transceive_mutex_);
+  if (transceive_tsfn_) {
+    transceive_tsfn_.Release();
+    transceive_tsfn_ = Napi::ThreadSafeFunction();
+  }
 }
 
 Napi::Value NodeHamLib::Open(const Napi::CallbackInfo & info) {
@@ -3615,6 +4571,11 @@ Napi::Value NodeHamLib::Open(const Napi::CallbackInfo & info) {
   return worker->GetPromise();
 }
 
+// Identity of a coalescable request: operation, VFO and level/func token.
+static std::string coalesceKey(const char* operation, int vfo, uint64_t token = 0) {
+  return std::string(operation) + '|' + std::to_string(vfo) + '|' + std::to_string(token);
+}
+
 Napi::Value NodeHamLib::SetVFO(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
 
@@ -3672,7 +4633,24 @@ Napi::Value NodeHamLib::SetFrequency(const Napi::CallbackInfo & info) {
     RETURN_NULL_IF_INVALID_VFO(vfo);
   }
   
+  const std::string writeKey = coalesceKey("SetFrequency", vfo);
+  // A scoped call may be dropped, so it neither merges into nor takes writes.
+  const bool coalesce = coalesce_writes_ && call_scopes_.empty();
+  if (coalesce) {
+    auto pending = pending_writes_.find(writeKey);
+    if (pending != pending_writes_.end()
+        && static_cast<SetFrequencyAsyncWorker*>(pending->second)->TryReplaceFrequency(freq)) {
+      ++coalesced_writes_;
+      // Reads issued from now on must observe the new value.
+      inflight_reads_.clear();
+      return pending->second->AddFollower(env);
+    }
+  }
+
   SetFrequencyAsyncWorker* worker = new SetFrequencyAsyncWorker(env, this, freq, vfo);
+  if (coalesce) {
+    worker->SetCoalesceKey(writeKey, true);
+  }
   worker->Queue();
   
   return worker->GetPromise();
@@ -3767,42 +4745,191 @@ Napi::Value NodeHamLib::SetPtt(const Napi::CallbackInfo & info) {
   return worker->GetPromise();
 }
 
+Napi::Value NodeHamLib::QueueCoalescedRead(Napi::Env env, const std::string& key,
+                                           const std::function<HamLibAsyncWorker*()>& create) {
+  // Followers share the leader's outcome, so scoped reads stay on their own.
+  const bool coalesce = coalesce_reads_ && call_scopes_.empty();
+  if (coalesce) {
+    auto inflight = inflight_reads_.find(key);
+    if (inflight != inflight_reads_.end()) {
+      ++coalesced_reads_;
+      return inflight->second->AddFollower(env);
+    }
+  }
+  HamLibAsyncWorker* worker = create();
+  if (coalesce) {
+    worker->SetCoalesceKey(key, false);
+  }
+  worker->Queue();
+  return worker->GetPromise();
+}
+
+void NodeHamLib::NoteCommandQueued(HamLibAsyncWorker* worker, const std::string& key, bool write) {
+  if (key.empty()) {
+    inflight_reads_.clear();
+    pending_writes_.clear();
+  } else if (!write) {
+    inflight_reads_[key] = worker;
+  } else {
+    inflight_reads_.clear();
+    pending_writes_[key] = worker;
+  }
+}
+
+// Reads `{ maxAgeMs }` of a cached getter; *max_age_ms stays -1 (the cache
+// default) when absent. Returns false with a pending exception when invalid.
+static bool readStateCacheMaxAge(Napi::Env env, const Napi::Value& value, int64_t* max_age_ms) {
+  *max_age_ms = -1;
+  if (value.IsUndefined() || value.IsNull()) {
+    return true;
+  }
+  if (!value.IsObject()) {
+    Napi::TypeError::New(env, "Options must be an object").ThrowAsJavaScriptException();
+    return false;
+  }
+  Napi::Object options = value.As<Napi::Object>();
+  if (!options.Has("maxAgeMs") || options.Get("maxAgeMs").IsUndefined()) {
+    return true;
+  }
+  if (!options.Get("maxAgeMs").IsNumber()) {
+    Napi::TypeError::New(env, "maxAgeMs must be a number").ThrowAsJavaScriptException();
+    return false;
+  }
+  const double requested = options.Get("maxAgeMs").As<Napi::Number>().DoubleValue();
+  if (!(requested >= 0 && requested <= 86400000)) {
+    Napi::RangeError::New(env, "maxAgeMs must be between 0 and 86400000").ThrowAsJavaScriptException();
+    return false;
+  }
+  *max_age_ms = static_cast<int64_t>(requested);
+  return true;
+}
+
+static Napi::Value resolvedPromise(Napi::Env env, Napi::Value value) {
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+  deferred.Resolve(value);
+  return deferred.Promise();
+}
+
 Napi::Value NodeHamLib::GetVFO(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
+
+  int64_t maxAgeMs = -1;
+  if (info.Length() >= 1 && !readStateCacheMaxAge(env, info[0], &maxAgeMs)) {
+    return env.Null();
+  }
+  int cachedVfo = 0;
+  if (state_cache_.LookupVfo(maxAgeMs, &cachedVfo)) {
+    return resolvedPromise(env, Napi::String::New(env, publicVfoToken(cachedVfo)));
+  }
   
-  
-  GetVfoAsyncWorker* worker = new GetVfoAsyncWorker(env, this);
-  worker->Queue();
-  
-  return worker->GetPromise();
+  return QueueCoalescedRead(env, coalesceKey("GetVfo", SHIM_RIG_VFO_CURR), [&]() -> HamLibAsyncWorker* {
+    return new GetVfoAsyncWorker(env, this);
+  });
+}
+
+// (vfo?, { maxAgeMs }?) or ({ maxAgeMs }); false after throwing.
+static bool readGetFrequencyArgs(const Napi::CallbackInfo& info, int* vfo, int64_t* maxAgeMs) {
+  Napi::Env env = info.Env();
+  *vfo = SHIM_RIG_VFO_CURR;
+  size_t optionsIndex = 1;
+  if (info.Length() >= 1 && info[0].IsObject()) {
+    optionsIndex = 0;
+  } else if (info.Length() >= 1) {
+    *vfo = parseVfoParameter(info, 0, SHIM_RIG_VFO_CURR);
+    if (*vfo == kInvalidVfoParameter) {
+      return false;
+    }
+  }
+  *maxAgeMs = -1;
+  return info.Length() <= optionsIndex || readStateCacheMaxAge(env, info[optionsIndex], maxAgeMs);
+}
+
+static Napi::Object modeResultObject(Napi::Env env, int mode, int width) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("mode", Napi::String::New(env, shim_rig_strrmode(mode)));
+  obj.Set("bandwidth", Napi::Number::New(env, width));
+  return obj;
 }
 
 Napi::Value NodeHamLib::GetFrequency(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
   
   
-  // Support optional VFO parameter
+  // Support optional VFO parameter and { maxAgeMs } cache options
   int vfo = SHIM_RIG_VFO_CURR;
-  
-  if (info.Length() >= 1) {
-    vfo = parseVfoParameter(info, 0, SHIM_RIG_VFO_CURR);
-    RETURN_NULL_IF_INVALID_VFO(vfo);
+  int64_t maxAgeMs = -1;
+  if (!readGetFrequencyArgs(info, &vfo, &maxAgeMs)) {
+    return env.Null();
+  }
+  double cachedFrequency = 0;
+  if (state_cache_.LookupFrequency(vfo, maxAgeMs, &cachedFrequency)) {
+    return resolvedPromise(env, Napi::Number::New(env, cachedFrequency));
   }
   
-  GetFrequencyAsyncWorker* worker = new GetFrequencyAsyncWorker(env, this, vfo);
-  worker->Queue();
-  
-  return worker->GetPromise();
+  return QueueCoalescedRead(env, coalesceKey("GetFrequency", vfo), [&]() -> HamLibAsyncWorker* {
+    return new GetFrequencyAsyncWorker(env, this, vfo);
+  });
 }
 
 Napi::Value NodeHamLib::GetMode(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
+
+  int64_t maxAgeMs = -1;
+  if (info.Length() >= 1 && !readStateCacheMaxAge(env, info[0], &maxAgeMs)) {
+    return env.Null();
+  }
+  int cachedMode = 0;
+  int cachedWidth = 0;
+  if (state_cache_.LookupMode(SHIM_RIG_VFO_CURR, maxAgeMs, &cachedMode, &cachedWidth)) {
+    return resolvedPromise(env, modeResultObject(env, cachedMode, cachedWidth));
+  }
   
-  
-  GetModeAsyncWorker* worker = new GetModeAsyncWorker(env, this);
-  worker->Queue();
-  
-  return worker->GetPromise();
+  return QueueCoalescedRead(env, coalesceKey("GetMode", SHIM_RIG_VFO_CURR), [&]() -> HamLibAsyncWorker* {
+    return new GetModeAsyncWorker(env, this);
+  });
+}
+
+// State cache only: the cached value, or null when there is none within
+// maxAgeMs (including while the cache is disabled).
+Napi::Value NodeHamLib::GetFrequencySync(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  int vfo = SHIM_RIG_VFO_CURR;
+  int64_t maxAgeMs = -1;
+  if (!readGetFrequencyArgs(info, &vfo, &maxAgeMs)) {
+    return env.Null();
+  }
+  double cachedFrequency = 0;
+  if (!state_cache_.LookupFrequency(vfo, maxAgeMs, &cachedFrequency)) {
+    return env.Null();
+  }
+  return Napi::Number::New(env, cachedFrequency);
+}
+
+Napi::Value NodeHamLib::GetModeSync(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  int64_t maxAgeMs = -1;
+  if (info.Length() >= 1 && !readStateCacheMaxAge(env, info[0], &maxAgeMs)) {
+    return env.Null();
+  }
+  int cachedMode = 0;
+  int cachedWidth = 0;
+  if (!state_cache_.LookupMode(SHIM_RIG_VFO_CURR, maxAgeMs, &cachedMode, &cachedWidth)) {
+    return env.Null();
+  }
+  return modeResultObject(env, cachedMode, cachedWidth);
+}
+
+Napi::Value NodeHamLib::GetVfoSync(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  int64_t maxAgeMs = -1;
+  if (info.Length() >= 1 && !readStateCacheMaxAge(env, info[0], &maxAgeMs)) {
+    return env.Null();
+  }
+  int cachedVfo = 0;
+  if (!state_cache_.LookupVfo(maxAgeMs, &cachedVfo)) {
+    return env.Null();
+  }
+  return Napi::String::New(env, publicVfoToken(cachedVfo));
 }
 
 Napi::Value NodeHamLib::GetStrength(const Napi::CallbackInfo & info) {
@@ -3817,15 +4944,15 @@ Napi::Value NodeHamLib::GetStrength(const Napi::CallbackInfo & info) {
     RETURN_NULL_IF_INVALID_VFO(vfo);
   }
   
-  GetStrengthAsyncWorker* worker = new GetStrengthAsyncWorker(env, this, vfo);
-  worker->Queue();
-  
-  return worker->GetPromise();
+  return QueueCoalescedRead(env, coalesceKey("GetStrength", vfo), [&]() -> HamLibAsyncWorker* {
+    return new GetStrengthAsyncWorker(env, this, vfo);
+  });
 }
 
 Napi::Value NodeHamLib::Close(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  
+  // Polls would otherwise keep reading a closed rig.
+  stopRigPollScheduler(poll_scheduler_);
 
   CloseAsyncWorker* worker = new CloseAsyncWorker(env, this);
   worker->Queue();
@@ -3835,6 +4962,7 @@ Napi::Value NodeHamLib::Close(const Napi::CallbackInfo & info) {
 
 Napi::Value NodeHamLib::Destroy(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
+  stopRigPollScheduler(poll_scheduler_);
 
   DestroyAsyncWorker* worker = new DestroyAsyncWorker(env, this);
   worker->Queue();
@@ -3860,927 +4988,2892 @@ Napi::Value NodeHamLib::GetConnectionInfo(const Napi::CallbackInfo & info) {
   return obj;
 }
 
-// Memory Channel Management
-Napi::Value NodeHamLib::SetMemoryChannel(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::EnableCommandThread(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  
-  
-  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsObject()) {
-    Napi::TypeError::New(env, "Expected (channelNumber: number, channelData: object)").ThrowAsJavaScriptException();
-    return env.Null();
+
+  size_t queueCapacity = kDefaultCommandQueueCapacity;
+  if (info.Length() >= 1 && info[0].IsObject()) {
+    Napi::Object options = info[0].As<Napi::Object>();
+    if (options.Has("queueCapacity") && !options.Get("queueCapacity").IsUndefined()) {
+      if (!options.Get("queueCapacity").IsNumber()) {
+        Napi::TypeError::New(env, "queueCapacity must be a number").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      const double requested = options.Get("queueCapacity").As<Napi::Number>().DoubleValue();
+      if (!(requested >= 1 && requested <= 65536)) {
+        Napi::RangeError::New(env, "queueCapacity must be between 1 and 65536").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      queueCapacity = static_cast<size_t>(requested);
+    }
+  } else if (info.Length() >= 1 && !info[0].IsUndefined()) {
+    Napi::TypeError::New(env, "Expected (options?: { queueCapacity?: number })").ThrowAsJavaScriptException();
+    return env.Undefined();
   }
-  
-  int channel_num = info[0].As<Napi::Number>().Int32Value();
-  Napi::Object chanObj = info[1].As<Napi::Object>();
 
-  shim_channel_t chan;
-  if (!jsObjectToShimChannel(env, chanObj, &chan, channel_num)) {
-    return env.Null();
+  if (command_executor_) {
+    return env.Undefined();
   }
-  
-  SetMemoryChannelAsyncWorker* worker = new SetMemoryChannelAsyncWorker(env, this, chan);
-  worker->Queue();
-  
-  return worker->GetPromise();
+  command_executor_ = RigCommandExecutor::Create(env, queueCapacity);
+  return env.Undefined();
 }
 
-Napi::Value NodeHamLib::GetMemoryChannel(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::DisableCommandThread(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  
-  
-  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsBoolean()) {
-    Napi::TypeError::New(env, "Expected (channelNumber: number, readOnly: boolean)").ThrowAsJavaScriptException();
-    return env.Null();
+  // Already-queued commands still run and settle; new calls use the threadpool.
+  if (command_executor_) {
+    command_executor_->Stop();
+    command_executor_.reset();
   }
-  
-  int channel_num = info[0].As<Napi::Number>().Int32Value();
-  bool read_only = info[1].As<Napi::Boolean>().Value();
-  
-  GetMemoryChannelAsyncWorker* worker = new GetMemoryChannelAsyncWorker(env, this, channel_num, read_only);
-  worker->Queue();
-  
-  return worker->GetPromise();
+  return env.Undefined();
 }
 
-Napi::Value NodeHamLib::SelectMemoryChannel(const Napi::CallbackInfo & info) {
-  Napi::Env env = info.Env();
-  
-  
-  if (info.Length() < 1 || !info[0].IsNumber()) {
-    Napi::TypeError::New(env, "Expected (channelNumber: number)").ThrowAsJavaScriptException();
-    return env.Null();
-  }
-  
-  int channel_num = info[0].As<Napi::Number>().Int32Value();
-  int vfo = parseVfoParameter(info, 1, SHIM_RIG_VFO_CURR);
-  RETURN_NULL_IF_INVALID_VFO(vfo);
-  
-  SelectMemoryChannelAsyncWorker* worker = new SelectMemoryChannelAsyncWorker(env, this, channel_num, vfo);
-  worker->Queue();
-  
-  return worker->GetPromise();
+static Napi::Object commandThreadStatsToObject(Napi::Env env, const std::shared_ptr<RigCommandExecutor>& executor) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("enabled", Napi::Boolean::New(env, static_cast<bool>(executor)));
+  RigCommandExecutorStats stats;
+  if (executor) {
+    stats = executor->GetStats();
+  }
+  obj.Set("queueCapacity", Napi::Number::New(env, static_cast<double>(stats.queue_capacity)));
+  obj.Set("queueDepth", Napi::Number::New(env, static_cast<double>(stats.queue_depth)));
+  obj.Set("maxQueueDepth", Napi::Number::New(env, static_cast<double>(stats.max_queue_depth)));
+  obj.Set("submitted", Napi::Number::New(env, static_cast<double>(stats.submitted)));
+  obj.Set("completed", Napi::Number::New(env, static_cast<double>(stats.completed)));
+  obj.Set("rejected", Napi::Number::New(env, static_cast<double>(stats.rejected)));
+  obj.Set("batches", Napi::Number::New(env, static_cast<double>(stats.batches)));
+  const uint64_t started = stats.submitted >= stats.queue_depth ? stats.submitted - stats.queue_depth : 0;
+  obj.Set("avgWaitMs", Napi::Number::New(env, started > 0 ? stats.total_wait_ms / static_cast<double>(started) : 0));
+  obj.Set("maxWaitMs", Napi::Number::New(env, stats.max_wait_ms));
+  return obj;
 }
 
-Napi::Value NodeHamLib::GetMemoryLayout(const Napi::CallbackInfo & info) {
-  Napi::Env env = info.Env();
-  MemoryLayoutAsyncWorker* worker = new MemoryLayoutAsyncWorker(env, this);
-  worker->Queue();
-  return worker->GetPromise();
+Napi::Value NodeHamLib::GetCommandThreadStats(const Napi::CallbackInfo & info) {
+  return commandThreadStatsToObject(info.Env(), command_executor_);
 }
 
-Napi::Value NodeHamLib::GetMemoryCapabilities(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::GetStats(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  int channel_num = -1;
-  if (info.Length() >= 1 && !info[0].IsUndefined() && !info[0].IsNull()) {
-    if (!info[0].IsNumber()) {
-      Napi::TypeError::New(env, "Expected optional channel number").ThrowAsJavaScriptException();
-      return env.Null();
-    }
-    channel_num = info[0].As<Napi::Number>().Int32Value();
-  }
-  MemoryCapabilitiesAsyncWorker* worker = new MemoryCapabilitiesAsyncWorker(env, this, channel_num);
-  worker->Queue();
-  return worker->GetPromise();
+  Napi::Object obj = rigMetricsToObject(env, *metrics_);
+  obj.Set("commandThread", commandThreadStatsToObject(env, command_executor_));
+  Napi::Object coalescing = Napi::Object::New(env);
+  coalescing.Set("reads", Napi::Boolean::New(env, coalesce_reads_));
+  coalescing.Set("writes", Napi::Boolean::New(env, coalesce_writes_));
+  coalescing.Set("coalescedReads", Napi::Number::New(env, static_cast<double>(coalesced_reads_)));
+  coalescing.Set("coalescedWrites", Napi::Number::New(env, static_cast<double>(coalesced_writes_)));
+  obj.Set("coalescing", coalescing);
+  return obj;
 }
 
-Napi::Value NodeHamLib::GetMemoryList(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::ResetStats(const Napi::CallbackInfo & info) {
+  metrics_->Reset();
+  return info.Env().Undefined();
+}
+
+Napi::Value NodeHamLib::EnableTrace(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  bool read_only = true;
-  bool include_empty = false;
-  bool continue_on_error = true;
+
+  size_t capacity = RigTraceRing::kDefaultCapacity;
   if (info.Length() >= 1 && info[0].IsObject()) {
     Napi::Object options = info[0].As<Napi::Object>();
-    if (options.Has("readOnly")) read_only = options.Get("readOnly").As<Napi::Boolean>().Value();
-    if (options.Has("includeEmpty")) include_empty = options.Get("includeEmpty").As<Napi::Boolean>().Value();
-    if (options.Has("continueOnError")) continue_on_error = options.Get("continueOnError").As<Napi::Boolean>().Value();
+    if (options.Has("capacity") && !options.Get("capacity").IsUndefined()) {
+      if (!options.Get("capacity").IsNumber()) {
+        Napi::TypeError::New(env, "capacity must be a number").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      const double requested = options.Get("capacity").As<Napi::Number>().DoubleValue();
+      if (!(requested >= RigTraceRing::kMinCapacity && requested <= RigTraceRing::kMaxCapacity)) {
+        Napi::RangeError::New(env, "capacity must be between 64 and 1048576").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      capacity = static_cast<size_t>(requested);
+    }
+  } else if (info.Length() >= 1 && !info[0].IsUndefined()) {
+    Napi::TypeError::New(env, "Expected (options?: { capacity?: number })").ThrowAsJavaScriptException();
+    return env.Undefined();
   }
-  MemoryListAsyncWorker* worker = new MemoryListAsyncWorker(env, this, read_only, include_empty, continue_on_error);
-  worker->Queue();
-  return worker->GetPromise();
+
+  // Re-enabling with the same capacity keeps the events recorded so far.
+  if (!trace_ || trace_->Capacity() != RigTraceRing::RoundCapacity(capacity)) {
+    trace_ = std::make_shared<RigTraceRing>(capacity);
+  }
+  trace_enabled_ = true;
+  return env.Undefined();
 }
 
-Napi::Value NodeHamLib::SetMemoryChannels(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::DisableTrace(const Napi::CallbackInfo & info) {
+  // Workers created while tracing was on still record their later phases.
+  trace_enabled_ = false;
+  return info.Env().Undefined();
+}
+
+Napi::Value NodeHamLib::DumpTrace(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  if (info.Length() < 1 || !info[0].IsArray()) {
-    Napi::TypeError::New(env, "Expected channels array").ThrowAsJavaScriptException();
+  bool clear = false;
+  if (info.Length() >= 1 && info[0].IsObject()) {
+    Napi::Object options = info[0].As<Napi::Object>();
+    if (options.Has("clear") && !options.Get("clear").IsUndefined()) {
+      if (!options.Get("clear").IsBoolean()) {
+        Napi::TypeError::New(env, "clear must be a boolean").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      clear = options.Get("clear").As<Napi::Boolean>().Value();
+    }
+  } else if (info.Length() >= 1 && !info[0].IsUndefined()) {
+    Napi::TypeError::New(env, "Expected (options?: { clear?: boolean })").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Object trace = rigTraceToChromeObject(env, trace_.get(), trace_enabled_);
+  if (clear && trace_) {
+    trace_->Clear();
+  }
+  return trace;
+}
+
+Napi::Value NodeHamLib::EnableStateCache(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  int64_t maxAgeMs = -1;
+  if (info.Length() >= 1 && !readStateCacheMaxAge(env, info[0], &maxAgeMs)) {
     return env.Null();
   }
-  bool continue_on_error = false;
-  if (info.Length() >= 2 && info[1].IsObject()) {
-    Napi::Object options = info[1].As<Napi::Object>();
-    if (options.Has("continueOnError")) continue_on_error = options.Get("continueOnError").As<Napi::Boolean>().Value();
+  state_cache_.Enable(maxAgeMs < 0 ? RigStateCache::kDefaultMaxAgeMs : static_cast<uint32_t>(maxAgeMs));
+  return env.Undefined();
+}
+
+Napi::Value NodeHamLib::DisableStateCache(const Napi::CallbackInfo & info) {
+  state_cache_.Disable();
+  return info.Env().Undefined();
+}
+
+Napi::Value NodeHamLib::GetStateCacheStats(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  const RigStateCacheStats stats = state_cache_.GetStats();
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("enabled", Napi::Boolean::New(env, stats.enabled));
+  obj.Set("maxAgeMs", Napi::Number::New(env, stats.max_age_ms));
+  obj.Set("hits", Napi::Number::New(env, static_cast<double>(stats.hits)));
+  obj.Set("misses", Napi::Number::New(env, static_cast<double>(stats.misses)));
+  obj.Set("stale", Napi::Number::New(env, static_cast<double>(stats.stale)));
+  obj.Set("updates", Napi::Number::New(env, static_cast<double>(stats.updates)));
+  obj.Set("invalidations", Napi::Number::New(env, static_cast<double>(stats.invalidations)));
+  const uint64_t lookups = stats.hits + stats.misses;
+  obj.Set("hitRate", Napi::Number::New(env, lookups > 0 ? static_cast<double>(stats.hits) / static_cast<double>(lookups) : 0));
+  return obj;
+}
+
+static bool readCoalescingFlag(Napi::Env env, const Napi::Object& options, const char* name, bool* value) {
+  if (!options.Has(name) || options.Get(name).IsUndefined()) {
+    return true;
   }
-  Napi::Array input = info[0].As<Napi::Array>();
-  std::vector<shim_channel_t> channels;
-  channels.reserve(input.Length());
-  for (uint32_t i = 0; i < input.Length(); ++i) {
-    if (!input.Get(i).IsObject()) {
-      Napi::TypeError::New(env, "Each channel must be an object").ThrowAsJavaScriptException();
-      return env.Null();
-    }
-    shim_channel_t chan;
-    if (!jsObjectToShimChannel(env, input.Get(i).As<Napi::Object>(), &chan)) {
+  if (!options.Get(name).IsBoolean()) {
+    Napi::TypeError::New(env, std::string(name) + " must be a boolean").ThrowAsJavaScriptException();
+    return false;
+  }
+  *value = options.Get(name).As<Napi::Boolean>().Value();
+  return true;
+}
+
+Napi::Value NodeHamLib::EnableRequestCoalescing(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  bool reads = true;
+  bool writes = true;
+  if (info.Length() >= 1 && info[0].IsObject()) {
+    Napi::Object options = info[0].As<Napi::Object>();
+    if (!readCoalescingFlag(env, options, "reads", &reads) ||
+        !readCoalescingFlag(env, options, "writes", &writes)) {
       return env.Null();
     }
-    channels.push_back(chan);
+  } else if (info.Length() >= 1 && !info[0].IsUndefined()) {
+    Napi::TypeError::New(env, "Options must be an object").ThrowAsJavaScriptException();
+    return env.Null();
   }
-  SetMemoryChannelsAsyncWorker* worker = new SetMemoryChannelsAsyncWorker(env, this, std::move(channels), continue_on_error);
-  worker->Queue();
-  return worker->GetPromise();
+  coalesce_reads_ = reads;
+  coalesce_writes_ = writes;
+  return env.Undefined();
 }
 
-Napi::Value NodeHamLib::ReplaceMemoryChannels(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::DisableRequestCoalescing(const Napi::CallbackInfo & info) {
+  // Commands already sharing a worker still settle together.
+  coalesce_reads_ = false;
+  coalesce_writes_ = false;
+  inflight_reads_.clear();
+  pending_writes_.clear();
+  return info.Env().Undefined();
+}
+
+RigCommandPriority NodeHamLib::CommandPriorityFor(const char* operation, RigCommandPriority fallback) const {
+  if (command_priorities_.empty() || !operation) {
+    return fallback;
+  }
+  auto found = command_priorities_.find(operation);
+  return found == command_priorities_.end() ? fallback : found->second;
+}
+
+Napi::Value NodeHamLib::SetCommandPriorities(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  if (info.Length() < 1 || !info[0].IsArray()) {
-    Napi::TypeError::New(env, "Expected complete channels array").ThrowAsJavaScriptException();
+  if (info.Length() < 1 || !info[0].IsObject()) {
+    Napi::TypeError::New(env, "Expected (options: { backgroundBudget?: number, operations?: object })")
+      .ThrowAsJavaScriptException();
     return env.Null();
   }
-  Napi::Array input = info[0].As<Napi::Array>();
-  std::vector<shim_channel_t> channels;
-  channels.reserve(input.Length());
-  for (uint32_t i = 0; i < input.Length(); ++i) {
-    if (!input.Get(i).IsObject()) {
-      Napi::TypeError::New(env, "Each channel must be an object").ThrowAsJavaScriptException();
+  Napi::Object options = info[0].As<Napi::Object>();
+
+  uint32_t budget = background_budget_;
+  if (options.Has("backgroundBudget") && !options.Get("backgroundBudget").IsUndefined()) {
+    Napi::Value value = options.Get("backgroundBudget");
+    const double number = value.IsNumber() ? value.As<Napi::Number>().DoubleValue() : -1;
+    if (!(number >= 0 && number <= 65536) || number != static_cast<double>(static_cast<uint32_t>(number))) {
+      Napi::RangeError::New(env, "backgroundBudget must be an integer between 0 and 65536").ThrowAsJavaScriptException();
       return env.Null();
     }
-    shim_channel_t chan;
-    if (!jsObjectToShimChannel(env, input.Get(i).As<Napi::Object>(), &chan)) {
+    budget = static_cast<uint32_t>(number);
+  }
+
+  // Validate every entry before applying any.
+  std::vector<std::pair<std::string, Napi::Value>> updates;
+  if (options.Has("operations") && !options.Get("operations").IsUndefined()) {
+    if (!options.Get("operations").IsObject()) {
+      Napi::TypeError::New(env, "operations must be an object").ThrowAsJavaScriptException();
       return env.Null();
     }
-    channels.push_back(chan);
+    Napi::Object operations = options.Get("operations").As<Napi::Object>();
+    Napi::Array names = operations.GetPropertyNames();
+    for (uint32_t i = 0; i < names.Length(); ++i) {
+      std::string name = names.Get(i).As<Napi::String>().Utf8Value();
+      Napi::Value value = operations.Get(name);
+      RigCommandPriority priority = RigCommandPriority::Interactive;
+      if (!value.IsNull() && !(value.IsString()
+          && parseRigCommandPriority(value.As<Napi::String>().Utf8Value(), &priority))) {
+        Napi::TypeError::New(env, "operations." + name + " must be 'realtime', 'interactive', 'background' or null")
+          .ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      // Accept the JS method name as well as the operation name in getStats().
+      if (!name.empty()) {
+        name[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(name[0])));
+      }
+      updates.emplace_back(name, value);
+    }
   }
-  ReplaceMemoryChannelsAsyncWorker* worker = new ReplaceMemoryChannelsAsyncWorker(env, this, std::move(channels));
-  worker->Queue();
-  return worker->GetPromise();
+
+  background_budget_ = budget;
+  for (const auto& update : updates) {
+    RigCommandPriority priority = RigCommandPriority::Interactive;
+    if (update.second.IsNull()) {
+      command_priorities_.erase(update.first);
+    } else if (parseRigCommandPriority(update.second.As<Napi::String>().Utf8Value(), &priority)) {
+      command_priorities_[update.first] = priority;
+    }
+  }
+  return env.Undefined();
 }
 
-// RIT/XIT Control
-Napi::Value NodeHamLib::SetRit(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::GetCommandPriorities(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  
-  
-  if (info.Length() < 1 || !info[0].IsNumber()) {
-    Napi::TypeError::New(env, "Expected (ritOffset: number)").ThrowAsJavaScriptException();
-    return env.Null();
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("backgroundBudget", Napi::Number::New(env, background_budget_));
+  obj.Set("inflight", Napi::Number::New(env, static_cast<double>(inflight_commands_)));
+  Napi::Object operations = Napi::Object::New(env);
+  for (const auto& entry : command_priorities_) {
+    operations.Set(entry.first, Napi::String::New(env, rigCommandPriorityName(entry.second)));
   }
-  
-  int rit_offset = info[0].As<Napi::Number>().Int32Value();
-  
-  SetRitAsyncWorker* worker = new SetRitAsyncWorker(env, this, rit_offset);
-  worker->Queue();
-  
-  return worker->GetPromise();
+  obj.Set("operations", operations);
+  return obj;
 }
 
-Napi::Value NodeHamLib::GetRit(const Napi::CallbackInfo & info) {
+std::shared_ptr<RigCallControl> NodeHamLib::CurrentCallControl() const {
+  return call_scopes_.empty() ? nullptr : call_scopes_.back();
+}
+
+Napi::Value NodeHamLib::BeginCallScope(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  
-  
-  GetRitAsyncWorker* worker = new GetRitAsyncWorker(env, this);
-  worker->Queue();
-  
-  return worker->GetPromise();
+  bool hasDeadline = false;
+  double deadlineMs = 0;
+  if (info.Length() >= 1 && !info[0].IsUndefined() && !info[0].IsNull()) {
+    if (!info[0].IsNumber()) {
+      Napi::TypeError::New(env, "deadlineMs must be a number").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    deadlineMs = info[0].As<Napi::Number>().DoubleValue();
+    if (!std::isfinite(deadlineMs) || deadlineMs < 0) {
+      Napi::RangeError::New(env, "deadlineMs must be a non-negative finite number").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    hasDeadline = true;
+  }
+
+  for (auto entry = call_controls_.begin(); entry != call_controls_.end();) {
+    entry = entry->second.expired() ? call_controls_.erase(entry) : std::next(entry);
+  }
+  const uint32_t id = next_call_id_++;
+  if (next_call_id_ == 0) {
+    next_call_id_ = 1;
+  }
+  const RigCallControl::Clock::time_point deadline = RigCallControl::Clock::now()
+    + std::chrono::duration_cast<RigCallControl::Clock::duration>(std::chrono::duration<double, std::milli>(deadlineMs));
+  auto control = std::make_shared<RigCallControl>(id, hasDeadline, deadline);
+  call_scopes_.push_back(control);
+  call_controls_[id] = control;
+  return Napi::Number::New(env, id);
 }
 
-Napi::Value NodeHamLib::SetXit(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::EndCallScope(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  
-  
   if (info.Length() < 1 || !info[0].IsNumber()) {
-    Napi::TypeError::New(env, "Expected (xitOffset: number)").ThrowAsJavaScriptException();
+    Napi::TypeError::New(env, "Expected (scopeId: number)").ThrowAsJavaScriptException();
     return env.Null();
   }
-  
-  int xit_offset = info[0].As<Napi::Number>().Int32Value();
-  
-  SetXitAsyncWorker* worker = new SetXitAsyncWorker(env, this, xit_offset);
-  worker->Queue();
-  
-  return worker->GetPromise();
+  const uint32_t id = info[0].As<Napi::Number>().Uint32Value();
+  for (auto scope = call_scopes_.rbegin(); scope != call_scopes_.rend(); ++scope) {
+    if ((*scope)->Id() == id) {
+      call_scopes_.erase(std::next(scope).base());
+      break;
+    }
+  }
+  return env.Undefined();
 }
 
-Napi::Value NodeHamLib::GetXit(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::CancelCallScope(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  
-  
-  GetXitAsyncWorker* worker = new GetXitAsyncWorker(env, this);
-  worker->Queue();
-  
-  return worker->GetPromise();
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (scopeId: number)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  // False once every worker of the scope has completed: nothing to cancel.
+  auto entry = call_controls_.find(info[0].As<Napi::Number>().Uint32Value());
+  std::shared_ptr<RigCallControl> control = entry != call_controls_.end() ? entry->second.lock() : nullptr;
+  if (!control) {
+    return Napi::Boolean::New(env, false);
+  }
+  control->Cancel();
+  return Napi::Boolean::New(env, true);
 }
 
-Napi::Value NodeHamLib::ClearRitXit(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::GetGlobalStats(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  
-  
-  ClearRitXitAsyncWorker* worker = new ClearRitXitAsyncWorker(env, this);
-  worker->Queue();
-  
-  return worker->GetPromise();
+  Napi::Object obj = rigMetricsToObject(env, RigMetricsRegistry::Global());
+  Napi::Array holders = Napi::Array::New(env);
+  uint32_t index = 0;
+  for (const RigLockHolderSnapshot& holder : RigLockHolderTable::Global().TakeAll()) {
+    Napi::Object entry = Napi::Object::New(env);
+    entry.Set("operation", Napi::String::New(env, holder.operation));
+    entry.Set("scope", Napi::String::New(env, holder.scope));
+    entry.Set("heldMs", Napi::Number::New(env, holder.held_ms));
+    holders[index++] = entry;
+  }
+  obj.Set("lockHolders", holders);
+  return obj;
 }
 
-// Scanning Operations
-Napi::Value NodeHamLib::StartScan(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::ResetGlobalStats(const Napi::CallbackInfo & info) {
+  RigMetricsRegistry::Global().Reset();
+  return info.Env().Undefined();
+}
+
+// Memory Channel Management
+Napi::Value NodeHamLib::SetMemoryChannel(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
   
   
-  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsNumber()) {
-    Napi::TypeError::New(env, "Expected (scanType: string, channel: number)").ThrowAsJavaScriptException();
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsObject()) {
+    Napi::TypeError::New(env, "Expected (channelNumber: number, channelData: object)").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  std::string scanTypeStr = info[0].As<Napi::String>().Utf8Value();
-  int scanType;
-  
-  if (scanTypeStr == "VFO") {
-    scanType = SHIM_RIG_SCAN_VFO;
-  } else if (scanTypeStr == "MEM") {
-    scanType = SHIM_RIG_SCAN_MEM;
-  } else if (scanTypeStr == "PROG") {
-    scanType = SHIM_RIG_SCAN_PROG;
-  } else if (scanTypeStr == "DELTA") {
-    scanType = SHIM_RIG_SCAN_DELTA;
-  } else if (scanTypeStr == "PRIO") {
-    scanType = SHIM_RIG_SCAN_PRIO;
-  } else {
-    Napi::TypeError::New(env, "Invalid scan type").ThrowAsJavaScriptException();
+  int channel_num = info[0].As<Napi::Number>().Int32Value();
+  Napi::Object chanObj = info[1].As<Napi::Object>();
+
+  shim_channel_t chan;
+  if (!jsObjectToShimChannel(env, chanObj, &chan, channel_num)) {
     return env.Null();
   }
   
-  int channel = info[1].As<Napi::Number>().Int32Value();
-  
-  StartScanAsyncWorker* asyncWorker = new StartScanAsyncWorker(env, this, scanType, channel);
-  asyncWorker->Queue();
-  return asyncWorker->GetPromise();
-}
-
-Napi::Value NodeHamLib::StopScan(const Napi::CallbackInfo & info) {
-  Napi::Env env = info.Env();
-  
+  SetMemoryChannelAsyncWorker* worker = new SetMemoryChannelAsyncWorker(env, this, chan);
+  worker->Queue();
   
-  StopScanAsyncWorker* asyncWorker = new StopScanAsyncWorker(env, this);
-  asyncWorker->Queue();
-  return asyncWorker->GetPromise();
+  return worker->GetPromise();
 }
 
-// Level Controls
-Napi::Value NodeHamLib::SetLevel(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::GetMemoryChannel(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
   
   
-  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsNumber()) {
-    Napi::TypeError::New(env, "Expected (levelType: string, value: number, vfo?: string)").ThrowAsJavaScriptException();
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsBoolean()) {
+    Napi::TypeError::New(env, "Expected (channelNumber: number, readOnly: boolean)").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  std::string levelTypeStr = info[0].As<Napi::String>().Utf8Value();
-  double levelValue = info[1].As<Napi::Number>().DoubleValue();
-  int vfo = SHIM_RIG_VFO_CURR;
-  if (info.Length() >= 3) {
-    vfo = parseVfoParameter(info, 2, SHIM_RIG_VFO_CURR);
-    RETURN_NULL_IF_INVALID_VFO(vfo);
-  }
-  
-  uint64_t levelType;
-  if (!parseLevelTypeString(levelTypeStr, &levelType)) {
-    Napi::TypeError::New(env, "Invalid level type").ThrowAsJavaScriptException();
-    return env.Null();
-  }
+  int channel_num = info[0].As<Napi::Number>().Int32Value();
+  bool read_only = info[1].As<Napi::Boolean>().Value();
   
-  float val = static_cast<float>(levelValue);
-  SetLevelAsyncWorker* worker = new SetLevelAsyncWorker(env, this, levelType, val, vfo);
+  GetMemoryChannelAsyncWorker* worker = new GetMemoryChannelAsyncWorker(env, this, channel_num, read_only);
   worker->Queue();
+  
   return worker->GetPromise();
 }
 
-Napi::Value NodeHamLib::GetLevel(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::SelectMemoryChannel(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
   
   
-  if (info.Length() < 1 || !info[0].IsString()) {
-    Napi::TypeError::New(env, "Expected (levelType: string)").ThrowAsJavaScriptException();
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (channelNumber: number)").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  std::string levelTypeStr = info[0].As<Napi::String>().Utf8Value();
+  int channel_num = info[0].As<Napi::Number>().Int32Value();
+  int vfo = parseVfoParameter(info, 1, SHIM_RIG_VFO_CURR);
+  RETURN_NULL_IF_INVALID_VFO(vfo);
   
-  uint64_t levelType;
-  if (!parseLevelTypeString(levelTypeStr, &levelType)) {
-    Napi::TypeError::New(env, "Invalid level type").ThrowAsJavaScriptException();
-    return env.Null();
-  }
+  SelectMemoryChannelAsyncWorker* worker = new SelectMemoryChannelAsyncWorker(env, this, channel_num, vfo);
+  worker->Queue();
   
-  // Optional second parameter: Hamlib VFO token string ('VFOA', 'VFOB', 'currVFO', ...)
-  int vfo = SHIM_RIG_VFO_CURR;
-  if (info.Length() >= 2) {
-    vfo = parseVfoParameter(info, 1, SHIM_RIG_VFO_CURR);
-    RETURN_NULL_IF_INVALID_VFO(vfo);
-  }
+  return worker->GetPromise();
+}
 
-  GetLevelAsyncWorker* worker = new GetLevelAsyncWorker(env, this, levelType, vfo);
+Napi::Value NodeHamLib::GetMemoryLayout(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  MemoryLayoutAsyncWorker* worker = new MemoryLayoutAsyncWorker(env, this);
   worker->Queue();
+  return worker->GetPromise();
+}
 
+Napi::Value NodeHamLib::GetMemoryCapabilities(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  int channel_num = -1;
+  if (info.Length() >= 1 && !info[0].IsUndefined() && !info[0].IsNull()) {
+    if (!info[0].IsNumber()) {
+      Napi::TypeError::New(env, "Expected optional channel number").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    channel_num = info[0].As<Napi::Number>().Int32Value();
+  }
+  MemoryCapabilitiesAsyncWorker* worker = new MemoryCapabilitiesAsyncWorker(env, this, channel_num);
+  worker->Queue();
   return worker->GetPromise();
 }
 
+Napi::Value NodeHamLib::GetMemoryList(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  bool read_only = true;
+  bool include_empty = false;
+  bool continue_on_error = true;
+  if (info.Length() >= 1 && info[0].IsObject()) {
+    Napi::Object options = info[0].As<Napi::Object>();
+    if (options.Has("readOnly")) read_only = options.Get("readOnly").As<Napi::Boolean>().Value();
+    if (options.Has("includeEmpty")) include_empty = options.Get("includeEmpty").As<Napi::Boolean>().Value();
+    if (options.Has("continueOnError")) continue_on_error = options.Get("continueOnError").As<Napi::Boolean>().Value();
+  }
+  MemoryListAsyncWorker* worker = new MemoryListAsyncWorker(env, this, read_only, include_empty, continue_on_error);
+  worker->Queue();
+  return worker->GetPromise();
+}
 
-Napi::Value NodeHamLib::GetSupportedLevels(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::GetMemoryListChunk(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  auto values = std::make_shared<std::vector<std::string>>();
-  return QueueLockedCallbackWorker(env, this, "GetSupportedLevels",
-    [values](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      uint64_t levels = shim_rig_get_caps_has_get_level(instance->my_rig) | shim_rig_get_caps_has_set_level(instance->my_rig);
-      if (levels & SHIM_RIG_LEVEL_AF) values->push_back("AF");
-      if (levels & SHIM_RIG_LEVEL_PREAMP) values->push_back("PREAMP");
-      if (levels & SHIM_RIG_LEVEL_ATT) values->push_back("ATT");
-      if (levels & SHIM_RIG_LEVEL_RF) values->push_back("RF");
-      if (levels & SHIM_RIG_LEVEL_SQL) values->push_back("SQL");
-      if (levels & SHIM_RIG_LEVEL_RFPOWER) values->push_back("RFPOWER");
-      if (levels & SHIM_RIG_LEVEL_MICGAIN) values->push_back("MICGAIN");
-      if (levels & SHIM_RIG_LEVEL_IF) values->push_back("IF");
-      if (levels & SHIM_RIG_LEVEL_APF) values->push_back("APF");
-      if (levels & SHIM_RIG_LEVEL_NR) values->push_back("NR");
-      if (levels & SHIM_RIG_LEVEL_PBT_IN) values->push_back("PBT_IN");
-      if (levels & SHIM_RIG_LEVEL_PBT_OUT) values->push_back("PBT_OUT");
-      if (levels & SHIM_RIG_LEVEL_CWPITCH) values->push_back("CWPITCH");
-      if (levels & SHIM_RIG_LEVEL_KEYSPD) values->push_back("KEYSPD");
-      if (levels & SHIM_RIG_LEVEL_NOTCHF) values->push_back("NOTCHF");
-      if (levels & SHIM_RIG_LEVEL_COMP) values->push_back("COMP");
-      if (levels & SHIM_RIG_LEVEL_AGC) values->push_back("AGC");
-      if (levels & SHIM_RIG_LEVEL_BKINDL) values->push_back("BKINDL");
-      if (levels & SHIM_RIG_LEVEL_BALANCE) values->push_back("BALANCE");
-      if (levels & SHIM_RIG_LEVEL_VOXGAIN) values->push_back("VOXGAIN");
-      if (levels & SHIM_RIG_LEVEL_VOXDELAY) values->push_back("VOXDELAY");
-      if (levels & SHIM_RIG_LEVEL_ANTIVOX) values->push_back("ANTIVOX");
-      if (levels & SHIM_RIG_LEVEL_MONITOR_GAIN) values->push_back("MONITOR_GAIN");
-      if (levels & SHIM_RIG_LEVEL_STRENGTH) values->push_back("STRENGTH");
-      if (levels & SHIM_RIG_LEVEL_RAWSTR) values->push_back("RAWSTR");
-      if (levels & SHIM_RIG_LEVEL_SWR) values->push_back("SWR");
-      if (levels & SHIM_RIG_LEVEL_ALC) values->push_back("ALC");
-      if (levels & SHIM_RIG_LEVEL_RFPOWER_METER) values->push_back("RFPOWER_METER");
-      if (levels & SHIM_RIG_LEVEL_RFPOWER_METER_WATTS) values->push_back("RFPOWER_METER_WATTS");
-      if (levels & SHIM_RIG_LEVEL_COMP_METER) values->push_back("COMP_METER");
-      if (levels & SHIM_RIG_LEVEL_VD_METER) values->push_back("VD_METER");
-      if (levels & SHIM_RIG_LEVEL_ID_METER) values->push_back("ID_METER");
-      if (levels & SHIM_RIG_LEVEL_SPECTRUM_MODE) values->push_back("SPECTRUM_MODE");
-      if (levels & SHIM_RIG_LEVEL_SPECTRUM_SPAN) values->push_back("SPECTRUM_SPAN");
-      if (levels & SHIM_RIG_LEVEL_SPECTRUM_EDGE_LOW) values->push_back("SPECTRUM_EDGE_LOW");
-      if (levels & SHIM_RIG_LEVEL_SPECTRUM_EDGE_HIGH) values->push_back("SPECTRUM_EDGE_HIGH");
-      if (levels & SHIM_RIG_LEVEL_SPECTRUM_SPEED) values->push_back("SPECTRUM_SPEED");
-      if (levels & SHIM_RIG_LEVEL_SPECTRUM_REF) values->push_back("SPECTRUM_REF");
-      if (levels & SHIM_RIG_LEVEL_SPECTRUM_AVG) values->push_back("SPECTRUM_AVG");
-      if (levels & SHIM_RIG_LEVEL_SPECTRUM_ATT) values->push_back("SPECTRUM_ATT");
-      if (levels & SHIM_RIG_LEVEL_TEMP_METER) values->push_back("TEMP_METER");
-    },
-    [values](Napi::Env env) {
-      return StringVectorToArray(env, *values);
-    });
+  bool read_only = true;
+  bool include_empty = false;
+  bool continue_on_error = true;
+  int cursor = std::numeric_limits<int>::min();
+  int chunk_size = 32;
+  if (info.Length() >= 1 && info[0].IsObject()) {
+    Napi::Object options = info[0].As<Napi::Object>();
+    if (options.Has("readOnly")) read_only = options.Get("readOnly").As<Napi::Boolean>().Value();
+    if (options.Has("includeEmpty")) include_empty = options.Get("includeEmpty").As<Napi::Boolean>().Value();
+    if (options.Has("continueOnError")) continue_on_error = options.Get("continueOnError").As<Napi::Boolean>().Value();
+    Napi::Value cursorValue = options.Get("cursor");
+    if (!cursorValue.IsUndefined() && !cursorValue.IsNull()) {
+      if (!cursorValue.IsNumber()) {
+        Napi::TypeError::New(env, "cursor must be a channel number").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      cursor = cursorValue.As<Napi::Number>().Int32Value();
+    }
+    Napi::Value chunkValue = options.Get("chunkSize");
+    if (!chunkValue.IsUndefined()) {
+      if (!chunkValue.IsNumber() || chunkValue.As<Napi::Number>().Int32Value() < 1) {
+        Napi::RangeError::New(env, "chunkSize must be a positive integer").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      chunk_size = chunkValue.As<Napi::Number>().Int32Value();
+    }
+  }
+  MemoryListChunkAsyncWorker* worker = new MemoryListChunkAsyncWorker(
+    env, this, cursor, chunk_size, read_only, include_empty, continue_on_error);
+  worker->Queue();
+  return worker->GetPromise();
+}
+
+// Diff-mode options shared by setMemoryChannels and replaceMemoryChannels:
+// { diff: boolean, baseline?: MemoryChannel[] }. A baseline implies diff.
+static bool readMemoryDiffOptions(Napi::Env env, Napi::Object options, bool* diff,
+                                  std::map<int, shim_channel_t>* baseline) {
+  if (options.Has("diff")) *diff = options.Get("diff").As<Napi::Boolean>().Value();
+  Napi::Value baselineValue = options.Get("baseline");
+  if (baselineValue.IsUndefined() || baselineValue.IsNull()) {
+    return true;
+  }
+  if (!baselineValue.IsArray()) {
+    Napi::TypeError::New(env, "baseline must be an array of channels (e.g. from memory.list())").ThrowAsJavaScriptException();
+    return false;
+  }
+  Napi::Array input = baselineValue.As<Napi::Array>();
+  for (uint32_t i = 0; i < input.Length(); ++i) {
+    if (!input.Get(i).IsObject()) {
+      Napi::TypeError::New(env, "Each baseline channel must be an object").ThrowAsJavaScriptException();
+      return false;
+    }
+    Napi::Object entry = input.Get(i).As<Napi::Object>();
+    if (!entry.Get("channelNumber").IsNumber()) {
+      Napi::TypeError::New(env, "Each baseline channel needs a channelNumber").ThrowAsJavaScriptException();
+      return false;
+    }
+    shim_channel_t chan;
+    memset(&chan, 0, sizeof(chan));
+    chan.channel_num = entry.Get("channelNumber").As<Napi::Number>().Int32Value();
+    if (!entry.Get("empty").IsBoolean() || !entry.Get("empty").As<Napi::Boolean>().Value()) {
+      // list() reports unset VFOs as tokens that do not parse back ("None");
+      // they are not compared, so leave them out rather than fail.
+      Napi::Object fields = Napi::Object::New(env);
+      Napi::Array names = entry.GetPropertyNames();
+      for (uint32_t n = 0; n < names.Length(); ++n) {
+        std::string name = names.Get(n).As<Napi::String>().Utf8Value();
+        Napi::Value value = entry.Get(name);
+        if (name == "vfo" || (name == "txVfo" && (!value.IsString()
+            || shim_rig_parse_vfo(value.As<Napi::String>().Utf8Value().c_str()) == SHIM_RIG_VFO_NONE))) {
+          continue;
+        }
+        fields.Set(name, value);
+      }
+      if (!jsObjectToShimChannel(env, fields, &chan)) {
+        return false;
+      }
+    }
+    (*baseline)[chan.channel_num] = chan;
+  }
+  *diff = true;
+  return true;
 }
 
+Napi::Value NodeHamLib::SetMemoryChannels(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected channels array").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  bool continue_on_error = false;
+  bool diff = false;
+  std::map<int, shim_channel_t> baseline;
+  if (info.Length() >= 2 && info[1].IsObject()) {
+    Napi::Object options = info[1].As<Napi::Object>();
+    if (options.Has("continueOnError")) continue_on_error = options.Get("continueOnError").As<Napi::Boolean>().Value();
+    if (!readMemoryDiffOptions(env, options, &diff, &baseline)) {
+      return env.Null();
+    }
+  }
+  Napi::Array input = info[0].As<Napi::Array>();
+  std::vector<shim_channel_t> channels;
+  channels.reserve(input.Length());
+  for (uint32_t i = 0; i < input.Length(); ++i) {
+    if (!input.Get(i).IsObject()) {
+      Napi::TypeError::New(env, "Each channel must be an object").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    shim_channel_t chan;
+    if (!jsObjectToShimChannel(env, input.Get(i).As<Napi::Object>(), &chan)) {
+      return env.Null();
+    }
+    channels.push_back(chan);
+  }
+  SetMemoryChannelsAsyncWorker* worker = new SetMemoryChannelsAsyncWorker(env, this, std::move(channels), continue_on_error,
+    diff, std::move(baseline));
+  worker->Queue();
+  return worker->GetPromise();
+}
 
-// Function Controls
-Napi::Value NodeHamLib::SetFunction(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::ReplaceMemoryChannels(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  
-  
-  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsBoolean()) {
-    Napi::TypeError::New(env, "Expected (functionType: string, enable: boolean)").ThrowAsJavaScriptException();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected complete channels array").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  bool diff = false;
+  std::map<int, shim_channel_t> baseline;
+  if (info.Length() >= 2 && info[1].IsObject()
+      && !readMemoryDiffOptions(env, info[1].As<Napi::Object>(), &diff, &baseline)) {
     return env.Null();
   }
+  Napi::Array input = info[0].As<Napi::Array>();
+  std::vector<shim_channel_t> channels;
+  channels.reserve(input.Length());
+  for (uint32_t i = 0; i < input.Length(); ++i) {
+    if (!input.Get(i).IsObject()) {
+      Napi::TypeError::New(env, "Each channel must be an object").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    shim_channel_t chan;
+    if (!jsObjectToShimChannel(env, input.Get(i).As<Napi::Object>(), &chan)) {
+      return env.Null();
+    }
+    channels.push_back(chan);
+  }
+  ReplaceMemoryChannelsAsyncWorker* worker = new ReplaceMemoryChannelsAsyncWorker(env, this, std::move(channels),
+    diff, std::move(baseline));
+  worker->Queue();
+  return worker->GetPromise();
+}
+
+// RIT/XIT Control
+Napi::Value NodeHamLib::SetRit(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
   
-  std::string funcTypeStr = info[0].As<Napi::String>().Utf8Value();
-  bool enable = info[1].As<Napi::Boolean>().Value();
   
-  // Map function type strings to hamlib constants
-  uint64_t funcType;
-  if (funcTypeStr == "FAGC") {
-    funcType = SHIM_RIG_FUNC_FAGC;
-  } else if (funcTypeStr == "NB") {
-    funcType = SHIM_RIG_FUNC_NB;
-  } else if (funcTypeStr == "COMP") {
-    funcType = SHIM_RIG_FUNC_COMP;
-  } else if (funcTypeStr == "VOX") {
-    funcType = SHIM_RIG_FUNC_VOX;
-  } else if (funcTypeStr == "TONE") {
-    funcType = SHIM_RIG_FUNC_TONE;
-  } else if (funcTypeStr == "TSQL") {
-    funcType = SHIM_RIG_FUNC_TSQL;
-  } else if (funcTypeStr == "SBKIN") {
-    funcType = SHIM_RIG_FUNC_SBKIN;
-  } else if (funcTypeStr == "FBKIN") {
-    funcType = SHIM_RIG_FUNC_FBKIN;
-  } else if (funcTypeStr == "ANF") {
-    funcType = SHIM_RIG_FUNC_ANF;
-  } else if (funcTypeStr == "NR") {
-    funcType = SHIM_RIG_FUNC_NR;
-  } else if (funcTypeStr == "AIP") {
-    funcType = SHIM_RIG_FUNC_AIP;
-  } else if (funcTypeStr == "APF") {
-    funcType = SHIM_RIG_FUNC_APF;
-  } else if (funcTypeStr == "TUNER") {
-    funcType = SHIM_RIG_FUNC_TUNER;
-  } else if (funcTypeStr == "XIT") {
-    funcType = SHIM_RIG_FUNC_XIT;
-  } else if (funcTypeStr == "RIT") {
-    funcType = SHIM_RIG_FUNC_RIT;
-  } else if (funcTypeStr == "LOCK") {
-    funcType = SHIM_RIG_FUNC_LOCK;
-  } else if (funcTypeStr == "MUTE") {
-    funcType = SHIM_RIG_FUNC_MUTE;
-  } else if (funcTypeStr == "VSC") {
-    funcType = SHIM_RIG_FUNC_VSC;
-  } else if (funcTypeStr == "REV") {
-    funcType = SHIM_RIG_FUNC_REV;
-  } else if (funcTypeStr == "SQL") {
-    funcType = SHIM_RIG_FUNC_SQL;
-  } else if (funcTypeStr == "ABM") {
-    funcType = SHIM_RIG_FUNC_ABM;
-  } else if (funcTypeStr == "BC") {
-    funcType = SHIM_RIG_FUNC_BC;
-  } else if (funcTypeStr == "MBC") {
-    funcType = SHIM_RIG_FUNC_MBC;
-  } else if (funcTypeStr == "AFC") {
-    funcType = SHIM_RIG_FUNC_AFC;
-  } else if (funcTypeStr == "SATMODE") {
-    funcType = SHIM_RIG_FUNC_SATMODE;
-  } else if (funcTypeStr == "SCOPE") {
-    funcType = SHIM_RIG_FUNC_SCOPE;
-  } else if (funcTypeStr == "RESUME") {
-    funcType = SHIM_RIG_FUNC_RESUME;
-  } else if (funcTypeStr == "TBURST") {
-    funcType = SHIM_RIG_FUNC_TBURST;
-  } else if (funcTypeStr == "TRANSCEIVE") {
-    funcType = SHIM_RIG_FUNC_TRANSCEIVE;
-  } else if (funcTypeStr == "SPECTRUM") {
-    funcType = SHIM_RIG_FUNC_SPECTRUM;
-  } else if (funcTypeStr == "SPECTRUM_HOLD") {
-    funcType = SHIM_RIG_FUNC_SPECTRUM_HOLD;
-  } else {
-    Napi::TypeError::New(env, "Invalid function type").ThrowAsJavaScriptException();
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (ritOffset: number)").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  SetFunctionAsyncWorker* worker = new SetFunctionAsyncWorker(env, this, funcType, enable ? 1 : 0);
+  int rit_offset = info[0].As<Napi::Number>().Int32Value();
+  
+  SetRitAsyncWorker* worker = new SetRitAsyncWorker(env, this, rit_offset);
   worker->Queue();
   
   return worker->GetPromise();
 }
 
-Napi::Value NodeHamLib::GetFunction(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::GetRit(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
   
   
-  if (info.Length() < 1 || !info[0].IsString()) {
-    Napi::TypeError::New(env, "Expected (functionType: string)").ThrowAsJavaScriptException();
-    return env.Null();
-  }
+  GetRitAsyncWorker* worker = new GetRitAsyncWorker(env, this);
+  worker->Queue();
   
-  std::string funcTypeStr = info[0].As<Napi::String>().Utf8Value();
+  return worker->GetPromise();
+}
+
+Napi::Value NodeHamLib::SetXit(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
   
-  // Map function type strings to hamlib constants (same as SetFunction)
-  uint64_t funcType;
-  if (funcTypeStr == "FAGC") {
-    funcType = SHIM_RIG_FUNC_FAGC;
-  } else if (funcTypeStr == "NB") {
-    funcType = SHIM_RIG_FUNC_NB;
-  } else if (funcTypeStr == "COMP") {
-    funcType = SHIM_RIG_FUNC_COMP;
-  } else if (funcTypeStr == "VOX") {
-    funcType = SHIM_RIG_FUNC_VOX;
-  } else if (funcTypeStr == "TONE") {
-    funcType = SHIM_RIG_FUNC_TONE;
-  } else if (funcTypeStr == "TSQL") {
-    funcType = SHIM_RIG_FUNC_TSQL;
-  } else if (funcTypeStr == "SBKIN") {
-    funcType = SHIM_RIG_FUNC_SBKIN;
-  } else if (funcTypeStr == "FBKIN") {
-    funcType = SHIM_RIG_FUNC_FBKIN;
-  } else if (funcTypeStr == "ANF") {
-    funcType = SHIM_RIG_FUNC_ANF;
-  } else if (funcTypeStr == "NR") {
-    funcType = SHIM_RIG_FUNC_NR;
-  } else if (funcTypeStr == "AIP") {
-    funcType = SHIM_RIG_FUNC_AIP;
-  } else if (funcTypeStr == "APF") {
-    funcType = SHIM_RIG_FUNC_APF;
-  } else if (funcTypeStr == "TUNER") {
-    funcType = SHIM_RIG_FUNC_TUNER;
-  } else if (funcTypeStr == "XIT") {
-    funcType = SHIM_RIG_FUNC_XIT;
-  } else if (funcTypeStr == "RIT") {
-    funcType = SHIM_RIG_FUNC_RIT;
-  } else if (funcTypeStr == "LOCK") {
-    funcType = SHIM_RIG_FUNC_LOCK;
-  } else if (funcTypeStr == "MUTE") {
-    funcType = SHIM_RIG_FUNC_MUTE;
-  } else if (funcTypeStr == "VSC") {
-    funcType = SHIM_RIG_FUNC_VSC;
-  } else if (funcTypeStr == "REV") {
-    funcType = SHIM_RIG_FUNC_REV;
-  } else if (funcTypeStr == "SQL") {
-    funcType = SHIM_RIG_FUNC_SQL;
-  } else if (funcTypeStr == "ABM") {
-    funcType = SHIM_RIG_FUNC_ABM;
-  } else if (funcTypeStr == "BC") {
-    funcType = SHIM_RIG_FUNC_BC;
-  } else if (funcTypeStr == "MBC") {
-    funcType = SHIM_RIG_FUNC_MBC;
-  } else if (funcTypeStr == "AFC") {
-    funcType = SHIM_RIG_FUNC_AFC;
-  } else if (funcTypeStr == "SATMODE") {
-    funcType = SHIM_RIG_FUNC_SATMODE;
-  } else if (funcTypeStr == "SCOPE") {
-    funcType = SHIM_RIG_FUNC_SCOPE;
-  } else if (funcTypeStr == "RESUME") {
-    funcType = SHIM_RIG_FUNC_RESUME;
-  } else if (funcTypeStr == "TBURST") {
-    funcType = SHIM_RIG_FUNC_TBURST;
-  } else if (funcTypeStr == "TRANSCEIVE") {
-    funcType = SHIM_RIG_FUNC_TRANSCEIVE;
-  } else if (funcTypeStr == "SPECTRUM") {
-    funcType = SHIM_RIG_FUNC_SPECTRUM;
-  } else if (funcTypeStr == "SPECTRUM_HOLD") {
-    funcType = SHIM_RIG_FUNC_SPECTRUM_HOLD;
-  } else {
-    Napi::TypeError::New(env, "Invalid function type").ThrowAsJavaScriptException();
+  
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (xitOffset: number)").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  GetFunctionAsyncWorker* worker = new GetFunctionAsyncWorker(env, this, funcType);
+  int xit_offset = info[0].As<Napi::Number>().Int32Value();
+  
+  SetXitAsyncWorker* worker = new SetXitAsyncWorker(env, this, xit_offset);
   worker->Queue();
   
   return worker->GetPromise();
 }
 
-
-Napi::Value NodeHamLib::GetSupportedFunctions(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::GetXit(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  auto values = std::make_shared<std::vector<std::string>>();
-  return QueueLockedCallbackWorker(env, this, "GetSupportedFunctions",
-    [values](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      uint64_t functions = shim_rig_get_caps_has_get_func(instance->my_rig) | shim_rig_get_caps_has_set_func(instance->my_rig);
-      if (functions & SHIM_RIG_FUNC_FAGC) values->push_back("FAGC");
-      if (functions & SHIM_RIG_FUNC_NB) values->push_back("NB");
-      if (functions & SHIM_RIG_FUNC_COMP) values->push_back("COMP");
-      if (functions & SHIM_RIG_FUNC_VOX) values->push_back("VOX");
-      if (functions & SHIM_RIG_FUNC_TONE) values->push_back("TONE");
-      if (functions & SHIM_RIG_FUNC_TSQL) values->push_back("TSQL");
-      if (functions & SHIM_RIG_FUNC_SBKIN) values->push_back("SBKIN");
-      if (functions & SHIM_RIG_FUNC_FBKIN) values->push_back("FBKIN");
-      if (functions & SHIM_RIG_FUNC_ANF) values->push_back("ANF");
-      if (functions & SHIM_RIG_FUNC_NR) values->push_back("NR");
-      if (functions & SHIM_RIG_FUNC_AIP) values->push_back("AIP");
-      if (functions & SHIM_RIG_FUNC_APF) values->push_back("APF");
-      if (functions & SHIM_RIG_FUNC_TUNER) values->push_back("TUNER");
-      if (functions & SHIM_RIG_FUNC_XIT) values->push_back("XIT");
-      if (functions & SHIM_RIG_FUNC_RIT) values->push_back("RIT");
-      if (functions & SHIM_RIG_FUNC_LOCK) values->push_back("LOCK");
-      if (functions & SHIM_RIG_FUNC_MUTE) values->push_back("MUTE");
-      if (functions & SHIM_RIG_FUNC_VSC) values->push_back("VSC");
-      if (functions & SHIM_RIG_FUNC_REV) values->push_back("REV");
-      if (functions & SHIM_RIG_FUNC_SQL) values->push_back("SQL");
-      if (functions & SHIM_RIG_FUNC_ABM) values->push_back("ABM");
-      if (functions & SHIM_RIG_FUNC_BC) values->push_back("BC");
-      if (functions & SHIM_RIG_FUNC_MBC) values->push_back("MBC");
-      if (functions & SHIM_RIG_FUNC_AFC) values->push_back("AFC");
-      if (functions & SHIM_RIG_FUNC_SATMODE) values->push_back("SATMODE");
-      if (functions & SHIM_RIG_FUNC_SCOPE) values->push_back("SCOPE");
-      if (functions & SHIM_RIG_FUNC_RESUME) values->push_back("RESUME");
-      if (functions & SHIM_RIG_FUNC_TBURST) values->push_back("TBURST");
-      if (functions & SHIM_RIG_FUNC_TRANSCEIVE) values->push_back("TRANSCEIVE");
-      if (functions & SHIM_RIG_FUNC_SPECTRUM) values->push_back("SPECTRUM");
-      if (functions & SHIM_RIG_FUNC_SPECTRUM_HOLD) values->push_back("SPECTRUM_HOLD");
-      if (functions & SHIM_RIG_FUNC_SEND_MORSE) values->push_back("SEND_MORSE");
-      if (functions & SHIM_RIG_FUNC_SEND_VOICE_MEM) values->push_back("SEND_VOICE_MEM");
-      if (functions & SHIM_RIG_FUNC_OVF_STATUS) values->push_back("OVF_STATUS");
-    },
-    [values](Napi::Env env) {
-      return StringVectorToArray(env, *values);
-    });
+  
+  
+  GetXitAsyncWorker* worker = new GetXitAsyncWorker(env, this);
+  worker->Queue();
+  
+  return worker->GetPromise();
 }
 
-
-// Mode Query
-
-Napi::Value NodeHamLib::GetSupportedModes(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::ClearRitXit(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
-  auto values = std::make_shared<std::vector<std::string>>();
-  return QueueLockedCallbackWorker(env, this, "GetSupportedModes",
-    [values](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      (void)error_message;
-      uint64_t modes = shim_rig_get_mode_list(instance->my_rig);
-      for (unsigned int i = 0; i < SHIM_HAMLIB_MAX_MODES; i++) {
-        uint64_t mode_bit = modes & (1ULL << i);
-        if (!mode_bit) continue;
-        const char* mode_str = shim_rig_strrmode(mode_bit);
-        if (mode_str && mode_str[0] != '\0') values->emplace_back(mode_str);
-      }
-    },
-    [values](Napi::Env env) {
-      return StringVectorToArray(env, *values);
-    });
+  
+  
+  ClearRitXitAsyncWorker* worker = new ClearRitXitAsyncWorker(env, this);
+  worker->Queue();
+  
+  return worker->GetPromise();
 }
 
-
-// Split Operations
-Napi::Value NodeHamLib::SetSplitFreq(const Napi::CallbackInfo & info) {
+// Scanning Operations
+Napi::Value NodeHamLib::StartScan(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
   
   
-  if (info.Length() < 1 || !info[0].IsNumber()) {
-    Napi::TypeError::New(env, "Expected TX frequency").ThrowAsJavaScriptException();
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (scanType: string, channel: number)").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  double tx_freq = info[0].As<Napi::Number>().DoubleValue();
+  std::string scanTypeStr = info[0].As<Napi::String>().Utf8Value();
+  int scanType;
   
-  // Basic frequency range validation
-  if (tx_freq < 1000 || tx_freq > 10000000000) { // 1 kHz to 10 GHz reasonable range
-    Napi::Error::New(env, "Frequency out of range (1 kHz - 10 GHz)").ThrowAsJavaScriptException();
+  if (scanTypeStr == "VFO") {
+    scanType = SHIM_RIG_SCAN_VFO;
+  } else if (scanTypeStr == "MEM") {
+    scanType = SHIM_RIG_SCAN_MEM;
+  } else if (scanTypeStr == "PROG") {
+    scanType = SHIM_RIG_SCAN_PROG;
+  } else if (scanTypeStr == "DELTA") {
+    scanType = SHIM_RIG_SCAN_DELTA;
+  } else if (scanTypeStr == "PRIO") {
+    scanType = SHIM_RIG_SCAN_PRIO;
+  } else {
+    Napi::TypeError::New(env, "Invalid scan type").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  int vfo = SHIM_RIG_VFO_CURR;
-  
-  if (info.Length() >= 2 && info[1].IsString()) {
-    // setSplitFreq(freq, vfo)
-    vfo = parseVfoParameter(info, 1, SHIM_RIG_VFO_CURR);
-    RETURN_NULL_IF_INVALID_VFO(vfo);
-  }
+  int channel = info[1].As<Napi::Number>().Int32Value();
   
-  SetSplitFreqAsyncWorker* asyncWorker = new SetSplitFreqAsyncWorker(env, this, tx_freq, vfo);
+  StartScanAsyncWorker* asyncWorker = new StartScanAsyncWorker(env, this, scanType, channel);
   asyncWorker->Queue();
   return asyncWorker->GetPromise();
 }
 
-Napi::Value NodeHamLib::GetSplitFreq(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::StopScan(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
   
   
-  int vfo = SHIM_RIG_VFO_CURR;
-  
-  if (info.Length() >= 1 && info[0].IsString()) {
-    // getSplitFreq(vfo)
-    vfo = parseVfoParameter(info, 0, SHIM_RIG_VFO_CURR);
-    RETURN_NULL_IF_INVALID_VFO(vfo);
-  }
-  // Otherwise use default SHIM_RIG_VFO_CURR for getSplitFreq()
-  
-  GetSplitFreqAsyncWorker* asyncWorker = new GetSplitFreqAsyncWorker(env, this, vfo);
+  StopScanAsyncWorker* asyncWorker = new StopScanAsyncWorker(env, this);
   asyncWorker->Queue();
   return asyncWorker->GetPromise();
 }
 
-Napi::Value NodeHamLib::SetSplitMode(const Napi::CallbackInfo & info) {
+// Level Controls
+Napi::Value NodeHamLib::SetLevel(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
   
   
-  if (info.Length() < 1 || !info[0].IsString()) {
-    Napi::TypeError::New(env, "Expected TX mode string").ThrowAsJavaScriptException();
+  if (info.Length() < 2 || !isTokenValue(info[0]) || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (levelType: string, value: number, vfo?: string)").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  std::string modeStr = info[0].As<Napi::String>().Utf8Value();
-  int tx_mode = shim_rig_parse_mode(modeStr.c_str());
-  
-  if (tx_mode == SHIM_RIG_MODE_NONE) {
-    Napi::Error::New(env, "Invalid mode: " + modeStr).ThrowAsJavaScriptException();
-    return env.Null();
-  }
-  
-  int tx_width = SHIM_RIG_PASSBAND_NORMAL;
+  double levelValue = info[1].As<Napi::Number>().DoubleValue();
   int vfo = SHIM_RIG_VFO_CURR;
-  
-  // Parse parameters: setSplitMode(mode) | setSplitMode(mode, vfo) | setSplitMode(mode, width) | setSplitMode(mode, width, vfo)
-  if (info.Length() == 2) {
-    if (info[1].IsString()) {
-      // setSplitMode(mode, vfo)
-      vfo = parseVfoParameter(info, 1, SHIM_RIG_VFO_CURR);
-      RETURN_NULL_IF_INVALID_VFO(vfo);
-    } else if (info[1].IsNumber()) {
-      // setSplitMode(mode, width)
-      tx_width = info[1].As<Napi::Number>().Int32Value();
-    }
-  } else if (info.Length() == 3 && info[1].IsNumber() && info[2].IsString()) {
-    // setSplitMode(mode, width, vfo)
-    tx_width = info[1].As<Napi::Number>().Int32Value();
+  if (info.Length() >= 3) {
     vfo = parseVfoParameter(info, 2, SHIM_RIG_VFO_CURR);
     RETURN_NULL_IF_INVALID_VFO(vfo);
   }
   
-  SetSplitModeAsyncWorker* asyncWorker = new SetSplitModeAsyncWorker(env, this, tx_mode, tx_width, vfo);
-  asyncWorker->Queue();
-  return asyncWorker->GetPromise();
+  uint64_t levelType;
+  if (!parseTokenValue(RigTokenKind::Level, info[0], &levelType)) {
+    Napi::TypeError::New(env, "Invalid level type").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  float val = static_cast<float>(levelValue);
+  SetLevelAsyncWorker* worker = new SetLevelAsyncWorker(env, this, levelType, val, vfo);
+  worker->Queue();
+  return worker->GetPromise();
 }
 
-Napi::Value NodeHamLib::GetSplitMode(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::GetLevel(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
   
   
-  int vfo = SHIM_RIG_VFO_CURR;
+  if (info.Length() < 1 || !isTokenValue(info[0])) {
+    Napi::TypeError::New(env, "Expected (levelType: string)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
   
-  if (info.Length() >= 1 && info[0].IsString()) {
-    // getSplitMode(vfo)
-    vfo = parseVfoParameter(info, 0, SHIM_RIG_VFO_CURR);
-    RETURN_NULL_IF_INVALID_VFO(vfo);
+  uint64_t levelType;
+  if (!parseTokenValue(RigTokenKind::Level, info[0], &levelType)) {
+    Napi::TypeError::New(env, "Invalid level type").ThrowAsJavaScriptException();
+    return env.Null();
   }
-  // Otherwise use default SHIM_RIG_VFO_CURR for getSplitMode()
   
-  GetSplitModeAsyncWorker* asyncWorker = new GetSplitModeAsyncWorker(env, this, vfo);
-  asyncWorker->Queue();
-  return asyncWorker->GetPromise();
+  // Optional second parameter: Hamlib VFO token string ('VFOA', 'VFOB', 'currVFO', ...)
+  int vfo = SHIM_RIG_VFO_CURR;
+  if (info.Length() >= 2) {
+    vfo = parseVfoParameter(info, 1, SHIM_RIG_VFO_CURR);
+    RETURN_NULL_IF_INVALID_VFO(vfo);
+  }
+
+  return QueueCoalescedRead(env, coalesceKey("GetLevel", vfo, levelType), [&]() -> HamLibAsyncWorker* {
+    return new GetLevelAsyncWorker(env, this, levelType, vfo);
+  });
 }
 
-Napi::Value NodeHamLib::SetSplit(const Napi::CallbackInfo & info) {
+
+static Napi::Value tokenHandleFor(const Napi::CallbackInfo& info, RigTokenKind kind, const char* expected, const char* invalid) {
   Napi::Env env = info.Env();
-  
-  
-  if (info.Length() < 1 || !info[0].IsBoolean()) {
-    Napi::TypeError::New(env, "Expected boolean split enable state").ThrowAsJavaScriptException();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, expected).ThrowAsJavaScriptException();
     return env.Null();
   }
-  
-  bool split_enabled = info[0].As<Napi::Boolean>().Value();
-  int split = split_enabled ? SHIM_RIG_SPLIT_ON : SHIM_RIG_SPLIT_OFF;
-  
-  // Default values
-  int rx_vfo = SHIM_RIG_VFO_CURR;
-  int tx_vfo = SHIM_RIG_VFO_CURR;
-  
-  // ⚠️  CRITICAL HISTORICAL ISSUE WARNING ⚠️
-  // This Split API had a severe parameter order bug that caused AI to repeatedly
-  // modify but never correctly fix. See CLAUDE.md for full details.
-  // 
-  // Parse different overloads:
-  // setSplit(enable)
-  // setSplit(enable, rxVfo) - rxVfo here is RX VFO
-  // setSplit(enable, rxVfo, txVfo) - RX VFO and TX VFO
-  // 
-  // ⚠️  VERIFIED PARAMETER ORDER (2024-08-10):
-  // - info[1] = rxVfo (RX VFO) 
-  // - info[2] = txVfo (TX VFO)
-  // - Must match JavaScript: setSplit(enable, rxVfo, txVfo)
-  // - Must match TypeScript: setSplit(enable: boolean, rxVfo?: VFO, txVfo?: VFO)
-  
-  if (info.Length() == 2 && info[1].IsString()) {
-    // setSplit(enable, rxVfo) - treating vfo as RX VFO for current VFO operation
-    rx_vfo = parseVfoParameter(info, 1, SHIM_RIG_VFO_CURR);
-    RETURN_NULL_IF_INVALID_VFO(rx_vfo);
-  } else if (info.Length() == 3 && info[1].IsString() && info[2].IsString()) {
-    // setSplit(enable, rxVfo, txVfo)
-    // ⚠️  CRITICAL: Parameter assignment was WRONG before 2024-08-10 fix!
-    // ⚠️  Previous bug: info[1] -> txVfoStr, info[2] -> rxVfoStr (WRONG!)
-    // ⚠️  Correct now: info[1] -> rxVfoStr, info[2] -> txVfoStr (RIGHT!)
-    rx_vfo = parseVfoParameter(info, 1, SHIM_RIG_VFO_CURR);
-    RETURN_NULL_IF_INVALID_VFO(rx_vfo);
-    tx_vfo = parseVfoParameter(info, 2, SHIM_RIG_VFO_CURR);
-    RETURN_NULL_IF_INVALID_VFO(tx_vfo);
+  const uint32_t handle = rigTokenHandle(kind, info[0].As<Napi::String>().Utf8Value());
+  if (handle == 0) {
+    Napi::TypeError::New(env, invalid).ThrowAsJavaScriptException();
+    return env.Null();
   }
-  
-  SetSplitAsyncWorker* asyncWorker = new SetSplitAsyncWorker(env, this, rx_vfo, split, tx_vfo);
-  asyncWorker->Queue();
-  return asyncWorker->GetPromise();
+  return Napi::Number::New(env, handle);
 }
 
-Napi::Value NodeHamLib::GetSplit(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::GetLevelHandle(const Napi::CallbackInfo & info) {
+  return tokenHandleFor(info, RigTokenKind::Level, "Expected (levelType: string)", "Invalid level type");
+}
+
+Napi::Value NodeHamLib::GetFunctionHandle(const Napi::CallbackInfo & info) {
+  return tokenHandleFor(info, RigTokenKind::Function, "Expected (functionType: string)", "Invalid function type");
+}
+
+std::shared_ptr<const RigCapabilitySnapshot> NodeHamLib::CapabilitySnapshot() const {
+  std::lock_guard<std::mutex> guard(capabilities_mutex_);
+  return capabilities_;
+}
+
+void NodeHamLib::SetCapabilitySnapshot(std::shared_ptr<const RigCapabilitySnapshot> snapshot) {
+  std::lock_guard<std::mutex> guard(capabilities_mutex_);
+  capabilities_ = std::move(snapshot);
+}
+
+// Served from the open-time snapshot without a worker when there is one;
+// otherwise captures it under the rig lock and keeps it if the rig is open.
+Napi::Value NodeHamLib::QueueCapabilityQuery(Napi::Env env, const char* operation,
+    std::function<Napi::Value(Napi::Env, const RigCapabilitySnapshot&)> build) {
+  if (std::shared_ptr<const RigCapabilitySnapshot> caps = CapabilitySnapshot()) {
+    return resolvedPromise(env, build(env, *caps));
+  }
+  auto captured = std::make_shared<std::shared_ptr<const RigCapabilitySnapshot>>();
+  return QueueLockedCallbackWorker(env, this, operation,
+    [captured](NodeHamLib* instance, int& result_code, std::string& error_message) {
+      (void)result_code;
+      (void)error_message;
+      *captured = RigCapabilitySnapshot::Capture(instance->my_rig);
+      if (instance->rig_is_open.load(std::memory_order_acquire)) {
+        instance->SetCapabilitySnapshot(*captured);
+      }
+    },
+    [captured, build](Napi::Env env) {
+      return build(env, **captured);
+    });
+}
+
+Napi::Value NodeHamLib::CapabilitySync(const Napi::CallbackInfo& info,
+    const std::function<Napi::Value(Napi::Env, const RigCapabilitySnapshot&)>& build) {
   Napi::Env env = info.Env();
-  
-  
-  int vfo = SHIM_RIG_VFO_CURR;
-  
-  if (info.Length() >= 1 && info[0].IsString()) {
-    // getSplit(vfo)
-    vfo = parseVfoParameter(info, 0, SHIM_RIG_VFO_CURR);
-    RETURN_NULL_IF_INVALID_VFO(vfo);
+  std::shared_ptr<const RigCapabilitySnapshot> caps = CapabilitySnapshot();
+  if (!caps) {
+    Napi::Error::New(env, "Capabilities are captured by open(); use the async variant before that").ThrowAsJavaScriptException();
+    return env.Null();
   }
-  // Otherwise use default SHIM_RIG_VFO_CURR for getSplit()
-  
-  GetSplitAsyncWorker* asyncWorker = new GetSplitAsyncWorker(env, this, vfo);
-  asyncWorker->Queue();
-  return asyncWorker->GetPromise();
+  return build(env, *caps);
+}
+
+static std::vector<std::string> supportedLevelNames(uint64_t levels) {
+  std::vector<std::string> values;
+  if (levels & SHIM_RIG_LEVEL_AF) values.push_back("AF");
+  if (levels & SHIM_RIG_LEVEL_PREAMP) values.push_back("PREAMP");
+  if (levels & SHIM_RIG_LEVEL_ATT) values.push_back("ATT");
+  if (levels & SHIM_RIG_LEVEL_RF) values.push_back("RF");
+  if (levels & SHIM_RIG_LEVEL_SQL) values.push_back("SQL");
+  if (levels & SHIM_RIG_LEVEL_RFPOWER) values.push_back("RFPOWER");
+  if (levels & SHIM_RIG_LEVEL_MICGAIN) values.push_back("MICGAIN");
+  if (levels & SHIM_RIG_LEVEL_IF) values.push_back("IF");
+  if (levels & SHIM_RIG_LEVEL_APF) values.push_back("APF");
+  if (levels & SHIM_RIG_LEVEL_NR) values.push_back("NR");
+  if (levels & SHIM_RIG_LEVEL_PBT_IN) values.push_back("PBT_IN");
+  if (levels & SHIM_RIG_LEVEL_PBT_OUT) values.push_back("PBT_OUT");
+  if (levels & SHIM_RIG_LEVEL_CWPITCH) values.push_back("CWPITCH");
+  if (levels & SHIM_RIG_LEVEL_KEYSPD) values.push_back("KEYSPD");
+  if (levels & SHIM_RIG_LEVEL_NOTCHF) values.push_back("NOTCHF");
+  if (levels & SHIM_RIG_LEVEL_COMP) values.push_back("COMP");
+  if (levels & SHIM_RIG_LEVEL_AGC) values.push_back("AGC");
+  if (levels & SHIM_RIG_LEVEL_BKINDL) values.push_back("BKINDL");
+  if (levels & SHIM_RIG_LEVEL_BALANCE) values.push_back("BALANCE");
+  if (levels & SHIM_RIG_LEVEL_VOXGAIN) values.push_back("VOXGAIN");
+  if (levels & SHIM_RIG_LEVEL_VOXDELAY) values.push_back("VOXDELAY");
+  if (levels & SHIM_RIG_LEVEL_ANTIVOX) values.push_back("ANTIVOX");
+  if (levels & SHIM_RIG_LEVEL_MONITOR_GAIN) values.push_back("MONITOR_GAIN");
+  if (levels & SHIM_RIG_LEVEL_STRENGTH) values.push_back("STRENGTH");
+  if (levels & SHIM_RIG_LEVEL_RAWSTR) values.push_back("RAWSTR");
+  if (levels & SHIM_RIG_LEVEL_SWR) values.push_back("SWR");
+  if (levels & SHIM_RIG_LEVEL_ALC) values.push_back("ALC");
+  if (levels & SHIM_RIG_LEVEL_RFPOWER_METER) values.push_back("RFPOWER_METER");
+  if (levels & SHIM_RIG_LEVEL_RFPOWER_METER_WATTS) values.push_back("RFPOWER_METER_WATTS");
+  if (levels & SHIM_RIG_LEVEL_COMP_METER) values.push_back("COMP_METER");
+  if (levels & SHIM_RIG_LEVEL_VD_METER) values.push_back("VD_METER");
+  if (levels & SHIM_RIG_LEVEL_ID_METER) values.push_back("ID_METER");
+  if (levels & SHIM_RIG_LEVEL_SPECTRUM_MODE) values.push_back("SPECTRUM_MODE");
+  if (levels & SHIM_RIG_LEVEL_SPECTRUM_SPAN) values.push_back("SPECTRUM_SPAN");
+  if (levels & SHIM_RIG_LEVEL_SPECTRUM_EDGE_LOW) values.push_back("SPECTRUM_EDGE_LOW");
+  if (levels & SHIM_RIG_LEVEL_SPECTRUM_EDGE_HIGH) values.push_back("SPECTRUM_EDGE_HIGH");
+  if (levels & SHIM_RIG_LEVEL_SPECTRUM_SPEED) values.push_back("SPECTRUM_SPEED");
+  if (levels & SHIM_RIG_LEVEL_SPECTRUM_REF) values.push_back("SPECTRUM_REF");
+  if (levels & SHIM_RIG_LEVEL_SPECTRUM_AVG) values.push_back("SPECTRUM_AVG");
+  if (levels & SHIM_RIG_LEVEL_SPECTRUM_ATT) values.push_back("SPECTRUM_ATT");
+  if (levels & SHIM_RIG_LEVEL_TEMP_METER) values.push_back("TEMP_METER");
+  return values;
+}
+
+static Napi::Value supportedLevelsValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return StringVectorToArray(env, supportedLevelNames(caps.levels));
+}
+
+Napi::Value NodeHamLib::GetSupportedLevels(const Napi::CallbackInfo& info) {
+  return QueueCapabilityQuery(info.Env(), "GetSupportedLevels", supportedLevelsValue);
+}
+
+Napi::Value NodeHamLib::GetSupportedLevelsSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, supportedLevelsValue);
 }
 
-// VFO Operations
-Napi::Value NodeHamLib::VfoOperation(const Napi::CallbackInfo & info) {
+
+// Function Controls
+Napi::Value NodeHamLib::SetFunction(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
   
   
-  if (info.Length() < 1 || !info[0].IsString()) {
-    Napi::TypeError::New(env, "Expected VFO operation string").ThrowAsJavaScriptException();
+  if (info.Length() < 2 || !isTokenValue(info[0]) || !info[1].IsBoolean()) {
+    Napi::TypeError::New(env, "Expected (functionType: string, enable: boolean)").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  std::string vfoOpStr = info[0].As<Napi::String>().Utf8Value();
+  bool enable = info[1].As<Napi::Boolean>().Value();
   
-  int vfo_op;
-  if (vfoOpStr == "CPY") {
-    vfo_op = SHIM_RIG_OP_CPY;
-  } else if (vfoOpStr == "XCHG") {
-    vfo_op = SHIM_RIG_OP_XCHG;
-  } else if (vfoOpStr == "FROM_VFO") {
-    vfo_op = SHIM_RIG_OP_FROM_VFO;
-  } else if (vfoOpStr == "TO_VFO") {
-    vfo_op = SHIM_RIG_OP_TO_VFO;
-  } else if (vfoOpStr == "MCL") {
-    vfo_op = SHIM_RIG_OP_MCL;
-  } else if (vfoOpStr == "UP") {
-    vfo_op = SHIM_RIG_OP_UP;
-  } else if (vfoOpStr == "DOWN") {
-    vfo_op = SHIM_RIG_OP_DOWN;
-  } else if (vfoOpStr == "BAND_UP") {
-    vfo_op = SHIM_RIG_OP_BAND_UP;
-  } else if (vfoOpStr == "BAND_DOWN") {
-    vfo_op = SHIM_RIG_OP_BAND_DOWN;
-  } else if (vfoOpStr == "LEFT") {
-    vfo_op = SHIM_RIG_OP_LEFT;
-  } else if (vfoOpStr == "RIGHT") {
-    vfo_op = SHIM_RIG_OP_RIGHT;
-  } else if (vfoOpStr == "TUNE") {
-    vfo_op = SHIM_RIG_OP_TUNE;
-  } else if (vfoOpStr == "TOGGLE") {
-    vfo_op = SHIM_RIG_OP_TOGGLE;
-  } else {
-    Napi::TypeError::New(env, "Invalid VFO operation").ThrowAsJavaScriptException();
+  uint64_t funcType;
+  if (!parseTokenValue(RigTokenKind::Function, info[0], &funcType)) {
+    Napi::TypeError::New(env, "Invalid function type").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  VfoOperationAsyncWorker* asyncWorker = new VfoOperationAsyncWorker(env, this, vfo_op);
-  asyncWorker->Queue();
-  return asyncWorker->GetPromise();
+  SetFunctionAsyncWorker* worker = new SetFunctionAsyncWorker(env, this, funcType, enable ? 1 : 0);
+  worker->Queue();
+  
+  return worker->GetPromise();
 }
 
-// Antenna Selection
-Napi::Value NodeHamLib::SetAntenna(const Napi::CallbackInfo & info) {
+Napi::Value NodeHamLib::GetFunction(const Napi::CallbackInfo & info) {
   Napi::Env env = info.Env();
   
   
-  if (info.Length() < 1 || !info[0].IsNumber()) {
-    Napi::TypeError::New(env, "Expected antenna number").ThrowAsJavaScriptException();
+  if (info.Length() < 1 || !isTokenValue(info[0])) {
+    Napi::TypeError::New(env, "Expected (functionType: string)").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  const int antennaOrdinal = info[0].As<Napi::Number>().Int32Value();
-  const int antenna = antennaOrdinalToMask(env, antennaOrdinal);
-  if (antenna == 0) {
+  uint64_t funcType;
+  if (!parseTokenValue(RigTokenKind::Function, info[0], &funcType)) {
+    Napi::TypeError::New(env, "Invalid function type").ThrowAsJavaScriptException();
     return env.Null();
   }
+  
+  return QueueCoalescedRead(env, coalesceKey("GetFunction", SHIM_RIG_VFO_CURR, funcType), [&]() -> HamLibAsyncWorker* {
+    return new GetFunctionAsyncWorker(env, this, funcType);
+  });
+}
+
 
+enum class BatchOp {
+  GetFrequency,
+  GetMode,
+  GetVfo,
+  GetPtt,
+  GetStrength,
+  GetLevel,
+  GetFunction,
+  SetFrequency,
+  SetMode,
+  SetPtt,
+  SetVfo,
+  SetLevel,
+  SetFunction,
+};
+
+struct BatchItem {
+  BatchOp op = BatchOp::GetFrequency;
+  std::string name;
+  // Level / function name as given, for the rigctld session protocol.
+  std::string token_name;
   int vfo = SHIM_RIG_VFO_CURR;
-  float option = 0.0f;
+  uint64_t token = 0;
+  double number = 0;
+  int mode = 0;
+  int width = SHIM_RIG_PASSBAND_NORMAL;
+  int passband_selector = 0;
+  int flag = 0;
+
+  int result_code = SHIM_RIG_OK;
+  double value = 0;
+  int int_value = 0;
+};
 
-  if (info.Length() >= 2) {
-    if (info[1].IsNumber()) {
-      option = info[1].As<Napi::Number>().FloatValue();
-      if (info.Length() >= 3 && info[2].IsString()) {
-        vfo = parseVfoParameter(info, 2, SHIM_RIG_VFO_CURR);
-        RETURN_NULL_IF_INVALID_VFO(vfo);
-      } else if (info.Length() >= 3 && !info[2].IsUndefined()) {
-        Napi::TypeError::New(env, "Expected VFO token as third argument").ThrowAsJavaScriptException();
-        return env.Null();
-      }
-    } else if (info[1].IsString()) {
-      vfo = parseVfoParameter(info, 1, SHIM_RIG_VFO_CURR);
-      RETURN_NULL_IF_INVALID_VFO(vfo);
-    } else if (!info[1].IsUndefined()) {
-      Napi::TypeError::New(env, "Expected antenna option as number or VFO token as string").ThrowAsJavaScriptException();
-      return env.Null();
+constexpr size_t kMaxBatchItems = 1024;
+
+// A batch that keys the transmitter runs in the Realtime class like setPtt();
+// any other batch is Interactive.
+static RigCommandPriority batchPriority(const std::vector<BatchItem>& items) {
+  for (const BatchItem& item : items) {
+    if (item.op == BatchOp::SetPtt) {
+      return RigCommandPriority::Realtime;
     }
   }
+  return RigCommandPriority::Interactive;
+}
 
-  if (info.Length() >= 3 && info[1].IsString()) {
-    Napi::TypeError::New(env, "Antenna option must come before VFO").ThrowAsJavaScriptException();
-    return env.Null();
+// Reads the optional `vfo` field of a batch entry; throws and returns
+// kInvalidVfoParameter on a bad token.
+static int parseBatchVfo(Napi::Env env, const Napi::Object& entry) {
+  if (!entry.Has("vfo") || entry.Get("vfo").IsUndefined() || entry.Get("vfo").IsNull()) {
+    return SHIM_RIG_VFO_CURR;
   }
-
-  SetAntennaAsyncWorker* asyncWorker = new SetAntennaAsyncWorker(env, this, antenna, vfo, option);
-  asyncWorker->Queue();
-  return asyncWorker->GetPromise();
+  if (!entry.Get("vfo").IsString()) {
+    Napi::TypeError::New(env, "VFO must be specified as a Hamlib VFO token string").ThrowAsJavaScriptException();
+    return kInvalidVfoParameter;
+  }
+  return parseVfoString(env, entry.Get("vfo").As<Napi::String>().Utf8Value());
 }
 
-Napi::Value NodeHamLib::GetAntenna(const Napi::CallbackInfo & info) {
-  Napi::Env env = info.Env();
-  
-  
-  // Support optional VFO parameter: getAntenna() or getAntenna(vfo)
-  int vfo = SHIM_RIG_VFO_CURR;
-  if (info.Length() >= 1 && info[0].IsString()) {
-    vfo = parseVfoParameter(info, 0, SHIM_RIG_VFO_CURR);
-    RETURN_NULL_IF_INVALID_VFO(vfo);
+// `prefix` locates the entry in error messages, e.g. "batch[3]: ".
+static bool parseBatchItem(Napi::Env env, const Napi::Object& entry, const std::string& prefix, BatchItem* item) {
+  if (!entry.Has("op") || !entry.Get("op").IsString()) {
+    Napi::TypeError::New(env, prefix + "expected { op: string }").ThrowAsJavaScriptException();
+    return false;
   }
-  
-  // Default antenna query (SHIM_RIG_ANT_CURR gets all antenna info)
-  int antenna = SHIM_RIG_ANT_CURR;
-  
-  GetAntennaAsyncWorker* asyncWorker = new GetAntennaAsyncWorker(env, this, vfo, antenna);
-  asyncWorker->Queue();
-  return asyncWorker->GetPromise();
-}
+  item->name = entry.Get("op").As<Napi::String>().Utf8Value();
+  const std::string& op = item->name;
 
-Napi::Function NodeHamLib::GetClass(Napi::Env env) {
-  auto ret =  DefineClass(
+  auto requireString = [&](const char* field, std::string* out) {
+    if (!entry.Has(field) || !entry.Get(field).IsString()) {
+      Napi::TypeError::New(env, prefix + op + " requires string field '" + field + "'").ThrowAsJavaScriptException();
+      return false;
+    }
+    *out = entry.Get(field).As<Napi::String>().Utf8Value();
+    return true;
+  };
+  auto requireNumber = [&](const char* field, double* out) {
+    if (!entry.Has(field) || !entry.Get(field).IsNumber()) {
+      Napi::TypeError::New(env, prefix + op + " requires number field '" + field + "'").ThrowAsJavaScriptException();
+      return false;
+    }
+    *out = entry.Get(field).As<Napi::Number>().DoubleValue();
+    return true;
+  };
+  auto requireBoolean = [&](const char* field, int* out) {
+    if (!entry.Has(field) || !entry.Get(field).IsBoolean()) {
+      Napi::TypeError::New(env, prefix + op + " requires boolean field '" + field + "'").ThrowAsJavaScriptException();
+      return false;
+    }
+    *out = entry.Get(field).As<Napi::Boolean>().Value() ? 1 : 0;
+    return true;
+  };
+
+  const bool usesVfo =
+    op == "getFrequency" || op == "getPtt" || op == "getStrength" || op == "getLevel" ||
+    op == "setFrequency" || op == "setMode" || op == "setLevel" || op == "setVfo";
+  if (usesVfo) {
+    item->vfo = parseBatchVfo(env, entry);
+    if (item->vfo == kInvalidVfoParameter) {
+      return false;
+    }
+  }
+
+  std::string text;
+  if (op == "getFrequency") {
+    item->op = BatchOp::GetFrequency;
+  } else if (op == "getMode") {
+    item->op = BatchOp::GetMode;
+  } else if (op == "getVfo") {
+    item->op = BatchOp::GetVfo;
+  } else if (op == "getPtt") {
+    item->op = BatchOp::GetPtt;
+  } else if (op == "getStrength") {
+    item->op = BatchOp::GetStrength;
+  } else if (op == "getLevel" || op == "setLevel") {
+    item->op = op == "getLevel" ? BatchOp::GetLevel : BatchOp::SetLevel;
+    if (!requireString("level", &text)) {
+      return false;
+    }
+    if (!parseLevelTypeString(text, &item->token)) {
+      Napi::TypeError::New(env, prefix + "Invalid level type").ThrowAsJavaScriptException();
+      return false;
+    }
+    item->token_name = text;
+    if (item->op == BatchOp::SetLevel && !requireNumber("value", &item->number)) {
+      return false;
+    }
+  } else if (op == "getFunction" || op == "setFunction") {
+    item->op = op == "getFunction" ? BatchOp::GetFunction : BatchOp::SetFunction;
+    if (!requireString("function", &text)) {
+      return false;
+    }
+    if (!parseFunctionTypeString(text, &item->token)) {
+      Napi::TypeError::New(env, prefix + "Invalid function type").ThrowAsJavaScriptException();
+      return false;
+    }
+    item->token_name = text;
+    if (item->op == BatchOp::SetFunction && !requireBoolean("enable", &item->flag)) {
+      return false;
+    }
+  } else if (op == "setFrequency") {
+    item->op = BatchOp::SetFrequency;
+    if (!requireNumber("frequency", &item->number)) {
+      return false;
+    }
+    if (item->number < 1000 || item->number > 10000000000) {
+      Napi::Error::New(env, prefix + "Frequency out of range (1 kHz - 10 GHz)").ThrowAsJavaScriptException();
+      return false;
+    }
+  } else if (op == "setMode") {
+    item->op = BatchOp::SetMode;
+    if (!requireString("mode", &text)) {
+      return false;
+    }
+    item->mode = shim_rig_parse_mode(text.c_str());
+    if (item->mode == SHIM_RIG_MODE_NONE) {
+      Napi::Error::New(env, prefix + "Invalid mode: " + text).ThrowAsJavaScriptException();
+      return false;
+    }
+    if (entry.Has("bandwidth") && !entry.Get("bandwidth").IsUndefined()) {
+      Napi::Value bandwidth = entry.Get("bandwidth");
+      if (bandwidth.IsNumber()) {
+        item->width = bandwidth.As<Napi::Number>().Int32Value();
+      } else if (bandwidth.IsString()) {
+        const std::string selector = bandwidth.As<Napi::String>().Utf8Value();
+        if (selector == "narrow" || selector == "wide") {
+          item->passband_selector = selector == "narrow" ? 1 : 2;
+        } else if (selector == "nochange") {
+          item->width = SHIM_RIG_PASSBAND_NOCHANGE;
+        } else if (selector != "normal") {
+          Napi::TypeError::New(env, prefix + "Bandwidth must be 'narrow', 'wide', 'normal', 'nochange' or a number")
+            .ThrowAsJavaScriptException();
+          return false;
+        }
+      } else {
+        Napi::TypeError::New(env, prefix + "Bandwidth must be a string selector or numeric passband width")
+          .ThrowAsJavaScriptException();
+        return false;
+      }
+    }
+  } else if (op == "setPtt") {
+    item->op = BatchOp::SetPtt;
+    if (!requireBoolean("ptt", &item->flag)) {
+      return false;
+    }
+  } else if (op == "setVfo") {
+    item->op = BatchOp::SetVfo;
+    if (!entry.Has("vfo") || !entry.Get("vfo").IsString()) {
+      Napi::TypeError::New(env, prefix + "setVfo requires string field 'vfo'").ThrowAsJavaScriptException();
+      return false;
+    }
+  } else {
+    Napi::TypeError::New(env, prefix + "Unsupported batch op: " + op).ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+static int executeBatchItem(hamlib_shim_handle_t rig, BatchItem& item) {
+  switch (item.op) {
+    case BatchOp::GetFrequency:
+      return shim_rig_get_freq(rig, item.vfo, &item.value);
+    case BatchOp::GetMode:
+      return shim_rig_get_mode(rig, SHIM_RIG_VFO_CURR, &item.mode, &item.int_value);
+    case BatchOp::GetVfo:
+      return shim_rig_get_vfo(rig, &item.int_value);
+    case BatchOp::GetPtt:
+      return shim_rig_get_ptt(rig, item.vfo, &item.int_value);
+    case BatchOp::GetStrength:
+      return shim_rig_get_strength(rig, item.vfo, &item.int_value);
+    case BatchOp::GetLevel:
+      return shim_rig_get_level_auto(rig, item.vfo, item.token, &item.value);
+    case BatchOp::GetFunction:
+      return shim_rig_get_func(rig, SHIM_RIG_VFO_CURR, item.token, &item.int_value);
+    case BatchOp::SetFrequency:
+      return shim_rig_set_freq(rig, item.vfo, item.number);
+    case BatchOp::SetMode:
+      if (item.passband_selector == 1) {
+        item.width = shim_rig_passband_narrow(rig, item.mode);
+      } else if (item.passband_selector == 2) {
+        item.width = shim_rig_passband_wide(rig, item.mode);
+      }
+      return shim_rig_set_mode(rig, item.vfo, item.mode, item.width);
+    case BatchOp::SetPtt:
+      return shim_rig_set_ptt(rig, SHIM_RIG_VFO_CURR, item.flag ? SHIM_RIG_PTT_ON : SHIM_RIG_PTT_OFF);
+    case BatchOp::SetVfo:
+      return shim_rig_set_vfo(rig, item.vfo);
+    case BatchOp::SetLevel:
+      if (shim_rig_level_is_float(item.token)) {
+        return shim_rig_set_level_f(rig, item.vfo, item.token, static_cast<float>(item.number));
+      }
+      return shim_rig_set_level_i(rig, item.vfo, item.token, static_cast<int>(item.number));
+    case BatchOp::SetFunction:
+      return shim_rig_set_func(rig, SHIM_RIG_VFO_CURR, item.token, item.flag);
+  }
+  return SHIM_RIG_EINVAL;
+}
+
+// Mirrors an executed batch / poll item into the rig's state cache.
+static void noteBatchItemInStateCache(RigStateCache& cache, const BatchItem& item) {
+  const bool isSet = item.op == BatchOp::SetFrequency || item.op == BatchOp::SetMode || item.op == BatchOp::SetVfo;
+  if (item.result_code != SHIM_RIG_OK) {
+    if (isSet) {
+      cache.Invalidate();
+    }
+    return;
+  }
+  switch (item.op) {
+    case BatchOp::GetFrequency:
+      cache.StoreFrequency(item.vfo, item.value);
+      break;
+    case BatchOp::GetMode:
+      cache.StoreMode(SHIM_RIG_VFO_CURR, item.mode, item.int_value);
+      break;
+    case BatchOp::GetVfo:
+      cache.StoreVfo(item.int_value);
+      break;
+    case BatchOp::SetFrequency:
+      cache.StoreFrequency(item.vfo, item.number);
+      break;
+    case BatchOp::SetMode:
+      cache.StoreMode(item.vfo, item.mode, item.width);
+      break;
+    case BatchOp::SetVfo:
+      cache.StoreVfo(item.vfo);
+      break;
+    default:
+      break;
+  }
+}
+
+static Napi::Value batchItemValue(Napi::Env env, const BatchItem& item) {
+  switch (item.op) {
+    case BatchOp::GetFrequency:
+    case BatchOp::GetLevel:
+      return Napi::Number::New(env, item.value);
+    case BatchOp::GetMode: {
+      Napi::Object obj = Napi::Object::New(env);
+      obj.Set("mode", Napi::String::New(env, shim_rig_strrmode(item.mode)));
+      obj.Set("bandwidth", Napi::Number::New(env, item.int_value));
+      return obj;
+    }
+    case BatchOp::GetVfo:
+      return Napi::String::New(env, publicVfoToken(item.int_value));
+    case BatchOp::GetPtt:
+      return Napi::Boolean::New(env, item.int_value == SHIM_RIG_PTT_ON);
+    case BatchOp::GetStrength:
+      return Napi::Number::New(env, item.int_value);
+    case BatchOp::GetFunction:
+      return Napi::Boolean::New(env, item.int_value != 0);
+    default:
+      return Napi::Number::New(env, item.result_code);
+  }
+}
+
+static bool isBatchReadOp(BatchOp op) {
+  switch (op) {
+    case BatchOp::GetFrequency:
+    case BatchOp::GetMode:
+    case BatchOp::GetVfo:
+    case BatchOp::GetPtt:
+    case BatchOp::GetStrength:
+    case BatchOp::GetLevel:
+    case BatchOp::GetFunction:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static Napi::Array batchResultsToArray(Napi::Env env, const std::vector<BatchItem>& items) {
+  Napi::Array results = Napi::Array::New(env, items.size());
+  for (size_t i = 0; i < items.size(); ++i) {
+    const BatchItem& item = items[i];
+    Napi::Object entry = Napi::Object::New(env);
+    entry.Set("op", Napi::String::New(env, item.name));
+    if (item.result_code == SHIM_RIG_OK) {
+      entry.Set("ok", Napi::Boolean::New(env, true));
+      entry.Set("value", batchItemValue(env, item));
+    } else {
+      entry.Set("ok", Napi::Boolean::New(env, false));
+      entry.Set("code", Napi::String::New(env, "HAMLIB_ERROR"));
+      entry.Set("hamlibCode", Napi::Number::New(env, item.result_code));
+      entry.Set("message", Napi::String::New(env, shim_rigerror(item.result_code)));
+    }
+    results[static_cast<uint32_t>(i)] = entry;
+  }
+  return results;
+}
+
+static std::string formatRigctldNumber(double value) {
+  char text[64];
+  snprintf(text, sizeof(text), "%.15g", value);
+  return text;
+}
+
+// The rigctld protocol line for a batch item. With `vfoMode` (rigctld
+// --vfo) every get/set except the VFO commands names its VFO first.
+static RigctldRequest rigctldBatchRequest(const BatchItem& item, bool vfoMode) {
+  const std::string vfo = vfoMode ? std::string(" ") + shim_rig_strvfo(item.vfo) : std::string();
+  RigctldRequest request;
+  switch (item.op) {
+    case BatchOp::GetFrequency:
+      request.command = "f" + vfo;
+      break;
+    case BatchOp::GetMode:
+      request.command = "m" + vfo;
+      request.reply_lines = 2;
+      break;
+    case BatchOp::GetVfo:
+      request.command = "v";
+      break;
+    case BatchOp::GetPtt:
+      request.command = "t" + vfo;
+      break;
+    case BatchOp::GetStrength:
+      request.command = "l" + vfo + " STRENGTH";
+      break;
+    case BatchOp::GetLevel:
+      request.command = "l" + vfo + " " + item.token_name;
+      break;
+    case BatchOp::GetFunction:
+      request.command = "u" + vfo + " " + item.token_name;
+      break;
+    case BatchOp::SetFrequency:
+      request.command = "F" + vfo + " " + formatRigctldNumber(item.number);
+      break;
+    case BatchOp::SetMode:
+      request.command = "M" + vfo + " " + shim_rig_strrmode(item.mode) + " " + std::to_string(item.width);
+      break;
+    case BatchOp::SetPtt:
+      request.command = "T" + vfo + (item.flag ? " 1" : " 0");
+      break;
+    case BatchOp::SetVfo:
+      request.command = std::string("V ") + shim_rig_strvfo(item.vfo);
+      break;
+    case BatchOp::SetLevel:
+      request.command = "L" + vfo + " " + item.token_name + " "
+        + (shim_rig_level_is_float(item.token) ? formatRigctldNumber(item.number)
+                                               : std::to_string(static_cast<int>(item.number)));
+      break;
+    case BatchOp::SetFunction:
+      request.command = "U" + vfo + " " + item.token_name + (item.flag ? " 1" : " 0");
+      break;
+  }
+  return request;
+}
+
+// Parses a rigctld reply into the item the way executeBatchItem() fills it.
+static void applyRigctldReply(BatchItem& item, const RigctldReply& reply) {
+  item.result_code = reply.result_code;
+  if (item.result_code != SHIM_RIG_OK || !isBatchReadOp(item.op)) {
+    return;
+  }
+  if (reply.lines.empty()) {
+    item.result_code = SHIM_RIG_EPROTO;
+    return;
+  }
+  const std::string& first = reply.lines[0];
+  switch (item.op) {
+    case BatchOp::GetFrequency:
+    case BatchOp::GetLevel:
+      item.value = std::atof(first.c_str());
+      break;
+    case BatchOp::GetMode:
+      item.mode = shim_rig_parse_mode(first.c_str());
+      item.int_value = reply.lines.size() > 1 ? std::atoi(reply.lines[1].c_str()) : 0;
+      break;
+    case BatchOp::GetVfo:
+      item.int_value = shim_rig_parse_vfo(first.c_str());
+      break;
+    case BatchOp::GetPtt:
+    case BatchOp::GetStrength:
+    case BatchOp::GetFunction:
+      item.int_value = std::atoi(first.c_str());
+      break;
+    default:
+      break;
+  }
+}
+
+// A batch sent through the shared rigctld session. With continueOnError
+// every item goes out in one pipelined group; otherwise items go one group
+// at a time so nothing runs after the first failure, as in the locked path.
+struct SessionBatch {
+  explicit SessionBatch(Napi::Env env) : deferred(Napi::Promise::Deferred::New(env)) {}
+
+  NodeHamLib* instance = nullptr;
+  Napi::ObjectReference self;
+  Napi::Promise::Deferred deferred;
+  std::vector<BatchItem> items;
+  bool continue_on_error = true;
+  size_t next = 0;
+  // Set for a HamLibGroup member, which reports here instead of `deferred`.
+  RigGroupDone group_done;
+  int64_t started_us = 0;
+};
+
+static Napi::Error sessionBatchError(Napi::Env env, const std::string& message, const char* code, int hamlib_code) {
+  Napi::Error error = Napi::Error::New(env, message);
+  error.Set("code", Napi::String::New(env, code));
+  if (hamlib_code != SHIM_RIG_OK) {
+    error.Set("hamlibCode", Napi::Number::New(env, hamlib_code));
+  }
+  error.Set("operation", Napi::String::New(env, "Batch"));
+  return error;
+}
+
+static size_t failedBatchItems(const std::vector<BatchItem>& items) {
+  return static_cast<size_t>(std::count_if(items.begin(), items.end(),
+    [](const BatchItem& item) { return item.result_code != SHIM_RIG_OK; }));
+}
+
+static void settleSessionBatch(Napi::Env env, const std::shared_ptr<SessionBatch>& batch, bool resolved,
+                               Napi::Value value) {
+  if (!batch->group_done) {
+    if (resolved) {
+      batch->deferred.Resolve(value);
+    } else {
+      batch->deferred.Reject(value);
+    }
+    return;
+  }
+  RigGroupOutcome outcome;
+  outcome.resolved = resolved;
+  outcome.value = value;
+  outcome.failed_items = resolved ? failedBatchItems(batch->items) : 0;
+  outcome.started_us = batch->started_us;
+  outcome.applied_us = resolved ? rigMetricsNowMicros() : 0;
+  batch->group_done(env, outcome);
+}
+
+static void runSessionBatch(Napi::Env env, std::shared_ptr<SessionBatch> batch) {
+  if (batch->next >= batch->items.size()) {
+    settleSessionBatch(env, batch, true, batchResultsToArray(env, batch->items));
+    return;
+  }
+  RigctldSessionClient* client = batch->instance->session_client_.get();
+  if (!client) {
+    settleSessionBatch(env, batch, false,
+      sessionBatchError(env, "Shared rigctld session was closed", kSessionErrorCode, SHIM_RIG_OK).Value());
+    return;
+  }
+  const size_t first = batch->next;
+  const size_t last = batch->continue_on_error ? batch->items.size() : first + 1;
+  const bool vfoMode = client->Session().VfoMode();
+  std::vector<RigctldRequest> requests;
+  requests.reserve(last - first);
+  for (size_t i = first; i < last; ++i) {
+    requests.push_back(rigctldBatchRequest(batch->items[i], vfoMode));
+  }
+  batch->next = last;
+  client->Submit(std::move(requests),
+    [batch, first](Napi::Env env, std::vector<RigctldReply>& replies, const std::string& error) {
+      if (!error.empty()) {
+        settleSessionBatch(env, batch, false, sessionBatchError(env, error, kSessionErrorCode, SHIM_RIG_OK).Value());
+        return;
+      }
+      for (size_t i = 0; i < replies.size(); ++i) {
+        BatchItem& item = batch->items[first + i];
+        applyRigctldReply(item, replies[i]);
+        noteBatchItemInStateCache(batch->instance->state_cache_, item);
+        if (item.result_code != SHIM_RIG_OK && !batch->continue_on_error) {
+          settleSessionBatch(env, batch, false, sessionBatchError(env, item.name + ": " + shim_rigerror(item.result_code),
+            "HAMLIB_ERROR", item.result_code).Value());
+          return;
+        }
+      }
+      runSessionBatch(env, batch);
+    });
+}
+
+struct RigBatchPlan {
+  std::vector<BatchItem> items;
+};
+
+std::shared_ptr<const RigBatchPlan> NodeHamLib::ParseBatchPlan(Napi::Env env, const Napi::Array& operations) {
+  if (operations.Length() > kMaxBatchItems) {
+    Napi::RangeError::New(env, "Batch is limited to " + std::to_string(kMaxBatchItems) + " operations")
+      .ThrowAsJavaScriptException();
+    return nullptr;
+  }
+  auto plan = std::make_shared<RigBatchPlan>();
+  plan->items.resize(operations.Length());
+  for (uint32_t i = 0; i < operations.Length(); ++i) {
+    Napi::Value entry = operations.Get(i);
+    if (!entry.IsObject()) {
+      Napi::TypeError::New(env, "batch[" + std::to_string(i) + "]: expected { op: string }").ThrowAsJavaScriptException();
+      return nullptr;
+    }
+    if (!parseBatchItem(env, entry.As<Napi::Object>(), "batch[" + std::to_string(i) + "]: ", &plan->items[i])) {
+      return nullptr;
+    }
+  }
+  return plan;
+}
+
+// Why the shared session cannot run `items`, or empty.
+static std::string sessionUnsupportedBatchItem(const std::vector<BatchItem>& items) {
+  for (size_t i = 0; i < items.size(); ++i) {
+    if (items[i].passband_selector != 0) {
+      return "batch[" + std::to_string(i)
+        + "]: narrow/wide bandwidth needs the rig's caps and is not available over a shared session";
+    }
+  }
+  return std::string();
+}
+
+// One rig's share of a HamLibGroup call: batch() under the rig's own lock
+// and executor, reporting to the group instead of through its own promise.
+class GroupBatchAsyncWorker : public HamLibAsyncWorker {
+public:
+    GroupBatchAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance, std::vector<BatchItem> items,
+                          bool continue_on_error, RigGroupDone done)
+        : HamLibAsyncWorker(env, hamlib_instance), items_(std::move(items)),
+          continue_on_error_(continue_on_error), done_(std::move(done)) {}
+
+    const char* OperationName() const override { return "GroupBatch"; }
+    RigCommandPriority DefaultPriority() const override { return batchPriority(items_); }
+
+    void ExecuteWithRigLock() override {
+        CHECK_RIG_VALID();
+        started_us_ = rigMetricsNowMicros();
+        for (BatchItem& item : items_) {
+            item.result_code = executeBatchItem(hamlib_instance_->my_rig, item);
+            noteBatchItemInStateCache(hamlib_instance_->state_cache_, item);
+            if (item.result_code != SHIM_RIG_OK && !continue_on_error_) {
+                result_code_ = item.result_code;
+                error_message_ = item.name + ": " + shim_rigerror(item.result_code);
+                return;
+            }
+        }
+        applied_us_ = rigMetricsNowMicros();
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        if (result_code_ != SHIM_RIG_OK || !error_message_.empty()) {
+            Report(env, error_message_.empty() ? shim_rigerror(result_code_) : error_message_);
+            return;
+        }
+        RigGroupOutcome outcome;
+        outcome.resolved = true;
+        outcome.value = batchResultsToArray(env, items_);
+        outcome.failed_items = failedBatchItems(items_);
+        outcome.started_us = started_us_;
+        outcome.applied_us = applied_us_;
+        done_(env, outcome);
+        deferred_.Resolve(env.Undefined());
+    }
+
+    void OnError(const Napi::Error& e) override {
+        Report(Env(), error_message_.empty() ? e.Message() : error_message_);
+    }
+
+private:
+    void Report(Napi::Env env, const std::string& message) {
+        RigGroupOutcome outcome;
+        outcome.value = DecorateErrorValue(Napi::Error::New(env, message).Value());
+        outcome.started_us = started_us_;
+        done_(env, outcome);
+        // Nobody observes this worker's own promise; settle it so the trace
+        // and the instance reference are released as usual.
+        deferred_.Resolve(env.Undefined());
+    }
+
+    std::vector<BatchItem> items_;
+    bool continue_on_error_;
+    RigGroupDone done_;
+    int64_t started_us_ = 0;
+    int64_t applied_us_ = 0;
+};
+
+void NodeHamLib::QueueBatchPlan(Napi::Env env, const std::shared_ptr<const RigBatchPlan>& plan, bool continue_on_error,
+                                RigGroupDone done) {
+  if (session_client_) {
+    const std::string unsupported = sessionUnsupportedBatchItem(plan->items);
+    if (!unsupported.empty()) {
+      RigGroupOutcome outcome;
+      outcome.value = Napi::TypeError::New(env, unsupported).Value();
+      done(env, outcome);
+      return;
+    }
+    auto batch = std::make_shared<SessionBatch>(env);
+    batch->instance = this;
+    batch->self = Napi::Persistent(Value());
+    batch->items = plan->items;
+    batch->continue_on_error = continue_on_error;
+    batch->group_done = std::move(done);
+    batch->started_us = rigMetricsNowMicros();
+    runSessionBatch(env, batch);
+    return;
+  }
+  auto* worker = new GroupBatchAsyncWorker(env, this, plan->items, continue_on_error, std::move(done));
+  worker->Queue();
+}
+
+Napi::Value NodeHamLib::Batch(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected (operations: Array<{ op: string }>, options?: { continueOnError?: boolean })")
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  bool continue_on_error = true;
+  if (info.Length() >= 2 && info[1].IsObject()) {
+    Napi::Object options = info[1].As<Napi::Object>();
+    if (options.Has("continueOnError")) {
+      if (!options.Get("continueOnError").IsBoolean()) {
+        Napi::TypeError::New(env, "continueOnError must be a boolean").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      continue_on_error = options.Get("continueOnError").As<Napi::Boolean>().Value();
+    }
+  }
+
+  std::shared_ptr<const RigBatchPlan> plan = ParseBatchPlan(env, info[0].As<Napi::Array>());
+  if (!plan) {
+    return env.Null();
+  }
+  auto items = std::make_shared<std::vector<BatchItem>>(plan->items);
+
+  if (session_client_) {
+    const std::string unsupported = sessionUnsupportedBatchItem(*items);
+    if (!unsupported.empty()) {
+      Napi::TypeError::New(env, unsupported).ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    auto batch = std::make_shared<SessionBatch>(env);
+    batch->instance = this;
+    batch->self = Napi::Persistent(info.This().As<Napi::Object>());
+    batch->items = std::move(*items);
+    batch->continue_on_error = continue_on_error;
+    runSessionBatch(env, batch);
+    return batch->deferred.Promise();
+  }
+
+  // All items run back to back under one rig lock acquisition.
+  const RigCommandPriority priority = batchPriority(*items);
+  return QueueLockedCallbackWorker(env, this, "Batch",
+    [items, continue_on_error](NodeHamLib* instance, int& result_code, std::string& error_message) {
+      for (BatchItem& item : *items) {
+        item.result_code = executeBatchItem(instance->my_rig, item);
+        noteBatchItemInStateCache(instance->state_cache_, item);
+        if (item.result_code != SHIM_RIG_OK && !continue_on_error) {
+          result_code = item.result_code;
+          error_message = item.name + ": " + shim_rigerror(item.result_code);
+          return;
+        }
+      }
+    },
+    [items](Napi::Env env) -> Napi::Value {
+      return batchResultsToArray(env, *items);
+    },
+    true, priority);
+}
+
+// ===== Shared rigctld session =====
+
+constexpr double kDefaultSessionTimeoutMs = 5000;
+
+// Connects off the JS thread; the client (and its TSFN) is created on it.
+class SharedSessionOpenAsyncWorker : public Napi::AsyncWorker {
+public:
+    SharedSessionOpenAsyncWorker(Napi::Env env, NodeHamLib* instance, Napi::Object self,
+                                 std::string address, std::chrono::milliseconds timeout)
+        : Napi::AsyncWorker(env), deferred_(Napi::Promise::Deferred::New(env)),
+          self_(Napi::Persistent(self)), instance_(instance), address_(std::move(address)),
+          timeout_(timeout) {}
+
+    void Execute() override {
+        std::string error;
+        session_ = RigctldSession::Acquire(address_, timeout_, &error);
+        if (!session_) {
+            SetError(error);
+        }
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        instance_->session_client_.reset(new RigctldSessionClient(env, session_));
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("address", Napi::String::New(env, session_->Address()));
+        obj.Set("vfoMode", Napi::Boolean::New(env, session_->VfoMode()));
+        obj.Set("clients", Napi::Number::New(env, static_cast<double>(session_->GetStats().clients)));
+        deferred_.Resolve(obj);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        Napi::Error rejected = error;
+        rejected.Set("code", Napi::String::New(Env(), kSessionErrorCode));
+        rejected.Set("operation", Napi::String::New(Env(), "OpenSharedSession"));
+        deferred_.Reject(rejected.Value());
+    }
+
+    Napi::Promise GetPromise() { return deferred_.Promise(); }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    Napi::ObjectReference self_;
+    NodeHamLib* instance_;
+    std::string address_;
+    std::chrono::milliseconds timeout_;
+    std::shared_ptr<RigctldSession> session_;
+};
+
+Napi::Value NodeHamLib::OpenSharedSession(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  if (!is_network_rig) {
+    Napi::Error::New(env, "Shared sessions need a network rig (rigctld host:port)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  double timeoutMs = kDefaultSessionTimeoutMs;
+  if (info.Length() >= 1 && info[0].IsObject()) {
+    Napi::Object options = info[0].As<Napi::Object>();
+    if (options.Has("timeoutMs") && !options.Get("timeoutMs").IsUndefined()) {
+      if (!options.Get("timeoutMs").IsNumber()) {
+        Napi::TypeError::New(env, "timeoutMs must be a number").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      timeoutMs = options.Get("timeoutMs").As<Napi::Number>().DoubleValue();
+      if (!(timeoutMs >= 100 && timeoutMs <= 600000)) {
+        Napi::RangeError::New(env, "timeoutMs must be between 100 and 600000").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+    }
+  } else if (info.Length() >= 1 && !info[0].IsUndefined()) {
+    Napi::TypeError::New(env, "Expected (options?: { timeoutMs?: number })").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  auto* worker = new SharedSessionOpenAsyncWorker(env, this, info.This().As<Napi::Object>(), port_path,
+    std::chrono::milliseconds(static_cast<int64_t>(timeoutMs)));
+  Napi::Promise promise = worker->GetPromise();
+  worker->Queue();
+  return promise;
+}
+
+Napi::Value NodeHamLib::CloseSharedSession(const Napi::CallbackInfo & info) {
+  // Batches already submitted still settle; the connection closes with its
+  // last client.
+  session_client_.reset();
+  return info.Env().Undefined();
+}
+
+Napi::Value NodeHamLib::GetSharedSessionStats(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  if (!session_client_) {
+    return env.Null();
+  }
+  const RigctldSessionStats stats = session_client_->Session().GetStats();
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("address", Napi::String::New(env, stats.address));
+  obj.Set("connected", Napi::Boolean::New(env, stats.connected));
+  obj.Set("vfoMode", Napi::Boolean::New(env, stats.vfo_mode));
+  obj.Set("clients", Napi::Number::New(env, static_cast<double>(stats.clients)));
+  obj.Set("groups", Napi::Number::New(env, static_cast<double>(stats.groups)));
+  obj.Set("commands", Napi::Number::New(env, static_cast<double>(stats.commands)));
+  obj.Set("errors", Napi::Number::New(env, static_cast<double>(stats.errors)));
+  obj.Set("inflight", Napi::Number::New(env, static_cast<double>(stats.inflight)));
+  obj.Set("maxInflight", Napi::Number::New(env, static_cast<double>(stats.max_inflight)));
+  obj.Set("latency", latencyHistogramToObject(env, stats.latency));
+  return obj;
+}
+
+// ===== Native poll scheduler =====
+
+constexpr double kMinPollIntervalMs = 10;
+constexpr double kMaxPollIntervalMs = 3600000;
+constexpr double kDefaultPollIntervalMs = 1000;
+// The poll thread waits for the rig lock in slices so Stop() (on the JS
+// thread) is not held up, and never longer than kMaxPollLockWait per round
+// however long the interval is.
+constexpr std::chrono::milliseconds kPollLockSlice(100);
+constexpr std::chrono::milliseconds kMaxPollLockWait(1000);
+
+struct PollItem {
+  BatchItem read;
+  std::string key;
+  std::chrono::milliseconds interval{1000};
+  std::chrono::steady_clock::time_point next_due;
+  bool has_last = false;
+  BatchItem last;
+};
+
+struct PollSubscription {
+  uint32_t id = 0;
+  std::vector<PollItem> items;
+};
+
+struct PollRead {
+  uint32_t subscription_id = 0;
+  size_t index = 0;
+  BatchItem item;
+};
+
+struct PollChange {
+  uint32_t subscription_id = 0;
+  size_t index = 0;
+  std::string key;
+  BatchItem current;
+  bool has_previous = false;
+  BatchItem previous;
+  double timestamp = 0;
+};
+
+static bool samePollReading(const BatchItem& a, const BatchItem& b) {
+  if (a.result_code != b.result_code) {
+    return false;
+  }
+  if (a.result_code != SHIM_RIG_OK) {
+    return true;
+  }
+  switch (a.op) {
+    case BatchOp::GetFrequency:
+    case BatchOp::GetLevel:
+      return a.value == b.value;
+    case BatchOp::GetMode:
+      return a.mode == b.mode && a.int_value == b.int_value;
+    default:
+      return a.int_value == b.int_value;
+  }
+}
+
+static Napi::Object pollChangeToObject(Napi::Env env, const PollChange& change) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("key", Napi::String::New(env, change.key));
+  obj.Set("op", Napi::String::New(env, change.current.name));
+  obj.Set("index", Napi::Number::New(env, static_cast<double>(change.index)));
+  obj.Set("timestamp", Napi::Number::New(env, change.timestamp));
+  if (change.current.result_code == SHIM_RIG_OK) {
+    obj.Set("ok", Napi::Boolean::New(env, true));
+    obj.Set("value", batchItemValue(env, change.current));
+  } else {
+    obj.Set("ok", Napi::Boolean::New(env, false));
+    obj.Set("code", Napi::String::New(env, "HAMLIB_ERROR"));
+    obj.Set("hamlibCode", Napi::Number::New(env, change.current.result_code));
+    obj.Set("message", Napi::String::New(env, shim_rigerror(change.current.result_code)));
+  }
+  if (change.has_previous && change.previous.result_code == SHIM_RIG_OK) {
+    obj.Set("previous", batchItemValue(env, change.previous));
+  }
+  return obj;
+}
+
+// One native thread per rig that reads due get* items under the rig's I/O
+// lock, diffs each reading against the last one and hands only the changes to
+// JS, one ThreadSafeFunction call per poll round across all subscriptions.
+class RigPollScheduler : public std::enable_shared_from_this<RigPollScheduler> {
+public:
+    explicit RigPollScheduler(NodeHamLib* instance) : instance_(instance) {}
+
+    ~RigPollScheduler() {
+        Stop();
+    }
+
+    void Start(Napi::Env env) {
+        Napi::Function noop = Napi::Function::New(env, [](const Napi::CallbackInfo&) {});
+        tsfn_ = Napi::ThreadSafeFunction::New(env, noop, "HamLibPollScheduler", 0, 1);
+        // Only active subscriptions keep the event loop alive.
+        tsfn_.Unref(env);
+        thread_ = std::thread([this]() { ThreadMain(); });
+    }
+
+    uint32_t Add(Napi::Env env, std::vector<PollItem> items, Napi::Function callback) {
+        const uint32_t id = next_id_++;
+        callbacks_[id] = Napi::Persistent(callback);
+        if (callbacks_.size() == 1) {
+            tsfn_.Ref(env);
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        for (PollItem& item : items) {
+            item.next_due = now;
+        }
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            PollSubscription subscription;
+            subscription.id = id;
+            subscription.items = std::move(items);
+            subscriptions_.push_back(std::move(subscription));
+            wake_ = true;
+        }
+        cv_.notify_one();
+        return id;
+    }
+
+    bool Remove(Napi::Env env, uint32_t id) {
+        if (callbacks_.erase(id) == 0) {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            subscriptions_.erase(
+                std::remove_if(subscriptions_.begin(), subscriptions_.end(),
+                    [id](const PollSubscription& subscription) { return subscription.id == id; }),
+                subscriptions_.end());
+            wake_ = true;
+        }
+        cv_.notify_one();
+        if (callbacks_.empty()) {
+            tsfn_.Unref(env);
+        }
+        return true;
+    }
+
+    bool RemoveAll(Napi::Env env) {
+        if (callbacks_.empty()) {
+            return false;
+        }
+        callbacks_.clear();
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            subscriptions_.clear();
+            wake_ = true;
+        }
+        cv_.notify_one();
+        tsfn_.Unref(env);
+        return true;
+    }
+
+    // Joins the poll thread; a round already talking to the rig finishes first.
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            if (stopping_) {
+                return;
+            }
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        if (tsfn_) {
+            tsfn_.Release();
+        }
+    }
+
+private:
+    void ThreadMain() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            auto wakeRequested = [this]() { return stopping_ || wake_; };
+            if (subscriptions_.empty()) {
+                cv_.wait(lock, wakeRequested);
+                wake_ = false;
+                continue;
+            }
+            if (cv_.wait_until(lock, NextDueLocked(), wakeRequested)) {
+                wake_ = false;
+                continue;
+            }
+
+            std::chrono::milliseconds lockTimeout(0);
+            std::vector<PollRead> reads = CollectDueLocked(std::chrono::steady_clock::now(), &lockTimeout);
+            lock.unlock();
+            const bool sampled = RunReads(reads, lockTimeout);
+            const double timestamp = static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+            lock.lock();
+            if (sampled) {
+                DiffLocked(reads, timestamp);
+            }
+        }
+    }
+
+    std::chrono::steady_clock::time_point NextDueLocked() const {
+        auto next = std::chrono::steady_clock::time_point::max();
+        for (const PollSubscription& subscription : subscriptions_) {
+            for (const PollItem& item : subscription.items) {
+                next = std::min(next, item.next_due);
+            }
+        }
+        return next;
+    }
+
+    std::vector<PollRead> CollectDueLocked(std::chrono::steady_clock::time_point now,
+                                           std::chrono::milliseconds* lockTimeout) {
+        std::vector<PollRead> reads;
+        for (PollSubscription& subscription : subscriptions_) {
+            for (size_t i = 0; i < subscription.items.size(); ++i) {
+                PollItem& item = subscription.items[i];
+                if (item.next_due > now) {
+                    continue;
+                }
+                item.next_due = now + item.interval;
+                if (reads.empty() || item.interval < *lockTimeout) {
+                    *lockTimeout = item.interval;
+                }
+                PollRead read;
+                read.subscription_id = subscription.id;
+                read.index = i;
+                read.item = item.read;
+                reads.push_back(read);
+            }
+        }
+        return reads;
+    }
+
+    bool Stopping() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return stopping_;
+    }
+
+    // Returns false when the round was skipped: the lock stayed busy for the
+    // poll period (at most kMaxPollLockWait), the scheduler is stopping or
+    // the rig is not open.
+    bool RunReads(std::vector<PollRead>& reads, std::chrono::milliseconds lockTimeout) {
+        if (reads.empty()) {
+            return false;
+        }
+        const auto deadline = std::chrono::steady_clock::now() + std::min(lockTimeout, kMaxPollLockWait);
+        RigLockScopeUse scopeUse;
+        GlobalRigLock rigLock;
+        while (!Stopping()) {
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            rigLock = instance_->TryAcquireRigLockIfEnabled(
+                std::max(std::chrono::milliseconds(0), std::min(kPollLockSlice, remaining)),
+                nullptr, RigCommandPriority::Background);
+            if (rigLock.owns_lock() || !NodeHamLib::IsGlobalRigLockEnabled() || remaining <= kPollLockSlice) {
+                break;
+            }
+        }
+        if (!rigLock.owns_lock() && (NodeHamLib::IsGlobalRigLockEnabled() || Stopping())) {
+            return false;
+        }
+        if (!instance_->my_rig || !instance_->rig_is_open.load(std::memory_order_acquire)) {
+            return false;
+        }
+        for (PollRead& read : reads) {
+            read.item.result_code = executeBatchItem(instance_->my_rig, read.item);
+            noteBatchItemInStateCache(instance_->state_cache_, read.item);
+        }
+        return true;
+    }
+
+    void DiffLocked(const std::vector<PollRead>& reads, double timestamp) {
+        std::vector<PollChange> changes;
+        for (const PollRead& read : reads) {
+            auto subscription = std::find_if(subscriptions_.begin(), subscriptions_.end(),
+                [&read](const PollSubscription& candidate) { return candidate.id == read.subscription_id; });
+            if (subscription == subscriptions_.end() || read.index >= subscription->items.size()) {
+                continue;
+            }
+            PollItem& item = subscription->items[read.index];
+            if (item.has_last && samePollReading(item.last, read.item)) {
+                continue;
+            }
+            PollChange change;
+            change.subscription_id = read.subscription_id;
+            change.index = read.index;
+            change.key = item.key;
+            change.current = read.item;
+            change.has_previous = item.has_last;
+            change.previous = item.last;
+            change.timestamp = timestamp;
+            changes.push_back(std::move(change));
+            item.last = read.item;
+            item.has_last = true;
+        }
+        if (changes.empty()) {
+            return;
+        }
+
+        auto* batch = new std::vector<PollChange>(std::move(changes));
+        std::shared_ptr<RigPollScheduler> self = shared_from_this();
+        napi_status status = tsfn_.NonBlockingCall(
+            batch,
+            [self](Napi::Env env, Napi::Function, std::vector<PollChange>* data) {
+                self->Deliver(env, *data);
+                delete data;
+            });
+        if (status != napi_ok) {
+            delete batch;
+        }
+    }
+
+    // JS thread. Delivers one array per subscription, in poll order.
+    void Deliver(Napi::Env env, const std::vector<PollChange>& changes) {
+        std::vector<uint32_t> order;
+        for (const PollChange& change : changes) {
+            if (std::find(order.begin(), order.end(), change.subscription_id) == order.end()) {
+                order.push_back(change.subscription_id);
+            }
+        }
+        for (uint32_t id : order) {
+            auto callback = callbacks_.find(id);
+            if (callback == callbacks_.end()) {
+                continue;
+            }
+            Napi::HandleScope scope(env);
+            Napi::Array array = Napi::Array::New(env);
+            uint32_t count = 0;
+            for (const PollChange& change : changes) {
+                if (change.subscription_id == id) {
+                    array[count++] = pollChangeToObject(env, change);
+                }
+            }
+            // The callback may stop polling, so do not hold the map iterator.
+            Napi::Function fn = callback->second.Value();
+            fn.Call({ array });
+        }
+    }
+
+    NodeHamLib* instance_;
+    std::thread thread_;
+    Napi::ThreadSafeFunction tsfn_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    bool wake_ = false;
+    std::vector<PollSubscription> subscriptions_;
+
+    // JS thread only.
+    std::map<uint32_t, Napi::FunctionReference> callbacks_;
+    uint32_t next_id_ = 1;
+};
+
+static void stopRigPollScheduler(std::shared_ptr<RigPollScheduler>& scheduler) {
+  if (scheduler) {
+    scheduler->Stop();
+    scheduler.reset();
+  }
+}
+
+static std::string pollItemKey(const Napi::Object& entry, const BatchItem& item) {
+  if (entry.Has("key") && entry.Get("key").IsString()) {
+    return entry.Get("key").As<Napi::String>().Utf8Value();
+  }
+  std::string key = item.name;
+  if (entry.Has("level") && entry.Get("level").IsString()) {
+    key += ":" + entry.Get("level").As<Napi::String>().Utf8Value();
+  } else if (entry.Has("function") && entry.Get("function").IsString()) {
+    key += ":" + entry.Get("function").As<Napi::String>().Utf8Value();
+  }
+  if (entry.Has("vfo") && entry.Get("vfo").IsString()) {
+    key += "@" + entry.Get("vfo").As<Napi::String>().Utf8Value();
+  }
+  return key;
+}
+
+Napi::Value NodeHamLib::StartPolling(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsArray() || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (items: Array<{ op: string, intervalMs?: number }>, callback: Function)")
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Array entries = info[0].As<Napi::Array>();
+  if (entries.Length() == 0 || entries.Length() > kMaxBatchItems) {
+    Napi::RangeError::New(env, "Polling requires between 1 and " + std::to_string(kMaxBatchItems) + " items")
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::vector<PollItem> items(entries.Length());
+  for (uint32_t i = 0; i < entries.Length(); ++i) {
+    const std::string prefix = "poll[" + std::to_string(i) + "]: ";
+    Napi::Value value = entries.Get(i);
+    if (!value.IsObject()) {
+      Napi::TypeError::New(env, prefix + "expected { op: string }").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    Napi::Object entry = value.As<Napi::Object>();
+    PollItem& item = items[i];
+    if (!parseBatchItem(env, entry, prefix, &item.read)) {
+      return env.Null();
+    }
+    if (!isBatchReadOp(item.read.op)) {
+      Napi::TypeError::New(env, prefix + "only get* operations can be polled").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+
+    double intervalMs = kDefaultPollIntervalMs;
+    if (entry.Has("intervalMs") && !entry.Get("intervalMs").IsUndefined()) {
+      if (!entry.Get("intervalMs").IsNumber()) {
+        Napi::TypeError::New(env, prefix + "intervalMs must be a number").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      intervalMs = entry.Get("intervalMs").As<Napi::Number>().DoubleValue();
+      if (!(intervalMs >= kMinPollIntervalMs && intervalMs <= kMaxPollIntervalMs)) {
+        Napi::RangeError::New(env, prefix + "intervalMs must be between 10 and 3600000").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+    }
+    item.interval = std::chrono::milliseconds(static_cast<int64_t>(intervalMs));
+    item.key = pollItemKey(entry, item.read);
+  }
+
+  if (!poll_scheduler_) {
+    poll_scheduler_ = std::make_shared<RigPollScheduler>(this);
+    poll_scheduler_->Start(env);
+  }
+  const uint32_t id = poll_scheduler_->Add(env, std::move(items), info[1].As<Napi::Function>());
+  return Napi::Number::New(env, id);
+}
+
+Napi::Value NodeHamLib::StopPolling(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() >= 1 && !info[0].IsUndefined() && !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (pollId?: number)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  if (!poll_scheduler_) {
+    return Napi::Boolean::New(env, false);
+  }
+  if (info.Length() >= 1 && info[0].IsNumber()) {
+    const uint32_t id = info[0].As<Napi::Number>().Uint32Value();
+    return Napi::Boolean::New(env, poll_scheduler_->Remove(env, id));
+  }
+  return Napi::Boolean::New(env, poll_scheduler_->RemoveAll(env));
+}
+
+// ===== Tracking loop =====
+
+constexpr double kMinTrackingStepMs = 10;
+constexpr double kMaxTrackingStepMs = 60000;
+constexpr uint32_t kMaxTrackingPoints = 100000;
+
+static void stopRigTracker(std::shared_ptr<RigTracker>& tracker) {
+  if (tracker) {
+    tracker->Stop();
+    tracker.reset();
+  }
+}
+
+// Reads an optional number within [min, max]; false after throwing.
+static bool readTrackingNumber(Napi::Env env, const Napi::Object& options, const char* name,
+                               double min, double max, double* out) {
+  if (!options.Has(name) || options.Get(name).IsUndefined()) {
+    return true;
+  }
+  Napi::Value value = options.Get(name);
+  if (!value.IsNumber()) {
+    Napi::TypeError::New(env, std::string(name) + " must be a number").ThrowAsJavaScriptException();
+    return false;
+  }
+  const double number = value.As<Napi::Number>().DoubleValue();
+  if (!(number >= min && number <= max)) {
+    Napi::RangeError::New(env, std::string(name) + " must be between " + std::to_string(static_cast<int64_t>(min))
+      + " and " + std::to_string(static_cast<int64_t>(max))).ThrowAsJavaScriptException();
+    return false;
+  }
+  *out = number;
+  return true;
+}
+
+// Reads field `name` of a schedule point. Whether the first point has it
+// decides for the whole schedule; false after throwing.
+static bool readTrackingField(Napi::Env env, const Napi::Object& point, const std::string& prefix,
+                              const char* name, bool first, bool* present, double* out) {
+  const bool has = point.Has(name) && !point.Get(name).IsUndefined();
+  if (first) {
+    *present = has;
+  } else if (has != *present) {
+    Napi::TypeError::New(env, prefix + name + " must be given in every point or in none")
+      .ThrowAsJavaScriptException();
+    return false;
+  }
+  if (!has) {
+    return true;
+  }
+  Napi::Value value = point.Get(name);
+  if (!value.IsNumber() || !std::isfinite(value.As<Napi::Number>().DoubleValue())) {
+    Napi::TypeError::New(env, prefix + name + " must be a finite number").ThrowAsJavaScriptException();
+    return false;
+  }
+  *out = value.As<Napi::Number>().DoubleValue();
+  return true;
+}
+
+Napi::Value NodeHamLib::StartTracking(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 3 || !info[0].IsArray() || !info[1].IsObject() || !info[2].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (points: Array<{ time: number }>, options: object, callback: Function)")
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Array entries = info[0].As<Napi::Array>();
+  if (entries.Length() == 0 || entries.Length() > kMaxTrackingPoints) {
+    Napi::RangeError::New(env, "Tracking requires between 1 and " + std::to_string(kMaxTrackingPoints) + " points")
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  TrackingOptions options;
+  options.vfo = SHIM_RIG_VFO_CURR;
+  std::vector<TrackingPoint> points(entries.Length());
+  for (uint32_t i = 0; i < entries.Length(); ++i) {
+    const std::string prefix = "points[" + std::to_string(i) + "]: ";
+    Napi::Value value = entries.Get(i);
+    if (!value.IsObject()) {
+      Napi::TypeError::New(env, prefix + "expected { time: number }").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    Napi::Object entry = value.As<Napi::Object>();
+    TrackingPoint& point = points[i];
+    if (!entry.Get("time").IsNumber() || !std::isfinite(entry.Get("time").As<Napi::Number>().DoubleValue())) {
+      Napi::TypeError::New(env, prefix + "time must be epoch milliseconds").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    point.time_ms = entry.Get("time").As<Napi::Number>().DoubleValue();
+    if (i > 0 && !(point.time_ms > points[i - 1].time_ms)) {
+      Napi::RangeError::New(env, prefix + "times must be strictly increasing").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    const bool first = i == 0;
+    bool hasAzimuth = options.has_position;
+    bool hasElevation = options.has_position;
+    if (!readTrackingField(env, entry, prefix, "azimuth", first, &hasAzimuth, &point.azimuth)
+        || !readTrackingField(env, entry, prefix, "elevation", first, &hasElevation, &point.elevation)
+        || !readTrackingField(env, entry, prefix, "rxFrequency", first, &options.has_rx_frequency, &point.rx_frequency)
+        || !readTrackingField(env, entry, prefix, "txFrequency", first, &options.has_tx_frequency, &point.tx_frequency)) {
+      return env.Null();
+    }
+    if (hasAzimuth != hasElevation) {
+      Napi::TypeError::New(env, prefix + "azimuth and elevation must be given together").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    options.has_position = hasAzimuth;
+  }
+  if (!options.has_position && !options.has_rx_frequency && !options.has_tx_frequency) {
+    Napi::TypeError::New(env, "points need azimuth/elevation, rxFrequency or txFrequency").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  Napi::Object optionsObject = info[1].As<Napi::Object>();
+  double stepMs = static_cast<double>(options.step.count());
+  if (!readTrackingNumber(env, optionsObject, "stepMs", kMinTrackingStepMs, kMaxTrackingStepMs, &stepMs)
+      || !readTrackingNumber(env, optionsObject, "frequencyDeadbandHz", 0, 1e9, &options.frequency_deadband_hz)
+      || !readTrackingNumber(env, optionsObject, "azimuthDeadband", 0, 360, &options.azimuth_deadband)
+      || !readTrackingNumber(env, optionsObject, "elevationDeadband", 0, 180, &options.elevation_deadband)) {
+    return env.Null();
+  }
+  options.step = std::chrono::milliseconds(static_cast<int64_t>(stepMs));
+  if (optionsObject.Has("vfo") && !optionsObject.Get("vfo").IsUndefined()) {
+    if (!optionsObject.Get("vfo").IsString()) {
+      Napi::TypeError::New(env, "vfo must be a string").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    options.vfo = parseVfoString(env, optionsObject.Get("vfo").As<Napi::String>().Utf8Value());
+    if (options.vfo == kInvalidVfoParameter) {
+      return env.Null();
+    }
+  }
+
+  NodeRotator* rotator = nullptr;
+  Napi::Object rotatorObject;
+  if (optionsObject.Has("rotator") && !optionsObject.Get("rotator").IsUndefined()
+      && !optionsObject.Get("rotator").IsNull()) {
+    Napi::Value value = optionsObject.Get("rotator");
+    HamLibAddonData* addonData = HamLibAddonData::From(env);
+    if (!value.IsObject() || !addonData
+        || !value.As<Napi::Object>().InstanceOf(addonData->rotator_constructor.Value())) {
+      Napi::TypeError::New(env, "rotator must be a Rotator").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    rotatorObject = value.As<Napi::Object>();
+    rotator = Napi::ObjectWrap<NodeRotator>::Unwrap(rotatorObject);
+  }
+  if (options.has_position && !rotator) {
+    Napi::TypeError::New(env, "points with azimuth/elevation need options.rotator").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if ((options.has_rx_frequency || options.has_tx_frequency) && !rig_is_open.load(std::memory_order_acquire)) {
+    Napi::Error::New(env, "Rig is not open!").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  if (rotator && !rotator->rot_is_open.load(std::memory_order_acquire)) {
+    Napi::Error::New(env, "Rotator is not open!").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  stopRigTracker(tracker_);
+  tracker_ = std::make_shared<RigTracker>(this, rotator, std::move(points), options);
+  tracker_->Start(env, info[2].As<Napi::Function>(), rotatorObject);
+  return env.Undefined();
+}
+
+Napi::Value NodeHamLib::StopTracking(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  const bool running = tracker_ && tracker_->Running();
+  if (tracker_) {
+    // Keep the finished schedule around for getTrackingStatus().
+    tracker_->Stop();
+  }
+  return Napi::Boolean::New(env, running);
+}
+
+Napi::Value NodeHamLib::GetTrackingStatus(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  if (!tracker_) {
+    return env.Null();
+  }
+  const TrackingStats stats = tracker_->GetStats();
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("running", Napi::Boolean::New(env, stats.running));
+  obj.Set("points", Napi::Number::New(env, static_cast<double>(stats.points)));
+  obj.Set("startTime", Napi::Number::New(env, stats.start_ms));
+  obj.Set("endTime", Napi::Number::New(env, stats.end_ms));
+  obj.Set("steps", Napi::Number::New(env, static_cast<double>(stats.steps)));
+  obj.Set("lateSteps", Napi::Number::New(env, static_cast<double>(stats.late_steps)));
+  obj.Set("skippedSteps", Napi::Number::New(env, static_cast<double>(stats.skipped_steps)));
+  obj.Set("maxLateMs", Napi::Number::New(env, stats.max_late_ms));
+  Napi::Object commands = Napi::Object::New(env);
+  commands.Set("rxFrequency", Napi::Number::New(env, static_cast<double>(stats.rx_frequency_commands)));
+  commands.Set("txFrequency", Napi::Number::New(env, static_cast<double>(stats.tx_frequency_commands)));
+  commands.Set("position", Napi::Number::New(env, static_cast<double>(stats.position_commands)));
+  obj.Set("commands", commands);
+  obj.Set("errors", Napi::Number::New(env, static_cast<double>(stats.errors)));
+  return obj;
+}
+
+// ===== Transceive events =====
+
+static bool parseTransceiveMode(const std::string& value, int* mode) {
+  if (value == "off") {
+    *mode = SHIM_RIG_TRN_OFF;
+  } else if (value == "rig") {
+    *mode = SHIM_RIG_TRN_RIG;
+  } else if (value == "poll") {
+    *mode = SHIM_RIG_TRN_POLL;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static const char* transceiveModeName(int mode) {
+  switch (mode) {
+    case SHIM_RIG_TRN_OFF:
+      return "off";
+    case SHIM_RIG_TRN_POLL:
+      return "poll";
+    default:
+      return "rig";
+  }
+}
+
+Napi::Value NodeHamLib::SetTransceive(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+
+  int mode = SHIM_RIG_TRN_RIG;
+  if (info.Length() < 1 || !info[0].IsString() ||
+      !parseTransceiveMode(info[0].As<Napi::String>().Utf8Value(), &mode)) {
+    Napi::TypeError::New(env, "Expected (mode: 'off' | 'rig' | 'poll')").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  // Stored for the next open(); applied right away when the rig is open.
+  return QueueLockedCallbackWorker(env, this, "SetTransceive",
+    [mode](NodeHamLib* instance, int& result_code, std::string& error_message) {
+      instance->transceive_mode_.store(mode, std::memory_order_release);
+      if (!instance->rig_is_open.load(std::memory_order_acquire)) {
+        return;
+      }
+      result_code = shim_rig_set_trn(instance->my_rig, mode);
+      if (result_code != SHIM_RIG_OK) {
+        error_message = shim_rigerror(result_code);
+      }
+    },
+    [](Napi::Env env) { return Napi::Number::New(env, SHIM_RIG_OK); });
+}
+
+Napi::Value NodeHamLib::GetTransceive(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  return Napi::String::New(env, transceiveModeName(transceive_mode_.load(std::memory_order_acquire)));
+}
+
+Napi::Value NodeHamLib::SetTransceiveListener(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !(info[0].IsFunction() || info[0].IsNull() || info[0].IsUndefined())) {
+    Napi::TypeError::New(env, "Expected (listener: Function | null)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  StopTransceiveEventsInternal();
+  if (info[0].IsFunction()) {
+    Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+      env, info[0].As<Napi::Function>(), "HamLibTransceiveEvents", 0, 1);
+    // Rig-pushed events alone must not keep the process alive.
+    tsfn.Unref(env);
+    std::lock_guard<std::mutex> lock(transceive_mutex_);
+    transceive_tsfn_ = tsfn;
+  }
+  return env.Undefined();
+}
+
+static std::vector<std::string> supportedFunctionNames(uint64_t functions) {
+  std::vector<std::string> values;
+  if (functions & SHIM_RIG_FUNC_FAGC) values.push_back("FAGC");
+  if (functions & SHIM_RIG_FUNC_NB) values.push_back("NB");
+  if (functions & SHIM_RIG_FUNC_COMP) values.push_back("COMP");
+  if (functions & SHIM_RIG_FUNC_VOX) values.push_back("VOX");
+  if (functions & SHIM_RIG_FUNC_TONE) values.push_back("TONE");
+  if (functions & SHIM_RIG_FUNC_TSQL) values.push_back("TSQL");
+  if (functions & SHIM_RIG_FUNC_SBKIN) values.push_back("SBKIN");
+  if (functions & SHIM_RIG_FUNC_FBKIN) values.push_back("FBKIN");
+  if (functions & SHIM_RIG_FUNC_ANF) values.push_back("ANF");
+  if (functions & SHIM_RIG_FUNC_NR) values.push_back("NR");
+  if (functions & SHIM_RIG_FUNC_AIP) values.push_back("AIP");
+  if (functions & SHIM_RIG_FUNC_APF) values.push_back("APF");
+  if (functions & SHIM_RIG_FUNC_TUNER) values.push_back("TUNER");
+  if (functions & SHIM_RIG_FUNC_XIT) values.push_back("XIT");
+  if (functions & SHIM_RIG_FUNC_RIT) values.push_back("RIT");
+  if (functions & SHIM_RIG_FUNC_LOCK) values.push_back("LOCK");
+  if (functions & SHIM_RIG_FUNC_MUTE) values.push_back("MUTE");
+  if (functions & SHIM_RIG_FUNC_VSC) values.push_back("VSC");
+  if (functions & SHIM_RIG_FUNC_REV) values.push_back("REV");
+  if (functions & SHIM_RIG_FUNC_SQL) values.push_back("SQL");
+  if (functions & SHIM_RIG_FUNC_ABM) values.push_back("ABM");
+  if (functions & SHIM_RIG_FUNC_BC) values.push_back("BC");
+  if (functions & SHIM_RIG_FUNC_MBC) values.push_back("MBC");
+  if (functions & SHIM_RIG_FUNC_AFC) values.push_back("AFC");
+  if (functions & SHIM_RIG_FUNC_SATMODE) values.push_back("SATMODE");
+  if (functions & SHIM_RIG_FUNC_SCOPE) values.push_back("SCOPE");
+  if (functions & SHIM_RIG_FUNC_RESUME) values.push_back("RESUME");
+  if (functions & SHIM_RIG_FUNC_TBURST) values.push_back("TBURST");
+  if (functions & SHIM_RIG_FUNC_TRANSCEIVE) values.push_back("TRANSCEIVE");
+  if (functions & SHIM_RIG_FUNC_SPECTRUM) values.push_back("SPECTRUM");
+  if (functions & SHIM_RIG_FUNC_SPECTRUM_HOLD) values.push_back("SPECTRUM_HOLD");
+  if (functions & SHIM_RIG_FUNC_SEND_MORSE) values.push_back("SEND_MORSE");
+  if (functions & SHIM_RIG_FUNC_SEND_VOICE_MEM) values.push_back("SEND_VOICE_MEM");
+  if (functions & SHIM_RIG_FUNC_OVF_STATUS) values.push_back("OVF_STATUS");
+  return values;
+}
+
+static Napi::Value supportedFunctionsValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return StringVectorToArray(env, supportedFunctionNames(caps.functions));
+}
+
+Napi::Value NodeHamLib::GetSupportedFunctions(const Napi::CallbackInfo& info) {
+  return QueueCapabilityQuery(info.Env(), "GetSupportedFunctions", supportedFunctionsValue);
+}
+
+Napi::Value NodeHamLib::GetSupportedFunctionsSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, supportedFunctionsValue);
+}
+
+
+// Mode Query
+
+static std::vector<std::string> supportedModeNames(uint64_t modes) {
+  std::vector<std::string> values;
+  for (unsigned int i = 0; i < SHIM_HAMLIB_MAX_MODES; i++) {
+    uint64_t mode_bit = modes & (1ULL << i);
+    if (!mode_bit) continue;
+    const char* mode_str = shim_rig_strrmode(mode_bit);
+    if (mode_str && mode_str[0] != '\0') values.emplace_back(mode_str);
+  }
+  return values;
+}
+
+static Napi::Value supportedModesValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return StringVectorToArray(env, supportedModeNames(caps.modes));
+}
+
+Napi::Value NodeHamLib::GetSupportedModes(const Napi::CallbackInfo& info) {
+  return QueueCapabilityQuery(info.Env(), "GetSupportedModes", supportedModesValue);
+}
+
+Napi::Value NodeHamLib::GetSupportedModesSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, supportedModesValue);
+}
+
+
+// Split Operations
+Napi::Value NodeHamLib::SetSplitFreq(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  
+  
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected TX frequency").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  double tx_freq = info[0].As<Napi::Number>().DoubleValue();
+  
+  // Basic frequency range validation
+  if (tx_freq < 1000 || tx_freq > 10000000000) { // 1 kHz to 10 GHz reasonable range
+    Napi::Error::New(env, "Frequency out of range (1 kHz - 10 GHz)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  int vfo = SHIM_RIG_VFO_CURR;
+  
+  if (info.Length() >= 2 && info[1].IsString()) {
+    // setSplitFreq(freq, vfo)
+    vfo = parseVfoParameter(info, 1, SHIM_RIG_VFO_CURR);
+    RETURN_NULL_IF_INVALID_VFO(vfo);
+  }
+  
+  SetSplitFreqAsyncWorker* asyncWorker = new SetSplitFreqAsyncWorker(env, this, tx_freq, vfo);
+  asyncWorker->Queue();
+  return asyncWorker->GetPromise();
+}
+
+Napi::Value NodeHamLib::GetSplitFreq(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  
+  
+  int vfo = SHIM_RIG_VFO_CURR;
+  
+  if (info.Length() >= 1 && info[0].IsString()) {
+    // getSplitFreq(vfo)
+    vfo = parseVfoParameter(info, 0, SHIM_RIG_VFO_CURR);
+    RETURN_NULL_IF_INVALID_VFO(vfo);
+  }
+  // Otherwise use default SHIM_RIG_VFO_CURR for getSplitFreq()
+  
+  GetSplitFreqAsyncWorker* asyncWorker = new GetSplitFreqAsyncWorker(env, this, vfo);
+  asyncWorker->Queue();
+  return asyncWorker->GetPromise();
+}
+
+Napi::Value NodeHamLib::SetSplitMode(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  
+  
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected TX mode string").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  std::string modeStr = info[0].As<Napi::String>().Utf8Value();
+  int tx_mode = shim_rig_parse_mode(modeStr.c_str());
+  
+  if (tx_mode == SHIM_RIG_MODE_NONE) {
+    Napi::Error::New(env, "Invalid mode: " + modeStr).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  int tx_width = SHIM_RIG_PASSBAND_NORMAL;
+  int vfo = SHIM_RIG_VFO_CURR;
+  
+  // Parse parameters: setSplitMode(mode) | setSplitMode(mode, vfo) | setSplitMode(mode, width) | setSplitMode(mode, width, vfo)
+  if (info.Length() == 2) {
+    if (info[1].IsString()) {
+      // setSplitMode(mode, vfo)
+      vfo = parseVfoParameter(info, 1, SHIM_RIG_VFO_CURR);
+      RETURN_NULL_IF_INVALID_VFO(vfo);
+    } else if (info[1].IsNumber()) {
+      // setSplitMode(mode, width)
+      tx_width = info[1].As<Napi::Number>().Int32Value();
+    }
+  } else if (info.Length() == 3 && info[1].IsNumber() && info[2].IsString()) {
+    // setSplitMode(mode, width, vfo)
+    tx_width = info[1].As<Napi::Number>().Int32Value();
+    vfo = parseVfoParameter(info, 2, SHIM_RIG_VFO_CURR);
+    RETURN_NULL_IF_INVALID_VFO(vfo);
+  }
+  
+  SetSplitModeAsyncWorker* asyncWorker = new SetSplitModeAsyncWorker(env, this, tx_mode, tx_width, vfo);
+  asyncWorker->Queue();
+  return asyncWorker->GetPromise();
+}
+
+Napi::Value NodeHamLib::GetSplitMode(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  
+  
+  int vfo = SHIM_RIG_VFO_CURR;
+  
+  if (info.Length() >= 1 && info[0].IsString()) {
+    // getSplitMode(vfo)
+    vfo = parseVfoParameter(info, 0, SHIM_RIG_VFO_CURR);
+    RETURN_NULL_IF_INVALID_VFO(vfo);
+  }
+  // Otherwise use default SHIM_RIG_VFO_CURR for getSplitMode()
+  
+  GetSplitModeAsyncWorker* asyncWorker = new GetSplitModeAsyncWorker(env, this, vfo);
+  asyncWorker->Queue();
+  return asyncWorker->GetPromise();
+}
+
+Napi::Value NodeHamLib::SetSplit(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  
+  
+  if (info.Length() < 1 || !info[0].IsBoolean()) {
+    Napi::TypeError::New(env, "Expected boolean split enable state").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  bool split_enabled = info[0].As<Napi::Boolean>().Value();
+  int split = split_enabled ? SHIM_RIG_SPLIT_ON : SHIM_RIG_SPLIT_OFF;
+  
+  // Default values
+  int rx_vfo = SHIM_RIG_VFO_CURR;
+  int tx_vfo = SHIM_RIG_VFO_CURR;
+  
+  // ⚠️  CRITICAL HISTORICAL ISSUE WARNING ⚠️
+  // This Split API had a severe parameter order bug that caused AI to repeatedly
+  // modify but never correctly fix. See CLAUDE.md for full details.
+  // 
+  // Parse different overloads:
+  // setSplit(enable)
+  // setSplit(enable, rxVfo) - rxVfo here is RX VFO
+  // setSplit(enable, rxVfo, txVfo) - RX VFO and TX VFO
+  // 
+  // ⚠️  VERIFIED PARAMETER ORDER (2024-08-10):
+  // - info[1] = rxVfo (RX VFO) 
+  // - info[2] = txVfo (TX VFO)
+  // - Must match JavaScript: setSplit(enable, rxVfo, txVfo)
+  // - Must match TypeScript: setSplit(enable: boolean, rxVfo?: VFO, txVfo?: VFO)
+  
+  if (info.Length() == 2 && info[1].IsString()) {
+    // setSplit(enable, rxVfo) - treating vfo as RX VFO for current VFO operation
+    rx_vfo = parseVfoParameter(info, 1, SHIM_RIG_VFO_CURR);
+    RETURN_NULL_IF_INVALID_VFO(rx_vfo);
+  } else if (info.Length() == 3 && info[1].IsString() && info[2].IsString()) {
+    // setSplit(enable, rxVfo, txVfo)
+    // ⚠️  CRITICAL: Parameter assignment was WRONG before 2024-08-10 fix!
+    // ⚠️  Previous bug: info[1] -> txVfoStr, info[2] -> rxVfoStr (WRONG!)
+    // ⚠️  Correct now: info[1] -> rxVfoStr, info[2] -> txVfoStr (RIGHT!)
+    rx_vfo = parseVfoParameter(info, 1, SHIM_RIG_VFO_CURR);
+    RETURN_NULL_IF_INVALID_VFO(rx_vfo);
+    tx_vfo = parseVfoParameter(info, 2, SHIM_RIG_VFO_CURR);
+    RETURN_NULL_IF_INVALID_VFO(tx_vfo);
+  }
+  
+  SetSplitAsyncWorker* asyncWorker = new SetSplitAsyncWorker(env, this, rx_vfo, split, tx_vfo);
+  asyncWorker->Queue();
+  return asyncWorker->GetPromise();
+}
+
+Napi::Value NodeHamLib::GetSplit(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  
+  
+  int vfo = SHIM_RIG_VFO_CURR;
+  
+  if (info.Length() >= 1 && info[0].IsString()) {
+    // getSplit(vfo)
+    vfo = parseVfoParameter(info, 0, SHIM_RIG_VFO_CURR);
+    RETURN_NULL_IF_INVALID_VFO(vfo);
+  }
+  // Otherwise use default SHIM_RIG_VFO_CURR for getSplit()
+  
+  GetSplitAsyncWorker* asyncWorker = new GetSplitAsyncWorker(env, this, vfo);
+  asyncWorker->Queue();
+  return asyncWorker->GetPromise();
+}
+
+// VFO Operations
+Napi::Value NodeHamLib::VfoOperation(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  
+  
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected VFO operation string").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  std::string vfoOpStr = info[0].As<Napi::String>().Utf8Value();
+  
+  int vfo_op;
+  if (vfoOpStr == "CPY") {
+    vfo_op = SHIM_RIG_OP_CPY;
+  } else if (vfoOpStr == "XCHG") {
+    vfo_op = SHIM_RIG_OP_XCHG;
+  } else if (vfoOpStr == "FROM_VFO") {
+    vfo_op = SHIM_RIG_OP_FROM_VFO;
+  } else if (vfoOpStr == "TO_VFO") {
+    vfo_op = SHIM_RIG_OP_TO_VFO;
+  } else if (vfoOpStr == "MCL") {
+    vfo_op = SHIM_RIG_OP_MCL;
+  } else if (vfoOpStr == "UP") {
+    vfo_op = SHIM_RIG_OP_UP;
+  } else if (vfoOpStr == "DOWN") {
+    vfo_op = SHIM_RIG_OP_DOWN;
+  } else if (vfoOpStr == "BAND_UP") {
+    vfo_op = SHIM_RIG_OP_BAND_UP;
+  } else if (vfoOpStr == "BAND_DOWN") {
+    vfo_op = SHIM_RIG_OP_BAND_DOWN;
+  } else if (vfoOpStr == "LEFT") {
+    vfo_op = SHIM_RIG_OP_LEFT;
+  } else if (vfoOpStr == "RIGHT") {
+    vfo_op = SHIM_RIG_OP_RIGHT;
+  } else if (vfoOpStr == "TUNE") {
+    vfo_op = SHIM_RIG_OP_TUNE;
+  } else if (vfoOpStr == "TOGGLE") {
+    vfo_op = SHIM_RIG_OP_TOGGLE;
+  } else {
+    Napi::TypeError::New(env, "Invalid VFO operation").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  VfoOperationAsyncWorker* asyncWorker = new VfoOperationAsyncWorker(env, this, vfo_op);
+  asyncWorker->Queue();
+  return asyncWorker->GetPromise();
+}
+
+// Antenna Selection
+Napi::Value NodeHamLib::SetAntenna(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  
+  
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected antenna number").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  
+  const int antennaOrdinal = info[0].As<Napi::Number>().Int32Value();
+  const int antenna = antennaOrdinalToMask(env, antennaOrdinal);
+  if (antenna == 0) {
+    return env.Null();
+  }
+
+  int vfo = SHIM_RIG_VFO_CURR;
+  float option = 0.0f;
+
+  if (info.Length() >= 2) {
+    if (info[1].IsNumber()) {
+      option = info[1].As<Napi::Number>().FloatValue();
+      if (info.Length() >= 3 && info[2].IsString()) {
+        vfo = parseVfoParameter(info, 2, SHIM_RIG_VFO_CURR);
+        RETURN_NULL_IF_INVALID_VFO(vfo);
+      } else if (info.Length() >= 3 && !info[2].IsUndefined()) {
+        Napi::TypeError::New(env, "Expected VFO token as third argument").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+    } else if (info[1].IsString()) {
+      vfo = parseVfoParameter(info, 1, SHIM_RIG_VFO_CURR);
+      RETURN_NULL_IF_INVALID_VFO(vfo);
+    } else if (!info[1].IsUndefined()) {
+      Napi::TypeError::New(env, "Expected antenna option as number or VFO token as string").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+
+  if (info.Length() >= 3 && info[1].IsString()) {
+    Napi::TypeError::New(env, "Antenna option must come before VFO").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  SetAntennaAsyncWorker* asyncWorker = new SetAntennaAsyncWorker(env, this, antenna, vfo, option);
+  asyncWorker->Queue();
+  return asyncWorker->GetPromise();
+}
+
+Napi::Value NodeHamLib::GetAntenna(const Napi::CallbackInfo & info) {
+  Napi::Env env = info.Env();
+  
+  
+  // Support optional VFO parameter: getAntenna() or getAntenna(vfo)
+  int vfo = SHIM_RIG_VFO_CURR;
+  if (info.Length() >= 1 && info[0].IsString()) {
+    vfo = parseVfoParameter(info, 0, SHIM_RIG_VFO_CURR);
+    RETURN_NULL_IF_INVALID_VFO(vfo);
+  }
+  
+  // Default antenna query (SHIM_RIG_ANT_CURR gets all antenna info)
+  int antenna = SHIM_RIG_ANT_CURR;
+  
+  GetAntennaAsyncWorker* asyncWorker = new GetAntennaAsyncWorker(env, this, vfo, antenna);
+  asyncWorker->Queue();
+  return asyncWorker->GetPromise();
+}
+
+Napi::Function NodeHamLib::GetClass(Napi::Env env) {
+  auto ret =  DefineClass(
     env,
     "HamLib", {
       NodeHamLib::InstanceMethod("open", & NodeHamLib::Open),
@@ -4800,6 +7893,7 @@ Napi::Function NodeHamLib::GetClass(Napi::Env env) {
       NodeHamLib::InstanceMethod("getMemoryLayout", & NodeHamLib::GetMemoryLayout),
       NodeHamLib::InstanceMethod("getMemoryCapabilities", & NodeHamLib::GetMemoryCapabilities),
       NodeHamLib::InstanceMethod("getMemoryList", & NodeHamLib::GetMemoryList),
+      NodeHamLib::InstanceMethod("getMemoryListChunk", & NodeHamLib::GetMemoryListChunk),
       NodeHamLib::InstanceMethod("setMemoryChannels", & NodeHamLib::SetMemoryChannels),
       NodeHamLib::InstanceMethod("replaceMemoryChannels", & NodeHamLib::ReplaceMemoryChannels),
       
@@ -4930,9 +8024,21 @@ Napi::Function NodeHamLib::GetClass(Napi::Env env) {
       // Rig Info / Spectrum / Conf (async)
       NodeHamLib::InstanceMethod("getInfo", & NodeHamLib::GetInfo),
       NodeHamLib::InstanceMethod("sendRaw", & NodeHamLib::SendRaw),
+      NodeHamLib::InstanceMethod("sendRawInto", & NodeHamLib::SendRawInto),
+      NodeHamLib::InstanceMethod("startRawStream", & NodeHamLib::StartRawStream),
+      NodeHamLib::InstanceMethod("stopRawStream", & NodeHamLib::StopRawStream),
+      NodeHamLib::InstanceMethod("getRawStreamStatus", & NodeHamLib::GetRawStreamStatus),
       NodeHamLib::InstanceMethod("getSpectrumCapabilities", & NodeHamLib::GetSpectrumCapabilities),
       NodeHamLib::InstanceMethod("startSpectrumStream", & NodeHamLib::StartSpectrumStream),
       NodeHamLib::InstanceMethod("stopSpectrumStream", & NodeHamLib::StopSpectrumStream),
+      NodeHamLib::InstanceMethod("getSpectrumStreamStats", & NodeHamLib::GetSpectrumStreamStats),
+      NodeHamLib::InstanceMethod("_injectSpectrumLines", & NodeHamLib::InjectSpectrumLines),
+      NodeHamLib::InstanceMethod("startSweep", & NodeHamLib::StartSweep),
+      NodeHamLib::InstanceMethod("stopSweep", & NodeHamLib::StopSweep),
+      NodeHamLib::InstanceMethod("getSweepStatus", & NodeHamLib::GetSweepStatus),
+      NodeHamLib::InstanceMethod("startSpectrumRecording", & NodeHamLib::StartSpectrumRecording),
+      NodeHamLib::InstanceMethod("stopSpectrumRecording", & NodeHamLib::StopSpectrumRecording),
+      NodeHamLib::InstanceMethod("getSpectrumRecordingStats", & NodeHamLib::GetSpectrumRecordingStats),
       NodeHamLib::InstanceMethod("setConf", & NodeHamLib::SetConf),
       NodeHamLib::InstanceMethod("getConf", & NodeHamLib::GetConf),
 
@@ -4959,27 +8065,93 @@ Napi::Function NodeHamLib::GetClass(Napi::Env env) {
       NodeHamLib::InstanceMethod("getFrequencyRanges", & NodeHamLib::GetFrequencyRanges),
       NodeHamLib::InstanceMethod("getTuningSteps", & NodeHamLib::GetTuningSteps),
       NodeHamLib::InstanceMethod("getFilterList", & NodeHamLib::GetFilterList),
+      NodeHamLib::InstanceMethod("getCapabilitySnapshot", & NodeHamLib::GetCapabilitySnapshot),
+      NodeHamLib::InstanceMethod("getFrequencySync", & NodeHamLib::GetFrequencySync),
+      NodeHamLib::InstanceMethod("getModeSync", & NodeHamLib::GetModeSync),
+      NodeHamLib::InstanceMethod("getVfoSync", & NodeHamLib::GetVfoSync),
+      NodeHamLib::InstanceMethod("getSupportedLevelsSync", & NodeHamLib::GetSupportedLevelsSync),
+      NodeHamLib::InstanceMethod("getSupportedFunctionsSync", & NodeHamLib::GetSupportedFunctionsSync),
+      NodeHamLib::InstanceMethod("getSupportedModesSync", & NodeHamLib::GetSupportedModesSync),
+      NodeHamLib::InstanceMethod("getSupportedParmsSync", & NodeHamLib::GetSupportedParmsSync),
+      NodeHamLib::InstanceMethod("getSupportedVfoOpsSync", & NodeHamLib::GetSupportedVfoOpsSync),
+      NodeHamLib::InstanceMethod("getSupportedScanTypesSync", & NodeHamLib::GetSupportedScanTypesSync),
+      NodeHamLib::InstanceMethod("getPreampValuesSync", & NodeHamLib::GetPreampValuesSync),
+      NodeHamLib::InstanceMethod("getAttenuatorValuesSync", & NodeHamLib::GetAttenuatorValuesSync),
+      NodeHamLib::InstanceMethod("getAgcLevelsSync", & NodeHamLib::GetAgcLevelsSync),
+      NodeHamLib::InstanceMethod("getMaxRitSync", & NodeHamLib::GetMaxRitSync),
+      NodeHamLib::InstanceMethod("getMaxXitSync", & NodeHamLib::GetMaxXitSync),
+      NodeHamLib::InstanceMethod("getMaxIfShiftSync", & NodeHamLib::GetMaxIfShiftSync),
+      NodeHamLib::InstanceMethod("getAvailableCtcssTonesSync", & NodeHamLib::GetAvailableCtcssTonesSync),
+      NodeHamLib::InstanceMethod("getAvailableDcsCodesSync", & NodeHamLib::GetAvailableDcsCodesSync),
+      NodeHamLib::InstanceMethod("getFrequencyRangesSync", & NodeHamLib::GetFrequencyRangesSync),
+      NodeHamLib::InstanceMethod("getTuningStepsSync", & NodeHamLib::GetTuningStepsSync),
+      NodeHamLib::InstanceMethod("getFilterListSync", & NodeHamLib::GetFilterListSync),
+      NodeHamLib::InstanceMethod("getSpectrumCapabilitiesSync", & NodeHamLib::GetSpectrumCapabilitiesSync),
+      NodeHamLib::InstanceMethod("getCapabilitySnapshotSync", & NodeHamLib::GetCapabilitySnapshotSync),
+      NodeHamLib::InstanceMethod("power2mWSync", & NodeHamLib::Power2mWSync),
+      NodeHamLib::InstanceMethod("mW2powerSync", & NodeHamLib::MW2PowerSync),
       NodeHamLib::InstanceMethod("getLevelGranularity", & NodeHamLib::GetLevelGranularity),
       NodeHamLib::InstanceMethod("getRfPowerStepTable", & NodeHamLib::GetRfPowerStepTable),
 
       NodeHamLib::InstanceMethod("close", & NodeHamLib::Close),
       NodeHamLib::InstanceMethod("destroy", & NodeHamLib::Destroy),
       NodeHamLib::InstanceMethod("getConnectionInfo", & NodeHamLib::GetConnectionInfo),
+      NodeHamLib::InstanceMethod("batch", & NodeHamLib::Batch),
+      NodeHamLib::InstanceMethod("enableCommandThread", & NodeHamLib::EnableCommandThread),
+      NodeHamLib::InstanceMethod("disableCommandThread", & NodeHamLib::DisableCommandThread),
+      NodeHamLib::InstanceMethod("getCommandThreadStats", & NodeHamLib::GetCommandThreadStats),
+      NodeHamLib::InstanceMethod("getStats", & NodeHamLib::GetStats),
+      NodeHamLib::InstanceMethod("resetStats", & NodeHamLib::ResetStats),
+      NodeHamLib::InstanceMethod("enableTrace", & NodeHamLib::EnableTrace),
+      NodeHamLib::InstanceMethod("disableTrace", & NodeHamLib::DisableTrace),
+      NodeHamLib::InstanceMethod("dumpTrace", & NodeHamLib::DumpTrace),
+      NodeHamLib::InstanceMethod("openSharedSession", & NodeHamLib::OpenSharedSession),
+      NodeHamLib::InstanceMethod("closeSharedSession", & NodeHamLib::CloseSharedSession),
+      NodeHamLib::InstanceMethod("getSharedSessionStats", & NodeHamLib::GetSharedSessionStats),
+      NodeHamLib::InstanceMethod("enableStateCache", & NodeHamLib::EnableStateCache),
+      NodeHamLib::InstanceMethod("disableStateCache", & NodeHamLib::DisableStateCache),
+      NodeHamLib::InstanceMethod("getStateCacheStats", & NodeHamLib::GetStateCacheStats),
+      NodeHamLib::InstanceMethod("enableRequestCoalescing", & NodeHamLib::EnableRequestCoalescing),
+      NodeHamLib::InstanceMethod("disableRequestCoalescing", & NodeHamLib::DisableRequestCoalescing),
+      NodeHamLib::InstanceMethod("setCommandPriorities", & NodeHamLib::SetCommandPriorities),
+      NodeHamLib::InstanceMethod("getCommandPriorities", & NodeHamLib::GetCommandPriorities),
+      NodeHamLib::InstanceMethod("beginCallScope", & NodeHamLib::BeginCallScope),
+      NodeHamLib::InstanceMethod("endCallScope", & NodeHamLib::EndCallScope),
+      NodeHamLib::InstanceMethod("cancelCallScope", & NodeHamLib::CancelCallScope),
+      NodeHamLib::InstanceMethod("setTransceive", & NodeHamLib::SetTransceive),
+      NodeHamLib::InstanceMethod("getTransceive", & NodeHamLib::GetTransceive),
+      NodeHamLib::InstanceMethod("setTransceiveListener", & NodeHamLib::SetTransceiveListener),
+      NodeHamLib::InstanceMethod("startPolling", & NodeHamLib::StartPolling),
+      NodeHamLib::InstanceMethod("stopPolling", & NodeHamLib::StopPolling),
+      NodeHamLib::InstanceMethod("startTracking", & NodeHamLib::StartTracking),
+      NodeHamLib::InstanceMethod("stopTracking", & NodeHamLib::StopTracking),
+      NodeHamLib::InstanceMethod("getTrackingStatus", & NodeHamLib::GetTrackingStatus),
 
       // Static methods
       NodeHamLib::StaticMethod("getSupportedRigs", & NodeHamLib::GetSupportedRigs),
+      NodeHamLib::StaticMethod("getSupportedRigsAsync", & NodeHamLib::GetSupportedRigsAsync),
+      NodeHamLib::StaticMethod("getSupportedRigsColumnar", & NodeHamLib::GetSupportedRigsColumnar),
+      NodeHamLib::StaticMethod("getSupportedRig", & NodeHamLib::GetSupportedRig),
       NodeHamLib::StaticMethod("getHamlibVersion", & NodeHamLib::GetHamlibVersion),
       NodeHamLib::StaticMethod("setDebugLevel", & NodeHamLib::SetDebugLevel),
       NodeHamLib::StaticMethod("getDebugLevel", & NodeHamLib::GetDebugLevel),
       NodeHamLib::StaticMethod("setGlobalLockEnabled", & NodeHamLib::SetGlobalLockEnabled),
       NodeHamLib::StaticMethod("isGlobalLockEnabled", & NodeHamLib::IsGlobalLockEnabled),
+      NodeHamLib::StaticMethod("setLockScope", & NodeHamLib::SetLockScope),
+      NodeHamLib::StaticMethod("getLockScope", & NodeHamLib::GetLockScope),
+      NodeHamLib::StaticMethod("getStats", & NodeHamLib::GetGlobalStats),
+      NodeHamLib::StaticMethod("resetStats", & NodeHamLib::ResetGlobalStats),
+      NodeHamLib::StaticMethod("setBackendSerialized", & NodeHamLib::SetBackendSerialized),
       NodeHamLib::StaticMethod("getConfigSchemaForModel", & NodeHamLib::GetConfigSchemaForModel),
       NodeHamLib::StaticMethod("getPortCapsForModel", & NodeHamLib::GetPortCapsForModel),
+      NodeHamLib::StaticMethod("buildModelIndex", & NodeHamLib::BuildModelIndex),
+      NodeHamLib::StaticMethod("loadModelIndex", & NodeHamLib::LoadModelIndex),
+      NodeHamLib::StaticMethod("getModelIndexInfo", & NodeHamLib::GetModelIndexInfo),
       NodeHamLib::StaticMethod("getCopyright", & NodeHamLib::GetCopyright),
       NodeHamLib::StaticMethod("getLicense", & NodeHamLib::GetLicense),
+      NodeHamLib::StaticMethod("getLevelHandle", & NodeHamLib::GetLevelHandle),
+      NodeHamLib::StaticMethod("getFunctionHandle", & NodeHamLib::GetFunctionHandle),
     });
-      constructor = Napi::Persistent(ret);
-      constructor.SuppressDestruct();
       return ret;
 }
 
@@ -5001,60 +8173,170 @@ bool NodeHamLib::isNetworkAddress(const char* path) {
   return false;
 }
 
-// Static callback function for rig_list_foreach
-int NodeHamLib::rig_list_callback(const shim_rig_info_t *info, void *data) {
-  RigListData *rig_data = static_cast<RigListData*>(data);
+static Napi::Object rigCatalogEntryToObject(Napi::Env env, const RigCatalog& catalog, const RigCatalogEntry& entry) {
+  Napi::Object rigInfo = Napi::Object::New(env);
+  rigInfo.Set("rigModel", Napi::Number::New(env, entry.model));
+  rigInfo.Set("modelName", Napi::String::New(env, catalog.String(entry.model_name)));
+  rigInfo.Set("mfgName", Napi::String::New(env, catalog.String(entry.mfg_name)));
+  rigInfo.Set("version", Napi::String::New(env, catalog.String(entry.version)));
+  rigInfo.Set("status", Napi::String::New(env, catalog.String(entry.status)));
+  rigInfo.Set("rigType", Napi::String::New(env, catalog.String(entry.rig_type)));
+  return rigInfo;
+}
+
+static Napi::Array rigCatalogToArray(Napi::Env env, const RigCatalog& catalog) {
+  // Each distinct string becomes one JS string, shared by every entry.
+  std::vector<Napi::String> strings;
+  strings.reserve(catalog.Strings().size());
+  for (const std::string& text : catalog.Strings()) {
+    strings.push_back(Napi::String::New(env, text));
+  }
+  const std::vector<RigCatalogEntry>& entries = catalog.Entries();
+  Napi::Array rigArray = Napi::Array::New(env, entries.size());
+  for (size_t i = 0; i < entries.size(); i++) {
+    const RigCatalogEntry& entry = entries[i];
+    Napi::Object rigInfo = Napi::Object::New(env);
+    rigInfo.Set("rigModel", Napi::Number::New(env, entry.model));
+    rigInfo.Set("modelName", strings[entry.model_name]);
+    rigInfo.Set("mfgName", strings[entry.mfg_name]);
+    rigInfo.Set("version", strings[entry.version]);
+    rigInfo.Set("status", strings[entry.status]);
+    rigInfo.Set("rigType", strings[entry.rig_type]);
+    rigArray[static_cast<uint32_t>(i)] = rigInfo;
+  }
+  return rigArray;
+}
+
+static std::shared_ptr<const RigCatalog> supportedRigCatalog(Napi::Env env) {
+  int result = SHIM_RIG_OK;
+  std::shared_ptr<const RigCatalog> catalog = RigCatalog::Get(NodeHamLib::MetadataMutex(), &result);
+  if (!catalog) {
+    Napi::Error::New(env, "Failed to retrieve supported rig list").ThrowAsJavaScriptException();
+  }
+  return catalog;
+}
 
-  // Create rig info object
-  Napi::Object rigInfo = Napi::Object::New(rig_data->env);
-  rigInfo.Set(Napi::String::New(rig_data->env, "rigModel"),
-              Napi::Number::New(rig_data->env, info->rig_model));
-  rigInfo.Set(Napi::String::New(rig_data->env, "modelName"),
-              Napi::String::New(rig_data->env, info->model_name ? info->model_name : ""));
-  rigInfo.Set(Napi::String::New(rig_data->env, "mfgName"),
-              Napi::String::New(rig_data->env, info->mfg_name ? info->mfg_name : ""));
-  rigInfo.Set(Napi::String::New(rig_data->env, "version"),
-              Napi::String::New(rig_data->env, info->version ? info->version : ""));
-  rigInfo.Set(Napi::String::New(rig_data->env, "status"),
-              Napi::String::New(rig_data->env, shim_rig_strstatus(info->status)));
+// Enumerates the backends on the libuv pool the first time; later calls only
+// build the array.
+class SupportedRigsAsyncWorker : public Napi::AsyncWorker {
+public:
+    explicit SupportedRigsAsyncWorker(Napi::Env env)
+        : Napi::AsyncWorker(env), deferred_(Napi::Promise::Deferred::New(env)) {}
+
+    void Execute() override {
+        catalog_ = RigCatalog::Get(NodeHamLib::MetadataMutex(), &result_);
+    }
 
-  // Determine rig type string using shim helper
-  const char* rigType = shim_rig_type_str(info->rig_type);
+    void OnOK() override {
+        Napi::Env env = Env();
+        if (!catalog_) {
+            deferred_.Reject(Napi::Error::New(env, "Failed to retrieve supported rig list").Value());
+            return;
+        }
+        deferred_.Resolve(rigCatalogToArray(env, *catalog_));
+    }
 
-  rigInfo.Set(Napi::String::New(rig_data->env, "rigType"),
-              Napi::String::New(rig_data->env, rigType));
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
 
-  // Add to list
-  rig_data->rigList.push_back(rigInfo);
+    Napi::Promise GetPromise() { return deferred_.Promise(); }
 
-  return 1; // Continue iteration (returning 0 would stop)
-}
+private:
+    Napi::Promise::Deferred deferred_;
+    std::shared_ptr<const RigCatalog> catalog_;
+    int result_ = SHIM_RIG_OK;
+};
 
 // Static method to get supported rig models
 Napi::Value NodeHamLib::GetSupportedRigs(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  
-  // Load all backends to ensure we get the complete list
-  shim_rig_load_all_backends();
-  
-  // Prepare data structure for callback with proper initialization
-  RigListData rigData{std::vector<Napi::Object>(), env};
-  
-  // Call hamlib function to iterate through all supported rigs
-  int result = shim_rig_list_foreach(rig_list_callback, &rigData);
-  
-  if (result != SHIM_RIG_OK) {
-    Napi::Error::New(env, "Failed to retrieve supported rig list").ThrowAsJavaScriptException();
+  std::shared_ptr<const RigCatalog> catalog = supportedRigCatalog(env);
+  if (!catalog) {
     return env.Null();
   }
-  
-  // Convert std::vector to Napi::Array
-  Napi::Array rigArray = Napi::Array::New(env, rigData.rigList.size());
-  for (size_t i = 0; i < rigData.rigList.size(); i++) {
-    rigArray[i] = rigData.rigList[i];
+  return rigCatalogToArray(env, *catalog);
+}
+
+Napi::Value NodeHamLib::GetSupportedRigsAsync(const Napi::CallbackInfo& info) {
+  auto* worker = new SupportedRigsAsyncWorker(info.Env());
+  worker->Queue();
+  return worker->GetPromise();
+}
+
+// Typed-array columns plus one string table, instead of one object per rig.
+Napi::Value NodeHamLib::GetSupportedRigsColumnar(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  std::shared_ptr<const RigCatalog> catalog = supportedRigCatalog(env);
+  if (!catalog) {
+    return env.Null();
   }
-  
-  return rigArray;
+  const std::vector<RigCatalogEntry>& entries = catalog->Entries();
+  const size_t count = entries.size();
+  Napi::Uint32Array rigModel = Napi::Uint32Array::New(env, count);
+  Napi::Uint32Array modelName = Napi::Uint32Array::New(env, count);
+  Napi::Uint32Array mfgName = Napi::Uint32Array::New(env, count);
+  Napi::Uint32Array version = Napi::Uint32Array::New(env, count);
+  Napi::Uint32Array status = Napi::Uint32Array::New(env, count);
+  Napi::Uint32Array rigType = Napi::Uint32Array::New(env, count);
+  for (size_t i = 0; i < count; ++i) {
+    rigModel[i] = entries[i].model;
+    modelName[i] = entries[i].model_name;
+    mfgName[i] = entries[i].mfg_name;
+    version[i] = entries[i].version;
+    status[i] = entries[i].status;
+    rigType[i] = entries[i].rig_type;
+  }
+  const std::vector<std::string>& texts = catalog->Strings();
+  Napi::Array strings = Napi::Array::New(env, texts.size());
+  for (size_t i = 0; i < texts.size(); ++i) {
+    strings[static_cast<uint32_t>(i)] = Napi::String::New(env, texts[i]);
+  }
+
+  Napi::Object columns = Napi::Object::New(env);
+  columns.Set("count", Napi::Number::New(env, static_cast<double>(count)));
+  columns.Set("rigModel", rigModel);
+  columns.Set("modelName", modelName);
+  columns.Set("mfgName", mfgName);
+  columns.Set("version", version);
+  columns.Set("status", status);
+  columns.Set("rigType", rigType);
+  columns.Set("strings", strings);
+  return columns;
+}
+
+Napi::Value NodeHamLib::GetSupportedRig(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (model: number)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  const unsigned int model = info[0].As<Napi::Number>().Uint32Value();
+  std::shared_ptr<const RigCatalog> catalog = RigCatalog::Cached();
+  if (catalog) {
+    const RigCatalogEntry* entry = catalog->Find(model);
+    if (!entry) {
+      return env.Null();
+    }
+    return rigCatalogEntryToObject(env, *catalog, *entry);
+  }
+
+  // Before the full list exists, load only this model's backend.
+  Napi::Object rigInfo = Napi::Object::New(env);
+  {
+    std::lock_guard<std::mutex> metadataLock(MetadataMutex());
+    shim_rig_info_t modelInfo{};
+    if (shim_rig_get_model_info(model, &modelInfo) != SHIM_RIG_OK || modelInfo.rig_model != model) {
+      return env.Null();
+    }
+    rigInfo.Set("rigModel", Napi::Number::New(env, modelInfo.rig_model));
+    rigInfo.Set("modelName", Napi::String::New(env, modelInfo.model_name));
+    rigInfo.Set("mfgName", Napi::String::New(env, modelInfo.mfg_name));
+    rigInfo.Set("version", Napi::String::New(env, modelInfo.version));
+    rigInfo.Set("status", Napi::String::New(env, shim_rig_strstatus(modelInfo.status)));
+    rigInfo.Set("rigType", Napi::String::New(env, shim_rig_type_str(modelInfo.rig_type)));
+  }
+  return rigInfo;
 }
 
 // Get Hamlib version information
@@ -5109,20 +8391,87 @@ void NodeHamLib::SetGlobalRigLockEnabled(bool enabled) {
   global_rig_lock_enabled_.store(enabled, std::memory_order_release);
 }
 
-bool NodeHamLib::IsGlobalRigLockEnabled() {
-  return global_rig_lock_enabled_.load(std::memory_order_acquire);
+bool NodeHamLib::IsGlobalRigLockEnabled() {
+  return global_rig_lock_enabled_.load(std::memory_order_acquire);
+}
+
+GlobalRigLock NodeHamLib::TryAcquireGlobalRigLockIfEnabled(std::chrono::milliseconds timeout,
+                                                           RigCommandPriority priority) {
+  GlobalRigLock lock(global_rig_mutex_, std::defer_lock);
+  if (!IsGlobalRigLockEnabled()) {
+    return lock;
+  }
+  RigLockArbiter::Global().Acquire(lock, timeout, priority);
+  return lock;
+}
+
+constexpr int kRigLockScopeMask = 0x3;
+constexpr int kRigLockScopeUser = 0x4;
+
+RigLockScopeUse::RigLockScopeUse() {
+  NodeHamLib::RetainRigLockScope();
+}
+
+RigLockScopeUse::~RigLockScopeUse() {
+  NodeHamLib::ReleaseRigLockScope();
+}
+
+bool NodeHamLib::SetRigLockScope(RigLockScope scope) {
+  int state = rig_lock_scope_.load(std::memory_order_acquire);
+  do {
+    if (state & ~kRigLockScopeMask) {
+      return false;
+    }
+  } while (!rig_lock_scope_.compare_exchange_weak(state, static_cast<int>(scope), std::memory_order_acq_rel));
+  return true;
+}
+
+RigLockScope NodeHamLib::GetRigLockScope() {
+  return static_cast<RigLockScope>(rig_lock_scope_.load(std::memory_order_acquire) & kRigLockScopeMask);
+}
+
+void NodeHamLib::RetainRigLockScope() {
+  rig_lock_scope_.fetch_add(kRigLockScopeUser, std::memory_order_acq_rel);
+}
+
+void NodeHamLib::ReleaseRigLockScope() {
+  rig_lock_scope_.fetch_sub(kRigLockScopeUser, std::memory_order_acq_rel);
+}
+
+bool NodeHamLib::IsBackendSerialized(unsigned int model) {
+  std::lock_guard<std::mutex> guard(serializedBackendMutex());
+  return serializedBackendModels().count(model) > 0;
 }
 
-GlobalRigLock NodeHamLib::TryAcquireGlobalRigLockIfEnabled(std::chrono::milliseconds timeout) {
-  GlobalRigLock lock(global_rig_mutex_, std::defer_lock);
+GlobalRigLock NodeHamLib::TryAcquireRigLockIfEnabled(std::chrono::milliseconds timeout, RigLockScope* acquiredScope,
+                                                     RigCommandPriority priority) {
+  RigLockScope scope = GetRigLockScope();
+  const unsigned int backendModel = is_network_rig ? 2 : original_model;
+  if (scope != RigLockScope::Global && IsBackendSerialized(backendModel)) {
+    scope = RigLockScope::Global;
+  }
+
+  std::timed_mutex* mutex = nullptr;
+  if (scope == RigLockScope::Port) {
+    mutex = port_rig_mutex_.get();
+  } else if (scope == RigLockScope::Instance) {
+    mutex = instance_rig_mutex_.get();
+  }
+  if (!mutex) {
+    scope = RigLockScope::Global;
+  }
+  if (acquiredScope) {
+    *acquiredScope = scope;
+  }
+  if (scope == RigLockScope::Global) {
+    return TryAcquireGlobalRigLockIfEnabled(timeout, priority);
+  }
+
+  GlobalRigLock lock(*mutex, std::defer_lock);
   if (!IsGlobalRigLockEnabled()) {
     return lock;
   }
-  if (timeout.count() <= 0) {
-    lock.try_lock();
-  } else {
-    lock.try_lock_for(timeout);
-  }
+  RigLockArbiter::Global().Acquire(lock, timeout, priority);
   return lock;
 }
 
@@ -5146,6 +8495,49 @@ Napi::Value NodeHamLib::IsGlobalLockEnabled(const Napi::CallbackInfo& info) {
   return Napi::Boolean::New(info.Env(), IsGlobalRigLockEnabled());
 }
 
+Napi::Value NodeHamLib::SetLockScope(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected (scope: 'global' | 'port' | 'instance')").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  RigLockScope scope = RigLockScope::Global;
+  if (!parseRigLockScope(info[0].As<Napi::String>().Utf8Value(), &scope)) {
+    Napi::TypeError::New(env, "Invalid lock scope. Expected 'global', 'port' or 'instance'").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!SetRigLockScope(scope)) {
+    Napi::Error::New(env, "Lock scope cannot change while rig commands, poll rounds, tracking, raw streams or sweeps are running").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  return env.Undefined();
+}
+
+Napi::Value NodeHamLib::GetLockScope(const Napi::CallbackInfo& info) {
+  return Napi::String::New(info.Env(), rigLockScopeName(GetRigLockScope()));
+}
+
+Napi::Value NodeHamLib::SetBackendSerialized(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsBoolean()) {
+    Napi::TypeError::New(env, "Expected (model: number, serialized: boolean)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  const unsigned int model = info[0].As<Napi::Number>().Uint32Value();
+  std::lock_guard<std::mutex> guard(serializedBackendMutex());
+  if (info[1].As<Napi::Boolean>().Value()) {
+    serializedBackendModels().insert(model);
+  } else {
+    serializedBackendModels().erase(model);
+  }
+  return env.Undefined();
+}
+
 Napi::Value NodeHamLib::GetConfigSchemaForModel(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   if (info.Length() < 1 || !info[0].IsNumber()) {
@@ -5156,6 +8548,11 @@ Napi::Value NodeHamLib::GetConfigSchemaForModel(const Napi::CallbackInfo& info)
   unsigned int model = info[0].As<Napi::Number>().Uint32Value();
   RigConfigSchemaData schemaData{};
   int result = SHIM_RIG_OK;
+  std::shared_ptr<const RigModelIndex> index = RigModelIndex::Installed();
+  const RigModelIndexModel* indexed = index ? index->Find(model) : nullptr;
+  if (indexed && index->ForEachConfigParam(*indexed, NodeHamLib::rig_config_callback, &schemaData) == SHIM_RIG_OK) {
+    return rigConfigSchemaToArray(env, schemaData);
+  }
   {
     std::lock_guard<std::mutex> metadataLock(MetadataMutex());
     hamlib_shim_handle_t rig = shim_rig_init(model);
@@ -5184,6 +8581,11 @@ Napi::Value NodeHamLib::GetPortCapsForModel(const Napi::CallbackInfo& info) {
   unsigned int model = info[0].As<Napi::Number>().Uint32Value();
   shim_rig_port_caps_t caps{};
   int result = SHIM_RIG_OK;
+  std::shared_ptr<const RigModelIndex> index = RigModelIndex::Installed();
+  const RigModelIndexModel* indexed = index ? index->Find(model) : nullptr;
+  if (indexed && index->PortCaps(*indexed, &caps)) {
+    return portCapsToObject(env, caps);
+  }
   {
     std::lock_guard<std::mutex> metadataLock(MetadataMutex());
     hamlib_shim_handle_t rig = shim_rig_init(model);
@@ -5202,6 +8604,61 @@ Napi::Value NodeHamLib::GetPortCapsForModel(const Napi::CallbackInfo& info) {
   return portCapsToObject(env, caps);
 }
 
+static Napi::Object modelIndexInfoToObject(Napi::Env env, const RigModelIndex& index) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("path", Napi::String::New(env, index.Path()));
+  obj.Set("models", Napi::Number::New(env, static_cast<double>(index.ModelCount())));
+  obj.Set("bytes", Napi::Number::New(env, static_cast<double>(index.Bytes())));
+  obj.Set("hamlibVersion", Napi::String::New(env, index.HamlibVersion()));
+  return obj;
+}
+
+Napi::Value NodeHamLib::BuildModelIndex(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected (path: string)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  const std::string path = info[0].As<Napi::String>().Utf8Value();
+  RigModelIndexBuildStats stats;
+  std::string error;
+  if (!RigModelIndex::Build(path, MetadataMutex(), &stats, &error)) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("path", Napi::String::New(env, path));
+  obj.Set("models", Napi::Number::New(env, static_cast<double>(stats.models)));
+  obj.Set("incomplete", Napi::Number::New(env, static_cast<double>(stats.incomplete)));
+  obj.Set("bytes", Napi::Number::New(env, static_cast<double>(stats.bytes)));
+  return obj;
+}
+
+Napi::Value NodeHamLib::LoadModelIndex(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected (path: string)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::string error;
+  std::shared_ptr<const RigModelIndex> index = RigModelIndex::Open(info[0].As<Napi::String>().Utf8Value(), &error);
+  if (!index) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  RigModelIndex::Install(index);
+  return modelIndexInfoToObject(env, *index);
+}
+
+Napi::Value NodeHamLib::GetModelIndexInfo(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  std::shared_ptr<const RigModelIndex> index = RigModelIndex::Installed();
+  if (!index) {
+    return env.Null();
+  }
+  return modelIndexInfoToObject(env, *index);
+}
+
 // Serial Port Configuration Methods
 
 // Set serial configuration parameter (data_bits, stop_bits, parity, handshake, etc.)
@@ -5488,9 +8945,9 @@ Napi::Value NodeHamLib::GetPtt(const Napi::CallbackInfo& info) {
   int vfo = parseVfoParameter(info, 0, SHIM_RIG_VFO_CURR);
   RETURN_NULL_IF_INVALID_VFO(vfo);
   
-  GetPttAsyncWorker* asyncWorker = new GetPttAsyncWorker(env, this, vfo);
-  asyncWorker->Queue();
-  return asyncWorker->GetPromise();
+  return QueueCoalescedRead(env, coalesceKey("GetPtt", vfo), [&]() -> HamLibAsyncWorker* {
+    return new GetPttAsyncWorker(env, this, vfo);
+  });
 }
 
 // Data Carrier Detect
@@ -6151,6 +9608,7 @@ public:
         : HamLibAsyncWorker(env, hamlib_instance), vfo_(vfo), msg_(msg) {}
 
     const char* OperationName() const override { return "SendMorse"; }
+    RigCommandPriority DefaultPriority() const override { return RigCommandPriority::Realtime; }
     
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
@@ -6186,6 +9644,7 @@ public:
         : HamLibAsyncWorker(env, hamlib_instance), vfo_(vfo) {}
 
     const char* OperationName() const override { return "StopMorse"; }
+    RigCommandPriority DefaultPriority() const override { return RigCommandPriority::Realtime; }
     
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
@@ -6223,6 +9682,10 @@ public:
     
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
+        if (call_control_) {
+            WaitInSteps();
+            return;
+        }
         
         result_code_ = shim_rig_wait_morse(hamlib_instance_->my_rig, vfo_);
         if (result_code_ != SHIM_RIG_OK) {
@@ -6245,6 +9708,37 @@ public:
     }
     
 private:
+    // rig_wait_morse() polls PTT until the keyer releases it and cannot be
+    // interrupted; this is the same loop (200 ms lead-in, 25 ms polls, 15 s
+    // cap) with the call scope checked between polls.
+    void WaitInSteps() {
+        const std::chrono::milliseconds leadIn(200);
+        const std::chrono::milliseconds poll(25);
+        const auto started = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - started < leadIn) {
+            if (CallStopped()) {
+                return;
+            }
+            std::this_thread::sleep_for(poll);
+        }
+        for (int loops = 0; loops <= 600; ++loops) {
+            if (CallStopped()) {
+                return;
+            }
+            int ptt = SHIM_RIG_PTT_OFF;
+            result_code_ = shim_rig_get_ptt(hamlib_instance_->my_rig, vfo_, &ptt);
+            if (result_code_ != SHIM_RIG_OK) {
+                error_message_ = shim_rigerror(result_code_);
+                return;
+            }
+            if (ptt != SHIM_RIG_PTT_ON) {
+                return;
+            }
+            std::this_thread::sleep_for(poll);
+        }
+        result_code_ = SHIM_RIG_OK;
+    }
+
     int vfo_;
 };
 
@@ -6406,6 +9900,7 @@ public:
         : HamLibAsyncWorker(env, hamlib_instance), reset_(reset) {}
 
     const char* OperationName() const override { return "Reset"; }
+    bool InvalidatesStateCache() const override { return true; }
     
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
@@ -6557,7 +10052,7 @@ Napi::Value NodeHamLib::SetParm(const Napi::CallbackInfo& info) {
   }
   
   std::string parm_str = info[0].As<Napi::String>().Utf8Value();
-  uint64_t parm = shim_rig_parse_parm(parm_str.c_str());
+  uint64_t parm = parseParmName(parm_str);
   
   if (parm == 0) {
     Napi::Error::New(env, "Invalid parameter name: " + parm_str).ThrowAsJavaScriptException();
@@ -6580,7 +10075,7 @@ Napi::Value NodeHamLib::GetParm(const Napi::CallbackInfo& info) {
   }
   
   std::string parm_str = info[0].As<Napi::String>().Utf8Value();
-  uint64_t parm = shim_rig_parse_parm(parm_str.c_str());
+  uint64_t parm = parseParmName(parm_str);
   
   if (parm == 0) {
     Napi::Error::New(env, "Invalid parameter name: " + parm_str).ThrowAsJavaScriptException();
@@ -6777,36 +10272,47 @@ Napi::Value NodeHamLib::GetSplitFreqMode(const Napi::CallbackInfo& info) {
   return asyncWorker->GetPromise();
 }
 
-// Power2mW Method Implementation  
-Napi::Value NodeHamLib::Power2mW(const Napi::CallbackInfo& info) {
+// (power, frequency, mode) shared by power2mW and power2mWSync; false after throwing.
+static bool readPower2mWArgs(const Napi::CallbackInfo& info, float* power, double* freq, int* mode) {
   Napi::Env env = info.Env();
-  
-  
   if (info.Length() < 3 || !info[0].IsNumber() || !info[1].IsNumber() || !info[2].IsString()) {
     Napi::TypeError::New(env, "Expected power2mW(power, frequency, mode)").ThrowAsJavaScriptException();
-    return env.Null();
+    return false;
   }
   
-  float power = info[0].As<Napi::Number>().FloatValue();
-  double freq = info[1].As<Napi::Number>().DoubleValue();
+  *power = info[0].As<Napi::Number>().FloatValue();
+  *freq = info[1].As<Napi::Number>().DoubleValue();
   std::string mode_str = info[2].As<Napi::String>().Utf8Value();
   
   // Validate power (0.0 to 1.0)
-  if (power < 0.0 || power > 1.0) {
+  if (*power < 0.0 || *power > 1.0) {
     Napi::Error::New(env, "Power must be between 0.0 and 1.0").ThrowAsJavaScriptException();
-    return env.Null();
+    return false;
   }
   
   // Validate frequency range
-  if (freq < 1000 || freq > 10000000000) { // 1 kHz to 10 GHz
+  if (*freq < 1000 || *freq > 10000000000) { // 1 kHz to 10 GHz
     Napi::Error::New(env, "Frequency out of range (1 kHz - 10 GHz)").ThrowAsJavaScriptException();
-    return env.Null();
+    return false;
   }
   
   // Parse mode string
-  int mode = shim_rig_parse_mode(mode_str.c_str());
-  if (mode == SHIM_RIG_MODE_NONE) {
+  *mode = shim_rig_parse_mode(mode_str.c_str());
+  if (*mode == SHIM_RIG_MODE_NONE) {
     Napi::Error::New(env, "Invalid mode: " + mode_str).ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+// Power2mW Method Implementation  
+Napi::Value NodeHamLib::Power2mW(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  float power = 0;
+  double freq = 0;
+  int mode = SHIM_RIG_MODE_NONE;
+  if (!readPower2mWArgs(info, &power, &freq, &mode)) {
     return env.Null();
   }
   
@@ -6815,36 +10321,47 @@ Napi::Value NodeHamLib::Power2mW(const Napi::CallbackInfo& info) {
   return asyncWorker->GetPromise();
 }
 
-// MW2Power Method Implementation
-Napi::Value NodeHamLib::MW2Power(const Napi::CallbackInfo& info) {
+// (milliwatts, frequency, mode) shared by mW2power and mW2powerSync; false after throwing.
+static bool readMW2PowerArgs(const Napi::CallbackInfo& info, unsigned int* mwpower, double* freq, int* mode) {
   Napi::Env env = info.Env();
-  
-  
   if (info.Length() < 3 || !info[0].IsNumber() || !info[1].IsNumber() || !info[2].IsString()) {
     Napi::TypeError::New(env, "Expected mW2power(milliwatts, frequency, mode)").ThrowAsJavaScriptException();
-    return env.Null();
+    return false;
   }
   
-  unsigned int mwpower = info[0].As<Napi::Number>().Uint32Value();
-  double freq = info[1].As<Napi::Number>().DoubleValue();
+  *mwpower = info[0].As<Napi::Number>().Uint32Value();
+  *freq = info[1].As<Napi::Number>().DoubleValue();
   std::string mode_str = info[2].As<Napi::String>().Utf8Value();
   
   // Validate milliwatts (reasonable range)
-  if (mwpower > 10000000) { // 10kW max
+  if (*mwpower > 10000000) { // 10kW max
     Napi::Error::New(env, "Milliwatts out of reasonable range (max 10,000,000 mW)").ThrowAsJavaScriptException();
-    return env.Null();
+    return false;
   }
   
   // Validate frequency range
-  if (freq < 1000 || freq > 10000000000) { // 1 kHz to 10 GHz
+  if (*freq < 1000 || *freq > 10000000000) { // 1 kHz to 10 GHz
     Napi::Error::New(env, "Frequency out of range (1 kHz - 10 GHz)").ThrowAsJavaScriptException();
-    return env.Null();
+    return false;
   }
   
   // Parse mode string
-  int mode = shim_rig_parse_mode(mode_str.c_str());
-  if (mode == SHIM_RIG_MODE_NONE) {
+  *mode = shim_rig_parse_mode(mode_str.c_str());
+  if (*mode == SHIM_RIG_MODE_NONE) {
     Napi::Error::New(env, "Invalid mode: " + mode_str).ThrowAsJavaScriptException();
+    return false;
+  }
+  return true;
+}
+
+// MW2Power Method Implementation
+Napi::Value NodeHamLib::MW2Power(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  
+  unsigned int mwpower = 0;
+  double freq = 0;
+  int mode = SHIM_RIG_MODE_NONE;
+  if (!readMW2PowerArgs(info, &mwpower, &freq, &mode)) {
     return env.Null();
   }
   
@@ -6853,6 +10370,40 @@ Napi::Value NodeHamLib::MW2Power(const Napi::CallbackInfo& info) {
   return asyncWorker->GetPromise();
 }
 
+// Answered from the capability snapshot when the backend uses Hamlib's
+// range-based conversion; null when only the backend (or the rig) can say.
+Napi::Value NodeHamLib::Power2mWSync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  float power = 0;
+  double freq = 0;
+  int mode = SHIM_RIG_MODE_NONE;
+  if (!readPower2mWArgs(info, &power, &freq, &mode)) {
+    return env.Null();
+  }
+  std::shared_ptr<const RigCapabilitySnapshot> caps = CapabilitySnapshot();
+  unsigned int mwpower = 0;
+  if (!caps || !caps->Power2mW(power, freq, static_cast<uint64_t>(mode), &mwpower)) {
+    return env.Null();
+  }
+  return Napi::Number::New(env, mwpower);
+}
+
+Napi::Value NodeHamLib::MW2PowerSync(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  unsigned int mwpower = 0;
+  double freq = 0;
+  int mode = SHIM_RIG_MODE_NONE;
+  if (!readMW2PowerArgs(info, &mwpower, &freq, &mode)) {
+    return env.Null();
+  }
+  std::shared_ptr<const RigCapabilitySnapshot> caps = CapabilitySnapshot();
+  float power = 0;
+  if (!caps || !caps->MW2Power(mwpower, freq, static_cast<uint64_t>(mode), &power)) {
+    return env.Null();
+  }
+  return Napi::Number::New(env, power);
+}
+
 // Reset Function Method Implementation
 Napi::Value NodeHamLib::Reset(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
@@ -7156,285 +10707,902 @@ private:
     int satmode_;
 };
 
-Napi::Value NodeHamLib::GetVfoInfo(const Napi::CallbackInfo& info) {
+Napi::Value NodeHamLib::GetVfoInfo(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  int vfo = parseVfoParameter(info, 0, SHIM_RIG_VFO_CURR);
+  RETURN_NULL_IF_INVALID_VFO(vfo);
+
+  GetVfoInfoAsyncWorker* asyncWorker = new GetVfoInfoAsyncWorker(env, this, vfo);
+  asyncWorker->Queue();
+  return asyncWorker->GetPromise();
+}
+
+// ===== GetInfo (async) =====
+
+class GetInfoAsyncWorker : public HamLibAsyncWorker {
+public:
+    GetInfoAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance)
+        : HamLibAsyncWorker(env, hamlib_instance) {}
+
+    const char* OperationName() const override { return "GetInfo"; }
+
+    void ExecuteWithRigLock() override {
+        CHECK_RIG_VALID();
+        const char* info = shim_rig_get_info(hamlib_instance_->my_rig);
+        info_str_ = info ? info : "";
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        if (result_code_ != SHIM_RIG_OK && !error_message_.empty()) {
+            deferred_.Reject(Napi::Error::New(env, error_message_).Value());
+        } else {
+            deferred_.Resolve(Napi::String::New(env, info_str_));
+        }
+    }
+
+    void OnError(const Napi::Error& e) override {
+        deferred_.Reject(Napi::Error::New(Env(), error_message_).Value());
+    }
+
+private:
+    std::string info_str_;
+};
+
+Napi::Value NodeHamLib::GetInfo(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+
+  GetInfoAsyncWorker* asyncWorker = new GetInfoAsyncWorker(env, this);
+  asyncWorker->Queue();
+  return asyncWorker->GetPromise();
+}
+
+// ===== SendRaw (async) =====
+
+constexpr int kMaxRawReplyBytes = 65536;
+
+// sendRaw() snapshots the command and resolves with an exact-size copy of the
+// reply. sendRawInto() sends straight from the caller's Buffer and lets Hamlib
+// write the reply straight into the caller's output Buffer; both stay
+// referenced until the promise settles.
+class SendRawAsyncWorker : public HamLibAsyncWorker {
+public:
+    // sendRaw()
+    SendRawAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance, Napi::Buffer<unsigned char> send,
+                       int reply_max_len, Napi::Buffer<unsigned char> terminator)
+        : HamLibAsyncWorker(env, hamlib_instance),
+          send_copy_(send.Data(), send.Data() + send.Length()),
+          reply_copy_(static_cast<size_t>(std::max(reply_max_len, 1))),
+          reply_max_len_(reply_max_len), resolve_length_(false), reply_len_(0) {
+        if (!terminator.IsEmpty()) {
+            terminator_copy_.assign(terminator.Data(), terminator.Data() + terminator.Length());
+        }
+        send_data_ = send_copy_.data();
+        send_len_ = static_cast<int>(send_copy_.size());
+        reply_data_ = reply_copy_.data();
+        terminator_ = terminator_copy_.empty() ? nullptr : terminator_copy_.data();
+    }
+
+    // sendRawInto()
+    SendRawAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance, Napi::Buffer<unsigned char> send,
+                       Napi::Buffer<unsigned char> reply, Napi::Buffer<unsigned char> terminator)
+        : HamLibAsyncWorker(env, hamlib_instance),
+          reply_max_len_(static_cast<int>(reply.Length())), resolve_length_(true), reply_len_(0) {
+        send_data_ = send.Data();
+        send_len_ = static_cast<int>(send.Length());
+        reply_data_ = reply.Data();
+        terminator_ = terminator.IsEmpty() ? nullptr : terminator.Data();
+        send_ref_ = Napi::Persistent(static_cast<Napi::Object>(send));
+        reply_ref_ = Napi::Persistent(static_cast<Napi::Object>(reply));
+        if (!terminator.IsEmpty()) {
+            terminator_ref_ = Napi::Persistent(static_cast<Napi::Object>(terminator));
+        }
+    }
+
+    const char* OperationName() const override { return "SendRaw"; }
+    bool InvalidatesStateCache() const override { return true; }
+
+    void ExecuteWithRigLock() override {
+        CHECK_RIG_VALID();
+        result_code_ = shim_rig_send_raw(hamlib_instance_->my_rig,
+            send_data_, send_len_, reply_data_, reply_max_len_, terminator_);
+        if (result_code_ < 0) {
+            error_message_ = shim_rigerror(result_code_);
+        } else {
+            reply_len_ = std::min(result_code_, reply_max_len_);
+            result_code_ = SHIM_RIG_OK;
+        }
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        if (!error_message_.empty()) {
+            deferred_.Reject(Napi::Error::New(env, error_message_).Value());
+        } else if (resolve_length_) {
+            deferred_.Resolve(Napi::Number::New(env, reply_len_));
+        } else {
+            deferred_.Resolve(Napi::Buffer<unsigned char>::Copy(env, reply_copy_.data(), reply_len_));
+        }
+    }
+
+    void OnError(const Napi::Error& e) override {
+        deferred_.Reject(Napi::Error::New(Env(), error_message_).Value());
+    }
+
+private:
+    std::vector<unsigned char> send_copy_;
+    std::vector<unsigned char> reply_copy_;
+    std::vector<unsigned char> terminator_copy_;
+    Napi::ObjectReference send_ref_;
+    Napi::ObjectReference reply_ref_;
+    Napi::ObjectReference terminator_ref_;
+    const unsigned char* send_data_ = nullptr;
+    int send_len_ = 0;
+    unsigned char* reply_data_ = nullptr;
+    int reply_max_len_;
+    const unsigned char* terminator_ = nullptr;
+    bool resolve_length_;
+    int reply_len_;
+};
+
+// Optional trailing terminator Buffer at info[index]; false after throwing.
+static bool readRawTerminator(Napi::Env env, const Napi::CallbackInfo& info, size_t index,
+                              Napi::Buffer<unsigned char>* terminator) {
+  if (info.Length() <= index || info[index].IsUndefined() || info[index].IsNull()) {
+    return true;
+  }
+  if (!info[index].IsBuffer() || info[index].As<Napi::Buffer<unsigned char>>().Length() == 0) {
+    Napi::TypeError::New(env, "terminator must be a non-empty Buffer").ThrowAsJavaScriptException();
+    return false;
+  }
+  *terminator = info[index].As<Napi::Buffer<unsigned char>>();
+  return true;
+}
+
+Napi::Value NodeHamLib::SendRaw(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+
+  if (info.Length() < 2 || !info[0].IsBuffer() || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (data: Buffer, replyMaxLen: number, terminator?: Buffer)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  const double replyMaxLen = info[1].As<Napi::Number>().DoubleValue();
+  if (!(replyMaxLen >= 0 && replyMaxLen <= kMaxRawReplyBytes)) {
+    Napi::RangeError::New(env, "replyMaxLen must be between 0 and " + std::to_string(kMaxRawReplyBytes))
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  Napi::Buffer<unsigned char> terminator;
+  if (!readRawTerminator(env, info, 2, &terminator)) {
+    return env.Null();
+  }
+
+  SendRawAsyncWorker* asyncWorker = new SendRawAsyncWorker(env, this, info[0].As<Napi::Buffer<unsigned char>>(),
+    static_cast<int>(replyMaxLen), terminator);
+  asyncWorker->Queue();
+  return asyncWorker->GetPromise();
+}
+
+Napi::Value NodeHamLib::SendRawInto(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
 
-  int vfo = parseVfoParameter(info, 0, SHIM_RIG_VFO_CURR);
-  RETURN_NULL_IF_INVALID_VFO(vfo);
+  if (info.Length() < 2 || !info[0].IsBuffer() || !info[1].IsBuffer()) {
+    Napi::TypeError::New(env, "Expected (data: Buffer, reply: Buffer, terminator?: Buffer)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  Napi::Buffer<unsigned char> reply = info[1].As<Napi::Buffer<unsigned char>>();
+  if (reply.Length() == 0 || reply.Length() > static_cast<size_t>(kMaxRawReplyBytes)) {
+    Napi::RangeError::New(env, "reply must hold between 1 and " + std::to_string(kMaxRawReplyBytes) + " bytes")
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  Napi::Buffer<unsigned char> terminator;
+  if (!readRawTerminator(env, info, 2, &terminator)) {
+    return env.Null();
+  }
 
-  GetVfoInfoAsyncWorker* asyncWorker = new GetVfoInfoAsyncWorker(env, this, vfo);
+  SendRawAsyncWorker* asyncWorker = new SendRawAsyncWorker(env, this, info[0].As<Napi::Buffer<unsigned char>>(),
+    reply, terminator);
   asyncWorker->Queue();
   return asyncWorker->GetPromise();
 }
 
-// ===== GetInfo (async) =====
 
-class GetInfoAsyncWorker : public HamLibAsyncWorker {
-public:
-    GetInfoAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance)
-        : HamLibAsyncWorker(env, hamlib_instance) {}
+constexpr double kMaxRawFrameBytes = 65536;
+constexpr double kMaxRawPoolFrames = 4096;
 
-    const char* OperationName() const override { return "GetInfo"; }
+static void stopRigRawStream(std::shared_ptr<RigRawStream>& stream) {
+  if (stream) {
+    stream->Stop();
+    stream.reset();
+  }
+}
 
-    void ExecuteWithRigLock() override {
-        CHECK_RIG_VALID();
-        const char* info = shim_rig_get_info(hamlib_instance_->my_rig);
-        info_str_ = info ? info : "";
-    }
+Napi::Value NodeHamLib::StartRawStream(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
 
-    void OnOK() override {
-        Napi::Env env = Env();
-        if (result_code_ != SHIM_RIG_OK && !error_message_.empty()) {
-            deferred_.Reject(Napi::Error::New(env, error_message_).Value());
-        } else {
-            deferred_.Resolve(Napi::String::New(env, info_str_));
-        }
+  if (info.Length() < 2 || !info[0].IsObject() || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (options: { terminator: Buffer, command?: Buffer }, callback: Function)")
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  Napi::Object input = info[0].As<Napi::Object>();
+  RawStreamOptions options;
+  Napi::Value terminator = input.Get("terminator");
+  if (!terminator.IsBuffer() || terminator.As<Napi::Buffer<unsigned char>>().Length() == 0) {
+    Napi::TypeError::New(env, "terminator must be a non-empty Buffer").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  Napi::Buffer<unsigned char> terminatorBuf = terminator.As<Napi::Buffer<unsigned char>>();
+  options.terminator.assign(terminatorBuf.Data(), terminatorBuf.Data() + terminatorBuf.Length());
+  Napi::Value command = input.Get("command");
+  if (!command.IsUndefined() && !command.IsNull()) {
+    if (!command.IsBuffer()) {
+      Napi::TypeError::New(env, "command must be a Buffer").ThrowAsJavaScriptException();
+      return env.Null();
     }
+    Napi::Buffer<unsigned char> commandBuf = command.As<Napi::Buffer<unsigned char>>();
+    options.command.assign(commandBuf.Data(), commandBuf.Data() + commandBuf.Length());
+  }
+  double frameBytes = static_cast<double>(options.frame_bytes);
+  double poolFrames = static_cast<double>(options.pool_frames);
+  double maxFrames = 0;
+  if (!readTrackingNumber(env, input, "frameBytes", 1, kMaxRawFrameBytes, &frameBytes)
+      || !readTrackingNumber(env, input, "poolFrames", 1, kMaxRawPoolFrames, &poolFrames)
+      || !readTrackingNumber(env, input, "maxFrames", 0, 1e12, &maxFrames)) {
+    return env.Null();
+  }
+  options.frame_bytes = static_cast<size_t>(frameBytes);
+  options.pool_frames = static_cast<size_t>(poolFrames);
+  options.max_frames = static_cast<uint64_t>(maxFrames);
 
-    void OnError(const Napi::Error& e) override {
-        deferred_.Reject(Napi::Error::New(Env(), error_message_).Value());
+  if (!rig_is_open.load(std::memory_order_acquire)) {
+    Napi::Error::New(env, "Rig is not open!").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  stopRigRawStream(raw_stream_);
+  raw_stream_ = std::make_shared<RigRawStream>(this, std::move(options));
+  raw_stream_->Start(env, info[1].As<Napi::Function>());
+  return env.Undefined();
+}
+
+Napi::Value NodeHamLib::StopRawStream(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  const bool running = raw_stream_ && raw_stream_->Running();
+  if (raw_stream_) {
+    // Keep the counters around for getRawStreamStatus().
+    raw_stream_->Stop();
+  }
+  return Napi::Boolean::New(env, running);
+}
+
+Napi::Value NodeHamLib::GetRawStreamStatus(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (!raw_stream_) {
+    return env.Null();
+  }
+  const RawStreamStats stats = raw_stream_->GetStats();
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("running", Napi::Boolean::New(env, stats.running));
+  obj.Set("frames", Napi::Number::New(env, static_cast<double>(stats.frames)));
+  obj.Set("bytes", Napi::Number::New(env, static_cast<double>(stats.bytes)));
+  obj.Set("pending", Napi::Number::New(env, static_cast<double>(stats.pending)));
+  obj.Set("stalls", Napi::Number::New(env, static_cast<double>(stats.stalls)));
+  obj.Set("frameBytes", Napi::Number::New(env, static_cast<double>(stats.pool.frame_bytes)));
+  obj.Set("poolFrames", Napi::Number::New(env, static_cast<double>(stats.pool.capacity)));
+  obj.Set("inUse", Napi::Number::New(env, static_cast<double>(stats.pool.in_use)));
+  obj.Set("poolMisses", Napi::Number::New(env, static_cast<double>(stats.pool.pool_misses)));
+  return obj;
+}
+
+
+// ===== Frequency sweep =====
+
+constexpr double kMaxSweepDwellMs = 1000;
+constexpr size_t kMaxSweepPoints = sizeof(shim_spectrum_line_t::data);
+
+static void stopRigSweep(std::shared_ptr<RigSweep>& sweep) {
+  if (sweep) {
+    sweep->Stop();
+    sweep.reset();
+  }
+}
+
+Napi::Value NodeHamLib::StartSweep(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsObject() || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (options: { startFreq: number, stopFreq: number, stepHz: number }, callback: Function)")
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  Napi::Object input = info[0].As<Napi::Object>();
+  for (const char* name : { "startFreq", "stopFreq", "stepHz" }) {
+    if (!input.Has(name) || input.Get(name).IsUndefined()) {
+      Napi::TypeError::New(env, std::string(name) + " is required").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+  SweepOptions options;
+  double stopHz = 0;
+  double dwellMs = 0;
+  double chunkPoints = 16;
+  double sweeps = 0;
+  double scopeId = 0;
+  if (!readTrackingNumber(env, input, "startFreq", 1000, 10000000000, &options.start_hz)
+      || !readTrackingNumber(env, input, "stopFreq", 1000, 10000000000, &stopHz)
+      || !readTrackingNumber(env, input, "stepHz", 1, 1e9, &options.step_hz)
+      || !readTrackingNumber(env, input, "dwellMs", 0, kMaxSweepDwellMs, &dwellMs)
+      || !readTrackingNumber(env, input, "chunkPoints", 1, static_cast<double>(kMaxSweepPoints), &chunkPoints)
+      || !readTrackingNumber(env, input, "sweeps", 0, 1e9, &sweeps)
+      || !readTrackingNumber(env, input, "scopeId", 0, 255, &scopeId)
+      || !readTrackingNumber(env, input, "strengthMinDb", -200, 200, &options.strength_min_db)
+      || !readTrackingNumber(env, input, "strengthMaxDb", -200, 200, &options.strength_max_db)) {
+    return env.Null();
+  }
+  const double points = std::floor((stopHz - options.start_hz) / options.step_hz + 1e-9) + 1;
+  if (stopHz <= options.start_hz || points < 2 || points > static_cast<double>(kMaxSweepPoints)) {
+    Napi::RangeError::New(env, "A sweep needs stopFreq above startFreq and between 2 and "
+      + std::to_string(kMaxSweepPoints) + " points").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  if (options.strength_min_db >= options.strength_max_db) {
+    Napi::RangeError::New(env, "strengthMinDb must be below strengthMaxDb").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  if (input.Has("restoreFrequency") && !input.Get("restoreFrequency").IsUndefined()) {
+    if (!input.Get("restoreFrequency").IsBoolean()) {
+      Napi::TypeError::New(env, "restoreFrequency must be a boolean").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    options.restore_frequency = input.Get("restoreFrequency").As<Napi::Boolean>().Value();
+  }
+  if (input.Has("vfo") && !input.Get("vfo").IsUndefined()) {
+    if (!input.Get("vfo").IsString()) {
+      Napi::TypeError::New(env, "vfo must be a string").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    options.vfo = parseVfoString(env, input.Get("vfo").As<Napi::String>().Utf8Value());
+    if (options.vfo == kInvalidVfoParameter) {
+      return env.Null();
     }
+  }
+  options.points = static_cast<size_t>(points);
+  options.dwell = std::chrono::milliseconds(static_cast<int64_t>(dwellMs));
+  options.chunk_points = static_cast<size_t>(chunkPoints);
+  options.sweeps = static_cast<uint64_t>(sweeps);
+  options.scope_id = static_cast<int>(scopeId);
 
-private:
-    std::string info_str_;
-};
+  if (!rig_is_open.load(std::memory_order_acquire)) {
+    Napi::Error::New(env, "Rig is not open!").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  if (!spectrum_stream_running_.load(std::memory_order_acquire)) {
+    Napi::Error::New(env, "Spectrum stream is not running; sweep lines are delivered through startSpectrumStream()")
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
 
-Napi::Value NodeHamLib::GetInfo(const Napi::CallbackInfo& info) {
+  stopRigSweep(sweep_);
+  sweep_ = std::make_shared<RigSweep>(this, std::move(options));
+  sweep_->Start(env, info[1].As<Napi::Function>());
+  return env.Undefined();
+}
+
+Napi::Value NodeHamLib::StopSweep(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  const bool running = sweep_ && sweep_->Running();
+  if (sweep_) {
+    // Keep the counters around for getSweepStatus().
+    sweep_->Stop();
+  }
+  return Napi::Boolean::New(env, running);
+}
+
+Napi::Value NodeHamLib::GetSweepStatus(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+  if (!sweep_) {
+    return env.Null();
+  }
+  const SweepStats stats = sweep_->GetStats();
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("running", Napi::Boolean::New(env, stats.running));
+  obj.Set("points", Napi::Number::New(env, static_cast<double>(stats.points)));
+  obj.Set("sweeps", Napi::Number::New(env, static_cast<double>(stats.sweeps)));
+  obj.Set("readings", Napi::Number::New(env, static_cast<double>(stats.readings)));
+  obj.Set("errors", Napi::Number::New(env, static_cast<double>(stats.errors)));
+  obj.Set("unsentLines", Napi::Number::New(env, static_cast<double>(stats.unsent_lines)));
+  obj.Set("lastSweepMs", Napi::Number::New(env, stats.last_sweep_ms));
+  return obj;
+}
 
 
-  GetInfoAsyncWorker* asyncWorker = new GetInfoAsyncWorker(env, this);
-  asyncWorker->Queue();
-  return asyncWorker->GetPromise();
+static Napi::Object spectrumCapabilitiesToObject(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("asyncDataSupported", Napi::Boolean::New(env, caps.async_data_supported));
+  Napi::Array scopes = Napi::Array::New(env, caps.spectrum_scopes.size());
+  for (size_t i = 0; i < caps.spectrum_scopes.size(); ++i) {
+    Napi::Object scopeObject = Napi::Object::New(env);
+    scopeObject.Set("id", Napi::Number::New(env, caps.spectrum_scopes[i].id));
+    scopeObject.Set("name", Napi::String::New(env, caps.spectrum_scopes[i].name));
+    scopes[static_cast<uint32_t>(i)] = scopeObject;
+  }
+  result.Set("scopes", scopes);
+  Napi::Array modes = Napi::Array::New(env, caps.spectrum_modes.size());
+  for (size_t i = 0; i < caps.spectrum_modes.size(); ++i) {
+    Napi::Object modeObject = Napi::Object::New(env);
+    modeObject.Set("id", Napi::Number::New(env, caps.spectrum_modes[i].first));
+    modeObject.Set("name", Napi::String::New(env, caps.spectrum_modes[i].second));
+    modes[static_cast<uint32_t>(i)] = modeObject;
+  }
+  result.Set("modes", modes);
+  result.Set("spans", DoubleVectorToArray(env, caps.spectrum_spans));
+  Napi::Array avgModes = Napi::Array::New(env, caps.spectrum_avg_modes.size());
+  for (size_t i = 0; i < caps.spectrum_avg_modes.size(); ++i) {
+    Napi::Object avgModeObject = Napi::Object::New(env);
+    avgModeObject.Set("id", Napi::Number::New(env, caps.spectrum_avg_modes[i].id));
+    avgModeObject.Set("name", Napi::String::New(env, caps.spectrum_avg_modes[i].name));
+    avgModes[static_cast<uint32_t>(i)] = avgModeObject;
+  }
+  result.Set("avgModes", avgModes);
+  return result;
 }
 
-// ===== SendRaw (async) =====
+static Napi::Value spectrumCapabilitiesValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return spectrumCapabilitiesToObject(env, caps);
+}
 
-class SendRawAsyncWorker : public HamLibAsyncWorker {
+Napi::Value NodeHamLib::GetSpectrumCapabilities(const Napi::CallbackInfo& info) {
+  return QueueCapabilityQuery(info.Env(), "GetSpectrumCapabilities", spectrumCapabilitiesValue);
+}
+
+Napi::Value NodeHamLib::GetSpectrumCapabilitiesSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, spectrumCapabilitiesValue);
+}
+
+
+
+class StartSpectrumStreamAsyncWorker : public HamLibAsyncWorker {
 public:
-    SendRawAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance,
-                       std::vector<unsigned char> send_data, int reply_max_len,
-                       std::vector<unsigned char> terminator, bool has_terminator)
-        : HamLibAsyncWorker(env, hamlib_instance),
-          send_data_(std::move(send_data)), reply_max_len_(reply_max_len),
-          terminator_(std::move(terminator)), has_terminator_(has_terminator),
-          reply_len_(0) {
-        reply_buf_.resize(reply_max_len > 0 ? reply_max_len : 1);
-    }
+    StartSpectrumStreamAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance, Napi::ThreadSafeFunction tsfn,
+                                   std::shared_ptr<SpectrumLineRing> ring,
+                                   std::shared_ptr<SpectrumLineProcessor> processor)
+        : HamLibAsyncWorker(env, hamlib_instance), tsfn_(tsfn), ring_(std::move(ring)),
+          processor_(std::move(processor)) {}
 
-    const char* OperationName() const override { return "SendRaw"; }
+    const char* OperationName() const override { return "StartSpectrumStream"; }
 
     void ExecuteWithRigLock() override {
         CHECK_RIG_VALID();
-        const unsigned char* term = has_terminator_ ? terminator_.data() : nullptr;
-        result_code_ = shim_rig_send_raw(hamlib_instance_->my_rig,
-            send_data_.data(), (int)send_data_.size(),
-            reply_buf_.data(), reply_max_len_, term);
-        if (result_code_ < 0) {
+        if (!hamlib_instance_->rig_is_open.load(std::memory_order_acquire)) {
+            result_code_ = SHIM_RIG_EINVAL;
+            error_message_ = "Rig is not open!";
+            tsfn_.Release();
+            tsfn_released_ = true;
+            return;
+        }
+        std::lock_guard<std::mutex> lock(hamlib_instance_->spectrum_mutex_);
+        if (hamlib_instance_->spectrum_stream_running_) {
+            result_code_ = SHIM_RIG_EINVAL;
+            error_message_ = "Spectrum stream is already running";
+            tsfn_.Release();
+            tsfn_released_ = true;
+            return;
+        }
+        hamlib_instance_->spectrum_tsfn_ = tsfn_;
+        hamlib_instance_->spectrum_ring_ = ring_;
+        hamlib_instance_->spectrum_processor_ = processor_;
+        result_code_ = shim_rig_set_spectrum_callback(hamlib_instance_->my_rig, &NodeHamLib::spectrum_line_cb, hamlib_instance_);
+        if (result_code_ != SHIM_RIG_OK) {
             error_message_ = shim_rigerror(result_code_);
-        } else {
-            reply_len_ = result_code_;
-            result_code_ = SHIM_RIG_OK;
+            hamlib_instance_->spectrum_tsfn_.Release();
+            hamlib_instance_->spectrum_tsfn_ = Napi::ThreadSafeFunction();
+            tsfn_released_ = true;
+            return;
         }
+        hamlib_instance_->spectrum_stream_running_ = true;
+        NodeHamLib* instance = hamlib_instance_;
+        ring_->StartLatencyTimer([instance]() { instance->FlushPartialSpectrumBatch(); });
     }
 
     void OnOK() override {
         Napi::Env env = Env();
-        if (!error_message_.empty()) {
-            deferred_.Reject(Napi::Error::New(env, error_message_).Value());
-        } else {
-            deferred_.Resolve(Napi::Buffer<unsigned char>::Copy(env, reply_buf_.data(), reply_len_));
+        if (result_code_ != SHIM_RIG_OK || !error_message_.empty()) {
+            if (!tsfn_released_) {
+                tsfn_.Release();
+                tsfn_released_ = true;
+            }
+            Napi::Error error = Napi::Error::New(env, error_message_.empty() ? shim_rigerror(result_code_) : error_message_);
+            if (!error_code_.empty()) error.Value().Set("code", Napi::String::New(env, error_code_));
+            deferred_.Reject(error.Value());
+            return;
         }
+        deferred_.Resolve(Napi::Boolean::New(env, true));
     }
 
     void OnError(const Napi::Error& e) override {
-        deferred_.Reject(Napi::Error::New(Env(), error_message_).Value());
+        deferred_.Reject(Napi::Error::New(Env(), error_message_.empty() ? e.Message() : error_message_).Value());
     }
 
 private:
-    std::vector<unsigned char> send_data_;
-    int reply_max_len_;
-    std::vector<unsigned char> terminator_;
-    bool has_terminator_;
-    std::vector<unsigned char> reply_buf_;
-    int reply_len_;
+    Napi::ThreadSafeFunction tsfn_;
+    std::shared_ptr<SpectrumLineRing> ring_;
+    std::shared_ptr<SpectrumLineProcessor> processor_;
+    bool tsfn_released_ = false;
 };
 
-Napi::Value NodeHamLib::SendRaw(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
+constexpr size_t kDefaultSpectrumBufferLines = 64;
+constexpr size_t kMaxSpectrumBufferLines = 4096;
+constexpr size_t kMaxSpectrumBatchLines = 1024;
+constexpr double kDefaultSpectrumMaxLatencyMs = 50;
+constexpr double kMaxSpectrumMaxLatencyMs = 10000;
 
+static const char* spectrumOverflowName(SpectrumOverflowPolicy policy) {
+  return policy == SpectrumOverflowPolicy::KeepLatest ? "keep-latest" : "drop-oldest";
+}
 
-  if (info.Length() < 2 || !info[0].IsBuffer() || !info[1].IsNumber()) {
-    Napi::TypeError::New(env, "Expected (data: Buffer, replyMaxLen: number, terminator?: Buffer)").ThrowAsJavaScriptException();
+// Reads an optional numeric option; returns false (with a JS exception set)
+// when it is present but not a number in [min, max].
+static bool readSpectrumNumberOption(Napi::Env env, const Napi::Object& options, const char* name,
+                                     double min, double max, double* value, const char* prefix = "") {
+  if (!options.Has(name) || options.Get(name).IsUndefined()) {
+    return true;
+  }
+  if (!options.Get(name).IsNumber()) {
+    Napi::TypeError::New(env, std::string(prefix) + name + " must be a number").ThrowAsJavaScriptException();
+    return false;
+  }
+  const double requested = options.Get(name).As<Napi::Number>().DoubleValue();
+  if (!(requested >= min && requested <= max)) {
+    std::ostringstream message;
+    message << prefix << name << " must be between " << min << " and " << max;
+    Napi::RangeError::New(env, message.str()).ThrowAsJavaScriptException();
+    return false;
+  }
+  *value = requested;
+  return true;
+}
+
+static bool readSpectrumBooleanOption(Napi::Env env, const Napi::Object& options, const char* name,
+                                      bool* value, const char* prefix) {
+  if (!options.Has(name) || options.Get(name).IsUndefined()) {
+    return true;
+  }
+  if (!options.Get(name).IsBoolean()) {
+    Napi::TypeError::New(env, std::string(prefix) + name + " must be a boolean").ThrowAsJavaScriptException();
+    return false;
+  }
+  *value = options.Get(name).As<Napi::Boolean>().Value();
+  return true;
+}
+
+// Parses startSpectrumStream({ processing }). Returns false with a JS
+// exception set on invalid input.
+static bool parseSpectrumProcessing(Napi::Env env, const Napi::Value& value, SpectrumProcessingConfig* config) {
+  if (value.IsUndefined() || value.IsNull()) {
+    return true;
+  }
+  if (!value.IsObject()) {
+    Napi::TypeError::New(env, "processing must be an object").ThrowAsJavaScriptException();
+    return false;
+  }
+  Napi::Object options = value.As<Napi::Object>();
+  const char* prefix = "processing.";
+  double averageAlpha = config->average_alpha;
+  double peakDecay = config->peak_decay;
+  double bins = 0;
+  if (!readSpectrumNumberOption(env, options, "averageAlpha", 0.001, 1, &averageAlpha, prefix) ||
+      !readSpectrumBooleanOption(env, options, "peakHold", &config->peak_hold, prefix) ||
+      !readSpectrumNumberOption(env, options, "peakDecay", 0, 255, &peakDecay, prefix) ||
+      !readSpectrumNumberOption(env, options, "bins", 1, sizeof(shim_spectrum_line_t::data), &bins, prefix) ||
+      !readSpectrumBooleanOption(env, options, "normalize", &config->normalize, prefix)) {
+    return false;
+  }
+  config->average_alpha = static_cast<float>(averageAlpha);
+  config->peak_decay = static_cast<float>(peakDecay);
+  config->bins = static_cast<size_t>(bins);
+
+  if (options.Has("decimation") && !options.Get("decimation").IsUndefined()) {
+    const std::string decimation = options.Get("decimation").IsString()
+      ? options.Get("decimation").As<Napi::String>().Utf8Value()
+      : std::string();
+    if (decimation == "mean") {
+      config->decimation = SpectrumDecimation::Mean;
+    } else if (decimation != "max") {
+      Napi::TypeError::New(env, "processing.decimation must be 'max' or 'mean'").ThrowAsJavaScriptException();
+      return false;
+    }
+  }
+  return true;
+}
+
+Napi::Value NodeHamLib::StartSpectrumStream(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsFunction()) {
+    Napi::TypeError::New(env, "Expected (callback: Function, options?: { overflow?: string, bufferLines?: number, batchLines?: number, maxLatencyMs?: number, processing?: object })")
+      .ThrowAsJavaScriptException();
     return env.Null();
   }
 
-  Napi::Buffer<unsigned char> dataBuf = info[0].As<Napi::Buffer<unsigned char>>();
-  std::vector<unsigned char> send_data(dataBuf.Data(), dataBuf.Data() + dataBuf.Length());
-  int replyMaxLen = info[1].As<Napi::Number>().Int32Value();
+  SpectrumOverflowPolicy overflow = SpectrumOverflowPolicy::DropOldest;
+  double bufferLines = 0;
+  double batchLines = 1;
+  double maxLatencyMs = kDefaultSpectrumMaxLatencyMs;
+  SpectrumProcessingConfig processing;
+  if (info.Length() >= 2 && info[1].IsObject()) {
+    Napi::Object options = info[1].As<Napi::Object>();
+    if (options.Has("overflow") && !options.Get("overflow").IsUndefined()) {
+      const std::string policy = options.Get("overflow").IsString()
+        ? options.Get("overflow").As<Napi::String>().Utf8Value()
+        : std::string();
+      if (policy == "keep-latest") {
+        overflow = SpectrumOverflowPolicy::KeepLatest;
+      } else if (policy != "drop-oldest") {
+        Napi::TypeError::New(env, "overflow must be 'drop-oldest' or 'keep-latest'").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+    }
+    if (!readSpectrumNumberOption(env, options, "bufferLines", 1, kMaxSpectrumBufferLines, &bufferLines) ||
+        !readSpectrumNumberOption(env, options, "batchLines", 1, kMaxSpectrumBatchLines, &batchLines) ||
+        !readSpectrumNumberOption(env, options, "maxLatencyMs", 1, kMaxSpectrumMaxLatencyMs, &maxLatencyMs) ||
+        !parseSpectrumProcessing(env, options.Get("processing"), &processing)) {
+      return env.Null();
+    }
+  } else if (info.Length() >= 2 && !info[1].IsUndefined()) {
+    Napi::TypeError::New(env, "Spectrum stream options must be an object").ThrowAsJavaScriptException();
+    return env.Null();
+  }
 
-  std::vector<unsigned char> terminator;
-  bool has_terminator = false;
-  if (info.Length() >= 3 && info[2].IsBuffer()) {
-    Napi::Buffer<unsigned char> termBuf = info[2].As<Napi::Buffer<unsigned char>>();
-    terminator.assign(termBuf.Data(), termBuf.Data() + termBuf.Length());
-    has_terminator = true;
+  const size_t batch = static_cast<size_t>(batchLines);
+  size_t capacity = static_cast<size_t>(bufferLines);
+  if (capacity == 0) {
+    // Room for a couple of batches while JS drains the previous one.
+    capacity = std::min(kMaxSpectrumBufferLines, std::max(kDefaultSpectrumBufferLines, batch * 2));
+  } else if (capacity < batch) {
+    Napi::RangeError::New(env, "bufferLines must be at least batchLines").ThrowAsJavaScriptException();
+    return env.Null();
   }
 
-  SendRawAsyncWorker* asyncWorker = new SendRawAsyncWorker(env, this, std::move(send_data), replyMaxLen, std::move(terminator), has_terminator);
-  asyncWorker->Queue();
-  return asyncWorker->GetPromise();
+  Napi::Function callback = info[0].As<Napi::Function>();
+  Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(env, callback, "HamLibSpectrumStream", 0, 1);
+  auto ring = std::make_shared<SpectrumLineRing>(capacity, overflow, batch,
+    std::chrono::milliseconds(static_cast<int64_t>(maxLatencyMs)));
+  std::shared_ptr<SpectrumLineProcessor> processor;
+  if (processing.Enabled()) {
+    processor = std::make_shared<SpectrumLineProcessor>(processing);
+  }
+  auto* worker = new StartSpectrumStreamAsyncWorker(env, this, tsfn, ring, processor);
+  worker->Queue();
+  return worker->GetPromise();
 }
 
-
-Napi::Value NodeHamLib::GetSpectrumCapabilities(const Napi::CallbackInfo& info) {
+Napi::Value NodeHamLib::GetSpectrumStreamStats(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  struct SpectrumCapabilityData {
-    bool asyncDataSupported = false;
-    std::vector<shim_spectrum_scope_t> scopes;
-    std::vector<std::pair<int, std::string>> modes;
-    std::vector<double> spans;
-    std::vector<shim_spectrum_avg_mode_t> avgModes;
-  };
-  auto data = std::make_shared<SpectrumCapabilityData>();
-  return QueueLockedCallbackWorker(env, this, "GetSpectrumCapabilities",
-    [data](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      (void)error_message;
-      data->asyncDataSupported = shim_rig_is_async_data_supported(instance->my_rig) != 0;
-      int scopeCount = shim_rig_get_caps_spectrum_scope_count(instance->my_rig);
-      for (int i = 0; i < scopeCount; ++i) {
-        shim_spectrum_scope_t scope{};
-        if (shim_rig_get_caps_spectrum_scope(instance->my_rig, i, &scope) == SHIM_RIG_OK) data->scopes.push_back(scope);
-      }
-      int modeCount = shim_rig_get_caps_spectrum_mode_count(instance->my_rig);
-      for (int i = 0; i < modeCount; ++i) {
-        int modeId = 0;
-        if (shim_rig_get_caps_spectrum_mode(instance->my_rig, i, &modeId) == SHIM_RIG_OK) {
-          const char* modeName = shim_rig_str_spectrum_mode(modeId);
-          data->modes.emplace_back(modeId, modeName ? modeName : "");
-        }
-      }
-      int spanCount = shim_rig_get_caps_spectrum_span_count(instance->my_rig);
-      for (int i = 0; i < spanCount; ++i) {
-        double spanHz = 0;
-        if (shim_rig_get_caps_spectrum_span(instance->my_rig, i, &spanHz) == SHIM_RIG_OK) data->spans.push_back(spanHz);
-      }
-      int avgModeCount = shim_rig_get_caps_spectrum_avg_mode_count(instance->my_rig);
-      for (int i = 0; i < avgModeCount; ++i) {
-        shim_spectrum_avg_mode_t avgMode{};
-        if (shim_rig_get_caps_spectrum_avg_mode(instance->my_rig, i, &avgMode) == SHIM_RIG_OK) data->avgModes.push_back(avgMode);
-      }
-    },
-    [data](Napi::Env env) {
-      Napi::Object result = Napi::Object::New(env);
-      result.Set("asyncDataSupported", Napi::Boolean::New(env, data->asyncDataSupported));
-      Napi::Array scopes = Napi::Array::New(env, data->scopes.size());
-      for (size_t i = 0; i < data->scopes.size(); ++i) {
-        Napi::Object scopeObject = Napi::Object::New(env);
-        scopeObject.Set("id", Napi::Number::New(env, data->scopes[i].id));
-        scopeObject.Set("name", Napi::String::New(env, data->scopes[i].name));
-        scopes[static_cast<uint32_t>(i)] = scopeObject;
-      }
-      result.Set("scopes", scopes);
-      Napi::Array modes = Napi::Array::New(env, data->modes.size());
-      for (size_t i = 0; i < data->modes.size(); ++i) {
-        Napi::Object modeObject = Napi::Object::New(env);
-        modeObject.Set("id", Napi::Number::New(env, data->modes[i].first));
-        modeObject.Set("name", Napi::String::New(env, data->modes[i].second));
-        modes[static_cast<uint32_t>(i)] = modeObject;
-      }
-      result.Set("modes", modes);
-      result.Set("spans", DoubleVectorToArray(env, data->spans));
-      Napi::Array avgModes = Napi::Array::New(env, data->avgModes.size());
-      for (size_t i = 0; i < data->avgModes.size(); ++i) {
-        Napi::Object avgModeObject = Napi::Object::New(env);
-        avgModeObject.Set("id", Napi::Number::New(env, data->avgModes[i].id));
-        avgModeObject.Set("name", Napi::String::New(env, data->avgModes[i].name));
-        avgModes[static_cast<uint32_t>(i)] = avgModeObject;
-      }
-      result.Set("avgModes", avgModes);
-      return result;
-    });
+
+  std::shared_ptr<SpectrumLineRing> ring;
+  std::shared_ptr<SpectrumLineProcessor> processor;
+  bool running = false;
+  {
+    std::lock_guard<std::mutex> lock(spectrum_mutex_);
+    ring = spectrum_ring_;
+    processor = spectrum_processor_;
+    running = spectrum_stream_running_;
+  }
+
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("running", Napi::Boolean::New(env, running));
+  SpectrumRingStats stats;
+  if (ring) {
+    stats = ring->GetStats();
+  }
+  obj.Set("overflow", Napi::String::New(env, spectrumOverflowName(ring ? ring->Policy() : SpectrumOverflowPolicy::DropOldest)));
+  obj.Set("bufferLines", Napi::Number::New(env, static_cast<double>(ring ? stats.capacity : kDefaultSpectrumBufferLines)));
+  obj.Set("batchLines", Napi::Number::New(env, static_cast<double>(ring ? ring->BatchLines() : 1)));
+  obj.Set("maxLatencyMs", Napi::Number::New(env, ring ? static_cast<double>(ring->MaxLatency().count()) : kDefaultSpectrumMaxLatencyMs));
+  obj.Set("processing", Napi::Boolean::New(env, static_cast<bool>(processor)));
+  obj.Set("received", Napi::Number::New(env, static_cast<double>(stats.received)));
+  obj.Set("delivered", Napi::Number::New(env, static_cast<double>(stats.delivered)));
+  obj.Set("dropped", Napi::Number::New(env, static_cast<double>(stats.dropped)));
+  obj.Set("coalesced", Napi::Number::New(env, static_cast<double>(stats.coalesced)));
+  obj.Set("pending", Napi::Number::New(env, static_cast<double>(stats.pending)));
+  obj.Set("inUse", Napi::Number::New(env, static_cast<double>(stats.in_use)));
+  obj.Set("poolMisses", Napi::Number::New(env, static_cast<double>(stats.pool_misses)));
+  return obj;
 }
 
-
-
-class StartSpectrumStreamAsyncWorker : public HamLibAsyncWorker {
+// Feeds synthetic lines through EmitSpectrumLine from its own thread, the way
+// Hamlib's spectrum callback would, so the delivery path (processing, ring,
+// batching, TSFN) can be measured without a rig that streams.
+class SpectrumInjectAsyncWorker : public Napi::AsyncWorker {
 public:
-    StartSpectrumStreamAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance, Napi::ThreadSafeFunction tsfn)
-        : HamLibAsyncWorker(env, hamlib_instance), tsfn_(tsfn) {}
-
-    const char* OperationName() const override { return "StartSpectrumStream"; }
-
-    void ExecuteWithRigLock() override {
-        CHECK_RIG_VALID();
-        if (!hamlib_instance_->rig_is_open.load(std::memory_order_acquire)) {
-            result_code_ = SHIM_RIG_EINVAL;
-            error_message_ = "Rig is not open!";
-            tsfn_.Release();
-            tsfn_released_ = true;
-            return;
-        }
-        std::lock_guard<std::mutex> lock(hamlib_instance_->spectrum_mutex_);
-        if (hamlib_instance_->spectrum_stream_running_) {
-            result_code_ = SHIM_RIG_EINVAL;
-            error_message_ = "Spectrum stream is already running";
-            tsfn_.Release();
-            tsfn_released_ = true;
-            return;
-        }
-        hamlib_instance_->spectrum_tsfn_ = tsfn_;
-        result_code_ = shim_rig_set_spectrum_callback(hamlib_instance_->my_rig, &NodeHamLib::spectrum_line_cb, hamlib_instance_);
-        if (result_code_ != SHIM_RIG_OK) {
-            error_message_ = shim_rigerror(result_code_);
-            hamlib_instance_->spectrum_tsfn_.Release();
-            hamlib_instance_->spectrum_tsfn_ = Napi::ThreadSafeFunction();
-            tsfn_released_ = true;
-            return;
+    SpectrumInjectAsyncWorker(Napi::Env env, NodeHamLib* instance, Napi::Object self,
+                              uint32_t count, int data_length, uint32_t interval_us)
+        : Napi::AsyncWorker(env), deferred_(Napi::Promise::Deferred::New(env)),
+          self_(Napi::Persistent(self)), instance_(instance), count_(count),
+          data_length_(data_length), interval_us_(interval_us) {}
+
+    void Execute() override {
+        shim_spectrum_line_t line{};
+        line.data_level_min = 0;
+        line.data_level_max = 160;
+        line.signal_strength_min = -80;
+        line.signal_strength_max = 0;
+        line.spectrum_mode = 1;
+        line.center_freq = 14074000;
+        line.span_freq = 50000;
+        line.low_edge_freq = line.center_freq - line.span_freq / 2;
+        line.high_edge_freq = line.center_freq + line.span_freq / 2;
+        line.data_length = data_length_;
+        const auto started = std::chrono::steady_clock::now();
+        auto next = started;
+        for (uint32_t n = 0; n < count_; ++n) {
+            for (int i = 0; i < data_length_; ++i) {
+                line.data[i] = static_cast<unsigned char>((i * 7 + n * 3) % 161);
+            }
+            // Synthetic lines never reach a recording; a stopped stream ends
+            // the injection early.
+            if (!instance_->EmitSpectrumLine(line, false)) {
+                break;
+            }
+            ++injected_;
+            if (interval_us_ > 0) {
+                next += std::chrono::microseconds(interval_us_);
+                std::this_thread::sleep_until(next);
+            }
         }
-        hamlib_instance_->spectrum_stream_running_ = true;
+        elapsed_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
     }
 
     void OnOK() override {
         Napi::Env env = Env();
-        if (result_code_ != SHIM_RIG_OK || !error_message_.empty()) {
-            if (!tsfn_released_) {
-                tsfn_.Release();
-                tsfn_released_ = true;
-            }
-            Napi::Error error = Napi::Error::New(env, error_message_.empty() ? shim_rigerror(result_code_) : error_message_);
-            if (!error_code_.empty()) error.Value().Set("code", Napi::String::New(env, error_code_));
-            deferred_.Reject(error.Value());
-            return;
-        }
-        deferred_.Resolve(Napi::Boolean::New(env, true));
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("lines", Napi::Number::New(env, injected_));
+        obj.Set("elapsedMs", Napi::Number::New(env, elapsed_ms_));
+        deferred_.Resolve(obj);
     }
 
-    void OnError(const Napi::Error& e) override {
-        deferred_.Reject(Napi::Error::New(Env(), error_message_.empty() ? e.Message() : error_message_).Value());
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
     }
 
+    Napi::Promise GetPromise() { return deferred_.Promise(); }
+
 private:
-    Napi::ThreadSafeFunction tsfn_;
-    bool tsfn_released_ = false;
+    Napi::Promise::Deferred deferred_;
+    Napi::ObjectReference self_;
+    NodeHamLib* instance_;
+    uint32_t count_;
+    int data_length_;
+    uint32_t interval_us_;
+    uint32_t injected_ = 0;
+    double elapsed_ms_ = 0;
 };
 
-Napi::Value NodeHamLib::StartSpectrumStream(const Napi::CallbackInfo& info) {
+// Pacing is capped so an injection cannot hold a libuv pool thread for long.
+constexpr double kMaxSpectrumInjectUs = 10e6;
+
+Napi::Value NodeHamLib::InjectSpectrumLines(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
-  if (info.Length() < 1 || !info[0].IsFunction()) {
-    Napi::TypeError::New(env, "Expected (callback: Function)").ThrowAsJavaScriptException();
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (count: number, options?: { dataLength?: number, intervalUs?: number })")
+      .ThrowAsJavaScriptException();
     return env.Null();
   }
-
-  Napi::Function callback = info[0].As<Napi::Function>();
-  Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(env, callback, "HamLibSpectrumStream", 0, 1);
-  auto* worker = new StartSpectrumStreamAsyncWorker(env, this, tsfn);
+  const double count = info[0].As<Napi::Number>().DoubleValue();
+  if (!std::isfinite(count) || count < 1 || count > 10000000) {
+    Napi::RangeError::New(env, "count must be between 1 and 10000000").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  double dataLength = 475;
+  double intervalUs = 0;
+  if (info.Length() >= 2 && info[1].IsObject()) {
+    Napi::Object input = info[1].As<Napi::Object>();
+    if (!readSpectrumNumberOption(env, input, "dataLength", 1, static_cast<double>(sizeof(shim_spectrum_line_t::data)), &dataLength) ||
+        !readSpectrumNumberOption(env, input, "intervalUs", 0, 1000000, &intervalUs)) {
+      return env.Null();
+    }
+  } else if (info.Length() >= 2 && !info[1].IsUndefined()) {
+    Napi::TypeError::New(env, "Spectrum injection options must be an object").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  if (count * intervalUs > kMaxSpectrumInjectUs) {
+    Napi::RangeError::New(env, "count * intervalUs must not exceed 10 seconds").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  {
+    std::lock_guard<std::mutex> lock(spectrum_mutex_);
+    if (!spectrum_stream_running_) {
+      Napi::Error::New(env, "Spectrum stream is not running").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+  auto* worker = new SpectrumInjectAsyncWorker(env, this, info.This().As<Napi::Object>(),
+    static_cast<uint32_t>(count), static_cast<int>(dataLength), static_cast<uint32_t>(intervalUs));
   worker->Queue();
   return worker->GetPromise();
 }
 
+static Napi::Object spectrumRecordingStatsToObject(Napi::Env env, bool recording, const SpectrumRecorderStats& stats) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("recording", Napi::Boolean::New(env, recording));
+  obj.Set("path", stats.path.empty() ? env.Null() : Napi::String::New(env, stats.path));
+  obj.Set("lines", Napi::Number::New(env, static_cast<double>(stats.lines)));
+  obj.Set("dataBytes", Napi::Number::New(env, static_cast<double>(stats.data_bytes)));
+  obj.Set("indexEntries", Napi::Number::New(env, static_cast<double>(stats.index_entries)));
+  obj.Set("startTime", Napi::Number::New(env, stats.first_timestamp));
+  obj.Set("endTime", Napi::Number::New(env, stats.last_timestamp));
+  obj.Set("droppedLines", Napi::Number::New(env, static_cast<double>(stats.dropped_lines)));
+  obj.Set("failed", Napi::Boolean::New(env, stats.failed));
+  obj.Set("error", stats.last_error.empty() ? env.Null() : Napi::String::New(env, stats.last_error));
+  return obj;
+}
+
+Napi::Value NodeHamLib::StartSpectrumRecording(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected (path: string, options?: { segmentBytes?: number, indexIntervalMs?: number })")
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  SpectrumRecorderOptions options;
+  if (info.Length() >= 2 && info[1].IsObject()) {
+    Napi::Object input = info[1].As<Napi::Object>();
+    double segmentBytes = static_cast<double>(options.segment_bytes);
+    double indexIntervalMs = options.index_interval_ms;
+    if (!readSpectrumNumberOption(env, input, "segmentBytes", 65536, 1024.0 * 1024 * 1024, &segmentBytes) ||
+        !readSpectrumNumberOption(env, input, "indexIntervalMs", 1, 3600000, &indexIntervalMs)) {
+      return env.Null();
+    }
+    options.segment_bytes = static_cast<uint64_t>(segmentBytes);
+    options.index_interval_ms = static_cast<uint32_t>(indexIntervalMs);
+  } else if (info.Length() >= 2 && !info[1].IsUndefined()) {
+    Napi::TypeError::New(env, "Spectrum recording options must be an object").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::lock_guard<std::mutex> lock(spectrum_mutex_);
+  if (spectrum_recorder_) {
+    Napi::Error::New(env, "Spectrum recording is already running").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::string error;
+  spectrum_recorder_ = SpectrumRecorder::Create(info[0].As<Napi::String>().Utf8Value(), options, &error);
+  if (!spectrum_recorder_) {
+    Napi::Error::New(env, "Unable to start spectrum recording: " + error).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  return Napi::Boolean::New(env, true);
+}
+
+Napi::Value NodeHamLib::StopSpectrumRecording(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  std::unique_ptr<SpectrumRecorder> recorder;
+  {
+    std::lock_guard<std::mutex> lock(spectrum_mutex_);
+    recorder = std::move(spectrum_recorder_);
+  }
+  if (!recorder) {
+    return spectrumRecordingStatsToObject(env, false, SpectrumRecorderStats());
+  }
+  // Close() writes out the lines still queued for the writer thread first.
+  recorder->Close();
+  return spectrumRecordingStatsToObject(env, false, recorder->GetStats());
+}
 
+Napi::Value NodeHamLib::GetSpectrumRecordingStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  std::lock_guard<std::mutex> lock(spectrum_mutex_);
+  if (!spectrum_recorder_) {
+    return spectrumRecordingStatsToObject(env, false, SpectrumRecorderStats());
+  }
+  return spectrumRecordingStatsToObject(env, true, spectrum_recorder_->GetStats());
+}
 
 Napi::Value NodeHamLib::StopSpectrumStream(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
@@ -7640,77 +11808,89 @@ Napi::Value NodeHamLib::GetResolution(const Napi::CallbackInfo& info) {
 // ===== getSupportedParms (async) =====
 
 
-Napi::Value NodeHamLib::GetSupportedParms(const Napi::CallbackInfo & info) {
-  Napi::Env env = info.Env();
-  auto values = std::make_shared<std::vector<std::string>>();
-  return QueueLockedCallbackWorker(env, this, "GetSupportedParms",
-    [values](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      uint64_t parms = shim_rig_get_caps_has_get_parm(instance->my_rig) | shim_rig_get_caps_has_set_parm(instance->my_rig);
-      if (parms & SHIM_RIG_PARM_ANN) values->push_back("ANN");
-      if (parms & SHIM_RIG_PARM_APO) values->push_back("APO");
-      if (parms & SHIM_RIG_PARM_BACKLIGHT) values->push_back("BACKLIGHT");
-      if (parms & SHIM_RIG_PARM_BEEP) values->push_back("BEEP");
-      if (parms & SHIM_RIG_PARM_TIME) values->push_back("TIME");
-      if (parms & SHIM_RIG_PARM_BAT) values->push_back("BAT");
-      if (parms & SHIM_RIG_PARM_KEYLIGHT) values->push_back("KEYLIGHT");
-      if (parms & SHIM_RIG_PARM_SCREENSAVER) values->push_back("SCREENSAVER");
-    },
-    [values](Napi::Env env) {
-      return StringVectorToArray(env, *values);
-    });
+static std::vector<std::string> supportedParmNames(uint64_t parms) {
+  std::vector<std::string> values;
+  if (parms & SHIM_RIG_PARM_ANN) values.push_back("ANN");
+  if (parms & SHIM_RIG_PARM_APO) values.push_back("APO");
+  if (parms & SHIM_RIG_PARM_BACKLIGHT) values.push_back("BACKLIGHT");
+  if (parms & SHIM_RIG_PARM_BEEP) values.push_back("BEEP");
+  if (parms & SHIM_RIG_PARM_TIME) values.push_back("TIME");
+  if (parms & SHIM_RIG_PARM_BAT) values.push_back("BAT");
+  if (parms & SHIM_RIG_PARM_KEYLIGHT) values.push_back("KEYLIGHT");
+  if (parms & SHIM_RIG_PARM_SCREENSAVER) values.push_back("SCREENSAVER");
+  return values;
+}
+
+static Napi::Value supportedParmsValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return StringVectorToArray(env, supportedParmNames(caps.parms));
+}
+
+Napi::Value NodeHamLib::GetSupportedParms(const Napi::CallbackInfo& info) {
+  return QueueCapabilityQuery(info.Env(), "GetSupportedParms", supportedParmsValue);
+}
+
+Napi::Value NodeHamLib::GetSupportedParmsSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, supportedParmsValue);
 }
 
 
 // ===== getSupportedVfoOps (async) =====
 
 
-Napi::Value NodeHamLib::GetSupportedVfoOps(const Napi::CallbackInfo & info) {
-  Napi::Env env = info.Env();
-  auto values = std::make_shared<std::vector<std::string>>();
-  return QueueLockedCallbackWorker(env, this, "GetSupportedVfoOps",
-    [values](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      int ops = shim_rig_get_caps_vfo_ops(instance->my_rig);
-      if (ops & SHIM_RIG_OP_CPY) values->push_back("CPY");
-      if (ops & SHIM_RIG_OP_XCHG) values->push_back("XCHG");
-      if (ops & SHIM_RIG_OP_FROM_VFO) values->push_back("FROM_VFO");
-      if (ops & SHIM_RIG_OP_TO_VFO) values->push_back("TO_VFO");
-      if (ops & SHIM_RIG_OP_MCL) values->push_back("MCL");
-      if (ops & SHIM_RIG_OP_UP) values->push_back("UP");
-      if (ops & SHIM_RIG_OP_DOWN) values->push_back("DOWN");
-      if (ops & SHIM_RIG_OP_BAND_UP) values->push_back("BAND_UP");
-      if (ops & SHIM_RIG_OP_BAND_DOWN) values->push_back("BAND_DOWN");
-      if (ops & SHIM_RIG_OP_LEFT) values->push_back("LEFT");
-      if (ops & SHIM_RIG_OP_RIGHT) values->push_back("RIGHT");
-      if (ops & SHIM_RIG_OP_TUNE) values->push_back("TUNE");
-      if (ops & SHIM_RIG_OP_TOGGLE) values->push_back("TOGGLE");
-    },
-    [values](Napi::Env env) {
-      return StringVectorToArray(env, *values);
-    });
+static std::vector<std::string> supportedVfoOpNames(uint64_t ops) {
+  std::vector<std::string> values;
+  if (ops & SHIM_RIG_OP_CPY) values.push_back("CPY");
+  if (ops & SHIM_RIG_OP_XCHG) values.push_back("XCHG");
+  if (ops & SHIM_RIG_OP_FROM_VFO) values.push_back("FROM_VFO");
+  if (ops & SHIM_RIG_OP_TO_VFO) values.push_back("TO_VFO");
+  if (ops & SHIM_RIG_OP_MCL) values.push_back("MCL");
+  if (ops & SHIM_RIG_OP_UP) values.push_back("UP");
+  if (ops & SHIM_RIG_OP_DOWN) values.push_back("DOWN");
+  if (ops & SHIM_RIG_OP_BAND_UP) values.push_back("BAND_UP");
+  if (ops & SHIM_RIG_OP_BAND_DOWN) values.push_back("BAND_DOWN");
+  if (ops & SHIM_RIG_OP_LEFT) values.push_back("LEFT");
+  if (ops & SHIM_RIG_OP_RIGHT) values.push_back("RIGHT");
+  if (ops & SHIM_RIG_OP_TUNE) values.push_back("TUNE");
+  if (ops & SHIM_RIG_OP_TOGGLE) values.push_back("TOGGLE");
+  return values;
+}
+
+static Napi::Value supportedVfoOpsValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return StringVectorToArray(env, supportedVfoOpNames(caps.vfo_ops));
+}
+
+Napi::Value NodeHamLib::GetSupportedVfoOps(const Napi::CallbackInfo& info) {
+  return QueueCapabilityQuery(info.Env(), "GetSupportedVfoOps", supportedVfoOpsValue);
+}
+
+Napi::Value NodeHamLib::GetSupportedVfoOpsSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, supportedVfoOpsValue);
 }
 
 
 // ===== getSupportedScanTypes (async) =====
 
 
-Napi::Value NodeHamLib::GetSupportedScanTypes(const Napi::CallbackInfo & info) {
-  Napi::Env env = info.Env();
-  auto values = std::make_shared<std::vector<std::string>>();
-  return QueueLockedCallbackWorker(env, this, "GetSupportedScanTypes",
-    [values](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      int scan = shim_rig_get_caps_has_scan(instance->my_rig);
-      if (scan & SHIM_RIG_SCAN_MEM) values->push_back("MEM");
-      if (scan & SHIM_RIG_SCAN_VFO) values->push_back("VFO");
-      if (scan & SHIM_RIG_SCAN_PROG) values->push_back("PROG");
-      if (scan & SHIM_RIG_SCAN_DELTA) values->push_back("DELTA");
-      if (scan & SHIM_RIG_SCAN_PRIO) values->push_back("PRIO");
-    },
-    [values](Napi::Env env) {
-      return StringVectorToArray(env, *values);
-    });
+static std::vector<std::string> supportedScanTypeNames(uint64_t scan) {
+  std::vector<std::string> values;
+  if (scan & SHIM_RIG_SCAN_MEM) values.push_back("MEM");
+  if (scan & SHIM_RIG_SCAN_VFO) values.push_back("VFO");
+  if (scan & SHIM_RIG_SCAN_PROG) values.push_back("PROG");
+  if (scan & SHIM_RIG_SCAN_DELTA) values.push_back("DELTA");
+  if (scan & SHIM_RIG_SCAN_PRIO) values.push_back("PRIO");
+  return values;
+}
+
+static Napi::Value supportedScanTypesValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return StringVectorToArray(env, supportedScanTypeNames(caps.scan_types));
+}
+
+Napi::Value NodeHamLib::GetSupportedScanTypes(const Napi::CallbackInfo& info) {
+  return QueueCapabilityQuery(info.Env(), "GetSupportedScanTypes", supportedScanTypesValue);
+}
+
+Napi::Value NodeHamLib::GetSupportedScanTypesSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, supportedScanTypesValue);
 }
 
 
@@ -7733,214 +11913,225 @@ static Napi::Array ModeBitmaskToArray(Napi::Env env, uint64_t modes) {
 }
 
 
+static Napi::Value preampValuesValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return IntVectorToArray(env, caps.preamp);
+}
+
 Napi::Value NodeHamLib::GetPreampValues(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  auto values = std::make_shared<std::vector<int>>();
-  return QueueLockedCallbackWorker(env, this, "GetPreampValues",
-    [values](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      (void)error_message;
-      int buf[SHIM_HAMLIB_MAX_MODES];
-      int count = shim_rig_get_caps_preamp(instance->my_rig, buf, SHIM_HAMLIB_MAX_MODES);
-      values->assign(buf, buf + std::max(0, count));
-    },
-    [values](Napi::Env env) { return IntVectorToArray(env, *values); });
+  return QueueCapabilityQuery(info.Env(), "GetPreampValues", preampValuesValue);
+}
+
+Napi::Value NodeHamLib::GetPreampValuesSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, preampValuesValue);
 }
 
 
 
+static Napi::Value attenuatorValuesValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return IntVectorToArray(env, caps.attenuator);
+}
+
 Napi::Value NodeHamLib::GetAttenuatorValues(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  auto values = std::make_shared<std::vector<int>>();
-  return QueueLockedCallbackWorker(env, this, "GetAttenuatorValues",
-    [values](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      (void)error_message;
-      int buf[SHIM_HAMLIB_MAX_MODES];
-      int count = shim_rig_get_caps_attenuator(instance->my_rig, buf, SHIM_HAMLIB_MAX_MODES);
-      values->assign(buf, buf + std::max(0, count));
-    },
-    [values](Napi::Env env) { return IntVectorToArray(env, *values); });
+  return QueueCapabilityQuery(info.Env(), "GetAttenuatorValues", attenuatorValuesValue);
+}
+
+Napi::Value NodeHamLib::GetAttenuatorValuesSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, attenuatorValuesValue);
 }
 
 
 
+static Napi::Value agcLevelsValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return IntVectorToArray(env, caps.agc_levels);
+}
+
 Napi::Value NodeHamLib::GetAgcLevels(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  auto values = std::make_shared<std::vector<int>>();
-  return QueueLockedCallbackWorker(env, this, "GetAgcLevels",
-    [values](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      (void)error_message;
-      int buf[SHIM_HAMLIB_MAX_MODES];
-      int count = shim_rig_get_caps_agc_levels(instance->my_rig, buf, SHIM_HAMLIB_MAX_MODES);
-      values->assign(buf, buf + std::max(0, count));
-    },
-    [values](Napi::Env env) { return IntVectorToArray(env, *values); });
+  return QueueCapabilityQuery(info.Env(), "GetAgcLevels", agcLevelsValue);
+}
+
+Napi::Value NodeHamLib::GetAgcLevelsSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, agcLevelsValue);
 }
 
 
 
+static Napi::Value maxRitValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return Napi::Number::New(env, caps.max_rit);
+}
+
 Napi::Value NodeHamLib::GetMaxRit(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  auto value = std::make_shared<double>(0);
-  return QueueLockedCallbackWorker(env, this, "GetMaxRit",
-    [value](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      (void)error_message;
-      *value = static_cast<double>(shim_rig_get_caps_max_rit(instance->my_rig));
-    },
-    [value](Napi::Env env) { return Napi::Number::New(env, *value); });
+  return QueueCapabilityQuery(info.Env(), "GetMaxRit", maxRitValue);
+}
+
+Napi::Value NodeHamLib::GetMaxRitSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, maxRitValue);
 }
 
 
 
+static Napi::Value maxXitValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return Napi::Number::New(env, caps.max_xit);
+}
+
 Napi::Value NodeHamLib::GetMaxXit(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  auto value = std::make_shared<double>(0);
-  return QueueLockedCallbackWorker(env, this, "GetMaxXit",
-    [value](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      (void)error_message;
-      *value = static_cast<double>(shim_rig_get_caps_max_xit(instance->my_rig));
-    },
-    [value](Napi::Env env) { return Napi::Number::New(env, *value); });
+  return QueueCapabilityQuery(info.Env(), "GetMaxXit", maxXitValue);
+}
+
+Napi::Value NodeHamLib::GetMaxXitSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, maxXitValue);
 }
 
 
 
+static Napi::Value maxIfShiftValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return Napi::Number::New(env, caps.max_if_shift);
+}
+
 Napi::Value NodeHamLib::GetMaxIfShift(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  auto value = std::make_shared<double>(0);
-  return QueueLockedCallbackWorker(env, this, "GetMaxIfShift",
-    [value](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      (void)error_message;
-      *value = static_cast<double>(shim_rig_get_caps_max_ifshift(instance->my_rig));
-    },
-    [value](Napi::Env env) { return Napi::Number::New(env, *value); });
+  return QueueCapabilityQuery(info.Env(), "GetMaxIfShift", maxIfShiftValue);
+}
+
+Napi::Value NodeHamLib::GetMaxIfShiftSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, maxIfShiftValue);
 }
 
 
 
+static Napi::Value availableCtcssTonesValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return DoubleVectorToArray(env, caps.ctcss_tones);
+}
+
 Napi::Value NodeHamLib::GetAvailableCtcssTones(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  auto values = std::make_shared<std::vector<double>>();
-  return QueueLockedCallbackWorker(env, this, "GetAvailableCtcssTones",
-    [values](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      (void)error_message;
-      unsigned int buf[256];
-      int count = shim_rig_get_caps_ctcss_list(instance->my_rig, buf, 256);
-      for (int i = 0; i < count; ++i) values->push_back(buf[i] / 10.0);
-    },
-    [values](Napi::Env env) { return DoubleVectorToArray(env, *values); });
+  return QueueCapabilityQuery(info.Env(), "GetAvailableCtcssTones", availableCtcssTonesValue);
+}
+
+Napi::Value NodeHamLib::GetAvailableCtcssTonesSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, availableCtcssTonesValue);
 }
 
 
 
+static Napi::Value availableDcsCodesValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return IntVectorToArray(env, caps.dcs_codes);
+}
+
 Napi::Value NodeHamLib::GetAvailableDcsCodes(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  auto values = std::make_shared<std::vector<int>>();
-  return QueueLockedCallbackWorker(env, this, "GetAvailableDcsCodes",
-    [values](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      (void)error_message;
-      unsigned int buf[256];
-      int count = shim_rig_get_caps_dcs_list(instance->my_rig, buf, 256);
-      for (int i = 0; i < count; ++i) values->push_back(static_cast<int>(buf[i]));
-    },
-    [values](Napi::Env env) { return IntVectorToArray(env, *values); });
+  return QueueCapabilityQuery(info.Env(), "GetAvailableDcsCodes", availableDcsCodesValue);
+}
+
+Napi::Value NodeHamLib::GetAvailableDcsCodesSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, availableDcsCodesValue);
+}
+
+
+
+static Napi::Array FreqRangesToArray(Napi::Env env, const std::vector<shim_freq_range_t>& ranges) {
+  Napi::Array arr = Napi::Array::New(env, ranges.size());
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("startFreq", Napi::Number::New(env, ranges[i].start_freq));
+    obj.Set("endFreq", Napi::Number::New(env, ranges[i].end_freq));
+    obj.Set("modes", ModeBitmaskToArray(env, ranges[i].modes));
+    obj.Set("lowPower", Napi::Number::New(env, ranges[i].low_power));
+    obj.Set("highPower", Napi::Number::New(env, ranges[i].high_power));
+    obj.Set("vfo", Napi::Number::New(env, ranges[i].vfo));
+    obj.Set("antenna", Napi::Number::New(env, ranges[i].ant));
+    arr[static_cast<uint32_t>(i)] = obj;
+  }
+  return arr;
 }
 
+static Napi::Object frequencyRangesToObject(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("rx", FreqRangesToArray(env, caps.rx_ranges));
+  result.Set("tx", FreqRangesToArray(env, caps.tx_ranges));
+  return result;
+}
 
+static Napi::Value frequencyRangesValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return frequencyRangesToObject(env, caps);
+}
 
 Napi::Value NodeHamLib::GetFrequencyRanges(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  struct RangeData { std::vector<shim_freq_range_t> rx; std::vector<shim_freq_range_t> tx; };
-  auto data = std::make_shared<RangeData>();
-  return QueueLockedCallbackWorker(env, this, "GetFrequencyRanges",
-    [data](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      (void)error_message;
-      shim_freq_range_t rx_buf[30];
-      shim_freq_range_t tx_buf[30];
-      int rx_count = shim_rig_get_caps_rx_range(instance->my_rig, rx_buf, 30);
-      int tx_count = shim_rig_get_caps_tx_range(instance->my_rig, tx_buf, 30);
-      data->rx.assign(rx_buf, rx_buf + std::max(0, rx_count));
-      data->tx.assign(tx_buf, tx_buf + std::max(0, tx_count));
-    },
-    [data](Napi::Env env) {
-      auto buildArray = [env](const std::vector<shim_freq_range_t>& ranges) {
-        Napi::Array arr = Napi::Array::New(env, ranges.size());
-        for (size_t i = 0; i < ranges.size(); ++i) {
-          Napi::Object obj = Napi::Object::New(env);
-          obj.Set("startFreq", Napi::Number::New(env, ranges[i].start_freq));
-          obj.Set("endFreq", Napi::Number::New(env, ranges[i].end_freq));
-          obj.Set("modes", ModeBitmaskToArray(env, ranges[i].modes));
-          obj.Set("lowPower", Napi::Number::New(env, ranges[i].low_power));
-          obj.Set("highPower", Napi::Number::New(env, ranges[i].high_power));
-          obj.Set("vfo", Napi::Number::New(env, ranges[i].vfo));
-          obj.Set("antenna", Napi::Number::New(env, ranges[i].ant));
-          arr[static_cast<uint32_t>(i)] = obj;
-        }
-        return arr;
-      };
-      Napi::Object result = Napi::Object::New(env);
-      result.Set("rx", buildArray(data->rx));
-      result.Set("tx", buildArray(data->tx));
-      return result;
-    });
+  return QueueCapabilityQuery(info.Env(), "GetFrequencyRanges", frequencyRangesValue);
+}
+
+Napi::Value NodeHamLib::GetFrequencyRangesSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, frequencyRangesValue);
 }
 
 
 
+// Helper: convert (modes, value) rows to [{ modes, <valueKey> }]
+static Napi::Array ModeValuesToArray(Napi::Env env, const std::vector<shim_mode_value_t>& values, const char* valueKey) {
+  Napi::Array arr = Napi::Array::New(env, values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("modes", ModeBitmaskToArray(env, values[i].modes));
+    obj.Set(valueKey, Napi::Number::New(env, values[i].value));
+    arr[static_cast<uint32_t>(i)] = obj;
+  }
+  return arr;
+}
+
+static Napi::Value tuningStepsValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return ModeValuesToArray(env, caps.tuning_steps, "stepHz");
+}
+
 Napi::Value NodeHamLib::GetTuningSteps(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  auto values = std::make_shared<std::vector<shim_mode_value_t>>();
-  return QueueLockedCallbackWorker(env, this, "GetTuningSteps",
-    [values](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      (void)error_message;
-      shim_mode_value_t buf[20];
-      int count = shim_rig_get_caps_tuning_steps(instance->my_rig, buf, 20);
-      values->assign(buf, buf + std::max(0, count));
-    },
-    [values](Napi::Env env) {
-      Napi::Array arr = Napi::Array::New(env, values->size());
-      for (size_t i = 0; i < values->size(); ++i) {
-        Napi::Object obj = Napi::Object::New(env);
-        obj.Set("modes", ModeBitmaskToArray(env, (*values)[i].modes));
-        obj.Set("stepHz", Napi::Number::New(env, (*values)[i].value));
-        arr[static_cast<uint32_t>(i)] = obj;
-      }
-      return arr;
-    });
+  return QueueCapabilityQuery(info.Env(), "GetTuningSteps", tuningStepsValue);
+}
+
+Napi::Value NodeHamLib::GetTuningStepsSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, tuningStepsValue);
 }
 
 
 
+static Napi::Value filterListValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  return ModeValuesToArray(env, caps.filters, "width");
+}
+
 Napi::Value NodeHamLib::GetFilterList(const Napi::CallbackInfo& info) {
-  Napi::Env env = info.Env();
-  auto values = std::make_shared<std::vector<shim_mode_value_t>>();
-  return QueueLockedCallbackWorker(env, this, "GetFilterList",
-    [values](NodeHamLib* instance, int& result_code, std::string& error_message) {
-      (void)result_code;
-      (void)error_message;
-      shim_mode_value_t buf[60];
-      int count = shim_rig_get_caps_filters(instance->my_rig, buf, 60);
-      values->assign(buf, buf + std::max(0, count));
-    },
-    [values](Napi::Env env) {
-      Napi::Array arr = Napi::Array::New(env, values->size());
-      for (size_t i = 0; i < values->size(); ++i) {
-        Napi::Object obj = Napi::Object::New(env);
-        obj.Set("modes", ModeBitmaskToArray(env, (*values)[i].modes));
-        obj.Set("width", Napi::Number::New(env, (*values)[i].value));
-        arr[static_cast<uint32_t>(i)] = obj;
-      }
-      return arr;
-    });
+  return QueueCapabilityQuery(info.Env(), "GetFilterList", filterListValue);
+}
+
+Napi::Value NodeHamLib::GetFilterListSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, filterListValue);
+}
+
+
+
+static Napi::Value capabilitySnapshotValue(Napi::Env env, const RigCapabilitySnapshot& caps) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("capturedAt", Napi::Number::New(env, caps.captured_at_ms));
+  result.Set("levels", StringVectorToArray(env, supportedLevelNames(caps.levels)));
+  result.Set("functions", StringVectorToArray(env, supportedFunctionNames(caps.functions)));
+  result.Set("parms", StringVectorToArray(env, supportedParmNames(caps.parms)));
+  result.Set("modes", StringVectorToArray(env, supportedModeNames(caps.modes)));
+  result.Set("vfoOps", StringVectorToArray(env, supportedVfoOpNames(caps.vfo_ops)));
+  result.Set("scanTypes", StringVectorToArray(env, supportedScanTypeNames(caps.scan_types)));
+  result.Set("preampValues", IntVectorToArray(env, caps.preamp));
+  result.Set("attenuatorValues", IntVectorToArray(env, caps.attenuator));
+  result.Set("agcLevels", IntVectorToArray(env, caps.agc_levels));
+  result.Set("maxRit", Napi::Number::New(env, caps.max_rit));
+  result.Set("maxXit", Napi::Number::New(env, caps.max_xit));
+  result.Set("maxIfShift", Napi::Number::New(env, caps.max_if_shift));
+  result.Set("ctcssTones", DoubleVectorToArray(env, caps.ctcss_tones));
+  result.Set("dcsCodes", IntVectorToArray(env, caps.dcs_codes));
+  result.Set("frequencyRanges", frequencyRangesToObject(env, caps));
+  result.Set("tuningSteps", ModeValuesToArray(env, caps.tuning_steps, "stepHz"));
+  result.Set("filters", ModeValuesToArray(env, caps.filters, "width"));
+  result.Set("spectrum", spectrumCapabilitiesToObject(env, caps));
+  return result;
+}
+
+Napi::Value NodeHamLib::GetCapabilitySnapshot(const Napi::CallbackInfo& info) {
+  return QueueCapabilityQuery(info.Env(), "GetCapabilitySnapshot", capabilitySnapshotValue);
+}
+
+Napi::Value NodeHamLib::GetCapabilitySnapshotSync(const Napi::CallbackInfo& info) {
+  return CapabilitySync(info, capabilitySnapshotValue);
 }
 
 
@@ -2,41 +2,111 @@
 
 #include <napi.h>
 #include "shim/hamlib_shim.h"
+#include "rig_call_control.h"
+#include "rig_capabilities.h"
+#include "rig_executor.h"
+#include "rig_metrics.h"
+#include "rig_priority.h"
+#include "rig_state_cache.h"
+#include "rig_trace.h"
+#include "rigctld_session.h"
+#include "spectrum_ring.h"
+#include "spectrum_dsp.h"
+#include "spectrum_recorder.h"
 #include <memory>
 #include <string>
 #include <atomic>
 #include <chrono>
+#include <functional>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <cstdint>
 
 // Forward declaration
 class NodeHamLib;
 class HamLibAsyncWorker;
+class RigPollScheduler;
+class RigTracker;
+class RigRawStream;
+class RigSweep;
+class HamLibAddonData;
+// Parsed batch() operations; defined in hamlib.cpp.
+struct RigBatchPlan;
 
 using GlobalRigLock = std::unique_lock<std::timed_mutex>;
 
+// Which mutex serializes native I/O for a HamLib instance.
+//   Global   - one process-wide mutex for every instance (default)
+//   Port     - one mutex per device (port path / rigctld host:port)
+//   Instance - one mutex per instance; instances on the same explicit port
+//              still share theirs
+enum class RigLockScope {
+  Global = 0,
+  Port = 1,
+  Instance = 2,
+};
+
+// Held by every thread that picks a rig lock through the lock scope, from
+// the pick until the lock is released. The scope cannot change while any is
+// alive, so all locks held on one RIG* come from the same scope.
+class RigLockScopeUse {
+ public:
+  RigLockScopeUse();
+  ~RigLockScopeUse();
+  RigLockScopeUse(const RigLockScopeUse&) = delete;
+  RigLockScopeUse& operator=(const RigLockScopeUse&) = delete;
+};
+
+// A change pushed by the rig in transceive mode, copied off Hamlib's thread.
+struct RigTransceiveEvent {
+  enum class Kind { Frequency, Mode, Ptt };
+  Kind kind = Kind::Frequency;
+  int vfo = 0;
+  double frequency = 0;
+  int mode = 0;
+  int width = 0;
+  int ptt = 0;
+  double timestamp = 0;
+};
+
 class HamLibPromiseController {
 public:
     HamLibPromiseController(Napi::Env env, HamLibAsyncWorker* owner);
 
     Napi::Promise Promise() const { return deferred_.Promise(); }
+    // A further promise settled with the same value (coalesced callers).
+    Napi::Promise AddFollower(Napi::Env env);
     void Resolve(Napi::Value value);
     void Reject(Napi::Value value);
 
 private:
     Napi::Promise::Deferred deferred_;
+    std::vector<Napi::Promise::Deferred> followers_;
     HamLibAsyncWorker* owner_;
 };
 
 // Base AsyncWorker class for hamlib operations with Promise support
-class HamLibAsyncWorker : public Napi::AsyncWorker {
+class HamLibAsyncWorker : public Napi::AsyncWorker, public RigCommandTask {
 public:
     HamLibAsyncWorker(Napi::Env env, NodeHamLib* hamlib_instance);
     ~HamLibAsyncWorker() override;
 
     // Get the promise that will be resolved/rejected
     Napi::Promise GetPromise() { return deferred_.Promise(); }
+    Napi::Promise AddFollower(Napi::Env env) { return deferred_.AddFollower(env); }
+
+    // Registers the worker under `key` with its rig's request coalescing
+    // (an in-flight read, or a write that later ones may merge into) when
+    // Queue() is called. An empty key marks an ordinary command.
+    void SetCoalesceKey(std::string key, bool write);
+
+    // Runs on the rig's command thread when one is enabled, otherwise on the
+    // libuv threadpool like a plain AsyncWorker.
+    void Queue();
+
+    void RunOnCommandThread() override;
+    void CompleteOnJsThread(Napi::Env env) override;
 
 protected:
     friend class HamLibPromiseController;
@@ -45,20 +115,70 @@ protected:
     virtual void ExecuteWithRigLock() = 0;
     virtual const char* OperationName() const { return "HamLibAsyncWorker"; }
     virtual bool RequiresOpenRig() const { return true; }
+    // Class used unless setCommandPriorities() overrides this operation.
+    virtual RigCommandPriority DefaultPriority() const { return RigCommandPriority::Interactive; }
+    // Whether the call may change frequency/mode/VFO behind the state cache.
+    virtual bool InvalidatesStateCache() const { return false; }
     std::string GetOperationName() const;
     Napi::Value DecorateErrorValue(Napi::Value value) const;
     void ReleaseObjectReference();
+    void ReleaseCoalescing();
+    void RecordLaneCall();
+    // Sets the abort / deadline error and returns true when the call scope
+    // this worker was queued under has been stopped. Long-running workers
+    // call it between steps.
+    bool CallStopped();
+    // No-op unless the rig had tracing enabled when the worker was created.
+    void RecordTrace(RigTracePhase phase, bool failed = false);
 
     NodeHamLib* hamlib_instance_;
     int result_code_;
     std::string error_code_;
     std::string error_message_;
     int lock_timeout_ms_;
+    std::string lock_scope_;
+    // Operation holding the rig lock when it timed out, if known.
+    std::string lock_holder_;
+    double lock_holder_held_ms_;
     bool object_ref_held_;
+    // Registry of hamlib_instance_, kept alive for the worker's lifetime;
+    // metrics_queued_ is set between Queue() and Execute().
+    std::shared_ptr<RigMetricsRegistry> rig_metrics_;
+    bool metrics_queued_;
+    std::string coalesce_key_;
+    bool coalesce_write_;
+    // Resolved by Queue(); queued_at_us_ feeds the per-class latency.
+    RigCommandPriority priority_;
+    int64_t queued_at_us_;
+    bool counted_inflight_;
+    // Scope of the JS call that queued the worker, if any.
+    std::shared_ptr<RigCallControl> call_control_;
+    // Trace ring of hamlib_instance_ when tracing was on at construction.
+    std::shared_ptr<RigTraceRing> trace_;
+    uint32_t trace_call_id_;
+    const RigOperationMetrics* trace_operation_;
+    // Pins the lock scope from construction until the worker is destroyed.
+    RigLockScopeUse scope_use_;
     HamLibPromiseController deferred_;
 };
 
 
+// One rig's part of a HamLibGroup call, reported on the JS thread.
+struct RigGroupOutcome {
+  // Whether batch() would have resolved; `value` is then its results array,
+  // otherwise the error it would have rejected with.
+  bool resolved = false;
+  Napi::Value value;
+  // Items of a resolved batch that failed (continueOnError).
+  size_t failed_items = 0;
+  // rigMetricsNowMicros() when the rig started executing and when its last
+  // item returned; 0 when the operations never ran.
+  int64_t started_us = 0;
+  int64_t applied_us = 0;
+};
+
+using RigGroupDone = std::function<void(Napi::Env, const RigGroupOutcome&)>;
+
 class NodeHamLib : public Napi::ObjectWrap<NodeHamLib> {
  public:
   NodeHamLib(const Napi::CallbackInfo&);
@@ -77,6 +197,92 @@ class NodeHamLib : public Napi::ObjectWrap<NodeHamLib> {
   Napi::Value Destroy(const Napi::CallbackInfo&);
   Napi::Value GetConnectionInfo(const Napi::CallbackInfo&);
 
+  // Batched get/set operations under one lock acquisition
+  Napi::Value Batch(const Napi::CallbackInfo&);
+
+  // Opt-in dedicated command thread
+  Napi::Value EnableCommandThread(const Napi::CallbackInfo&);
+  Napi::Value DisableCommandThread(const Napi::CallbackInfo&);
+  Napi::Value GetCommandThreadStats(const Napi::CallbackInfo&);
+
+  // Per-operation call, error and latency metrics
+  Napi::Value GetStats(const Napi::CallbackInfo&);
+  Napi::Value ResetStats(const Napi::CallbackInfo&);
+  static Napi::Value GetGlobalStats(const Napi::CallbackInfo&);
+  static Napi::Value ResetGlobalStats(const Napi::CallbackInfo&);
+
+  // Opt-in per-call trace events, exported as Chrome trace-event JSON
+  Napi::Value EnableTrace(const Napi::CallbackInfo&);
+  Napi::Value DisableTrace(const Napi::CallbackInfo&);
+  Napi::Value DumpTrace(const Napi::CallbackInfo&);
+
+  // Pipelined rigctld connection shared by network rigs on the same host:port
+  Napi::Value OpenSharedSession(const Napi::CallbackInfo&);
+  Napi::Value CloseSharedSession(const Napi::CallbackInfo&);
+  Napi::Value GetSharedSessionStats(const Napi::CallbackInfo&);
+
+  // Optional frequency/mode/VFO cache answering get* within a maximum age
+  Napi::Value EnableStateCache(const Napi::CallbackInfo&);
+  Napi::Value DisableStateCache(const Napi::CallbackInfo&);
+  Napi::Value GetStateCacheStats(const Napi::CallbackInfo&);
+
+  // Capabilities captured once per open(); caps getters answer from it
+  Napi::Value GetCapabilitySnapshot(const Napi::CallbackInfo&);
+
+  // Synchronous variants: answered from the state cache or the capability
+  // snapshot on the JS thread, never touching the rig
+  Napi::Value GetFrequencySync(const Napi::CallbackInfo&);
+  Napi::Value GetModeSync(const Napi::CallbackInfo&);
+  Napi::Value GetVfoSync(const Napi::CallbackInfo&);
+  Napi::Value GetSupportedLevelsSync(const Napi::CallbackInfo&);
+  Napi::Value GetSupportedFunctionsSync(const Napi::CallbackInfo&);
+  Napi::Value GetSupportedModesSync(const Napi::CallbackInfo&);
+  Napi::Value GetSupportedParmsSync(const Napi::CallbackInfo&);
+  Napi::Value GetSupportedVfoOpsSync(const Napi::CallbackInfo&);
+  Napi::Value GetSupportedScanTypesSync(const Napi::CallbackInfo&);
+  Napi::Value GetPreampValuesSync(const Napi::CallbackInfo&);
+  Napi::Value GetAttenuatorValuesSync(const Napi::CallbackInfo&);
+  Napi::Value GetAgcLevelsSync(const Napi::CallbackInfo&);
+  Napi::Value GetMaxRitSync(const Napi::CallbackInfo&);
+  Napi::Value GetMaxXitSync(const Napi::CallbackInfo&);
+  Napi::Value GetMaxIfShiftSync(const Napi::CallbackInfo&);
+  Napi::Value GetAvailableCtcssTonesSync(const Napi::CallbackInfo&);
+  Napi::Value GetAvailableDcsCodesSync(const Napi::CallbackInfo&);
+  Napi::Value GetFrequencyRangesSync(const Napi::CallbackInfo&);
+  Napi::Value GetTuningStepsSync(const Napi::CallbackInfo&);
+  Napi::Value GetFilterListSync(const Napi::CallbackInfo&);
+  Napi::Value GetSpectrumCapabilitiesSync(const Napi::CallbackInfo&);
+  Napi::Value GetCapabilitySnapshotSync(const Napi::CallbackInfo&);
+  Napi::Value Power2mWSync(const Napi::CallbackInfo&);
+  Napi::Value MW2PowerSync(const Napi::CallbackInfo&);
+
+  // In-flight read sharing and setFrequency last-writer-wins
+  Napi::Value EnableRequestCoalescing(const Napi::CallbackInfo&);
+  Napi::Value DisableRequestCoalescing(const Napi::CallbackInfo&);
+
+  // Realtime / interactive / background command classes
+  Napi::Value SetCommandPriorities(const Napi::CallbackInfo&);
+  Napi::Value GetCommandPriorities(const Napi::CallbackInfo&);
+
+  // AbortSignal / deadline scopes for the workers a JS call queues
+  Napi::Value BeginCallScope(const Napi::CallbackInfo&);
+  Napi::Value EndCallScope(const Napi::CallbackInfo&);
+  Napi::Value CancelCallScope(const Napi::CallbackInfo&);
+
+  // Transceive (rig-pushed) change events
+  Napi::Value SetTransceive(const Napi::CallbackInfo&);
+  Napi::Value GetTransceive(const Napi::CallbackInfo&);
+  Napi::Value SetTransceiveListener(const Napi::CallbackInfo&);
+
+  // Native poll scheduler emitting value changes
+  Napi::Value StartPolling(const Napi::CallbackInfo&);
+  Napi::Value StopPolling(const Napi::CallbackInfo&);
+
+  // Native doppler / rotator tracking loop
+  Napi::Value StartTracking(const Napi::CallbackInfo&);
+  Napi::Value StopTracking(const Napi::CallbackInfo&);
+  Napi::Value GetTrackingStatus(const Napi::CallbackInfo&);
+
   // Memory Channel Management
   Napi::Value SetMemoryChannel(const Napi::CallbackInfo&);
   Napi::Value GetMemoryChannel(const Napi::CallbackInfo&);
@@ -84,6 +290,7 @@ class NodeHamLib : public Napi::ObjectWrap<NodeHamLib> {
   Napi::Value GetMemoryLayout(const Napi::CallbackInfo&);
   Napi::Value GetMemoryCapabilities(const Napi::CallbackInfo&);
   Napi::Value GetMemoryList(const Napi::CallbackInfo&);
+  Napi::Value GetMemoryListChunk(const Napi::CallbackInfo&);
   Napi::Value SetMemoryChannels(const Napi::CallbackInfo&);
   Napi::Value ReplaceMemoryChannels(const Napi::CallbackInfo&);
 
@@ -102,6 +309,9 @@ class NodeHamLib : public Napi::ObjectWrap<NodeHamLib> {
   Napi::Value SetLevel(const Napi::CallbackInfo&);
   Napi::Value GetLevel(const Napi::CallbackInfo&);
   Napi::Value GetSupportedLevels(const Napi::CallbackInfo&);
+  // Level/function name -> numeric handle accepted in place of the name
+  static Napi::Value GetLevelHandle(const Napi::CallbackInfo&);
+  static Napi::Value GetFunctionHandle(const Napi::CallbackInfo&);
 
   // Function Controls
   Napi::Value SetFunction(const Napi::CallbackInfo&);
@@ -214,9 +424,24 @@ class NodeHamLib : public Napi::ObjectWrap<NodeHamLib> {
   // Rig Info / Raw / Conf (async)
   Napi::Value GetInfo(const Napi::CallbackInfo&);
   Napi::Value SendRaw(const Napi::CallbackInfo&);
+  Napi::Value SendRawInto(const Napi::CallbackInfo&);
+  // Terminator-delimited raw frames read into a reusable buffer pool
+  Napi::Value StartRawStream(const Napi::CallbackInfo&);
+  Napi::Value StopRawStream(const Napi::CallbackInfo&);
+  Napi::Value GetRawStreamStatus(const Napi::CallbackInfo&);
   Napi::Value GetSpectrumCapabilities(const Napi::CallbackInfo&);
   Napi::Value StartSpectrumStream(const Napi::CallbackInfo&);
   Napi::Value StopSpectrumStream(const Napi::CallbackInfo&);
+  Napi::Value GetSpectrumStreamStats(const Napi::CallbackInfo&);
+  // Synthetic lines through the live stream's native path (benchmarks)
+  Napi::Value InjectSpectrumLines(const Napi::CallbackInfo&);
+  // Pseudo-bandscope: tune-and-measure sweeps fed into the spectrum stream
+  Napi::Value StartSweep(const Napi::CallbackInfo&);
+  Napi::Value StopSweep(const Napi::CallbackInfo&);
+  Napi::Value GetSweepStatus(const Napi::CallbackInfo&);
+  Napi::Value StartSpectrumRecording(const Napi::CallbackInfo&);
+  Napi::Value StopSpectrumRecording(const Napi::CallbackInfo&);
+  Napi::Value GetSpectrumRecordingStats(const Napi::CallbackInfo&);
   Napi::Value SetConf(const Napi::CallbackInfo&);
   Napi::Value GetConf(const Napi::CallbackInfo&);
 
@@ -248,6 +473,9 @@ class NodeHamLib : public Napi::ObjectWrap<NodeHamLib> {
 
   // Static method to get supported rig models
   static Napi::Value GetSupportedRigs(const Napi::CallbackInfo&);
+  static Napi::Value GetSupportedRigsAsync(const Napi::CallbackInfo&);
+  static Napi::Value GetSupportedRigsColumnar(const Napi::CallbackInfo&);
+  static Napi::Value GetSupportedRig(const Napi::CallbackInfo&);
 
   // Static method to get Hamlib version
   static Napi::Value GetHamlibVersion(const Napi::CallbackInfo&);
@@ -261,10 +489,28 @@ class NodeHamLib : public Napi::ObjectWrap<NodeHamLib> {
   static Napi::Value IsGlobalLockEnabled(const Napi::CallbackInfo&);
   static void SetGlobalRigLockEnabled(bool enabled);
   static bool IsGlobalRigLockEnabled();
-  static GlobalRigLock TryAcquireGlobalRigLockIfEnabled(std::chrono::milliseconds timeout);
+  static GlobalRigLock TryAcquireGlobalRigLockIfEnabled(std::chrono::milliseconds timeout,
+    RigCommandPriority priority = RigCommandPriority::Interactive);
+  static Napi::Value SetLockScope(const Napi::CallbackInfo&);
+  static Napi::Value GetLockScope(const Napi::CallbackInfo&);
+  static Napi::Value SetBackendSerialized(const Napi::CallbackInfo&);
+  // False while a RigLockScopeUse is alive; the scope is left unchanged.
+  static bool SetRigLockScope(RigLockScope scope);
+  static RigLockScope GetRigLockScope();
+  static void RetainRigLockScope();
+  static void ReleaseRigLockScope();
+  static bool IsBackendSerialized(unsigned int model);
+  // Acquire the I/O lock selected by the current lock scope for this instance;
+  // waiters of a higher priority class get it first.
+  GlobalRigLock TryAcquireRigLockIfEnabled(std::chrono::milliseconds timeout, RigLockScope* acquiredScope = nullptr,
+    RigCommandPriority priority = RigCommandPriority::Interactive);
   static std::mutex& MetadataMutex();
   static Napi::Value GetConfigSchemaForModel(const Napi::CallbackInfo&);
   static Napi::Value GetPortCapsForModel(const Napi::CallbackInfo&);
+  // Prebuilt model index answering the model lookups above without backends
+  static Napi::Value BuildModelIndex(const Napi::CallbackInfo&);
+  static Napi::Value LoadModelIndex(const Napi::CallbackInfo&);
+  static Napi::Value GetModelIndexInfo(const Napi::CallbackInfo&);
 
   // Static copyright/license
   static Napi::Value GetCopyright(const Napi::CallbackInfo&);
@@ -274,6 +520,8 @@ class NodeHamLib : public Napi::ObjectWrap<NodeHamLib> {
 
   // Frequency change callback (uses basic C types via shim)
   static int freq_change_cb(void* handle, int vfo, double freq, void* arg);
+  static int mode_change_cb(void* handle, int vfo, int mode, int width, void* arg);
+  static int ptt_change_cb(void* handle, int vfo, int ptt, void* arg);
   static int spectrum_line_cb(void* handle, const shim_spectrum_line_t* line, void* arg);
 
  public:
@@ -282,26 +530,119 @@ class NodeHamLib : public Napi::ObjectWrap<NodeHamLib> {
   bool is_network_rig = false;     // Flag to indicate if using network connection
   unsigned int original_model = 0;  // Store original model when using network
   int count = 0;
-  void* freq_emit_cb = nullptr;
   char port_path[SHIM_HAMLIB_FILPATHLEN]{};  // Store the port path
-  static Napi::FunctionReference constructor;
-  Napi::CallbackInfo * m_currentInfo = nullptr;
+  // Environment this instance was created in; cleared if that data is
+  // finalized first.
+  HamLibAddonData* addon_data_ = nullptr;
+  // Stops every native thread of the instance and closes the rig. Called by
+  // the destructor and by the environment cleanup hook; idempotent.
+  void ShutdownNative();
+  // batch() parsing shared with HamLibGroup; null after throwing.
+  static std::shared_ptr<const RigBatchPlan> ParseBatchPlan(Napi::Env env, const Napi::Array& operations);
+  // Runs `plan` the way batch() does, under this rig's own lock and command
+  // thread (or through its shared rigctld session), and reports to `done`
+  // instead of settling a promise. `done` may run before this returns.
+  void QueueBatchPlan(Napi::Env env, const std::shared_ptr<const RigBatchPlan>& plan, bool continue_on_error,
+                      RigGroupDone done);
+  // Per-device and per-instance I/O mutexes, resolved once at construction.
+  std::shared_ptr<std::timed_mutex> port_rig_mutex_;
+  std::shared_ptr<std::timed_mutex> instance_rig_mutex_;
+  // Set while the opt-in command thread is enabled; JS thread only.
+  std::shared_ptr<RigCommandExecutor> command_executor_;
+  // Created by the first startPolling() call; JS thread only.
+  std::shared_ptr<RigPollScheduler> poll_scheduler_;
+  // The schedule of the last startTracking() call; JS thread only.
+  std::shared_ptr<RigTracker> tracker_;
+  // The stream of the last startRawStream() call; JS thread only.
+  std::shared_ptr<RigRawStream> raw_stream_;
+  // The job of the last startSweep() call; JS thread only.
+  std::shared_ptr<RigSweep> sweep_;
+  // Metrics for this instance's workers; the process-wide totals live in
+  // RigMetricsRegistry::Global().
+  std::shared_ptr<RigMetricsRegistry> metrics_ = std::make_shared<RigMetricsRegistry>();
+  // Kept after disableTrace() so the last events can still be dumped;
+  // workers only record while trace_enabled_. JS thread only.
+  std::shared_ptr<RigTraceRing> trace_;
+  bool trace_enabled_ = false;
+  // Filled by get/set workers, batch and poll reads and transceive events.
+  RigStateCache state_cache_;
+  // Set by openSharedSession(); batch() goes through it instead of Hamlib's
+  // own netrigctl connection. JS thread only.
+  std::unique_ptr<RigctldSessionClient> session_client_;
+
+  // Set by a successful open() (or the first caps query after it) and
+  // dropped by close()/destroy(). Written under the rig lock, read anywhere.
+  std::shared_ptr<const RigCapabilitySnapshot> CapabilitySnapshot() const;
+  void SetCapabilitySnapshot(std::shared_ptr<const RigCapabilitySnapshot> snapshot);
+  Napi::Value QueueCapabilityQuery(Napi::Env env, const char* operation,
+    std::function<Napi::Value(Napi::Env, const RigCapabilitySnapshot&)> build);
+  // Throws when no snapshot has been captured yet.
+  Napi::Value CapabilitySync(const Napi::CallbackInfo& info,
+    const std::function<Napi::Value(Napi::Env, const RigCapabilitySnapshot&)>& build);
+  mutable std::mutex capabilities_mutex_;
+  std::shared_ptr<const RigCapabilitySnapshot> capabilities_;
+
+  // Request coalescing; JS thread only. Reads join an identical read that is
+  // queued or running; a setFrequency replaces the value of one that has not
+  // reached the rig yet. Any other command is a barrier for both.
+  Napi::Value QueueCoalescedRead(Napi::Env env, const std::string& key, const std::function<HamLibAsyncWorker*()>& create);
+  void NoteCommandQueued(HamLibAsyncWorker* worker, const std::string& key, bool write);
+  bool coalesce_reads_ = false;
+  bool coalesce_writes_ = false;
+  std::unordered_map<std::string, HamLibAsyncWorker*> inflight_reads_;
+  std::unordered_map<std::string, HamLibAsyncWorker*> pending_writes_;
+  uint64_t coalesced_reads_ = 0;
+  uint64_t coalesced_writes_ = 0;
+
+  // Priority classes; JS thread only. inflight_commands_ counts workers
+  // queued and not yet completed; once it reaches a non-zero
+  // background_budget_, new background commands are shed.
+  RigCommandPriority CommandPriorityFor(const char* operation, RigCommandPriority fallback) const;
+  std::unordered_map<std::string, RigCommandPriority> command_priorities_;
+  uint32_t background_budget_ = 0;
+  size_t inflight_commands_ = 0;
+
+  // Call scopes; JS thread only. A worker constructed while a scope is open
+  // takes the innermost one. call_controls_ lets an AbortSignal reach the
+  // scope after it closed, for as long as one of its workers is alive.
+  std::shared_ptr<RigCallControl> CurrentCallControl() const;
+  std::vector<std::shared_ptr<RigCallControl>> call_scopes_;
+  std::unordered_map<uint32_t, std::weak_ptr<RigCallControl>> call_controls_;
+  uint32_t next_call_id_ = 1;
 
   // Helper method to detect network address format
   bool isNetworkAddress(const char* path);
 
   // Static callback helper for shim_rig_list_foreach
-  static int rig_list_callback(const shim_rig_info_t* info, void* data);
   static int rig_config_callback(const shim_confparam_info_t* info, void* data);
 
-  void EmitSpectrumLine(const shim_spectrum_line_t& line);
+  // False when no spectrum stream is running. Lines with `record` false
+  // bypass the spectrum recorder.
+  bool EmitSpectrumLine(const shim_spectrum_line_t& line, bool record = true);
+  void FlushPartialSpectrumBatch();
+  void ScheduleSpectrumFlushLocked();
   void StopSpectrumStreamInternal();
   std::atomic<bool> spectrum_stream_running_{false};
   Napi::ThreadSafeFunction spectrum_tsfn_;
+  // Line slots of the current (or last) stream; kept after stop for stats.
+  std::shared_ptr<SpectrumLineRing> spectrum_ring_;
+  // Optional DSP stage applied before lines enter the ring; null when disabled.
+  std::shared_ptr<SpectrumLineProcessor> spectrum_processor_;
+  // Appends every queued line to disk, independent of JS back-pressure.
+  std::unique_ptr<SpectrumRecorder> spectrum_recorder_;
   std::mutex spectrum_mutex_;
 
+  void EmitTransceiveEvent(const RigTransceiveEvent& event);
+  void StopTransceiveEventsInternal();
+  Napi::ThreadSafeFunction transceive_tsfn_;
+  std::mutex transceive_mutex_;
+  // SHIM_RIG_TRN_* applied by open(); RIG matches what open() always requested.
+  std::atomic<int> transceive_mode_{SHIM_RIG_TRN_RIG};
+
  private:
   static std::timed_mutex global_rig_mutex_;
   static std::atomic<bool> global_rig_lock_enabled_;
+  // RigLockScope in the low bits, live RigLockScopeUse count above them.
+  static std::atomic<int> rig_lock_scope_;
   static std::mutex metadata_mutex_;
 };
@@ -0,0 +1,158 @@
+#include "node_hamlib_group.h"
+
+#include "addon_data.h"
+#include "hamlib.h"
+#include "rig_metrics.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace {
+
+constexpr uint32_t kMaxGroupRigs = 32;
+
+// One group call in flight; JS thread only.
+struct GroupCall {
+  explicit GroupCall(Napi::Env env) : deferred(Napi::Promise::Deferred::New(env)) {}
+
+  Napi::Promise::Deferred deferred;
+  Napi::ObjectReference self;
+  Napi::ObjectReference entries;
+  int64_t started_us = 0;
+  size_t remaining = 0;
+  bool ok = true;
+  int64_t first_applied_us = 0;
+  int64_t last_applied_us = 0;
+};
+
+double millisSince(int64_t from_us, int64_t to_us) {
+  return static_cast<double>(to_us - from_us) / 1000.0;
+}
+
+void finishGroupCall(Napi::Env env, const std::shared_ptr<GroupCall>& call) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("ok", Napi::Boolean::New(env, call->ok));
+  result.Set("skewMs", Napi::Number::New(env, call->first_applied_us == 0
+    ? 0 : millisSince(call->first_applied_us, call->last_applied_us)));
+  result.Set("elapsedMs", Napi::Number::New(env, millisSince(call->started_us, rigMetricsNowMicros())));
+  result.Set("rigs", call->entries.Value());
+  call->deferred.Resolve(result);
+  call->entries.Reset();
+  call->self.Reset();
+}
+
+void noteGroupOutcome(Napi::Env env, const std::shared_ptr<GroupCall>& call, size_t index,
+                      const RigGroupOutcome& outcome) {
+  Napi::HandleScope scope(env);
+  const bool ok = outcome.resolved && outcome.failed_items == 0;
+  Napi::Object entry = Napi::Object::New(env);
+  entry.Set("index", Napi::Number::New(env, static_cast<double>(index)));
+  entry.Set("ok", Napi::Boolean::New(env, ok));
+  entry.Set(outcome.resolved ? "results" : "error", outcome.value);
+  if (outcome.started_us > 0) {
+    entry.Set("startedMs", Napi::Number::New(env, millisSince(call->started_us, outcome.started_us)));
+  }
+  if (outcome.applied_us > 0) {
+    entry.Set("appliedMs", Napi::Number::New(env, millisSince(call->started_us, outcome.applied_us)));
+  }
+  call->entries.Value().Set(static_cast<uint32_t>(index), entry);
+
+  call->ok = call->ok && ok;
+  if (ok && outcome.applied_us > 0) {
+    call->first_applied_us = call->first_applied_us == 0
+      ? outcome.applied_us : std::min(call->first_applied_us, outcome.applied_us);
+    call->last_applied_us = std::max(call->last_applied_us, outcome.applied_us);
+  }
+  if (--call->remaining == 0) {
+    finishGroupCall(env, call);
+  }
+}
+
+}  // namespace
+
+NodeHamLibGroup::NodeHamLibGroup(const Napi::CallbackInfo& info) : ObjectWrap(info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected (rigs: HamLib[])").ThrowAsJavaScriptException();
+    return;
+  }
+  Napi::Array rigs = info[0].As<Napi::Array>();
+  if (rigs.Length() == 0 || rigs.Length() > kMaxGroupRigs) {
+    Napi::RangeError::New(env, "A group takes between 1 and " + std::to_string(kMaxGroupRigs) + " rigs")
+      .ThrowAsJavaScriptException();
+    return;
+  }
+  HamLibAddonData* addonData = HamLibAddonData::From(env);
+  for (uint32_t i = 0; i < rigs.Length(); ++i) {
+    Napi::Value value = rigs.Get(i);
+    if (!value.IsObject() || !addonData
+        || !value.As<Napi::Object>().InstanceOf(addonData->hamlib_constructor.Value())) {
+      Napi::TypeError::New(env, "rigs[" + std::to_string(i) + "] must be a HamLib instance").ThrowAsJavaScriptException();
+      return;
+    }
+    NodeHamLib* rig = Napi::ObjectWrap<NodeHamLib>::Unwrap(value.As<Napi::Object>());
+    if (std::find(rigs_.begin(), rigs_.end(), rig) != rigs_.end()) {
+      Napi::TypeError::New(env, "rigs[" + std::to_string(i) + "] is already in the group").ThrowAsJavaScriptException();
+      return;
+    }
+    rigs_.push_back(rig);
+    rig_refs_.push_back(Napi::Persistent(value.As<Napi::Object>()));
+  }
+}
+
+Napi::Value NodeHamLibGroup::Batch(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "Expected (operations: Array<{ op: string }>, options?: { continueOnError?: boolean })")
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  bool continueOnError = true;
+  if (info.Length() >= 2 && info[1].IsObject()) {
+    Napi::Object options = info[1].As<Napi::Object>();
+    if (options.Has("continueOnError")) {
+      if (!options.Get("continueOnError").IsBoolean()) {
+        Napi::TypeError::New(env, "continueOnError must be a boolean").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      continueOnError = options.Get("continueOnError").As<Napi::Boolean>().Value();
+    }
+  }
+  std::shared_ptr<const RigBatchPlan> plan = NodeHamLib::ParseBatchPlan(env, info[0].As<Napi::Array>());
+  if (!plan) {
+    return env.Null();
+  }
+
+  auto call = std::make_shared<GroupCall>(env);
+  call->self = Napi::Persistent(info.This().As<Napi::Object>());
+  call->entries = Napi::Persistent(Napi::Array::New(env, rigs_.size()));
+  call->started_us = rigMetricsNowMicros();
+  Napi::Promise promise = call->deferred.Promise();
+  // One extra count while queuing, so a rig that reports synchronously (a
+  // closed shared session) cannot finish the call before the rest are queued.
+  call->remaining = rigs_.size() + 1;
+  for (size_t i = 0; i < rigs_.size(); ++i) {
+    rigs_[i]->QueueBatchPlan(env, plan, continueOnError,
+      [call, i](Napi::Env env, const RigGroupOutcome& outcome) { noteGroupOutcome(env, call, i, outcome); });
+  }
+  if (--call->remaining == 0) {
+    finishGroupCall(env, call);
+  }
+  return promise;
+}
+
+Napi::Value NodeHamLibGroup::Size(const Napi::CallbackInfo& info) {
+  return Napi::Number::New(info.Env(), static_cast<double>(rigs_.size()));
+}
+
+Napi::Function NodeHamLibGroup::GetClass(Napi::Env env) {
+  return DefineClass(
+      env,
+      "HamLibGroup",
+      {
+          InstanceMethod("batch", &NodeHamLibGroup::Batch),
+          InstanceMethod("size", &NodeHamLibGroup::Size),
+      });
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <napi.h>
+#include <vector>
+
+class NodeHamLib;
+
+// Several HamLib instances driven as one: a call runs the same batch() on
+// every rig at once, each on its own lock and command thread, and settles
+// once with every rig's outcome and the skew between the first and the last
+// rig applying it. Rigs only overlap when their locks are independent
+// (setLockScope('port') or 'instance'); under the global lock they run one
+// after another.
+class NodeHamLibGroup : public Napi::ObjectWrap<NodeHamLibGroup> {
+ public:
+  NodeHamLibGroup(const Napi::CallbackInfo&);
+
+  Napi::Value Batch(const Napi::CallbackInfo&);
+  Napi::Value Size(const Napi::CallbackInfo&);
+
+  static Napi::Function GetClass(Napi::Env);
+
+ private:
+  std::vector<NodeHamLib*> rigs_;
+  // Keeps the rigs' JS objects alive for the group's lifetime.
+  std::vector<Napi::ObjectReference> rig_refs_;
+};
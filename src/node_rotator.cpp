@@ -1,10 +1,16 @@
 #include "node_rotator.h"
+#include "addon_data.h"
+#include "rig_metrics_js.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <limits>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #define CHECK_ROT_VALID() \
@@ -26,6 +32,11 @@
 
 namespace {
 
+constexpr size_t kRotatorQueueCapacity = 256;
+constexpr const char* kRotatorQueueFullCode = "HAMLIB_COMMAND_QUEUE_FULL";
+// How long teardown waits for a rig's tracking step to release the rotator.
+constexpr std::chrono::milliseconds kRotatorShutdownIoTimeout(5000);
+
 struct RotatorListData {
   std::vector<Napi::Object> rotators;
   Napi::Env env;
@@ -207,31 +218,225 @@ uint64_t parseRotParm(Napi::Env env, const Napi::Value& value) {
 
 }  // namespace
 
-class RotatorAsyncWorker : public Napi::AsyncWorker {
+class RotatorAsyncWorker;
+
+// Promise of one rotator command plus any setPosition calls merged into it.
+class RotatorPromiseController {
+ public:
+  RotatorPromiseController(Napi::Env env, RotatorAsyncWorker* owner)
+      : deferred_(Napi::Promise::Deferred::New(env)), owner_(owner) {}
+
+  Napi::Promise Promise() const { return deferred_.Promise(); }
+  Napi::Promise AddFollower(Napi::Env env) {
+    followers_.push_back(Napi::Promise::Deferred::New(env));
+    return followers_.back().Promise();
+  }
+  void Resolve(Napi::Value value);
+  void Reject(Napi::Value value);
+
+ private:
+  Napi::Promise::Deferred deferred_;
+  std::vector<Napi::Promise::Deferred> followers_;
+  RotatorAsyncWorker* owner_;
+};
+
+// Base class for rotator commands. Every command of one rotator runs on that
+// rotator's command thread in submission order, with the same per-operation
+// metrics and error decoration as the rig workers.
+class RotatorAsyncWorker : public Napi::AsyncWorker, public RigCommandTask {
  public:
   RotatorAsyncWorker(Napi::Env env, NodeRotator* rotator_instance)
       : Napi::AsyncWorker(env),
         rotator_instance_(rotator_instance),
         result_code_(0),
-        deferred_(Napi::Promise::Deferred::New(env)) {}
+        metrics_(rotator_instance ? rotator_instance->metrics_ : nullptr),
+        deferred_(env, this) {
+    if (rotator_instance_) {
+      rotator_instance_->Ref();
+      object_ref_held_ = true;
+    }
+  }
+
+  ~RotatorAsyncWorker() override {
+    // Queued but never executed (e.g. environment teardown).
+    if (metrics_queued_) {
+      RigMetricsRegistry::Global().NoteDequeued();
+      if (metrics_) {
+        metrics_->NoteDequeued();
+      }
+    }
+    ReleaseObjectReference();
+  }
 
   Napi::Promise GetPromise() { return deferred_.Promise(); }
+  Napi::Promise AddFollower(Napi::Env env) { return deferred_.AddFollower(env); }
+
+  // Returns false when the command queue rejected the worker; it then fails
+  // asynchronously with HAMLIB_COMMAND_QUEUE_FULL and is no coalescing barrier.
+  bool Queue() {
+    if (!metrics_queued_) {
+      metrics_queued_ = true;
+      RigMetricsRegistry::Global().NoteQueued();
+      if (metrics_) {
+        metrics_->NoteQueued();
+      }
+    }
+    if (rotator_instance_ && rotator_instance_->executor_) {
+      if (rotator_instance_->executor_->Submit(this)) {
+        rotator_instance_->NoteCommandQueued(this, ClearsPositionTarget());
+        return true;
+      }
+      // Delivered through the threadpool so the rejection stays asynchronous.
+      result_code_ = SHIM_RIG_ENAVAIL;
+      error_code_ = kRotatorQueueFullCode;
+      error_message_ = std::string(kRotatorQueueFullCode)
+          + ": rotator command queue is full operation=" + OperationName();
+      Napi::AsyncWorker::Queue();
+      return false;
+    }
+    if (rotator_instance_) {
+      rotator_instance_->NoteCommandQueued(this, ClearsPositionTarget());
+    }
+    Napi::AsyncWorker::Queue();
+    return true;
+  }
+
+  void RunOnCommandThread() override { Execute(); }
+
+  void CompleteOnJsThread(Napi::Env env) override {
+    (void)env;
+    OnOK();
+    Destroy();
+  }
+
+  Napi::Value DecorateErrorValue(Napi::Value value) const {
+    if (!value.IsObject()) {
+      return value;
+    }
+    Napi::Object error = value.As<Napi::Object>();
+    Napi::Env env = value.Env();
+    error.Set("operation", Napi::String::New(env, OperationName()));
+    if (error.Has("code")) {
+      return error;
+    }
+    if (!error_code_.empty()) {
+      error.Set("code", Napi::String::New(env, error_code_));
+    } else if (result_code_ != SHIM_RIG_OK) {
+      error.Set("code", Napi::String::New(env, "HAMLIB_ERROR"));
+      error.Set("hamlibCode", Napi::Number::New(env, result_code_));
+    }
+    return error;
+  }
+
+  void ReleaseObjectReference() {
+    if (object_ref_held_ && rotator_instance_) {
+      rotator_instance_->Unref();
+      object_ref_held_ = false;
+    }
+  }
 
  protected:
+  void Execute() final {
+    RigMetricsRegistry& globalMetrics = RigMetricsRegistry::Global();
+    RigMetricsRegistry* rotMetrics = metrics_.get();
+    if (metrics_queued_) {
+      metrics_queued_ = false;
+      globalMetrics.NoteDequeued();
+      if (rotMetrics) {
+        rotMetrics->NoteDequeued();
+      }
+    }
+    RigOperationMetrics* globalOperation = globalMetrics.ForOperation(OperationName());
+    RigOperationMetrics* rotOperation = rotMetrics ? rotMetrics->ForOperation(OperationName()) : nullptr;
+    if (!error_code_.empty()) {
+      globalOperation->RecordRejected();
+      if (rotOperation) {
+        rotOperation->RecordRejected();
+      }
+      return;
+    }
+
+    const int64_t startedUs = rigMetricsNowMicros();
+    globalMetrics.NoteExecuteBegin();
+    if (rotMetrics) {
+      rotMetrics->NoteExecuteBegin();
+    }
+    if (!rotator_instance_) {
+      result_code_ = SHIM_RIG_EINVAL;
+      error_message_ = "Rotator is not initialized or has been destroyed";
+    } else {
+      std::lock_guard<std::timed_mutex> ioLock(rotator_instance_->io_mutex_);
+      if (!rotator_instance_->my_rot) {
+        result_code_ = SHIM_RIG_EINVAL;
+        error_message_ = "Rotator is not initialized or has been destroyed";
+      } else if (RequiresOpenRotator() && !rotator_instance_->rot_is_open.load(std::memory_order_acquire)) {
+        result_code_ = SHIM_RIG_EINVAL;
+        error_message_ = "Rotator is not open!";
+      } else {
+        ExecuteOnRotator();
+      }
+    }
+    const uint64_t executeUs = static_cast<uint64_t>(std::max<int64_t>(0, rigMetricsNowMicros() - startedUs));
+    const bool failed = result_code_ < 0 || !error_message_.empty();
+    globalMetrics.NoteExecuteEnd();
+    globalOperation->RecordCall(executeUs, failed, result_code_);
+    if (rotMetrics) {
+      rotMetrics->NoteExecuteEnd();
+      rotOperation->RecordCall(executeUs, failed, result_code_);
+    }
+  }
+
+  virtual void ExecuteOnRotator() = 0;
+  virtual const char* OperationName() const = 0;
+  virtual bool RequiresOpenRotator() const { return true; }
+  // Whether the command moves (or may move) the rotator away from the last
+  // setPosition target, so the next setPosition must not fall in the deadband.
+  virtual bool ClearsPositionTarget() const { return false; }
+
   NodeRotator* rotator_instance_;
   int result_code_;
+  std::string error_code_;
   std::string error_message_;
-  Napi::Promise::Deferred deferred_;
+  bool object_ref_held_ = false;
+  std::shared_ptr<RigMetricsRegistry> metrics_;
+  bool metrics_queued_ = false;
+  RotatorPromiseController deferred_;
 };
 
-Napi::FunctionReference NodeRotator::constructor;
+void RotatorPromiseController::Resolve(Napi::Value value) {
+  if (owner_) {
+    owner_->ReleaseObjectReference();
+  }
+  deferred_.Resolve(value);
+  for (const Napi::Promise::Deferred& follower : followers_) {
+    follower.Resolve(value);
+  }
+  followers_.clear();
+}
+
+void RotatorPromiseController::Reject(Napi::Value value) {
+  if (owner_) {
+    value = owner_->DecorateErrorValue(value);
+    owner_->ReleaseObjectReference();
+  }
+  deferred_.Reject(value);
+  for (const Napi::Promise::Deferred& follower : followers_) {
+    follower.Reject(value);
+  }
+  followers_.clear();
+}
+
 
 class RotatorOpenAsyncWorker : public RotatorAsyncWorker {
  public:
   RotatorOpenAsyncWorker(Napi::Env env, NodeRotator* rotator_instance)
       : RotatorAsyncWorker(env, rotator_instance) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorOpen"; }
+  bool RequiresOpenRotator() const override { return false; }
+  bool ClearsPositionTarget() const override { return true; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     result_code_ = shim_rot_open(rotator_instance_->my_rot);
     if (result_code_ != SHIM_RIG_OK) {
@@ -255,7 +460,11 @@ class RotatorCloseAsyncWorker : public RotatorAsyncWorker {
   RotatorCloseAsyncWorker(Napi::Env env, NodeRotator* rotator_instance)
       : RotatorAsyncWorker(env, rotator_instance) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorClose"; }
+  bool RequiresOpenRotator() const override { return false; }
+  bool ClearsPositionTarget() const override { return true; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     result_code_ = shim_rot_close(rotator_instance_->my_rot);
     if (result_code_ != SHIM_RIG_OK) {
@@ -279,7 +488,11 @@ class RotatorDestroyAsyncWorker : public RotatorAsyncWorker {
   RotatorDestroyAsyncWorker(Napi::Env env, NodeRotator* rotator_instance)
       : RotatorAsyncWorker(env, rotator_instance) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorDestroy"; }
+  bool RequiresOpenRotator() const override { return false; }
+  bool ClearsPositionTarget() const override { return true; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     if (rotator_instance_->rot_is_open) {
       shim_rot_close(rotator_instance_->my_rot);
@@ -307,16 +520,49 @@ class RotatorSetPositionAsyncWorker : public RotatorAsyncWorker {
   RotatorSetPositionAsyncWorker(Napi::Env env, NodeRotator* rotator_instance, double azimuth, double elevation)
       : RotatorAsyncWorker(env, rotator_instance), azimuth_(azimuth), elevation_(elevation) {}
 
-  void Execute() override {
+  ~RotatorSetPositionAsyncWorker() override {
+    if (rotator_instance_ && rotator_instance_->pending_position_ == this) {
+      rotator_instance_->pending_position_ = nullptr;
+    }
+  }
+
+  const char* OperationName() const override { return "RotatorSetPosition"; }
+
+  // Replaces the target if the command has not started yet (JS thread).
+  bool Retarget(double azimuth, double elevation) {
+    std::lock_guard<std::mutex> guard(target_mutex_);
+    if (started_) {
+      return false;
+    }
+    azimuth_ = azimuth;
+    elevation_ = elevation;
+    return true;
+  }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
-    result_code_ = shim_rot_set_position(rotator_instance_->my_rot, azimuth_, elevation_);
+    double azimuth = 0;
+    double elevation = 0;
+    {
+      std::lock_guard<std::mutex> guard(target_mutex_);
+      started_ = true;
+      azimuth = azimuth_;
+      elevation = elevation_;
+    }
+    result_code_ = shim_rot_set_position(rotator_instance_->my_rot, azimuth, elevation);
     if (result_code_ != SHIM_RIG_OK) {
       error_message_ = shim_rigerror(result_code_);
     }
   }
 
   void OnOK() override {
+    if (rotator_instance_ && rotator_instance_->pending_position_ == this) {
+      rotator_instance_->pending_position_ = nullptr;
+    }
     if (!error_message_.empty()) {
+      if (rotator_instance_) {
+        rotator_instance_->has_position_target_ = false;
+      }
       deferred_.Reject(Napi::Error::New(Env(), error_message_).Value());
       return;
     }
@@ -324,6 +570,8 @@ class RotatorSetPositionAsyncWorker : public RotatorAsyncWorker {
   }
 
  private:
+  std::mutex target_mutex_;
+  bool started_ = false;
   double azimuth_;
   double elevation_;
 };
@@ -333,7 +581,9 @@ class RotatorGetPositionAsyncWorker : public RotatorAsyncWorker {
   RotatorGetPositionAsyncWorker(Napi::Env env, NodeRotator* rotator_instance)
       : RotatorAsyncWorker(env, rotator_instance), azimuth_(0), elevation_(0) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorGetPosition"; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     result_code_ = shim_rot_get_position(rotator_instance_->my_rot, &azimuth_, &elevation_);
     if (result_code_ != SHIM_RIG_OK) {
@@ -362,7 +612,10 @@ class RotatorMoveAsyncWorker : public RotatorAsyncWorker {
   RotatorMoveAsyncWorker(Napi::Env env, NodeRotator* rotator_instance, int direction, int speed)
       : RotatorAsyncWorker(env, rotator_instance), direction_(direction), speed_(speed) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorMove"; }
+  bool ClearsPositionTarget() const override { return true; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     result_code_ = shim_rot_move(rotator_instance_->my_rot, direction_, speed_);
     if (result_code_ != SHIM_RIG_OK) {
@@ -387,10 +640,14 @@ class RotatorSimpleAsyncWorker : public RotatorAsyncWorker {
  public:
   typedef int (*OpFn)(hamlib_shim_handle_t);
 
-  RotatorSimpleAsyncWorker(Napi::Env env, NodeRotator* rotator_instance, OpFn fn)
-      : RotatorAsyncWorker(env, rotator_instance), fn_(fn) {}
+  RotatorSimpleAsyncWorker(Napi::Env env, NodeRotator* rotator_instance, OpFn fn, const char* operation)
+      : RotatorAsyncWorker(env, rotator_instance), fn_(fn), operation_(operation) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return operation_; }
+  // stop and park both leave the rotator somewhere other than the last target.
+  bool ClearsPositionTarget() const override { return true; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     result_code_ = fn_(rotator_instance_->my_rot);
     if (result_code_ != SHIM_RIG_OK) {
@@ -408,6 +665,7 @@ class RotatorSimpleAsyncWorker : public RotatorAsyncWorker {
 
  private:
   OpFn fn_;
+  const char* operation_;
 };
 
 class RotatorResetAsyncWorker : public RotatorAsyncWorker {
@@ -415,7 +673,10 @@ class RotatorResetAsyncWorker : public RotatorAsyncWorker {
   RotatorResetAsyncWorker(Napi::Env env, NodeRotator* rotator_instance, int reset_type)
       : RotatorAsyncWorker(env, rotator_instance), reset_type_(reset_type) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorReset"; }
+  bool ClearsPositionTarget() const override { return true; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     result_code_ = shim_rot_reset(rotator_instance_->my_rot, reset_type_);
     if (result_code_ != SHIM_RIG_OK) {
@@ -440,7 +701,10 @@ class RotatorGetInfoAsyncWorker : public RotatorAsyncWorker {
   RotatorGetInfoAsyncWorker(Napi::Env env, NodeRotator* rotator_instance)
       : RotatorAsyncWorker(env, rotator_instance) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorGetInfo"; }
+  bool RequiresOpenRotator() const override { return false; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     info_ = shim_rot_get_info(rotator_instance_->my_rot);
   }
@@ -458,7 +722,9 @@ class RotatorGetStatusAsyncWorker : public RotatorAsyncWorker {
   RotatorGetStatusAsyncWorker(Napi::Env env, NodeRotator* rotator_instance)
       : RotatorAsyncWorker(env, rotator_instance), status_(0) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorGetStatus"; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     result_code_ = shim_rot_get_status(rotator_instance_->my_rot, &status_);
     if (result_code_ != SHIM_RIG_OK) {
@@ -486,7 +752,10 @@ class RotatorSetConfAsyncWorker : public RotatorAsyncWorker {
   RotatorSetConfAsyncWorker(Napi::Env env, NodeRotator* rotator_instance, std::string name, std::string value)
       : RotatorAsyncWorker(env, rotator_instance), name_(std::move(name)), value_(std::move(value)) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorSetConf"; }
+  bool RequiresOpenRotator() const override { return false; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     result_code_ = shim_rot_set_conf(rotator_instance_->my_rot, name_.c_str(), value_.c_str());
     if (result_code_ != SHIM_RIG_OK) {
@@ -514,7 +783,10 @@ class RotatorGetConfAsyncWorker : public RotatorAsyncWorker {
     memset(buf_, 0, sizeof(buf_));
   }
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorGetConf"; }
+  bool RequiresOpenRotator() const override { return false; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     result_code_ = shim_rot_get_conf(rotator_instance_->my_rot, name_.c_str(), buf_, sizeof(buf_));
     if (result_code_ != SHIM_RIG_OK) {
@@ -540,7 +812,9 @@ class RotatorSetLevelAsyncWorker : public RotatorAsyncWorker {
   RotatorSetLevelAsyncWorker(Napi::Env env, NodeRotator* rotator_instance, uint64_t level, double value)
       : RotatorAsyncWorker(env, rotator_instance), level_(level), value_(value) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorSetLevel"; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     if (level_ == SHIM_ROT_LEVEL_SPEED) {
       result_code_ = shim_rot_set_level_i(rotator_instance_->my_rot, level_, static_cast<int>(value_));
@@ -570,7 +844,9 @@ class RotatorGetLevelAsyncWorker : public RotatorAsyncWorker {
   RotatorGetLevelAsyncWorker(Napi::Env env, NodeRotator* rotator_instance, uint64_t level)
       : RotatorAsyncWorker(env, rotator_instance), level_(level), value_(0) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorGetLevel"; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     result_code_ = shim_rot_get_level_auto(rotator_instance_->my_rot, level_, &value_);
     if (result_code_ != SHIM_RIG_OK) {
@@ -596,7 +872,9 @@ class RotatorSetFunctionAsyncWorker : public RotatorAsyncWorker {
   RotatorSetFunctionAsyncWorker(Napi::Env env, NodeRotator* rotator_instance, uint64_t func, int enable)
       : RotatorAsyncWorker(env, rotator_instance), func_(func), enable_(enable) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorSetFunction"; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     result_code_ = shim_rot_set_func(rotator_instance_->my_rot, func_, enable_);
     if (result_code_ != SHIM_RIG_OK) {
@@ -622,7 +900,9 @@ class RotatorGetFunctionAsyncWorker : public RotatorAsyncWorker {
   RotatorGetFunctionAsyncWorker(Napi::Env env, NodeRotator* rotator_instance, uint64_t func)
       : RotatorAsyncWorker(env, rotator_instance), func_(func), state_(0) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorGetFunction"; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     result_code_ = shim_rot_get_func(rotator_instance_->my_rot, func_, &state_);
     if (result_code_ != SHIM_RIG_OK) {
@@ -648,7 +928,9 @@ class RotatorSetParmAsyncWorker : public RotatorAsyncWorker {
   RotatorSetParmAsyncWorker(Napi::Env env, NodeRotator* rotator_instance, uint64_t parm, double value)
       : RotatorAsyncWorker(env, rotator_instance), parm_(parm), value_(value) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorSetParm"; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     result_code_ = shim_rot_set_parm_f(rotator_instance_->my_rot, parm_, static_cast<float>(value_));
     if (result_code_ != SHIM_RIG_OK) {
@@ -674,7 +956,9 @@ class RotatorGetParmAsyncWorker : public RotatorAsyncWorker {
   RotatorGetParmAsyncWorker(Napi::Env env, NodeRotator* rotator_instance, uint64_t parm)
       : RotatorAsyncWorker(env, rotator_instance), parm_(parm), value_(0) {}
 
-  void Execute() override {
+  const char* OperationName() const override { return "RotatorGetParm"; }
+
+  void ExecuteOnRotator() override {
     CHECK_ROT_VALID();
     float raw = 0;
     result_code_ = shim_rot_get_parm_f(rotator_instance_->my_rot, parm_, &raw);
@@ -708,6 +992,10 @@ bool NodeRotator::isNetworkAddress(const char* path) {
 
 NodeRotator::NodeRotator(const Napi::CallbackInfo& info) : ObjectWrap(info), my_rot(nullptr) {
   Napi::Env env = info.Env();
+  addon_data_ = HamLibAddonData::From(env);
+  if (addon_data_) {
+    addon_data_->AddRotator(this);
+  }
 
   if (info.Length() < 1 || !info[0].IsNumber()) {
     Napi::TypeError::New(env, "Invalid rotator model").ThrowAsJavaScriptException();
@@ -742,10 +1030,31 @@ NodeRotator::NodeRotator(const Napi::CallbackInfo& info) : ObjectWrap(info), my_
     shim_rot_set_port_path(my_rot, port_path);
     shim_rot_set_port_type(my_rot, is_network_rot ? SHIM_RIG_PORT_NETWORK : SHIM_RIG_PORT_SERIAL);
   }
+
+  executor_ = RigCommandExecutor::Create(env, kRotatorQueueCapacity);
 }
 
 NodeRotator::~NodeRotator() {
+  if (addon_data_) {
+    addon_data_->RemoveRotator(this);
+  }
+  // Workers hold a reference, so nothing is queued any more.
+  ShutdownNative();
+}
+
+void NodeRotator::ShutdownNative() {
+  if (executor_) {
+    // Joins the command thread; workers still queued on it are abandoned
+    // rather than run against a rotator that is about to be cleaned up.
+    executor_->Shutdown();
+    executor_.reset();
+  }
   if (my_rot) {
+    // A rig's tracking loop may still be stepping this rotator.
+    std::unique_lock<std::timed_mutex> ioLock(io_mutex_, kRotatorShutdownIoTimeout);
+    if (!ioLock.owns_lock()) {
+      return;
+    }
     if (rot_is_open) {
       shim_rot_close(my_rot);
       rot_is_open = false;
@@ -784,6 +1093,16 @@ Napi::Value NodeRotator::GetConnectionInfo(const Napi::CallbackInfo& info) {
   return obj;
 }
 
+void NodeRotator::NoteCommandQueued(RotatorAsyncWorker* worker, bool clears_position_target) {
+  // Any other command is a barrier: a later setPosition must not jump ahead of it.
+  if (pending_position_ && static_cast<RotatorAsyncWorker*>(pending_position_) != worker) {
+    pending_position_ = nullptr;
+  }
+  if (clears_position_target) {
+    has_position_target_ = false;
+  }
+}
+
 Napi::Value NodeRotator::SetPosition(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   if (!rot_is_open) {
@@ -794,16 +1113,72 @@ Napi::Value NodeRotator::SetPosition(const Napi::CallbackInfo& info) {
     Napi::TypeError::New(env, "Expected (azimuth: number, elevation: number)").ThrowAsJavaScriptException();
     return env.Null();
   }
+  const double azimuth = info[0].As<Napi::Number>().DoubleValue();
+  const double elevation = info[1].As<Napi::Number>().DoubleValue();
 
-  auto* worker = new RotatorSetPositionAsyncWorker(
-      env,
-      this,
-      info[0].As<Napi::Number>().DoubleValue(),
-      info[1].As<Napi::Number>().DoubleValue());
-  worker->Queue();
+  // Within the deadband of the target already sent or queued: nothing to do.
+  if (has_position_target_ && (deadband_azimuth_ > 0 || deadband_elevation_ > 0)
+      && std::fabs(azimuth - position_target_azimuth_) <= deadband_azimuth_
+      && std::fabs(elevation - position_target_elevation_) <= deadband_elevation_) {
+    ++suppressed_positions_;
+    Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+    deferred.Resolve(Napi::Number::New(env, SHIM_RIG_OK));
+    return deferred.Promise();
+  }
+
+  has_position_target_ = true;
+  position_target_azimuth_ = azimuth;
+  position_target_elevation_ = elevation;
+
+  // Last writer wins while the previous target has not reached the rotator.
+  if (pending_position_ && pending_position_->Retarget(azimuth, elevation)) {
+    ++coalesced_positions_;
+    return pending_position_->AddFollower(env);
+  }
+
+  auto* worker = new RotatorSetPositionAsyncWorker(env, this, azimuth, elevation);
+  if (worker->Queue()) {
+    pending_position_ = worker;
+  }
   return worker->GetPromise();
 }
 
+Napi::Value NodeRotator::SetPositionDeadband(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsNumber() || (info.Length() >= 2 && !info[1].IsNumber())) {
+    Napi::TypeError::New(env, "Expected (azimuth: number, elevation?: number)").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  const double azimuth = info[0].As<Napi::Number>().DoubleValue();
+  const double elevation = info.Length() >= 2 ? info[1].As<Napi::Number>().DoubleValue() : azimuth;
+  if (!(azimuth >= 0) || !(elevation >= 0)) {
+    Napi::RangeError::New(env, "Deadband must be a non-negative number of degrees").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  deadband_azimuth_ = azimuth;
+  deadband_elevation_ = elevation;
+  return env.Undefined();
+}
+
+Napi::Value NodeRotator::GetStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  Napi::Object obj = rigMetricsToObject(env, *metrics_);
+  Napi::Object position = Napi::Object::New(env);
+  position.Set("deadbandAzimuth", Napi::Number::New(env, deadband_azimuth_));
+  position.Set("deadbandElevation", Napi::Number::New(env, deadband_elevation_));
+  position.Set("coalesced", Napi::Number::New(env, static_cast<double>(coalesced_positions_)));
+  position.Set("suppressed", Napi::Number::New(env, static_cast<double>(suppressed_positions_)));
+  obj.Set("position", position);
+  return obj;
+}
+
+Napi::Value NodeRotator::ResetStats(const Napi::CallbackInfo& info) {
+  metrics_->Reset();
+  coalesced_positions_ = 0;
+  suppressed_positions_ = 0;
+  return info.Env().Undefined();
+}
+
 Napi::Value NodeRotator::GetPosition(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   if (!rot_is_open) {
@@ -848,7 +1223,7 @@ Napi::Value NodeRotator::Stop(const Napi::CallbackInfo& info) {
     Napi::TypeError::New(env, "Rotator is not open!").ThrowAsJavaScriptException();
     return env.Null();
   }
-  auto* worker = new RotatorSimpleAsyncWorker(env, this, shim_rot_stop);
+  auto* worker = new RotatorSimpleAsyncWorker(env, this, shim_rot_stop, "RotatorStop");
   worker->Queue();
   return worker->GetPromise();
 }
@@ -859,7 +1234,7 @@ Napi::Value NodeRotator::Park(const Napi::CallbackInfo& info) {
     Napi::TypeError::New(env, "Rotator is not open!").ThrowAsJavaScriptException();
     return env.Null();
   }
-  auto* worker = new RotatorSimpleAsyncWorker(env, this, shim_rot_park);
+  auto* worker = new RotatorSimpleAsyncWorker(env, this, shim_rot_park, "RotatorPark");
   worker->Queue();
   return worker->GetPromise();
 }
@@ -1296,6 +1671,9 @@ Napi::Function NodeRotator::GetClass(Napi::Env env) {
           InstanceMethod("setParm", &NodeRotator::SetParm),
           InstanceMethod("getParm", &NodeRotator::GetParm),
           InstanceMethod("getSupportedParms", &NodeRotator::GetSupportedParms),
+          InstanceMethod("setPositionDeadband", &NodeRotator::SetPositionDeadband),
+          InstanceMethod("getStats", &NodeRotator::GetStats),
+          InstanceMethod("resetStats", &NodeRotator::ResetStats),
           StaticMethod("getSupportedRotators", &NodeRotator::GetSupportedRotators),
           StaticMethod("getHamlibVersion", &NodeRotator::GetHamlibVersion),
           StaticMethod("setDebugLevel", &NodeRotator::SetDebugLevel),
@@ -1303,7 +1681,5 @@ Napi::Function NodeRotator::GetClass(Napi::Env env) {
           StaticMethod("getCopyright", &NodeRotator::GetCopyright),
           StaticMethod("getLicense", &NodeRotator::GetLicense),
       });
-  constructor = Napi::Persistent(klass);
-  constructor.SuppressDestruct();
   return klass;
 }
@@ -2,8 +2,19 @@
 
 #include <napi.h>
 #include "shim/hamlib_shim.h"
+#include "rig_executor.h"
+#include "rig_metrics.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 
+class RotatorAsyncWorker;
+class RotatorSetPositionAsyncWorker;
+
+class HamLibAddonData;
+
 class NodeRotator : public Napi::ObjectWrap<NodeRotator> {
  public:
   NodeRotator(const Napi::CallbackInfo&);
@@ -39,6 +50,11 @@ class NodeRotator : public Napi::ObjectWrap<NodeRotator> {
   Napi::Value GetParm(const Napi::CallbackInfo&);
   Napi::Value GetSupportedParms(const Napi::CallbackInfo&);
 
+  // setPosition deadband and per-operation metrics
+  Napi::Value SetPositionDeadband(const Napi::CallbackInfo&);
+  Napi::Value GetStats(const Napi::CallbackInfo&);
+  Napi::Value ResetStats(const Napi::CallbackInfo&);
+
   static Napi::Value GetSupportedRotators(const Napi::CallbackInfo&);
   static Napi::Value GetHamlibVersion(const Napi::CallbackInfo&);
   static Napi::Value SetDebugLevel(const Napi::CallbackInfo&);
@@ -49,11 +65,34 @@ class NodeRotator : public Napi::ObjectWrap<NodeRotator> {
   static Napi::Function GetClass(Napi::Env);
 
   hamlib_shim_handle_t my_rot;
-  bool rot_is_open = false;
+  // Written by open/close workers on the command thread.
+  std::atomic<bool> rot_is_open{false};
+  // Held around every shim_rot_* call made off the JS thread, by command
+  // thread workers and a rig's tracking loop.
+  std::timed_mutex io_mutex_;
   bool is_network_rot = false;
   unsigned int original_model = 0;
   char port_path[SHIM_HAMLIB_FILPATHLEN];
-  static Napi::FunctionReference constructor;
+  // See NodeHamLib::addon_data_ / ShutdownNative().
+  HamLibAddonData* addon_data_ = nullptr;
+  void ShutdownNative();
+
+  // Every command of this rotator runs here, one at a time, in order.
+  std::shared_ptr<RigCommandExecutor> executor_;
+  std::shared_ptr<RigMetricsRegistry> metrics_ = std::make_shared<RigMetricsRegistry>();
+
+  // setPosition coalescing and deadband; JS thread only. pending_position_ is
+  // the queued setPosition later ones may retarget until another command is
+  // queued behind it; the target is the last position sent or queued.
+  void NoteCommandQueued(RotatorAsyncWorker* worker, bool clears_position_target);
+  RotatorSetPositionAsyncWorker* pending_position_ = nullptr;
+  bool has_position_target_ = false;
+  double position_target_azimuth_ = 0;
+  double position_target_elevation_ = 0;
+  double deadband_azimuth_ = 0;
+  double deadband_elevation_ = 0;
+  uint64_t coalesced_positions_ = 0;
+  uint64_t suppressed_positions_ = 0;
 
  private:
   bool isNetworkAddress(const char* path);
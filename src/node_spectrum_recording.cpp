@@ -0,0 +1,176 @@
+#include "node_spectrum_recording.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr double kDefaultReadMaxBytes = 16 * 1024 * 1024;
+constexpr double kMaxReadMaxBytes = 1024.0 * 1024 * 1024;
+
+class SpectrumRecordingReadWorker : public Napi::AsyncWorker {
+ public:
+  SpectrumRecordingReadWorker(Napi::Env env, std::shared_ptr<SpectrumRecordingReader> reader,
+                              double from_ms, double to_ms, uint64_t max_bytes, uint64_t start_offset)
+      : Napi::AsyncWorker(env),
+        reader_(std::move(reader)),
+        from_ms_(from_ms),
+        to_ms_(to_ms),
+        max_bytes_(max_bytes),
+        start_offset_(start_offset),
+        deferred_(Napi::Promise::Deferred::New(env)) {}
+
+  Napi::Promise GetPromise() { return deferred_.Promise(); }
+
+  void Execute() override {
+    reader_->Read(from_ms_, to_ms_, max_bytes_, start_offset_, &slice_, &error_message_);
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    if (!error_message_.empty()) {
+      deferred_.Reject(Napi::Error::New(env, error_message_).Value());
+      return;
+    }
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("data", TakeBuffer(env));
+    result.Set("lines", Napi::Number::New(env, static_cast<double>(slice_.lines)));
+    result.Set("startTime", Napi::Number::New(env, slice_.first_timestamp));
+    result.Set("endTime", Napi::Number::New(env, slice_.last_timestamp));
+    result.Set("startOffset", Napi::Number::New(env, static_cast<double>(slice_.begin_offset)));
+    result.Set("endOffset", Napi::Number::New(env, static_cast<double>(slice_.end_offset)));
+    result.Set("complete", Napi::Boolean::New(env, slice_.complete));
+    deferred_.Resolve(result);
+  }
+
+  void OnError(const Napi::Error& e) override {
+    deferred_.Reject(Napi::Error::New(Env(), error_message_.empty() ? e.Message() : error_message_).Value());
+  }
+
+ private:
+  // Hands the copied records to JS without a second copy where allowed.
+  Napi::Value TakeBuffer(Napi::Env env) {
+#ifndef NODE_API_NO_EXTERNAL_BUFFERS_ALLOWED
+    if (!slice_.data.empty()) {
+      auto* owned = new std::vector<uint8_t>(std::move(slice_.data));
+      Napi::Buffer<uint8_t> buffer = Napi::Buffer<uint8_t>::New(
+        env, owned->data(), owned->size(),
+        [](Napi::Env, uint8_t*, std::vector<uint8_t>* data) { delete data; },
+        owned);
+      if (!env.IsExceptionPending()) {
+        return buffer;
+      }
+      env.GetAndClearPendingException();
+      slice_.data = std::move(*owned);
+      delete owned;
+    }
+#endif
+    return Napi::Buffer<uint8_t>::Copy(env, slice_.data.data(), slice_.data.size());
+  }
+
+  std::shared_ptr<SpectrumRecordingReader> reader_;
+  double from_ms_;
+  double to_ms_;
+  uint64_t max_bytes_;
+  uint64_t start_offset_;
+  SpectrumRecordingSlice slice_;
+  std::string error_message_;
+  Napi::Promise::Deferred deferred_;
+};
+
+}  // namespace
+
+
+NodeSpectrumRecording::NodeSpectrumRecording(const Napi::CallbackInfo& info)
+    : ObjectWrap(info), reader_(std::make_shared<SpectrumRecordingReader>()) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Expected recording path as string").ThrowAsJavaScriptException();
+    return;
+  }
+  std::string error;
+  if (!reader_->Open(info[0].As<Napi::String>().Utf8Value(), &error)) {
+    Napi::Error::New(env, "Unable to open spectrum recording: " + error).ThrowAsJavaScriptException();
+  }
+}
+
+Napi::Value NodeSpectrumRecording::Info(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  SpectrumRecordingInfo details;
+  std::string error;
+  if (!reader_->GetInfo(&details, &error)) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("version", Napi::Number::New(env, details.version));
+  obj.Set("lines", Napi::Number::New(env, static_cast<double>(details.lines)));
+  obj.Set("dataBytes", Napi::Number::New(env, static_cast<double>(details.data_bytes)));
+  obj.Set("indexEntries", Napi::Number::New(env, static_cast<double>(details.index_entries)));
+  obj.Set("startTime", Napi::Number::New(env, details.first_timestamp));
+  obj.Set("endTime", Napi::Number::New(env, details.last_timestamp));
+  obj.Set("recordHeaderBytes", Napi::Number::New(env, static_cast<double>(kSpectrumRecordHeaderBytes)));
+  return obj;
+}
+
+Napi::Value NodeSpectrumRecording::Read(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "Expected (fromMs: number, toMs: number, options?: { maxBytes?: number, offset?: number })")
+      .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  const double from_ms = info[0].As<Napi::Number>().DoubleValue();
+  const double to_ms = info[1].As<Napi::Number>().DoubleValue();
+  double max_bytes = kDefaultReadMaxBytes;
+  double offset = 0;
+  if (info.Length() >= 3 && info[2].IsObject()) {
+    Napi::Object options = info[2].As<Napi::Object>();
+    if (options.Has("maxBytes") && !options.Get("maxBytes").IsUndefined()) {
+      if (!options.Get("maxBytes").IsNumber()) {
+        Napi::TypeError::New(env, "maxBytes must be a number").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      max_bytes = options.Get("maxBytes").As<Napi::Number>().DoubleValue();
+      if (!(max_bytes >= 1 && max_bytes <= kMaxReadMaxBytes)) {
+        Napi::RangeError::New(env, "maxBytes must be between 1 and 1073741824").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+    }
+    if (options.Has("offset") && !options.Get("offset").IsUndefined()) {
+      if (!options.Get("offset").IsNumber()) {
+        Napi::TypeError::New(env, "offset must be a number").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+      offset = options.Get("offset").As<Napi::Number>().DoubleValue();
+      if (!(offset >= 0)) {
+        Napi::RangeError::New(env, "offset must not be negative").ThrowAsJavaScriptException();
+        return env.Null();
+      }
+    }
+  }
+
+  auto* worker = new SpectrumRecordingReadWorker(env, reader_, from_ms, to_ms,
+    static_cast<uint64_t>(max_bytes), static_cast<uint64_t>(offset));
+  worker->Queue();
+  return worker->GetPromise();
+}
+
+Napi::Value NodeSpectrumRecording::Close(const Napi::CallbackInfo& info) {
+  reader_->Close();
+  return info.Env().Undefined();
+}
+
+Napi::Function NodeSpectrumRecording::GetClass(Napi::Env env) {
+  auto klass = DefineClass(
+      env,
+      "SpectrumRecording",
+      {
+          InstanceMethod("info", &NodeSpectrumRecording::Info),
+          InstanceMethod("read", &NodeSpectrumRecording::Read),
+          InstanceMethod("close", &NodeSpectrumRecording::Close),
+      });
+  return klass;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <napi.h>
+#include "spectrum_recorder.h"
+#include <memory>
+
+// JS handle on a spectrum recording file (see SpectrumRecordingReader).
+class NodeSpectrumRecording : public Napi::ObjectWrap<NodeSpectrumRecording> {
+ public:
+  NodeSpectrumRecording(const Napi::CallbackInfo&);
+
+  Napi::Value Info(const Napi::CallbackInfo&);
+  Napi::Value Read(const Napi::CallbackInfo&);
+  Napi::Value Close(const Napi::CallbackInfo&);
+
+  static Napi::Function GetClass(Napi::Env);
+
+ private:
+  // Shared with in-flight read workers so close() cannot pull the mapping
+  // out from under them.
+  std::shared_ptr<SpectrumRecordingReader> reader_;
+};
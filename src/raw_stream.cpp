@@ -0,0 +1,276 @@
+#include "raw_stream.h"
+
+#include "hamlib.h"
+#include "shim/hamlib_shim.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+std::atomic<bool> rawExternalBuffersAllowed{true};
+
+struct RawSlotHint {
+  std::shared_ptr<RawFramePool> pool;
+  RawFrameSlot* slot;
+};
+
+// Lends the slot to JS without copying; it returns to the pool when the
+// Buffer is collected. Falls back to a copy where the runtime forbids
+// external buffers.
+Napi::Value rawFrameData(Napi::Env env, const std::shared_ptr<RawFramePool>& pool, RawFrameSlot* slot) {
+#ifndef NODE_API_NO_EXTERNAL_BUFFERS_ALLOWED
+  if (rawExternalBuffersAllowed.load(std::memory_order_relaxed)) {
+    auto* hint = new RawSlotHint{pool, slot};
+    Napi::Buffer<unsigned char> buffer = Napi::Buffer<unsigned char>::New(
+      env, slot->data.get(), slot->length,
+      [](Napi::Env, unsigned char*, RawSlotHint* data) {
+        data->pool->Release(data->slot);
+        delete data;
+      },
+      hint);
+    if (!env.IsExceptionPending()) {
+      return buffer;
+    }
+    env.GetAndClearPendingException();
+    delete hint;
+    rawExternalBuffersAllowed.store(false, std::memory_order_relaxed);
+  }
+#endif
+  Napi::Buffer<unsigned char> copy = Napi::Buffer<unsigned char>::Copy(env, slot->data.get(), slot->length);
+  pool->Release(slot);
+  return copy;
+}
+
+}  // namespace
+
+RawFramePool::RawFramePool(size_t capacity, size_t frame_bytes)
+  : capacity_(capacity), frame_bytes_(frame_bytes), pool_(new RawFrameSlot[capacity]) {
+  free_.reserve(capacity);
+  for (size_t i = capacity; i > 0; --i) {
+    RawFrameSlot& slot = pool_[i - 1];
+    slot.data.reset(new unsigned char[frame_bytes]);
+    slot.pooled = true;
+    free_.push_back(&slot);
+  }
+}
+
+RawFrameSlot* RawFramePool::Acquire() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  ++in_use_;
+  if (!free_.empty()) {
+    RawFrameSlot* slot = free_.back();
+    free_.pop_back();
+    return slot;
+  }
+  // Every pooled slot is queued or still referenced from JS.
+  ++pool_misses_;
+  auto* slot = new RawFrameSlot();
+  slot->data.reset(new unsigned char[frame_bytes_]);
+  return slot;
+}
+
+void RawFramePool::Release(RawFrameSlot* slot) {
+  if (!slot) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (in_use_ > 0) {
+    --in_use_;
+  }
+  if (slot->pooled) {
+    free_.push_back(slot);
+  } else {
+    delete slot;
+  }
+}
+
+RawFramePoolStats RawFramePool::GetStats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  RawFramePoolStats stats;
+  stats.capacity = capacity_;
+  stats.frame_bytes = frame_bytes_;
+  stats.in_use = in_use_;
+  stats.pool_misses = pool_misses_;
+  return stats;
+}
+
+RigRawStream::RigRawStream(NodeHamLib* rig, RawStreamOptions options)
+  : RigBackgroundJob(rig), options_(std::move(options)),
+    pool_(std::make_shared<RawFramePool>(options_.pool_frames, options_.frame_bytes)) {}
+
+RigRawStream::~RigRawStream() {
+  Stop();
+}
+
+void RigRawStream::Start(Napi::Env env, Napi::Function callback) {
+  StartThread(env, callback, "HamLibRawStream");
+}
+
+void RigRawStream::Stop() {
+  StopThread();
+  std::deque<RawFrameSlot*> dropped;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    dropped.swap(pending_);
+  }
+  for (RawFrameSlot* slot : dropped) {
+    pool_->Release(slot);
+  }
+}
+
+RawStreamStats RigRawStream::GetStats() const {
+  RawStreamStats stats;
+  stats.running = Running();
+  stats.frames = frames_.load(std::memory_order_relaxed);
+  stats.bytes = bytes_.load(std::memory_order_relaxed);
+  stats.stalls = stalls_.load(std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stats.pending = pending_.size();
+  }
+  stats.pool = pool_->GetStats();
+  return stats;
+}
+
+void RigRawStream::ThreadMain() {
+  RigLockScopeUse scopeUse;
+  End end;
+  end.reason = "stopped";
+  // The command goes out with the first read only; later reads send nothing
+  // and just collect the next frame.
+  static const unsigned char kNoCommand = 0;
+  const unsigned char* command = options_.command.empty() ? &kNoCommand : options_.command.data();
+  int commandLen = static_cast<int>(options_.command.size());
+  const int frameBytes = static_cast<int>(pool_->FrameBytes());
+  while (true) {
+    GlobalRigLock rigLock;
+    if (!AcquireRigLock(&rigLock, RigCommandPriority::Background)) {
+      break;
+    }
+    if (!rig_->my_rig || !rig_->rig_is_open.load(std::memory_order_acquire)) {
+      end.reason = "closed";
+      break;
+    }
+    // Raw commands can change anything behind the cache's back.
+    rig_->state_cache_.Invalidate();
+    RawFrameSlot* slot = pool_->Acquire();
+    const int code = shim_rig_send_raw(rig_->my_rig, command, commandLen, slot->data.get(), frameBytes,
+                                       options_.terminator.data());
+    // Other commands, a Realtime PTT release first, run between frames.
+    if (rigLock.owns_lock()) {
+      rigLock.unlock();
+    }
+    command = &kNoCommand;
+    commandLen = 0;
+    if (code <= 0) {
+      pool_->Release(slot);
+      if (code == 0 || code == SHIM_RIG_ETIMEOUT) {
+        end.reason = "idle";
+      } else {
+        end.reason = "error";
+        end.result_code = code;
+      }
+      break;
+    }
+    slot->length = static_cast<size_t>(std::min(code, frameBytes));
+    slot->sequence = frames_.fetch_add(1, std::memory_order_relaxed);
+    slot->timestamp = rigEpochMillis();
+    bytes_.fetch_add(slot->length, std::memory_order_relaxed);
+    if (!Push(slot)) {
+      break;
+    }
+    if (options_.max_frames > 0 && slot->sequence + 1 >= options_.max_frames) {
+      end.reason = "complete";
+      break;
+    }
+  }
+
+  if (end.reason != "stopped") {
+    end.timestamp = rigEpochMillis();
+    ScheduleFlush(new End(end));
+  }
+  Finish();
+}
+
+bool RigRawStream::Push(RawFrameSlot* slot) {
+  bool schedule = false;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (pending_.size() >= options_.pool_frames && !stopping_) {
+      stalls_.fetch_add(1, std::memory_order_relaxed);
+      cv_.wait(lock, [this]() { return stopping_ || pending_.size() < options_.pool_frames; });
+    }
+    if (stopping_) {
+      lock.unlock();
+      pool_->Release(slot);
+      return false;
+    }
+    pending_.push_back(slot);
+    if (!flush_pending_) {
+      flush_pending_ = true;
+      schedule = true;
+    }
+  }
+  if (schedule) {
+    ScheduleFlush(nullptr);
+  }
+  return true;
+}
+
+void RigRawStream::ScheduleFlush(End* end) {
+  const bool flush = !end;
+  const bool posted = Post(end, [this](Napi::Env env, Napi::Function callback, End* data) {
+    Deliver(env, callback, data);
+  });
+  if (!posted && flush) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    flush_pending_ = false;
+  }
+}
+
+void RigRawStream::Deliver(Napi::Env env, Napi::Function callback, End* end) {
+  std::deque<RawFrameSlot*> frames;
+  bool stopped = false;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    frames.swap(pending_);
+    if (!end) {
+      flush_pending_ = false;
+    }
+    stopped = stopping_;
+  }
+  cv_.notify_all();
+
+  for (RawFrameSlot* slot : frames) {
+    if (stopped || env.IsExceptionPending()) {
+      pool_->Release(slot);
+      continue;
+    }
+    Napi::HandleScope scope(env);
+    Napi::Object frame = Napi::Object::New(env);
+    frame.Set("type", Napi::String::New(env, "frame"));
+    frame.Set("sequence", Napi::Number::New(env, static_cast<double>(slot->sequence)));
+    frame.Set("timestamp", Napi::Number::New(env, slot->timestamp));
+    // Must be last: the slot may be recycled as soon as it is handed over.
+    frame.Set("data", rawFrameData(env, pool_, slot));
+    callback.Call({ frame });
+  }
+
+  if (!end || stopped || env.IsExceptionPending()) {
+    return;
+  }
+  Napi::HandleScope scope(env);
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("type", Napi::String::New(env, "end"));
+  obj.Set("reason", Napi::String::New(env, end->reason));
+  obj.Set("frames", Napi::Number::New(env, static_cast<double>(frames_.load(std::memory_order_relaxed))));
+  obj.Set("bytes", Napi::Number::New(env, static_cast<double>(bytes_.load(std::memory_order_relaxed))));
+  obj.Set("timestamp", Napi::Number::New(env, end->timestamp));
+  if (end->reason == "error") {
+    obj.Set("code", Napi::String::New(env, "HAMLIB_ERROR"));
+    obj.Set("hamlibCode", Napi::Number::New(env, end->result_code));
+    obj.Set("message", Napi::String::New(env, shim_rigerror(end->result_code)));
+  }
+  callback.Call({ obj });
+}
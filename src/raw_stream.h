@@ -0,0 +1,128 @@
+#pragma once
+
+#include "rig_background_job.h"
+#include <napi.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class NodeHamLib;
+
+struct RawFrameSlot {
+  std::unique_ptr<unsigned char[]> data;
+  size_t length = 0;
+  uint64_t sequence = 0;
+  double timestamp = 0;
+  bool pooled = false;
+};
+
+struct RawFramePoolStats {
+  size_t capacity = 0;
+  size_t frame_bytes = 0;
+  size_t in_use = 0;
+  uint64_t pool_misses = 0;
+};
+
+// Fixed-size frame buffers that raw reads are written into directly. Slots
+// are lent to JS as external Buffers and come back through Release() when
+// those Buffers are collected; while JS holds every pooled slot, frames
+// spill into heap slots instead of waiting. Thread-safe.
+class RawFramePool {
+public:
+    RawFramePool(size_t capacity, size_t frame_bytes);
+
+    RawFramePool(const RawFramePool&) = delete;
+    RawFramePool& operator=(const RawFramePool&) = delete;
+
+    RawFrameSlot* Acquire();
+    void Release(RawFrameSlot* slot);
+    size_t FrameBytes() const { return frame_bytes_; }
+    RawFramePoolStats GetStats() const;
+
+private:
+    const size_t capacity_;
+    const size_t frame_bytes_;
+    std::unique_ptr<RawFrameSlot[]> pool_;
+
+    mutable std::mutex mutex_;
+    std::vector<RawFrameSlot*> free_;
+    size_t in_use_ = 0;
+    uint64_t pool_misses_ = 0;
+};
+
+struct RawStreamOptions {
+  // Written once before the first read; may be empty to only listen.
+  std::vector<unsigned char> command;
+  std::vector<unsigned char> terminator;
+  size_t frame_bytes = 1024;
+  size_t pool_frames = 32;
+  // End after this many frames; 0 reads until the rig falls silent.
+  uint64_t max_frames = 0;
+};
+
+struct RawStreamStats {
+  bool running = false;
+  uint64_t frames = 0;
+  uint64_t bytes = 0;
+  // Frames read but not yet handed to JS.
+  size_t pending = 0;
+  // Reads that waited for JS to drain the backlog.
+  uint64_t stalls = 0;
+  RawFramePoolStats pool;
+};
+
+// Reads terminator-delimited frames with shim_rig_send_raw() on its own
+// thread, straight into pooled buffers, and hands them to JS in arrival
+// order, one ThreadSafeFunction call per drained backlog. The rig lock is
+// taken in the Background class for each read and released before the frame
+// is queued, so other commands run between frames; on a rig that keeps
+// sending, their replies can pick up streamed bytes. The reader stops
+// reading while pool_frames frames wait for JS rather than dropping any.
+//
+// The stream ends on its own once max_frames arrived ("complete"), when a
+// read times out or returns nothing ("idle": the rig has stopped sending),
+// on any other read error ("error") or when the rig is closed ("closed").
+class RigRawStream : public RigBackgroundJob {
+public:
+    RigRawStream(NodeHamLib* rig, RawStreamOptions options);
+    ~RigRawStream() override;
+
+    // JS thread.
+    void Start(Napi::Env env, Napi::Function callback);
+    // JS thread. Joins the reader; a read already in progress finishes first
+    // (at most the rig's timeout). Undelivered frames and the end event are
+    // dropped.
+    void Stop();
+    RawStreamStats GetStats() const;
+
+private:
+    struct End {
+        std::string reason;
+        int result_code = 0;
+        double timestamp = 0;
+    };
+
+    void ThreadMain() override;
+    // Queues a filled slot, waiting while the backlog is full; false once
+    // stopping.
+    bool Push(RawFrameSlot* slot);
+    void ScheduleFlush(End* end);
+    // JS thread.
+    void Deliver(Napi::Env env, Napi::Function callback, End* end);
+
+    const RawStreamOptions options_;
+    std::shared_ptr<RawFramePool> pool_;
+
+    // Guarded by mutex_.
+    bool flush_pending_ = false;
+    std::deque<RawFrameSlot*> pending_;
+
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> stalls_{0};
+};
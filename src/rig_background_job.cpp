@@ -0,0 +1,53 @@
+#include "rig_background_job.h"
+
+#include "hamlib.h"
+
+#include <chrono>
+
+namespace {
+
+constexpr std::chrono::milliseconds kJobLockSlice(100);
+
+}  // namespace
+
+double rigEpochMillis() {
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+void RigBackgroundJob::StartThread(Napi::Env env, Napi::Function callback, const char* name) {
+  tsfn_ = Napi::ThreadSafeFunction::New(env, callback, name, 0, 1);
+  running_.store(true, std::memory_order_release);
+  thread_ = std::thread([this]() { ThreadMain(); });
+}
+
+void RigBackgroundJob::StopThread() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool RigBackgroundJob::Stopping() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return stopping_;
+}
+
+bool RigBackgroundJob::AcquireRigLock(GlobalRigLock* lock, RigCommandPriority priority) {
+  while (!Stopping()) {
+    *lock = rig_->TryAcquireRigLockIfEnabled(kJobLockSlice, nullptr, priority);
+    if (lock->owns_lock() || !NodeHamLib::IsGlobalRigLockEnabled()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void RigBackgroundJob::Finish() {
+  running_.store(false, std::memory_order_release);
+  tsfn_.Release();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "rig_priority.h"
+#include <napi.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class NodeHamLib;
+
+// Epoch milliseconds, as used for event timestamps.
+double rigEpochMillis();
+
+// Skeleton shared by the native jobs that drive a rig from their own thread
+// (tracking, raw streams, sweeps): the thread, the ThreadSafeFunction that
+// carries their events to JS, the stop flag and a stoppable wait for the rig
+// lock. A derived class implements ThreadMain(), which ends with Finish(),
+// and calls StopThread() from its own Stop() and destructor.
+class RigBackgroundJob : public std::enable_shared_from_this<RigBackgroundJob> {
+public:
+    virtual ~RigBackgroundJob() = default;
+
+    RigBackgroundJob(const RigBackgroundJob&) = delete;
+    RigBackgroundJob& operator=(const RigBackgroundJob&) = delete;
+
+    bool Running() const { return running_.load(std::memory_order_acquire); }
+
+protected:
+    explicit RigBackgroundJob(NodeHamLib* rig) : rig_(rig) {}
+
+    // JS thread. A running job keeps the process alive until it ends or is
+    // stopped.
+    void StartThread(Napi::Env env, Napi::Function callback, const char* name);
+    // JS thread. Sets the stop flag, wakes the job and joins its thread.
+    void StopThread();
+    bool Stopping() const;
+    // Waits for the rig lock in slices, so a stop is not held up behind a long
+    // command of another caller; false once stopping.
+    bool AcquireRigLock(std::unique_lock<std::timed_mutex>* lock,
+                        RigCommandPriority priority = RigCommandPriority::Interactive);
+    // Job thread, last call of ThreadMain().
+    void Finish();
+
+    // Hands `data` to `deliver(env, callback, data)` on the JS thread and
+    // deletes it afterwards, or at once when the call cannot be queued.
+    template <typename Data, typename Deliver>
+    bool Post(Data* data, Deliver deliver) {
+        std::shared_ptr<RigBackgroundJob> self = shared_from_this();
+        napi_status status = tsfn_.NonBlockingCall(
+            data,
+            [self, deliver](Napi::Env env, Napi::Function callback, Data* posted) {
+                deliver(env, callback, posted);
+                delete posted;
+            });
+        if (status != napi_ok) {
+            delete data;
+            return false;
+        }
+        return true;
+    }
+
+    virtual void ThreadMain() = 0;
+
+    NodeHamLib* rig_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+
+private:
+    std::thread thread_;
+    Napi::ThreadSafeFunction tsfn_;
+    std::atomic<bool> running_{false};
+};
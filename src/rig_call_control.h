@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Cancellation and deadline of one JS call, shared by every worker the call
+// queued. Cancel() comes from the JS thread (an AbortSignal firing); workers
+// read it on whichever thread runs them. Work that is stopped before it
+// reaches the rig is dropped; work already talking to the rig only notices
+// at its own step boundaries.
+class RigCallControl {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Stop {
+        None,
+        Aborted,
+        DeadlineExceeded,
+    };
+
+    RigCallControl(uint32_t id, bool has_deadline, Clock::time_point deadline)
+        : id_(id), has_deadline_(has_deadline), deadline_(deadline) {}
+
+    RigCallControl(const RigCallControl&) = delete;
+    RigCallControl& operator=(const RigCallControl&) = delete;
+
+    uint32_t Id() const { return id_; }
+    void Cancel() { cancelled_.store(true, std::memory_order_release); }
+    bool Cancelled() const { return cancelled_.load(std::memory_order_acquire); }
+    bool HasDeadline() const { return has_deadline_; }
+    Clock::time_point Deadline() const { return deadline_; }
+
+    // Cancellation wins over an expired deadline.
+    Stop Check(Clock::time_point now) const {
+        if (Cancelled()) {
+            return Stop::Aborted;
+        }
+        if (has_deadline_ && now >= deadline_) {
+            return Stop::DeadlineExceeded;
+        }
+        return Stop::None;
+    }
+
+private:
+    const uint32_t id_;
+    const bool has_deadline_;
+    const Clock::time_point deadline_;
+    std::atomic<bool> cancelled_{false};
+};
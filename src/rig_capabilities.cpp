@@ -0,0 +1,129 @@
+#include "rig_capabilities.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+template <typename T, size_t N, typename Read>
+void readCapsList(std::vector<T>* out, Read read) {
+  T buf[N];
+  int count = read(buf, static_cast<int>(N));
+  out->assign(buf, buf + std::max(0, std::min(count, static_cast<int>(N))));
+}
+
+// Same match as Hamlib's rig_get_range().
+const shim_freq_range_t* findTxRange(const std::vector<shim_freq_range_t>& ranges, double freq, uint64_t mode) {
+  for (const shim_freq_range_t& range : ranges) {
+    if (freq >= range.start_freq && freq <= range.end_freq && (range.modes & mode)) {
+      return &range;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+std::shared_ptr<const RigCapabilitySnapshot> RigCapabilitySnapshot::Capture(hamlib_shim_handle_t rig) {
+  auto caps = std::make_shared<RigCapabilitySnapshot>();
+  caps->captured_at_ms = static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count());
+
+  caps->levels = shim_rig_get_caps_has_get_level(rig) | shim_rig_get_caps_has_set_level(rig);
+  caps->functions = shim_rig_get_caps_has_get_func(rig) | shim_rig_get_caps_has_set_func(rig);
+  caps->parms = shim_rig_get_caps_has_get_parm(rig) | shim_rig_get_caps_has_set_parm(rig);
+  caps->modes = shim_rig_get_mode_list(rig);
+  caps->vfo_ops = shim_rig_get_caps_vfo_ops(rig);
+  caps->scan_types = shim_rig_get_caps_has_scan(rig);
+
+  readCapsList<int, SHIM_HAMLIB_MAX_MODES>(&caps->preamp,
+    [rig](int* buf, int max) { return shim_rig_get_caps_preamp(rig, buf, max); });
+  readCapsList<int, SHIM_HAMLIB_MAX_MODES>(&caps->attenuator,
+    [rig](int* buf, int max) { return shim_rig_get_caps_attenuator(rig, buf, max); });
+  readCapsList<int, SHIM_HAMLIB_MAX_MODES>(&caps->agc_levels,
+    [rig](int* buf, int max) { return shim_rig_get_caps_agc_levels(rig, buf, max); });
+  caps->max_rit = static_cast<double>(shim_rig_get_caps_max_rit(rig));
+  caps->max_xit = static_cast<double>(shim_rig_get_caps_max_xit(rig));
+  caps->max_if_shift = static_cast<double>(shim_rig_get_caps_max_ifshift(rig));
+
+  std::vector<unsigned int> tones;
+  readCapsList<unsigned int, 256>(&tones,
+    [rig](unsigned int* buf, int max) { return shim_rig_get_caps_ctcss_list(rig, buf, max); });
+  for (unsigned int tone : tones) caps->ctcss_tones.push_back(tone / 10.0);
+  std::vector<unsigned int> codes;
+  readCapsList<unsigned int, 256>(&codes,
+    [rig](unsigned int* buf, int max) { return shim_rig_get_caps_dcs_list(rig, buf, max); });
+  for (unsigned int code : codes) caps->dcs_codes.push_back(static_cast<int>(code));
+
+  readCapsList<shim_freq_range_t, 30>(&caps->rx_ranges,
+    [rig](shim_freq_range_t* buf, int max) { return shim_rig_get_caps_rx_range(rig, buf, max); });
+  readCapsList<shim_freq_range_t, 30>(&caps->tx_ranges,
+    [rig](shim_freq_range_t* buf, int max) { return shim_rig_get_caps_tx_range(rig, buf, max); });
+  readCapsList<shim_mode_value_t, 20>(&caps->tuning_steps,
+    [rig](shim_mode_value_t* buf, int max) { return shim_rig_get_caps_tuning_steps(rig, buf, max); });
+  readCapsList<shim_mode_value_t, 60>(&caps->filters,
+    [rig](shim_mode_value_t* buf, int max) { return shim_rig_get_caps_filters(rig, buf, max); });
+
+  readCapsList<shim_freq_range_t, 30>(&caps->state_tx_ranges,
+    [rig](shim_freq_range_t* buf, int max) { return shim_rig_get_state_tx_range(rig, buf, max); });
+  int hasPower2mW = 1;
+  int hasMW2Power = 1;
+  if (shim_rig_get_power_conversion_hooks(rig, &hasPower2mW, &hasMW2Power) == SHIM_RIG_OK) {
+    caps->power2mw_hook = hasPower2mW != 0;
+    caps->mw2power_hook = hasMW2Power != 0;
+  }
+
+  caps->async_data_supported = shim_rig_is_async_data_supported(rig) != 0;
+  int scopeCount = shim_rig_get_caps_spectrum_scope_count(rig);
+  for (int i = 0; i < scopeCount; ++i) {
+    shim_spectrum_scope_t scope{};
+    if (shim_rig_get_caps_spectrum_scope(rig, i, &scope) == SHIM_RIG_OK) caps->spectrum_scopes.push_back(scope);
+  }
+  int modeCount = shim_rig_get_caps_spectrum_mode_count(rig);
+  for (int i = 0; i < modeCount; ++i) {
+    int modeId = 0;
+    if (shim_rig_get_caps_spectrum_mode(rig, i, &modeId) == SHIM_RIG_OK) {
+      const char* modeName = shim_rig_str_spectrum_mode(modeId);
+      caps->spectrum_modes.emplace_back(modeId, modeName ? modeName : "");
+    }
+  }
+  int spanCount = shim_rig_get_caps_spectrum_span_count(rig);
+  for (int i = 0; i < spanCount; ++i) {
+    double spanHz = 0;
+    if (shim_rig_get_caps_spectrum_span(rig, i, &spanHz) == SHIM_RIG_OK) caps->spectrum_spans.push_back(spanHz);
+  }
+  int avgModeCount = shim_rig_get_caps_spectrum_avg_mode_count(rig);
+  for (int i = 0; i < avgModeCount; ++i) {
+    shim_spectrum_avg_mode_t avgMode{};
+    if (shim_rig_get_caps_spectrum_avg_mode(rig, i, &avgMode) == SHIM_RIG_OK) caps->spectrum_avg_modes.push_back(avgMode);
+  }
+  return caps;
+}
+
+bool RigCapabilitySnapshot::Power2mW(float power, double freq, uint64_t mode, unsigned int* mwpower) const {
+  if (power2mw_hook || !mwpower) {
+    return false;
+  }
+  const shim_freq_range_t* range = findTxRange(state_tx_ranges, freq, mode);
+  if (!range) {
+    return false;
+  }
+  *mwpower = static_cast<unsigned int>(power * range->high_power);
+  return true;
+}
+
+bool RigCapabilitySnapshot::MW2Power(unsigned int mwpower, double freq, uint64_t mode, float* power) const {
+  if (mw2power_hook || !power || mwpower == 0) {
+    return false;
+  }
+  const shim_freq_range_t* range = findTxRange(state_tx_ranges, freq, mode);
+  if (!range) {
+    return false;
+  }
+  if (range->high_power <= 0) {
+    *power = 0.0f;
+    return true;
+  }
+  *power = std::min(1.0f, static_cast<float>(mwpower) / static_cast<float>(range->high_power));
+  return true;
+}
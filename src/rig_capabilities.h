@@ -0,0 +1,57 @@
+#pragma once
+
+#include "shim/hamlib_shim.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Everything the capability getters report, read from the rig caps (and the
+// mode list rig_open() fills in) in one pass. Immutable once captured; a
+// snapshot is shared between the instance and any promise still reading it.
+struct RigCapabilitySnapshot {
+  double captured_at_ms = 0;
+
+  uint64_t levels = 0;
+  uint64_t functions = 0;
+  uint64_t parms = 0;
+  uint64_t modes = 0;
+  int vfo_ops = 0;
+  int scan_types = 0;
+
+  std::vector<int> preamp;
+  std::vector<int> attenuator;
+  std::vector<int> agc_levels;
+  double max_rit = 0;
+  double max_xit = 0;
+  double max_if_shift = 0;
+  std::vector<double> ctcss_tones;
+  std::vector<int> dcs_codes;
+
+  std::vector<shim_freq_range_t> rx_ranges;
+  std::vector<shim_freq_range_t> tx_ranges;
+  std::vector<shim_mode_value_t> tuning_steps;
+  std::vector<shim_mode_value_t> filters;
+
+  // Region TX ranges from rig_state and whether the backend overrides
+  // Hamlib's range-based power conversion.
+  std::vector<shim_freq_range_t> state_tx_ranges;
+  bool power2mw_hook = true;
+  bool mw2power_hook = true;
+
+  bool async_data_supported = false;
+  std::vector<shim_spectrum_scope_t> spectrum_scopes;
+  std::vector<std::pair<int, std::string>> spectrum_modes;
+  std::vector<double> spectrum_spans;
+  std::vector<shim_spectrum_avg_mode_t> spectrum_avg_modes;
+
+  // Caller holds the rig lock.
+  static std::shared_ptr<const RigCapabilitySnapshot> Capture(hamlib_shim_handle_t rig);
+
+  // Hamlib's generic power conversion over state_tx_ranges, without touching
+  // the rig. False when the backend has its own conversion or no TX range
+  // covers (freq, mode).
+  bool Power2mW(float power, double freq, uint64_t mode, unsigned int* mwpower) const;
+  bool MW2Power(unsigned int mwpower, double freq, uint64_t mode, float* power) const;
+};
@@ -0,0 +1,131 @@
+#include "rig_catalog.h"
+
+#include "rig_model_index.h"
+#include "shim/hamlib_shim.h"
+
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+// Serializes backend enumerations only; readers go through the atomic slot
+// and never wait for one.
+std::mutex& catalogBuildMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+// Accessed with std::atomic_load / std::atomic_store only.
+std::shared_ptr<const RigCatalog>& catalogSlot() {
+  static std::shared_ptr<const RigCatalog> catalog;
+  return catalog;
+}
+
+struct RigCatalogBuilder {
+  std::vector<RigCatalogEntry>* entries;
+  std::vector<std::string>* strings;
+  std::unordered_map<std::string, uint32_t> index;
+
+  uint32_t Intern(const char* value) {
+    std::string text = value ? value : "";
+    auto found = index.find(text);
+    if (found != index.end()) {
+      return found->second;
+    }
+    const uint32_t id = static_cast<uint32_t>(strings->size());
+    strings->push_back(text);
+    index.emplace(std::move(text), id);
+    return id;
+  }
+};
+
+int catalogCallback(const shim_rig_info_t* info, void* data) {
+  RigCatalogBuilder* builder = static_cast<RigCatalogBuilder*>(data);
+  RigCatalogEntry entry;
+  entry.model = info->rig_model;
+  entry.model_name = builder->Intern(info->model_name);
+  entry.mfg_name = builder->Intern(info->mfg_name);
+  entry.version = builder->Intern(info->version);
+  entry.status = builder->Intern(shim_rig_strstatus(info->status));
+  entry.rig_type = builder->Intern(shim_rig_type_str(info->rig_type));
+  builder->entries->push_back(entry);
+  return 1;  // continue iteration
+}
+
+}  // namespace
+
+std::shared_ptr<const RigCatalog> RigCatalog::Cached() {
+  std::shared_ptr<const RigCatalog> published = std::atomic_load(&catalogSlot());
+  if (published) {
+    return published;
+  }
+  std::shared_ptr<const RigModelIndex> index = RigModelIndex::Installed();
+  if (!index) {
+    return nullptr;
+  }
+  // The index is sorted by model already.
+  auto catalog = std::make_shared<RigCatalog>();
+  RigCatalogBuilder builder{ &catalog->entries_, &catalog->strings_, {} };
+  catalog->entries_.reserve(index->ModelCount());
+  for (size_t i = 0; i < index->ModelCount(); ++i) {
+    const RigModelIndexModel& model = index->Model(i);
+    RigCatalogEntry entry;
+    entry.model = model.model;
+    entry.model_name = builder.Intern(index->String(model.model_name));
+    entry.mfg_name = builder.Intern(index->String(model.mfg_name));
+    entry.version = builder.Intern(index->String(model.version));
+    entry.status = builder.Intern(index->String(model.status));
+    entry.rig_type = builder.Intern(index->String(model.rig_type));
+    catalog->entries_.push_back(entry);
+  }
+  // A catalog published meanwhile wins; `published` is then updated to it.
+  std::shared_ptr<const RigCatalog> built = catalog;
+  if (std::atomic_compare_exchange_strong(&catalogSlot(), &published, built)) {
+    return built;
+  }
+  return published;
+}
+
+std::shared_ptr<const RigCatalog> RigCatalog::Get(std::mutex& metadata_mutex, int* result) {
+  std::shared_ptr<const RigCatalog> cached = Cached();
+  if (cached) {
+    *result = SHIM_RIG_OK;
+    return cached;
+  }
+
+  // Held across the enumeration so concurrent first callers wait for one
+  // load; Cached() does not take it.
+  std::lock_guard<std::mutex> guard(catalogBuildMutex());
+  cached = std::atomic_load(&catalogSlot());
+  if (cached) {
+    *result = SHIM_RIG_OK;
+    return cached;
+  }
+
+  auto catalog = std::make_shared<RigCatalog>();
+  RigCatalogBuilder builder{ &catalog->entries_, &catalog->strings_, {} };
+  {
+    std::lock_guard<std::mutex> metadataLock(metadata_mutex);
+    shim_rig_load_all_backends();
+    *result = shim_rig_list_foreach(catalogCallback, &builder);
+  }
+  if (*result != SHIM_RIG_OK) {
+    return nullptr;
+  }
+  std::sort(catalog->entries_.begin(), catalog->entries_.end(),
+    [](const RigCatalogEntry& a, const RigCatalogEntry& b) { return a.model < b.model; });
+  std::shared_ptr<const RigCatalog> built = catalog;
+  std::atomic_store(&catalogSlot(), built);
+  return built;
+}
+
+const RigCatalogEntry* RigCatalog::Find(unsigned int model) const {
+  auto found = std::lower_bound(entries_.begin(), entries_.end(), model,
+    [](const RigCatalogEntry& entry, unsigned int key) { return entry.model < key; });
+  if (found == entries_.end() || found->model != model) {
+    return nullptr;
+  }
+  return &*found;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// One supported rig model. Strings are indices into RigCatalog::Strings().
+struct RigCatalogEntry {
+  unsigned int model = 0;
+  uint32_t model_name = 0;
+  uint32_t mfg_name = 0;
+  uint32_t version = 0;
+  uint32_t status = 0;
+  uint32_t rig_type = 0;
+};
+
+// Every rig model Hamlib knows, enumerated once and kept for the process
+// lifetime. Entries are sorted by model; strings (including the status and
+// rig type names) are stored once each, so the catalog maps directly onto
+// the columnar JS form.
+class RigCatalog {
+public:
+    // Loads every backend and enumerates it on the first successful call,
+    // unless a RigModelIndex is installed, which then supplies the catalog
+    // without touching Hamlib; later calls return the same catalog.
+    // `metadata_mutex` guards Hamlib's global backend state. Thread-safe.
+    static std::shared_ptr<const RigCatalog> Get(std::mutex& metadata_mutex, int* result);
+    // The catalog if it is built or can come from the installed index, else
+    // null; never loads a backend or waits for a Get() in progress.
+    // Thread-safe.
+    static std::shared_ptr<const RigCatalog> Cached();
+
+    const std::vector<RigCatalogEntry>& Entries() const { return entries_; }
+    const std::vector<std::string>& Strings() const { return strings_; }
+    const std::string& String(uint32_t index) const { return strings_[index]; }
+    // Null for an unknown model.
+    const RigCatalogEntry* Find(unsigned int model) const;
+
+private:
+    std::vector<RigCatalogEntry> entries_;
+    std::vector<std::string> strings_;
+};
@@ -0,0 +1,233 @@
+#include "rig_executor.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr size_t kMaxCompletionBatch = 64;
+
+}  // namespace
+
+std::shared_ptr<RigCommandExecutor> RigCommandExecutor::Create(Napi::Env env, size_t queue_capacity) {
+  std::shared_ptr<RigCommandExecutor> executor(new RigCommandExecutor(queue_capacity));
+  executor->Start(env);
+  return executor;
+}
+
+RigCommandExecutor::RigCommandExecutor(size_t queue_capacity) {
+  for (auto& lane : lanes_) {
+    lane.reset(new BoundedMpscQueue<QueuedTask>(std::max<size_t>(queue_capacity, 2)));
+  }
+}
+
+RigCommandExecutor::~RigCommandExecutor() {
+  // The thread holds a reference of its own, so the last one is dropped
+  // either there, after ThreadMain() returned, or by whoever joined it.
+  if (thread_.joinable()) {
+    if (thread_.get_id() == std::this_thread::get_id()) {
+      thread_.detach();
+    } else {
+      thread_.join();
+    }
+  }
+}
+
+void RigCommandExecutor::Start(Napi::Env env) {
+  Napi::Function noop = Napi::Function::New(env, [](const Napi::CallbackInfo&) {});
+  tsfn_ = Napi::ThreadSafeFunction::New(env, noop, "HamLibCommandThread", 0, 1);
+  tsfn_env_ = env;
+  // Idle executors must not keep the process alive; Submit() re-refs while
+  // work is outstanding.
+  tsfn_.Unref(env);
+
+  std::shared_ptr<RigCommandExecutor> self = shared_from_this();
+  thread_ = std::thread([self]() { self->ThreadMain(); });
+}
+
+bool RigCommandExecutor::Submit(RigCommandTask* task, RigCommandPriority priority) {
+  if (!task || stopping_.load(std::memory_order_acquire)) {
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  QueuedTask item;
+  item.task = task;
+  item.enqueued_at = std::chrono::steady_clock::now();
+  if (!lanes_[static_cast<size_t>(priority)]->TryPush(item)) {
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  submitted_.fetch_add(1, std::memory_order_relaxed);
+  const size_t depth = QueueDepth();
+  size_t previous = max_queue_depth_.load(std::memory_order_relaxed);
+  while (depth > previous && !max_queue_depth_.compare_exchange_weak(previous, depth, std::memory_order_relaxed)) {
+  }
+
+  if (js_inflight_++ == 0) {
+    tsfn_.Ref(tsfn_env_);
+  }
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (consumer_waiting_.load(std::memory_order_seq_cst)) {
+    std::lock_guard<std::mutex> guard(wake_mutex_);
+    wake_cv_.notify_one();
+  }
+  return true;
+}
+
+void RigCommandExecutor::Stop() {
+  if (stopping_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(wake_mutex_);
+  wake_cv_.notify_one();
+}
+
+void RigCommandExecutor::Shutdown() {
+  shut_down_.store(true, std::memory_order_release);
+  Stop();
+  {
+    std::lock_guard<std::mutex> guard(wake_mutex_);
+    wake_cv_.notify_one();
+  }
+  if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
+    thread_.join();
+  }
+}
+
+RigCommandExecutorStats RigCommandExecutor::GetStats() const {
+  RigCommandExecutorStats stats;
+  stats.queue_capacity = lanes_[0]->Capacity();
+  stats.queue_depth = QueueDepth();
+  stats.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+  stats.submitted = submitted_.load(std::memory_order_relaxed);
+  stats.completed = completed_count_.load(std::memory_order_relaxed);
+  stats.rejected = rejected_.load(std::memory_order_relaxed);
+  stats.batches = batches_.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> guard(wait_stats_mutex_);
+  stats.total_wait_ms = total_wait_ms_;
+  stats.max_wait_ms = max_wait_ms_;
+  return stats;
+}
+
+void RigCommandExecutor::RecordWait(double wait_ms) {
+  std::lock_guard<std::mutex> guard(wait_stats_mutex_);
+  total_wait_ms_ += wait_ms;
+  max_wait_ms_ = std::max(max_wait_ms_, wait_ms);
+}
+
+size_t RigCommandExecutor::QueueDepth() const {
+  size_t depth = 0;
+  for (const auto& lane : lanes_) {
+    depth += lane->ApproximateSize();
+  }
+  return depth;
+}
+
+bool RigCommandExecutor::TryPopNext(QueuedTask* out) {
+  for (auto& lane : lanes_) {
+    if (lane->TryPop(out)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void RigCommandExecutor::ThreadMain() {
+  size_t pending_batch = 0;
+  for (;;) {
+    if (shut_down_.load(std::memory_order_acquire)) {
+      break;
+    }
+    QueuedTask item;
+    if (TryPopNext(&item)) {
+      const auto started = std::chrono::steady_clock::now();
+      RecordWait(std::chrono::duration<double, std::milli>(started - item.enqueued_at).count());
+      item.task->RunOnCommandThread();
+      {
+        std::lock_guard<std::mutex> guard(completed_mutex_);
+        completed_.push_back(item.task);
+      }
+      // Hand results back once the queue drains, or periodically under a
+      // sustained backlog so early callers are not held hostage.
+      if (++pending_batch >= kMaxCompletionBatch || QueueDepth() == 0) {
+        ScheduleFlush();
+        pending_batch = 0;
+      }
+      continue;
+    }
+
+    if (pending_batch > 0) {
+      ScheduleFlush();
+      pending_batch = 0;
+    }
+    if (stopping_.load(std::memory_order_acquire)) {
+      break;
+    }
+
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    consumer_waiting_.store(true, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wake_cv_.wait(lock, [this]() {
+      return QueueDepth() > 0 || stopping_.load(std::memory_order_acquire);
+    });
+    consumer_waiting_.store(false, std::memory_order_relaxed);
+  }
+
+  if (!shut_down_.load(std::memory_order_acquire)) {
+    ScheduleFlush();
+  }
+  tsfn_.Release();
+}
+
+void RigCommandExecutor::ScheduleFlush() {
+  {
+    std::lock_guard<std::mutex> guard(completed_mutex_);
+    if (completed_.empty()) {
+      return;
+    }
+  }
+  if (flush_pending_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  std::shared_ptr<RigCommandExecutor> self = shared_from_this();
+  napi_status status = tsfn_.NonBlockingCall([self](Napi::Env env, Napi::Function) {
+    // A flush that was already queued when the owner shut down is dropped
+    // with the tasks it would have completed.
+    if (self->shut_down_.load(std::memory_order_acquire)) {
+      return;
+    }
+    self->FlushCompleted(env);
+  });
+  if (status != napi_ok) {
+    flush_pending_.store(false, std::memory_order_release);
+  }
+}
+
+void RigCommandExecutor::FlushCompleted(Napi::Env env) {
+  // Clear the flag before taking the batch so a task finishing concurrently
+  // schedules its own flush instead of being stranded.
+  flush_pending_.store(false, std::memory_order_release);
+
+  std::vector<RigCommandTask*> batch;
+  {
+    std::lock_guard<std::mutex> guard(completed_mutex_);
+    batch.swap(completed_);
+  }
+  if (batch.empty()) {
+    return;
+  }
+
+  batches_.fetch_add(1, std::memory_order_relaxed);
+  for (RigCommandTask* task : batch) {
+    Napi::HandleScope scope(env);
+    task->CompleteOnJsThread(env);
+  }
+  completed_count_.fetch_add(batch.size(), std::memory_order_relaxed);
+
+  js_inflight_ -= std::min(js_inflight_, batch.size());
+  if (js_inflight_ == 0) {
+    tsfn_.Unref(env);
+  }
+}
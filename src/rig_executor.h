@@ -0,0 +1,185 @@
+#pragma once
+
+#include <napi.h>
+#include "rig_priority.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Unit of work accepted by RigCommandExecutor. Run() executes on the rig's
+// command thread; Complete() runs later on the JS thread and must release the
+// task (the executor never touches it again).
+class RigCommandTask {
+public:
+    virtual ~RigCommandTask() = default;
+    virtual void RunOnCommandThread() = 0;
+    virtual void CompleteOnJsThread(Napi::Env env) = 0;
+};
+
+// Bounded multi-producer / single-consumer ring buffer (Vyukov sequence
+// cells). TryPush/TryPop never block; TryPush fails once the ring is full.
+template <typename T>
+class BoundedMpscQueue {
+public:
+    explicit BoundedMpscQueue(size_t capacity)
+        : capacity_(roundUpPowerOfTwo(capacity)),
+          mask_(capacity_ - 1),
+          cells_(new Cell[capacity_]),
+          enqueue_pos_(0),
+          cursor_padding_(),
+          dequeue_pos_(0) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedMpscQueue(const BoundedMpscQueue&) = delete;
+    BoundedMpscQueue& operator=(const BoundedMpscQueue&) = delete;
+
+    bool TryPush(const T& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool TryPop(T* out) {
+        const size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[pos & mask_];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1) < 0) {
+            return false;
+        }
+        *out = cell.value;
+        dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+        cell.sequence.store(pos + capacity_, std::memory_order_release);
+        return true;
+    }
+
+    size_t Capacity() const { return capacity_; }
+
+    size_t ApproximateSize() const {
+        const size_t enqueued = enqueue_pos_.load(std::memory_order_relaxed);
+        const size_t dequeued = dequeue_pos_.load(std::memory_order_relaxed);
+        return enqueued >= dequeued ? enqueued - dequeued : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static size_t roundUpPowerOfTwo(size_t value) {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    std::atomic<size_t> enqueue_pos_;
+    // Keep producer and consumer cursors off the same cache line.
+    char cursor_padding_[64];
+    std::atomic<size_t> dequeue_pos_;
+};
+
+struct RigCommandExecutorStats {
+    size_t queue_capacity = 0;
+    size_t queue_depth = 0;
+    size_t max_queue_depth = 0;
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t rejected = 0;
+    uint64_t batches = 0;
+    double total_wait_ms = 0;
+    double max_wait_ms = 0;
+};
+
+// One long-lived native thread per rig. Submit() is called on the JS thread;
+// finished tasks are handed back to JS in batches through a single
+// ThreadSafeFunction call instead of one libuv work item per command.
+// Each priority class has its own queue; the thread always takes the next
+// task from the highest non-empty one, so order is kept within a class only.
+class RigCommandExecutor : public std::enable_shared_from_this<RigCommandExecutor> {
+public:
+    static std::shared_ptr<RigCommandExecutor> Create(Napi::Env env, size_t queue_capacity);
+    ~RigCommandExecutor();
+
+    // Returns false when the class's queue is full or the executor is stopping.
+    bool Submit(RigCommandTask* task, RigCommandPriority priority = RigCommandPriority::Interactive);
+    // Stop accepting work; queued tasks still run and complete, then the
+    // thread exits on its own.
+    void Stop();
+    // Teardown of the owner: stop accepting work, abandon the tasks still
+    // queued (they never run or complete) and join the thread once the task
+    // it is running returns. Nothing the executor holds is touched afterwards.
+    void Shutdown();
+    bool IsRunning() const { return !stopping_.load(std::memory_order_acquire); }
+    RigCommandExecutorStats GetStats() const;
+
+private:
+    struct QueuedTask {
+        RigCommandTask* task = nullptr;
+        std::chrono::steady_clock::time_point enqueued_at;
+    };
+
+    RigCommandExecutor(size_t queue_capacity);
+    void Start(Napi::Env env);
+    void ThreadMain();
+    void ScheduleFlush();
+    void FlushCompleted(Napi::Env env);
+    void RecordWait(double wait_ms);
+    bool TryPopNext(QueuedTask* out);
+    size_t QueueDepth() const;
+
+    std::unique_ptr<BoundedMpscQueue<QueuedTask>> lanes_[kRigPriorityCount];
+    std::thread thread_;
+    Napi::ThreadSafeFunction tsfn_;
+    napi_env tsfn_env_ = nullptr;
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> shut_down_{false};
+    std::atomic<bool> flush_pending_{false};
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::atomic<bool> consumer_waiting_{false};
+
+    std::mutex completed_mutex_;
+    std::vector<RigCommandTask*> completed_;
+
+    // Tasks submitted but not yet completed; only touched on the JS thread and
+    // used to keep the event loop alive while work is outstanding.
+    size_t js_inflight_ = 0;
+
+    std::atomic<size_t> max_queue_depth_{0};
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> completed_count_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> batches_{0};
+    mutable std::mutex wait_stats_mutex_;
+    double total_wait_ms_ = 0;
+    double max_wait_ms_ = 0;
+};
@@ -0,0 +1,383 @@
+#include "rig_metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+constexpr uint64_t kMaxRecordedMicros = (uint64_t(1) << 32) - 1;
+
+int floorLog2(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - __builtin_clzll(value);
+#else
+  int result = 0;
+  while (value >>= 1) {
+    ++result;
+  }
+  return result;
+#endif
+}
+
+void storeMax(std::atomic<uint64_t>& target, uint64_t value) {
+  uint64_t previous = target.load(std::memory_order_relaxed);
+  while (value > previous && !target.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+  }
+}
+
+// FNV-1a; operation names are short ASCII identifiers.
+size_t hashName(const char* name) {
+  uint64_t hash = 1469598103934665603ull;
+  for (const unsigned char* p = reinterpret_cast<const unsigned char*>(name); *p; ++p) {
+    hash ^= *p;
+    hash *= 1099511628211ull;
+  }
+  return static_cast<size_t>(hash);
+}
+
+double wallClockMs() {
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+}  // namespace
+
+int64_t rigMetricsNowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+LatencyHistogram::LatencyHistogram() {
+  Reset();
+}
+
+size_t LatencyHistogram::BucketIndex(uint64_t micros) {
+  if (micros < kLinearBuckets) {
+    return static_cast<size_t>(micros);
+  }
+  micros = std::min(micros, kMaxRecordedMicros);
+  const int exponent = floorLog2(micros);
+  const size_t sub = static_cast<size_t>(micros >> (exponent - 3)) & (kSubBuckets - 1);
+  return kLinearBuckets + static_cast<size_t>(exponent - 4) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t index) {
+  if (index < kLinearBuckets) {
+    return index + 1;
+  }
+  const size_t offset = index - kLinearBuckets;
+  const int exponent = 4 + static_cast<int>(offset / kSubBuckets);
+  const uint64_t sub = offset % kSubBuckets;
+  return (kSubBuckets + sub + 1) << (exponent - 3);
+}
+
+void LatencyHistogram::Record(uint64_t micros) {
+  buckets_[BucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_us_.fetch_add(micros, std::memory_order_relaxed);
+  storeMax(max_us_, micros);
+}
+
+void LatencyHistogram::Reset() {
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    buckets_[i].store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_us_.store(0, std::memory_order_relaxed);
+  max_us_.store(0, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::Take() const {
+  Snapshot snapshot;
+  snapshot.buckets.resize(kBucketCount);
+  uint64_t total = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += snapshot.buckets[i];
+  }
+  // Bucket totals are the source of truth so percentiles stay consistent
+  // with the buckets even when a recording races the snapshot.
+  snapshot.count = total;
+  snapshot.sum_us = sum_us_.load(std::memory_order_relaxed);
+  snapshot.max_us = max_us_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+uint64_t LatencyHistogram::Snapshot::Percentile(double quantile) const {
+  if (count == 0) {
+    return 0;
+  }
+  const double clamped = std::min(1.0, std::max(0.0, quantile));
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(clamped * static_cast<double>(count) + 0.5));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return std::min(BucketUpperBound(i), max_us);
+    }
+  }
+  return max_us;
+}
+
+RigOperationMetrics::RigOperationMetrics(std::string name)
+    : name_(std::move(name)) {
+  for (int i = 0; i < kTrackedCodes; ++i) {
+    error_codes_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void RigOperationMetrics::RecordLockWait(uint64_t micros) {
+  lock_wait_.Record(micros);
+}
+
+void RigOperationMetrics::RecordLockTimeout() {
+  calls_.fetch_add(1, std::memory_order_relaxed);
+  errors_.fetch_add(1, std::memory_order_relaxed);
+  lock_timeouts_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RigOperationMetrics::RecordRejected() {
+  calls_.fetch_add(1, std::memory_order_relaxed);
+  errors_.fetch_add(1, std::memory_order_relaxed);
+  rejected_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RigOperationMetrics::RecordCall(uint64_t execute_us, bool error, int result_code) {
+  calls_.fetch_add(1, std::memory_order_relaxed);
+  execute_.Record(execute_us);
+  if (!error) {
+    return;
+  }
+  errors_.fetch_add(1, std::memory_order_relaxed);
+  const int slot = result_code < 0 ? std::min(-result_code, kTrackedCodes - 1) : 0;
+  error_codes_[slot].fetch_add(1, std::memory_order_relaxed);
+}
+
+RigOperationSnapshot RigOperationMetrics::Take() const {
+  RigOperationSnapshot snapshot;
+  snapshot.name = name_;
+  snapshot.calls = calls_.load(std::memory_order_relaxed);
+  snapshot.errors = errors_.load(std::memory_order_relaxed);
+  snapshot.lock_timeouts = lock_timeouts_.load(std::memory_order_relaxed);
+  snapshot.rejected = rejected_.load(std::memory_order_relaxed);
+  for (int i = 0; i < kTrackedCodes; ++i) {
+    const uint64_t count = error_codes_[i].load(std::memory_order_relaxed);
+    if (count > 0) {
+      snapshot.errors_by_code.emplace_back(-i, count);
+    }
+  }
+  snapshot.lock_wait = lock_wait_.Take();
+  snapshot.execute = execute_.Take();
+  return snapshot;
+}
+
+void RigOperationMetrics::Reset() {
+  calls_.store(0, std::memory_order_relaxed);
+  errors_.store(0, std::memory_order_relaxed);
+  lock_timeouts_.store(0, std::memory_order_relaxed);
+  rejected_.store(0, std::memory_order_relaxed);
+  for (int i = 0; i < kTrackedCodes; ++i) {
+    error_codes_[i].store(0, std::memory_order_relaxed);
+  }
+  lock_wait_.Reset();
+  execute_.Reset();
+}
+
+RigMetricsRegistry::RigMetricsRegistry()
+    : slots_(new std::atomic<RigOperationMetrics*>[kSlots]),
+      overflow_(new RigOperationMetrics("other")),
+      since_ms_(wallClockMs()) {
+  for (size_t i = 0; i < kSlots; ++i) {
+    slots_[i].store(nullptr, std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < kRigPriorityCount; ++i) {
+    lane_calls_[i].store(0, std::memory_order_relaxed);
+    lane_shed_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+RigMetricsRegistry::~RigMetricsRegistry() = default;
+
+RigMetricsRegistry& RigMetricsRegistry::Global() {
+  // Leaked on purpose: worker threads may still record during shutdown.
+  static RigMetricsRegistry* registry = new RigMetricsRegistry();
+  return *registry;
+}
+
+RigOperationMetrics* RigMetricsRegistry::ForOperation(const char* name) {
+  if (!name || !*name) {
+    name = "HamLibAsyncWorker";
+  }
+  const size_t start = hashName(name) & (kSlots - 1);
+  for (size_t probe = 0; probe < kSlots; ++probe) {
+    std::atomic<RigOperationMetrics*>& slot = slots_[(start + probe) & (kSlots - 1)];
+    RigOperationMetrics* entry = slot.load(std::memory_order_acquire);
+    if (!entry) {
+      std::lock_guard<std::mutex> guard(insert_mutex_);
+      entry = slot.load(std::memory_order_acquire);
+      if (!entry) {
+        owned_.emplace_back(new RigOperationMetrics(name));
+        entry = owned_.back().get();
+        slot.store(entry, std::memory_order_release);
+        return entry;
+      }
+    }
+    if (std::strcmp(entry->Name().c_str(), name) == 0) {
+      return entry;
+    }
+  }
+  return overflow_.get();
+}
+
+void RigMetricsRegistry::NoteQueued() {
+  const int64_t depth = pending_.fetch_add(1, std::memory_order_relaxed) + 1;
+  int64_t previous = max_pending_.load(std::memory_order_relaxed);
+  while (depth > previous && !max_pending_.compare_exchange_weak(previous, depth, std::memory_order_relaxed)) {
+  }
+}
+
+void RigMetricsRegistry::RecordLaneCall(RigCommandPriority priority, uint64_t latency_us) {
+  const size_t lane = static_cast<size_t>(priority);
+  lane_calls_[lane].fetch_add(1, std::memory_order_relaxed);
+  lane_latency_[lane].Record(latency_us);
+}
+
+void RigMetricsRegistry::RecordLaneShed(RigCommandPriority priority) {
+  lane_shed_[static_cast<size_t>(priority)].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<RigLaneSnapshot> RigMetricsRegistry::TakeLanes() const {
+  std::vector<RigLaneSnapshot> lanes(kRigPriorityCount);
+  for (size_t i = 0; i < kRigPriorityCount; ++i) {
+    lanes[i].calls = lane_calls_[i].load(std::memory_order_relaxed);
+    lanes[i].shed = lane_shed_[i].load(std::memory_order_relaxed);
+    lanes[i].latency = lane_latency_[i].Take();
+  }
+  return lanes;
+}
+
+std::vector<RigOperationSnapshot> RigMetricsRegistry::TakeOperations() const {
+  std::vector<RigOperationMetrics*> entries;
+  entries.reserve(kSlots);
+  for (size_t i = 0; i < kSlots; ++i) {
+    RigOperationMetrics* entry = slots_[i].load(std::memory_order_acquire);
+    if (entry) {
+      entries.push_back(entry);
+    }
+  }
+  entries.push_back(overflow_.get());
+
+  std::vector<RigOperationSnapshot> snapshots;
+  snapshots.reserve(entries.size());
+  for (RigOperationMetrics* entry : entries) {
+    RigOperationSnapshot snapshot = entry->Take();
+    if (snapshot.calls > 0) {
+      snapshots.push_back(std::move(snapshot));
+    }
+  }
+  std::sort(snapshots.begin(), snapshots.end(), [](const RigOperationSnapshot& a, const RigOperationSnapshot& b) {
+    return a.name < b.name;
+  });
+  return snapshots;
+}
+
+RigQueueSnapshot RigMetricsRegistry::TakeQueue() const {
+  RigQueueSnapshot snapshot;
+  snapshot.pending = std::max<int64_t>(0, pending_.load(std::memory_order_relaxed));
+  snapshot.waiting_for_lock = std::max<int64_t>(0, waiting_for_lock_.load(std::memory_order_relaxed));
+  snapshot.executing = std::max<int64_t>(0, executing_.load(std::memory_order_relaxed));
+  snapshot.max_pending = max_pending_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+void RigMetricsRegistry::Reset() {
+  for (size_t i = 0; i < kSlots; ++i) {
+    RigOperationMetrics* entry = slots_[i].load(std::memory_order_acquire);
+    if (entry) {
+      entry->Reset();
+    }
+  }
+  overflow_->Reset();
+  for (size_t i = 0; i < kRigPriorityCount; ++i) {
+    lane_calls_[i].store(0, std::memory_order_relaxed);
+    lane_shed_[i].store(0, std::memory_order_relaxed);
+    lane_latency_[i].Reset();
+  }
+  max_pending_.store(std::max<int64_t>(0, pending_.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+  since_ms_.store(wallClockMs(), std::memory_order_relaxed);
+}
+
+RigLockHolderTable& RigLockHolderTable::Global() {
+  static RigLockHolderTable* table = new RigLockHolderTable();
+  return *table;
+}
+
+void RigLockHolderTable::NoteAcquired(const void* mutex, const RigOperationMetrics* operation, const char* scope) {
+  if (!mutex) {
+    return;
+  }
+  const size_t start = (reinterpret_cast<uintptr_t>(mutex) >> 4) & (kSlots - 1);
+  for (size_t probe = 0; probe < kSlots; ++probe) {
+    Slot& slot = slots_[(start + probe) & (kSlots - 1)];
+    const void* expected = nullptr;
+    if (slot.mutex.compare_exchange_strong(expected, mutex, std::memory_order_acq_rel)) {
+      slot.since_us.store(rigMetricsNowMicros(), std::memory_order_relaxed);
+      slot.scope.store(scope, std::memory_order_relaxed);
+      slot.operation.store(operation, std::memory_order_release);
+      return;
+    }
+  }
+  // More locks held at once than slots: only diagnostics are lost.
+}
+
+void RigLockHolderTable::NoteReleased(const void* mutex) {
+  if (!mutex) {
+    return;
+  }
+  for (size_t i = 0; i < kSlots; ++i) {
+    Slot& slot = slots_[i];
+    if (slot.mutex.load(std::memory_order_acquire) == mutex) {
+      slot.operation.store(nullptr, std::memory_order_relaxed);
+      slot.mutex.store(nullptr, std::memory_order_release);
+      return;
+    }
+  }
+}
+
+bool RigLockHolderTable::Read(const Slot& slot, const void* mutex, RigLockHolderSnapshot* out) const {
+  const RigOperationMetrics* operation = slot.operation.load(std::memory_order_acquire);
+  const char* scope = slot.scope.load(std::memory_order_relaxed);
+  const int64_t since = slot.since_us.load(std::memory_order_relaxed);
+  if (!operation || slot.mutex.load(std::memory_order_acquire) != mutex) {
+    return false;
+  }
+  out->operation = operation->Name();
+  out->scope = scope ? scope : "";
+  out->held_ms = static_cast<double>(std::max<int64_t>(0, rigMetricsNowMicros() - since)) / 1000.0;
+  return true;
+}
+
+bool RigLockHolderTable::Find(const void* mutex, RigLockHolderSnapshot* out) const {
+  if (!mutex || !out) {
+    return false;
+  }
+  for (size_t i = 0; i < kSlots; ++i) {
+    if (slots_[i].mutex.load(std::memory_order_acquire) == mutex && Read(slots_[i], mutex, out)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<RigLockHolderSnapshot> RigLockHolderTable::TakeAll() const {
+  std::vector<RigLockHolderSnapshot> holders;
+  for (size_t i = 0; i < kSlots; ++i) {
+    const void* mutex = slots_[i].mutex.load(std::memory_order_acquire);
+    RigLockHolderSnapshot holder;
+    if (mutex && Read(slots_[i], mutex, &holder)) {
+      holders.push_back(std::move(holder));
+    }
+  }
+  return holders;
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "rig_priority.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Latency histogram with HDR-style buckets: exact below 16us, then eight
+// linear sub-buckets per power of two (<= 12.5% relative error) up to ~71
+// minutes. Recording is a handful of relaxed atomic adds.
+class LatencyHistogram {
+public:
+    static constexpr size_t kLinearBuckets = 16;
+    static constexpr size_t kSubBuckets = 8;
+    static constexpr size_t kBucketCount = kLinearBuckets + (32 - 4) * kSubBuckets;
+
+    LatencyHistogram();
+
+    void Record(uint64_t micros);
+    void Reset();
+
+    // Exclusive upper bound of a bucket, in microseconds.
+    static uint64_t BucketUpperBound(size_t index);
+    static size_t BucketIndex(uint64_t micros);
+
+    struct Snapshot {
+        uint64_t count = 0;
+        uint64_t sum_us = 0;
+        uint64_t max_us = 0;
+        std::vector<uint64_t> buckets;
+
+        // Upper bound of the bucket holding the given quantile (0..1),
+        // capped at the recorded maximum.
+        uint64_t Percentile(double quantile) const;
+    };
+    Snapshot Take() const;
+
+private:
+    std::atomic<uint64_t> buckets_[kBucketCount];
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_us_{0};
+    std::atomic<uint64_t> max_us_{0};
+};
+
+struct RigOperationSnapshot {
+  std::string name;
+  uint64_t calls = 0;
+  uint64_t errors = 0;
+  uint64_t lock_timeouts = 0;
+  uint64_t rejected = 0;
+  // (hamlib result code, count); code 0 is a native error without one.
+  std::vector<std::pair<int, uint64_t>> errors_by_code;
+  LatencyHistogram::Snapshot lock_wait;
+  LatencyHistogram::Snapshot execute;
+};
+
+// Counters for one OperationName(). Entries are created on first use and
+// live as long as their registry, so a pointer can be cached.
+class RigOperationMetrics {
+public:
+    // Hamlib codes are small negative numbers; anything past this shares
+    // the last slot.
+    static constexpr int kTrackedCodes = 64;
+
+    explicit RigOperationMetrics(std::string name);
+
+    const std::string& Name() const { return name_; }
+
+    void RecordLockWait(uint64_t micros);
+    void RecordLockTimeout();
+    void RecordRejected();
+    // error is true for a failed call; result_code is the worker's result.
+    void RecordCall(uint64_t execute_us, bool error, int result_code);
+
+    RigOperationSnapshot Take() const;
+    void Reset();
+
+private:
+    const std::string name_;
+    std::atomic<uint64_t> calls_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::atomic<uint64_t> lock_timeouts_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> error_codes_[kTrackedCodes];
+    LatencyHistogram lock_wait_;
+    LatencyHistogram execute_;
+};
+
+struct RigQueueSnapshot {
+  int64_t pending = 0;
+  int64_t waiting_for_lock = 0;
+  int64_t executing = 0;
+  int64_t max_pending = 0;
+};
+
+struct RigLaneSnapshot {
+  uint64_t calls = 0;
+  // Background commands refused because the rig was over its budget.
+  uint64_t shed = 0;
+  // Queued to finished: queue wait, lock wait and execution.
+  LatencyHistogram::Snapshot latency;
+};
+
+// Per-operation metrics plus queue-depth gauges. Lookups after the first
+// call for a name are lock-free; new names take a mutex once.
+class RigMetricsRegistry {
+public:
+    RigMetricsRegistry();
+    ~RigMetricsRegistry();
+
+    RigMetricsRegistry(const RigMetricsRegistry&) = delete;
+    RigMetricsRegistry& operator=(const RigMetricsRegistry&) = delete;
+
+    static RigMetricsRegistry& Global();
+
+    RigOperationMetrics* ForOperation(const char* name);
+
+    // Worker life cycle: queued -> waiting for the rig lock -> executing.
+    void NoteQueued();
+    void NoteDequeued() { pending_.fetch_sub(1, std::memory_order_relaxed); }
+    void NoteLockWaitBegin() { waiting_for_lock_.fetch_add(1, std::memory_order_relaxed); }
+    void NoteLockWaitEnd() { waiting_for_lock_.fetch_sub(1, std::memory_order_relaxed); }
+    void NoteExecuteBegin() { executing_.fetch_add(1, std::memory_order_relaxed); }
+    void NoteExecuteEnd() { executing_.fetch_sub(1, std::memory_order_relaxed); }
+
+    // Per priority class; a shed command is not a call.
+    void RecordLaneCall(RigCommandPriority priority, uint64_t latency_us);
+    void RecordLaneShed(RigCommandPriority priority);
+
+    std::vector<RigOperationSnapshot> TakeOperations() const;
+    // Indexed by RigCommandPriority.
+    std::vector<RigLaneSnapshot> TakeLanes() const;
+    RigQueueSnapshot TakeQueue() const;
+    // Clears counters and histograms; gauges keep tracking in-flight work.
+    void Reset();
+    // Milliseconds since the epoch of construction or the last Reset().
+    double SinceMs() const { return since_ms_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t kSlots = 512;
+
+    std::unique_ptr<std::atomic<RigOperationMetrics*>[]> slots_;
+    std::mutex insert_mutex_;
+    std::vector<std::unique_ptr<RigOperationMetrics>> owned_;
+    std::unique_ptr<RigOperationMetrics> overflow_;
+    std::atomic<int64_t> pending_{0};
+    std::atomic<int64_t> waiting_for_lock_{0};
+    std::atomic<int64_t> executing_{0};
+    std::atomic<int64_t> max_pending_{0};
+    std::atomic<double> since_ms_{0};
+    std::atomic<uint64_t> lane_calls_[kRigPriorityCount];
+    std::atomic<uint64_t> lane_shed_[kRigPriorityCount];
+    LatencyHistogram lane_latency_[kRigPriorityCount];
+};
+
+struct RigLockHolderSnapshot {
+  std::string operation;
+  std::string scope;
+  double held_ms = 0;
+};
+
+// Which operation currently holds each rig mutex, so a lock timeout can name
+// the culprit. Only the lock owner writes its entry.
+class RigLockHolderTable {
+public:
+    static RigLockHolderTable& Global();
+
+    void NoteAcquired(const void* mutex, const RigOperationMetrics* operation, const char* scope);
+    void NoteReleased(const void* mutex);
+    bool Find(const void* mutex, RigLockHolderSnapshot* out) const;
+    std::vector<RigLockHolderSnapshot> TakeAll() const;
+
+private:
+    static constexpr size_t kSlots = 64;
+
+    struct Slot {
+        std::atomic<const void*> mutex{nullptr};
+        std::atomic<const RigOperationMetrics*> operation{nullptr};
+        std::atomic<const char*> scope{nullptr};
+        std::atomic<int64_t> since_us{0};
+    };
+
+    bool Read(const Slot& slot, const void* mutex, RigLockHolderSnapshot* out) const;
+
+    Slot slots_[kSlots];
+};
+
+// Monotonic microseconds used by the metrics and holder table.
+int64_t rigMetricsNowMicros();
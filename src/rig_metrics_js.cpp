@@ -0,0 +1,247 @@
+#include "rig_metrics_js.h"
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+Napi::Object latencyHistogramToObject(Napi::Env env, const LatencyHistogram::Snapshot& histogram) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("count", Napi::Number::New(env, static_cast<double>(histogram.count)));
+  obj.Set("sumMs", Napi::Number::New(env, static_cast<double>(histogram.sum_us) / 1000.0));
+  obj.Set("meanMs", Napi::Number::New(env, histogram.count > 0
+    ? static_cast<double>(histogram.sum_us) / 1000.0 / static_cast<double>(histogram.count) : 0));
+  obj.Set("maxMs", Napi::Number::New(env, static_cast<double>(histogram.max_us) / 1000.0));
+  obj.Set("p50Ms", Napi::Number::New(env, static_cast<double>(histogram.Percentile(0.5)) / 1000.0));
+  obj.Set("p90Ms", Napi::Number::New(env, static_cast<double>(histogram.Percentile(0.9)) / 1000.0));
+  obj.Set("p99Ms", Napi::Number::New(env, static_cast<double>(histogram.Percentile(0.99)) / 1000.0));
+  obj.Set("p999Ms", Napi::Number::New(env, static_cast<double>(histogram.Percentile(0.999)) / 1000.0));
+  // Only non-empty buckets; counts are per bucket, not cumulative.
+  Napi::Array buckets = Napi::Array::New(env);
+  uint32_t index = 0;
+  for (size_t i = 0; i < histogram.buckets.size(); ++i) {
+    if (histogram.buckets[i] == 0) {
+      continue;
+    }
+    Napi::Object bucket = Napi::Object::New(env);
+    bucket.Set("leMs", Napi::Number::New(env, static_cast<double>(LatencyHistogram::BucketUpperBound(i)) / 1000.0));
+    bucket.Set("count", Napi::Number::New(env, static_cast<double>(histogram.buckets[i])));
+    buckets[index++] = bucket;
+  }
+  obj.Set("buckets", buckets);
+  return obj;
+}
+
+Napi::Object rigMetricsToObject(Napi::Env env, const RigMetricsRegistry& registry) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("since", Napi::Number::New(env, registry.SinceMs()));
+
+  Napi::Object operations = Napi::Object::New(env);
+  for (const RigOperationSnapshot& snapshot : registry.TakeOperations()) {
+    Napi::Object op = Napi::Object::New(env);
+    op.Set("calls", Napi::Number::New(env, static_cast<double>(snapshot.calls)));
+    op.Set("errors", Napi::Number::New(env, static_cast<double>(snapshot.errors)));
+    op.Set("lockTimeouts", Napi::Number::New(env, static_cast<double>(snapshot.lock_timeouts)));
+    op.Set("rejected", Napi::Number::New(env, static_cast<double>(snapshot.rejected)));
+    Napi::Object byCode = Napi::Object::New(env);
+    for (const auto& entry : snapshot.errors_by_code) {
+      byCode.Set(std::to_string(entry.first), Napi::Number::New(env, static_cast<double>(entry.second)));
+    }
+    op.Set("errorsByCode", byCode);
+    op.Set("lockWait", latencyHistogramToObject(env, snapshot.lock_wait));
+    op.Set("execute", latencyHistogramToObject(env, snapshot.execute));
+    operations.Set(snapshot.name, op);
+  }
+  obj.Set("operations", operations);
+
+  const RigQueueSnapshot queue = registry.TakeQueue();
+  Napi::Object queueObj = Napi::Object::New(env);
+  queueObj.Set("pending", Napi::Number::New(env, static_cast<double>(queue.pending)));
+  queueObj.Set("waitingForLock", Napi::Number::New(env, static_cast<double>(queue.waiting_for_lock)));
+  queueObj.Set("executing", Napi::Number::New(env, static_cast<double>(queue.executing)));
+  queueObj.Set("maxPending", Napi::Number::New(env, static_cast<double>(queue.max_pending)));
+  obj.Set("queue", queueObj);
+
+  const std::vector<RigLaneSnapshot> lanes = registry.TakeLanes();
+  Napi::Object lanesObj = Napi::Object::New(env);
+  for (size_t i = 0; i < lanes.size(); ++i) {
+    Napi::Object lane = Napi::Object::New(env);
+    lane.Set("calls", Napi::Number::New(env, static_cast<double>(lanes[i].calls)));
+    lane.Set("shed", Napi::Number::New(env, static_cast<double>(lanes[i].shed)));
+    lane.Set("latency", latencyHistogramToObject(env, lanes[i].latency));
+    lanesObj.Set(rigCommandPriorityName(static_cast<RigCommandPriority>(i)), lane);
+  }
+  obj.Set("lanes", lanesObj);
+  return obj;
+}
+
+namespace {
+
+constexpr size_t kTracePhaseCount = 5;
+
+struct TracedCall {
+  uint32_t id = 0;
+  bool seen[kTracePhaseCount] = {};
+  RigTraceEvent events[kTracePhaseCount];
+  const RigOperationMetrics* operation = nullptr;
+};
+
+class ChromeTraceWriter {
+public:
+    ChromeTraceWriter(Napi::Env env, uint32_t owner_thread)
+        : env_(env), owner_thread_(owner_thread), events_(Napi::Array::New(env)) {}
+
+    Napi::Object Event(const char* ph, const std::string& name, int64_t ts_us, uint32_t thread) {
+        Napi::Object event = Napi::Object::New(env_);
+        event.Set("name", Napi::String::New(env_, name));
+        event.Set("cat", Napi::String::New(env_, "hamlib"));
+        event.Set("ph", Napi::String::New(env_, ph));
+        event.Set("ts", Napi::Number::New(env_, static_cast<double>(ts_us)));
+        event.Set("pid", Napi::Number::New(env_, 1));
+        event.Set("tid", Napi::Number::New(env_, thread));
+        events_[count_++] = event;
+        threads_.insert(thread);
+        return event;
+    }
+
+    // Nestable async begin/end pair of one call, keyed by its id.
+    void Span(const std::string& name, uint32_t id, const RigTraceEvent& from, const RigTraceEvent& to,
+              uint32_t thread, Napi::Object args) {
+        const std::string key = "0x" + ToHex(id);
+        Event("b", name, from.ts_us, thread).Set("id", Napi::String::New(env_, key));
+        Napi::Object end = Event("e", name, to.ts_us, thread);
+        end.Set("id", Napi::String::New(env_, key));
+        if (!args.IsEmpty()) {
+            end.Set("args", args);
+        }
+    }
+
+    Napi::Array Finish() {
+        Napi::Object process = Event("M", "process_name", 0, owner_thread_);
+        Napi::Object processArgs = Napi::Object::New(env_);
+        processArgs.Set("name", Napi::String::New(env_, "node-hamlib"));
+        process.Set("args", processArgs);
+        const std::set<uint32_t> threads = threads_;
+        for (uint32_t thread : threads) {
+            Napi::Object meta = Event("M", "thread_name", 0, thread);
+            Napi::Object args = Napi::Object::New(env_);
+            args.Set("name", Napi::String::New(env_, thread == owner_thread_
+              ? std::string("JS thread") : "Hamlib worker " + std::to_string(thread)));
+            meta.Set("args", args);
+        }
+        return events_;
+    }
+
+private:
+    static std::string ToHex(uint32_t value) {
+        static const char digits[] = "0123456789abcdef";
+        std::string out;
+        do {
+            out.insert(out.begin(), digits[value & 0xf]);
+            value >>= 4;
+        } while (value);
+        return out;
+    }
+
+    Napi::Env env_;
+    uint32_t owner_thread_;
+    Napi::Array events_;
+    uint32_t count_ = 0;
+    std::set<uint32_t> threads_;
+};
+
+}  // namespace
+
+Napi::Object rigTraceToChromeObject(Napi::Env env, const RigTraceRing* ring, bool enabled) {
+  std::vector<RigTraceEvent> events;
+  if (ring) {
+    events = ring->Snapshot();
+  }
+
+  // Events of one call share its id; keep calls in order of first sight.
+  std::vector<TracedCall> calls;
+  std::unordered_map<uint32_t, size_t> index;
+  for (const RigTraceEvent& event : events) {
+    auto found = index.find(event.call_id);
+    if (found == index.end()) {
+      found = index.emplace(event.call_id, calls.size()).first;
+      calls.emplace_back();
+      calls.back().id = event.call_id;
+    }
+    TracedCall& call = calls[found->second];
+    const size_t phase = static_cast<size_t>(event.phase);
+    if (phase < kTracePhaseCount && !call.seen[phase]) {
+      call.seen[phase] = true;
+      call.events[phase] = event;
+    }
+    if (!call.operation && event.operation) {
+      call.operation = event.operation;
+    }
+  }
+
+  const uint32_t owner = ring ? ring->OwnerThread() : 0;
+  ChromeTraceWriter writer(env, owner);
+  const size_t created = static_cast<size_t>(RigTracePhase::Created);
+  const size_t started = static_cast<size_t>(RigTracePhase::Started);
+  const size_t locked = static_cast<size_t>(RigTracePhase::Locked);
+  const size_t returned = static_cast<size_t>(RigTracePhase::Returned);
+  const size_t settled = static_cast<size_t>(RigTracePhase::Settled);
+  for (const TracedCall& call : calls) {
+    const std::string name = call.operation ? call.operation->Name() : std::string("HamLibAsyncWorker");
+    const RigTraceEvent* last = nullptr;
+    const RigTraceEvent* first = nullptr;
+    for (size_t phase = 0; phase < kTracePhaseCount; ++phase) {
+      if (call.seen[phase]) {
+        first = first ? first : &call.events[phase];
+        last = &call.events[phase];
+      }
+    }
+    // Whole call: construction to settlement.
+    Napi::Object callArgs = Napi::Object::New(env);
+    if (call.seen[started]) {
+      callArgs.Set("priority", Napi::String::New(env, rigCommandPriorityName(call.events[started].priority)));
+    }
+    if (call.seen[settled]) {
+      callArgs.Set("ok", Napi::Boolean::New(env, !call.events[settled].failed));
+      callArgs.Set("result", Napi::Number::New(env, call.events[settled].result_code));
+    }
+    writer.Span(name, call.id, *first, *last, owner, callArgs);
+    if (call.seen[created] && call.seen[started]) {
+      writer.Span("queue", call.id, call.events[created], call.events[started], owner, Napi::Object());
+    }
+    if (call.seen[started] && call.seen[locked]) {
+      writer.Span("lockWait", call.id, call.events[started], call.events[locked], owner, Napi::Object());
+    }
+    if (call.seen[locked] && call.seen[returned]) {
+      writer.Span("execute", call.id, call.events[locked], call.events[returned], owner, Napi::Object());
+      // The shim call itself, on the thread that ran it.
+      const RigTraceEvent& end = call.events[returned];
+      Napi::Object slice = writer.Event("X", name, call.events[locked].ts_us, end.thread);
+      slice.Set("dur", Napi::Number::New(env, static_cast<double>(end.ts_us - call.events[locked].ts_us)));
+      Napi::Object args = Napi::Object::New(env);
+      args.Set("callId", Napi::Number::New(env, call.id));
+      args.Set("result", Napi::Number::New(env, end.result_code));
+      slice.Set("args", args);
+    }
+    if (call.seen[settled]) {
+      const RigTraceEvent* from = call.seen[returned] ? &call.events[returned]
+        : call.seen[locked] ? &call.events[locked]
+        : call.seen[started] ? &call.events[started] : nullptr;
+      if (from) {
+        writer.Span("resolve", call.id, *from, call.events[settled], owner, Napi::Object());
+      }
+    }
+  }
+
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("traceEvents", writer.Finish());
+  obj.Set("displayTimeUnit", Napi::String::New(env, "ms"));
+  Napi::Object other = Napi::Object::New(env);
+  other.Set("enabled", Napi::Boolean::New(env, enabled));
+  other.Set("capacity", Napi::Number::New(env, ring ? static_cast<double>(ring->Capacity()) : 0));
+  other.Set("recorded", Napi::Number::New(env, ring ? static_cast<double>(ring->Recorded()) : 0));
+  other.Set("overwritten", Napi::Number::New(env, ring ? static_cast<double>(ring->Overwritten()) : 0));
+  other.Set("calls", Napi::Number::New(env, static_cast<double>(calls.size())));
+  obj.Set("otherData", other);
+  return obj;
+}
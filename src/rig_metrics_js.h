@@ -0,0 +1,12 @@
+#pragma once
+
+#include <napi.h>
+#include "rig_metrics.h"
+#include "rig_trace.h"
+
+// JS views of the metrics types, shared by the rig and rotator getStats().
+Napi::Object latencyHistogramToObject(Napi::Env env, const LatencyHistogram::Snapshot& histogram);
+Napi::Object rigMetricsToObject(Napi::Env env, const RigMetricsRegistry& registry);
+// Chrome trace-event JSON object ({ traceEvents, displayTimeUnit, otherData })
+// of a trace ring; `ring` may be null when tracing was never enabled.
+Napi::Object rigTraceToChromeObject(Napi::Env env, const RigTraceRing* ring, bool enabled);
@@ -0,0 +1,377 @@
+#include "rig_model_index.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const char kIndexMagic[8] = { 'H', 'L', 'M', 'I', 'D', 'X', '\0', '\0' };
+
+std::mutex& installedMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::shared_ptr<const RigModelIndex>& installedSlot() {
+  static std::shared_ptr<const RigModelIndex> index;
+  return index;
+}
+
+struct IndexWriter {
+  std::vector<RigModelIndexModel> models;
+  std::vector<RigModelIndexField> fields;
+  std::vector<uint32_t> options;
+  std::vector<RigModelIndexString> strings;
+  std::string blob;
+  std::unordered_map<std::string, uint32_t> interned;
+
+  uint32_t Intern(const char* value) {
+    std::string text = value ? value : "";
+    auto found = interned.find(text);
+    if (found != interned.end()) {
+      return found->second;
+    }
+    const uint32_t id = static_cast<uint32_t>(strings.size());
+    strings.push_back(RigModelIndexString{ static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(text.size()) });
+    blob += text;
+    blob.push_back('\0');
+    interned.emplace(std::move(text), id);
+    return id;
+  }
+};
+
+int collectModel(const shim_rig_info_t* info, void* data) {
+  IndexWriter* writer = static_cast<IndexWriter*>(data);
+  RigModelIndexModel model;
+  std::memset(&model, 0, sizeof(model));
+  model.model = info->rig_model;
+  model.model_name = writer->Intern(info->model_name);
+  model.mfg_name = writer->Intern(info->mfg_name);
+  model.version = writer->Intern(info->version);
+  model.status = writer->Intern(shim_rig_strstatus(info->status));
+  model.rig_type = writer->Intern(shim_rig_type_str(info->rig_type));
+  writer->models.push_back(model);
+  return 1;  // continue iteration
+}
+
+int collectField(const shim_confparam_info_t* info, void* data) {
+  IndexWriter* writer = static_cast<IndexWriter*>(data);
+  RigModelIndexField field;
+  std::memset(&field, 0, sizeof(field));
+  field.token = info->token;
+  field.name = writer->Intern(info->name);
+  field.label = writer->Intern(info->label);
+  field.tooltip = writer->Intern(info->tooltip);
+  field.dflt = writer->Intern(info->dflt);
+  field.type = info->type;
+  field.numeric_min = info->numeric_min;
+  field.numeric_max = info->numeric_max;
+  field.numeric_step = info->numeric_step;
+  field.first_option = static_cast<uint32_t>(writer->options.size());
+  for (int i = 0; i < info->combo_count && i < SHIM_CONF_COMBO_MAX; ++i) {
+    writer->options.push_back(writer->Intern(info->combo_options[i]));
+  }
+  field.option_count = static_cast<uint32_t>(writer->options.size()) - field.first_option;
+  writer->fields.push_back(field);
+  return 1;
+}
+
+void copyString(char* dest, size_t size, const char* src) {
+  std::strncpy(dest, src, size - 1);
+  dest[size - 1] = '\0';
+}
+
+uint64_t alignTo8(uint64_t value) {
+  return (value + 7) & ~static_cast<uint64_t>(7);
+}
+
+template <typename T>
+bool writeArray(std::FILE* file, const std::vector<T>& values) {
+  return values.empty() || std::fwrite(values.data(), sizeof(T), values.size(), file) == values.size();
+}
+
+bool writePadding(std::FILE* file, uint64_t from, uint64_t to) {
+  static const char zeros[8] = {};
+  return from == to || std::fwrite(zeros, 1, static_cast<size_t>(to - from), file) == to - from;
+}
+
+}  // namespace
+
+bool RigModelIndex::Build(const std::string& path, std::mutex& metadata_mutex, RigModelIndexBuildStats* stats,
+                          std::string* error) {
+  IndexWriter writer;
+  const uint32_t hamlibVersion = writer.Intern(shim_rig_get_version());
+  {
+    std::lock_guard<std::mutex> metadataLock(metadata_mutex);
+    shim_rig_load_all_backends();
+    const int result = shim_rig_list_foreach(collectModel, &writer);
+    if (result != SHIM_RIG_OK) {
+      *error = std::string("Failed to enumerate rig models: ") + shim_rigerror(result);
+      return false;
+    }
+    std::sort(writer.models.begin(), writer.models.end(),
+      [](const RigModelIndexModel& a, const RigModelIndexModel& b) { return a.model < b.model; });
+
+    for (RigModelIndexModel& model : writer.models) {
+      hamlib_shim_handle_t rig = shim_rig_init(model.model);
+      if (!rig) {
+        ++stats->incomplete;
+        continue;
+      }
+      shim_rig_port_caps_t caps{};
+      if (shim_rig_get_port_caps(rig, &caps) == SHIM_RIG_OK) {
+        model.flags |= kRigModelIndexHasPortCaps;
+        model.port_type = writer.Intern(caps.port_type);
+        model.serial_parity = writer.Intern(caps.serial_parity);
+        model.serial_handshake = writer.Intern(caps.serial_handshake);
+        model.serial_rate_min = caps.serial_rate_min;
+        model.serial_rate_max = caps.serial_rate_max;
+        model.serial_data_bits = caps.serial_data_bits;
+        model.serial_stop_bits = caps.serial_stop_bits;
+        model.write_delay = caps.write_delay;
+        model.post_write_delay = caps.post_write_delay;
+        model.timeout = caps.timeout;
+        model.retry = caps.retry;
+      }
+      const size_t firstField = writer.fields.size();
+      const size_t firstOption = writer.options.size();
+      if (shim_rig_cfgparams_foreach(rig, collectField, &writer) == SHIM_RIG_OK) {
+        model.flags |= kRigModelIndexHasConfigSchema;
+        model.first_field = static_cast<uint32_t>(firstField);
+        model.field_count = static_cast<uint32_t>(writer.fields.size() - firstField);
+      } else {
+        writer.fields.resize(firstField);
+        writer.options.resize(firstOption);
+      }
+      shim_rig_cleanup(rig);
+    }
+  }
+
+  RigModelIndexHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kIndexMagic, sizeof(header.magic));
+  header.version = kRigModelIndexVersion;
+  header.header_bytes = static_cast<uint32_t>(kRigModelIndexHeaderBytes);
+  header.model_count = static_cast<uint32_t>(writer.models.size());
+  header.field_count = static_cast<uint32_t>(writer.fields.size());
+  header.option_count = static_cast<uint32_t>(writer.options.size());
+  header.string_count = static_cast<uint32_t>(writer.strings.size());
+  header.hamlib_version = hamlibVersion;
+  header.models_offset = kRigModelIndexHeaderBytes;
+  header.fields_offset = header.models_offset + writer.models.size() * sizeof(RigModelIndexModel);
+  header.options_offset = header.fields_offset + writer.fields.size() * sizeof(RigModelIndexField);
+  header.strings_offset = alignTo8(header.options_offset + writer.options.size() * sizeof(uint32_t));
+  header.blob_offset = header.strings_offset + writer.strings.size() * sizeof(RigModelIndexString);
+
+  // Written beside the target and renamed over it, so a reader never maps
+  // a half-written index.
+  const std::string temporary = path + ".tmp";
+  std::FILE* file = std::fopen(temporary.c_str(), "wb");
+  if (!file) {
+    *error = "Unable to create " + temporary;
+    return false;
+  }
+  const uint64_t optionsEnd = header.options_offset + writer.options.size() * sizeof(uint32_t);
+  bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+    && writeArray(file, writer.models)
+    && writeArray(file, writer.fields)
+    && writeArray(file, writer.options)
+    && writePadding(file, optionsEnd, header.strings_offset)
+    && writeArray(file, writer.strings)
+    && std::fwrite(writer.blob.data(), 1, writer.blob.size(), file) == writer.blob.size();
+  ok = std::fclose(file) == 0 && ok;
+  if (!ok) {
+    std::remove(temporary.c_str());
+    *error = "Unable to write " + temporary;
+    return false;
+  }
+#ifdef _WIN32
+  std::remove(path.c_str());
+#endif
+  if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    *error = "Unable to replace " + path;
+    return false;
+  }
+  stats->models = writer.models.size();
+  stats->bytes = header.blob_offset + writer.blob.size();
+  return true;
+}
+
+std::shared_ptr<const RigModelIndex> RigModelIndex::Open(const std::string& path, std::string* error) {
+  std::shared_ptr<RigModelIndex> index(new RigModelIndex(path));
+  if (!index->file_.Open(path, false, error)) {
+    return nullptr;
+  }
+  const uint64_t size = index->file_.Size(error);
+  if (size < kRigModelIndexHeaderBytes) {
+    if (error->empty()) {
+      *error = path + " is not a rig model index";
+    }
+    return nullptr;
+  }
+  if (!index->file_.Map(0, static_cast<size_t>(size), error) || !index->Validate(error)) {
+    return nullptr;
+  }
+  if (std::strcmp(index->HamlibVersion(), shim_rig_get_version()) != 0) {
+    *error = path + " was built for " + index->HamlibVersion() + ", not " + shim_rig_get_version();
+    return nullptr;
+  }
+  return index;
+}
+
+bool RigModelIndex::Validate(std::string* error) const {
+  const uint64_t size = file_.ViewLength();
+  const RigModelIndexHeader& h = header();
+  if (std::memcmp(h.magic, kIndexMagic, sizeof(kIndexMagic)) != 0 || h.header_bytes != kRigModelIndexHeaderBytes) {
+    *error = path_ + " is not a rig model index";
+    return false;
+  }
+  if (h.version != kRigModelIndexVersion) {
+    *error = path_ + " has index format " + std::to_string(h.version) + ", expected "
+      + std::to_string(kRigModelIndexVersion);
+    return false;
+  }
+  auto fits = [size](uint64_t offset, uint64_t count, uint64_t width) {
+    return offset % 8 == 0 && offset <= size && count <= (size - offset) / width;
+  };
+  if (!fits(h.models_offset, h.model_count, sizeof(RigModelIndexModel))
+      || !fits(h.fields_offset, h.field_count, sizeof(RigModelIndexField))
+      || !fits(h.options_offset, h.option_count, sizeof(uint32_t))
+      || !fits(h.strings_offset, h.string_count, sizeof(RigModelIndexString))
+      || h.blob_offset > size || h.hamlib_version >= h.string_count) {
+    *error = path_ + " is truncated or corrupt";
+    return false;
+  }
+  const uint64_t blobBytes = size - h.blob_offset;
+  const char* blob = reinterpret_cast<const char*>(file_.View() + h.blob_offset);
+  for (uint32_t i = 0; i < h.string_count; ++i) {
+    const RigModelIndexString& text = strings()[i];
+    if (static_cast<uint64_t>(text.offset) + text.length >= blobBytes || blob[text.offset + text.length] != '\0') {
+      *error = path_ + " has a corrupt string table";
+      return false;
+    }
+  }
+  auto validString = [&h](uint32_t id) { return id < h.string_count; };
+  for (uint32_t i = 0; i < h.model_count; ++i) {
+    const RigModelIndexModel& model = models()[i];
+    const bool stringsOk = validString(model.model_name) && validString(model.mfg_name)
+      && validString(model.version) && validString(model.status) && validString(model.rig_type)
+      && validString(model.port_type) && validString(model.serial_parity) && validString(model.serial_handshake);
+    const bool sorted = i == 0 || models()[i - 1].model < model.model;
+    if (!stringsOk || !sorted || model.first_field > h.field_count
+        || model.field_count > h.field_count - model.first_field) {
+      *error = path_ + " has a corrupt model table";
+      return false;
+    }
+  }
+  for (uint32_t i = 0; i < h.field_count; ++i) {
+    const RigModelIndexField& field = fields()[i];
+    if (!validString(field.name) || !validString(field.label) || !validString(field.tooltip)
+        || !validString(field.dflt) || field.first_option > h.option_count
+        || field.option_count > h.option_count - field.first_option) {
+      *error = path_ + " has a corrupt config schema table";
+      return false;
+    }
+  }
+  for (uint32_t i = 0; i < h.option_count; ++i) {
+    if (!validString(options()[i])) {
+      *error = path_ + " has a corrupt config schema table";
+      return false;
+    }
+  }
+  return true;
+}
+
+void RigModelIndex::Install(std::shared_ptr<const RigModelIndex> index) {
+  std::lock_guard<std::mutex> guard(installedMutex());
+  installedSlot() = std::move(index);
+}
+
+std::shared_ptr<const RigModelIndex> RigModelIndex::Installed() {
+  std::lock_guard<std::mutex> guard(installedMutex());
+  return installedSlot();
+}
+
+const RigModelIndexModel* RigModelIndex::models() const {
+  return reinterpret_cast<const RigModelIndexModel*>(file_.View() + header().models_offset);
+}
+
+const RigModelIndexField* RigModelIndex::fields() const {
+  return reinterpret_cast<const RigModelIndexField*>(file_.View() + header().fields_offset);
+}
+
+const uint32_t* RigModelIndex::options() const {
+  return reinterpret_cast<const uint32_t*>(file_.View() + header().options_offset);
+}
+
+const RigModelIndexString* RigModelIndex::strings() const {
+  return reinterpret_cast<const RigModelIndexString*>(file_.View() + header().strings_offset);
+}
+
+const char* RigModelIndex::String(uint32_t id) const {
+  return reinterpret_cast<const char*>(file_.View() + header().blob_offset + strings()[id].offset);
+}
+
+const RigModelIndexModel* RigModelIndex::Find(unsigned int model) const {
+  const RigModelIndexModel* begin = models();
+  const RigModelIndexModel* end = begin + header().model_count;
+  const RigModelIndexModel* found = std::lower_bound(begin, end, model,
+    [](const RigModelIndexModel& entry, unsigned int key) { return entry.model < key; });
+  if (found == end || found->model != model) {
+    return nullptr;
+  }
+  return found;
+}
+
+bool RigModelIndex::PortCaps(const RigModelIndexModel& model, shim_rig_port_caps_t* out) const {
+  if (!(model.flags & kRigModelIndexHasPortCaps)) {
+    return false;
+  }
+  std::memset(out, 0, sizeof(*out));
+  copyString(out->port_type, sizeof(out->port_type), String(model.port_type));
+  copyString(out->serial_parity, sizeof(out->serial_parity), String(model.serial_parity));
+  copyString(out->serial_handshake, sizeof(out->serial_handshake), String(model.serial_handshake));
+  out->serial_rate_min = model.serial_rate_min;
+  out->serial_rate_max = model.serial_rate_max;
+  out->serial_data_bits = model.serial_data_bits;
+  out->serial_stop_bits = model.serial_stop_bits;
+  out->write_delay = model.write_delay;
+  out->post_write_delay = model.post_write_delay;
+  out->timeout = model.timeout;
+  out->retry = model.retry;
+  return true;
+}
+
+int RigModelIndex::ForEachConfigParam(const RigModelIndexModel& model, shim_rig_cfg_cb_t callback, void* data) const {
+  if (!(model.flags & kRigModelIndexHasConfigSchema)) {
+    return SHIM_RIG_ENAVAIL;
+  }
+  shim_confparam_info_t info;
+  for (uint32_t i = 0; i < model.field_count; ++i) {
+    const RigModelIndexField& field = fields()[model.first_field + i];
+    std::memset(&info, 0, sizeof(info));
+    info.token = field.token;
+    copyString(info.name, sizeof(info.name), String(field.name));
+    copyString(info.label, sizeof(info.label), String(field.label));
+    copyString(info.tooltip, sizeof(info.tooltip), String(field.tooltip));
+    copyString(info.dflt, sizeof(info.dflt), String(field.dflt));
+    info.type = field.type;
+    info.numeric_min = field.numeric_min;
+    info.numeric_max = field.numeric_max;
+    info.numeric_step = field.numeric_step;
+    info.combo_count = static_cast<int>(std::min<uint32_t>(field.option_count, SHIM_CONF_COMBO_MAX));
+    for (int option = 0; option < info.combo_count; ++option) {
+      copyString(info.combo_options[option], sizeof(info.combo_options[option]),
+        String(options()[field.first_option + option]));
+    }
+    if (callback(&info, data) == 0) {
+      break;
+    }
+  }
+  return SHIM_RIG_OK;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "shim/hamlib_shim.h"
+#include "spectrum_recorder.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// On-disk layout (host byte order, little-endian on every supported target):
+//
+//   header         kRigModelIndexHeaderBytes
+//   models         model_count RigModelIndexModel, sorted by model
+//   fields         field_count RigModelIndexField (config schemas)
+//   options        option_count uint32_t string ids (combo options)
+//   strings        string_count RigModelIndexString
+//   blob           NUL-terminated UTF-8 strings
+//
+// Every string is stored once; ids index the strings table. The file is
+// written for one Hamlib version and refused by any other.
+constexpr size_t kRigModelIndexHeaderBytes = 80;
+constexpr uint32_t kRigModelIndexVersion = 1;
+
+struct RigModelIndexHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_bytes;
+  uint32_t model_count;
+  uint32_t field_count;
+  uint32_t option_count;
+  uint32_t string_count;
+  uint64_t models_offset;
+  uint64_t fields_offset;
+  uint64_t options_offset;
+  uint64_t strings_offset;
+  uint64_t blob_offset;
+  uint32_t hamlib_version;
+  uint32_t reserved;
+};
+
+// RigModelIndexModel::flags
+constexpr uint32_t kRigModelIndexHasPortCaps = 1u << 0;
+constexpr uint32_t kRigModelIndexHasConfigSchema = 1u << 1;
+
+struct RigModelIndexModel {
+  uint32_t model;
+  uint32_t model_name;
+  uint32_t mfg_name;
+  uint32_t version;
+  uint32_t status;
+  uint32_t rig_type;
+  uint32_t flags;
+  // shim_rig_port_caps_t
+  uint32_t port_type;
+  uint32_t serial_parity;
+  uint32_t serial_handshake;
+  int32_t serial_rate_min;
+  int32_t serial_rate_max;
+  int32_t serial_data_bits;
+  int32_t serial_stop_bits;
+  int32_t write_delay;
+  int32_t post_write_delay;
+  int32_t timeout;
+  int32_t retry;
+  uint32_t first_field;
+  uint32_t field_count;
+  uint32_t reserved[2];
+};
+
+struct RigModelIndexField {
+  int32_t token;
+  uint32_t name;
+  uint32_t label;
+  uint32_t tooltip;
+  uint32_t dflt;
+  int32_t type;
+  double numeric_min;
+  double numeric_max;
+  double numeric_step;
+  uint32_t first_option;
+  uint32_t option_count;
+};
+
+struct RigModelIndexString {
+  uint32_t offset;  // from blob_offset
+  uint32_t length;  // without the NUL
+};
+
+static_assert(sizeof(RigModelIndexHeader) == kRigModelIndexHeaderBytes, "index header layout");
+static_assert(sizeof(RigModelIndexModel) == 88, "index model layout");
+static_assert(sizeof(RigModelIndexField) == 56, "index field layout");
+static_assert(sizeof(RigModelIndexString) == 8, "index string layout");
+
+struct RigModelIndexBuildStats {
+  size_t models = 0;
+  // Models whose rig_init() failed; listed without port caps or schema.
+  size_t incomplete = 0;
+  uint64_t bytes = 0;
+};
+
+// A memory-mapped, prebuilt table of every rig model with its port caps and
+// config schema, so model lookups at startup need no backend initialisation.
+// Open() checks every offset once; lookups afterwards only read the view.
+class RigModelIndex {
+public:
+    // Enumerates every backend and writes the index for the running Hamlib,
+    // replacing `path` only once the new file is complete. `metadata_mutex`
+    // guards Hamlib's global backend state for the whole build.
+    static bool Build(const std::string& path, std::mutex& metadata_mutex, RigModelIndexBuildStats* stats,
+                      std::string* error);
+    // Null with `error` set if the file is unreadable, malformed or built
+    // for another Hamlib version.
+    static std::shared_ptr<const RigModelIndex> Open(const std::string& path, std::string* error);
+
+    // The index answering lookups for the process, or null. Thread-safe.
+    static void Install(std::shared_ptr<const RigModelIndex> index);
+    static std::shared_ptr<const RigModelIndex> Installed();
+
+    RigModelIndex(const RigModelIndex&) = delete;
+    RigModelIndex& operator=(const RigModelIndex&) = delete;
+
+    const std::string& Path() const { return path_; }
+    uint64_t Bytes() const { return file_.ViewLength(); }
+    size_t ModelCount() const { return header().model_count; }
+    const RigModelIndexModel& Model(size_t index) const { return models()[index]; }
+    // Null for an unknown model.
+    const RigModelIndexModel* Find(unsigned int model) const;
+    const char* String(uint32_t id) const;
+    const char* HamlibVersion() const { return String(header().hamlib_version); }
+
+    // False when the index could not record them for this model.
+    bool PortCaps(const RigModelIndexModel& model, shim_rig_port_caps_t* out) const;
+    // Replays the schema through the shim_rig_cfgparams_foreach() callback;
+    // SHIM_RIG_ENAVAIL when the index has none for this model.
+    int ForEachConfigParam(const RigModelIndexModel& model, shim_rig_cfg_cb_t callback, void* data) const;
+
+private:
+    explicit RigModelIndex(std::string path) : path_(std::move(path)) {}
+    bool Validate(std::string* error) const;
+
+    const RigModelIndexHeader& header() const {
+        return *reinterpret_cast<const RigModelIndexHeader*>(file_.View());
+    }
+    const RigModelIndexModel* models() const;
+    const RigModelIndexField* fields() const;
+    const uint32_t* options() const;
+    const RigModelIndexString* strings() const;
+
+    std::string path_;
+    MappedFile file_;
+};
@@ -0,0 +1,134 @@
+#include "rig_priority.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// How long a lower class sits in try_lock_for before re-checking for higher
+// waiters; bounds how long it can race a realtime command for the mutex.
+constexpr std::chrono::milliseconds kLowerPrioritySlice(2);
+
+}  // namespace
+
+const char* rigCommandPriorityName(RigCommandPriority priority) {
+  switch (priority) {
+    case RigCommandPriority::Realtime:
+      return "realtime";
+    case RigCommandPriority::Background:
+      return "background";
+    case RigCommandPriority::Interactive:
+    default:
+      return "interactive";
+  }
+}
+
+bool parseRigCommandPriority(const std::string& value, RigCommandPriority* priority) {
+  if (value == "realtime") {
+    *priority = RigCommandPriority::Realtime;
+  } else if (value == "interactive") {
+    *priority = RigCommandPriority::Interactive;
+  } else if (value == "background") {
+    *priority = RigCommandPriority::Background;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+RigLockArbiter& RigLockArbiter::Global() {
+  static RigLockArbiter arbiter;
+  return arbiter;
+}
+
+void RigLockArbiter::Enter(const void* mutex, RigCommandPriority priority) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto entry = std::find_if(waiting_.begin(), waiting_.end(),
+    [mutex](const Waiters& waiters) { return waiters.mutex == mutex; });
+  if (entry == waiting_.end()) {
+    Waiters waiters;
+    waiters.mutex = mutex;
+    waiting_.push_back(waiters);
+    entry = waiting_.end() - 1;
+  }
+  ++entry->count[static_cast<size_t>(priority)];
+}
+
+void RigLockArbiter::Leave(const void* mutex, RigCommandPriority priority) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto entry = std::find_if(waiting_.begin(), waiting_.end(),
+      [mutex](const Waiters& waiters) { return waiters.mutex == mutex; });
+    if (entry != waiting_.end()) {
+      --entry->count[static_cast<size_t>(priority)];
+      // Drop the entry with its last waiter so waiting_ only lists contended
+      // mutexes.
+      if (std::all_of(std::begin(entry->count), std::end(entry->count), [](int count) { return count == 0; })) {
+        *entry = waiting_.back();
+        waiting_.pop_back();
+      }
+    }
+  }
+  cv_.notify_all();
+}
+
+bool RigLockArbiter::AnyWaiting(const void* mutex) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return std::any_of(waiting_.begin(), waiting_.end(),
+    [mutex](const Waiters& waiters) { return waiters.mutex == mutex; });
+}
+
+bool RigLockArbiter::HigherWaitingLocked(const void* mutex, RigCommandPriority priority) const {
+  for (const Waiters& waiters : waiting_) {
+    if (waiters.mutex != mutex) {
+      continue;
+    }
+    for (size_t i = 0; i < static_cast<size_t>(priority); ++i) {
+      if (waiters.count[i] > 0) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool RigLockArbiter::Acquire(std::unique_lock<std::timed_mutex>& lock, std::chrono::milliseconds timeout,
+                             RigCommandPriority priority) {
+  if (timeout.count() <= 0) {
+    return lock.try_lock();
+  }
+  // Uncontended: skip the bookkeeping. With waiters queued, a newcomer goes
+  // through the arbitration below instead of racing them for the mutex.
+  const void* key = lock.mutex();
+  if (!AnyWaiting(key) && lock.try_lock()) {
+    return true;
+  }
+
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point deadline = Clock::now() + timeout;
+  Enter(key, priority);
+  bool acquired = false;
+  for (;;) {
+    if (priority != RigCommandPriority::Realtime) {
+      std::unique_lock<std::mutex> guard(mutex_);
+      if (!cv_.wait_until(guard, deadline, [&]() { return !HigherWaitingLocked(key, priority); })) {
+        break;
+      }
+    }
+    const Clock::time_point now = Clock::now();
+    if (now >= deadline) {
+      acquired = lock.try_lock();
+      break;
+    }
+    auto slice = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now) + std::chrono::milliseconds(1);
+    if (priority != RigCommandPriority::Realtime) {
+      slice = std::min(slice, kLowerPrioritySlice);
+    }
+    if (lock.try_lock_for(slice)) {
+      acquired = true;
+      break;
+    }
+  }
+  Leave(key, priority);
+  return acquired;
+}
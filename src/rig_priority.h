@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Scheduling class of a native command. Lower values go first.
+//   Realtime    - keying: PTT, CW send/stop
+//   Interactive - operator actions (default)
+//   Background  - meter polls; may be shed when a rig is over budget
+enum class RigCommandPriority {
+  Realtime = 0,
+  Interactive = 1,
+  Background = 2,
+};
+
+constexpr size_t kRigPriorityCount = 3;
+
+const char* rigCommandPriorityName(RigCommandPriority priority);
+bool parseRigCommandPriority(const std::string& value, RigCommandPriority* priority);
+
+// Orders threads waiting for the same rig mutex by priority: a waiter only
+// competes for the mutex while nobody of a higher class waits for it, so a
+// PTT-off does not queue behind meter reads. A command already holding the
+// mutex is never interrupted.
+class RigLockArbiter {
+public:
+    static RigLockArbiter& Global();
+
+    // Acquires the (deferred) lock within `timeout`. A zero timeout is a
+    // plain try_lock.
+    bool Acquire(std::unique_lock<std::timed_mutex>& lock, std::chrono::milliseconds timeout,
+                 RigCommandPriority priority);
+
+private:
+    struct Waiters {
+        const void* mutex = nullptr;
+        int count[kRigPriorityCount] = {};
+    };
+
+    void Enter(const void* mutex, RigCommandPriority priority);
+    void Leave(const void* mutex, RigCommandPriority priority);
+    bool AnyWaiting(const void* mutex);
+    bool HigherWaitingLocked(const void* mutex, RigCommandPriority priority) const;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    // One entry per mutex with waiters; a handful at most.
+    std::vector<Waiters> waiting_;
+};
@@ -0,0 +1,205 @@
+#include "rig_state_cache.h"
+
+#include "shim/hamlib_shim.h"
+
+#include <algorithm>
+
+void RigStateCache::Enable(uint32_t max_age_ms) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  max_age_ms_ = max_age_ms;
+  enabled_.store(true, std::memory_order_release);
+}
+
+void RigStateCache::Disable() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  enabled_.store(false, std::memory_order_release);
+  frequencies_.clear();
+  modes_.clear();
+  has_vfo_ = false;
+}
+
+RigStateCache::Entry* RigStateCache::FindLocked(std::vector<Entry>& entries, int vfo) {
+  for (Entry& entry : entries) {
+    if (entry.vfo == vfo) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+void RigStateCache::PutLocked(std::vector<Entry>& entries, const Entry& entry) {
+  if (Entry* existing = FindLocked(entries, entry.vfo)) {
+    *existing = entry;
+  } else {
+    entries.push_back(entry);
+  }
+}
+
+void RigStateCache::EraseLocked(std::vector<Entry>& entries, int vfo) {
+  entries.erase(std::remove_if(entries.begin(), entries.end(),
+    [vfo](const Entry& entry) { return entry.vfo == vfo; }), entries.end());
+}
+
+template <typename Apply>
+void RigStateCache::StoreLocked(std::vector<Entry>& entries, int vfo, Apply apply) {
+  const Clock::time_point now = Clock::now();
+  auto put = [&](int key) {
+    Entry entry;
+    if (Entry* existing = FindLocked(entries, key)) {
+      entry = *existing;
+    }
+    entry.vfo = key;
+    apply(entry);
+    entry.at = now;
+    PutLocked(entries, entry);
+  };
+  put(vfo);
+  if (vfo == SHIM_RIG_VFO_CURR) {
+    if (has_vfo_) {
+      put(vfo_);
+    }
+  } else if (has_vfo_ && vfo_ == vfo) {
+    put(SHIM_RIG_VFO_CURR);
+  } else if (!has_vfo_) {
+    // `vfo` may be the current one; the alias can no longer be trusted.
+    EraseLocked(entries, SHIM_RIG_VFO_CURR);
+  }
+  ++updates_;
+}
+
+void RigStateCache::StoreFrequency(int vfo, double frequency) {
+  if (!Enabled()) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  StoreLocked(frequencies_, vfo, [frequency](Entry& entry) { entry.frequency = frequency; });
+}
+
+void RigStateCache::StoreMode(int vfo, int mode, int width) {
+  if (!Enabled()) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (width > 0) {
+    StoreLocked(modes_, vfo, [mode, width](Entry& entry) {
+      entry.mode = mode;
+      entry.width = width;
+    });
+    return;
+  }
+  EraseLocked(modes_, vfo);
+  if (vfo == SHIM_RIG_VFO_CURR) {
+    if (has_vfo_) {
+      EraseLocked(modes_, vfo_);
+    }
+  } else {
+    EraseLocked(modes_, SHIM_RIG_VFO_CURR);
+  }
+  ++invalidations_;
+}
+
+void RigStateCache::StoreVfo(int vfo) {
+  if (!Enabled()) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!has_vfo_ || vfo_ != vfo) {
+    // The current-VFO alias now means `vfo`; carry over what is known of it.
+    for (std::vector<Entry>* entries : { &frequencies_, &modes_ }) {
+      EraseLocked(*entries, SHIM_RIG_VFO_CURR);
+      if (Entry* known = FindLocked(*entries, vfo)) {
+        Entry alias = *known;
+        alias.vfo = SHIM_RIG_VFO_CURR;
+        entries->push_back(alias);
+      }
+    }
+  }
+  has_vfo_ = true;
+  vfo_ = vfo;
+  vfo_at_ = Clock::now();
+  ++updates_;
+}
+
+void RigStateCache::Invalidate() {
+  if (!Enabled()) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  frequencies_.clear();
+  modes_.clear();
+  has_vfo_ = false;
+  ++invalidations_;
+}
+
+int64_t RigStateCache::MaxAgeLocked(int64_t requested) const {
+  return requested < 0 ? static_cast<int64_t>(max_age_ms_) : requested;
+}
+
+bool RigStateCache::FreshLocked(const Entry* entry, int64_t max_age_ms, Clock::time_point now) {
+  if (!entry) {
+    ++misses_;
+    return false;
+  }
+  if (now - entry->at > std::chrono::milliseconds(max_age_ms)) {
+    ++misses_;
+    ++stale_;
+    return false;
+  }
+  ++hits_;
+  return true;
+}
+
+bool RigStateCache::LookupFrequency(int vfo, int64_t max_age_ms, double* frequency) {
+  if (!Enabled()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  Entry* entry = FindLocked(frequencies_, vfo);
+  if (!FreshLocked(entry, MaxAgeLocked(max_age_ms), Clock::now())) {
+    return false;
+  }
+  *frequency = entry->frequency;
+  return true;
+}
+
+bool RigStateCache::LookupMode(int vfo, int64_t max_age_ms, int* mode, int* width) {
+  if (!Enabled()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  Entry* entry = FindLocked(modes_, vfo);
+  if (!FreshLocked(entry, MaxAgeLocked(max_age_ms), Clock::now())) {
+    return false;
+  }
+  *mode = entry->mode;
+  *width = entry->width;
+  return true;
+}
+
+bool RigStateCache::LookupVfo(int64_t max_age_ms, int* vfo) {
+  if (!Enabled()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  Entry current;
+  current.vfo = vfo_;
+  current.at = vfo_at_;
+  if (!FreshLocked(has_vfo_ ? &current : nullptr, MaxAgeLocked(max_age_ms), Clock::now())) {
+    return false;
+  }
+  *vfo = vfo_;
+  return true;
+}
+
+RigStateCacheStats RigStateCache::GetStats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  RigStateCacheStats stats;
+  stats.enabled = enabled_.load(std::memory_order_acquire);
+  stats.max_age_ms = max_age_ms_;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.stale = stale_;
+  stats.updates = updates_;
+  stats.invalidations = invalidations_;
+  return stats;
+}
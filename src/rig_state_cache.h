@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+struct RigStateCacheStats {
+  bool enabled = false;
+  uint32_t max_age_ms = 0;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  // Misses where a value was cached but older than the allowed age.
+  uint64_t stale = 0;
+  uint64_t updates = 0;
+  uint64_t invalidations = 0;
+};
+
+// Last known frequency, mode and VFO of one rig, filled by successful get/set
+// calls, poll reads and transceive events. Entries are keyed by the VFO the
+// value was read or written with; values for SHIM_RIG_VFO_CURR are mirrored
+// to and from the current VFO when that is known. Thread-safe.
+class RigStateCache {
+public:
+    static constexpr uint32_t kDefaultMaxAgeMs = 250;
+
+    void Enable(uint32_t max_age_ms);
+    // Disables and forgets every entry; counters are kept.
+    void Disable();
+    bool Enabled() const { return enabled_.load(std::memory_order_acquire); }
+
+    // Store* calls are ignored while disabled.
+    void StoreFrequency(int vfo, double frequency);
+    // A width <= 0 (normal / no-change passband) is not known afterwards, so
+    // the mode entry is dropped instead.
+    void StoreMode(int vfo, int mode, int width);
+    void StoreVfo(int vfo);
+    void Invalidate();
+
+    // A negative max_age_ms uses the configured default. Counts a hit or miss.
+    bool LookupFrequency(int vfo, int64_t max_age_ms, double* frequency);
+    bool LookupMode(int vfo, int64_t max_age_ms, int* mode, int* width);
+    bool LookupVfo(int64_t max_age_ms, int* vfo);
+
+    RigStateCacheStats GetStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+      int vfo = 0;
+      double frequency = 0;
+      int mode = 0;
+      int width = 0;
+      Clock::time_point at;
+    };
+
+    Entry* FindLocked(std::vector<Entry>& entries, int vfo);
+    void PutLocked(std::vector<Entry>& entries, const Entry& entry);
+    void EraseLocked(std::vector<Entry>& entries, int vfo);
+    // Applies a store for `vfo` to the current-VFO alias as well.
+    template <typename Apply>
+    void StoreLocked(std::vector<Entry>& entries, int vfo, Apply apply);
+    bool FreshLocked(const Entry* entry, int64_t max_age_ms, Clock::time_point now);
+    int64_t MaxAgeLocked(int64_t requested) const;
+
+    std::atomic<bool> enabled_{false};
+    mutable std::mutex mutex_;
+    uint32_t max_age_ms_ = kDefaultMaxAgeMs;
+    std::vector<Entry> frequencies_;
+    std::vector<Entry> modes_;
+    bool has_vfo_ = false;
+    int vfo_ = 0;
+    Clock::time_point vfo_at_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t stale_ = 0;
+    uint64_t updates_ = 0;
+    uint64_t invalidations_ = 0;
+};
@@ -0,0 +1,203 @@
+#include "rig_sweep.h"
+
+#include "hamlib.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+// Putting the frequency back is skipped rather than waited for long.
+constexpr std::chrono::milliseconds kRestoreLockTimeout(100);
+// A chunk gives the rig lock up after this long even with bins left, once it
+// has measured at least one.
+constexpr std::chrono::milliseconds kMaxSweepLockHold(100);
+
+unsigned char strengthToLevel(int strength_db, const SweepOptions& options) {
+  const double fraction = (strength_db - options.strength_min_db)
+    / (options.strength_max_db - options.strength_min_db);
+  return static_cast<unsigned char>(std::min(255.0, std::max(0.0, fraction * 255.0 + 0.5)));
+}
+
+}  // namespace
+
+RigSweep::RigSweep(NodeHamLib* rig, SweepOptions options)
+  : RigBackgroundJob(rig), options_(std::move(options)) {}
+
+RigSweep::~RigSweep() {
+  Stop();
+}
+
+void RigSweep::Start(Napi::Env env, Napi::Function callback) {
+  StartThread(env, callback, "HamLibSweep");
+}
+
+void RigSweep::Stop() {
+  StopThread();
+}
+
+SweepStats RigSweep::GetStats() const {
+  SweepStats stats;
+  stats.running = Running();
+  stats.points = options_.points;
+  stats.sweeps = sweeps_.load(std::memory_order_relaxed);
+  stats.readings = readings_.load(std::memory_order_relaxed);
+  stats.errors = errors_.load(std::memory_order_relaxed);
+  stats.unsent_lines = unsent_lines_.load(std::memory_order_relaxed);
+  stats.last_sweep_ms = last_sweep_ms_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void RigSweep::ThreadMain() {
+  RigLockScopeUse scopeUse;
+  using Clock = std::chrono::steady_clock;
+  End end;
+  end.reason = "stopped";
+  const size_t chunk = std::max<size_t>(1, options_.chunk_points);
+
+  shim_spectrum_line_t line;
+  std::memset(&line, 0, sizeof(line));
+  line.id = options_.scope_id;
+  line.data_level_min = 0;
+  line.data_level_max = 255;
+  line.signal_strength_min = options_.strength_min_db;
+  line.signal_strength_max = options_.strength_max_db;
+  line.spectrum_mode = SHIM_RIG_SPECTRUM_MODE_FIXED;
+  line.low_edge_freq = options_.start_hz;
+  line.high_edge_freq = options_.start_hz + options_.step_hz * static_cast<double>(options_.points - 1);
+  line.center_freq = (line.low_edge_freq + line.high_edge_freq) / 2;
+  line.span_freq = line.high_edge_freq - line.low_edge_freq;
+  line.data_length = static_cast<int>(options_.points);
+
+  bool finished = false;
+  while (!finished) {
+    const Clock::time_point started = Clock::now();
+    size_t measured = 0;
+    int lastError = SHIM_RIG_OK;
+    for (size_t first = 0; first < options_.points;) {
+      GlobalRigLock rigLock;
+      if (!AcquireRigLock(&rigLock)) {
+        finished = true;
+        break;
+      }
+      if (!rig_->my_rig || !rig_->rig_is_open.load(std::memory_order_acquire)) {
+        end.reason = "closed";
+        finished = true;
+        break;
+      }
+      if (options_.restore_frequency && !has_original_) {
+        has_original_ = shim_rig_get_freq(rig_->my_rig, options_.vfo, &original_hz_) == SHIM_RIG_OK;
+      }
+      if (!RunChunk(first, std::min(first + chunk, options_.points), &line, &measured, &lastError, &first)) {
+        finished = true;
+        break;
+      }
+    }
+    if (finished) {
+      break;
+    }
+
+    last_sweep_ms_.store(std::chrono::duration<double, std::milli>(Clock::now() - started).count(),
+                         std::memory_order_relaxed);
+    if (measured == 0) {
+      end.reason = "error";
+      end.result_code = lastError;
+      break;
+    }
+    if (rig_->spectrum_stream_running_.load(std::memory_order_acquire)) {
+      rig_->EmitSpectrumLine(line);
+    } else {
+      unsent_lines_.fetch_add(1, std::memory_order_relaxed);
+    }
+    const uint64_t sweeps = sweeps_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (options_.sweeps > 0 && sweeps >= options_.sweeps) {
+      end.reason = "complete";
+      break;
+    }
+  }
+
+  if (end.reason != "closed") {
+    RestoreFrequency();
+  }
+  if (end.reason != "stopped") {
+    end.timestamp = rigEpochMillis();
+    EmitEnd(end);
+  }
+  Finish();
+}
+
+bool RigSweep::RunChunk(size_t first, size_t last, shim_spectrum_line_t* line, size_t* measured,
+                        int* last_error, size_t* next) {
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point holdUntil = Clock::now() + kMaxSweepLockHold;
+  for (size_t i = first; i < last; ++i) {
+    if (Stopping()) {
+      return false;
+    }
+    if (i > first && Clock::now() >= holdUntil) {
+      *next = i;
+      return true;
+    }
+    const double frequency = options_.start_hz + options_.step_hz * static_cast<double>(i);
+    int code = shim_rig_set_freq(rig_->my_rig, options_.vfo, frequency);
+    if (code == SHIM_RIG_OK) {
+      rig_->state_cache_.StoreFrequency(options_.vfo, frequency);
+      if (options_.dwell.count() > 0) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (cv_.wait_for(lock, options_.dwell, [this]() { return stopping_; })) {
+          return false;
+        }
+      }
+      int strength = 0;
+      code = shim_rig_get_level_i(rig_->my_rig, options_.vfo, SHIM_RIG_LEVEL_STRENGTH, &strength);
+      if (code == SHIM_RIG_OK) {
+        line->data[i] = strengthToLevel(strength, options_);
+        readings_.fetch_add(1, std::memory_order_relaxed);
+        ++*measured;
+        continue;
+      }
+    }
+    line->data[i] = 0;
+    *last_error = code;
+    errors_.fetch_add(1, std::memory_order_relaxed);
+  }
+  *next = last;
+  return !Stopping();
+}
+
+void RigSweep::RestoreFrequency() {
+  if (!has_original_) {
+    return;
+  }
+  auto rigLock = rig_->TryAcquireRigLockIfEnabled(kRestoreLockTimeout);
+  if (!rigLock.owns_lock() && NodeHamLib::IsGlobalRigLockEnabled()) {
+    return;
+  }
+  if (rig_->my_rig && rig_->rig_is_open.load(std::memory_order_acquire)
+      && shim_rig_set_freq(rig_->my_rig, options_.vfo, original_hz_) == SHIM_RIG_OK) {
+    rig_->state_cache_.StoreFrequency(options_.vfo, original_hz_);
+  }
+  has_original_ = false;
+}
+
+void RigSweep::EmitEnd(const End& end) {
+  Post(new End(end), [this](Napi::Env env, Napi::Function callback, End* data) {
+    Deliver(env, callback, *data);
+  });
+}
+
+void RigSweep::Deliver(Napi::Env env, Napi::Function callback, const End& end) {
+  Napi::HandleScope scope(env);
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("type", Napi::String::New(env, "end"));
+  obj.Set("reason", Napi::String::New(env, end.reason));
+  obj.Set("sweeps", Napi::Number::New(env, static_cast<double>(sweeps_.load(std::memory_order_relaxed))));
+  obj.Set("timestamp", Napi::Number::New(env, end.timestamp));
+  if (end.reason == "error") {
+    obj.Set("code", Napi::String::New(env, "HAMLIB_ERROR"));
+    obj.Set("hamlibCode", Napi::Number::New(env, end.result_code));
+    obj.Set("message", Napi::String::New(env, shim_rigerror(end.result_code)));
+  }
+  callback.Call({ obj });
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "rig_background_job.h"
+#include "shim/hamlib_shim.h"
+#include <napi.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+class NodeHamLib;
+
+struct SweepOptions {
+  double start_hz = 0;
+  double step_hz = 0;
+  // Bins per line; at most the payload of one shim_spectrum_line_t.
+  size_t points = 0;
+  int vfo = SHIM_RIG_VFO_CURR;
+  // Time between tuning a bin and reading its strength.
+  std::chrono::milliseconds dwell{0};
+  // Most bins measured per rig lock hold.
+  size_t chunk_points = 16;
+  // Sweeps to run; 0 repeats until stopped.
+  uint64_t sweeps = 0;
+  int scope_id = 0;
+  // STRENGTH (dB relative to S9) mapped onto the 0..255 bin values.
+  double strength_min_db = -54;
+  double strength_max_db = 60;
+  bool restore_frequency = true;
+};
+
+struct SweepStats {
+  bool running = false;
+  size_t points = 0;
+  uint64_t sweeps = 0;
+  uint64_t readings = 0;
+  // Bins whose tune or strength read failed; they hold the lowest level.
+  uint64_t errors = 0;
+  // Lines dropped because no spectrum stream was running to take them.
+  uint64_t unsent_lines = 0;
+  double last_sweep_ms = 0;
+};
+
+// Builds a pseudo-bandscope for rigs without a hardware scope: on its own
+// thread each bin is tuned with shim_rig_set_freq() and measured with the
+// STRENGTH level, and every finished sweep goes into the rig's spectrum
+// stream through EmitSpectrumLine() as one fixed-mode line. Processing,
+// recording, batching and the startSpectrumStream() callback then see it
+// like a line from a hardware scope.
+//
+// The rig lock is held for at most chunk_points bins, and given up sooner
+// once a hold has lasted 100 ms, so other commands run between chunks; the
+// dwell of the bin being measured still counts against the hold. The rig's frequency is put back
+// when the job ends. It ends by itself after `sweeps` sweeps ("complete"),
+// when a sweep measured no bin at all ("error") or when the rig is closed
+// ("closed").
+class RigSweep : public RigBackgroundJob {
+public:
+    RigSweep(NodeHamLib* rig, SweepOptions options);
+    ~RigSweep() override;
+
+    // JS thread.
+    void Start(Napi::Env env, Napi::Function callback);
+    // JS thread. Joins the loop; a bin already being measured finishes first.
+    // No end event is delivered for a stopped sweep.
+    void Stop();
+    SweepStats GetStats() const;
+
+private:
+    struct End {
+        std::string reason;
+        int result_code = 0;
+        double timestamp = 0;
+    };
+
+    void ThreadMain() override;
+    // Measures bins from `first` up to `last` into `line` and sets `next` to
+    // the first bin left unmeasured; false once the job is stopping.
+    bool RunChunk(size_t first, size_t last, shim_spectrum_line_t* line, size_t* measured, int* last_error,
+                  size_t* next);
+    void RestoreFrequency();
+    void EmitEnd(const End& end);
+    // JS thread.
+    void Deliver(Napi::Env env, Napi::Function callback, const End& end);
+
+    const SweepOptions options_;
+
+    // Loop thread only.
+    bool has_original_ = false;
+    double original_hz_ = 0;
+
+    std::atomic<uint64_t> sweeps_{0};
+    std::atomic<uint64_t> readings_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::atomic<uint64_t> unsent_lines_{0};
+    std::atomic<double> last_sweep_ms_{0};
+};
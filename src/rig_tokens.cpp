@@ -0,0 +1,209 @@
+#include "rig_tokens.h"
+
+#include <cstring>
+
+namespace {
+
+// Each table is sorted by name (byte order) for binary search; the
+// static_asserts below reject an out-of-order edit at compile time.
+constexpr RigTokenEntry kLevelTokens[] = {
+  {"AF", SHIM_RIG_LEVEL_AF},
+  {"AGC", SHIM_RIG_LEVEL_AGC},
+  {"ALC", SHIM_RIG_LEVEL_ALC},
+  {"ANTIVOX", SHIM_RIG_LEVEL_ANTIVOX},
+  {"APF", SHIM_RIG_LEVEL_APF},
+  {"ATT", SHIM_RIG_LEVEL_ATT},
+  {"BALANCE", SHIM_RIG_LEVEL_BALANCE},
+  {"BKINDL", SHIM_RIG_LEVEL_BKINDL},
+  {"COMP", SHIM_RIG_LEVEL_COMP},
+  {"COMP_METER", SHIM_RIG_LEVEL_COMP_METER},
+  {"CWPITCH", SHIM_RIG_LEVEL_CWPITCH},
+  {"ID_METER", SHIM_RIG_LEVEL_ID_METER},
+  {"IF", SHIM_RIG_LEVEL_IF},
+  {"KEYSPD", SHIM_RIG_LEVEL_KEYSPD},
+  {"MICGAIN", SHIM_RIG_LEVEL_MICGAIN},
+  {"MONITOR_GAIN", SHIM_RIG_LEVEL_MONITOR_GAIN},
+  {"NOTCHF", SHIM_RIG_LEVEL_NOTCHF},
+  {"NR", SHIM_RIG_LEVEL_NR},
+  {"PBT_IN", SHIM_RIG_LEVEL_PBT_IN},
+  {"PBT_OUT", SHIM_RIG_LEVEL_PBT_OUT},
+  {"PREAMP", SHIM_RIG_LEVEL_PREAMP},
+  {"RAWSTR", SHIM_RIG_LEVEL_RAWSTR},
+  {"RF", SHIM_RIG_LEVEL_RF},
+  {"RFPOWER", SHIM_RIG_LEVEL_RFPOWER},
+  {"RFPOWER_METER", SHIM_RIG_LEVEL_RFPOWER_METER},
+  {"RFPOWER_METER_WATTS", SHIM_RIG_LEVEL_RFPOWER_METER_WATTS},
+  {"SPECTRUM_ATT", SHIM_RIG_LEVEL_SPECTRUM_ATT},
+  {"SPECTRUM_AVG", SHIM_RIG_LEVEL_SPECTRUM_AVG},
+  {"SPECTRUM_EDGE_HIGH", SHIM_RIG_LEVEL_SPECTRUM_EDGE_HIGH},
+  {"SPECTRUM_EDGE_LOW", SHIM_RIG_LEVEL_SPECTRUM_EDGE_LOW},
+  {"SPECTRUM_MODE", SHIM_RIG_LEVEL_SPECTRUM_MODE},
+  {"SPECTRUM_REF", SHIM_RIG_LEVEL_SPECTRUM_REF},
+  {"SPECTRUM_SPAN", SHIM_RIG_LEVEL_SPECTRUM_SPAN},
+  {"SPECTRUM_SPEED", SHIM_RIG_LEVEL_SPECTRUM_SPEED},
+  {"SQL", SHIM_RIG_LEVEL_SQL},
+  {"STRENGTH", SHIM_RIG_LEVEL_STRENGTH},
+  {"SWR", SHIM_RIG_LEVEL_SWR},
+  {"TEMP_METER", SHIM_RIG_LEVEL_TEMP_METER},
+  {"VD_METER", SHIM_RIG_LEVEL_VD_METER},
+  {"VOXDELAY", SHIM_RIG_LEVEL_VOXDELAY},
+  {"VOXGAIN", SHIM_RIG_LEVEL_VOXGAIN},
+};
+
+constexpr RigTokenEntry kFunctionTokens[] = {
+  {"ABM", SHIM_RIG_FUNC_ABM},
+  {"AFC", SHIM_RIG_FUNC_AFC},
+  {"AIP", SHIM_RIG_FUNC_AIP},
+  {"ANF", SHIM_RIG_FUNC_ANF},
+  {"APF", SHIM_RIG_FUNC_APF},
+  {"BC", SHIM_RIG_FUNC_BC},
+  {"COMP", SHIM_RIG_FUNC_COMP},
+  {"FAGC", SHIM_RIG_FUNC_FAGC},
+  {"FBKIN", SHIM_RIG_FUNC_FBKIN},
+  {"LOCK", SHIM_RIG_FUNC_LOCK},
+  {"MBC", SHIM_RIG_FUNC_MBC},
+  {"MUTE", SHIM_RIG_FUNC_MUTE},
+  {"NB", SHIM_RIG_FUNC_NB},
+  {"NR", SHIM_RIG_FUNC_NR},
+  {"RESUME", SHIM_RIG_FUNC_RESUME},
+  {"REV", SHIM_RIG_FUNC_REV},
+  {"RIT", SHIM_RIG_FUNC_RIT},
+  {"SATMODE", SHIM_RIG_FUNC_SATMODE},
+  {"SBKIN", SHIM_RIG_FUNC_SBKIN},
+  {"SCOPE", SHIM_RIG_FUNC_SCOPE},
+  {"SPECTRUM", SHIM_RIG_FUNC_SPECTRUM},
+  {"SPECTRUM_HOLD", SHIM_RIG_FUNC_SPECTRUM_HOLD},
+  {"SQL", SHIM_RIG_FUNC_SQL},
+  {"TBURST", SHIM_RIG_FUNC_TBURST},
+  {"TONE", SHIM_RIG_FUNC_TONE},
+  {"TRANSCEIVE", SHIM_RIG_FUNC_TRANSCEIVE},
+  {"TSQL", SHIM_RIG_FUNC_TSQL},
+  {"TUNER", SHIM_RIG_FUNC_TUNER},
+  {"VOX", SHIM_RIG_FUNC_VOX},
+  {"VSC", SHIM_RIG_FUNC_VSC},
+  {"XIT", SHIM_RIG_FUNC_XIT},
+};
+
+constexpr RigTokenEntry kParmTokens[] = {
+  {"ANN", SHIM_RIG_PARM_ANN},
+  {"APO", SHIM_RIG_PARM_APO},
+  {"BACKLIGHT", SHIM_RIG_PARM_BACKLIGHT},
+  {"BAT", SHIM_RIG_PARM_BAT},
+  {"BEEP", SHIM_RIG_PARM_BEEP},
+  {"KEYLIGHT", SHIM_RIG_PARM_KEYLIGHT},
+  {"SCREENSAVER", SHIM_RIG_PARM_SCREENSAVER},
+  {"TIME", SHIM_RIG_PARM_TIME},
+};
+
+constexpr int compareTokenNames(const char* left, const char* right) {
+  while (*left != '\0' && *left == *right) {
+    ++left;
+    ++right;
+  }
+  return static_cast<unsigned char>(*left) - static_cast<unsigned char>(*right);
+}
+
+template <size_t N>
+constexpr bool tokenTableSorted(const RigTokenEntry (&table)[N]) {
+  for (size_t i = 1; i < N; ++i) {
+    if (compareTokenNames(table[i - 1].name, table[i].name) >= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(tokenTableSorted(kLevelTokens), "kLevelTokens must be sorted by name");
+static_assert(tokenTableSorted(kFunctionTokens), "kFunctionTokens must be sorted by name");
+static_assert(tokenTableSorted(kParmTokens), "kParmTokens must be sorted by name");
+
+// Handles are (kind << 16) | (table index + 1), so 0 is never valid.
+constexpr uint32_t kHandleIndexMask = 0xffff;
+constexpr int kHandleKindShift = 16;
+
+struct TokenTable {
+  const RigTokenEntry* entries;
+  size_t count;
+};
+
+template <size_t N>
+constexpr TokenTable tableOf(const RigTokenEntry (&table)[N]) {
+  return TokenTable{table, N};
+}
+
+TokenTable tableFor(RigTokenKind kind) {
+  switch (kind) {
+    case RigTokenKind::Level: return tableOf(kLevelTokens);
+    case RigTokenKind::Function: return tableOf(kFunctionTokens);
+    case RigTokenKind::Parm: return tableOf(kParmTokens);
+  }
+  return TokenTable{nullptr, 0};
+}
+
+// Compares a length-delimited name against a NUL-terminated table entry.
+int compareToEntry(const char* name, size_t length, const char* entry) {
+  const int cmp = std::strncmp(name, entry, length);
+  if (cmp != 0) {
+    return cmp;
+  }
+  return entry[length] == '\0' ? 0 : -1;
+}
+
+}  // namespace
+
+const RigTokenEntry* findRigToken(RigTokenKind kind, const char* name, size_t length, size_t* index) {
+  const TokenTable table = tableFor(kind);
+  if (!name || length == 0 || std::memchr(name, '\0', length)) {
+    return nullptr;
+  }
+  size_t low = 0;
+  size_t high = table.count;
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    const int cmp = compareToEntry(name, length, table.entries[mid].name);
+    if (cmp == 0) {
+      if (index) *index = mid;
+      return &table.entries[mid];
+    }
+    if (cmp < 0) {
+      high = mid;
+    } else {
+      low = mid + 1;
+    }
+  }
+  return nullptr;
+}
+
+bool lookupRigToken(RigTokenKind kind, const std::string& name, uint64_t* bit) {
+  const RigTokenEntry* entry = findRigToken(kind, name.data(), name.size(), nullptr);
+  if (!entry || !bit) {
+    return false;
+  }
+  *bit = entry->bit;
+  return true;
+}
+
+uint32_t rigTokenHandle(RigTokenKind kind, const std::string& name) {
+  size_t index = 0;
+  if (!findRigToken(kind, name.data(), name.size(), &index)) {
+    return 0;
+  }
+  return (static_cast<uint32_t>(kind) << kHandleKindShift) | static_cast<uint32_t>(index + 1);
+}
+
+bool resolveRigTokenHandle(RigTokenKind kind, double handle, uint64_t* bit) {
+  if (!bit || !(handle >= 1 && handle <= 0xffffffff) || handle != static_cast<double>(static_cast<uint32_t>(handle))) {
+    return false;
+  }
+  const uint32_t value = static_cast<uint32_t>(handle);
+  if ((value >> kHandleKindShift) != static_cast<uint32_t>(kind)) {
+    return false;
+  }
+  const TokenTable table = tableFor(kind);
+  const uint32_t index = value & kHandleIndexMask;
+  if (index == 0 || index > table.count) {
+    return false;
+  }
+  *bit = table.entries[index - 1].bit;
+  return true;
+}
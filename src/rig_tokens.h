@@ -0,0 +1,29 @@
+#pragma once
+
+#include "shim/hamlib_shim.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct RigTokenEntry {
+  const char* name;
+  uint64_t bit;
+};
+
+enum class RigTokenKind : uint32_t {
+  Level = 1,
+  Function = 2,
+  Parm = 3,
+};
+
+// Binary search over the sorted name table of one token kind. `index`, when
+// given, receives the position of the match.
+const RigTokenEntry* findRigToken(RigTokenKind kind, const char* name, size_t length, size_t* index);
+bool lookupRigToken(RigTokenKind kind, const std::string& name, uint64_t* bit);
+
+// Opaque numeric handle for a token name, stable for the life of the
+// process; 0 when the name is unknown. Handles of one kind are rejected by
+// the others.
+uint32_t rigTokenHandle(RigTokenKind kind, const std::string& name);
+bool resolveRigTokenHandle(RigTokenKind kind, double handle, uint64_t* bit);
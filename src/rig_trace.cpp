@@ -0,0 +1,96 @@
+#include "rig_trace.h"
+
+#include "rig_metrics.h"
+
+#include <algorithm>
+
+namespace {
+
+std::atomic<uint32_t> nextThreadNumber{0};
+
+}  // namespace
+
+RigTraceRing::RigTraceRing(size_t capacity)
+  : mask_(RoundCapacity(capacity) - 1),
+    owner_thread_(CurrentThread()) {
+  slots_.reset(new Slot[mask_ + 1]);
+}
+
+size_t RigTraceRing::RoundCapacity(size_t capacity) {
+  if (capacity < kMinCapacity) {
+    capacity = kMinCapacity;
+  } else if (capacity > kMaxCapacity) {
+    capacity = kMaxCapacity;
+  }
+  size_t rounded = 1;
+  while (rounded < capacity) {
+    rounded <<= 1;
+  }
+  return rounded;
+}
+
+uint32_t RigTraceRing::CurrentThread() {
+  thread_local uint32_t number = nextThreadNumber.fetch_add(1, std::memory_order_relaxed) + 1;
+  return number;
+}
+
+void RigTraceRing::Record(uint32_t call_id, RigTracePhase phase, const RigOperationMetrics* operation,
+                          RigCommandPriority priority, int32_t result_code, bool failed) {
+  const uint64_t index = head_.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = slots_[index & mask_];
+  slot.seq.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.ts_us.store(rigMetricsNowMicros(), std::memory_order_relaxed);
+  slot.call_id.store(call_id, std::memory_order_relaxed);
+  slot.thread.store(CurrentThread(), std::memory_order_relaxed);
+  slot.phase.store(static_cast<uint8_t>(phase), std::memory_order_relaxed);
+  slot.priority.store(static_cast<uint8_t>(priority), std::memory_order_relaxed);
+  slot.result_code.store(result_code, std::memory_order_relaxed);
+  slot.failed.store(failed ? 1 : 0, std::memory_order_relaxed);
+  slot.operation.store(operation, std::memory_order_relaxed);
+  slot.seq.store(2 * index + 2, std::memory_order_release);
+}
+
+std::vector<RigTraceEvent> RigTraceRing::Snapshot() const {
+  const uint64_t head = head_.load(std::memory_order_acquire);
+  const uint64_t capacity = Capacity();
+  const uint64_t first = std::max(floor_.load(std::memory_order_relaxed), head > capacity ? head - capacity : 0);
+  std::vector<RigTraceEvent> events;
+  events.reserve(static_cast<size_t>(head - first));
+  for (uint64_t index = first; index < head; ++index) {
+    const Slot& slot = slots_[index & mask_];
+    const uint64_t published = 2 * index + 2;
+    if (slot.seq.load(std::memory_order_acquire) != published) {
+      continue;
+    }
+    RigTraceEvent event;
+    event.ts_us = slot.ts_us.load(std::memory_order_relaxed);
+    event.call_id = slot.call_id.load(std::memory_order_relaxed);
+    event.thread = slot.thread.load(std::memory_order_relaxed);
+    event.phase = static_cast<RigTracePhase>(slot.phase.load(std::memory_order_relaxed));
+    event.priority = static_cast<RigCommandPriority>(slot.priority.load(std::memory_order_relaxed));
+    event.result_code = slot.result_code.load(std::memory_order_relaxed);
+    event.failed = slot.failed.load(std::memory_order_relaxed) != 0;
+    event.operation = slot.operation.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // Rewritten by a writer that lapped the ring while we copied it.
+    if (slot.seq.load(std::memory_order_relaxed) != published) {
+      continue;
+    }
+    events.push_back(event);
+  }
+  return events;
+}
+
+void RigTraceRing::Clear() {
+  floor_.store(head_.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+uint64_t RigTraceRing::Recorded() const {
+  return head_.load(std::memory_order_relaxed) - floor_.load(std::memory_order_relaxed);
+}
+
+uint64_t RigTraceRing::Overwritten() const {
+  const uint64_t recorded = Recorded();
+  return recorded > Capacity() ? recorded - Capacity() : 0;
+}
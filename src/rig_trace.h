@@ -0,0 +1,92 @@
+#pragma once
+
+#include "rig_priority.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class RigOperationMetrics;
+
+// Points in the life of one native command.
+enum class RigTracePhase : uint8_t {
+  Created = 0,   // worker constructed, JS thread
+  Started = 1,   // Execute() entered on a threadpool / command thread
+  Locked = 2,    // rig lock acquired or given up
+  Returned = 3,  // shim call returned, rig lock still held
+  Settled = 4,   // promise resolved or rejected, JS thread
+};
+
+struct RigTraceEvent {
+  int64_t ts_us = 0;
+  uint32_t call_id = 0;
+  // Small per-process thread number, see RigTraceRing::CurrentThread().
+  uint32_t thread = 0;
+  RigTracePhase phase = RigTracePhase::Created;
+  RigCommandPriority priority = RigCommandPriority::Interactive;
+  int32_t result_code = 0;
+  // Settled events: the promise was rejected.
+  bool failed = false;
+  // Interned in RigMetricsRegistry::Global(), lives for the process; null
+  // until the operation name is known (Created events).
+  const RigOperationMetrics* operation = nullptr;
+};
+
+// Fixed-size CAT trace events in a lock-free ring: writers on any thread
+// claim a slot with one fetch_add and publish it with a per-slot sequence
+// number, so recording never blocks and the oldest events are overwritten.
+// A snapshot skips slots that are being rewritten while it reads.
+class RigTraceRing {
+public:
+    static constexpr size_t kDefaultCapacity = 4096;
+    static constexpr size_t kMinCapacity = 64;
+    static constexpr size_t kMaxCapacity = 1 << 20;
+
+    // Capacity is clamped and rounded up to a power of two.
+    explicit RigTraceRing(size_t capacity);
+    static size_t RoundCapacity(size_t capacity);
+
+    RigTraceRing(const RigTraceRing&) = delete;
+    RigTraceRing& operator=(const RigTraceRing&) = delete;
+
+    uint32_t NextCallId() { return next_call_id_.fetch_add(1, std::memory_order_relaxed) + 1; }
+    void Record(uint32_t call_id, RigTracePhase phase, const RigOperationMetrics* operation,
+                RigCommandPriority priority, int32_t result_code, bool failed);
+
+    // Events still in the ring since the last Clear(), oldest first.
+    std::vector<RigTraceEvent> Snapshot() const;
+    void Clear();
+
+    size_t Capacity() const { return mask_ + 1; }
+    // Events recorded since the last Clear(), including overwritten ones.
+    uint64_t Recorded() const;
+    uint64_t Overwritten() const;
+    // Thread that created the ring: the JS thread of its rig.
+    uint32_t OwnerThread() const { return owner_thread_; }
+
+    // Numbered in order of each thread's first trace event.
+    static uint32_t CurrentThread();
+
+private:
+    struct Slot {
+        // 2 * index + 1 while being written, 2 * index + 2 once published.
+        std::atomic<uint64_t> seq{0};
+        std::atomic<int64_t> ts_us{0};
+        std::atomic<uint32_t> call_id{0};
+        std::atomic<uint32_t> thread{0};
+        std::atomic<uint8_t> phase{0};
+        std::atomic<uint8_t> priority{0};
+        std::atomic<uint8_t> failed{0};
+        std::atomic<int32_t> result_code{0};
+        std::atomic<const RigOperationMetrics*> operation{nullptr};
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> floor_{0};
+    std::atomic<uint32_t> next_call_id_{0};
+    const uint32_t owner_thread_;
+};
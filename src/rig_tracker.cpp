@@ -0,0 +1,291 @@
+#include "rig_tracker.h"
+
+#include "hamlib.h"
+#include "node_rotator.h"
+#include "shim/hamlib_shim.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+double lerp(double from, double to, double fraction) {
+  return from + (to - from) * fraction;
+}
+
+bool leftDeadband(bool has_sent, double sent, double target, double deadband) {
+  return !has_sent || std::fabs(target - sent) > deadband;
+}
+
+Napi::Object trackingProgressToObject(Napi::Env env, const TrackingProgress& progress,
+                                      const TrackingOptions& options) {
+  Napi::Object obj = Napi::Object::New(env);
+  obj.Set("type", Napi::String::New(env, progress.end ? "end" : "step"));
+  obj.Set("timestamp", Napi::Number::New(env, progress.timestamp));
+  if (progress.end) {
+    obj.Set("reason", Napi::String::New(env, progress.reason));
+    return obj;
+  }
+  obj.Set("index", Napi::Number::New(env, static_cast<double>(progress.index)));
+  obj.Set("lateMs", Napi::Number::New(env, progress.late_ms));
+  if (options.has_position) {
+    obj.Set("azimuth", Napi::Number::New(env, progress.sample.azimuth));
+    obj.Set("elevation", Napi::Number::New(env, progress.sample.elevation));
+  }
+  if (options.has_rx_frequency) {
+    obj.Set("rxFrequency", Napi::Number::New(env, progress.sample.rx_frequency));
+  }
+  if (options.has_tx_frequency) {
+    obj.Set("txFrequency", Napi::Number::New(env, progress.sample.tx_frequency));
+  }
+  Napi::Object sent = Napi::Object::New(env);
+  sent.Set("rxFrequency", Napi::Boolean::New(env, progress.sent_rx_frequency));
+  sent.Set("txFrequency", Napi::Boolean::New(env, progress.sent_tx_frequency));
+  sent.Set("position", Napi::Boolean::New(env, progress.sent_position));
+  obj.Set("sent", sent);
+  Napi::Array errors = Napi::Array::New(env, progress.errors.size());
+  for (size_t i = 0; i < progress.errors.size(); ++i) {
+    const TrackingCommandError& error = progress.errors[i];
+    Napi::Object item = Napi::Object::New(env);
+    item.Set("target", Napi::String::New(env, error.target));
+    item.Set("code", Napi::String::New(env, "HAMLIB_ERROR"));
+    item.Set("hamlibCode", Napi::Number::New(env, error.result_code));
+    item.Set("message", Napi::String::New(env, error.message));
+    errors[static_cast<uint32_t>(i)] = item;
+  }
+  obj.Set("errors", errors);
+  return obj;
+}
+
+}  // namespace
+
+RigTracker::RigTracker(NodeHamLib* rig, NodeRotator* rotator, std::vector<TrackingPoint> points,
+                       TrackingOptions options)
+  : RigBackgroundJob(rig), rotator_(rotator), points_(std::move(points)), options_(options) {}
+
+RigTracker::~RigTracker() {
+  Stop();
+}
+
+void RigTracker::Start(Napi::Env env, Napi::Function callback, Napi::Object rotator) {
+  if (!rotator.IsEmpty()) {
+    rotator_ref_ = Napi::Persistent(rotator);
+  }
+  StartThread(env, callback, "HamLibTracker");
+}
+
+void RigTracker::Stop() {
+  StopThread();
+  ReleaseRotator();
+}
+
+void RigTracker::ReleaseRotator() {
+  if (rotator_ref_.IsEmpty()) {
+    return;
+  }
+  // The rotator moved without its setPosition() knowing; do not let that
+  // deadband swallow the next manual target.
+  rotator_->has_position_target_ = false;
+  rotator_ref_.Reset();
+}
+
+TrackingStats RigTracker::GetStats() const {
+  TrackingStats stats;
+  stats.running = Running();
+  stats.points = points_.size();
+  stats.start_ms = points_.front().time_ms;
+  stats.end_ms = points_.back().time_ms;
+  stats.steps = steps_.load(std::memory_order_relaxed);
+  stats.late_steps = late_steps_.load(std::memory_order_relaxed);
+  stats.skipped_steps = skipped_steps_.load(std::memory_order_relaxed);
+  stats.rx_frequency_commands = rx_commands_.load(std::memory_order_relaxed);
+  stats.tx_frequency_commands = tx_commands_.load(std::memory_order_relaxed);
+  stats.position_commands = position_commands_.load(std::memory_order_relaxed);
+  stats.errors = errors_.load(std::memory_order_relaxed);
+  stats.max_late_ms = max_late_ms_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+TrackingPoint RigTracker::Interpolate(const std::vector<TrackingPoint>& points, double time_ms,
+                                      size_t* hint) {
+  if (time_ms <= points.front().time_ms || points.size() == 1) {
+    *hint = 0;
+    return points.front();
+  }
+  if (time_ms >= points.back().time_ms) {
+    *hint = points.size() - 1;
+    return points.back();
+  }
+  // Time only moves forward, so the segment is nearly always the hinted one.
+  size_t i = std::min(*hint, points.size() - 2);
+  if (points[i].time_ms > time_ms) {
+    i = 0;
+  }
+  while (points[i + 1].time_ms <= time_ms) {
+    ++i;
+  }
+  *hint = i;
+
+  const TrackingPoint& from = points[i];
+  const TrackingPoint& to = points[i + 1];
+  const double fraction = (time_ms - from.time_ms) / (to.time_ms - from.time_ms);
+  TrackingPoint sample;
+  sample.time_ms = time_ms;
+  sample.azimuth = lerp(from.azimuth, to.azimuth, fraction);
+  sample.elevation = lerp(from.elevation, to.elevation, fraction);
+  sample.rx_frequency = lerp(from.rx_frequency, to.rx_frequency, fraction);
+  sample.tx_frequency = lerp(from.tx_frequency, to.tx_frequency, fraction);
+  return sample;
+}
+
+void RigTracker::ThreadMain() {
+  RigLockScopeUse scopeUse;
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point deadline = Clock::now();
+  size_t hint = 0;
+  std::string reason = "stopped";
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    if (cv_.wait_until(lock, deadline, [this]() { return stopping_; })) {
+      break;
+    }
+    lock.unlock();
+
+    const Clock::time_point started = Clock::now();
+    const double lateMs = std::chrono::duration<double, std::milli>(started - deadline).count();
+    const double now = rigEpochMillis();
+    const bool last = now >= points_.back().time_ms;
+
+    TrackingProgress progress;
+    progress.timestamp = now;
+    progress.late_ms = lateMs;
+    progress.sample = Interpolate(points_, now, &hint);
+    progress.index = hint;
+    steps_.fetch_add(1, std::memory_order_relaxed);
+    if (lateMs > options_.step.count() / 2.0) {
+      late_steps_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (lateMs > max_late_ms_.load(std::memory_order_relaxed)) {
+      max_late_ms_.store(lateMs, std::memory_order_relaxed);
+    }
+
+    const bool open = RunStep(progress.sample, &progress);
+    if (progress.sent_rx_frequency || progress.sent_tx_frequency || progress.sent_position
+        || !progress.errors.empty()) {
+      Emit(&progress);
+    }
+
+    lock.lock();
+    if (!open || last) {
+      reason = open ? "complete" : "closed";
+      break;
+    }
+    deadline += options_.step;
+    const Clock::time_point after = Clock::now();
+    if (deadline < after) {
+      // Fell behind by more than a step: resume from now instead of bursting.
+      deadline = after + options_.step - (after - deadline) % options_.step;
+    }
+  }
+  lock.unlock();
+
+  if (reason != "stopped") {
+    TrackingProgress end;
+    end.end = true;
+    end.reason = reason;
+    end.timestamp = rigEpochMillis();
+    Emit(&end);
+  }
+  Finish();
+}
+
+bool RigTracker::RunStep(const TrackingPoint& sample, TrackingProgress* progress) {
+  const bool wantRx = options_.has_rx_frequency
+    && leftDeadband(has_sent_rx_, sent_rx_, std::round(sample.rx_frequency), options_.frequency_deadband_hz);
+  const bool wantTx = options_.has_tx_frequency
+    && leftDeadband(has_sent_tx_, sent_tx_, std::round(sample.tx_frequency), options_.frequency_deadband_hz);
+  auto fail = [this, progress](const char* target, int code) {
+    TrackingCommandError error;
+    error.target = target;
+    error.result_code = code;
+    error.message = shim_rigerror(code);
+    progress->errors.push_back(std::move(error));
+    errors_.fetch_add(1, std::memory_order_relaxed);
+  };
+
+  if (wantRx || wantTx) {
+    auto rigLock = rig_->TryAcquireRigLockIfEnabled(options_.step);
+    if (!rigLock.owns_lock() && NodeHamLib::IsGlobalRigLockEnabled()) {
+      skipped_steps_.fetch_add(1, std::memory_order_relaxed);
+    } else if (!rig_->my_rig || !rig_->rig_is_open.load(std::memory_order_acquire)) {
+      return false;
+    } else {
+      if (wantRx) {
+        const double frequency = std::round(sample.rx_frequency);
+        const int code = shim_rig_set_freq(rig_->my_rig, options_.vfo, frequency);
+        if (code == SHIM_RIG_OK) {
+          rig_->state_cache_.StoreFrequency(options_.vfo, frequency);
+          has_sent_rx_ = true;
+          sent_rx_ = frequency;
+          progress->sent_rx_frequency = true;
+          rx_commands_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          fail("rxFrequency", code);
+        }
+      }
+      if (wantTx) {
+        const double frequency = std::round(sample.tx_frequency);
+        const int code = shim_rig_set_split_freq(rig_->my_rig, options_.vfo, frequency);
+        if (code == SHIM_RIG_OK) {
+          has_sent_tx_ = true;
+          sent_tx_ = frequency;
+          progress->sent_tx_frequency = true;
+          tx_commands_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          fail("txFrequency", code);
+        }
+      }
+    }
+  }
+
+  const bool wantPosition = rotator_ && options_.has_position
+    && (leftDeadband(has_sent_position_, sent_azimuth_, sample.azimuth, options_.azimuth_deadband)
+        || leftDeadband(has_sent_position_, sent_elevation_, sample.elevation, options_.elevation_deadband));
+  if (wantPosition) {
+    std::unique_lock<std::timed_mutex> rotLock(rotator_->io_mutex_, options_.step);
+    if (!rotLock.owns_lock()) {
+      skipped_steps_.fetch_add(1, std::memory_order_relaxed);
+    } else if (!rotator_->my_rot || !rotator_->rot_is_open.load(std::memory_order_acquire)) {
+      return false;
+    } else {
+      const int code = shim_rot_set_position(rotator_->my_rot, sample.azimuth, sample.elevation);
+      if (code == SHIM_RIG_OK) {
+        has_sent_position_ = true;
+        sent_azimuth_ = sample.azimuth;
+        sent_elevation_ = sample.elevation;
+        progress->sent_position = true;
+        position_commands_.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        fail("position", code);
+      }
+    }
+  }
+  return true;
+}
+
+void RigTracker::Emit(TrackingProgress* progress) {
+  Post(new TrackingProgress(std::move(*progress)),
+       [this](Napi::Env env, Napi::Function callback, TrackingProgress* data) {
+         Deliver(env, callback, *data);
+       });
+}
+
+void RigTracker::Deliver(Napi::Env env, Napi::Function callback, const TrackingProgress& progress) {
+  Napi::HandleScope scope(env);
+  if (progress.end) {
+    ReleaseRotator();
+  }
+  callback.Call({ trackingProgressToObject(env, progress, options_) });
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "rig_background_job.h"
+#include <napi.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class NodeHamLib;
+class NodeRotator;
+
+// One row of a tracking schedule. Every point of a schedule carries the same
+// set of fields; absent ones are not commanded.
+struct TrackingPoint {
+  // Epoch milliseconds.
+  double time_ms = 0;
+  double azimuth = 0;
+  double elevation = 0;
+  double rx_frequency = 0;
+  double tx_frequency = 0;
+};
+
+struct TrackingOptions {
+  int vfo = 0;
+  std::chrono::milliseconds step{250};
+  bool has_position = false;
+  bool has_rx_frequency = false;
+  bool has_tx_frequency = false;
+  // A value is sent once it moved further than this from the last one sent.
+  double frequency_deadband_hz = 10;
+  double azimuth_deadband = 1;
+  double elevation_deadband = 1;
+};
+
+struct TrackingStats {
+  bool running = false;
+  size_t points = 0;
+  double start_ms = 0;
+  double end_ms = 0;
+  uint64_t steps = 0;
+  // Steps that started more than half a step after their deadline.
+  uint64_t late_steps = 0;
+  // Steps whose rig part was skipped because the rig lock stayed busy.
+  uint64_t skipped_steps = 0;
+  uint64_t rx_frequency_commands = 0;
+  uint64_t tx_frequency_commands = 0;
+  uint64_t position_commands = 0;
+  uint64_t errors = 0;
+  double max_late_ms = 0;
+};
+
+struct TrackingCommandError {
+  std::string target;
+  int result_code = 0;
+  std::string message;
+};
+
+// What one step did, or how the schedule ended, copied to the JS thread.
+struct TrackingProgress {
+  bool end = false;
+  // "complete", "closed" or "stopped"; end events only.
+  std::string reason;
+  double timestamp = 0;
+  size_t index = 0;
+  TrackingPoint sample;
+  bool sent_rx_frequency = false;
+  bool sent_tx_frequency = false;
+  bool sent_position = false;
+  double late_ms = 0;
+  std::vector<TrackingCommandError> errors;
+};
+
+// Steps a time-indexed schedule on its own thread: at each deadline the
+// schedule is interpolated at the wall clock time and the rig frequency
+// (shim_rig_set_freq / shim_rig_set_split_freq) and rotator position
+// (shim_rot_set_position) are sent when they left their deadband. Deadlines
+// are absolute, so slow commands do not make the loop drift; missed steps are
+// dropped rather than replayed. JS only sees a progress event for steps that
+// sent or failed something, and one end event.
+class RigTracker : public RigBackgroundJob {
+public:
+    // Both instances must outlive the tracker; the caller keeps a reference
+    // to the rotator's JS object through Start().
+    RigTracker(NodeHamLib* rig, NodeRotator* rotator, std::vector<TrackingPoint> points,
+               TrackingOptions options);
+    ~RigTracker() override;
+
+    // JS thread. `rotator` is the rotator's JS object, or an empty value.
+    void Start(Napi::Env env, Napi::Function callback, Napi::Object rotator);
+    // JS thread. Joins the loop; a step already talking to a device finishes
+    // first. No end event is delivered for a stopped schedule.
+    void Stop();
+    TrackingStats GetStats() const;
+
+    // Linear interpolation between the points around `time_ms`, holding the
+    // first and last point outside the schedule. `hint` is the segment of
+    // the previous call and is advanced in place.
+    static TrackingPoint Interpolate(const std::vector<TrackingPoint>& points, double time_ms,
+                                     size_t* hint);
+
+private:
+    void ThreadMain() override;
+    // Returns false when the rig or rotator is no longer open.
+    bool RunStep(const TrackingPoint& sample, TrackingProgress* progress);
+    void Emit(TrackingProgress* progress);
+    // JS thread.
+    void Deliver(Napi::Env env, Napi::Function callback, const TrackingProgress& progress);
+    void ReleaseRotator();
+
+    NodeRotator* rotator_;
+    const std::vector<TrackingPoint> points_;
+    const TrackingOptions options_;
+
+    // Loop thread only.
+    bool has_sent_rx_ = false;
+    bool has_sent_tx_ = false;
+    bool has_sent_position_ = false;
+    double sent_rx_ = 0;
+    double sent_tx_ = 0;
+    double sent_azimuth_ = 0;
+    double sent_elevation_ = 0;
+
+    std::atomic<uint64_t> steps_{0};
+    std::atomic<uint64_t> late_steps_{0};
+    std::atomic<uint64_t> skipped_steps_{0};
+    std::atomic<uint64_t> rx_commands_{0};
+    std::atomic<uint64_t> tx_commands_{0};
+    std::atomic<uint64_t> position_commands_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::atomic<double> max_late_ms_{0};
+
+    // JS thread only.
+    Napi::ObjectReference rotator_ref_;
+};
@@ -0,0 +1,507 @@
+#include "rigctld_session.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef _WIN32
+using SocketHandle = SOCKET;
+const SocketHandle kInvalidSocket = INVALID_SOCKET;
+#else
+using SocketHandle = int;
+const SocketHandle kInvalidSocket = -1;
+#endif
+
+// Receive timeout slice; the reader checks deadlines and shutdown between.
+constexpr int kReceiveSliceMs = 100;
+constexpr int kDefaultRigctldPort = 4532;
+
+SocketHandle toSocket(intptr_t value) {
+  return static_cast<SocketHandle>(value);
+}
+
+void closeSocket(SocketHandle socket) {
+#ifdef _WIN32
+  closesocket(socket);
+#else
+  close(socket);
+#endif
+}
+
+void shutdownSocket(SocketHandle socket) {
+#ifdef _WIN32
+  shutdown(socket, SD_BOTH);
+#else
+  shutdown(socket, SHUT_RDWR);
+#endif
+}
+
+std::string socketErrorText() {
+#ifdef _WIN32
+  return "socket error " + std::to_string(WSAGetLastError());
+#else
+  return std::strerror(errno);
+#endif
+}
+
+bool receiveTimedOut() {
+#ifdef _WIN32
+  const int error = WSAGetLastError();
+  return error == WSAETIMEDOUT || error == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+void setReceiveTimeout(SocketHandle socket, int ms) {
+#ifdef _WIN32
+  DWORD timeout = static_cast<DWORD>(ms);
+  setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+#else
+  timeval timeout;
+  timeout.tv_sec = ms / 1000;
+  timeout.tv_usec = (ms % 1000) * 1000;
+  setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+#endif
+}
+
+bool sendAll(SocketHandle socket, const std::string& data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+#ifdef _WIN32
+    const int n = send(socket, data.data() + sent, static_cast<int>(data.size() - sent), 0);
+#elif defined(MSG_NOSIGNAL)
+    const ssize_t n = send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+#else
+    const ssize_t n = send(socket, data.data() + sent, data.size() - sent, 0);
+#endif
+    if (n <= 0) {
+      return false;
+    }
+    sent += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+bool startsWithRprt(const std::string& line) {
+  return line.compare(0, 5, "RPRT ") == 0;
+}
+
+// "host:port", "[v6]:port" or a bare host, lower-cased for the registry key.
+bool splitAddress(const std::string& address, std::string* host, std::string* port) {
+  if (!address.empty() && address[0] == '[') {
+    const size_t close = address.find(']');
+    if (close == std::string::npos) {
+      return false;
+    }
+    *host = address.substr(1, close - 1);
+    *port = close + 1 < address.size() && address[close + 1] == ':' ? address.substr(close + 2) : "";
+  } else {
+    const size_t colon = address.rfind(':');
+    *host = colon == std::string::npos ? address : address.substr(0, colon);
+    *port = colon == std::string::npos ? "" : address.substr(colon + 1);
+  }
+  if (port->empty()) {
+    *port = std::to_string(kDefaultRigctldPort);
+  }
+  std::transform(host->begin(), host->end(), host->begin(), [](unsigned char ch) {
+    return static_cast<char>(std::tolower(ch));
+  });
+  return !host->empty();
+}
+
+SocketHandle connectTo(const std::string& host, const std::string& port, std::string* error) {
+  addrinfo hints;
+  std::memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_protocol = IPPROTO_TCP;
+  addrinfo* results = nullptr;
+  const int status = getaddrinfo(host.c_str(), port.c_str(), &hints, &results);
+  if (status != 0 || !results) {
+    *error = "Unable to resolve " + host + ":" + port;
+    return kInvalidSocket;
+  }
+  SocketHandle socket = kInvalidSocket;
+  for (addrinfo* candidate = results; candidate; candidate = candidate->ai_next) {
+    socket = ::socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+    if (socket == kInvalidSocket) {
+      continue;
+    }
+    if (connect(socket, candidate->ai_addr, static_cast<int>(candidate->ai_addrlen)) == 0) {
+      break;
+    }
+    *error = "Unable to connect to " + host + ":" + port + ": " + socketErrorText();
+    closeSocket(socket);
+    socket = kInvalidSocket;
+  }
+  freeaddrinfo(results);
+  if (socket == kInvalidSocket && error->empty()) {
+    *error = "Unable to connect to " + host + ":" + port;
+  }
+  return socket;
+}
+
+// Reads one line before the session threads start (the \chk_vfo probe).
+bool readLine(SocketHandle socket, std::chrono::milliseconds timeout, std::string* line) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  line->clear();
+  char ch = 0;
+  while (std::chrono::steady_clock::now() < deadline) {
+    const auto n = recv(socket, &ch, 1, 0);
+    if (n == 1) {
+      if (ch == '\n') {
+        return true;
+      }
+      if (ch != '\r') {
+        line->push_back(ch);
+      }
+    } else if (n == 0 || !receiveTimedOut()) {
+      return false;
+    }
+  }
+  return false;
+}
+
+std::mutex registryMutex;
+std::map<std::string, std::weak_ptr<RigctldSession>> registry;
+
+}  // namespace
+
+std::shared_ptr<RigctldSession> RigctldSession::Acquire(const std::string& address,
+                                                        std::chrono::milliseconds timeout, std::string* error) {
+#ifdef _WIN32
+  static std::once_flag winsockOnce;
+  std::call_once(winsockOnce, []() {
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+  });
+#endif
+  std::string host;
+  std::string port;
+  if (!splitAddress(address, &host, &port)) {
+    *error = "Invalid rigctld address: " + address;
+    return nullptr;
+  }
+  const std::string key = host + ":" + port;
+  {
+    std::lock_guard<std::mutex> guard(registryMutex);
+    auto found = registry.find(key);
+    if (found != registry.end()) {
+      std::shared_ptr<RigctldSession> existing = found->second.lock();
+      if (existing && existing->Connected()) {
+        return existing;
+      }
+    }
+  }
+
+  // Connect without the registry lock so other addresses are not held up.
+  SocketHandle socket = connectTo(host, port, error);
+  if (socket == kInvalidSocket) {
+    return nullptr;
+  }
+  int noDelay = 1;
+  setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+#ifdef SO_NOSIGPIPE
+  // macOS has no MSG_NOSIGNAL; a dropped connection must not raise SIGPIPE.
+  int noSigPipe = 1;
+  setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+  setReceiveTimeout(socket, kReceiveSliceMs);
+
+  // rigctld --vfo expects a VFO on every get/set; "CHKVFO 1" or "1" when set.
+  std::string probe;
+  if (!sendAll(socket, "\\chk_vfo\n") || !readLine(socket, timeout, &probe)) {
+    *error = "rigctld at " + key + " did not answer \\chk_vfo";
+    closeSocket(socket);
+    return nullptr;
+  }
+  const size_t lastSpace = probe.find_last_of(' ');
+  const bool vfoMode = !startsWithRprt(probe)
+    && std::atoi(probe.c_str() + (lastSpace == std::string::npos ? 0 : lastSpace + 1)) == 1;
+
+  std::shared_ptr<RigctldSession> session(
+    new RigctldSession(key, static_cast<intptr_t>(socket), timeout, vfoMode));
+  std::lock_guard<std::mutex> guard(registryMutex);
+  std::shared_ptr<RigctldSession> raced = registry[key].lock();
+  if (raced && raced->Connected()) {
+    // Another caller connected first; ours closes when it goes out of scope.
+    return raced;
+  }
+  session->Start();
+  registry[key] = session;
+  return session;
+}
+
+RigctldSession::RigctldSession(std::string address, intptr_t socket, std::chrono::milliseconds timeout,
+                               bool vfo_mode)
+  : address_(std::move(address)), timeout_(timeout), vfo_mode_(vfo_mode), socket_(socket) {}
+
+RigctldSession::~RigctldSession() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stopping_ = true;
+  }
+  outbox_cv_.notify_all();
+  shutdownSocket(toSocket(socket_));
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+  if (reader_.joinable()) {
+    reader_.join();
+  }
+  Fail("rigctld session closed");
+  closeSocket(toSocket(socket_));
+}
+
+void RigctldSession::Start() {
+  writer_ = std::thread([this]() { WriterMain(); });
+  reader_ = std::thread([this]() { ReaderMain(); });
+}
+
+void RigctldSession::Submit(std::vector<RigctldRequest> requests, Callback done) {
+  std::unique_ptr<Group> group(new Group());
+  group->requests = std::move(requests);
+  group->replies.resize(group->requests.size());
+  group->done = std::move(done);
+  group->submitted = std::chrono::steady_clock::now();
+  group->deadline = group->submitted + timeout_;
+  if (group->requests.empty()) {
+    group->done(group->replies, std::string());
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!stopping_ && Connected()) {
+      groups_.fetch_add(1, std::memory_order_relaxed);
+      commands_.fetch_add(group->requests.size(), std::memory_order_relaxed);
+      outbox_.push_back(std::move(group));
+    }
+  }
+  if (group) {
+    errors_.fetch_add(1, std::memory_order_relaxed);
+    std::vector<RigctldReply> none;
+    group->done(none, "rigctld session " + address_ + " is closed");
+    return;
+  }
+  outbox_cv_.notify_one();
+}
+
+void RigctldSession::WriterMain() {
+  std::string wire;
+  for (;;) {
+    wire.clear();
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      outbox_cv_.wait(lock, [this]() { return stopping_ || !outbox_.empty(); });
+      if (stopping_) {
+        return;
+      }
+      // Everything queued goes out in one write; replies come back in the
+      // order the groups enter inflight_.
+      while (!outbox_.empty()) {
+        std::unique_ptr<Group>& group = outbox_.front();
+        for (const RigctldRequest& request : group->requests) {
+          wire += request.command;
+          wire += '\n';
+        }
+        inflight_commands_ += group->requests.size();
+        inflight_.push_back(std::move(group));
+        outbox_.pop_front();
+      }
+      max_inflight_commands_ = std::max(max_inflight_commands_, inflight_commands_);
+    }
+    if (!sendAll(toSocket(socket_), wire)) {
+      Fail("Write to rigctld " + address_ + " failed: " + socketErrorText());
+      return;
+    }
+  }
+}
+
+void RigctldSession::ReaderMain() {
+  std::string buffered;
+  char chunk[4096];
+  for (;;) {
+    const auto n = recv(toSocket(socket_), chunk, sizeof(chunk), 0);
+    if (n > 0) {
+      buffered.append(chunk, static_cast<size_t>(n));
+      std::vector<std::unique_ptr<Group>> finished;
+      size_t start = 0;
+      size_t newline;
+      while ((newline = buffered.find('\n', start)) != std::string::npos) {
+        std::string line = buffered.substr(start, newline - start);
+        if (!line.empty() && line.back() == '\r') {
+          line.pop_back();
+        }
+        TakeLine(line, &finished);
+        start = newline + 1;
+      }
+      buffered.erase(0, start);
+      const auto now = std::chrono::steady_clock::now();
+      for (std::unique_ptr<Group>& group : finished) {
+        latency_.Record(static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(now - group->submitted).count()));
+        group->done(group->replies, std::string());
+      }
+      continue;
+    }
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (stopping_) {
+        return;
+      }
+    }
+    if (n == 0) {
+      Fail("rigctld " + address_ + " closed the connection");
+      return;
+    }
+    if (!receiveTimedOut()) {
+      Fail("Read from rigctld " + address_ + " failed: " + socketErrorText());
+      return;
+    }
+    bool expired = false;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      expired = !inflight_.empty() && std::chrono::steady_clock::now() >= inflight_.front()->deadline;
+    }
+    if (expired) {
+      Fail("No reply from rigctld " + address_ + " within "
+        + std::to_string(static_cast<long long>(timeout_.count())) + "ms");
+      return;
+    }
+  }
+}
+
+void RigctldSession::TakeLine(const std::string& line, std::vector<std::unique_ptr<Group>>* finished) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (inflight_.empty()) {
+    // Nothing asked for this line (e.g. a late reply after a failure).
+    return;
+  }
+  Group& group = *inflight_.front();
+  const RigctldRequest& request = group.requests[group.answered];
+  RigctldReply& reply = group.replies[group.answered];
+  reply.lines.push_back(line);
+  if (startsWithRprt(line)) {
+    // Ends the reply whatever its length: the status of a set, or an error.
+    reply.result_code = std::atoi(line.c_str() + 5);
+    reply.lines.pop_back();
+  } else if (reply.lines.size() < request.reply_lines) {
+    return;
+  }
+  --inflight_commands_;
+  if (++group.answered == group.requests.size()) {
+    finished->push_back(std::move(inflight_.front()));
+    inflight_.pop_front();
+  }
+}
+
+void RigctldSession::Fail(const std::string& error) {
+  std::deque<std::unique_ptr<Group>> failed;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    connected_.store(false, std::memory_order_release);
+    for (std::unique_ptr<Group>& group : inflight_) {
+      failed.push_back(std::move(group));
+    }
+    for (std::unique_ptr<Group>& group : outbox_) {
+      failed.push_back(std::move(group));
+    }
+    inflight_.clear();
+    outbox_.clear();
+    inflight_commands_ = 0;
+    stopping_ = true;
+  }
+  outbox_cv_.notify_all();
+  // Unblocks the other thread; the socket itself is closed by the destructor.
+  shutdownSocket(toSocket(socket_));
+  for (std::unique_ptr<Group>& group : failed) {
+    errors_.fetch_add(1, std::memory_order_relaxed);
+    group->done(group->replies, error);
+  }
+}
+
+RigctldSessionStats RigctldSession::GetStats() const {
+  RigctldSessionStats stats;
+  stats.address = address_;
+  stats.connected = Connected();
+  stats.vfo_mode = vfo_mode_;
+  stats.clients = clients_.load(std::memory_order_relaxed);
+  stats.groups = groups_.load(std::memory_order_relaxed);
+  stats.commands = commands_.load(std::memory_order_relaxed);
+  stats.errors = errors_.load(std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stats.inflight = inflight_commands_;
+    stats.max_inflight = max_inflight_commands_;
+  }
+  stats.latency = latency_.Take();
+  return stats;
+}
+
+RigctldSessionClient::RigctldSessionClient(Napi::Env env, std::shared_ptr<RigctldSession> session)
+  : session_(std::move(session)), port_(std::make_shared<Port>()) {
+  Napi::Function noop = Napi::Function::New(env, [](const Napi::CallbackInfo&) {});
+  port_->tsfn = Napi::ThreadSafeFunction::New(env, noop, "HamLibRigctldSession", 0, 1);
+  port_->env = env;
+  // An idle client must not keep the process alive.
+  port_->tsfn.Unref(env);
+  session_->NoteClientAttached();
+}
+
+RigctldSessionClient::~RigctldSessionClient() {
+  session_->NoteClientDetached();
+}
+
+void RigctldSessionClient::Submit(std::vector<RigctldRequest> requests, Complete complete) {
+  std::shared_ptr<Port> port = port_;
+  if (port->outstanding++ == 0) {
+    port->tsfn.Ref(Napi::Env(port->env));
+  }
+  // Owned by the JS-thread call so whatever `complete` captures (object
+  // references) is released there and never on the reader thread.
+  Complete* pending = new Complete(std::move(complete));
+  session_->Submit(std::move(requests),
+    [port, pending](std::vector<RigctldReply>& replies, const std::string& error) {
+      struct Result {
+        std::vector<RigctldReply> replies;
+        std::string error;
+      };
+      Result* result = new Result{ std::move(replies), error };
+      napi_status status = port->tsfn.NonBlockingCall([port, pending, result](Napi::Env env, Napi::Function) {
+        std::unique_ptr<Complete> owned(pending);
+        std::unique_ptr<Result> owned_result(result);
+        Napi::HandleScope scope(env);
+        (*owned)(env, owned_result->replies, owned_result->error);
+        if (port->outstanding > 0 && --port->outstanding == 0) {
+          port->tsfn.Unref(env);
+        }
+      });
+      if (status != napi_ok) {
+        // The environment is shutting down; `pending` is leaked rather than
+        // destroyed off the JS thread.
+        delete result;
+      }
+    });
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <napi.h>
+#include "rig_metrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One rigctld protocol command in the default (non-extended) response format.
+struct RigctldRequest {
+  // Command line without the trailing newline, e.g. "f currVFO".
+  std::string command;
+  // Lines of a successful reply; set commands answer with one "RPRT n" line.
+  // An "RPRT n" line also ends any reply early (an error).
+  size_t reply_lines = 1;
+};
+
+struct RigctldReply {
+  // Value of an "RPRT n" line, SHIM_RIG_OK for a value reply.
+  int result_code = 0;
+  std::vector<std::string> lines;
+};
+
+struct RigctldSessionStats {
+  std::string address;
+  bool connected = false;
+  bool vfo_mode = false;
+  // HamLib instances attached to the session.
+  size_t clients = 0;
+  uint64_t groups = 0;
+  uint64_t commands = 0;
+  uint64_t errors = 0;
+  // Commands written and not yet answered, now and at most.
+  size_t inflight = 0;
+  size_t max_inflight = 0;
+  // Submit to last reply of a group.
+  LatencyHistogram::Snapshot latency;
+};
+
+// A TCP connection to rigctld shared by every HamLib instance that attaches
+// to the same host:port. Groups of commands from any client are written
+// back to back without waiting for replies; rigctld answers in order, so
+// replies are matched to requests first-in first-out. A batch therefore
+// costs one round trip instead of one per command.
+//
+// A reply that does not arrive within the session timeout fails every
+// outstanding group and closes the connection, since the stream can no
+// longer be framed; clients attach again to reconnect.
+class RigctldSession {
+public:
+    // (replies, error); error is empty on success and replies then hold one
+    // entry per request. Runs on the session's reader thread.
+    using Callback = std::function<void(std::vector<RigctldReply>&, const std::string&)>;
+
+    // Connects (blocking), or returns the open session for the same
+    // host:port. Returns null and sets `error` on failure.
+    static std::shared_ptr<RigctldSession> Acquire(const std::string& address,
+                                                   std::chrono::milliseconds timeout, std::string* error);
+    ~RigctldSession();
+
+    RigctldSession(const RigctldSession&) = delete;
+    RigctldSession& operator=(const RigctldSession&) = delete;
+
+    // Any thread. `done` is called exactly once, possibly before Submit()
+    // returns when the session is already closed.
+    void Submit(std::vector<RigctldRequest> requests, Callback done);
+
+    // Whether rigctld runs with --vfo, i.e. get/set commands take a VFO.
+    bool VfoMode() const { return vfo_mode_; }
+    bool Connected() const { return connected_.load(std::memory_order_acquire); }
+    const std::string& Address() const { return address_; }
+    void NoteClientAttached() { clients_.fetch_add(1, std::memory_order_relaxed); }
+    void NoteClientDetached() { clients_.fetch_sub(1, std::memory_order_relaxed); }
+    RigctldSessionStats GetStats() const;
+
+private:
+    struct Group {
+        std::vector<RigctldRequest> requests;
+        std::vector<RigctldReply> replies;
+        // Requests whose reply is complete; replies arrive in request order.
+        size_t answered = 0;
+        Callback done;
+        std::chrono::steady_clock::time_point submitted;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    RigctldSession(std::string address, intptr_t socket, std::chrono::milliseconds timeout, bool vfo_mode);
+    void Start();
+    void WriterMain();
+    void ReaderMain();
+    // Handles one reply line; returns the groups it completed.
+    void TakeLine(const std::string& line, std::vector<std::unique_ptr<Group>>* finished);
+    // Fails every queued and outstanding group and closes the connection.
+    void Fail(const std::string& error);
+
+    const std::string address_;
+    const std::chrono::milliseconds timeout_;
+    const bool vfo_mode_;
+    intptr_t socket_;
+    std::atomic<bool> connected_{true};
+
+    std::thread writer_;
+    std::thread reader_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable outbox_cv_;
+    bool stopping_ = false;
+    // Submitted, not yet written.
+    std::deque<std::unique_ptr<Group>> outbox_;
+    // Written, waiting for replies, in wire order.
+    std::deque<std::unique_ptr<Group>> inflight_;
+    size_t inflight_commands_ = 0;
+    size_t max_inflight_commands_ = 0;
+
+    std::atomic<size_t> clients_{0};
+    std::atomic<uint64_t> groups_{0};
+    std::atomic<uint64_t> commands_{0};
+    std::atomic<uint64_t> errors_{0};
+    LatencyHistogram latency_;
+};
+
+// One HamLib instance's handle on a session. Replies are handed to the
+// instance's JS thread through a ThreadSafeFunction that only keeps the
+// event loop alive while requests are outstanding.
+class RigctldSessionClient {
+public:
+    // (env, replies, error) on the JS thread.
+    using Complete = std::function<void(Napi::Env, std::vector<RigctldReply>&, const std::string&)>;
+
+    RigctldSessionClient(Napi::Env env, std::shared_ptr<RigctldSession> session);
+    ~RigctldSessionClient();
+
+    RigctldSessionClient(const RigctldSessionClient&) = delete;
+    RigctldSessionClient& operator=(const RigctldSessionClient&) = delete;
+
+    // JS thread.
+    void Submit(std::vector<RigctldRequest> requests, Complete complete);
+    RigctldSession& Session() const { return *session_; }
+
+private:
+    // Outlives the client while replies are still on their way.
+    struct Port {
+        Napi::ThreadSafeFunction tsfn;
+        napi_env env = nullptr;
+        // JS thread only.
+        size_t outstanding = 0;
+        ~Port() { tsfn.Release(); }
+    };
+
+    std::shared_ptr<RigctldSession> session_;
+    std::shared_ptr<Port> port_;
+};
@@ -146,6 +146,21 @@ SHIM_API int shim_rig_list_foreach(shim_rig_list_cb_t cb, void* data) {
     return rig_list_foreach(shim_list_foreach_adapter, &adapter);
 }
 
+SHIM_API int shim_rig_get_model_info(unsigned int model, shim_rig_info_t* out_info) {
+    const struct rig_caps *caps;
+    if (!out_info) return -RIG_EINVAL;
+    if (rig_check_backend((rig_model_t)model) != RIG_OK) return -RIG_ENAVAIL;
+    caps = rig_get_caps((rig_model_t)model);
+    if (!caps) return -RIG_ENAVAIL;
+    out_info->rig_model = caps->rig_model;
+    out_info->model_name = caps->model_name ? caps->model_name : "";
+    out_info->mfg_name = caps->mfg_name ? caps->mfg_name : "";
+    out_info->version = caps->version ? caps->version : "";
+    out_info->status = (int)caps->status;
+    out_info->rig_type = (int)(caps->rig_type & RIG_TYPE_MASK);
+    return RIG_OK;
+}
+
 static int shim_rot_list_foreach_adapter(const struct rot_caps *caps, void *data) {
     struct shim_rot_list_adapter *adapter = (struct shim_rot_list_adapter*)data;
     shim_rot_info_t info;
@@ -1604,48 +1619,45 @@ SHIM_API const char* shim_rot_strparm(uint64_t parm) {
 
 /* ===== Callbacks ===== */
 
-/* Internal adapter structs for callback forwarding */
-struct shim_freq_cb_adapter {
-    shim_freq_cb_t user_cb;
-    void* user_arg;
-};
-
-struct shim_ptt_cb_adapter {
-    shim_ptt_cb_t user_cb;
-    void* user_arg;
-};
-
-struct shim_spectrum_cb_adapter {
-    shim_spectrum_cb_t user_cb;
-    void* user_arg;
-};
-
-/* We store adapters statically (one per rig handle - simplified) */
-static struct shim_freq_cb_adapter freq_cb_adapter = {NULL, NULL};
-static struct shim_ptt_cb_adapter ptt_cb_adapter = {NULL, NULL};
-static struct shim_spectrum_cb_adapter spectrum_cb_adapter = {NULL, NULL};
+/*
+ * Hamlib hands each rig's own rig_ptr_t back to the thunk, so the caller's
+ * arg is passed through per rig handle. Only the C function pointer is shared;
+ * the addon registers the same callback for every rig.
+ */
+static shim_freq_cb_t freq_user_cb = NULL;
+static shim_mode_cb_t mode_user_cb = NULL;
+static shim_ptt_cb_t ptt_user_cb = NULL;
+static shim_spectrum_cb_t spectrum_user_cb = NULL;
 
 static int shim_freq_cb_thunk(RIG *rig, vfo_t vfo, freq_t freq, rig_ptr_t arg) {
-    struct shim_freq_cb_adapter *adapter = (struct shim_freq_cb_adapter*)arg;
-    if (adapter && adapter->user_cb) {
-        return adapter->user_cb((void*)rig, (int)vfo, (double)freq, adapter->user_arg);
+    shim_freq_cb_t cb = freq_user_cb;
+    if (cb) {
+        return cb((void*)rig, (int)vfo, (double)freq, arg);
+    }
+    return 0;
+}
+
+static int shim_mode_cb_thunk(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width, rig_ptr_t arg) {
+    shim_mode_cb_t cb = mode_user_cb;
+    if (cb) {
+        return cb((void*)rig, (int)vfo, (int)mode, (int)width, arg);
     }
     return 0;
 }
 
 static int shim_ptt_cb_thunk(RIG *rig, vfo_t vfo, ptt_t ptt, rig_ptr_t arg) {
-    struct shim_ptt_cb_adapter *adapter = (struct shim_ptt_cb_adapter*)arg;
-    if (adapter && adapter->user_cb) {
-        return adapter->user_cb((void*)rig, (int)vfo, (int)ptt, adapter->user_arg);
+    shim_ptt_cb_t cb = ptt_user_cb;
+    if (cb) {
+        return cb((void*)rig, (int)vfo, (int)ptt, arg);
     }
     return 0;
 }
 
 static int shim_spectrum_cb_thunk(RIG *rig, struct rig_spectrum_line *line, rig_ptr_t arg) {
-    struct shim_spectrum_cb_adapter *adapter = (struct shim_spectrum_cb_adapter*)arg;
+    shim_spectrum_cb_t cb = spectrum_user_cb;
     shim_spectrum_line_t safe_line;
 
-    if (!adapter || !adapter->user_cb || !line) {
+    if (!cb || !line) {
         return 0;
     }
 
@@ -1665,25 +1677,35 @@ static int shim_spectrum_cb_thunk(RIG *rig, struct rig_spectrum_line *line, rig_
         memcpy(safe_line.data, line->spectrum_data, (size_t)safe_line.data_length);
     }
 
-    return adapter->user_cb((void*)rig, &safe_line, adapter->user_arg);
+    return cb((void*)rig, &safe_line, arg);
 }
 
 SHIM_API int shim_rig_set_freq_callback(hamlib_shim_handle_t h, shim_freq_cb_t cb, void* arg) {
-    freq_cb_adapter.user_cb = cb;
-    freq_cb_adapter.user_arg = arg;
-    return rig_set_freq_callback((RIG*)h, shim_freq_cb_thunk, &freq_cb_adapter);
+    if (cb) {
+        freq_user_cb = cb;
+    }
+    return rig_set_freq_callback((RIG*)h, cb ? shim_freq_cb_thunk : NULL, cb ? arg : NULL);
+}
+
+SHIM_API int shim_rig_set_mode_callback(hamlib_shim_handle_t h, shim_mode_cb_t cb, void* arg) {
+    if (cb) {
+        mode_user_cb = cb;
+    }
+    return rig_set_mode_callback((RIG*)h, cb ? shim_mode_cb_thunk : NULL, cb ? arg : NULL);
 }
 
 SHIM_API int shim_rig_set_ptt_callback(hamlib_shim_handle_t h, shim_ptt_cb_t cb, void* arg) {
-    ptt_cb_adapter.user_cb = cb;
-    ptt_cb_adapter.user_arg = arg;
-    return rig_set_ptt_callback((RIG*)h, shim_ptt_cb_thunk, &ptt_cb_adapter);
+    if (cb) {
+        ptt_user_cb = cb;
+    }
+    return rig_set_ptt_callback((RIG*)h, cb ? shim_ptt_cb_thunk : NULL, cb ? arg : NULL);
 }
 
 SHIM_API int shim_rig_set_spectrum_callback(hamlib_shim_handle_t h, shim_spectrum_cb_t cb, void* arg) {
-    spectrum_cb_adapter.user_cb = cb;
-    spectrum_cb_adapter.user_arg = arg;
-    return rig_set_spectrum_callback((RIG*)h, cb ? shim_spectrum_cb_thunk : NULL, cb ? &spectrum_cb_adapter : NULL);
+    if (cb) {
+        spectrum_user_cb = cb;
+    }
+    return rig_set_spectrum_callback((RIG*)h, cb ? shim_spectrum_cb_thunk : NULL, cb ? arg : NULL);
 }
 
 /* rig_set_trn: deprecated in Hamlib 4.7.0, may be removed in future versions. */
@@ -1692,7 +1714,21 @@ SHIM_API int shim_rig_set_spectrum_callback(hamlib_shim_handle_t h, shim_spectru
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 #endif
 SHIM_API int shim_rig_set_trn(hamlib_shim_handle_t h, int trn) {
-    return rig_set_trn((RIG*)h, trn);
+    int hamlib_trn;
+    switch (trn) {
+    case SHIM_RIG_TRN_OFF:
+        hamlib_trn = RIG_TRN_OFF;
+        break;
+    case SHIM_RIG_TRN_RIG:
+        hamlib_trn = RIG_TRN_RIG;
+        break;
+    case SHIM_RIG_TRN_POLL:
+        hamlib_trn = RIG_TRN_POLL;
+        break;
+    default:
+        return -RIG_EINVAL;
+    }
+    return rig_set_trn((RIG*)h, hamlib_trn);
 }
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
@@ -2139,6 +2175,33 @@ SHIM_API int shim_rig_get_caps_tx_range(hamlib_shim_handle_t h, shim_freq_range_
     return count;
 }
 
+SHIM_API int shim_rig_get_state_tx_range(hamlib_shim_handle_t h, shim_freq_range_t* out, int max_count) {
+    RIG *rig = (RIG *)h;
+    if (!rig || !out || max_count <= 0) return 0;
+    int count = 0;
+    for (int i = 0; i < HAMLIB_FRQRANGESIZ && count < max_count; i++) {
+        const freq_range_t *r = &rig->state.tx_range_list[i];
+        if (r->startf == 0 && r->endf == 0) break;
+        out[count].start_freq = (double)r->startf;
+        out[count].end_freq = (double)r->endf;
+        out[count].modes = (uint64_t)r->modes;
+        out[count].low_power = (int)r->low_power;
+        out[count].high_power = (int)r->high_power;
+        out[count].vfo = (int)r->vfo;
+        out[count].ant = (int)r->ant;
+        count++;
+    }
+    return count;
+}
+
+SHIM_API int shim_rig_get_power_conversion_hooks(hamlib_shim_handle_t h, int* has_power2mw, int* has_mw2power) {
+    RIG *rig = (RIG *)h;
+    if (!rig || !rig->caps) return SHIM_RIG_EINVAL;
+    if (has_power2mw) *has_power2mw = rig->caps->power2mW != NULL;
+    if (has_mw2power) *has_mw2power = rig->caps->mW2power != NULL;
+    return SHIM_RIG_OK;
+}
+
 /* ===== Capability Query: Tuning steps / Filters ===== */
 
 SHIM_API int shim_rig_get_caps_tuning_steps(hamlib_shim_handle_t h, shim_mode_value_t* out, int max_count) {
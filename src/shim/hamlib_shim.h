@@ -68,6 +68,9 @@ typedef void* hamlib_shim_handle_t;
 #define SHIM_RIG_DCD_OFF     0
 #define SHIM_RIG_DCD_ON      1
 
+/* Spectrum scope modes */
+#define SHIM_RIG_SPECTRUM_MODE_FIXED 2  /* RIG_SPECTRUM_MODE_FIXED */
+
 /* Passband constants */
 #define SHIM_RIG_PASSBAND_NORMAL  0
 #define SHIM_RIG_PASSBAND_NOCHANGE (-1)
@@ -95,8 +98,10 @@ typedef void* hamlib_shim_handle_t;
 #define SHIM_RIG_PARM_KEYLIGHT   (1ULL << 7)
 #define SHIM_RIG_PARM_SCREENSAVER (1ULL << 8)
 
-/* Transceive mode */
-#define SHIM_RIG_TRN_POLL    1
+/* Transceive mode (values match Hamlib's RIG_TRN_*) */
+#define SHIM_RIG_TRN_OFF     0
+#define SHIM_RIG_TRN_RIG     1
+#define SHIM_RIG_TRN_POLL    2
 
 /* Power status */
 #define SHIM_RIG_POWER_UNKNOWN -1
@@ -492,6 +497,9 @@ typedef int (*shim_freq_cb_t)(void* handle, int vfo, double freq, void* arg);
 /* PTT change callback: (handle, vfo, ptt, arg) -> int */
 typedef int (*shim_ptt_cb_t)(void* handle, int vfo, int ptt, void* arg);
 
+/* Mode change callback: (handle, vfo, mode, width, arg) -> int */
+typedef int (*shim_mode_cb_t)(void* handle, int vfo, int mode, int width, void* arg);
+
 /* Spectrum line callback: (handle, line, arg) -> int */
 typedef int (*shim_spectrum_cb_t)(void* handle, const shim_spectrum_line_t* line, void* arg);
 
@@ -517,6 +525,8 @@ SHIM_API int  shim_rig_get_debug(void);
 SHIM_API const char* shim_rig_get_version(void);
 SHIM_API int  shim_rig_load_all_backends(void);
 SHIM_API int  shim_rig_list_foreach(shim_rig_list_cb_t cb, void* data);
+/* Loads only the backend (manufacturer) of `model`; strings point into its caps */
+SHIM_API int  shim_rig_get_model_info(unsigned int model, shim_rig_info_t* out_info);
 SHIM_API int  shim_rig_cfgparams_foreach(hamlib_shim_handle_t h, shim_rig_cfg_cb_t cb, void* data);
 SHIM_API int  shim_rig_get_port_caps(hamlib_shim_handle_t h, shim_rig_port_caps_t* out_caps);
 SHIM_API const char* shim_rig_strstatus(int status);
@@ -776,7 +786,9 @@ SHIM_API const char* shim_rot_strparm(uint64_t parm);
 
 /* ===== Callbacks ===== */
 
+/* `arg` is stored per rig handle. Passing cb = NULL unregisters for that rig. */
 SHIM_API int shim_rig_set_freq_callback(hamlib_shim_handle_t h, shim_freq_cb_t cb, void* arg);
+SHIM_API int shim_rig_set_mode_callback(hamlib_shim_handle_t h, shim_mode_cb_t cb, void* arg);
 SHIM_API int shim_rig_set_ptt_callback(hamlib_shim_handle_t h, shim_ptt_cb_t cb, void* arg);
 SHIM_API int shim_rig_set_spectrum_callback(hamlib_shim_handle_t h, shim_spectrum_cb_t cb, void* arg);
 SHIM_API int shim_rig_set_trn(hamlib_shim_handle_t h, int trn);
@@ -847,6 +859,10 @@ SHIM_API int shim_rig_get_caps_dcs_list(hamlib_shim_handle_t h, unsigned int* ou
 /* Group C: Structured data */
 SHIM_API int shim_rig_get_caps_rx_range(hamlib_shim_handle_t h, shim_freq_range_t* out, int max_count);
 SHIM_API int shim_rig_get_caps_tx_range(hamlib_shim_handle_t h, shim_freq_range_t* out, int max_count);
+/* TX ranges of the configured region (rig_state), as used by rig_power2mW() */
+SHIM_API int shim_rig_get_state_tx_range(hamlib_shim_handle_t h, shim_freq_range_t* out, int max_count);
+/* Whether rig_power2mW()/rig_mW2power() go through a backend hook (which may do rig I/O) */
+SHIM_API int shim_rig_get_power_conversion_hooks(hamlib_shim_handle_t h, int* has_power2mw, int* has_mw2power);
 SHIM_API int shim_rig_get_caps_tuning_steps(hamlib_shim_handle_t h, shim_mode_value_t* out, int max_count);
 SHIM_API int shim_rig_get_caps_filters(hamlib_shim_handle_t h, shim_mode_value_t* out, int max_count);
 SHIM_API int shim_rig_get_level_granularity(hamlib_shim_handle_t h, uint64_t level, shim_granularity_t* out);
@@ -0,0 +1,115 @@
+#include "spectrum_dsp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// The loops below work on contiguous float arrays without data-dependent
+// branches so the compiler can vectorize them at -O2 and above.
+
+SpectrumLineProcessor::SpectrumLineProcessor(const SpectrumProcessingConfig& config)
+    : config_(config) {
+  std::memset(&output_, 0, sizeof(output_));
+}
+
+void SpectrumLineProcessor::Reset() {
+  scopes_.clear();
+}
+
+SpectrumLineProcessor::ScopeState& SpectrumLineProcessor::StateFor(const shim_spectrum_line_t& line, size_t length, bool* fresh) {
+  ScopeState& state = scopes_[line.id];
+  *fresh = state.average.size() != length ||
+    state.mode != line.spectrum_mode ||
+    state.low_edge != line.low_edge_freq ||
+    state.high_edge != line.high_edge_freq ||
+    state.span != line.span_freq;
+  if (*fresh) {
+    state.mode = line.spectrum_mode;
+    state.low_edge = line.low_edge_freq;
+    state.high_edge = line.high_edge_freq;
+    state.span = line.span_freq;
+    state.average.assign(length, 0.0f);
+    state.peak.assign(length, 0.0f);
+  }
+  return state;
+}
+
+const shim_spectrum_line_t& SpectrumLineProcessor::Process(const shim_spectrum_line_t& line) {
+  const size_t header = offsetof(shim_spectrum_line_t, data);
+  std::memcpy(&output_, &line, header);
+
+  const size_t length = std::min(static_cast<size_t>(std::max(line.data_length, 0)), sizeof(line.data));
+  work_.resize(length);
+  float* work = work_.data();
+  const unsigned char* in = line.data;
+
+  if (config_.normalize && line.data_level_max > line.data_level_min) {
+    const float floor = static_cast<float>(line.data_level_min);
+    const float scale = 255.0f / static_cast<float>(line.data_level_max - line.data_level_min);
+    for (size_t i = 0; i < length; ++i) {
+      work[i] = std::min(255.0f, std::max(0.0f, (static_cast<float>(in[i]) - floor) * scale));
+    }
+    output_.data_level_min = 0;
+    output_.data_level_max = 255;
+  } else {
+    for (size_t i = 0; i < length; ++i) {
+      work[i] = static_cast<float>(in[i]);
+    }
+  }
+
+  if (config_.average_alpha < 1.0f || config_.peak_hold) {
+    bool fresh = false;
+    ScopeState& state = StateFor(line, length, &fresh);
+    if (config_.average_alpha < 1.0f) {
+      float* average = state.average.data();
+      if (fresh) {
+        std::copy(work, work + length, average);
+      } else {
+        const float alpha = config_.average_alpha;
+        for (size_t i = 0; i < length; ++i) {
+          average[i] += alpha * (work[i] - average[i]);
+        }
+      }
+      std::copy(average, average + length, work);
+    }
+    if (config_.peak_hold) {
+      float* peak = state.peak.data();
+      if (fresh) {
+        std::copy(work, work + length, peak);
+      } else {
+        const float decay = config_.peak_decay;
+        for (size_t i = 0; i < length; ++i) {
+          peak[i] = std::max(peak[i] - decay, work[i]);
+        }
+      }
+      std::copy(peak, peak + length, work);
+    }
+  }
+
+  size_t out_length = length;
+  if (config_.bins > 0 && config_.bins < length) {
+    out_length = config_.bins;
+    for (size_t bin = 0; bin < out_length; ++bin) {
+      const size_t begin = bin * length / out_length;
+      const size_t end = std::max(begin + 1, (bin + 1) * length / out_length);
+      float value;
+      if (config_.decimation == SpectrumDecimation::Max) {
+        value = *std::max_element(work + begin, work + end);
+      } else {
+        float sum = 0.0f;
+        for (size_t i = begin; i < end; ++i) {
+          sum += work[i];
+        }
+        value = sum / static_cast<float>(end - begin);
+      }
+      // In place: bucket `bin` never reads below index `bin`.
+      work[bin] = value;
+    }
+  }
+
+  for (size_t i = 0; i < out_length; ++i) {
+    output_.data[i] = static_cast<unsigned char>(std::lround(std::min(255.0f, std::max(0.0f, work[i]))));
+  }
+  output_.data_length = static_cast<int>(out_length);
+  return output_;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "shim/hamlib_shim.h"
+#include <cstddef>
+#include <map>
+#include <vector>
+
+enum class SpectrumDecimation {
+  // Keep the strongest bin of each bucket so narrow signals survive.
+  Max,
+  Mean,
+};
+
+struct SpectrumProcessingConfig {
+  // Weight of the newest line in the exponential average; 1 disables it.
+  float average_alpha = 1.0f;
+  bool peak_hold = false;
+  // Levels subtracted from the held peak per line (0 holds forever).
+  float peak_decay = 0.0f;
+  // Target bin count; 0 (or >= the line length) keeps every bin.
+  size_t bins = 0;
+  SpectrumDecimation decimation = SpectrumDecimation::Max;
+  // Rescale data_level_min..data_level_max to 0..255.
+  bool normalize = false;
+
+  bool Enabled() const {
+    return average_alpha < 1.0f || peak_hold || bins > 0 || normalize;
+  }
+};
+
+// Per-scope averaging / max-hold / decimation applied on Hamlib's reader
+// thread before a line is queued for JS. State resets whenever a scope's
+// geometry (mode, edges, span, length) changes. Not thread-safe: Process()
+// must only be called from one producer at a time.
+class SpectrumLineProcessor {
+public:
+    explicit SpectrumLineProcessor(const SpectrumProcessingConfig& config);
+
+    // Returns the processed line; valid until the next Process() call.
+    const shim_spectrum_line_t& Process(const shim_spectrum_line_t& line);
+    void Reset();
+
+    const SpectrumProcessingConfig& Config() const { return config_; }
+
+private:
+    struct ScopeState {
+        int mode = 0;
+        double low_edge = 0;
+        double high_edge = 0;
+        double span = 0;
+        std::vector<float> average;
+        std::vector<float> peak;
+    };
+
+    ScopeState& StateFor(const shim_spectrum_line_t& line, size_t length, bool* fresh);
+
+    const SpectrumProcessingConfig config_;
+    std::map<int, ScopeState> scopes_;
+    std::vector<float> work_;
+    shim_spectrum_line_t output_;
+};
@@ -0,0 +1,654 @@
+#include "spectrum_recorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kSpectrumRecordingMagic[8] = { 'H', 'L', 'S', 'P', 'E', 'C', '\0', '\1' };
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+uint64_t alignDown(uint64_t value, uint64_t alignment) {
+  return value / alignment * alignment;
+}
+
+std::string indexPathFor(const std::string& path) {
+  return path + ".idx";
+}
+
+#ifdef _WIN32
+std::wstring widenPath(const std::string& path) {
+  const int length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+  std::wstring wide(length > 0 ? static_cast<size_t>(length) : 0, L'\0');
+  if (length > 0) {
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wide[0], length);
+    wide.resize(static_cast<size_t>(length - 1));
+  }
+  return wide;
+}
+
+std::string lastSystemError(const char* what) {
+  return std::string(what) + " failed (error " + std::to_string(GetLastError()) + ")";
+}
+
+std::FILE* openIndexFile(const std::string& path, const char* mode) {
+  const std::wstring wide_mode(mode, mode + std::strlen(mode));
+  return _wfopen(widenPath(path).c_str(), wide_mode.c_str());
+}
+#else
+std::string lastSystemError(const char* what) {
+  return std::string(what) + " failed: " + std::strerror(errno);
+}
+
+std::FILE* openIndexFile(const std::string& path, const char* mode) {
+  return std::fopen(path.c_str(), mode);
+}
+#endif
+
+SpectrumRecorderOptions normalizedOptions(SpectrumRecorderOptions options) {
+  const uint64_t granularity = MappedFile::Granularity();
+  options.segment_bytes = alignUp(std::max<uint64_t>(options.segment_bytes, granularity), granularity);
+  return options;
+}
+
+bool validHeader(const SpectrumRecordingFileHeader& header) {
+  return std::memcmp(header.magic, kSpectrumRecordingMagic, sizeof(header.magic)) == 0 &&
+    header.version == kSpectrumRecordingVersion &&
+    header.header_bytes == kSpectrumRecordingHeaderBytes &&
+    header.record_header_bytes == kSpectrumRecordHeaderBytes;
+}
+
+}  // namespace
+
+// ===== MappedFile =====
+
+MappedFile::~MappedFile() {
+  Close();
+}
+
+size_t MappedFile::Granularity() {
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return static_cast<size_t>(info.dwAllocationGranularity);
+#else
+  const long page = sysconf(_SC_PAGESIZE);
+  return page > 0 ? static_cast<size_t>(page) : 4096;
+#endif
+}
+
+bool MappedFile::Open(const std::string& path, bool writable, std::string* error) {
+  Close();
+  writable_ = writable;
+#ifdef _WIN32
+  HANDLE file = CreateFileW(widenPath(path).c_str(),
+    writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+    writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    *error = lastSystemError("CreateFile");
+    return false;
+  }
+  file_ = file;
+#else
+  const int fd = writable ? ::open(path.c_str(), O_RDWR | O_CREAT, 0644) : ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    *error = lastSystemError("open");
+    return false;
+  }
+  fd_ = fd;
+#endif
+  return true;
+}
+
+void MappedFile::Close() {
+  Unmap();
+#ifdef _WIN32
+  if (file_) {
+    CloseHandle(static_cast<HANDLE>(file_));
+    file_ = nullptr;
+  }
+#else
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+#endif
+}
+
+bool MappedFile::IsOpen() const {
+#ifdef _WIN32
+  return file_ != nullptr;
+#else
+  return fd_ >= 0;
+#endif
+}
+
+uint64_t MappedFile::Size(std::string* error) const {
+#ifdef _WIN32
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(static_cast<HANDLE>(file_), &size)) {
+    *error = lastSystemError("GetFileSizeEx");
+    return 0;
+  }
+  return static_cast<uint64_t>(size.QuadPart);
+#else
+  struct stat st;
+  if (fstat(fd_, &st) != 0) {
+    *error = lastSystemError("fstat");
+    return 0;
+  }
+  return static_cast<uint64_t>(st.st_size);
+#endif
+}
+
+bool MappedFile::Resize(uint64_t size, std::string* error) {
+#ifdef _WIN32
+  LARGE_INTEGER position;
+  position.QuadPart = static_cast<LONGLONG>(size);
+  if (!SetFilePointerEx(static_cast<HANDLE>(file_), position, nullptr, FILE_BEGIN) ||
+      !SetEndOfFile(static_cast<HANDLE>(file_))) {
+    *error = lastSystemError("SetEndOfFile");
+    return false;
+  }
+#else
+  struct stat st;
+  const bool growing = fstat(fd_, &st) == 0 && static_cast<uint64_t>(st.st_size) < size;
+#if defined(__linux__)
+  // Reserve the blocks up front: writing through a mapping into a sparse
+  // file on a full disk raises SIGBUS instead of returning an error.
+  if (growing) {
+    const int result = posix_fallocate(fd_, static_cast<off_t>(st.st_size), static_cast<off_t>(size - st.st_size));
+    if (result == 0) {
+      return true;
+    }
+    if (result != EINVAL && result != EOPNOTSUPP) {
+      errno = result;
+      *error = lastSystemError("posix_fallocate");
+      return false;
+    }
+  }
+#else
+  (void)growing;
+#endif
+  if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+    *error = lastSystemError("ftruncate");
+    return false;
+  }
+#endif
+  return true;
+}
+
+uint8_t* MappedFile::Map(uint64_t offset, size_t length, std::string* error) {
+  Unmap();
+#ifdef _WIN32
+  const uint64_t end = offset + length;
+  HANDLE mapping = CreateFileMappingW(static_cast<HANDLE>(file_), nullptr,
+    writable_ ? PAGE_READWRITE : PAGE_READONLY,
+    static_cast<DWORD>(end >> 32), static_cast<DWORD>(end & 0xFFFFFFFFu), nullptr);
+  if (!mapping) {
+    *error = lastSystemError("CreateFileMapping");
+    return nullptr;
+  }
+  void* view = MapViewOfFile(mapping, writable_ ? FILE_MAP_WRITE : FILE_MAP_READ,
+    static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset & 0xFFFFFFFFu), length);
+  if (!view) {
+    *error = lastSystemError("MapViewOfFile");
+    CloseHandle(mapping);
+    return nullptr;
+  }
+  mapping_ = mapping;
+#else
+  void* view = mmap(nullptr, length, writable_ ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED,
+    fd_, static_cast<off_t>(offset));
+  if (view == MAP_FAILED) {
+    *error = lastSystemError("mmap");
+    return nullptr;
+  }
+#endif
+  view_ = static_cast<uint8_t*>(view);
+  view_offset_ = offset;
+  view_length_ = length;
+  return view_;
+}
+
+void MappedFile::Unmap() {
+  if (!view_) {
+    return;
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(view_);
+  CloseHandle(static_cast<HANDLE>(mapping_));
+  mapping_ = nullptr;
+#else
+  munmap(view_, view_length_);
+#endif
+  view_ = nullptr;
+  view_offset_ = 0;
+  view_length_ = 0;
+}
+
+// ===== SpectrumRecorder =====
+
+std::unique_ptr<SpectrumRecorder> SpectrumRecorder::Create(const std::string& path, const SpectrumRecorderOptions& options,
+                                                           std::string* error) {
+  std::unique_ptr<SpectrumRecorder> recorder(new SpectrumRecorder(path, options));
+  if (!recorder->Initialize(error)) {
+    return nullptr;
+  }
+  recorder->writer_ = std::thread([raw = recorder.get()]() { raw->WriterMain(); });
+  return recorder;
+}
+
+SpectrumRecorder::SpectrumRecorder(const std::string& path, const SpectrumRecorderOptions& options)
+    : path_(path), options_(normalizedOptions(options)), queue_(kSpectrumRecorderQueueLines) {}
+
+SpectrumRecorder::~SpectrumRecorder() {
+  Close();
+}
+
+bool SpectrumRecorder::Initialize(std::string* error) {
+  if (!data_.Open(path_, true, error) || !header_file_.Open(path_, true, error)) {
+    return false;
+  }
+  const uint64_t existing = data_.Size(error);
+  if (!error->empty()) {
+    return false;
+  }
+
+  SpectrumRecordingFileHeader previous{};
+  if (existing > 0) {
+    // Continue an existing recording; refuse to clobber anything else.
+    if (existing < kSpectrumRecordingHeaderBytes ||
+        !data_.Map(0, kSpectrumRecordingHeaderBytes, error)) {
+      if (error->empty()) {
+        *error = "File exists and is not a spectrum recording";
+      }
+      return false;
+    }
+    std::memcpy(&previous, data_.View(), sizeof(previous));
+    data_.Unmap();
+    if (!validHeader(previous) || previous.data_end < kSpectrumRecordingHeaderBytes || previous.data_end > existing) {
+      *error = "File exists and is not a spectrum recording";
+      return false;
+    }
+  }
+
+  const uint64_t granularity = MappedFile::Granularity();
+  write_offset_ = existing > 0 ? previous.data_end : kSpectrumRecordingHeaderBytes;
+  file_size_ = std::max(existing, alignUp(write_offset_ + options_.segment_bytes, options_.segment_bytes));
+  if (!data_.Resize(file_size_, error)) {
+    return false;
+  }
+
+  uint8_t* header_view = header_file_.Map(0, static_cast<size_t>(granularity), error);
+  if (!header_view) {
+    return false;
+  }
+  header_ = reinterpret_cast<SpectrumRecordingFileHeader*>(header_view);
+  if (existing == 0) {
+    std::memset(header_, 0, sizeof(*header_));
+    std::memcpy(header_->magic, kSpectrumRecordingMagic, sizeof(header_->magic));
+    header_->version = kSpectrumRecordingVersion;
+    header_->header_bytes = kSpectrumRecordingHeaderBytes;
+    header_->record_header_bytes = kSpectrumRecordHeaderBytes;
+    header_->index_interval_ms = options_.index_interval_ms;
+    header_->data_end = write_offset_;
+  }
+
+  // Keep only index entries for records that made it into data_end; a crash
+  // can leave entries pointing at space that is about to be rewritten.
+  const std::string index_path = indexPathFor(path_);
+  std::vector<SpectrumIndexEntry> kept;
+  if (existing > 0) {
+    if (std::FILE* previous_index = openIndexFile(index_path, "rb")) {
+      SpectrumIndexEntry entry;
+      while (std::fread(&entry, sizeof(entry), 1, previous_index) == 1 && entry.offset < write_offset_) {
+        kept.push_back(entry);
+      }
+      std::fclose(previous_index);
+    }
+  }
+  index_ = openIndexFile(index_path, "wb");
+  if (!index_) {
+    *error = lastSystemError("open index");
+    return false;
+  }
+  if (!kept.empty() &&
+      (std::fwrite(kept.data(), sizeof(SpectrumIndexEntry), kept.size(), index_) != kept.size() || std::fflush(index_) != 0)) {
+    *error = lastSystemError("write index");
+    return false;
+  }
+  index_entries_ = kept.size();
+  if (!kept.empty()) {
+    last_index_timestamp_ = kept.back().timestamp;
+  }
+  PublishStats();
+  return true;
+}
+
+bool SpectrumRecorder::EnsureWritable(size_t record_bytes, std::string* error) {
+  const uint64_t record_end = write_offset_ + record_bytes;
+  if (data_.View() && record_end <= data_.ViewOffset() + data_.ViewLength()) {
+    return true;
+  }
+
+  const uint64_t granularity = MappedFile::Granularity();
+  const uint64_t view_offset = alignDown(write_offset_, granularity);
+  const uint64_t view_length = alignUp(std::max<uint64_t>(options_.segment_bytes, record_end - view_offset), granularity);
+  const uint64_t view_end = view_offset + view_length;
+  if (view_end > file_size_) {
+    const uint64_t grown = alignUp(view_end, options_.segment_bytes);
+    if (!data_.Resize(grown, error)) {
+      return false;
+    }
+    file_size_ = grown;
+  }
+  return data_.Map(view_offset, static_cast<size_t>(view_length), error) != nullptr;
+}
+
+bool SpectrumRecorder::Append(const shim_spectrum_line_t& line, double timestamp) {
+  {
+    std::lock_guard<std::mutex> guard(queue_mutex_);
+    if (failed_.load(std::memory_order_acquire) || stopping_) {
+      return false;
+    }
+    if (queue_count_ == queue_.size()) {
+      dropped_lines_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    QueuedLine& slot = queue_[(queue_head_ + queue_count_) % queue_.size()];
+    std::memcpy(&slot.line, &line, sizeof(line));
+    slot.timestamp = timestamp;
+    ++queue_count_;
+  }
+  queue_cv_.notify_one();
+  return true;
+}
+
+void SpectrumRecorder::WriterMain() {
+  std::unique_lock<std::mutex> lock(queue_mutex_);
+  while (true) {
+    queue_cv_.wait(lock, [this]() { return stopping_ || queue_count_ > 0; });
+    if (queue_count_ == 0) {
+      return;
+    }
+    // Append() only fills slots behind the head, so this one stays put.
+    const QueuedLine& queued = queue_[queue_head_];
+    lock.unlock();
+    if (!failed_.load(std::memory_order_acquire)) {
+      Write(queued.line, queued.timestamp);
+    }
+    lock.lock();
+    queue_head_ = (queue_head_ + 1) % queue_.size();
+    --queue_count_;
+  }
+}
+
+bool SpectrumRecorder::Write(const shim_spectrum_line_t& line, double timestamp) {
+  const size_t length = std::min(static_cast<size_t>(std::max(line.data_length, 0)), sizeof(line.data));
+  const size_t record_bytes = static_cast<size_t>(alignUp(kSpectrumRecordHeaderBytes + length, 8));
+  std::string error;
+  if (!EnsureWritable(record_bytes, &error)) {
+    Fail(error);
+    return false;
+  }
+
+  SpectrumRecordHeader record;
+  record.record_bytes = static_cast<uint32_t>(record_bytes);
+  record.data_length = static_cast<uint32_t>(length);
+  record.scope_id = line.id;
+  record.mode = line.spectrum_mode;
+  record.data_level_min = line.data_level_min;
+  record.data_level_max = line.data_level_max;
+  record.timestamp = timestamp;
+  record.center_freq = line.center_freq;
+  record.span_freq = line.span_freq;
+  record.low_edge_freq = line.low_edge_freq;
+  record.high_edge_freq = line.high_edge_freq;
+  record.signal_strength_min = line.signal_strength_min;
+  record.signal_strength_max = line.signal_strength_max;
+
+  uint8_t* out = data_.View() + (write_offset_ - data_.ViewOffset());
+  std::memcpy(out, &record, sizeof(record));
+  std::memcpy(out + sizeof(record), line.data, length);
+  std::memset(out + sizeof(record) + length, 0, record_bytes - sizeof(record) - length);
+
+  const uint64_t record_offset = write_offset_;
+  write_offset_ += record_bytes;
+  if (header_->line_count == 0) {
+    header_->first_timestamp = timestamp;
+  }
+  header_->last_timestamp = timestamp;
+  ++header_->line_count;
+  // Publish the record only after its bytes are in place.
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->data_end = write_offset_;
+
+  if (index_entries_ == 0 || timestamp - last_index_timestamp_ >= options_.index_interval_ms) {
+    const SpectrumIndexEntry entry = { timestamp, record_offset };
+    if (std::fwrite(&entry, sizeof(entry), 1, index_) != 1 || std::fflush(index_) != 0) {
+      Fail(lastSystemError("write index"));
+      return false;
+    }
+    ++index_entries_;
+    last_index_timestamp_ = timestamp;
+  }
+  PublishStats();
+  return true;
+}
+
+void SpectrumRecorder::PublishStats() {
+  lines_.store(header_->line_count, std::memory_order_relaxed);
+  data_bytes_.store(header_->data_end - kSpectrumRecordingHeaderBytes, std::memory_order_relaxed);
+  first_timestamp_.store(header_->first_timestamp, std::memory_order_relaxed);
+  last_timestamp_.store(header_->last_timestamp, std::memory_order_relaxed);
+  published_index_entries_.store(index_entries_, std::memory_order_relaxed);
+}
+
+void SpectrumRecorder::Fail(const std::string& error) {
+  std::lock_guard<std::mutex> guard(queue_mutex_);
+  last_error_ = error;
+  failed_.store(true, std::memory_order_release);
+}
+
+void SpectrumRecorder::Close() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  {
+    std::lock_guard<std::mutex> guard(queue_mutex_);
+    stopping_ = true;
+  }
+  queue_cv_.notify_all();
+  // The writer drains the queue before it exits.
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+  data_.Unmap();
+  const uint64_t data_end = header_ ? header_->data_end : write_offset_;
+  header_file_.Close();
+  header_ = nullptr;
+  if (data_.IsOpen()) {
+    // Best effort: trimming fails while a reader still maps the file on
+    // Windows, and readers ignore the reserved tail anyway.
+    std::string ignored;
+    data_.Resize(data_end, &ignored);
+    data_.Close();
+  }
+  if (index_) {
+    std::fclose(index_);
+    index_ = nullptr;
+  }
+}
+
+SpectrumRecorderStats SpectrumRecorder::GetStats() const {
+  SpectrumRecorderStats stats;
+  stats.path = path_;
+  stats.lines = lines_.load(std::memory_order_relaxed);
+  stats.data_bytes = data_bytes_.load(std::memory_order_relaxed);
+  stats.first_timestamp = first_timestamp_.load(std::memory_order_relaxed);
+  stats.last_timestamp = last_timestamp_.load(std::memory_order_relaxed);
+  stats.index_entries = published_index_entries_.load(std::memory_order_relaxed);
+  stats.dropped_lines = dropped_lines_.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> guard(queue_mutex_);
+  stats.failed = failed_.load(std::memory_order_acquire);
+  stats.last_error = last_error_;
+  return stats;
+}
+
+// ===== SpectrumRecordingReader =====
+
+bool SpectrumRecordingReader::Open(const std::string& path, std::string* error) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  path_ = path;
+  index_.clear();
+  index_bytes_read_ = 0;
+  if (!data_.Open(path, false, error)) {
+    return false;
+  }
+  if (!RefreshLocked(error)) {
+    data_.Close();
+    return false;
+  }
+  return true;
+}
+
+void SpectrumRecordingReader::Close() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  data_.Close();
+  index_.clear();
+}
+
+bool SpectrumRecordingReader::RefreshLocked(std::string* error) {
+  if (!data_.IsOpen()) {
+    *error = "Spectrum recording is closed";
+    return false;
+  }
+  const uint64_t size = data_.Size(error);
+  if (!error->empty()) {
+    return false;
+  }
+  if (size < kSpectrumRecordingHeaderBytes) {
+    *error = "Not a spectrum recording";
+    return false;
+  }
+  if (!data_.View() || data_.ViewLength() < size) {
+    if (!data_.Map(0, static_cast<size_t>(size), error)) {
+      return false;
+    }
+  }
+  std::memcpy(&header_, data_.View(), sizeof(header_));
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (!validHeader(header_)) {
+    *error = "Not a spectrum recording";
+    return false;
+  }
+  header_.data_end = std::min<uint64_t>(header_.data_end, data_.ViewLength());
+
+  // Pick up index entries appended since the last refresh; a missing index
+  // only makes seeks slower.
+  std::FILE* index = openIndexFile(indexPathFor(path_), "rb");
+  if (index) {
+    if (std::fseek(index, static_cast<long>(index_bytes_read_), SEEK_SET) == 0) {
+      SpectrumIndexEntry entry;
+      while (std::fread(&entry, sizeof(entry), 1, index) == 1) {
+        index_bytes_read_ += sizeof(entry);
+        if (entry.offset >= kSpectrumRecordingHeaderBytes && entry.offset < header_.data_end) {
+          index_.push_back(entry);
+        }
+      }
+    }
+    std::fclose(index);
+  }
+  return true;
+}
+
+bool SpectrumRecordingReader::GetInfo(SpectrumRecordingInfo* info, std::string* error) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!RefreshLocked(error)) {
+    return false;
+  }
+  info->version = header_.version;
+  info->lines = header_.line_count;
+  info->data_bytes = header_.data_end - kSpectrumRecordingHeaderBytes;
+  info->index_entries = index_.size();
+  info->first_timestamp = header_.first_timestamp;
+  info->last_timestamp = header_.last_timestamp;
+  return true;
+}
+
+uint64_t SpectrumRecordingReader::SeekLocked(double from_ms) const {
+  // Last index entry at or before from_ms; scanning starts there.
+  auto after = std::upper_bound(index_.begin(), index_.end(), from_ms,
+    [](double value, const SpectrumIndexEntry& entry) { return value < entry.timestamp; });
+  if (after == index_.begin()) {
+    return kSpectrumRecordingHeaderBytes;
+  }
+  return std::prev(after)->offset;
+}
+
+bool SpectrumRecordingReader::Read(double from_ms, double to_ms, uint64_t max_bytes, uint64_t start_offset,
+                                   SpectrumRecordingSlice* slice, std::string* error) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!RefreshLocked(error)) {
+    return false;
+  }
+
+  const uint8_t* base = data_.View();
+  const uint64_t data_end = header_.data_end;
+  auto recordAt = [&](uint64_t offset, SpectrumRecordHeader* record) {
+    if (offset + kSpectrumRecordHeaderBytes > data_end) {
+      return false;
+    }
+    std::memcpy(record, base + offset, sizeof(*record));
+    return record->record_bytes >= kSpectrumRecordHeaderBytes && offset + record->record_bytes <= data_end;
+  };
+
+  if (start_offset != 0 && (start_offset < kSpectrumRecordingHeaderBytes || start_offset % 8 != 0)) {
+    *error = "Invalid recording offset";
+    return false;
+  }
+  SpectrumRecordHeader record;
+  uint64_t offset = start_offset != 0 ? start_offset : SeekLocked(from_ms);
+  while (recordAt(offset, &record) && record.timestamp < from_ms) {
+    offset += record.record_bytes;
+  }
+
+  slice->begin_offset = offset;
+  uint64_t end = offset;
+  while (recordAt(end, &record) && record.timestamp <= to_ms) {
+    if (slice->lines > 0 && end - offset + record.record_bytes > max_bytes) {
+      slice->complete = false;
+      break;
+    }
+    if (slice->lines == 0) {
+      slice->first_timestamp = record.timestamp;
+    }
+    slice->last_timestamp = record.timestamp;
+    ++slice->lines;
+    end += record.record_bytes;
+  }
+  slice->end_offset = end;
+  slice->data.assign(base + offset, base + end);
+  return true;
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+#include "shim/hamlib_shim.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// On-disk layout (host byte order, little-endian on every supported target):
+//
+//   file header    kSpectrumRecordingHeaderBytes
+//   record         kSpectrumRecordHeaderBytes fixed header + payload, padded
+//   record         to a multiple of 8 bytes
+//   ...
+//
+// Readers only trust bytes below the header's data_end, which is published
+// after each record is complete. A sidecar "<path>.idx" holds sparse
+// (timestamp, offset) pairs so a time can be located without scanning the
+// whole file.
+constexpr size_t kSpectrumRecordingHeaderBytes = 64;
+constexpr size_t kSpectrumRecordHeaderBytes = 80;
+constexpr uint32_t kSpectrumRecordingVersion = 1;
+
+struct SpectrumRecordingFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_bytes;
+  uint32_t record_header_bytes;
+  uint32_t index_interval_ms;
+  uint64_t data_end;
+  uint64_t line_count;
+  double first_timestamp;
+  double last_timestamp;
+  uint64_t reserved;
+};
+
+struct SpectrumRecordHeader {
+  uint32_t record_bytes;
+  uint32_t data_length;
+  int32_t scope_id;
+  int32_t mode;
+  int32_t data_level_min;
+  int32_t data_level_max;
+  double timestamp;
+  double center_freq;
+  double span_freq;
+  double low_edge_freq;
+  double high_edge_freq;
+  double signal_strength_min;
+  double signal_strength_max;
+};
+
+struct SpectrumIndexEntry {
+  double timestamp;
+  uint64_t offset;
+};
+
+static_assert(sizeof(SpectrumRecordingFileHeader) == kSpectrumRecordingHeaderBytes, "file header layout");
+static_assert(sizeof(SpectrumRecordHeader) == kSpectrumRecordHeaderBytes, "record header layout");
+static_assert(sizeof(SpectrumIndexEntry) == 16, "index entry layout");
+
+// A read-write or read-only view of part of a file (mmap / MapViewOfFile).
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path, bool writable, std::string* error);
+    void Close();
+    bool IsOpen() const;
+    uint64_t Size(std::string* error) const;
+    // Grows (reserving disk space where the platform allows) or shrinks the file.
+    bool Resize(uint64_t size, std::string* error);
+
+    // Replaces the current view. offset must be a multiple of Granularity().
+    uint8_t* Map(uint64_t offset, size_t length, std::string* error);
+    void Unmap();
+    uint8_t* View() const { return view_; }
+    uint64_t ViewOffset() const { return view_offset_; }
+    size_t ViewLength() const { return view_length_; }
+
+    static size_t Granularity();
+
+private:
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    bool writable_ = false;
+    uint8_t* view_ = nullptr;
+    uint64_t view_offset_ = 0;
+    size_t view_length_ = 0;
+};
+
+struct SpectrumRecorderOptions {
+  // Bytes mapped (and reserved on disk) at a time; rounded up to the
+  // platform's mapping granularity.
+  uint64_t segment_bytes = 16 * 1024 * 1024;
+  // Minimum spacing of index entries.
+  uint32_t index_interval_ms = 1000;
+};
+
+struct SpectrumRecorderStats {
+  std::string path;
+  uint64_t lines = 0;
+  uint64_t data_bytes = 0;
+  uint64_t index_entries = 0;
+  double first_timestamp = 0;
+  double last_timestamp = 0;
+  // Lines lost because the writer thread was kSpectrumRecorderQueueLines
+  // lines behind.
+  uint64_t dropped_lines = 0;
+  bool failed = false;
+  std::string last_error;
+};
+
+constexpr size_t kSpectrumRecorderQueueLines = 256;
+
+// Appends spectrum lines to a recording. An existing recording at the same
+// path is continued rather than overwritten. Append() only copies the line
+// into a fixed queue, so Hamlib's reader thread never waits for the disk;
+// the recorder's own writer thread maps, grows and writes the file. Append
+// and GetStats are thread-safe; Close is called by the owner once.
+class SpectrumRecorder {
+public:
+    static std::unique_ptr<SpectrumRecorder> Create(const std::string& path, const SpectrumRecorderOptions& options,
+                                                    std::string* error);
+    ~SpectrumRecorder();
+
+    // Returns false once the recorder has failed (e.g. disk full); later
+    // lines are ignored and the error is kept in the stats.
+    bool Append(const shim_spectrum_line_t& line, double timestamp);
+    // Writes the queued lines, trims the reserved tail and closes the files.
+    void Close();
+    SpectrumRecorderStats GetStats() const;
+
+private:
+    struct QueuedLine {
+        shim_spectrum_line_t line;
+        double timestamp = 0;
+    };
+
+    SpectrumRecorder(const std::string& path, const SpectrumRecorderOptions& options);
+    bool Initialize(std::string* error);
+    void WriterMain();
+    // Writer thread (or Initialize) only, like the file state below.
+    bool Write(const shim_spectrum_line_t& line, double timestamp);
+    bool EnsureWritable(size_t record_bytes, std::string* error);
+    void PublishStats();
+    void Fail(const std::string& error);
+
+    const std::string path_;
+    const SpectrumRecorderOptions options_;
+    MappedFile data_;
+    MappedFile header_file_;
+    SpectrumRecordingFileHeader* header_ = nullptr;
+    std::FILE* index_ = nullptr;
+    uint64_t file_size_ = 0;
+    uint64_t write_offset_ = 0;
+    uint64_t index_entries_ = 0;
+    double last_index_timestamp_ = 0;
+    bool closed_ = false;
+
+    // Ring of lines handed from Append() to the writer thread.
+    mutable std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::vector<QueuedLine> queue_;
+    size_t queue_head_ = 0;
+    size_t queue_count_ = 0;
+    bool stopping_ = false;
+    std::string last_error_;
+    std::thread writer_;
+
+    // Published by the writer for GetStats().
+    std::atomic<bool> failed_{false};
+    std::atomic<uint64_t> lines_{0};
+    std::atomic<uint64_t> data_bytes_{0};
+    std::atomic<uint64_t> published_index_entries_{0};
+    std::atomic<double> first_timestamp_{0};
+    std::atomic<double> last_timestamp_{0};
+    std::atomic<uint64_t> dropped_lines_{0};
+};
+
+struct SpectrumRecordingInfo {
+  uint32_t version = 0;
+  uint64_t lines = 0;
+  uint64_t data_bytes = 0;
+  uint64_t index_entries = 0;
+  double first_timestamp = 0;
+  double last_timestamp = 0;
+};
+
+struct SpectrumRecordingSlice {
+  // Raw records (header + padded payload), exactly as stored.
+  std::vector<uint8_t> data;
+  uint64_t lines = 0;
+  double first_timestamp = 0;
+  double last_timestamp = 0;
+  // File offsets of the slice; end is where a follow-up read continues.
+  uint64_t begin_offset = 0;
+  uint64_t end_offset = 0;
+  // False when max_bytes cut the range short.
+  bool complete = true;
+};
+
+// Read-only access to a recording, including one that is still being
+// written: each call picks up lines appended since the last one. Thread-safe.
+class SpectrumRecordingReader {
+public:
+    bool Open(const std::string& path, std::string* error);
+    void Close();
+    bool GetInfo(SpectrumRecordingInfo* info, std::string* error);
+    // Copies the records with from_ms <= timestamp <= to_ms, at most
+    // max_bytes of them (always at least one record if any match). A non-zero
+    // start_offset (a previous slice's end_offset) continues from there
+    // instead of seeking by time.
+    bool Read(double from_ms, double to_ms, uint64_t max_bytes, uint64_t start_offset,
+              SpectrumRecordingSlice* slice, std::string* error);
+
+private:
+    bool RefreshLocked(std::string* error);
+    uint64_t SeekLocked(double from_ms) const;
+
+    mutable std::mutex mutex_;
+    std::string path_;
+    MappedFile data_;
+    SpectrumRecordingFileHeader header_{};
+    std::vector<SpectrumIndexEntry> index_;
+    uint64_t index_bytes_read_ = 0;
+};
@@ -0,0 +1,188 @@
+#include "spectrum_ring.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Copies the header and only the used part of the payload.
+void copySpectrumLine(shim_spectrum_line_t* target, const shim_spectrum_line_t& source) {
+  const size_t header = offsetof(shim_spectrum_line_t, data);
+  std::memcpy(target, &source, header);
+  const size_t length = std::min(static_cast<size_t>(std::max(source.data_length, 0)), sizeof(source.data));
+  target->data_length = static_cast<int>(length);
+  std::memcpy(target->data, source.data, length);
+}
+
+}  // namespace
+
+SpectrumLineRing::SpectrumLineRing(size_t capacity, SpectrumOverflowPolicy policy, size_t batch_lines,
+                                   std::chrono::milliseconds max_latency)
+    : capacity_(std::max<size_t>(capacity, 1)),
+      policy_(policy),
+      batch_lines_(std::max<size_t>(batch_lines, 1)),
+      max_latency_(std::max(max_latency, std::chrono::milliseconds(1))),
+      pool_(new SpectrumLineSlot[capacity_]) {
+  free_.reserve(capacity_);
+  for (size_t i = capacity_; i > 0; --i) {
+    pool_[i - 1].pooled = true;
+    free_.push_back(&pool_[i - 1]);
+  }
+}
+
+SpectrumLineRing::~SpectrumLineRing() {
+  StopLatencyTimer();
+  for (SpectrumLineSlot* slot : pending_) {
+    if (!slot->pooled) {
+      delete slot;
+    }
+  }
+}
+
+bool SpectrumLineRing::Push(const shim_spectrum_line_t& line, double timestamp) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  ++received_;
+
+  if (policy_ == SpectrumOverflowPolicy::KeepLatest) {
+    auto same_scope = std::find_if(pending_.begin(), pending_.end(),
+      [&line](const SpectrumLineSlot* slot) { return slot->line.id == line.id; });
+    if (same_scope != pending_.end()) {
+      copySpectrumLine(&(*same_scope)->line, line);
+      (*same_scope)->timestamp = timestamp;
+      ++coalesced_;
+      return false;
+    }
+  }
+
+  if (pending_.size() >= capacity_) {
+    SpectrumLineSlot* oldest = pending_.front();
+    pending_.pop_front();
+    RecycleLocked(oldest);
+    ++dropped_;
+  }
+
+  SpectrumLineSlot* slot = AcquireSlotLocked();
+  copySpectrumLine(&slot->line, line);
+  slot->timestamp = timestamp;
+  slot->enqueued_at = std::chrono::steady_clock::now();
+  pending_.push_back(slot);
+  if (pending_.size() < batch_lines_) {
+    if (pending_.size() == 1) {
+      timer_cv_.notify_one();
+    }
+    return false;
+  }
+  return !flush_pending_.exchange(true, std::memory_order_acq_rel);
+}
+
+void SpectrumLineRing::CancelFlush() {
+  flush_pending_.store(false, std::memory_order_release);
+}
+
+void SpectrumLineRing::StartLatencyTimer(std::function<void()> on_due) {
+  if (batch_lines_ <= 1 || timer_thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    on_due_ = std::move(on_due);
+    timer_stopping_ = false;
+  }
+  timer_thread_ = std::thread([this]() { LatencyTimerMain(); });
+}
+
+void SpectrumLineRing::StopLatencyTimer() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    timer_stopping_ = true;
+  }
+  timer_cv_.notify_one();
+  if (!timer_thread_.joinable()) {
+    return;
+  }
+  if (timer_thread_.get_id() == std::this_thread::get_id()) {
+    timer_thread_.detach();
+  } else {
+    timer_thread_.join();
+  }
+}
+
+void SpectrumLineRing::LatencyTimerMain() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!timer_stopping_) {
+    if (pending_.empty()) {
+      timer_cv_.wait(lock);
+      continue;
+    }
+    const auto due = pending_.front()->enqueued_at + max_latency_;
+    if (std::chrono::steady_clock::now() < due) {
+      timer_cv_.wait_until(lock, due);
+      continue;
+    }
+    if (!flush_pending_.exchange(true, std::memory_order_acq_rel)) {
+      std::function<void()> on_due = on_due_;
+      lock.unlock();
+      on_due();
+      lock.lock();
+    }
+    // Give the queued flush time to drain before looking again.
+    timer_cv_.wait_for(lock, max_latency_);
+  }
+}
+
+std::vector<SpectrumLineSlot*> SpectrumLineRing::TakePending() {
+  // Clear the flag first so a line pushed while JS is draining schedules its
+  // own flush instead of being stranded.
+  flush_pending_.store(false, std::memory_order_release);
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  std::vector<SpectrumLineSlot*> slots(pending_.begin(), pending_.end());
+  pending_.clear();
+  in_use_ += slots.size();
+  delivered_ += slots.size();
+  return slots;
+}
+
+void SpectrumLineRing::Release(SpectrumLineSlot* slot) {
+  if (!slot) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (in_use_ > 0) {
+    --in_use_;
+  }
+  RecycleLocked(slot);
+}
+
+SpectrumRingStats SpectrumLineRing::GetStats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  SpectrumRingStats stats;
+  stats.capacity = capacity_;
+  stats.pending = pending_.size();
+  stats.in_use = in_use_;
+  stats.received = received_;
+  stats.delivered = delivered_;
+  stats.dropped = dropped_;
+  stats.coalesced = coalesced_;
+  stats.pool_misses = pool_misses_;
+  return stats;
+}
+
+SpectrumLineSlot* SpectrumLineRing::AcquireSlotLocked() {
+  if (!free_.empty()) {
+    SpectrumLineSlot* slot = free_.back();
+    free_.pop_back();
+    return slot;
+  }
+  // Every pooled slot is queued or still referenced from JS.
+  ++pool_misses_;
+  return new SpectrumLineSlot();
+}
+
+void SpectrumLineRing::RecycleLocked(SpectrumLineSlot* slot) {
+  if (slot->pooled) {
+    free_.push_back(slot);
+  } else {
+    delete slot;
+  }
+}
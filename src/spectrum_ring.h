@@ -0,0 +1,110 @@
+#pragma once
+
+#include "shim/hamlib_shim.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum class SpectrumOverflowPolicy {
+  // Backlog full: discard the oldest undelivered line.
+  DropOldest,
+  // Replace an undelivered line of the same scope, so JS only ever sees the
+  // newest line per scopeId.
+  KeepLatest,
+};
+
+struct SpectrumLineSlot {
+  shim_spectrum_line_t line;
+  double timestamp = 0;
+  std::chrono::steady_clock::time_point enqueued_at;
+  bool pooled = false;
+};
+
+struct SpectrumRingStats {
+  size_t capacity = 0;
+  size_t pending = 0;
+  size_t in_use = 0;
+  uint64_t received = 0;
+  uint64_t delivered = 0;
+  uint64_t dropped = 0;
+  uint64_t coalesced = 0;
+  uint64_t pool_misses = 0;
+};
+
+// Preallocated line slots between Hamlib's async reader thread (Push) and the
+// JS thread (TakePending / Release). Delivered slots are lent to JS as external
+// buffers and come back through Release() when those buffers are collected;
+// if JS holds every pooled slot, lines spill into heap slots instead of being
+// lost. Only the undelivered backlog is bounded, by the overflow policy.
+//
+// With batch_lines > 1 a flush is requested only once a full batch is
+// pending; the latency timer flushes a partial batch once its oldest line has
+// waited max_latency.
+class SpectrumLineRing {
+public:
+    SpectrumLineRing(size_t capacity, SpectrumOverflowPolicy policy, size_t batch_lines = 1,
+                     std::chrono::milliseconds max_latency = std::chrono::milliseconds(0));
+    ~SpectrumLineRing();
+
+    SpectrumLineRing(const SpectrumLineRing&) = delete;
+    SpectrumLineRing& operator=(const SpectrumLineRing&) = delete;
+
+    // Producer side. Returns true when the caller should schedule a flush to
+    // the JS thread (no flush was pending).
+    bool Push(const shim_spectrum_line_t& line, double timestamp);
+    // Called when scheduling the flush failed, so the next Push retries.
+    void CancelFlush();
+
+    // Starts the thread that calls on_due (off the JS thread, without the ring
+    // lock held) to flush a partial batch. on_due must schedule a flush or
+    // call CancelFlush(). No-op unless batching.
+    void StartLatencyTimer(std::function<void()> on_due);
+    // Joins the timer thread; on_due is not called again afterwards.
+    void StopLatencyTimer();
+
+    // JS thread. Takes every undelivered line in arrival order; the caller owns
+    // the slots until it hands each back through Release().
+    std::vector<SpectrumLineSlot*> TakePending();
+    void Release(SpectrumLineSlot* slot);
+
+    SpectrumOverflowPolicy Policy() const { return policy_; }
+    size_t BatchLines() const { return batch_lines_; }
+    std::chrono::milliseconds MaxLatency() const { return max_latency_; }
+    SpectrumRingStats GetStats() const;
+
+private:
+    SpectrumLineSlot* AcquireSlotLocked();
+    void RecycleLocked(SpectrumLineSlot* slot);
+    void LatencyTimerMain();
+
+    const size_t capacity_;
+    const SpectrumOverflowPolicy policy_;
+    const size_t batch_lines_;
+    const std::chrono::milliseconds max_latency_;
+    std::unique_ptr<SpectrumLineSlot[]> pool_;
+
+    mutable std::mutex mutex_;
+    std::vector<SpectrumLineSlot*> free_;
+    std::deque<SpectrumLineSlot*> pending_;
+    size_t in_use_ = 0;
+    std::atomic<bool> flush_pending_{false};
+
+    std::thread timer_thread_;
+    std::condition_variable timer_cv_;
+    std::function<void()> on_due_;
+    bool timer_stopping_ = false;
+
+    uint64_t received_ = 0;
+    uint64_t delivered_ = 0;
+    uint64_t dropped_ = 0;
+    uint64_t coalesced_ = 0;
+    uint64_t pool_misses_ = 0;
+};
@@ -6,7 +6,10 @@
  * Tests core API operations to ensure the native addon is functional.
  */
 
-const { HamLib, Rotator, PASSBAND } = require('../index.js');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { HamLib, HamLibGroup, Rotator, SpectrumRecording, PASSBAND } = require('../index.js');
 
 let passed = 0;
 let failed = 0;
@@ -86,6 +89,33 @@ async function run() {
     assert(rigs[0].modelName !== undefined, 'rig entry missing modelName');
   });
 
+  await test('getSupportedRigsAsync resolves the same cached list', async () => {
+    const rigs = await HamLib.getSupportedRigsAsync();
+    const sync = HamLib.getSupportedRigs();
+    assert(rigs.length === sync.length, `async ${rigs.length} vs sync ${sync.length}`);
+    for (let i = 1; i < rigs.length; i++) {
+      assert(rigs[i - 1].rigModel < rigs[i].rigModel, 'list should be sorted by model');
+    }
+  });
+
+  await test('getSupportedRigsColumnar matches getSupportedRigs', () => {
+    const rigs = HamLib.getSupportedRigs();
+    const cols = HamLib.getSupportedRigsColumnar();
+    assert(cols.count === rigs.length, `count ${cols.count} vs ${rigs.length}`);
+    assert(cols.rigModel instanceof Uint32Array, 'rigModel should be a Uint32Array');
+    const i = rigs.findIndex((rig) => rig.rigModel === 1);
+    assert(i >= 0, 'dummy model missing');
+    assert(cols.rigModel[i] === 1, 'columns should share the list order');
+    assert(cols.strings[cols.modelName[i]] === rigs[i].modelName, 'modelName mismatch');
+    assert(cols.strings[cols.status[i]] === rigs[i].status, 'status mismatch');
+  });
+
+  await test('getSupportedRig looks up one model', () => {
+    const dummy = HamLib.getSupportedRig(1);
+    assert(dummy && dummy.rigModel === 1 && dummy.modelName === 'Dummy', `got ${JSON.stringify(dummy)}`);
+    assert(HamLib.getSupportedRig(987654321) === null, 'unknown model should be null');
+  });
+
   await test('getConfigSchemaForModel returns dummy schema without instance', () => {
     const schema = HamLib.getConfigSchemaForModel(1);
     assert(Array.isArray(schema), 'schema should be an array');
@@ -107,6 +137,46 @@ async function run() {
     assert(caps.serialDataBits === 8, `IC-705 serialDataBits should be 8, got ${caps.serialDataBits}`);
   });
 
+  await test('model index answers model lookups like the backends', () => {
+    const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'hamlib-index-'));
+    try {
+      const indexPath = path.join(dir, 'models.idx');
+      const built = HamLib.buildModelIndex(indexPath);
+      assert(built.models === HamLib.getSupportedRigs().length && built.bytes === fs.statSync(indexPath).size,
+        `unexpected build result ${JSON.stringify(built)}`);
+      const expected = [1, 3085].map((model) => JSON.stringify([
+        HamLib.getSupportedRig(model), HamLib.getConfigSchemaForModel(model), HamLib.getPortCapsForModel(model),
+      ]));
+      const loaded = HamLib.loadModelIndex(indexPath);
+      assert(loaded.models === built.models && loaded.hamlibVersion === HamLib.getHamlibVersion(),
+        `unexpected index info ${JSON.stringify(loaded)}`);
+      assert(HamLib.getModelIndexInfo().path === indexPath, 'loaded index should be in use');
+      [1, 3085].forEach((model, i) => {
+        const actual = JSON.stringify([
+          HamLib.getSupportedRig(model), HamLib.getConfigSchemaForModel(model), HamLib.getPortCapsForModel(model),
+        ]);
+        assert(actual === expected[i], `model ${model} differs through the index`);
+      });
+
+      // A fresh process picks the index up from the environment and lists
+      // the models from it.
+      const child = require('child_process').spawnSync(process.execPath,
+        ['-e', "const { HamLib } = require('./index.js'); process.stdout.write(String(HamLib.getModelIndexInfo().models) + ' ' + HamLib.getSupportedRigs().length);"],
+        { cwd: path.join(__dirname, '..'), env: { ...process.env, NODE_HAMLIB_MODEL_INDEX: indexPath }, encoding: 'utf8' });
+      assert(child.stdout.trim() === `${built.models} ${built.models}`, `child saw ${child.stdout || child.stderr}`);
+
+      const corrupt = path.join(dir, 'corrupt.idx');
+      fs.writeFileSync(corrupt, Buffer.alloc(256, 7));
+      assertThrows(() => HamLib.loadModelIndex(corrupt), /not a rig model index/);
+      const truncated = path.join(dir, 'truncated.idx');
+      fs.writeFileSync(truncated, fs.readFileSync(indexPath).subarray(0, 200));
+      assertThrows(() => HamLib.loadModelIndex(truncated), /truncated or corrupt/);
+      assert(HamLib.getModelIndexInfo().path === indexPath, 'a failed load should keep the current index');
+    } finally {
+      fs.rmSync(dir, { recursive: true, force: true });
+    }
+  });
+
   // --- Instance lifecycle ---
   console.log('\n[Instance Lifecycle]');
 
@@ -420,6 +490,53 @@ async function run() {
     }
   });
 
+  await test('sendRawInto writes the reply into the caller buffer', async () => {
+    const reply = Buffer.alloc(64, 0xff);
+    try {
+      const length = await rig.sendRawInto(Buffer.from([0xFE, 0xFE, 0x94, 0xE0, 0x03, 0xFD]), reply, Buffer.from([0xFD]));
+      assert(Number.isInteger(length) && length >= 0 && length <= reply.length, `unexpected length ${length}`);
+    } catch (e) {
+      if (!e.message.toLowerCase().includes('not implemented') &&
+          !e.message.toLowerCase().includes('protocol') &&
+          !e.message.toLowerCase().includes('i/o')) throw e;
+    }
+    await assertRejects(() => rig.sendRawInto(Buffer.from([0xFE]), Buffer.alloc(0)), /reply must hold/);
+    await assertRejects(() => rig.sendRaw(Buffer.from([0xFE]), -1), /replyMaxLen must be between/);
+  });
+
+  await test('startRawStream delivers pooled frames and one end event', async () => {
+    assertThrows(() => rig.startRawStream({}), /terminator must be a non-empty Buffer/);
+    assertThrows(() => rig.startRawStream({ terminator: Buffer.from([0xFD]), frameBytes: 0 }), /frameBytes must be between/);
+
+    const command = Buffer.from([0xFE, 0xFE, 0x94, 0xE0, 0x03, 0xFD]);
+    const frames = [];
+    const end = await new Promise((resolve, reject) => {
+      const timer = setTimeout(() => reject(new Error('raw stream did not end')), 5000);
+      rig.startRawStream({ command, terminator: Buffer.from([0xFD]), frameBytes: 64, poolFrames: 4, maxFrames: 8 }, (event) => {
+        if (event.type === 'frame') {
+          frames.push(event);
+          return;
+        }
+        clearTimeout(timer);
+        resolve(event);
+      });
+    });
+    assert(['complete', 'idle', 'error'].includes(end.reason), `unexpected end reason ${end.reason}`);
+    assert(end.frames === frames.length, `end counted ${end.frames} frames, ${frames.length} delivered`);
+    frames.forEach((frame, i) => {
+      assert(frame.sequence === i && Buffer.isBuffer(frame.data) && frame.data.length <= 64, `bad frame ${i}`);
+    });
+    if (end.reason === 'error') {
+      assert(end.code === 'HAMLIB_ERROR' && typeof end.hamlibCode === 'number', 'error end should carry the Hamlib code');
+    }
+    const status = rig.getRawStreamStatus();
+    assert(!status.running && status.frames === frames.length && status.poolFrames === 4 && status.frameBytes === 64,
+      `unexpected status ${JSON.stringify(status)}`);
+    assert(rig.stopRawStream() === false, 'a finished stream is not running');
+    // The stream released the rig lock when it ended.
+    assert(typeof await rig.getFrequency() === 'number', 'rig should answer after the stream');
+  });
+
   // --- New API: setConf / getConf ---
   console.log('\n[Configuration]');
 
@@ -655,6 +772,798 @@ async function run() {
     await assertRejects(() => rig.reset(), /Expected \(resetType: string\)/);
   });
 
+  // --- Batch ---
+  console.log('\n[Batch]');
+
+  await test('batch runs mixed get/set operations in order', async () => {
+    const results = await rig.batch([
+      { op: 'setFrequency', frequency: 14074000 },
+      { op: 'setMode', mode: 'USB', bandwidth: 'normal' },
+      { op: 'setLevel', level: 'AF', value: 0.5 },
+      { op: 'getFrequency' },
+      { op: 'getMode' },
+      { op: 'getVfo' },
+      { op: 'getPtt' },
+      { op: 'getLevel', level: 'AF' },
+    ]);
+    assert(Array.isArray(results) && results.length === 8, `expected 8 results, got ${results.length}`);
+    assert(results.every((entry) => entry.ok === true), `unexpected failure: ${JSON.stringify(results.find((entry) => !entry.ok))}`);
+    assert(results[3].op === 'getFrequency' && results[3].value === 14074000, `got ${results[3].value}`);
+    assert(results[4].value.mode === 'USB', `mode should be USB, got ${results[4].value.mode}`);
+    assert(typeof results[5].value === 'string', 'getVfo should return a VFO token');
+    assert(typeof results[6].value === 'boolean', 'getPtt should return boolean');
+    assert(Math.abs(results[7].value - 0.5) < 0.01, `AF should be ~0.5, got ${results[7].value}`);
+  });
+
+  await test('batch rejects invalid entries with their index', async () => {
+    await assertRejects(() => rig.batch([{ op: 'getFrequency' }, { op: 'getLevel', level: 'NOPE' }]), /batch\[1\]: Invalid level type/);
+    await assertRejects(() => rig.batch([{ op: 'explode' }]), /Unsupported batch op: explode/);
+    await assertRejects(() => rig.batch('getFrequency'), /Expected \(operations/);
+  });
+
+  await test('batch rejects when rig is not open', async () => {
+    const closedRig = new HamLib(1);
+    try {
+      await assertRejects(() => closedRig.batch([{ op: 'getFrequency' }]), /not open/);
+    } finally {
+      await closedRig.destroy();
+    }
+  });
+
+  await test('openSharedSession needs a network rig', async () => {
+    await assertRejects(() => rig.openSharedSession(), /need a network rig/);
+    assert(rig.getSharedSessionStats() === null, 'Dummy rig should have no shared session');
+  });
+
+  await test('network rigs on one host:port share a pipelined rigctld session', async () => {
+    const { FakeRigctld } = require('../bench/fake_rigctld.js');
+    const fake = new FakeRigctld({ latencyMs: 1 });
+    const address = await fake.listen();
+    const first = new HamLib(2, address);
+    const second = new HamLib(2, address);
+    try {
+      await assertRejects(() => first.openSharedSession({ timeoutMs: 10 }), /timeoutMs must be between/);
+      const info = await first.openSharedSession();
+      assert(info.vfoMode === false && info.clients === 1, `unexpected session info ${JSON.stringify(info)}`);
+      assert((await second.openSharedSession()).clients === 2, 'second rig should join the open session');
+
+      await first.batch([{ op: 'setFrequency', frequency: 7074000 }, { op: 'setMode', mode: 'LSB', bandwidth: 1800 }]);
+      const results = await second.batch([
+        { op: 'getFrequency' }, { op: 'getMode' }, { op: 'getVfo' }, { op: 'getPtt' }, { op: 'getFunction', function: 'NB' },
+      ]);
+      assert(results[0].ok && results[0].value === 7074000, `got ${JSON.stringify(results[0])}`);
+      assert(results[1].value.mode === 'LSB' && results[1].value.bandwidth === 1800, `got ${JSON.stringify(results[1])}`);
+      assert(results[2].value === 'VFOA' && results[3].value === false, 'VFO and PTT should parse');
+      assert(!results[4].ok && results[4].hamlibCode === -11, 'unsupported command should fail on its own');
+      await assertRejects(() => second.batch([{ op: 'getFunction', function: 'NB' }, { op: 'getFrequency' }], { continueOnError: false }),
+        /getFunction/);
+      await assertRejects(() => second.batch([{ op: 'setMode', mode: 'USB', bandwidth: 'narrow' }]), /not available over a shared session/);
+
+      const [frequency, ptt] = await Promise.all([first.getFrequency(), second.getPtt(), first.setLevel('AF', 0.25)]);
+      assert(frequency === 7074000 && ptt === false, 'plain calls should go through the session');
+      assert(Math.abs((await second.getLevel('AF')) - 0.25) < 0.001, 'levels should round-trip');
+
+      const stats = first.getSharedSessionStats();
+      assert(stats.connected && stats.clients === 2 && stats.address === address, `unexpected stats ${JSON.stringify(stats)}`);
+      assert(stats.maxInflight >= 5 && stats.latency.count === stats.groups, `pipelining not visible in ${JSON.stringify(stats)}`);
+
+      await fake.close();
+      await assertRejects(() => first.getFrequency(), /closed the connection|is closed/);
+      assert(first.getSharedSessionStats().connected === false, 'session should report the lost connection');
+      first.closeSharedSession();
+      assert(first.getSharedSessionStats() === null, 'closeSharedSession should detach');
+    } finally {
+      await fake.close();
+      await first.destroy();
+      await second.destroy();
+    }
+  });
+
+  // --- Lock scope ---
+  console.log('\n[Lock Scope]');
+
+  for (const scope of ['instance', 'port']) {
+    await test(`concurrent calls on separate Dummy rigs succeed with ${scope} lock scope`, async () => {
+      HamLib.setLockScope(scope);
+      const rigs = [new HamLib(1), new HamLib(1)];
+      try {
+        await Promise.all(rigs.map((entry) => entry.open()));
+        await Promise.all(rigs.map((entry, index) => entry.setFrequency(14074000 + index * 1000)));
+        const freqs = await Promise.all(rigs.map((entry) => entry.getFrequency()));
+        assert(freqs[0] === 14074000 && freqs[1] === 14075000, `got ${freqs.join(',')}`);
+      } finally {
+        await Promise.all(rigs.map((entry) => entry.destroy()));
+        HamLib.setLockScope('global');
+      }
+    });
+  }
+
+  await test('setLockScope throws while a rig command is running', async () => {
+    const pending = rig.getFrequency();
+    assertThrows(() => HamLib.setLockScope('instance'), /Lock scope cannot change/);
+    await pending;
+    assert(HamLib.getLockScope() === 'global', `expected global, got ${HamLib.getLockScope()}`);
+    HamLib.setLockScope('global');
+  });
+
+  // --- Rig groups ---
+  console.log('\n[Rig Groups]');
+
+  await test('HamLibGroup applies one batch to every rig', async () => {
+    HamLib.setLockScope('instance');
+    const rigs = [new HamLib(1), new HamLib(1)];
+    try {
+      await Promise.all(rigs.map((entry) => entry.open()));
+      const group = new HamLibGroup(rigs);
+      assert(group.size === 2, `expected size 2, got ${group.size}`);
+      const result = await group.setFrequency(21074000);
+      assert(result.ok === true, `unexpected result ${JSON.stringify(result)}`);
+      assert(result.skewMs >= 0 && result.elapsedMs >= result.skewMs, `unexpected timing ${JSON.stringify(result)}`);
+      assert(result.rigs.length === 2 && result.rigs.every((entry, index) => entry.index === index && entry.ok
+        && entry.results[0].ok && entry.appliedMs >= entry.startedMs), `unexpected rigs ${JSON.stringify(result.rigs)}`);
+      const freqs = await Promise.all(rigs.map((entry) => entry.getFrequency()));
+      assert(freqs.every((freq) => freq === 21074000), `got ${freqs.join(',')}`);
+
+      const mixed = await group.batch([{ op: 'setMode', mode: 'USB' }, { op: 'getMode' }]);
+      assert(mixed.rigs.every((entry) => entry.results[1].value.mode === 'USB'),
+        `unexpected results ${JSON.stringify(mixed.rigs)}`);
+    } finally {
+      await Promise.all(rigs.map((entry) => entry.destroy()));
+      HamLib.setLockScope('global');
+    }
+  });
+
+  await test('HamLibGroup reports a closed rig without failing the others', async () => {
+    const closedRig = new HamLib(1);
+    const result = await new HamLibGroup([rig, closedRig]).batch([{ op: 'getFrequency' }]);
+    assert(result.ok === false, 'group with a closed rig should not be ok');
+    assert(result.rigs[0].ok === true && result.rigs[1].ok === false && result.rigs[1].error instanceof Error,
+      `unexpected rigs ${JSON.stringify(result.rigs)}`);
+  });
+
+  await test('HamLibGroup validates its rigs and operations', async () => {
+    assertThrows(() => new HamLibGroup([]), /between 1 and 32/);
+    assertThrows(() => new HamLibGroup([{}]), /must be a HamLib instance/);
+    assertThrows(() => new HamLibGroup([rig, rig]), /already in the group/);
+    await assertRejects(() => new HamLibGroup([rig]).batch([{ op: 'bogus' }]), /Unsupported batch op/);
+  });
+
+  // --- Command thread ---
+  console.log('\n[Command Thread]');
+
+  await test('command thread runs calls and batches completions', async () => {
+    const threaded = new HamLib(1);
+    try {
+      threaded.enableCommandThread({ queueCapacity: 64 });
+      await threaded.open();
+      await threaded.setFrequency(7074000);
+      const results = await Promise.all(Array.from({ length: 20 }, () => threaded.getFrequency()));
+      assert(results.every((freq) => freq === 7074000), `got ${results.join(',')}`);
+      const stats = threaded.getCommandThreadStats();
+      assert(stats.enabled === true, 'command thread should be enabled');
+      assert(stats.queueCapacity === 64, `queueCapacity should be 64, got ${stats.queueCapacity}`);
+      assert(stats.completed >= 22, `completed should cover all calls, got ${stats.completed}`);
+      assert(stats.batches >= 1 && stats.batches <= stats.completed, `unexpected batches ${stats.batches}`);
+      assert(stats.queueDepth === 0, `queue should be drained, got ${stats.queueDepth}`);
+    } finally {
+      threaded.disableCommandThread();
+      await threaded.destroy();
+    }
+  });
+
+  await test('command thread rejects with HAMLIB_COMMAND_QUEUE_FULL when saturated', async () => {
+    const threaded = new HamLib(1);
+    try {
+      threaded.enableCommandThread({ queueCapacity: 2 });
+      await threaded.open();
+      const settled = await Promise.allSettled(Array.from({ length: 200 }, () => threaded.getFrequency()));
+      const rejected = settled.filter((entry) => entry.status === 'rejected');
+      assert(rejected.every((entry) => entry.reason.code === 'HAMLIB_COMMAND_QUEUE_FULL'),
+        'rejections should carry HAMLIB_COMMAND_QUEUE_FULL');
+      assert(threaded.getCommandThreadStats().rejected === rejected.length, 'rejected counter should match');
+
+      // Rejected submits are not in flight, so they do not use up the
+      // background budget.
+      threaded.setCommandPriorities({ backgroundBudget: 100 });
+      const burst = Array.from({ length: 200 }, () => threaded.getFrequency().catch(() => {}));
+      const meter = await threaded.getLevel('STRENGTH').then(() => null, (error) => error);
+      await Promise.all(burst);
+      assert(!meter || meter.code !== 'HAMLIB_COMMAND_SHED', 'queue-full rejections should not count as in flight');
+      assert(threaded.getCommandPriorities().inflight === 0, 'nothing should be left in flight');
+    } finally {
+      threaded.disableCommandThread();
+      await threaded.destroy();
+    }
+  });
+
+  // --- State Cache ---
+  console.log('\n[State Cache]');
+
+  await test('state cache answers getters from set* and reads', async () => {
+    const cached = new HamLib(1);
+    try {
+      await cached.open();
+      cached.enableStateCache({ maxAgeMs: 60000 });
+      await cached.setFrequency(7074000);
+      const calls = () => (cached.getStats().operations.GetFrequency || { calls: 0 }).calls;
+      const before = calls();
+      assert(await cached.getFrequency() === 7074000, 'cached frequency should match the write');
+      assert(calls() === before, 'a fresh cache hit should not reach the rig');
+      await cached.getFrequency({ maxAgeMs: 0 });
+      assert(calls() === before + 1, 'maxAgeMs 0 should force a read');
+
+      await cached.setMode('USB', 2400);
+      const mode = await cached.getMode();
+      assert(mode.mode === 'USB' && mode.bandwidth === 2400, `unexpected cached mode ${JSON.stringify(mode)}`);
+
+      await cached.batch([{ op: 'setFrequency', frequency: 14074000 }]);
+      assert(await cached.getFrequency() === 14074000, 'batch writes should update the cache');
+
+      const stats = cached.getStateCacheStats();
+      assert(stats.enabled === true && stats.maxAgeMs === 60000, `unexpected settings ${JSON.stringify(stats)}`);
+      assert(stats.hits >= 3 && stats.misses >= 1, `unexpected counters ${JSON.stringify(stats)}`);
+
+      await cached.vfoOperation('CPY').catch(() => {});
+      assert(cached.getStateCacheStats().invalidations >= 1, 'vfoOperation should invalidate the cache');
+      cached.disableStateCache();
+      assert(cached.getStateCacheStats().enabled === false, 'cache should be disabled');
+    } finally {
+      await cached.destroy();
+    }
+  });
+
+  await test('state cache validates maxAgeMs', async () => {
+    await assertRejects(() => rig.getFrequency(undefined, { maxAgeMs: 'soon' }), /maxAgeMs must be a number/);
+    await assertRejects(() => rig.getMode({ maxAgeMs: -5 }), /maxAgeMs must be between/);
+  });
+
+  // --- Request Coalescing ---
+  console.log('\n[Request Coalescing]');
+
+  await test('identical in-flight reads share one native call', async () => {
+    const shared = new HamLib(1);
+    try {
+      await shared.open();
+      await shared.setFrequency(7074000);
+      shared.enableRequestCoalescing();
+      shared.resetStats();
+      const results = await Promise.all(Array.from({ length: 5 }, () => shared.getLevel('STRENGTH')));
+      assert(results.every((value) => value === results[0]), `results differ: ${results.join(',')}`);
+      const stats = shared.getStats();
+      assert(stats.operations.GetLevel.calls === 1, `expected one GetLevel, got ${stats.operations.GetLevel.calls}`);
+      assert(stats.coalescing.coalescedReads === 4, `expected 4 coalesced reads, got ${stats.coalescing.coalescedReads}`);
+    } finally {
+      await shared.destroy();
+    }
+  });
+
+  await test('setFrequency bursts collapse to the last value', async () => {
+    const knob = new HamLib(1);
+    try {
+      knob.enableCommandThread({ queueCapacity: 64 });
+      await knob.open();
+      knob.enableRequestCoalescing({ reads: false });
+      knob.resetStats();
+      const writes = [7074000, 7075000, 7076000, 7077000, 7078000].map((freq) => knob.setFrequency(freq));
+      await Promise.all(writes);
+      assert(await knob.getFrequency() === 7078000, 'last writer should win');
+      const stats = knob.getStats();
+      assert(stats.operations.SetFrequency.calls + stats.coalescing.coalescedWrites === 5,
+        `writes should be sent or merged, got ${JSON.stringify(stats.coalescing)}`);
+    } finally {
+      knob.disableCommandThread();
+      await knob.destroy();
+    }
+  });
+
+  // --- Command Priorities ---
+  console.log('\n[Command Priorities]');
+
+  await test('background commands over budget are shed', async () => {
+    const meters = new HamLib(1);
+    try {
+      await meters.open();
+      meters.setCommandPriorities({ backgroundBudget: 2 });
+      meters.resetStats();
+      const settled = await Promise.allSettled(Array.from({ length: 5 }, () => meters.getLevel('STRENGTH')));
+      const shed = settled.filter((result) => result.status === 'rejected');
+      assert(settled.filter((result) => result.status === 'fulfilled').length === 2,
+        `expected 2 reads, got ${JSON.stringify(settled)}`);
+      assert(shed.length === 3 && shed.every((result) => result.reason.code === 'HAMLIB_COMMAND_SHED'),
+        `expected 3 shed reads, got ${JSON.stringify(shed.map((result) => result.reason.code))}`);
+      const stats = meters.getStats();
+      assert(stats.lanes.background.shed === 3, `expected 3 shed, got ${stats.lanes.background.shed}`);
+      assert(stats.lanes.background.calls === 2, `expected 2 background calls, got ${stats.lanes.background.calls}`);
+      assert(meters.getCommandPriorities().inflight === 0, 'nothing should be in flight');
+      // Interactive commands are never shed.
+      await Promise.all(Array.from({ length: 5 }, () => meters.getFrequency()));
+    } finally {
+      await meters.destroy();
+    }
+  });
+
+  await test('per-lane latency and operation overrides', async () => {
+    const lanes = new HamLib(1);
+    try {
+      await lanes.open();
+      lanes.setCommandPriorities({ operations: { getFrequency: 'background' } });
+      assert(lanes.getCommandPriorities().operations.GetFrequency === 'background', 'override not recorded');
+      lanes.resetStats();
+      await lanes.getFrequency();
+      await lanes.setPtt(false);
+      let stats = lanes.getStats();
+      assert(stats.lanes.background.calls === 1, `expected 1 background call, got ${stats.lanes.background.calls}`);
+      assert(stats.lanes.realtime.calls === 1, `expected 1 realtime call, got ${stats.lanes.realtime.calls}`);
+      assert(stats.lanes.realtime.latency.count === 1, 'realtime latency not recorded');
+      lanes.setCommandPriorities({ operations: { getFrequency: null } });
+      lanes.resetStats();
+      await lanes.getFrequency();
+      stats = lanes.getStats();
+      assert(stats.lanes.interactive.calls === 1, 'override should be cleared');
+    } finally {
+      await lanes.destroy();
+    }
+  });
+
+  await test('priority lanes work on the command thread', async () => {
+    const threaded = new HamLib(1);
+    try {
+      threaded.enableCommandThread();
+      await threaded.open();
+      const results = await Promise.all([
+        threaded.getLevel('STRENGTH'), threaded.getLevel('STRENGTH'), threaded.setPtt(false), threaded.getFrequency(),
+      ]);
+      assert(results.length === 4, 'all commands should settle');
+      assert(threaded.getStats().lanes.realtime.calls === 1, 'setPtt should run in the realtime lane');
+    } finally {
+      threaded.disableCommandThread();
+      await threaded.destroy();
+    }
+  });
+
+  // --- Call options ---
+  console.log('\n[Call Options]');
+
+  // Rejected calls are counted in `rejected` and never in `calls`, which
+  // only ExecuteWithRigLock() reaches.
+  const assertNeverExecuted = (target, frequency) => {
+    const op = target.getStats().operations.SetFrequency;
+    assert(op && op.calls === 0 && op.rejected === 1, `SetFrequency should not execute, got ${JSON.stringify(op)}`);
+    return target.getFrequency().then((freq) => assert(freq === frequency, `frequency changed to ${freq}`));
+  };
+  // A scoped waitMorse with PTT keyed keeps polling PTT under the rig lock
+  // until its own deadline passes.
+  const holdRigLock = (target, ms) => target.withCallOptions({ deadlineMs: ms }).waitMorse().catch(() => {});
+
+  await test('a call with an already aborted signal is rejected before the rig', async () => {
+    const scoped = new HamLib(1);
+    try {
+      await scoped.open();
+      await scoped.setFrequency(7074000);
+      scoped.resetStats();
+      const controller = new AbortController();
+      controller.abort();
+      await assertRejects(() => scoped.withCallOptions({ signal: controller.signal }).setFrequency(7080000), /HAMLIB_ABORTED/);
+      await assertNeverExecuted(scoped, 7074000);
+    } finally {
+      await scoped.destroy();
+    }
+  });
+
+  await test('aborting a call waiting for the rig lock rejects it', async () => {
+    const scoped = new HamLib(1);
+    try {
+      await scoped.open();
+      await scoped.setFrequency(7074000);
+      await scoped.setPtt(true);
+      scoped.resetStats();
+      const holder = holdRigLock(scoped, 600);
+      await new Promise((resolve) => setTimeout(resolve, 50));
+      const controller = new AbortController();
+      const pending = scoped.withCallOptions({ signal: controller.signal }).setFrequency(7080000);
+      setTimeout(() => controller.abort(), 100);
+      let caught = null;
+      await pending.catch((error) => { caught = error; });
+      assert(caught && caught.code === 'HAMLIB_ABORTED' && caught.name === 'AbortError',
+        `expected HAMLIB_ABORTED, got ${caught && caught.code}`);
+      await holder;
+      await scoped.setPtt(false);
+      await assertNeverExecuted(scoped, 7074000);
+    } finally {
+      await scoped.destroy();
+    }
+  });
+
+  await test('a deadline that passes while the call is queued rejects it', async () => {
+    const scoped = new HamLib(1);
+    try {
+      await scoped.open();
+      await scoped.setFrequency(7074000);
+      await scoped.setPtt(true);
+      scoped.resetStats();
+      const holder = holdRigLock(scoped, 600);
+      await new Promise((resolve) => setTimeout(resolve, 50));
+      const started = Date.now();
+      let caught = null;
+      await scoped.withCallOptions({ deadlineMs: 100 }).setFrequency(7080000).catch((error) => { caught = error; });
+      assert(caught && caught.code === 'HAMLIB_DEADLINE_EXCEEDED' && caught.name === 'TimeoutError',
+        `expected HAMLIB_DEADLINE_EXCEEDED, got ${caught && caught.code}`);
+      assert(Date.now() - started < 500, 'the call should give up at its deadline, not when the lock frees');
+      await holder;
+      await scoped.setPtt(false);
+      await assertNeverExecuted(scoped, 7074000);
+    } finally {
+      await scoped.destroy();
+    }
+  });
+
+  // --- Token handles ---
+  console.log('\n[Token Handles]');
+
+  await test('level and function handles work in place of names', async () => {
+    const level = HamLib.getLevelHandle('AF');
+    await rig.setLevel(level, 0.5);
+    const byHandle = await rig.getLevel(level);
+    const byName = await rig.getLevel('AF');
+    assert(byHandle === byName, `handle read ${byHandle} != name read ${byName}`);
+    const func = HamLib.getFunctionHandle('NB');
+    await rig.setFunction(func, true);
+    assert(await rig.getFunction('NB') === true, 'NB should be on after setFunction(handle)');
+    await rig.setFunction('NB', false);
+  });
+
+  await test('a function handle is rejected as a level', async () => {
+    await assertRejects(() => rig.getLevel(HamLib.getFunctionHandle('COMP')), /Invalid level type/);
+  });
+
+  // --- Capability Snapshot ---
+  console.log('\n[Capability Snapshot]');
+
+  await test('capability getters are served from the open-time snapshot', async () => {
+    const snap = new HamLib(1);
+    try {
+      await snap.open();
+      snap.resetStats();
+      const caps = await snap.getCapabilitySnapshot();
+      assert(typeof caps.capturedAt === 'number' && caps.capturedAt > 0, `bad capturedAt ${caps.capturedAt}`);
+      assert(Array.isArray(caps.modes) && caps.modes.length > 0, 'snapshot should list modes');
+      assert(Array.isArray(caps.frequencyRanges.rx), 'snapshot should include rx ranges');
+      assert(typeof caps.spectrum.asyncDataSupported === 'boolean', 'snapshot should include spectrum caps');
+      const levels = await snap.getSupportedLevels();
+      assert(JSON.stringify(levels) === JSON.stringify(caps.levels), 'getSupportedLevels should match the snapshot');
+      const filters = await snap.getFilterList();
+      assert(filters.length === caps.filters.length, 'getFilterList should match the snapshot');
+      const operations = snap.getStats().operations;
+      assert(!operations.GetSupportedLevels && !operations.GetFilterList && !operations.GetCapabilitySnapshot,
+        `capability reads should not queue workers: ${Object.keys(operations).join(',')}`);
+      await snap.close();
+      await snap.getSupportedModes();
+      assert(snap.getStats().operations.GetSupportedModes.calls === 1, 'close() should drop the snapshot');
+    } finally {
+      await snap.destroy();
+    }
+  });
+
+  await test('*Sync variants answer from the snapshot and state cache', async () => {
+    const fast = new HamLib(1);
+    try {
+      await fast.open();
+      fast.resetStats();
+      assert(JSON.stringify(fast.getSupportedLevelsSync()) === JSON.stringify(await fast.getSupportedLevels()),
+        'getSupportedLevelsSync should match the async result');
+      assert(fast.getCapabilitySnapshotSync().modes.length > 0, 'snapshot should list modes');
+      assert(fast.getFrequencySync() === null, 'state cache is off, nothing cached');
+      fast.enableStateCache({ maxAgeMs: 5000 });
+      await fast.setFrequency(14074000);
+      assert(fast.getFrequencySync() === 14074000, `getFrequencySync = ${fast.getFrequencySync()}`);
+      const mw = fast.power2mWSync(0.5, 14074000, 'USB');
+      assert(mw === null || typeof mw === 'number', `power2mWSync = ${mw}`);
+      assert(!fast.getStats().operations.GetFrequency, 'getFrequencySync should not queue a read');
+      await fast.close();
+      let threw = false;
+      try { fast.getMaxRitSync(); } catch (e) { threw = /captured by open/.test(e.message); }
+      assert(threw, 'capability Sync getters should throw after close()');
+    } finally {
+      await fast.destroy();
+    }
+  });
+
+  // --- Operation Metrics ---
+  console.log('\n[Operation Metrics]');
+
+  await test('getStats counts calls and latency per operation', async () => {
+    const metered = new HamLib(1);
+    try {
+      await metered.open();
+      metered.resetStats();
+      await metered.setFrequency(7074000);
+      await Promise.all(Array.from({ length: 5 }, () => metered.getFrequency()));
+      const stats = metered.getStats();
+      const op = stats.operations.GetFrequency;
+      assert(op && op.calls === 5 && op.errors === 0, `unexpected GetFrequency stats ${JSON.stringify(op)}`);
+      assert(op.execute.count === 5 && op.lockWait.count === 5, 'histograms should record every call');
+      assert(op.execute.p50Ms <= op.execute.p99Ms && op.execute.p99Ms <= op.execute.maxMs, 'percentiles should be ordered');
+      const bucketed = op.execute.buckets.reduce((sum, bucket) => sum + bucket.count, 0);
+      assert(bucketed === 5, `bucket counts should add up, got ${bucketed}`);
+      assert(stats.operations.SetFrequency.calls === 1, 'SetFrequency should be counted once');
+      assert(stats.queue.pending === 0 && stats.queue.executing === 0, `queue should be idle ${JSON.stringify(stats.queue)}`);
+      assert(HamLib.getStats().operations.GetFrequency.calls >= 5, 'global stats should include this rig');
+      metered.resetStats();
+      assert(Object.keys(metered.getStats().operations).length === 0, 'reset should clear operations');
+    } finally {
+      await metered.destroy();
+    }
+  });
+
+  await test('getStats records errors by Hamlib code', async () => {
+    const metered = new HamLib(1);
+    try {
+      await assertRejects(() => metered.getFrequency(), /not open/);
+      const op = metered.getStats().operations.GetFrequency;
+      assert(op.calls === 1 && op.errors === 1, `unexpected error stats ${JSON.stringify(op)}`);
+      assert(op.errorsByCode['-1'] === 1, `not-open should count as RIG_EINVAL, got ${JSON.stringify(op.errorsByCode)}`);
+    } finally {
+      await metered.destroy();
+    }
+  });
+
+  await test('dumpTrace exports every phase of traced calls', async () => {
+    const traced = new HamLib(1);
+    try {
+      assertThrows(() => traced.enableTrace({ capacity: 8 }), /capacity must be between/);
+      traced.enableTrace({ capacity: 256 });
+      await traced.open();
+      await traced.setFrequency(7074000);
+      await traced.getFrequency();
+      traced.disableTrace();
+      await traced.getFrequency();
+      const trace = traced.dumpTrace({ clear: true });
+      assert(trace.otherData.enabled === false && trace.otherData.capacity === 256, `unexpected otherData ${JSON.stringify(trace.otherData)}`);
+      const spans = trace.traceEvents.filter((event) => event.ph === 'b');
+      const calls = spans.filter((event) => event.name === 'GetFrequency');
+      assert(calls.length === 1, `only the traced GetFrequency should appear, got ${calls.length}`);
+      for (const phase of ['queue', 'lockWait', 'execute', 'resolve']) {
+        assert(spans.some((event) => event.name === phase && event.id === calls[0].id), `missing ${phase} span`);
+      }
+      const slice = trace.traceEvents.find((event) => event.ph === 'X' && event.name === 'SetFrequency');
+      assert(slice && slice.dur >= 0, 'SetFrequency should have an execute slice');
+      assert(JSON.parse(JSON.stringify(trace)).traceEvents.length === trace.traceEvents.length, 'trace should be JSON');
+      assert(traced.dumpTrace().otherData.calls === 0, 'clear should drop the exported events');
+    } finally {
+      await traced.destroy();
+    }
+  });
+
+  // --- Spectrum Stream Options ---
+  console.log('\n[Spectrum Stream Options]');
+
+  await test('startSpectrumStream validates overflow policy and buffer size', async () => {
+    await assertRejects(() => rig.startSpectrumStream(() => {}, { overflow: 'newest' }), /overflow must be/);
+    await assertRejects(() => rig.startSpectrumStream({ bufferLines: 0 }), /bufferLines must be between/);
+    const stats = rig.getSpectrumStreamStats();
+    assert(stats.running === false, 'stream should not be running');
+    assert(stats.received === 0 && stats.dropped === 0, `unexpected counters ${JSON.stringify(stats)}`);
+  });
+
+  await test('startSpectrumStream validates batch options', async () => {
+    await assertRejects(() => rig.startSpectrumStream({ batchLines: 0 }), /batchLines must be between/);
+    await assertRejects(() => rig.startSpectrumStream({ batchLines: 16, maxLatencyMs: 0 }), /maxLatencyMs must be between/);
+    await assertRejects(() => rig.startSpectrumStream({ batchLines: 16, bufferLines: 8 }), /bufferLines must be at least batchLines/);
+  });
+
+  await test('startSpectrumStream validates processing options', async () => {
+    await assertRejects(() => rig.startSpectrumStream({ processing: { averageAlpha: 0 } }), /processing.averageAlpha must be between/);
+    await assertRejects(() => rig.startSpectrumStream({ processing: { peakHold: 'yes' } }), /processing.peakHold must be a boolean/);
+    await assertRejects(() => rig.startSpectrumStream({ processing: { decimation: 'median' } }), /processing.decimation must be/);
+    assert(rig.getSpectrumStreamStats().processing === false, 'processing stage should not be attached');
+  });
+
+  await test('_injectSpectrumLines delivers synthetic lines through the stream', async () => {
+    await assertRejects(() => rig._injectSpectrumLines(10), /Spectrum stream is not running/);
+    let delivered = 0;
+    await rig.startSpectrumStream((frame) => { delivered += frame.lines; }, { batchLines: 8, maxLatencyMs: 10 });
+    const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'hamlib-inject-'));
+    try {
+      await assertRejects(() => rig._injectSpectrumLines(100000, { intervalUs: 1000 }), /must not exceed 10 seconds/);
+      await rig.startSpectrumRecording(path.join(dir, 'inject.hlspec'));
+      const result = await rig._injectSpectrumLines(100, { dataLength: 64 });
+      const recorded = await rig.stopSpectrumRecording();
+      assert(recorded.lines === 0, `injected lines should not be recorded, got ${recorded.lines}`);
+      assert(result.lines === 100, `unexpected result ${JSON.stringify(result)}`);
+      const started = Date.now();
+      while (delivered < 100 && Date.now() - started < 2000) {
+        await new Promise((resolve) => setTimeout(resolve, 10));
+      }
+      const stats = rig.getSpectrumStreamStats();
+      assert(stats.received === 100, `received should be 100, got ${stats.received}`);
+      assert(delivered + stats.dropped === 100, `delivered ${delivered}, dropped ${stats.dropped}`);
+    } finally {
+      await rig.stopSpectrumStream();
+      fs.rmSync(dir, { recursive: true, force: true });
+    }
+  });
+
+  await test('startSweep validates its options', async () => {
+    assertThrows(() => rig.startSweep({ startFreq: 14000000, stopFreq: 14010000, stepHz: 1000 }), /Spectrum stream is not running/);
+    await rig.startSpectrumStream(() => {});
+    try {
+      assertThrows(() => rig.startSweep({ startFreq: 14000000, stopFreq: 14010000 }), /stepHz is required/);
+      assertThrows(() => rig.startSweep({ startFreq: 14010000, stopFreq: 14000000, stepHz: 1000 }), /between 2 and 2048 points/);
+      assertThrows(() => rig.startSweep({ startFreq: 14000000, stopFreq: 15000000, stepHz: 10 }), /between 2 and 2048 points/);
+      assertThrows(() => rig.startSweep({ startFreq: 14000000, stopFreq: 14010000, stepHz: 1000, strengthMinDb: 10, strengthMaxDb: 0 }),
+        /strengthMinDb must be below/);
+      assertThrows(() => rig.startSweep({ startFreq: 14000000, stopFreq: 14010000, stepHz: 1000, dwellMs: 5000 }), /dwellMs must be/);
+      assertThrows(() => rig.startSweep({ startFreq: 14000000, stopFreq: 14010000, stepHz: 1000, chunkPoints: 0 }), /chunkPoints must be/);
+    } finally {
+      await rig.stopSpectrumStream();
+    }
+  });
+
+  await test('startSweep feeds swept lines into the spectrum stream and tunes back', async () => {
+    await rig.setFrequency(7074000);
+    const lines = [];
+    await rig.startSpectrumStream((line) => lines.push(line));
+    try {
+      const ended = new Promise((resolve) => {
+        rig.startSweep({ startFreq: 14000000, stopFreq: 14010000, stepHz: 1000, sweeps: 2, chunkPoints: 4 }, resolve);
+      });
+      const end = await ended;
+      assert(end.type === 'end' && end.reason === 'complete' && end.sweeps === 2, `unexpected end ${JSON.stringify(end)}`);
+      const started = Date.now();
+      while (lines.length < 2 && Date.now() - started < 2000) {
+        await new Promise((resolve) => setTimeout(resolve, 10));
+      }
+      assert(lines.length === 2, `expected 2 lines, got ${lines.length}`);
+      const line = lines[0];
+      assert(line.mode === 2 && line.dataLength === 11 && line.data.length === 11, `unexpected line ${JSON.stringify(line)}`);
+      assert(line.lowEdgeFreq === 14000000 && line.highEdgeFreq === 14010000 && line.spanHz === 10000,
+        `unexpected edges ${line.lowEdgeFreq}..${line.highEdgeFreq}`);
+      const status = rig.getSweepStatus();
+      assert(status.running === false && status.sweeps === 2 && status.readings + status.errors === 22,
+        `unexpected status ${JSON.stringify(status)}`);
+      assert(await rig.getFrequency() === 7074000, 'frequency should be restored');
+    } finally {
+      rig.stopSweep();
+      await rig.stopSpectrumStream();
+    }
+  });
+
+  await test('stopSweep ends a continuous sweep without an end event', async () => {
+    let endEvents = 0;
+    await rig.startSpectrumStream(() => {});
+    try {
+      rig.startSweep({ startFreq: 14000000, stopFreq: 14100000, stepHz: 1000, dwellMs: 1 }, () => { endEvents++; });
+      await new Promise((resolve) => setTimeout(resolve, 50));
+      assert(rig.stopSweep() === true, 'stopSweep should report the running sweep');
+      await new Promise((resolve) => setTimeout(resolve, 20));
+      assert(endEvents === 0, 'no end event expected after stopSweep');
+      assert(rig.getSweepStatus().running === false, 'sweep should not be running');
+    } finally {
+      await rig.stopSpectrumStream();
+    }
+  });
+
+  // --- Spectrum Recording ---
+  console.log('\n[Spectrum Recording]');
+
+  await test('startSpectrumRecording creates a readable recording', async () => {
+    const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'hamlib-rec-'));
+    const file = path.join(dir, 'waterfall.hlspec');
+    try {
+      assert(await rig.startSpectrumRecording(file, { segmentBytes: 65536 }) === true, 'start should resolve true');
+      await assertRejects(() => rig.startSpectrumRecording(file), /already running/);
+      assert(rig.getSpectrumRecordingStats().recording === true, 'should be recording');
+      const stats = await rig.stopSpectrumRecording();
+      assert(stats.lines === 0 && stats.droppedLines === 0 && stats.failed === false, `unexpected stats ${JSON.stringify(stats)}`);
+      assert(fs.existsSync(`${file}.idx`), 'index file should exist');
+
+      const recording = SpectrumRecording.open(file);
+      try {
+        const info = recording.info();
+        assert(info.lines === 0 && info.recordHeaderBytes === 80, `unexpected info ${JSON.stringify(info)}`);
+        const chunk = await recording.read(0, Date.now());
+        assert(chunk.lines === 0 && chunk.complete === true && chunk.data.length === 0, 'empty recording should read nothing');
+        assert(SpectrumRecording.decode(chunk.data).length === 0, 'decode of empty chunk');
+      } finally {
+        recording.close();
+      }
+    } finally {
+      fs.rmSync(dir, { recursive: true, force: true });
+    }
+  });
+
+  await test('SpectrumRecording rejects files that are not recordings', async () => {
+    assertThrows(() => SpectrumRecording.open(path.join(os.tmpdir(), 'hamlib-missing.hlspec')), /Unable to open spectrum recording/);
+  });
+
+  // --- Transceive ---
+  console.log('\n[Transceive]');
+
+  await test('setTransceive stores the mode for the next open', async () => {
+    const closed = new HamLib(1);
+    try {
+      assert(closed.getTransceive() === 'rig', `default should be rig, got ${closed.getTransceive()}`);
+      await closed.setTransceive('off');
+      assert(closed.getTransceive() === 'off', `mode should be off, got ${closed.getTransceive()}`);
+      await closed.open();
+      await closed.close();
+    } finally {
+      await closed.destroy();
+    }
+  });
+
+  await test('setTransceive rejects unknown modes with TypeError', async () => {
+    await assertRejects(() => rig.setTransceive('async'), /Expected \(mode/);
+  });
+
+  // --- Polling ---
+  console.log('\n[Polling]');
+
+  await test('startPolling reports initial values then only changes', async () => {
+    const polled = new HamLib(1);
+    const rounds = [];
+    let pollId = null;
+    try {
+      await polled.open();
+      await polled.setFrequency(14074000);
+      pollId = polled.startPolling([
+        { op: 'getFrequency', intervalMs: 20 },
+        { op: 'getPtt', intervalMs: 20 },
+      ], (changes) => rounds.push(changes));
+      assert(typeof pollId === 'number', `pollId should be a number, got ${pollId}`);
+
+      await new Promise((resolve) => setTimeout(resolve, 200));
+      const initial = rounds.flat();
+      const freq = initial.find((change) => change.key === 'getFrequency');
+      assert(freq && freq.ok && freq.value === 14074000, `initial frequency missing: ${JSON.stringify(initial)}`);
+      assert(freq.previous === undefined, 'initial reading should have no previous value');
+      assert(initial.filter((change) => change.key === 'getFrequency').length === 1,
+        'unchanged frequency should not be re-reported');
+
+      rounds.length = 0;
+      await polled.setFrequency(7074000);
+      await new Promise((resolve) => setTimeout(resolve, 200));
+      const changed = rounds.flat().filter((change) => change.key === 'getFrequency');
+      assert(changed.length === 1, `expected one frequency change, got ${changed.length}`);
+      assert(changed[0].value === 7074000 && changed[0].previous === 14074000,
+        `unexpected change ${JSON.stringify(changed[0])}`);
+    } finally {
+      if (pollId !== null) {
+        assert(polled.stopPolling(pollId) === true, 'stopPolling should report the poll set');
+      }
+      await polled.destroy();
+    }
+  });
+
+  await test('startPolling without callback emits pollChange events', async () => {
+    const polled = new HamLib(1);
+    try {
+      await polled.open();
+      const event = new Promise((resolve) => polled.once('pollChange', resolve));
+      polled.startPolling([{ op: 'getMode', intervalMs: 20, key: 'mode' }]);
+      const change = await event;
+      assert(change.key === 'mode' && change.ok === true && typeof change.value.mode === 'string',
+        `unexpected change ${JSON.stringify(change)}`);
+    } finally {
+      polled.stopPolling();
+      await polled.destroy();
+    }
+  });
+
+  await test('close stops polling', async () => {
+    const polled = new HamLib(1);
+    await polled.open();
+    let rounds = 0;
+    polled.startPolling([{ op: 'getFrequency', intervalMs: 20 }], () => { rounds++; });
+    await new Promise((resolve) => setTimeout(resolve, 60));
+    await polled.close();
+    assert(polled.stopPolling() === false, 'close should have stopped every poll set');
+    const seen = rounds;
+    await new Promise((resolve) => setTimeout(resolve, 60));
+    assert(rounds === seen, 'no rounds expected after close');
+    await polled.destroy();
+  });
+
   // --- Rotator ---
   console.log('\n[Rotator]');
 
@@ -717,6 +1626,37 @@ async function run() {
     assert(typeof position.elevation === 'number', 'missing elevation');
   });
 
+  await test('rotator back-to-back setPosition calls all resolve', async () => {
+    const results = await Promise.all([
+      rotator.setPosition(10, 5),
+      rotator.setPosition(20, 5),
+      rotator.setPosition(30, 5),
+      rotator.setPosition(40, 5)
+    ]);
+    assert(results.every(r => r === 0), `expected all 0, got ${results.join(', ')}`);
+    const stats = rotator.getStats();
+    assert(stats.operations.RotatorSetPosition.calls >= 1, 'RotatorSetPosition not counted');
+    assert(typeof stats.position.coalesced === 'number', 'missing position.coalesced');
+  });
+
+  await test('rotator setPositionDeadband suppresses small moves', async () => {
+    rotator.setPositionDeadband(5);
+    await rotator.setPosition(100, 10);
+    const before = rotator.getStats().position.suppressed;
+    const result = await rotator.setPosition(101, 10);
+    assert(result === 0, `expected 0, got ${result}`);
+    const stats = rotator.getStats();
+    assert(stats.position.suppressed === before + 1, `expected ${before + 1}, got ${stats.position.suppressed}`);
+    assert(stats.position.deadbandAzimuth === 5, 'deadbandAzimuth not reported');
+    rotator.setPositionDeadband(0);
+  });
+
+  await test('rotator setPositionDeadband rejects negative values', () => {
+    let threw = false;
+    try { rotator.setPositionDeadband(-1); } catch (e) { threw = true; }
+    assert(threw, 'expected a throw');
+  });
+
   await test('rotator move/stop succeeds', async () => {
     await rotator.move('RIGHT', 2);
     await rotator.stop();
@@ -757,6 +1697,82 @@ async function run() {
     assert(Array.isArray(parms), `expected array, got ${typeof parms}`);
   });
 
+  // --- Tracking ---
+  console.log('\n[Tracking]');
+
+  await test('startTracking drives rig frequency and rotator to the end of the schedule', async () => {
+    const start = Date.now();
+    const events = [];
+    const ended = new Promise((resolve) => {
+      rig.startTracking([
+        { time: start, azimuth: 10, elevation: 5, rxFrequency: 145800000 },
+        { time: start + 300, azimuth: 20, elevation: 15, rxFrequency: 145803000 },
+      ], { rotator, stepMs: 20 }, (event) => {
+        events.push(event);
+        if (event.type === 'end') resolve(event);
+      });
+    });
+    const end = await ended;
+    assert(end.reason === 'complete', `expected complete, got ${end.reason}`);
+    const steps = events.filter((event) => event.type === 'step');
+    assert(steps.length > 1, `expected several progress events, got ${steps.length}`);
+    assert(steps.every((event) => event.errors.length === 0), `unexpected errors ${JSON.stringify(steps)}`);
+    const freq = await rig.getFrequency();
+    assert(Math.abs(freq - 145803000) <= 10, `expected ~145803000, got ${freq}`);
+    const status = rig.getTrackingStatus();
+    assert(status.running === false, 'schedule should be finished');
+    assert(status.commands.rxFrequency > 1 && status.commands.position > 0,
+      `unexpected commands ${JSON.stringify(status.commands)}`);
+  });
+
+  await test('stopTracking stops a running schedule without an end event', async () => {
+    let endEvents = 0;
+    rig.startTracking([
+      { time: Date.now(), rxFrequency: 145800000 },
+      { time: Date.now() + 60000, rxFrequency: 145900000 },
+    ], { stepMs: 20 }, (event) => {
+      if (event.type === 'end') endEvents++;
+    });
+    await new Promise((resolve) => setTimeout(resolve, 60));
+    assert(rig.stopTracking() === true, 'stopTracking should report the running schedule');
+    await new Promise((resolve) => setTimeout(resolve, 40));
+    assert(endEvents === 0, 'no end event expected after stopTracking');
+    assert(rig.getTrackingStatus().running === false, 'schedule should not be running');
+  });
+
+  // --- Worker threads ---
+  console.log('\n[Worker Threads]');
+
+  await test('rigs run inside worker threads and are closed when they exit', async () => {
+    const { Worker } = require('worker_threads');
+    // Each worker leaves its rig open with polling running; the addon's
+    // environment cleanup hook has to stop and close it on exit.
+    const source = `
+      const { parentPort, workerData } = require('worker_threads');
+      const { HamLib } = require(${JSON.stringify(path.join(__dirname, '..', 'index.js'))});
+      (async () => {
+        const rig = new HamLib(1);
+        await rig.open();
+        await rig.setFrequency(workerData.frequency);
+        rig.startPolling([{ op: 'getFrequency', intervalMs: 50 }], () => {});
+        parentPort.postMessage({ frequency: await rig.getFrequency() });
+      })().catch((error) => parentPort.postMessage({ error: error.message }));
+    `;
+    const runWorker = (frequency) => new Promise((resolve, reject) => {
+      const worker = new Worker(source, { eval: true, workerData: { frequency } });
+      worker.once('message', async (message) => {
+        await worker.terminate();
+        resolve(message);
+      });
+      worker.once('error', reject);
+    });
+    const results = await Promise.all([runWorker(7074000), runWorker(14074000)]);
+    assert(results[0].frequency === 7074000 && results[1].frequency === 14074000,
+      `unexpected worker results ${JSON.stringify(results)}`);
+    // The main thread's rig is unaffected by the workers' teardown.
+    assert(typeof await rig.getFrequency() === 'number', 'main rig should still answer');
+  });
+
   // --- Cleanup ---
   console.log('\n[Cleanup]');
 
@@ -4,7 +4,7 @@
  */
 
 const { spawnSync } = require('child_process');
-const { HamLib, Rotator, PASSBAND } = require('../index.js');
+const { HamLib, HamLibGroup, Rotator, SpectrumRecording, PASSBAND, SPECTRUM_FRAME_FIELDS } = require('../index.js');
 const { SpectrumController } = require('../spectrum.js');
 
 console.log('🧪 测试node-hamlib模块加载和基础功能...\n');
@@ -58,6 +58,27 @@ function readGlobalLockEnabledFromChild(value) {
   return result.stdout.trim();
 }
 
+function readLockScopeFromChild(value) {
+  const env = { ...process.env };
+  if (value === undefined) {
+    delete env.NODE_HAMLIB_LOCK_SCOPE;
+  } else {
+    env.NODE_HAMLIB_LOCK_SCOPE = value;
+  }
+
+  const result = spawnSync(
+    process.execPath,
+    ['-e', "const { HamLib } = require('./index.js'); process.stdout.write(HamLib.getLockScope());"],
+    { cwd: require('path').join(__dirname, '..'), env, encoding: 'utf8' }
+  );
+
+  if (result.status !== 0) {
+    throw new Error(result.stderr || `child exited with ${result.status}`);
+  }
+
+  return result.stdout.trim();
+}
+
 function runLoaderChild(script, extraArgs = []) {
   const result = spawnSync(
     process.execPath,
@@ -79,14 +100,23 @@ try {
   test('HamLib构造函数可用', () => typeof HamLib === 'function');
   test('Rotator类成功加载', () => Rotator && typeof Rotator === 'function');
   test('PASSBAND常量成功加载', () => PASSBAND && typeof PASSBAND === 'object');
+  test('HamLibGroup类成功加载', () => typeof HamLibGroup === 'function'
+    && ['batch', 'setFrequency', 'setMode', 'setPtt'].every((method) => typeof HamLibGroup.prototype[method] === 'function'));
+  test('SpectrumRecording类成功加载', () => typeof SpectrumRecording === 'function'
+    && typeof SpectrumRecording.open === 'function' && typeof SpectrumRecording.decode === 'function');
   
   // 2. 静态方法测试
   console.log('\n📊 静态方法测试:');
   test('getHamlibVersion静态方法存在', () => typeof HamLib.getHamlibVersion === 'function');
   test('getSupportedRigs静态方法存在', () => typeof HamLib.getSupportedRigs === 'function');
+  ['getSupportedRigsAsync', 'getSupportedRigsColumnar', 'getSupportedRig'].forEach(method => {
+    test(`${method}静态方法存在`, () => typeof HamLib[method] === 'function');
+  });
   test('Rotator.getSupportedRotators静态方法存在', () => typeof Rotator.getSupportedRotators === 'function');
   test('PASSBAND.NORMAL 常量正确', () => PASSBAND.NORMAL === 0);
   test('PASSBAND.NOCHANGE 常量正确', () => PASSBAND.NOCHANGE === -1);
+  test('SPECTRUM_FRAME_FIELDS 常量正确', () => Object.isFrozen(SPECTRUM_FRAME_FIELDS)
+    && SPECTRUM_FRAME_FIELDS.scopeId === 0 && SPECTRUM_FRAME_FIELDS.signalStrengthMax === 12);
 
   try {
     const supportedRigs = HamLib.getSupportedRigs();
@@ -148,6 +178,12 @@ try {
   const spectrumController = new SpectrumController(testRig);
   test('SpectrumController实例创建成功', () => spectrumController && typeof spectrumController === 'object');
   test('spectrum 子路径 CJS 代理可用', () => typeof SpectrumController === 'function');
+  test('SpectrumController 接受不带 startPolling 的代理电台', () => {
+    const { startPolling, stopPolling, ...methods } = Object.fromEntries(
+      Object.getOwnPropertyNames(Object.getPrototypeOf(testRig)).map((name) => [name, () => {}])
+    );
+    return new SpectrumController(methods) instanceof SpectrumController;
+  });
   
   // 4. 基础方法存在性测试
   console.log('\n🔍 基础方法存在性测试:');
@@ -189,17 +225,210 @@ try {
   // 新增 API 方法存在性测试
   console.log('\n🆕 补齐 API 方法存在性测试:');
   const newApiMethods = [
-    'getInfo', 'sendRaw', 'getSpectrumCapabilities',
+    'getInfo', 'sendRaw', 'sendRawInto', 'startRawStream', 'stopRawStream', 'getRawStreamStatus',
+    'startSweep', 'stopSweep', 'getSweepStatus',
+    'getSpectrumCapabilities',
     'startSpectrumStream', 'stopSpectrumStream', 'setConf', 'getConf', 'getConfigSchema', 'getPortCaps',
     'getPassbandNormal', 'getPassbandNarrow', 'getPassbandWide',
     'getResolution',
-    'getSupportedParms', 'getSupportedVfoOps', 'getSupportedScanTypes'
+    'getSupportedParms', 'getSupportedVfoOps', 'getSupportedScanTypes',
+    'batch', 'getSpectrumStreamStats',
+    'openSharedSession', 'closeSharedSession', 'getSharedSessionStats',
+    'startSpectrumRecording', 'stopSpectrumRecording', 'getSpectrumRecordingStats'
   ];
 
   newApiMethods.forEach(method => {
     test(`新增方法 ${method} 存在`, () => typeof testRig[method] === 'function');
   });
 
+  console.log('\n🧵 专用命令线程方法存在性测试:');
+  ['enableCommandThread', 'disableCommandThread', 'getCommandThreadStats'].forEach(method => {
+    test(`命令线程方法 ${method} 存在`, () => typeof testRig[method] === 'function');
+  });
+  test('未启用时命令线程统计返回 enabled=false', () => {
+    const stats = testRig.getCommandThreadStats();
+    return stats.enabled === false && stats.queueDepth === 0 && typeof stats.avgWaitMs === 'number';
+  });
+  test('非法 queueCapacity 抛出 RangeError', () => {
+    try {
+      testRig.enableCommandThread({ queueCapacity: 0 });
+      return false;
+    } catch (error) {
+      return error instanceof RangeError && testRig.getCommandThreadStats().enabled === false;
+    }
+  });
+
+  console.log('\n🗃️ 状态缓存方法存在性测试:');
+  ['enableStateCache', 'disableStateCache', 'getStateCacheStats'].forEach(method => {
+    test(`状态缓存方法 ${method} 存在`, () => typeof testRig[method] === 'function');
+  });
+  test('状态缓存默认关闭', () => {
+    const stats = testRig.getStateCacheStats();
+    return stats.enabled === false && stats.hits === 0 && stats.misses === 0;
+  });
+  test('非法 maxAgeMs 抛出 RangeError', () => {
+    try {
+      testRig.enableStateCache({ maxAgeMs: -1 });
+      return false;
+    } catch (error) {
+      return error instanceof RangeError && testRig.getStateCacheStats().enabled === false;
+    }
+  });
+
+  console.log('\n🔗 请求合并方法存在性测试:');
+  ['enableRequestCoalescing', 'disableRequestCoalescing'].forEach(method => {
+    test(`请求合并方法 ${method} 存在`, () => typeof testRig[method] === 'function');
+  });
+  test('非布尔 reads 选项抛出 TypeError', () => {
+    try {
+      testRig.enableRequestCoalescing({ reads: 'yes' });
+      return false;
+    } catch (error) {
+      return error instanceof TypeError && testRig.getStats().coalescing.reads === false;
+    }
+  });
+
+  console.log('\n🚦 命令优先级方法存在性测试:');
+  ['setCommandPriorities', 'getCommandPriorities'].forEach(method => {
+    test(`优先级方法 ${method} 存在`, () => typeof testRig[method] === 'function');
+  });
+  test('默认不丢弃后台命令', () => testRig.getCommandPriorities().backgroundBudget === 0);
+  test('未知优先级抛出 TypeError', () => {
+    try {
+      testRig.setCommandPriorities({ operations: { getLevel: 'urgent' } });
+      return false;
+    } catch (error) {
+      return error instanceof TypeError && Object.keys(testRig.getCommandPriorities().operations).length === 0;
+    }
+  });
+  test('非法 backgroundBudget 抛出 RangeError', () => {
+    try {
+      testRig.setCommandPriorities({ backgroundBudget: -1 });
+      return false;
+    } catch (error) {
+      return error instanceof RangeError;
+    }
+  });
+
+  console.log('\n⏹️ 取消与截止时间测试:');
+  test('调用选项方法 withCallOptions 存在', () => typeof testRig.withCallOptions === 'function');
+  test('withCallOptions 返回带同样方法的视图', () => {
+    const scoped = testRig.withCallOptions({ deadlineMs: 100 });
+    return typeof scoped.getLevel === 'function' && typeof scoped.memory.list === 'function';
+  });
+  test('非法 deadlineMs 抛出 RangeError', () => {
+    try {
+      testRig.withCallOptions({ deadlineMs: -1 });
+      return false;
+    } catch (error) {
+      return error instanceof RangeError;
+    }
+  });
+  test('非 AbortSignal 的 signal 抛出 TypeError', () => {
+    try {
+      testRig.withCallOptions({ signal: {} });
+      return false;
+    } catch (error) {
+      return error instanceof TypeError;
+    }
+  });
+
+  console.log('\n🧾 能力快照方法存在性测试:');
+  test('能力快照方法 getCapabilitySnapshot 存在', () => typeof testRig.getCapabilitySnapshot === 'function');
+
+  console.log('\n⚡ 同步方法存在性测试:');
+  ['getFrequencySync', 'getModeSync', 'getVfoSync', 'getSupportedLevelsSync', 'getSupportedModesSync',
+    'getFrequencyRangesSync', 'getCapabilitySnapshotSync', 'power2mWSync', 'mW2powerSync'].forEach(method => {
+    test(`同步方法 ${method} 存在`, () => typeof testRig[method] === 'function');
+  });
+  test('状态缓存关闭时 getFrequencySync 返回 null', () => testRig.getFrequencySync() === null);
+  test('未打开时 getSupportedLevelsSync 抛出错误', () => {
+    try {
+      testRig.getSupportedLevelsSync();
+      return false;
+    } catch (e) {
+      return /captured by open\(\)/.test(e.message);
+    }
+  });
+  test('未打开时 power2mWSync 返回 null', () => testRig.power2mWSync(0.5, 14074000, 'USB') === null);
+
+  console.log('\n📊 操作指标方法存在性测试:');
+  ['getStats', 'resetStats'].forEach(method => {
+    test(`指标方法 ${method} 存在`, () => typeof testRig[method] === 'function');
+    test(`指标静态方法 ${method} 存在`, () => typeof HamLib[method] === 'function');
+  });
+  test('未执行命令时实例指标为空', () => {
+    const stats = testRig.getStats();
+    return Object.keys(stats.operations).length === 0 && stats.queue.pending === 0
+      && stats.commandThread.enabled === false && typeof stats.since === 'number';
+  });
+  test('全局指标包含 lockHolders 数组', () => Array.isArray(HamLib.getStats().lockHolders));
+  ['enableTrace', 'disableTrace', 'dumpTrace'].forEach(method => {
+    test(`追踪方法 ${method} 存在`, () => typeof testRig[method] === 'function');
+  });
+  test('未共享会话时 getSharedSessionStats 为 null', () => testRig.getSharedSessionStats() === null);
+  test('未启用追踪时 dumpTrace 没有调用', () => {
+    const trace = testRig.dumpTrace();
+    return Array.isArray(trace.traceEvents) && trace.otherData.enabled === false && trace.otherData.calls === 0;
+  });
+
+  test('未启动频谱流时统计为空', () => {
+    const stats = testRig.getSpectrumStreamStats();
+    return stats.running === false && stats.dropped === 0 && stats.overflow === 'drop-oldest'
+      && stats.batchLines === 1 && stats.maxLatencyMs === 50;
+  });
+
+  console.log('\n📻 Transceive 事件方法存在性测试:');
+  ['setTransceive', 'getTransceive'].forEach(method => {
+    test(`Transceive 方法 ${method} 存在`, () => typeof testRig[method] === 'function');
+  });
+  test('默认 transceive 模式为 rig', () => testRig.getTransceive() === 'rig');
+
+  console.log('\n📡 原生轮询方法存在性测试:');
+  ['startPolling', 'stopPolling'].forEach(method => {
+    test(`轮询方法 ${method} 存在`, () => typeof testRig[method] === 'function');
+  });
+  test('未启动轮询时 stopPolling 返回 false', () => testRig.stopPolling() === false);
+  test('轮询 set 操作抛出 TypeError', () => {
+    try {
+      testRig.startPolling([{ op: 'setPtt', ptt: true }]);
+      return false;
+    } catch (error) {
+      return error instanceof TypeError;
+    }
+  });
+  test('非法 intervalMs 抛出 RangeError', () => {
+    try {
+      testRig.startPolling([{ op: 'getFrequency', intervalMs: 1 }]);
+      return false;
+    } catch (error) {
+      return error instanceof RangeError;
+    }
+  });
+
+  console.log('\n🛰️ 跟踪循环方法存在性测试:');
+  ['startTracking', 'stopTracking', 'getTrackingStatus'].forEach(method => {
+    test(`跟踪方法 ${method} 存在`, () => typeof testRig[method] === 'function');
+  });
+  test('未启动跟踪时 stopTracking 返回 false', () => testRig.stopTracking() === false);
+  test('未启动跟踪时 getTrackingStatus 返回 null', () => testRig.getTrackingStatus() === null);
+  test('时间非递增的跟踪表抛出 RangeError', () => {
+    try {
+      testRig.startTracking([{ time: 2000, rxFrequency: 145800000 }, { time: 1000, rxFrequency: 145800000 }]);
+      return false;
+    } catch (error) {
+      return error instanceof RangeError;
+    }
+  });
+  test('含方位角但无 rotator 的跟踪表抛出 TypeError', () => {
+    try {
+      testRig.startTracking([{ time: Date.now(), azimuth: 10, elevation: 5 }]);
+      return false;
+    } catch (error) {
+      return error instanceof TypeError;
+    }
+  });
+
   console.log('\n🆕 SpectrumController 方法存在性测试:');
   const spectrumMethods = [
     'getSpectrumSupportSummary', 'configureSpectrum',
@@ -234,6 +463,33 @@ try {
   newStaticMethods.forEach(method => {
     test(`静态方法 ${method} 存在`, () => typeof HamLib[method] === 'function');
   });
+  ['buildModelIndex', 'loadModelIndex', 'getModelIndexInfo', 'getDefaultModelIndexPath'].forEach(method => {
+    test(`型号索引静态方法 ${method} 存在`, () => typeof HamLib[method] === 'function');
+  });
+  test('loadModelIndex 拒绝不存在的文件', () => {
+    try {
+      HamLib.loadModelIndex(require('path').join(__dirname, 'no-such-models.idx'));
+      return false;
+    } catch (err) {
+      return err instanceof Error;
+    }
+  });
+
+  console.log('\n🏷️ 电平/功能句柄测试:');
+  test('getLevelHandle 返回非零数字句柄', () => {
+    const handle = HamLib.getLevelHandle('STRENGTH');
+    return typeof handle === 'number' && handle > 0 && handle === HamLib.getLevelHandle('STRENGTH');
+  });
+  test('不同电平的句柄不同', () => HamLib.getLevelHandle('SWR') !== HamLib.getLevelHandle('ALC'));
+  test('未知电平名称抛出 TypeError', () => {
+    try {
+      HamLib.getLevelHandle('NOT_A_LEVEL');
+      return false;
+    } catch (error) {
+      return error instanceof TypeError;
+    }
+  });
+  test('同名电平与功能的句柄不同', () => HamLib.getLevelHandle('COMP') !== HamLib.getFunctionHandle('COMP'));
 
   console.log('\n🔒 HamLib 全局串行锁开关测试:');
   test('setGlobalLockEnabled 静态方法存在', () => typeof HamLib.setGlobalLockEnabled === 'function');
@@ -249,6 +505,37 @@ try {
   ['0', 'false', 'off', 'no'].forEach(value => {
     test(`NODE_HAMLIB_GLOBAL_LOCK=${value} 时默认关闭`, () => readGlobalLockEnabledFromChild(value) === 'false');
   });
+
+  console.log('\n🔒 HamLib 锁粒度测试:');
+  ['setLockScope', 'getLockScope', 'setBackendSerialized'].forEach(method => {
+    test(`${method} 静态方法存在`, () => typeof HamLib[method] === 'function');
+  });
+  test('锁粒度默认为 global', () => HamLib.getLockScope() === 'global');
+  test('锁粒度可在 global/port/instance 之间切换', () => {
+    const seen = ['port', 'instance', 'global'].map(scope => {
+      HamLib.setLockScope(scope);
+      return HamLib.getLockScope();
+    });
+    return seen.join(',') === 'port,instance,global';
+  });
+  test('非法锁粒度抛出 TypeError', () => {
+    try {
+      HamLib.setLockScope('device');
+      return false;
+    } catch (error) {
+      return error instanceof TypeError && HamLib.getLockScope() === 'global';
+    }
+  });
+  test('无环境变量时子进程默认 global 锁粒度', () => readLockScopeFromChild(undefined) === 'global');
+  test('NODE_HAMLIB_LOCK_SCOPE=port 时默认 port 锁粒度', () => readLockScopeFromChild('port') === 'port');
+  test('NODE_HAMLIB_LOCK_SCOPE=instance 时默认 instance 锁粒度', () => readLockScopeFromChild('instance') === 'instance');
+  test('非法 NODE_HAMLIB_LOCK_SCOPE 回退为 global', () => readLockScopeFromChild('bogus') === 'global');
+  test('setBackendSerialized 接受 (model, boolean)', () => {
+    HamLib.setBackendSerialized(1, true);
+    HamLib.setBackendSerialized(1, false);
+    return true;
+  });
+
   test('静态型号配置 schema 同步返回数组', () => {
     const schema = HamLib.getConfigSchemaForModel(1);
     return Array.isArray(schema) && schema.length > 0 && typeof schema[0].name === 'string';
@@ -362,7 +649,8 @@ try {
     'setConf', 'getConf', 'getConfigSchema', 'getPortCaps', 'getRotatorCaps',
     'setLevel', 'getLevel', 'getSupportedLevels',
     'setFunction', 'getFunction', 'getSupportedFunctions',
-    'setParm', 'getParm', 'getSupportedParms'
+    'setParm', 'getParm', 'getSupportedParms',
+    'setPositionDeadband', 'getStats', 'resetStats'
   ];
 
   rotatorMethods.forEach(method => {
@@ -49,6 +49,30 @@ async function main() {
     assert(Array.isArray(list.channels) && list.channels.length === layout.count, 'list should include all dummy memory slots with includeEmpty');
     assert(Array.isArray(list.errors), 'list errors missing');
 
+    let streamed = 0;
+    let chunks = 0;
+    let lastScanned = 0;
+    for await (const chunk of rig.memory.stream({ includeEmpty: true, continueOnError: true, chunkSize: 7 })) {
+      chunks += 1;
+      streamed += chunk.channels.length;
+      assert(chunk.total === layout.count, 'stream total should match layout count');
+      assert(chunk.scanned > lastScanned && chunk.scanned <= chunk.total, 'stream scanned should grow');
+      lastScanned = chunk.scanned;
+    }
+    assert(streamed === list.channels.length, `stream yielded ${streamed}, list ${list.channels.length}`);
+    assert(lastScanned === layout.count, 'stream should scan every slot');
+    assert(chunks === Math.ceil(layout.count / 7), `unexpected chunk count ${chunks}`);
+
+    const controller = new AbortController();
+    let beforeAbort = 0;
+    await assertRejects(async () => {
+      for await (const chunk of rig.memory.stream({ chunkSize: 1, signal: controller.signal })) {
+        beforeAbort += chunk.scanned;
+        controller.abort();
+      }
+    }, 'aborted memory.stream should reject');
+    assert(beforeAbort === 1, 'abort should stop the scan after the current chunk');
+
     const outsideChannel = Math.max(...layout.ranges.map((range) => range.end)) + 1;
     await assertRejects(() => rig.memory.get(outsideChannel, { readOnly: true }), 'memory.get should reject channels outside layout');
     await assertRejects(() => rig.memory.setMany([{}], { continueOnError: true }), 'setMany should require channelNumber');
@@ -80,6 +104,27 @@ async function main() {
     assert(typeof writeResult.written === 'number', 'write result missing written');
     assert(Array.isArray(writeResult.errors), 'write result missing errors');
 
+    const target = {
+      channelNumber: layout.ranges[0].start + 1,
+      frequency: 145500000,
+      mode: 'FM',
+      description: 'Diff test',
+    };
+    await rig.memory.setMany([target]);
+    const unchanged = await rig.memory.setMany([target], { diff: true });
+    assert(unchanged.written === 0 && unchanged.skipped === 1, `diff should skip an unchanged channel: ${JSON.stringify(unchanged)}`);
+    const changed = await rig.memory.setMany([{ ...target, frequency: 145525000 }], { diff: true });
+    assert(changed.written === 1 && changed.skipped === 0, 'diff should write a changed channel');
+
+    const image = await rig.memory.list({ includeEmpty: true });
+    // list() reports unset VFOs as tokens that writes do not accept.
+    const codeplug = image.channels.map(({ vfo, txVfo, ...rest }) => (
+      ['None', 'UNKNOWN', ''].includes(txVfo) ? rest : { ...rest, txVfo }
+    ));
+    const replay = await rig.memory.replaceAll(codeplug, { baseline: image.channels });
+    assert(replay.skipped + replay.written === layout.count, 'replaceAll diff should account for every slot');
+    assert(replay.written === 0, `replaying the current image should write nothing, wrote ${replay.written}`);
+
     console.log('Memory API tests passed');
   } finally {
     await rig.close();